@@ -0,0 +1,892 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <new>  // std::nothrow
+
+#if ! (defined( _WIN32 ) || defined( _WIN64 ))
+#include <unistd.h>
+#endif
+
+#include "thread_queue.hpp"
+
+#include "magma_internal.h"  // after thread_queue.hpp, so max, min are defined
+
+
+/******************************************************************************/
+// number of threads doing asynchronous reads (prefetch) and writes (write-behind)
+static const magma_int_t ooc_nthread_io = 2;
+
+// tile states
+enum {
+    ooc_absent,     // only in the file
+    ooc_loading,    // being read into its slot
+    ooc_resident,   // in its slot; the file copy is stale if dirty
+    ooc_evicting    // being written back before its slot is reused
+};
+
+struct magma_ooc_tile
+{
+    int         state;
+    magma_int_t slot;        // slot holding the tile, or -1
+    magma_int_t pin;         // number of acquires not yet released
+    magma_int_t stamp;       // last use, for LRU eviction
+    bool        dirty;       // slot is newer than the file
+    bool        writing;     // write-behind in progress; no writers until done
+    bool        prefetched;  // read ahead and not yet used
+};
+
+struct magma_ooc
+{
+    magma_int_t m, n, nb, mt, nt;
+    size_t      elemsize;
+    size_t      tilebytes;   // nb*nb*elemsize, the size of each tile in the file
+    magma_int_t lookahead;
+    magma_int_t nslot;       // lookahead + 2 slots of tilebytes each
+    int         fd;
+    bool        temporary;   // unnamed file, removed when closed
+
+    char*           slots;
+    magma_int_t*    slot_tile;  // tile held by each slot, or -1 if free
+    magma_ooc_tile* tiles;      // mt*nt tiles, column-major
+    magma_int_t     stamp;
+    magma_int_t     io_error;
+
+    double bytes_read;
+    double bytes_written;
+    double wait_time;
+
+    pthread_mutex_t    mutex;  // protects everything above, after create
+    pthread_cond_t     cond;   // signals any change of tile state
+    magma_thread_queue queue;  // I/O threads
+};
+
+
+/******************************************************************************/
+// Bytes of tile t transferred to or from the file.
+// Columns of a tile are stored with stride nb, so only full columns are
+// transferred, and the last tile column transfers fewer columns.
+static size_t ooc_tile_bytes( magma_ooc_t A, magma_int_t t )
+{
+    magma_int_t j = t / A->mt;
+    magma_int_t ncol = min( A->nb, A->n - j*A->nb );
+    return size_t(A->nb) * ncol * A->elemsize;
+}
+
+
+/******************************************************************************/
+// Reads (write = false) or writes (write = true) tile t between its slot and
+// the file. Called without the mutex held; the caller marks the tile as
+// loading, evicting, or writing beforehand so the slot is not reused.
+static magma_int_t ooc_tile_io( magma_ooc_t A, magma_int_t t, bool write )
+{
+#if defined( _WIN32 ) || defined( _WIN64 )
+    return MAGMA_ERR_NOT_SUPPORTED;
+#else
+    char*  buf    = A->slots + A->tiles[t].slot * A->tilebytes;
+    size_t bytes  = ooc_tile_bytes( A, t );
+    off_t  offset = off_t(t) * off_t(A->tilebytes);
+    while (bytes > 0) {
+        ssize_t cnt = (write
+                       ? pwrite( A->fd, buf, bytes, offset )
+                       : pread(  A->fd, buf, bytes, offset ));
+        if (cnt < 0 && errno == EINTR) {
+            continue;
+        }
+        if (cnt <= 0) {
+            return MAGMA_ERR_FILESYSTEM;
+        }
+        buf    += cnt;
+        bytes  -= cnt;
+        offset += cnt;
+    }
+    return MAGMA_SUCCESS;
+#endif
+}
+
+
+/******************************************************************************/
+// Opens filename, or an unnamed temporary file if filename is NULL,
+// and extends it to hold all tiles.
+static magma_int_t ooc_open( magma_ooc_t A, const char* filename )
+{
+#if defined( _WIN32 ) || defined( _WIN64 )
+    return MAGMA_ERR_NOT_SUPPORTED;
+#else
+    if (filename == NULL) {
+        const char* dir = getenv( "TMPDIR" );
+        if (dir == NULL || dir[0] == '\0') {
+            dir = "/tmp";
+        }
+        char path[ 4096 ];
+        snprintf( path, sizeof(path), "%s/magma_ooc_XXXXXX", dir );
+        A->fd = mkstemp( path );
+        if (A->fd >= 0) {
+            unlink( path );  // removed when closed
+        }
+        A->temporary = true;
+    }
+    else {
+        A->fd = open( filename, O_RDWR | O_CREAT, 0644 );
+    }
+    if (A->fd < 0) {
+        return MAGMA_ERR_FILESYSTEM;
+    }
+
+    struct stat st;
+    off_t size = off_t(A->mt) * off_t(A->nt) * off_t(A->tilebytes);
+    if (fstat( A->fd, &st ) != 0
+        || (st.st_size < size && ftruncate( A->fd, size ) != 0))
+    {
+        close( A->fd );
+        A->fd = -1;
+        return MAGMA_ERR_FILESYSTEM;
+    }
+    return MAGMA_SUCCESS;
+#endif
+}
+
+
+/******************************************************************************/
+static void ooc_close( magma_ooc_t A )
+{
+#if ! (defined( _WIN32 ) || defined( _WIN64 ))
+    if (A->fd >= 0) {
+        close( A->fd );
+    }
+#endif
+    A->fd = -1;
+}
+
+
+/******************************************************************************/
+// Reads or writes one tile asynchronously, then updates its state.
+class magma_ooc_task: public magma_task
+{
+public:
+    magma_ooc_task( magma_ooc_t in_A, magma_int_t in_tile, bool in_write ):
+        A    ( in_A     ),
+        tile ( in_tile  ),
+        write( in_write )
+    {}
+
+    virtual void run()
+    {
+        magma_int_t err = ooc_tile_io( A, tile, write );
+
+        pthread_mutex_lock( &A->mutex );
+        magma_ooc_tile* t = &A->tiles[ tile ];
+        if (write) {
+            t->writing = false;
+            t->dirty   = false;
+            A->bytes_written += ooc_tile_bytes( A, tile );
+        }
+        else {
+            t->state = ooc_resident;
+            A->bytes_read += ooc_tile_bytes( A, tile );
+        }
+        if (err != 0) {
+            A->io_error = err;
+        }
+        pthread_cond_broadcast( &A->cond );
+        pthread_mutex_unlock( &A->mutex );
+    }
+
+private:
+    magma_ooc_t A;
+    magma_int_t tile;
+    bool        write;
+};
+
+
+/******************************************************************************/
+// With the mutex held, finds a slot for a new tile.
+// Returns a free slot, with *victim = -1, or a slot whose tile *victim can be
+// evicted, or -1 if none is available now.
+// Prefers the least recently used clean tile. A prefetch takes only those,
+// so it never displaces tiles read ahead but not yet used. An acquire may
+// also take the most recently prefetched tile, or a dirty tile, which the
+// caller must write back first.
+static magma_int_t ooc_find_slot( magma_ooc_t A, bool prefetch, magma_int_t* victim )
+{
+    magma_int_t clean = -1, ahead = -1, dirty = -1;
+    for (magma_int_t s = 0; s < A->nslot; ++s) {
+        magma_int_t t = A->slot_tile[s];
+        if (t < 0) {
+            *victim = -1;
+            return s;
+        }
+        magma_ooc_tile* tile = &A->tiles[t];
+        if (tile->state != ooc_resident || tile->pin > 0 || tile->writing) {
+            continue;
+        }
+        if (tile->dirty) {
+            if (dirty < 0 || tile->stamp < A->tiles[ A->slot_tile[dirty] ].stamp)
+                dirty = s;
+        }
+        else if (tile->prefetched) {
+            if (ahead < 0 || tile->stamp > A->tiles[ A->slot_tile[ahead] ].stamp)
+                ahead = s;
+        }
+        else {
+            if (clean < 0 || tile->stamp < A->tiles[ A->slot_tile[clean] ].stamp)
+                clean = s;
+        }
+    }
+    magma_int_t s = clean;
+    if (! prefetch) {
+        if (s < 0) s = ahead;
+        if (s < 0) s = dirty;
+    }
+    *victim = (s >= 0 ? A->slot_tile[s] : -1);
+    return s;
+}
+
+
+/******************************************************************************/
+// With the mutex held, evicts tile v, writing it back if dirty, which
+// releases the mutex during the write. Its slot is then free.
+static void ooc_evict( magma_ooc_t A, magma_int_t v )
+{
+    magma_ooc_tile* tile = &A->tiles[v];
+    if (tile->dirty) {
+        tile->state   = ooc_evicting;
+        tile->writing = true;
+        pthread_mutex_unlock( &A->mutex );
+        magma_int_t err = ooc_tile_io( A, v, true );
+        pthread_mutex_lock( &A->mutex );
+        tile->writing = false;
+        tile->dirty   = false;
+        A->bytes_written += ooc_tile_bytes( A, v );
+        if (err != 0) {
+            A->io_error = err;
+        }
+    }
+    A->slot_tile[ tile->slot ] = -1;
+    tile->state      = ooc_absent;
+    tile->slot       = -1;
+    tile->prefetched = false;
+    pthread_cond_broadcast( &A->cond );
+}
+
+
+/******************************************************************************/
+// Starts an asynchronous read of tile t, if it is absent and a slot is
+// available without waiting. Returns false if no slot is available.
+static bool ooc_prefetch_tile( magma_ooc_t A, magma_int_t t )
+{
+    bool ok = true;
+    pthread_mutex_lock( &A->mutex );
+    magma_ooc_tile* tile = &A->tiles[t];
+    if (tile->state == ooc_absent && A->io_error == 0) {
+        magma_int_t victim;
+        magma_int_t s = ooc_find_slot( A, true, &victim );
+        if (s < 0) {
+            ok = false;
+        }
+        else {
+            if (victim >= 0) {
+                ooc_evict( A, victim );  // clean, so does not release the mutex
+            }
+            A->slot_tile[s]  = t;
+            tile->slot       = s;
+            tile->state      = ooc_loading;
+            tile->prefetched = true;
+            tile->stamp      = ++A->stamp;
+            A->queue.push_task( new magma_ooc_task( A, t, false ));
+        }
+    }
+    pthread_mutex_unlock( &A->mutex );
+    return ok;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Creates an M-by-N out-of-core matrix A, stored as NB-by-NB tiles in a file.
+    Tiles are read into a cache of LOOKAHEAD + 2 tiles in host memory when
+    acquired, and read ahead asynchronously by magma_ooc_prefetch,
+    magma_ooc_getmatrix, and the out-of-core drivers. Modified tiles are
+    written back asynchronously when released. The file is accessed with
+    pread and pwrite, so the host memory used is bounded by the cache,
+    independent of the matrix size.
+
+    Each tile is stored column-major with leading dimension NB; the tiles
+    are stored in column-major order in the file. Tiles on the bottom and
+    right edges are smaller than NB-by-NB.
+
+    Arguments
+    ---------
+    @param[in]
+    m           Number of rows of A. M >= 0.
+
+    @param[in]
+    n           Number of columns of A. N >= 0.
+
+    @param[in]
+    nb          Tile size. NB > 0.
+
+    @param[in]
+    elemsize    Size of each element, e.g., sizeof(magmaDoubleComplex).
+
+    @param[in]
+    lookahead   Number of tiles that can be read ahead. LOOKAHEAD >= 0.
+                At most LOOKAHEAD + 1 tiles may be acquired at once.
+
+    @param[in]
+    filename    File to store A in. It is created if it does not exist;
+                otherwise, its tiles are the initial contents of A, and it
+                is kept, with the final contents of A, after
+                magma_ooc_destroy.
+                If NULL, an unnamed temporary file in $TMPDIR (or /tmp) is
+                used, which is removed by magma_ooc_destroy.
+
+    @param[out]
+    A_ptr       On exit, the new out-of-core matrix.
+
+    @return MAGMA_SUCCESS, or
+            MAGMA_ERR_HOST_ALLOC if the cache could not be allocated, or
+            MAGMA_ERR_FILESYSTEM if the file could not be opened or extended.
+
+    @ingroup magma_ooc
+*******************************************************************************/
+extern "C" magma_int_t
+magma_ooc_create(
+    magma_int_t m, magma_int_t n, magma_int_t nb, size_t elemsize,
+    magma_int_t lookahead, const char* filename,
+    magma_ooc_t* A_ptr )
+{
+    magma_int_t info = 0;
+    if (m < 0)
+        info = -1;
+    else if (n < 0)
+        info = -2;
+    else if (nb <= 0)
+        info = -3;
+    else if (elemsize == 0)
+        info = -4;
+    else if (lookahead < 0)
+        info = -5;
+    else if (A_ptr == NULL)
+        info = -7;
+
+    if (info != 0) {
+        magma_xerbla( __func__, -(info) );
+        return info;
+    }
+
+    *A_ptr = NULL;
+    magma_ooc_t A = new (std::nothrow) magma_ooc;
+    if (A == NULL) {
+        return MAGMA_ERR_HOST_ALLOC;
+    }
+    A->m         = m;
+    A->n         = n;
+    A->nb        = nb;
+    A->mt        = magma_ceildiv( m, nb );
+    A->nt        = magma_ceildiv( n, nb );
+    A->elemsize  = elemsize;
+    A->tilebytes = size_t(nb) * nb * elemsize;
+    A->lookahead = lookahead;
+    A->nslot     = lookahead + 2;
+    A->fd        = -1;
+    A->temporary = false;
+    A->slots     = NULL;
+    A->slot_tile = NULL;
+    A->tiles     = NULL;
+    A->stamp     = 0;
+    A->io_error  = 0;
+    A->bytes_read    = 0;
+    A->bytes_written = 0;
+    A->wait_time     = 0;
+    pthread_mutex_init( &A->mutex, NULL );
+    pthread_cond_init(  &A->cond,  NULL );
+    A->queue.launch( ooc_nthread_io );
+
+    magma_int_t ntile = A->mt * A->nt;
+    if (MAGMA_SUCCESS != magma_malloc_cpu( (void**) &A->slots, A->nslot * A->tilebytes ) ||
+        MAGMA_SUCCESS != magma_imalloc_cpu( &A->slot_tile, A->nslot ) ||
+        MAGMA_SUCCESS != magma_malloc_cpu( (void**) &A->tiles, ntile * sizeof(magma_ooc_tile) ))
+    {
+        info = MAGMA_ERR_HOST_ALLOC;
+    }
+    else {
+        info = ooc_open( A, filename );
+    }
+    if (info != 0) {
+        magma_free_cpu( A->slots );
+        magma_free_cpu( A->slot_tile );
+        magma_free_cpu( A->tiles );
+        A->queue.quit();
+        pthread_mutex_destroy( &A->mutex );
+        pthread_cond_destroy(  &A->cond  );
+        delete A;
+        return info;
+    }
+
+    for (magma_int_t s = 0; s < A->nslot; ++s) {
+        A->slot_tile[s] = -1;
+    }
+    for (magma_int_t t = 0; t < ntile; ++t) {
+        A->tiles[t].state      = ooc_absent;
+        A->tiles[t].slot       = -1;
+        A->tiles[t].pin        = 0;
+        A->tiles[t].stamp      = 0;
+        A->tiles[t].dirty      = false;
+        A->tiles[t].writing    = false;
+        A->tiles[t].prefetched = false;
+    }
+
+    *A_ptr = A;
+    return info;
+}
+
+
+/***************************************************************************//**
+    Destroys an out-of-core matrix. If it was created with a filename,
+    modified tiles are first written to the file.
+
+    @param[in]
+    A       Out-of-core matrix to destroy. May be NULL.
+
+    @return MAGMA_SUCCESS, or MAGMA_ERR_FILESYSTEM if writing failed.
+
+    @ingroup magma_ooc
+*******************************************************************************/
+extern "C" magma_int_t
+magma_ooc_destroy( magma_ooc_t A )
+{
+    if (A == NULL) {
+        return MAGMA_SUCCESS;
+    }
+    magma_int_t info = MAGMA_SUCCESS;
+    if (A->temporary) {
+        A->queue.sync();
+    }
+    else {
+        info = magma_ooc_flush( A );
+    }
+    A->queue.quit();
+    ooc_close( A );
+    pthread_mutex_destroy( &A->mutex );
+    pthread_cond_destroy(  &A->cond  );
+    magma_free_cpu( A->slots );
+    magma_free_cpu( A->slot_tile );
+    magma_free_cpu( A->tiles );
+    delete A;
+    return info;
+}
+
+
+/***************************************************************************//**
+    Returns the dimensions, tile size, and element size of an out-of-core
+    matrix. Any output may be NULL.
+
+    @ingroup magma_ooc
+*******************************************************************************/
+extern "C" void
+magma_ooc_getsize(
+    magma_ooc_t A,
+    magma_int_t* m, magma_int_t* n, magma_int_t* nb, size_t* elemsize )
+{
+    if (m        != NULL) *m        = A->m;
+    if (n        != NULL) *n        = A->n;
+    if (nb       != NULL) *nb       = A->nb;
+    if (elemsize != NULL) *elemsize = A->elemsize;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Acquires tile (i, j) of an out-of-core matrix, reading it from the file
+    if it is not in the cache, and waiting for a prefetch in progress.
+    The tile stays in the cache until released by magma_ooc_tile_release.
+
+    Arguments
+    ---------
+    @param[in]
+    A       Out-of-core matrix.
+
+    @param[in]
+    i       Tile row index. 0 <= I < ceil( M/NB ).
+
+    @param[in]
+    j       Tile column index. 0 <= J < ceil( N/NB ).
+
+    @param[in]
+    access  magma_ooc_access_t
+      -     = MagmaOOCRead:      the tile will only be read.
+      -     = MagmaOOCReadWrite: the tile will be modified.
+      -     = MagmaOOCWrite:     the tile will be completely overwritten,
+                                 so it is not read from the file.
+
+    @param[out]
+    T_ptr   On exit, pointer to the tile, an
+            min( NB, M - I*NB )-by-min( NB, N - J*NB ) matrix.
+
+    @param[out]
+    ldt     On exit, leading dimension of the tile, which is NB.
+
+    @return MAGMA_SUCCESS, or
+            MAGMA_ERR_FILESYSTEM if reading or writing a tile failed.
+
+    @ingroup magma_ooc
+*******************************************************************************/
+extern "C" magma_int_t
+magma_ooc_tile_acquire(
+    magma_ooc_t A, magma_int_t i, magma_int_t j, magma_ooc_access_t access,
+    void** T_ptr, magma_int_t* ldt )
+{
+    magma_int_t info = 0;
+    if (A == NULL)
+        info = -1;
+    else if (i < 0 || i >= A->mt)
+        info = -2;
+    else if (j < 0 || j >= A->nt)
+        info = -3;
+    else if (access != MagmaOOCRead && access != MagmaOOCWrite &&
+             access != MagmaOOCReadWrite)
+        info = -4;
+
+    if (info != 0) {
+        magma_xerbla( __func__, -(info) );
+        return info;
+    }
+
+    real_Double_t time = magma_wtime();
+    magma_int_t t = i + j*A->mt;
+    magma_ooc_tile* tile = &A->tiles[t];
+
+    pthread_mutex_lock( &A->mutex );
+    while (A->io_error == 0) {
+        if (tile->state == ooc_resident
+            && ! (access != MagmaOOCRead && tile->writing))
+        {
+            break;
+        }
+        if (tile->state == ooc_absent) {
+            magma_int_t victim;
+            magma_int_t s = ooc_find_slot( A, false, &victim );
+            if (s >= 0) {
+                if (victim >= 0) {
+                    ooc_evict( A, victim );
+                    if (tile->state != ooc_absent) {
+                        continue;  // prefetched while the victim was written
+                    }
+                }
+                A->slot_tile[s] = t;
+                tile->slot = s;
+                if (access == MagmaOOCWrite) {
+                    tile->state = ooc_resident;
+                    break;
+                }
+                tile->state = ooc_loading;
+                pthread_mutex_unlock( &A->mutex );
+                magma_int_t err = ooc_tile_io( A, t, false );
+                pthread_mutex_lock( &A->mutex );
+                tile->state = ooc_resident;
+                A->bytes_read += ooc_tile_bytes( A, t );
+                if (err != 0) {
+                    A->io_error = err;
+                }
+                pthread_cond_broadcast( &A->cond );
+                continue;
+            }
+        }
+        // wait for a read or write of this tile, or for a free slot
+        pthread_cond_wait( &A->cond, &A->mutex );
+    }
+
+    info = A->io_error;
+    if (info == 0) {
+        tile->pin       += 1;
+        tile->stamp      = ++A->stamp;
+        tile->prefetched = false;
+        if (access != MagmaOOCRead) {
+            tile->dirty = true;
+        }
+        *T_ptr = A->slots + tile->slot * A->tilebytes;
+        *ldt   = A->nb;
+    }
+    A->wait_time += magma_wtime() - time;
+    pthread_mutex_unlock( &A->mutex );
+    return info;
+}
+
+
+/***************************************************************************//**
+    Releases tile (i, j), acquired by magma_ooc_tile_acquire.
+    If the tile was modified, it is written to the file asynchronously.
+
+    @ingroup magma_ooc
+*******************************************************************************/
+extern "C" void
+magma_ooc_tile_release(
+    magma_ooc_t A, magma_int_t i, magma_int_t j )
+{
+    magma_int_t t = i + j*A->mt;
+    magma_ooc_tile* tile = &A->tiles[t];
+
+    pthread_mutex_lock( &A->mutex );
+    assert( tile->pin > 0 );
+    tile->pin -= 1;
+    if (tile->pin == 0 && tile->dirty && ! tile->writing) {
+        tile->writing = true;
+        A->queue.push_task( new magma_ooc_task( A, t, true ));
+    }
+    pthread_cond_broadcast( &A->cond );
+    pthread_mutex_unlock( &A->mutex );
+}
+
+
+/***************************************************************************//**
+    Starts asynchronous reads of the tiles covering the M-by-N submatrix
+    A(ia:ia+m-1, ja:ja+n-1), in column-major tile order, up to the
+    look-ahead window of A. Tiles that are already in the cache count
+    toward the window. Returns without waiting for the reads.
+
+    @ingroup magma_ooc
+*******************************************************************************/
+extern "C" void
+magma_ooc_prefetch(
+    magma_int_t m, magma_int_t n,
+    magma_ooc_t A, magma_int_t ia, magma_int_t ja )
+{
+    if (m <= 0 || n <= 0) {
+        return;
+    }
+    magma_int_t nb  = A->nb;
+    magma_int_t cnt = 0;
+    for (magma_int_t j = ja/nb; j <= (ja + n - 1)/nb; ++j) {
+        for (magma_int_t i = ia/nb; i <= (ia + m - 1)/nb; ++i) {
+            if (cnt++ >= A->lookahead || ! ooc_prefetch_tile( A, i + j*A->mt )) {
+                return;
+            }
+        }
+    }
+}
+
+
+/***************************************************************************//**
+    Copies the M-by-N matrix hA_src, in LAPACK layout, to the submatrix
+    B(ib:ib+m-1, jb:jb+n-1) of out-of-core matrix B.
+    Tiles that are completely overwritten are not read from the file.
+    Tiles are written to the file asynchronously.
+
+    @return MAGMA_SUCCESS, or
+            MAGMA_ERR_FILESYSTEM if reading or writing a tile failed.
+
+    @ingroup magma_ooc
+*******************************************************************************/
+extern "C" magma_int_t
+magma_ooc_setmatrix(
+    magma_int_t m, magma_int_t n,
+    const void* hA_src, magma_int_t lda,
+    magma_ooc_t B,      magma_int_t ib, magma_int_t jb )
+{
+    magma_int_t info = 0;
+    if (m < 0)
+        info = -1;
+    else if (n < 0)
+        info = -2;
+    else if (lda < max( 1, m ))
+        info = -4;
+    else if (ib < 0 || ib + m > B->m)
+        info = -6;
+    else if (jb < 0 || jb + n > B->n)
+        info = -7;
+
+    if (info != 0) {
+        magma_xerbla( __func__, -(info) );
+        return info;
+    }
+    if (m == 0 || n == 0) {
+        return info;
+    }
+
+    const char* hA = (const char*) hA_src;
+    magma_int_t nb = B->nb;
+    size_t es = B->elemsize;
+    for (magma_int_t j = jb/nb; j <= (jb + n - 1)/nb && info == 0; ++j) {
+        magma_int_t j0 = max( jb,     j*nb );
+        magma_int_t j1 = min( jb + n, min( (j+1)*nb, B->n ));
+        for (magma_int_t i = ib/nb; i <= (ib + m - 1)/nb; ++i) {
+            magma_int_t i0 = max( ib,     i*nb );
+            magma_int_t i1 = min( ib + m, min( (i+1)*nb, B->m ));
+            bool whole = (i0 == i*nb && i1 == min( (i+1)*nb, B->m ) &&
+                          j0 == j*nb && j1 == min( (j+1)*nb, B->n ));
+            char* T;
+            magma_int_t ldt;
+            info = magma_ooc_tile_acquire( B, i, j,
+                                           (whole ? MagmaOOCWrite : MagmaOOCReadWrite),
+                                           (void**) &T, &ldt );
+            if (info != 0) {
+                break;
+            }
+            for (magma_int_t jj = j0; jj < j1; ++jj) {
+                memcpy( T  + ((i0 - i*nb) + (jj - j*nb)*ldt) * es,
+                        hA + ((i0 - ib)   + (jj - jb)*lda) * es,
+                        (i1 - i0) * es );
+            }
+            magma_ooc_tile_release( B, i, j );
+        }
+    }
+    return info;
+}
+
+
+/***************************************************************************//**
+    Copies the M-by-N submatrix A(ia:ia+m-1, ja:ja+n-1) of out-of-core
+    matrix A to hB_dst, in LAPACK layout. Tiles are read ahead
+    asynchronously, up to the look-ahead window of A.
+
+    @return MAGMA_SUCCESS, or
+            MAGMA_ERR_FILESYSTEM if reading or writing a tile failed.
+
+    @ingroup magma_ooc
+*******************************************************************************/
+extern "C" magma_int_t
+magma_ooc_getmatrix(
+    magma_int_t m, magma_int_t n,
+    magma_ooc_t A, magma_int_t ia, magma_int_t ja,
+    void* hB_dst,  magma_int_t ldb )
+{
+    magma_int_t info = 0;
+    if (m < 0)
+        info = -1;
+    else if (n < 0)
+        info = -2;
+    else if (ia < 0 || ia + m > A->m)
+        info = -4;
+    else if (ja < 0 || ja + n > A->n)
+        info = -5;
+    else if (ldb < max( 1, m ))
+        info = -7;
+
+    if (info != 0) {
+        magma_xerbla( __func__, -(info) );
+        return info;
+    }
+    if (m == 0 || n == 0) {
+        return info;
+    }
+
+    char* hB = (char*) hB_dst;
+    magma_int_t nb  = A->nb;
+    size_t es = A->elemsize;
+    magma_int_t it0 = ia/nb;
+    magma_int_t jt0 = ja/nb;
+    magma_int_t mt  = (ia + m - 1)/nb - it0 + 1;  // tiles in submatrix
+    magma_int_t nt  = (ja + n - 1)/nb - jt0 + 1;
+
+    magma_ooc_prefetch( m, n, A, ia, ja );
+    for (magma_int_t p = 0; p < mt*nt; ++p) {
+        // keep the window full: read ahead tile p + lookahead
+        magma_int_t q = p + A->lookahead;
+        if (A->lookahead > 0 && q < mt*nt) {
+            ooc_prefetch_tile( A, (it0 + q % mt) + (jt0 + q / mt)*A->mt );
+        }
+
+        magma_int_t i  = it0 + p % mt;
+        magma_int_t j  = jt0 + p / mt;
+        magma_int_t i0 = max( ia,     i*nb );
+        magma_int_t i1 = min( ia + m, min( (i+1)*nb, A->m ));
+        magma_int_t j0 = max( ja,     j*nb );
+        magma_int_t j1 = min( ja + n, min( (j+1)*nb, A->n ));
+        char* T;
+        magma_int_t ldt;
+        info = magma_ooc_tile_acquire( A, i, j, MagmaOOCRead, (void**) &T, &ldt );
+        if (info != 0) {
+            break;
+        }
+        for (magma_int_t jj = j0; jj < j1; ++jj) {
+            memcpy( hB + ((i0 - ia)   + (jj - ja)*ldb) * es,
+                    T  + ((i0 - i*nb) + (jj - j*nb)*ldt) * es,
+                    (i1 - i0) * es );
+        }
+        magma_ooc_tile_release( A, i, j );
+    }
+    return info;
+}
+
+
+/***************************************************************************//**
+    Waits for all asynchronous reads and writes, then writes all modified
+    tiles that are not acquired to the file.
+
+    @return MAGMA_SUCCESS, or
+            MAGMA_ERR_FILESYSTEM if reading or writing a tile failed.
+
+    @ingroup magma_ooc
+*******************************************************************************/
+extern "C" magma_int_t
+magma_ooc_flush( magma_ooc_t A )
+{
+    A->queue.sync();
+    pthread_mutex_lock( &A->mutex );
+    for (magma_int_t s = 0; s < A->nslot; ++s) {
+        magma_int_t t = A->slot_tile[s];
+        if (t >= 0) {
+            magma_ooc_tile* tile = &A->tiles[t];
+            if (tile->state == ooc_resident && tile->dirty
+                && tile->pin == 0 && ! tile->writing)
+            {
+                tile->writing = true;
+                A->queue.push_task( new magma_ooc_task( A, t, true ));
+            }
+        }
+    }
+    pthread_mutex_unlock( &A->mutex );
+    A->queue.sync();
+    return A->io_error;
+}
+
+
+/***************************************************************************//**
+    Returns the bytes read from and written to the file, and the time spent
+    waiting in magma_ooc_tile_acquire for tiles to be read or slots to be
+    freed, since A was created or the last magma_ooc_reset_stats.
+    Any output may be NULL.
+
+    @ingroup magma_ooc
+*******************************************************************************/
+extern "C" void
+magma_ooc_get_stats(
+    magma_ooc_t A,
+    double* bytes_read, double* bytes_written, double* wait_time )
+{
+    pthread_mutex_lock( &A->mutex );
+    if (bytes_read    != NULL) *bytes_read    = A->bytes_read;
+    if (bytes_written != NULL) *bytes_written = A->bytes_written;
+    if (wait_time     != NULL) *wait_time     = A->wait_time;
+    pthread_mutex_unlock( &A->mutex );
+}
+
+
+/***************************************************************************//**
+    Resets the statistics returned by magma_ooc_get_stats.
+
+    @ingroup magma_ooc
+*******************************************************************************/
+extern "C" void
+magma_ooc_reset_stats( magma_ooc_t A )
+{
+    pthread_mutex_lock( &A->mutex );
+    A->bytes_read    = 0;
+    A->bytes_written = 0;
+    A->wait_time     = 0;
+    pthread_mutex_unlock( &A->mutex );
+}
@@ -245,3 +245,69 @@ void magma_set_omp_numthreads(magma_int_t threads)
     omp_set_num_threads( threads );
 #endif
 }
+
+
+// -1 until read from $MAGMA_PANEL_NUM_THREADS
+static magma_int_t g_panel_numthreads = -1;
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    @return Number of threads the hybrid magma_zgetrf, magma_zgeqrf, and
+    magma_zpotrf (and other precisions) use to factor panels on the CPU with
+    the recursive magma_zgetrf_rec_cpu, magma_zgeqrf_rec_cpu, and
+    magma_zpotrf_rec_cpu. If 0, they use LAPACK, with its own threads.
+
+    It is initially set by the environment variable MAGMA_PANEL_NUM_THREADS,
+    or 0 if that is not set. The panel threads use single-threaded BLAS
+    without changing the BLAS thread setting.
+
+    @sa magma_set_panel_numthreads
+    @ingroup magma_thread
+*******************************************************************************/
+extern "C"
+magma_int_t magma_get_panel_numthreads()
+{
+    if ( g_panel_numthreads < 0 ) {
+        const char *threads_str = getenv("MAGMA_PANEL_NUM_THREADS");
+        magma_int_t threads = 0;
+        if ( threads_str != NULL ) {
+            char* endptr;
+            threads = strtol( threads_str, &endptr, 10 );
+            if ( threads < 0 || *endptr != '\0' ) {
+                threads = 0;
+                fprintf( stderr, "$MAGMA_PANEL_NUM_THREADS='%s' is an invalid number; using LAPACK panels.\n",
+                         threads_str );
+            }
+        }
+        g_panel_numthreads = threads;
+    }
+    return g_panel_numthreads;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Sets the number of threads the hybrid factorizations use to factor
+    panels on the CPU, overriding MAGMA_PANEL_NUM_THREADS.
+
+    Arguments
+    ---------
+    @param[in]
+    threads INTEGER
+            Number of panel threads. If threads = 0, panels are factored
+            by LAPACK. If threads < 0, this silently does nothing.
+
+    @sa magma_get_panel_numthreads
+    @ingroup magma_thread
+*******************************************************************************/
+extern "C"
+void magma_set_panel_numthreads(magma_int_t threads)
+{
+    if ( threads < 0 ) {
+        return;
+    }
+    g_panel_numthreads = threads;
+}
@@ -23,6 +23,8 @@ void magma_set_lapack_numthreads(magma_int_t numthreads);
 magma_int_t magma_get_lapack_numthreads();
 magma_int_t magma_get_parallel_numthreads();
 magma_int_t magma_get_omp_numthreads();
+magma_int_t magma_get_panel_numthreads();
+void magma_set_panel_numthreads(magma_int_t numthreads);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,582 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       Host matrices in tile (block data) layout: each NB-by-NB tile is
+       contiguous, so BLAS calls on a tile touch few pages and cache lines,
+       independent of the matrix size.
+*/
+#include <string.h>
+
+#include <new>  // std::nothrow
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "magma_internal.h"
+
+
+/******************************************************************************/
+struct magma_tile
+{
+    magma_int_t m, n, nb, mt, nt;
+    size_t      elemsize;
+    magma_int_t ldt;       // leading dimension of every tile if padded; 0 if compact
+    magma_int_t nthreads;  // tile column j is owned by thread j % nthreads
+    char*       data;
+    bool        attached;  // data is the caller's LAPACK matrix, converted in place
+};
+
+
+/******************************************************************************/
+// Offset, in elements, of tile (i, j), and its leading dimension.
+// Compact: tile column j is the m-by-jb LAPACK block column, with its
+// tiles stored one after the other; tile (i, j) is ib-by-jb with ld ib.
+// Padded: all tiles are ldt-by-nb, with ldt >= nb padded to the alignment.
+static size_t tile_offset( magma_tile_t A, magma_int_t i, magma_int_t j, magma_int_t* ldt )
+{
+    if (A->ldt > 0) {
+        *ldt = A->ldt;
+        return (size_t(j)*A->mt + i) * A->ldt * A->nb;
+    }
+    magma_int_t jb = min( A->nb, A->n - j*A->nb );
+    *ldt = max( 1, min( A->nb, A->m - i*A->nb ));
+    return size_t(j)*A->nb*A->m + size_t(i)*A->nb*jb;
+}
+
+
+/******************************************************************************/
+// Bytes from the start of tile column j to the start of tile column j+1.
+static size_t tile_column_bytes( magma_tile_t A, magma_int_t j )
+{
+    magma_int_t ldt;
+    size_t begin = tile_offset( A, 0, j, &ldt );
+    size_t end = (j + 1 < A->nt
+                  ? tile_offset( A, 0, j + 1, &ldt )
+                  : (A->ldt > 0 ? size_t(A->nt)*A->mt*A->ldt*A->nb
+                                : size_t(A->m)*A->n));
+    return (end - begin) * A->elemsize;
+}
+
+
+/******************************************************************************/
+// Copies block column j between LAPACK layout, L pointing to its first
+// element with leading dimension lda, and tiles of A, in the direction
+// given by to_tile.
+static void tile_copy_column(
+    magma_tile_t A, magma_int_t j, char* L, magma_int_t lda, bool to_tile )
+{
+    size_t es = A->elemsize;
+    magma_int_t nb = A->nb;
+    magma_int_t jb = min( nb, A->n - j*nb );
+    for (magma_int_t i = 0; i < A->mt; ++i) {
+        magma_int_t ib = min( nb, A->m - i*nb );
+        magma_int_t ldt;
+        char* T  = A->data + tile_offset( A, i, j, &ldt ) * es;
+        char* Li = L + size_t(i)*nb*es;
+        for (magma_int_t jj = 0; jj < jb; ++jj) {
+            if (to_tile)
+                memcpy( T + size_t(jj)*ldt*es, Li + size_t(jj)*lda*es, ib*es );
+            else
+                memcpy( Li + size_t(jj)*lda*es, T + size_t(jj)*ldt*es, ib*es );
+        }
+    }
+}
+
+
+/******************************************************************************/
+// Converts compact block column j in place, between its m-by-jb LAPACK
+// layout (lda = m) and its tiles, which occupy the same bytes,
+// through the m-by-nb workspace W.
+static void tile_convert_column(
+    magma_tile_t A, magma_int_t j, char* W, bool to_tile )
+{
+    magma_int_t ldt;
+    char* C = A->data + tile_offset( A, 0, j, &ldt ) * A->elemsize;
+    size_t bytes = tile_column_bytes( A, j );
+    if (to_tile) {
+        memcpy( W, C, bytes );
+        tile_copy_column( A, j, W, A->m, true );
+    }
+    else {
+        tile_copy_column( A, j, W, A->m, false );
+        memcpy( C, W, bytes );
+    }
+}
+
+
+/******************************************************************************/
+// Team size: nthreads, or magma_get_parallel_numthreads if nthreads <= 0,
+// but no more than the number of tile columns.
+static magma_int_t tile_team_size( magma_int_t nthreads, magma_int_t nt )
+{
+    if (nthreads <= 0) {
+        nthreads = magma_get_parallel_numthreads();
+    }
+    return max( 1, min( nthreads, nt ));
+}
+
+
+/******************************************************************************/
+// Allocates the descriptor; the caller sets data and attached.
+static magma_int_t tile_init(
+    magma_int_t m, magma_int_t n, magma_int_t nb, size_t elemsize,
+    magma_int_t ldt, magma_int_t nthreads, magma_tile_t* A_ptr )
+{
+    magma_tile_t A = new (std::nothrow) magma_tile;
+    if (A == NULL) {
+        return MAGMA_ERR_HOST_ALLOC;
+    }
+    A->m        = m;
+    A->n        = n;
+    A->nb       = nb;
+    A->mt       = magma_ceildiv( m, nb );
+    A->nt       = magma_ceildiv( n, nb );
+    A->elemsize = elemsize;
+    A->ldt      = ldt;
+    A->nthreads = tile_team_size( nthreads, A->nt );
+    A->data     = NULL;
+    A->attached = false;
+    *A_ptr = A;
+    return MAGMA_SUCCESS;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Creates an M-by-N host matrix A in tile layout: A is divided into
+    NB-by-NB tiles (smaller on the bottom and right edges), each stored
+    contiguously, column-major; the tiles are stored in column-major order.
+
+    Tile column j is owned by thread j % NTHREADS, which first touches its
+    memory, so on NUMA systems each tile column is placed in the memory of
+    its owner. The conversions to and from LAPACK layout and the tile
+    factorizations (magma_zpotrf_tile_cpu, etc.) update each tile column by
+    its owner, using the same number of threads.
+
+    The initial contents of A are zero.
+
+    Arguments
+    ---------
+    @param[in]
+    m           Number of rows of A. M >= 0.
+
+    @param[in]
+    n           Number of columns of A. N >= 0.
+
+    @param[in]
+    nb          Tile size. NB > 0.
+
+    @param[in]
+    elemsize    Size of each element, e.g., sizeof(magmaDoubleComplex).
+
+    @param[in]
+    align       If ALIGN = 0, tiles are compact: tile (i,j) is exactly
+                ib-by-jb, and A takes M*N elements.
+                If ALIGN > 0, the columns of every tile are padded to a
+                multiple of ALIGN bytes, e.g., 64 for cache lines, and all
+                tiles are allocated NB-by-NB, so each tile column starts on
+                an ALIGN boundary. ALIGN must be a multiple of ELEMSIZE.
+
+    @param[in]
+    nthreads    Number of threads that own the tile columns.
+                If NTHREADS <= 0, magma_get_parallel_numthreads() is used.
+
+    @param[out]
+    A_ptr       On exit, the new tiled matrix.
+
+    @return MAGMA_SUCCESS, or
+            MAGMA_ERR_HOST_ALLOC if A could not be allocated.
+
+    @ingroup magma_tile
+*******************************************************************************/
+extern "C" magma_int_t
+magma_tile_create(
+    magma_int_t m, magma_int_t n, magma_int_t nb, size_t elemsize,
+    magma_int_t align, magma_int_t nthreads,
+    magma_tile_t* A_ptr )
+{
+    magma_int_t info = 0;
+    if (m < 0)
+        info = -1;
+    else if (n < 0)
+        info = -2;
+    else if (nb <= 0)
+        info = -3;
+    else if (elemsize == 0)
+        info = -4;
+    else if (align < 0 || align % elemsize != 0)
+        info = -5;
+    else if (A_ptr == NULL)
+        info = -7;
+
+    if (info != 0) {
+        magma_xerbla( __func__, -(info) );
+        return info;
+    }
+
+    *A_ptr = NULL;
+    magma_int_t ldt = 0;
+    if (align > 0) {
+        ldt = magma_roundup( nb*elemsize, align ) / elemsize;
+    }
+    magma_tile_t A;
+    info = tile_init( m, n, nb, elemsize, ldt, nthreads, &A );
+    if (info != 0) {
+        return info;
+    }
+
+    size_t bytes = (ldt > 0 ? size_t(A->mt)*A->nt*ldt*nb : size_t(m)*n) * elemsize;
+    if (MAGMA_SUCCESS != magma_malloc_cpu( (void**) &A->data, max( bytes, elemsize ))) {
+        delete A;
+        return MAGMA_ERR_HOST_ALLOC;
+    }
+
+    // first touch by the owner of each tile column
+    #pragma omp parallel num_threads( A->nthreads )
+    {
+        #ifdef _OPENMP
+        magma_int_t tid  = omp_get_thread_num();
+        magma_int_t nthr = omp_get_num_threads();
+        #else
+        magma_int_t tid  = 0;
+        magma_int_t nthr = 1;
+        #endif
+        for (magma_int_t j = tid; j < A->nt; j += nthr) {
+            magma_int_t ldt_;
+            memset( A->data + tile_offset( A, 0, j, &ldt_ ) * elemsize, 0,
+                    tile_column_bytes( A, j ));
+        }
+    }
+
+    *A_ptr = A;
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Converts the M-by-N matrix hA, in LAPACK layout with LDA = M, to compact
+    tile layout in place, and returns a tiled matrix A that uses hA as its
+    storage. Block columns are converted in parallel, each by the thread
+    that owns it, through an M-by-NB workspace per thread, so the
+    conversion needs no second copy of the matrix.
+    Use magma_tile_detach to convert hA back to LAPACK layout.
+
+    Arguments
+    ---------
+    @param[in]
+    m           Number of rows of hA. M >= 0.
+
+    @param[in]
+    n           Number of columns of hA. N >= 0.
+
+    @param[in]
+    nb          Tile size. NB > 0.
+
+    @param[in]
+    elemsize    Size of each element, e.g., sizeof(magmaDoubleComplex).
+
+    @param[in,out]
+    hA          Array of dimension (LDA,N).
+                On entry, the M-by-N matrix in LAPACK layout.
+                On exit, the same matrix in compact tile layout.
+
+    @param[in]
+    lda         Leading dimension of hA. LDA = max(1,M); padded leading
+                dimensions are not supported, since the tiles would not be
+                contiguous.
+
+    @param[in]
+    nthreads    Number of threads that own the tile columns.
+                If NTHREADS <= 0, magma_get_parallel_numthreads() is used.
+
+    @param[out]
+    A_ptr       On exit, the tiled matrix.
+
+    @return MAGMA_SUCCESS, or
+            MAGMA_ERR_HOST_ALLOC if the workspace could not be allocated.
+
+    @ingroup magma_tile
+*******************************************************************************/
+extern "C" magma_int_t
+magma_tile_attach(
+    magma_int_t m, magma_int_t n, magma_int_t nb, size_t elemsize,
+    void* hA, magma_int_t lda, magma_int_t nthreads,
+    magma_tile_t* A_ptr )
+{
+    magma_int_t info = 0;
+    if (m < 0)
+        info = -1;
+    else if (n < 0)
+        info = -2;
+    else if (nb <= 0)
+        info = -3;
+    else if (elemsize == 0)
+        info = -4;
+    else if (hA == NULL && m*n > 0)
+        info = -5;
+    else if (lda != max( 1, m ))
+        info = -6;
+    else if (A_ptr == NULL)
+        info = -8;
+
+    if (info != 0) {
+        magma_xerbla( __func__, -(info) );
+        return info;
+    }
+
+    *A_ptr = NULL;
+    magma_tile_t A;
+    info = tile_init( m, n, nb, elemsize, 0, nthreads, &A );
+    if (info != 0) {
+        return info;
+    }
+    A->data     = (char*) hA;
+    A->attached = true;
+
+    char* work = NULL;
+    size_t lwork = size_t(m) * nb * elemsize;
+    if (A->mt > 1) {  // with one tile row, both layouts are the same
+        if (MAGMA_SUCCESS != magma_malloc_cpu( (void**) &work, lwork * A->nthreads )) {
+            delete A;
+            return MAGMA_ERR_HOST_ALLOC;
+        }
+        #pragma omp parallel num_threads( A->nthreads )
+        {
+            #ifdef _OPENMP
+            magma_int_t tid  = omp_get_thread_num();
+            magma_int_t nthr = omp_get_num_threads();
+            #else
+            magma_int_t tid  = 0;
+            magma_int_t nthr = 1;
+            #endif
+            for (magma_int_t j = tid; j < A->nt; j += nthr) {
+                tile_convert_column( A, j, work + tid*lwork, true );
+            }
+        }
+        magma_free_cpu( work );
+    }
+
+    *A_ptr = A;
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Converts a tiled matrix created by magma_tile_attach back to LAPACK
+    layout in place, with LDA = M, and destroys the descriptor.
+
+    @param[in]
+    A       Tiled matrix to detach. May be NULL.
+
+    @return MAGMA_SUCCESS, or
+            MAGMA_ERR_HOST_ALLOC if the workspace could not be allocated;
+            then A is not changed.
+
+    @ingroup magma_tile
+*******************************************************************************/
+extern "C" magma_int_t
+magma_tile_detach( magma_tile_t A )
+{
+    if (A == NULL) {
+        return MAGMA_SUCCESS;
+    }
+    if (! A->attached) {
+        magma_xerbla( __func__, 1 );
+        return -1;
+    }
+
+    char* work = NULL;
+    size_t lwork = size_t(A->m) * A->nb * A->elemsize;
+    if (A->mt > 1) {  // with one tile row, both layouts are the same
+        if (MAGMA_SUCCESS != magma_malloc_cpu( (void**) &work, lwork * A->nthreads )) {
+            return MAGMA_ERR_HOST_ALLOC;
+        }
+        #pragma omp parallel num_threads( A->nthreads )
+        {
+            #ifdef _OPENMP
+            magma_int_t tid  = omp_get_thread_num();
+            magma_int_t nthr = omp_get_num_threads();
+            #else
+            magma_int_t tid  = 0;
+            magma_int_t nthr = 1;
+            #endif
+            for (magma_int_t j = tid; j < A->nt; j += nthr) {
+                tile_convert_column( A, j, work + tid*lwork, false );
+            }
+        }
+        magma_free_cpu( work );
+    }
+    delete A;
+    return MAGMA_SUCCESS;
+}
+
+
+/***************************************************************************//**
+    Destroys a tiled matrix created by magma_tile_create, freeing its
+    memory. For a matrix created by magma_tile_attach, only the descriptor
+    is freed, and the caller's array is left in tile layout.
+
+    @param[in]
+    A       Tiled matrix to destroy. May be NULL.
+
+    @ingroup magma_tile
+*******************************************************************************/
+extern "C" void
+magma_tile_destroy( magma_tile_t A )
+{
+    if (A == NULL) {
+        return;
+    }
+    if (! A->attached) {
+        magma_free_cpu( A->data );
+    }
+    delete A;
+}
+
+
+/***************************************************************************//**
+    Returns the dimensions, tile size, and element size of a tiled matrix.
+    Any output may be NULL.
+
+    @ingroup magma_tile
+*******************************************************************************/
+extern "C" void
+magma_tile_getsize(
+    magma_tile_t A,
+    magma_int_t* m, magma_int_t* n, magma_int_t* nb, size_t* elemsize )
+{
+    if (m        != NULL) *m        = A->m;
+    if (n        != NULL) *n        = A->n;
+    if (nb       != NULL) *nb       = A->nb;
+    if (elemsize != NULL) *elemsize = A->elemsize;
+}
+
+
+/***************************************************************************//**
+    Returns the number of threads that own the tile columns of A;
+    tile column j is owned by thread j % nthreads.
+
+    @ingroup magma_tile
+*******************************************************************************/
+extern "C" magma_int_t
+magma_tile_get_nthreads( magma_tile_t A )
+{
+    return A->nthreads;
+}
+
+
+/***************************************************************************//**
+    Returns a pointer to tile (i, j) of a tiled matrix, and its leading
+    dimension in ldt. Tile (i, j) holds rows i*NB to min((i+1)*NB, M) - 1
+    and columns j*NB to min((j+1)*NB, N) - 1 of A, stored column-major.
+
+    @ingroup magma_tile
+*******************************************************************************/
+extern "C" void*
+magma_tile_ptr(
+    magma_tile_t A, magma_int_t i, magma_int_t j, magma_int_t* ldt )
+{
+    return A->data + tile_offset( A, i, j, ldt ) * A->elemsize;
+}
+
+
+/***************************************************************************//**
+    Copies the matrix hA_src, in LAPACK layout, to tiled matrix B, of the
+    same size. Each tile column is copied by the thread that owns it.
+
+    @param[in]
+    hA_src  Array of dimension (LDA,N), the M-by-N matrix to copy.
+
+    @param[in]
+    lda     Leading dimension of hA_src. LDA >= max(1,M).
+
+    @param[out]
+    B       Tiled matrix.
+
+    @ingroup magma_tile
+*******************************************************************************/
+extern "C" magma_int_t
+magma_tile_setmatrix(
+    const void* hA_src, magma_int_t lda,
+    magma_tile_t B )
+{
+    magma_int_t info = 0;
+    if (lda < max( 1, B->m ))
+        info = -2;
+
+    if (info != 0) {
+        magma_xerbla( __func__, -(info) );
+        return info;
+    }
+
+    #pragma omp parallel num_threads( B->nthreads )
+    {
+        #ifdef _OPENMP
+        magma_int_t tid  = omp_get_thread_num();
+        magma_int_t nthr = omp_get_num_threads();
+        #else
+        magma_int_t tid  = 0;
+        magma_int_t nthr = 1;
+        #endif
+        for (magma_int_t j = tid; j < B->nt; j += nthr) {
+            tile_copy_column( B, j, (char*) hA_src + size_t(j)*B->nb*lda*B->elemsize, lda, true );
+        }
+    }
+    return info;
+}
+
+
+/***************************************************************************//**
+    Copies tiled matrix A to hB_dst, in LAPACK layout.
+    Each tile column is copied by the thread that owns it.
+
+    @param[in]
+    A       Tiled M-by-N matrix.
+
+    @param[out]
+    hB_dst  Array of dimension (LDB,N). On exit, the M-by-N matrix A.
+
+    @param[in]
+    ldb     Leading dimension of hB_dst. LDB >= max(1,M).
+
+    @ingroup magma_tile
+*******************************************************************************/
+extern "C" magma_int_t
+magma_tile_getmatrix(
+    magma_tile_t A,
+    void* hB_dst, magma_int_t ldb )
+{
+    magma_int_t info = 0;
+    if (ldb < max( 1, A->m ))
+        info = -3;
+
+    if (info != 0) {
+        magma_xerbla( __func__, -(info) );
+        return info;
+    }
+
+    #pragma omp parallel num_threads( A->nthreads )
+    {
+        #ifdef _OPENMP
+        magma_int_t tid  = omp_get_thread_num();
+        magma_int_t nthr = omp_get_num_threads();
+        #else
+        magma_int_t tid  = 0;
+        magma_int_t nthr = 1;
+        #endif
+        for (magma_int_t j = tid; j < A->nt; j += nthr) {
+            tile_copy_column( A, j, (char*) hB_dst + size_t(j)*A->nb*ldb*A->elemsize, ldb, false );
+        }
+    }
+    return info;
+}
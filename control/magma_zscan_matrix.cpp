@@ -0,0 +1,447 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+       One-pass scan of a matrix on the CPU host for NAN and INF values,
+       norms, and Hermitian symmetry, to check the input of a factorization.
+*/
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "magma_internal.h"
+
+#define COMPLEX
+
+#define A(i_, j_) (A + (i_) + (j_)*lda)
+
+// Tile size of the scan. For the symmetry defect, tiles (I,J) and (J,I) are
+// scanned one after the other, then compared while both are in cache.
+static const magma_int_t scan_nb = 64;
+
+
+/******************************************************************************/
+// Statistics accumulated by each thread.
+struct zscan_stats {
+    magma_int_t nan, inf;
+    double cmax;      // max |real(a_ij)|, |imag(a_ij)|, to detect over/underflow
+    double amax;      // max |a_ij|
+    double ssq;       // sum |a_ij|^2
+    double ssq_diag;  // sum real(a_jj)^2, for Hermitian storage
+    double defect;    // max |a_ij - conj(a_ji)|, component-wise
+};
+
+
+/******************************************************************************/
+// Returns |a|^2, and in c the larger of |real(a)| and |imag(a)|.
+// Classifies a without branches, as magma_z_isnan and magma_z_isinf do;
+// NAN takes priority over INF.
+static inline double zscan_abs2(
+    magmaDoubleComplex a, double *c, magma_int_t *is_nan, magma_int_t *is_inf )
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    double re = fabs( MAGMA_Z_REAL( a ));
+    #ifdef COMPLEX
+    double im = fabs( MAGMA_Z_IMAG( a ));
+    *is_nan = (re != re) | (im != im);
+    *is_inf = (1 - *is_nan) & ((re == inf) | (im == inf));
+    *c = (re > im ? re : im);
+    return re*re + im*im;
+    #else
+    *is_nan = (re != re);
+    *is_inf = (re == inf);
+    *c = re;
+    return re*re;
+    #endif
+}
+
+
+/******************************************************************************/
+// Scans x(0:mlen-1), a segment of column j.
+// Adds |x(i)| to rowsum(i) and the sum of |x(i)| to colsum_j.
+static void zscan_col(
+    magma_int_t mlen, const magmaDoubleComplex *x,
+    double *rowsum, double *colsum_j, zscan_stats *st )
+{
+    magma_int_t c_nan = 0, c_inf = 0;
+    double cmax = st->cmax, amax = st->amax, ssq = 0, csum = 0;
+
+    #pragma omp simd reduction(+:c_nan,c_inf,ssq,csum) reduction(max:cmax,amax)
+    for (magma_int_t i = 0; i < mlen; ++i) {
+        double c;
+        magma_int_t is_nan, is_inf;
+        double a2 = zscan_abs2( x[i], &c, &is_nan, &is_inf );
+        double a  = sqrt( a2 );
+        c_nan += is_nan;
+        c_inf += is_inf;
+        cmax = (c > cmax ? c : cmax);
+        amax = (a > amax ? a : amax);
+        ssq  += a2;
+        csum += a;
+        rowsum[i] += a;
+    }
+    st->nan  += c_nan;
+    st->inf  += c_inf;
+    st->cmax  = cmax;
+    st->amax  = amax;
+    st->ssq  += ssq;
+    *colsum_j += csum;
+}
+
+
+/******************************************************************************/
+// Checks x(0:mlen-1), a segment of column j, against conj(y(0:mlen-1)),
+// the matching segment of row j, which has stride lda.
+// Updates the symmetry defect max |x(i) - conj(y(i))|, component-wise.
+static void zscan_defect(
+    magma_int_t mlen,
+    const magmaDoubleComplex *x, const magmaDoubleComplex *y, magma_int_t lda,
+    zscan_stats *st )
+{
+    double defect = st->defect;
+
+    #pragma omp simd reduction(max:defect)
+    for (magma_int_t i = 0; i < mlen; ++i) {
+        double d = fabs( MAGMA_Z_REAL( x[i] ) - MAGMA_Z_REAL( y[i*lda] ));
+        #ifdef COMPLEX
+        double di = fabs( MAGMA_Z_IMAG( x[i] ) + MAGMA_Z_IMAG( y[i*lda] ));
+        d = (di > d ? di : d);
+        #endif
+        defect = (d > defect ? d : defect);
+    }
+    st->defect = defect;
+}
+
+
+/******************************************************************************/
+// Scans the diagonal element a = A(j,j) of a Hermitian matrix. As in LAPACK
+// zlanhe, only real(a) enters the norms; imag(a) is the symmetry defect.
+static void zscan_diag_herm(
+    magmaDoubleComplex a, double *colsum_j, zscan_stats *st )
+{
+    double c;
+    magma_int_t is_nan, is_inf;
+    zscan_abs2( a, &c, &is_nan, &is_inf );
+    st->nan += is_nan;
+    st->inf += is_inf;
+
+    double re = fabs( MAGMA_Z_REAL( a ));
+    st->cmax = max( st->cmax, re );
+    st->amax = max( st->amax, re );
+    st->ssq_diag += re*re;
+    *colsum_j += re;
+    #ifdef COMPLEX
+    st->defect = max( st->defect, 2*fabs( MAGMA_Z_IMAG( a )));
+    #endif
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    magma_zscan_matrix checks a matrix that is located on the CPU host,
+    in one pass over its data, for NAN (not-a-number) and INF (infinity)
+    values, and computes its norms and how far it is from Hermitian.
+    This replaces magma_znan_inf followed by separate calls to zlange or
+    zlanhe, which each read all of A again.
+
+    For uplo = MagmaFull, the norms are those of LAPACK zlange for the
+    m-by-n matrix A. If m = n, the symmetry defect is
+        max_{i,j} | a_ij - conj( a_ji ) |,
+    where |z| = max( |real(z)|, |imag(z)| ), so A is Hermitian exactly
+    when the defect is 0. Tiles (I,J) and (J,I) are compared while in
+    cache, so A is still read from memory once.
+
+    For uplo = MagmaLower or MagmaUpper, A is Hermitian and only the given
+    triangle is read; the norms are those of LAPACK zlanhe, and the
+    symmetry defect is max_j | a_jj - conj( a_jj ) | = 2 max_j |imag(a_jj)|.
+
+    Columns are scanned by OpenMP threads, and each column segment by a
+    SIMD loop. The Frobenius norm is a sum of squares without scaling, so if
+    the largest entry is within sqrt(m*n) of overflow, or so small that its
+    square underflows, the norms are computed again by LAPACK.
+
+    Arguments
+    ---------
+    @param[in]
+    uplo    magma_uplo_t
+            Specifies what part of the matrix A to check.
+      -     = MagmaUpper:  Upper triangular part of Hermitian A
+      -     = MagmaLower:  Lower triangular part of Hermitian A
+      -     = MagmaFull:   All of A
+
+    @param[in]
+    m       INTEGER
+            The number of rows of the matrix A. m >= 0.
+
+    @param[in]
+    n       INTEGER
+            The number of columns of the matrix A. n >= 0.
+            If uplo = MagmaUpper or MagmaLower, n = m.
+
+    @param[in]
+    A       COMPLEX_16 array, dimension (lda,n), on the CPU host.
+            The m-by-n matrix to be checked.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A. lda >= m.
+
+    @param[out]
+    cnt_nan INTEGER*
+            If non-NULL, on exit contains the number of NAN values in A.
+
+    @param[out]
+    cnt_inf INTEGER*
+            If non-NULL, on exit contains the number of INF values in A.
+
+    @param[out]
+    norm_max DOUBLE PRECISION*
+            If non-NULL, on exit contains max_{i,j} |a_ij|.
+
+    @param[out]
+    norm_one DOUBLE PRECISION*
+            If non-NULL, on exit contains the one norm of A,
+            the maximum column sum.
+
+    @param[out]
+    norm_inf DOUBLE PRECISION*
+            If non-NULL, on exit contains the infinity norm of A,
+            the maximum row sum.
+
+    @param[out]
+    norm_fro DOUBLE PRECISION*
+            If non-NULL, on exit contains the Frobenius norm of A.
+
+    @param[out]
+    sym_defect DOUBLE PRECISION*
+            If non-NULL, on exit contains the symmetry defect of A, as above.
+            If uplo = MagmaFull and m != n, it is -1.
+            \n
+            If A has NAN values, the norms and the defect are NAN;
+            otherwise, if A has INF values, they are INF.
+
+    @return
+      -     >= 0:  Returns number of NAN + number of INF values.
+      -     <  0:  If it returns -i, the i-th argument had an illegal value,
+                   or another error occured, such as memory allocation failed.
+
+    @ingroup magma_nan_inf
+*******************************************************************************/
+extern "C"
+magma_int_t magma_zscan_matrix(
+    magma_uplo_t uplo, magma_int_t m, magma_int_t n,
+    const magmaDoubleComplex *A, magma_int_t lda,
+    magma_int_t *cnt_nan,
+    magma_int_t *cnt_inf,
+    double *norm_max, double *norm_one, double *norm_inf, double *norm_fro,
+    double *sym_defect )
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double inf = std::numeric_limits<double>::infinity();
+
+    magma_int_t info = 0;
+    if (uplo != MagmaLower && uplo != MagmaUpper && uplo != MagmaFull)
+        info = -1;
+    else if (m < 0)
+        info = -2;
+    else if (n < 0 || (uplo != MagmaFull && n != m))
+        info = -3;
+    else if (lda < max(1, m))
+        info = -5;
+
+    if (info != 0) {
+        magma_xerbla( __func__, -(info) );
+        return info;
+    }
+
+    bool herm   = (uplo != MagmaFull);
+    bool square = (m == n);
+    bool pair   = (! herm && square && sym_defect != NULL);
+
+    double *work = NULL;
+    double r_max = 0, r_one = 0, r_inf = 0, r_fro = 0, r_defect = 0;
+    zscan_stats total = { 0, 0, 0, 0, 0, 0, 0 };
+
+    magma_int_t ntile = magma_ceildiv( n, scan_nb );
+    magma_int_t nthread = max( 1, min( magma_get_parallel_numthreads(), ntile ));
+    magma_int_t lsum = m + n;
+
+    // Quick return
+    if (m == 0 || n == 0) {
+        goto cleanup;
+    }
+
+    // per thread, column sums colsum(0:n-1) and row sums rowsum(0:m-1)
+    if (MAGMA_SUCCESS != magma_dmalloc_cpu( &work, nthread*lsum )) {
+        info = MAGMA_ERR_HOST_ALLOC;
+        goto cleanup;
+    }
+
+    #pragma omp parallel num_threads( nthread )
+    {
+        #ifdef _OPENMP
+        magma_int_t tid = omp_get_thread_num();
+        #else
+        magma_int_t tid = 0;
+        #endif
+        double *colsum = work + tid*lsum;
+        double *rowsum = colsum + n;
+        zscan_stats st = { 0, 0, 0, 0, 0, 0, 0 };
+        for (magma_int_t k = 0; k < lsum; ++k) {
+            colsum[k] = 0;
+        }
+
+        if (pair) {
+            // tiles (I,J) and (J,I) for I <= J, so each tile is read from
+            // memory once; later J have more tiles, hence dynamic
+            #pragma omp for schedule(dynamic)
+            for (magma_int_t jt = 0; jt < ntile; ++jt) {
+                magma_int_t j0 = jt*scan_nb;
+                magma_int_t jb = min( scan_nb, n - j0 );
+                for (magma_int_t i0 = 0; i0 < j0; i0 += scan_nb) {
+                    for (magma_int_t j = j0; j < j0 + jb; ++j) {
+                        zscan_col( scan_nb, A(i0, j), &rowsum[i0], &colsum[j], &st );
+                    }
+                    for (magma_int_t i = i0; i < i0 + scan_nb; ++i) {
+                        zscan_col( jb, A(j0, i), &rowsum[j0], &colsum[i], &st );
+                    }
+                    for (magma_int_t j = j0; j < j0 + jb; ++j) {
+                        zscan_defect( scan_nb, A(i0, j), A(j, i0), lda, &st );
+                    }
+                }
+                // diagonal tile; a_jj - conj(a_jj) = 2i imag(a_jj)
+                for (magma_int_t j = j0; j < j0 + jb; ++j) {
+                    zscan_col( jb, A(j0, j), &rowsum[j0], &colsum[j], &st );
+                }
+                for (magma_int_t j = j0; j < j0 + jb; ++j) {
+                    zscan_defect( j - j0 + 1, A(j0, j), A(j, j0), lda, &st );
+                }
+            }
+        }
+        else if (! herm) {
+            #pragma omp for schedule(static)
+            for (magma_int_t jt = 0; jt < ntile; ++jt) {
+                magma_int_t j0 = jt*scan_nb;
+                magma_int_t jb = min( scan_nb, n - j0 );
+                for (magma_int_t j = j0; j < j0 + jb; ++j) {
+                    zscan_col( m, A(0, j), rowsum, &colsum[j], &st );
+                }
+            }
+        }
+        else {
+            // Hermitian: a_ij adds to column sums j (colsum) and i (rowsum)
+            #pragma omp for schedule(dynamic)
+            for (magma_int_t jt = 0; jt < ntile; ++jt) {
+                magma_int_t j0 = jt*scan_nb;
+                magma_int_t jb = min( scan_nb, n - j0 );
+                for (magma_int_t j = j0; j < j0 + jb; ++j) {
+                    if (uplo == MagmaLower) {
+                        zscan_diag_herm( *A(j, j), &colsum[j], &st );
+                        zscan_col( n-j-1, A(j+1, j), &rowsum[j+1], &colsum[j], &st );
+                    }
+                    else {
+                        zscan_col( j, A(0, j), rowsum, &colsum[j], &st );
+                        zscan_diag_herm( *A(j, j), &colsum[j], &st );
+                    }
+                }
+            }
+        }
+
+        #pragma omp critical (zscan_matrix)
+        {
+            total.nan      += st.nan;
+            total.inf      += st.inf;
+            total.cmax      = max( total.cmax,   st.cmax   );
+            total.amax      = max( total.amax,   st.amax   );
+            total.defect    = max( total.defect, st.defect );
+            total.ssq      += st.ssq;
+            total.ssq_diag += st.ssq_diag;
+        }
+
+        // sum the threads' column and row sums into those of thread 0
+        #pragma omp barrier
+        #pragma omp for schedule(static)
+        for (magma_int_t k = 0; k < lsum; ++k) {
+            for (magma_int_t t = 1; t < nthread; ++t) {
+                work[k] += work[k + t*lsum];
+            }
+        }
+    }
+
+    if (total.nan > 0) {
+        r_max = r_one = r_inf = r_fro = r_defect = nan;
+    }
+    else if (total.inf > 0) {
+        r_max = r_one = r_inf = r_fro = r_defect = inf;
+    }
+    else {
+        r_defect = total.defect;
+
+        double big   = sqrt( lapackf77_dlamch("O") / (4. * m * n) );
+        double small = sqrt( lapackf77_dlamch("S") / lapackf77_dlamch("E") );
+        if (total.cmax > big || (total.cmax > 0 && total.cmax < small)) {
+            // sum of squares may over or underflow; LAPACK scales it
+            if (herm) {
+                const char* uplo_ = lapack_uplo_const( uplo );
+                r_max = lapackf77_zlanhe( "M", uplo_, &n, A, &lda, work );
+                r_one = lapackf77_zlanhe( "1", uplo_, &n, A, &lda, work );
+                r_fro = lapackf77_zlanhe( "F", uplo_, &n, A, &lda, work );
+                r_inf = r_one;
+            }
+            else {
+                r_max = lapackf77_zlange( "M", &m, &n, A, &lda, work );
+                r_one = lapackf77_zlange( "1", &m, &n, A, &lda, work );
+                r_inf = lapackf77_zlange( "I", &m, &n, A, &lda, work );
+                r_fro = lapackf77_zlange( "F", &m, &n, A, &lda, work );
+            }
+        }
+        else {
+            double *colsum = work;
+            double *rowsum = work + n;
+            r_max = total.amax;
+            if (herm) {
+                for (magma_int_t j = 0; j < n; ++j) {
+                    r_one = max( r_one, colsum[j] + rowsum[j] );
+                }
+                r_inf = r_one;
+                r_fro = sqrt( 2*total.ssq + total.ssq_diag );
+            }
+            else {
+                for (magma_int_t j = 0; j < n; ++j) {
+                    r_one = max( r_one, colsum[j] );
+                }
+                for (magma_int_t i = 0; i < m; ++i) {
+                    r_inf = max( r_inf, rowsum[i] );
+                }
+                r_fro = sqrt( total.ssq );
+            }
+        }
+    }
+
+cleanup:
+    magma_free_cpu( work );
+
+    if (info != 0) {
+        return info;
+    }
+    if (! herm && ! square) {
+        r_defect = -1;
+    }
+    if (cnt_nan    != NULL) { *cnt_nan    = total.nan; }
+    if (cnt_inf    != NULL) { *cnt_inf    = total.inf; }
+    if (norm_max   != NULL) { *norm_max   = r_max;     }
+    if (norm_one   != NULL) { *norm_one   = r_one;     }
+    if (norm_inf   != NULL) { *norm_inf   = r_inf;     }
+    if (norm_fro   != NULL) { *norm_fro   = r_fro;     }
+    if (sym_defect != NULL) { *sym_defect = r_defect;  }
+
+    return (total.nan + total.inf);
+}
@@ -51,6 +51,7 @@ int main( int argc, char** argv )
     opts.solver_par.solver     = Magma_CG;
     opts.solver_par.maxiter    = 1000;
     opts.solver_par.rtol       = 1e-4;
+    opts.solver_par.perf.enabled = 0;
     // Initialize the solver.
     magma_dsolverinfo_init( &opts.solver_par, &opts.precond_par, queue );
     // Copy the system to the device (optional, only necessary if using the GPU)
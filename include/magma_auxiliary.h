@@ -313,6 +313,105 @@ void
 magma_queue_wait_event( magma_queue_t queue, magma_event_t event );
 
 
+// =============================================================================
+// out-of-core tiled matrices, stored in a file
+
+magma_int_t
+magma_ooc_create(
+    magma_int_t m, magma_int_t n, magma_int_t nb, size_t elemsize,
+    magma_int_t lookahead, const char* filename,
+    magma_ooc_t* A_ptr );
+
+magma_int_t
+magma_ooc_destroy( magma_ooc_t A );
+
+void
+magma_ooc_getsize(
+    magma_ooc_t A,
+    magma_int_t* m, magma_int_t* n, magma_int_t* nb, size_t* elemsize );
+
+magma_int_t
+magma_ooc_tile_acquire(
+    magma_ooc_t A, magma_int_t i, magma_int_t j, magma_ooc_access_t access,
+    void** T_ptr, magma_int_t* ldt );
+
+void
+magma_ooc_tile_release(
+    magma_ooc_t A, magma_int_t i, magma_int_t j );
+
+void
+magma_ooc_prefetch(
+    magma_int_t m, magma_int_t n,
+    magma_ooc_t A, magma_int_t ia, magma_int_t ja );
+
+magma_int_t
+magma_ooc_setmatrix(
+    magma_int_t m, magma_int_t n,
+    const void* hA_src, magma_int_t lda,
+    magma_ooc_t B,      magma_int_t ib, magma_int_t jb );
+
+magma_int_t
+magma_ooc_getmatrix(
+    magma_int_t m, magma_int_t n,
+    magma_ooc_t A, magma_int_t ia, magma_int_t ja,
+    void* hB_dst,  magma_int_t ldb );
+
+magma_int_t
+magma_ooc_flush( magma_ooc_t A );
+
+void
+magma_ooc_get_stats(
+    magma_ooc_t A,
+    double* bytes_read, double* bytes_written, double* wait_time );
+
+void
+magma_ooc_reset_stats( magma_ooc_t A );
+
+
+// =============================================================================
+// host tiled matrices, in tile (block data) layout
+
+magma_int_t
+magma_tile_create(
+    magma_int_t m, magma_int_t n, magma_int_t nb, size_t elemsize,
+    magma_int_t align, magma_int_t nthreads,
+    magma_tile_t* A_ptr );
+
+magma_int_t
+magma_tile_attach(
+    magma_int_t m, magma_int_t n, magma_int_t nb, size_t elemsize,
+    void* hA, magma_int_t lda, magma_int_t nthreads,
+    magma_tile_t* A_ptr );
+
+magma_int_t
+magma_tile_detach( magma_tile_t A );
+
+void
+magma_tile_destroy( magma_tile_t A );
+
+void
+magma_tile_getsize(
+    magma_tile_t A,
+    magma_int_t* m, magma_int_t* n, magma_int_t* nb, size_t* elemsize );
+
+magma_int_t
+magma_tile_get_nthreads( magma_tile_t A );
+
+void*
+magma_tile_ptr(
+    magma_tile_t A, magma_int_t i, magma_int_t j, magma_int_t* ldt );
+
+magma_int_t
+magma_tile_setmatrix(
+    const void* hA_src, magma_int_t lda,
+    magma_tile_t B );
+
+magma_int_t
+magma_tile_getmatrix(
+    magma_tile_t A,
+    void* hB_dst, magma_int_t ldb );
+
+
 // =============================================================================
 // error handler
 
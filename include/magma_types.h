@@ -507,6 +507,25 @@ typedef enum {
     MagmaHybrid        = 701,
     MagmaNative        = 702
 } magma_mode_t;
+
+typedef enum {
+    MagmaSketchGaussian   = 711,  /* sketch, rangefinder, gesvd_rand, geqp3_rand */
+    MagmaSketchSparseSign = 712
+} magma_sketch_t;
+
+typedef enum {
+    MagmaOOCRead       = 721,  /* ooc_tile_acquire */
+    MagmaOOCWrite      = 722,
+    MagmaOOCReadWrite  = 723
+} magma_ooc_access_t;
+
+// opaque out-of-core (file-backed) tiled matrix structure
+struct magma_ooc;
+typedef struct magma_ooc* magma_ooc_t;
+
+// opaque host tiled matrix structure, in tile (block data) layout
+struct magma_tile;
+typedef struct magma_tile* magma_tile_t;
 // -----------------------------------------------------------------------------
 // sparse
 typedef enum {
@@ -591,7 +610,16 @@ typedef enum {
     Magma_VBJACOBI     = 508,
     Magma_PARDISO      = 509,
     Magma_SYNCFREESOLVE= 510,
-    Magma_ILUT         = 511
+    Magma_ILUT         = 511,
+    Magma_PIPECG       = 512,
+    Magma_PPIPECG      = 513,
+    Magma_SSTEPCG      = 514,
+    Magma_SSTEPGMRES   = 515,
+    Magma_CHEBYSHEV    = 516,
+    Magma_GCRODR       = 517,
+    Magma_DEFCG        = 518,
+    Magma_SCHWARZ      = 519,
+    Magma_BAITERCPU    = 520
 } magma_solver_type;
 
 typedef enum {
@@ -654,6 +682,7 @@ typedef enum {
     Magma_PREC_HST          = 903,
     Magma_PREC_SH           = 904,
     Magma_PREC_SHT          = 905,
+    Magma_PREC_SB           = 906,  // single precision factorization of A rounded to bfloat16
     
     Magma_PREC_XHS_H        = 910,
     Magma_PREC_XHS_HTC      = 911,
@@ -88,6 +88,19 @@ magma_zirange(
     magma_int_t k, magma_int_t *indxq, magma_int_t *iil, magma_int_t *iiu, magma_int_t il, magma_int_t iu);
 #endif  // MAGMA_REAL
 
+// ------------------------------------------------------------ [dz]bd routines
+#ifdef MAGMA_REAL
+// only applicable to real [sd] precisions
+magma_int_t
+magma_dbdsdc(
+    magma_uplo_t uplo, magma_vec_t compq, magma_int_t n,
+    double *d, double *e,
+    double *U,  magma_int_t ldu,
+    double *VT, magma_int_t ldvt,
+    double *work, magma_int_t *iwork,
+    magma_int_t *info);
+#endif  // MAGMA_REAL
+
 // ------------------------------------------------------------ zge routines
 magma_int_t
 magma_zgebrd(
@@ -115,6 +128,20 @@ magma_zgeev(
     #endif
     magma_int_t *info);
 
+magma_int_t
+magma_zhseqr_mt(
+    magma_bool_t wantt, magma_vec_t compz,
+    magma_int_t n, magma_int_t ilo, magma_int_t ihi,
+    magmaDoubleComplex *H, magma_int_t ldh,
+    #ifdef MAGMA_COMPLEX
+    magmaDoubleComplex *w,
+    #else
+    double *wr, double *wi,
+    #endif
+    magmaDoubleComplex *Z, magma_int_t ldz,
+    magma_int_t nthread,
+    magma_int_t *info);
+
 // CUDA MAGMA only
 magma_int_t
 magma_zgeev_m(
@@ -264,6 +291,16 @@ magma_zgeqp3_gpu(
     #endif
     magma_int_t *info);
 
+magma_int_t
+magma_zgeqp3_rand(
+    magma_sketch_t sketch,
+    magma_int_t m, magma_int_t n, magma_int_t k,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magma_int_t *jpvt, magmaDoubleComplex *tau,
+    magma_int_t nb, magma_int_t p,
+    magma_int_t *iseed,
+    magma_int_t *info);
+
 // CUDA MAGMA only
 magma_int_t
 magma_zgeqr2_gpu(
@@ -324,6 +361,15 @@ magma_zgeqrf(
     magmaDoubleComplex *work, magma_int_t lwork,
     magma_int_t *info);
 
+magma_int_t
+magma_zgeqrf_rec_cpu(
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magmaDoubleComplex *tau,
+    magmaDoubleComplex *T, magma_int_t ldt,
+    magma_int_t nthreads,
+    magma_int_t *info);
+
 magma_int_t
 magma_zgeqrf_gpu(
     magma_int_t m, magma_int_t n,
@@ -351,6 +397,16 @@ magma_zgeqrf_ooc(
     magmaDoubleComplex *work, magma_int_t lwork,
     magma_int_t *info);
 
+magma_int_t
+magma_zgeqrf_ooc_cpu(
+    magma_ooc_t A, magmaDoubleComplex *tau, size_t mem_budget,
+    magma_int_t *info );
+
+magma_int_t
+magma_zgeqrf_tile_cpu(
+    magma_tile_t A, magmaDoubleComplex *tau,
+    magma_int_t *info );
+
 magma_int_t
 magma_zgeqrf2_gpu(
     magma_int_t m, magma_int_t n,
@@ -473,6 +529,18 @@ magma_zgesvd(
     #endif
     magma_int_t *info);
 
+magma_int_t
+magma_zgesvd_rand(
+    magma_vec_t jobz, magma_sketch_t sketch,
+    magma_int_t m, magma_int_t n, magma_int_t k, magma_int_t p,
+    magma_int_t niter,
+    const magmaDoubleComplex *A, magma_int_t lda,
+    double *s,
+    magmaDoubleComplex *U, magma_int_t ldu,
+    magmaDoubleComplex *VT, magma_int_t ldvt,
+    magma_int_t *iseed,
+    magma_int_t *info);
+
 // CUDA MAGMA only
 magma_int_t
 magma_zgetf2_gpu(
@@ -520,6 +588,14 @@ magma_zgetrf(
     magma_int_t *ipiv,
     magma_int_t *info);
 
+magma_int_t
+magma_zgetrf_rec_cpu(
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magma_int_t *ipiv,
+    magma_int_t nthreads,
+    magma_int_t *info);
+
 magma_int_t
 magma_zgetrf_gpu(
     magma_int_t m, magma_int_t n,
@@ -584,6 +660,16 @@ magma_zgetrf_nopiv_gpu(
     magmaDoubleComplex_ptr dA, magma_int_t ldda,
     magma_int_t *info);
 
+magma_int_t
+magma_zgetrf_ooc_cpu(
+    magma_ooc_t A, magma_int_t *ipiv, size_t mem_budget,
+    magma_int_t *info );
+
+magma_int_t
+magma_zgetrf_tile_cpu(
+    magma_tile_t A, magma_int_t *ipiv,
+    magma_int_t *info );
+
 magma_int_t
 magma_zgetri_gpu(
     magma_int_t n,
@@ -1058,6 +1144,12 @@ magma_zhetrf_nopiv_cpu(
     magmaDoubleComplex *A, magma_int_t lda,
     magma_int_t *info);
 
+magma_int_t
+magma_zhetrf_nopiv_rec_cpu(
+    magma_uplo_t uplo, magma_int_t n, magma_int_t ib,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magma_int_t *info);
+
 magma_int_t
 magma_zhetrf_nopiv_gpu(
     magma_uplo_t uplo, magma_int_t n,
@@ -1215,6 +1307,10 @@ magma_dlaln2(
     double wr, double wi, double *X, magma_int_t ldx,
     double *scale, double *xnorm,
     magma_int_t *info);
+
+double
+magma_dlarmm(
+    double anorm, double bnorm, double cnorm);
 #endif
 
 // CUDA MAGMA only
@@ -1263,6 +1359,16 @@ magma_zlaqtrsd(
     double *x,       magma_int_t ldx,
     const double *cnorm,
     magma_int_t *info);
+
+magma_int_t
+magma_zlaqtrs3d(
+    magma_trans_t trans, magma_int_t n, magma_int_t nrhs,
+    const double *T, magma_int_t ldt,
+    const double *wr, const double *wi,
+    double *X, magma_int_t ldx,
+    double *scale,
+    magma_int_t nthread,
+    magma_int_t *info);
 #endif
 
 // CUDA MAGMA only
@@ -1273,6 +1379,28 @@ magma_zlarf_gpu(
     magmaDoubleComplex_ptr dC, magma_int_t lddc,
     magma_queue_t queue);
 
+magma_int_t
+magma_zlarfb_cpu(
+    magma_side_t side, magma_trans_t trans,
+    magma_direct_t direct, magma_storev_t storev,
+    magma_int_t m, magma_int_t n, magma_int_t k,
+    const magmaDoubleComplex *V, magma_int_t ldv,
+    const magmaDoubleComplex *T, magma_int_t ldt,
+    magmaDoubleComplex *C, magma_int_t ldc,
+    magmaDoubleComplex *work, magma_int_t lwork,
+    magma_int_t *info);
+
+magma_int_t
+magma_zlarfb_cpu_vbatched(
+    magma_side_t side, magma_trans_t trans,
+    magma_direct_t direct, magma_storev_t storev,
+    const magma_int_t *m, const magma_int_t *n, const magma_int_t *k,
+    const magmaDoubleComplex * const *V_array, const magma_int_t *ldv,
+    const magmaDoubleComplex * const *T_array, const magma_int_t *ldt,
+    magmaDoubleComplex **C_array, const magma_int_t *ldc,
+    magma_int_t batchCount,
+    magma_int_t *info);
+
 // magma_zlarfb_gpu
 // see magmablas_q.h
 
@@ -1287,6 +1415,15 @@ magma_zlarfb2_gpu(
     magmaDoubleComplex_ptr dwork,    magma_int_t ldwork,
     magma_queue_t queue);
 
+magma_int_t
+magma_zlarft_cpu(
+    magma_direct_t direct, magma_storev_t storev,
+    magma_int_t n, magma_int_t k,
+    const magmaDoubleComplex *V, magma_int_t ldv,
+    const magmaDoubleComplex *tau,
+    magmaDoubleComplex *T, magma_int_t ldt,
+    magma_int_t *info);
+
 magma_int_t
 magma_zlatrd(
     magma_uplo_t uplo, magma_int_t n, magma_int_t nb,
@@ -1337,6 +1474,16 @@ magma_zlatrsd(
     magmaDoubleComplex *x,
     double *scale, double *cnorm,
     magma_int_t *info);
+
+magma_int_t
+magma_zlatrs3d(
+    magma_trans_t trans, magma_int_t n, magma_int_t nrhs,
+    const magmaDoubleComplex *T, magma_int_t ldt,
+    const magmaDoubleComplex *lambda,
+    magmaDoubleComplex *X, magma_int_t ldx,
+    double *scale,
+    magma_int_t nthread,
+    magma_int_t *info);
 #endif
 
 magma_int_t
@@ -1386,6 +1533,13 @@ magma_zpotrf(
     magmaDoubleComplex *A, magma_int_t lda,
     magma_int_t *info);
 
+magma_int_t
+magma_zpotrf_rec_cpu(
+    magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magma_int_t nthreads,
+    magma_int_t *info);
+
 magma_int_t
 magma_zpotrf_gpu(
     magma_uplo_t uplo, magma_int_t n,
@@ -1421,6 +1575,16 @@ magma_zpotrf_mgpu_right(
     magmaDoubleComplex_ptr d_lA[], magma_int_t ldda,
     magma_int_t *info);
 
+magma_int_t
+magma_zpotrf_ooc_cpu(
+    magma_uplo_t uplo, magma_ooc_t A, size_t mem_budget,
+    magma_int_t *info );
+
+magma_int_t
+magma_zpotrf_tile_cpu(
+    magma_uplo_t uplo, magma_tile_t A,
+    magma_int_t *info );
+
 // CUDA MAGMA only
 magma_int_t
 magma_zpotrf3_mgpu(
@@ -1452,6 +1616,24 @@ magma_zpotrs_gpu(
     magmaDoubleComplex_ptr dB, magma_int_t lddb,
     magma_int_t *info);
 
+magma_int_t
+magma_zrangefinder(
+    magma_sketch_t sketch,
+    magma_int_t m, magma_int_t n, magma_int_t l, magma_int_t niter,
+    const magmaDoubleComplex *A, magma_int_t lda,
+    magmaDoubleComplex *Q, magma_int_t ldq,
+    magma_int_t *iseed,
+    magma_int_t *info);
+
+magma_int_t
+magma_zsketch(
+    magma_sketch_t sketch, magma_side_t side,
+    magma_int_t m, magma_int_t n, magma_int_t l,
+    const magmaDoubleComplex *A, magma_int_t lda,
+    magmaDoubleComplex *Y, magma_int_t ldy,
+    magma_int_t *iseed,
+    magma_int_t *info);
+
 // ------------------------------------------------------------ zsy routines
 #ifdef MAGMA_COMPLEX
 // CUDA MAGMA only
@@ -1469,6 +1651,12 @@ magma_zsytrf_nopiv_cpu(
     magmaDoubleComplex *A, magma_int_t lda,
     magma_int_t *info);
 
+magma_int_t
+magma_zsytrf_nopiv_rec_cpu(
+    magma_uplo_t uplo, magma_int_t n, magma_int_t ib,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magma_int_t *info);
+
 // CUDA MAGMA only
 magma_int_t
 magma_zsytrf_nopiv_gpu(
@@ -1784,6 +1972,15 @@ magma_znan_inf_gpu(
     magma_int_t *cnt_inf,
     magma_queue_t queue);
 
+magma_int_t
+magma_zscan_matrix(
+    magma_uplo_t uplo, magma_int_t m, magma_int_t n,
+    const magmaDoubleComplex *A, magma_int_t lda,
+    magma_int_t *cnt_nan,
+    magma_int_t *cnt_inf,
+    double *norm_max, double *norm_one, double *norm_inf, double *norm_fro,
+    double *sym_defect);
+
 void magma_zprint(
     magma_int_t m, magma_int_t n,
     const magmaDoubleComplex *A, magma_int_t lda);
@@ -30,6 +30,18 @@ magma_zcgeqrsv_gpu(
     magma_int_t *iter,
     magma_int_t *info);
 
+magma_int_t
+magma_zcgesv_gmres_cpu(
+    magma_trans_t trans, magma_int_t n, magma_int_t nrhs,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magma_int_t *ipiv,
+    const magmaDoubleComplex *B, magma_int_t ldb,
+    magmaDoubleComplex *X, magma_int_t ldx,
+    magma_refinement_t facto_type,
+    magma_refinement_t solver_type,
+    magma_int_t *iter,
+    magma_int_t *info);
+
 magma_int_t
 magma_zcgesv_gpu(
     magma_trans_t trans, magma_int_t n, magma_int_t nrhs,
@@ -55,6 +55,11 @@ extern "C" {
 #define lapackf77_dlaln2   FORTRAN_NAME( dlaln2, DLALN2 )
 #define lapackf77_dlamc3   FORTRAN_NAME( dlamc3, DLAMC3 )
 #define lapackf77_dlamrg   FORTRAN_NAME( dlamrg, DLAMRG )
+#define lapackf77_dlanv2   FORTRAN_NAME( dlanv2, DLANV2 )
+#define lapackf77_dlasd2   FORTRAN_NAME( dlasd2, DLASD2 )
+#define lapackf77_dlasd4   FORTRAN_NAME( dlasd4, DLASD4 )
+#define lapackf77_dlasdq   FORTRAN_NAME( dlasdq, DLASDQ )
+#define lapackf77_dlasdt   FORTRAN_NAME( dlasdt, DLASDT )
 #define lapackf77_dlasrt   FORTRAN_NAME( dlasrt, DLASRT )
 #define lapackf77_dstebz   FORTRAN_NAME( dstebz, DSTEBZ )
 
@@ -112,6 +117,8 @@ extern "C" {
 #define lapackf77_zlantr   FORTRAN_NAME( zlantr, ZLANTR )
 #define lapackf77_dlapy3   FORTRAN_NAME( dlapy3, DLAPY3 )
 #define lapackf77_zlaqp2   FORTRAN_NAME( zlaqp2, ZLAQP2 )
+#define lapackf77_zlaqr1   FORTRAN_NAME( zlaqr1, ZLAQR1 )
+#define lapackf77_zlaqr3   FORTRAN_NAME( zlaqr3, ZLAQR3 )
 #define lapackf77_zlarcm   FORTRAN_NAME( zlarcm, ZLARCM )
 #define lapackf77_zlarf    FORTRAN_NAME( zlarf,  ZLARF  )
 #define lapackf77_zlarfb   FORTRAN_NAME( zlarfb, ZLARFB )
@@ -781,6 +788,37 @@ void   lapackf77_zlaqp2( const magma_int_t *m, const magma_int_t *n, const magma
                          double *vn1, double *vn2,
                          magmaDoubleComplex *work );
 
+void   lapackf77_zlaqr1( const magma_int_t *n,
+                         const magmaDoubleComplex *H, const magma_int_t *ldh,
+                         #ifdef MAGMA_COMPLEX
+                         const magmaDoubleComplex *s1,
+                         const magmaDoubleComplex *s2,
+                         #else
+                         const double *sr1, const double *si1,
+                         const double *sr2, const double *si2,
+                         #endif
+                         magmaDoubleComplex *v );
+
+void   lapackf77_zlaqr3( const magma_int_t *wantt, const magma_int_t *wantz,
+                         const magma_int_t *n,
+                         const magma_int_t *ktop, const magma_int_t *kbot,
+                         const magma_int_t *nw,
+                         magmaDoubleComplex *H, const magma_int_t *ldh,
+                         const magma_int_t *iloz, const magma_int_t *ihiz,
+                         magmaDoubleComplex *Z, const magma_int_t *ldz,
+                         magma_int_t *ns, magma_int_t *nd,
+                         #ifdef MAGMA_COMPLEX
+                         magmaDoubleComplex *sh,
+                         #else
+                         double *sr, double *si,
+                         #endif
+                         magmaDoubleComplex *V, const magma_int_t *ldv,
+                         const magma_int_t *nh,
+                         magmaDoubleComplex *T, const magma_int_t *ldt,
+                         const magma_int_t *nv,
+                         magmaDoubleComplex *WV, const magma_int_t *ldwv,
+                         magmaDoubleComplex *work, const magma_int_t *lwork );
+
 #ifdef MAGMA_COMPLEX
 void   lapackf77_zlarcm( const magma_int_t *m, const magma_int_t *n,
                          const double             *A, const magma_int_t *lda,
@@ -1135,6 +1173,11 @@ void   lapackf77_dlamrg( const magma_int_t *n1, const magma_int_t *n2,
                          const magma_int_t *dtrd1, const magma_int_t *dtrd2,
                          magma_int_t *index );
 
+void   lapackf77_dlanv2( double *a, double *b, double *c, double *d,
+                         double *rt1r, double *rt1i,
+                         double *rt2r, double *rt2i,
+                         double *cs, double *sn );
+
 double lapackf77_dlapy3( const double *x, const double *y, const double *z );
 
 void   lapackf77_dlaed2( magma_int_t *k, const magma_int_t *n, const magma_int_t *n1,
@@ -1155,6 +1198,43 @@ void   lapackf77_dlaed4( const magma_int_t *n, const magma_int_t *i,
                          double *dlam,
                          magma_int_t *info );
 
+void   lapackf77_dlasd2( const magma_int_t *nl, const magma_int_t *nr,
+                         const magma_int_t *sqre, magma_int_t *k,
+                         double *d, double *z,
+                         const double *alpha, const double *beta,
+                         double *U,   const magma_int_t *ldu,
+                         double *VT,  const magma_int_t *ldvt,
+                         double *dsigma,
+                         double *U2,  const magma_int_t *ldu2,
+                         double *VT2, const magma_int_t *ldvt2,
+                         magma_int_t *idxp, magma_int_t *idx,
+                         magma_int_t *idxc, magma_int_t *idxq,
+                         magma_int_t *coltyp,
+                         magma_int_t *info );
+
+void   lapackf77_dlasd4( const magma_int_t *n, const magma_int_t *i,
+                         const double *d,
+                         const double *z,
+                         double *delta,
+                         const double *rho,
+                         double *sigma,
+                         double *work,
+                         magma_int_t *info );
+
+void   lapackf77_dlasdq( const char *uplo, const magma_int_t *sqre,
+                         const magma_int_t *n, const magma_int_t *ncvt,
+                         const magma_int_t *nru, const magma_int_t *ncc,
+                         double *d, double *e,
+                         double *VT, const magma_int_t *ldvt,
+                         double *U,  const magma_int_t *ldu,
+                         double *C,  const magma_int_t *ldc,
+                         double *work,
+                         magma_int_t *info );
+
+void   lapackf77_dlasdt( const magma_int_t *n, magma_int_t *lvl, magma_int_t *nd,
+                         magma_int_t *inode, magma_int_t *ndiml, magma_int_t *ndimr,
+                         const magma_int_t *msub );
+
 void   lapackf77_dlasrt( const char *id, const magma_int_t *n, double *d,
                          magma_int_t *info );
 
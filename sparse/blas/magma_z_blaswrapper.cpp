@@ -81,6 +81,12 @@ magma_z_spmv(
         goto cleanup;
     }
 
+    // matrix-free operator, applied in its own memory location
+    if ( A.storage_type == Magma_SPMVFUNCTION && A.op != NULL ) {
+        CHECK( magma_zmoperator_apply( alpha, A, x, beta, y, queue ));
+        goto cleanup;
+    }
+
     // DEV case
     if ( A.memory_location == Magma_DEV ) {
         if ( A.num_cols == x.num_rows && x.num_cols == 1 ) {
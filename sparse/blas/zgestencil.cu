@@ -0,0 +1,154 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+
+*/
+#include "magmasparse_internal.h"
+
+#define BLOCK_SIZE 256
+
+
+// 7-pt and 27-pt stencil kernel, one thread per grid point
+__global__ void
+zgestencil_kernel(
+    int n,
+    int points,
+    int num_vecs,
+    magmaDoubleComplex alpha,
+    const magmaDoubleComplex * __restrict__ dx,
+    int ldx,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex * dy,
+    int ldy )
+{
+    int nn = n*n*n;
+    int row = blockDim.x * blockIdx.x + threadIdx.x;
+    if( row >= nn ){
+        return;
+    }
+    int ix = row % n;
+    int iy = (row / n) % n;
+    int iz = row / (n*n);
+
+    for( int v=0; v < num_vecs; v++ ){
+        const magmaDoubleComplex *x = dx + v*ldx;
+        magmaDoubleComplex sum;
+        if( points == 7 ){
+            sum = MAGMA_Z_MAKE( 6.0, 0.0 ) * x[ row ];
+            if( ix > 0   ) sum = sum - x[ row-1 ];
+            if( ix < n-1 ) sum = sum - x[ row+1 ];
+            if( iy > 0   ) sum = sum - x[ row-n ];
+            if( iy < n-1 ) sum = sum - x[ row+n ];
+            if( iz > 0   ) sum = sum - x[ row-n*n ];
+            if( iz < n-1 ) sum = sum - x[ row+n*n ];
+        } else {
+            // same couplings as magma_zm_27stencil
+            sum = MAGMA_Z_MAKE( 26.0, 0.0 ) * x[ row ];
+            for( int dz=-1; dz <= 1; dz++ ){
+                for( int dyy=-1; dyy <= 1; dyy++ ){
+                    for( int dxx=-1; dxx <= 1; dxx++ ){
+                        int col = row + dz*n*n + dyy*n + dxx;
+                        if( (dz == 0 && dyy == 0 && dxx == 0) ||
+                            ix+dxx < 0 || ix+dxx >= n ||
+                            col < 0 || col >= nn )
+                            continue;
+                        sum = sum - x[ col ];
+                    }
+                }
+            }
+        }
+        if ( MAGMA_Z_EQUAL( beta, MAGMA_Z_ZERO ) )
+            dy[ row+v*ldy ] = sum * alpha;
+        else
+            dy[ row+v*ldy ] = sum * alpha + beta * dy[ row+v*ldy ];
+    }
+}
+
+
+/**
+    Purpose
+    -------
+
+    This routine applies the 7-pt or 27-pt stencil operator of a 3D FD
+    discretization on an n x n x n grid to num_vecs vectors,
+        Y = alpha * A * X + beta * Y,
+    without assembling A. The 27-pt stencil has the same couplings as
+    magma_zm_27stencil, the 7-pt stencil the same as magma_zm_7stencil.
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                grid points in each dimension; vectors have length n^3
+
+    @param[in]
+    points      magma_int_t
+                7 or 27
+
+    @param[in]
+    num_vecs    magma_int_t
+                number of vectors in X and Y
+
+    @param[in]
+    alpha       magmaDoubleComplex
+                scalar multiplier
+
+    @param[in]
+    dx          magmaDoubleComplex_const_ptr
+                input vectors X
+
+    @param[in]
+    ldx         magma_int_t
+                leading dimension of X, ldx >= n^3
+
+    @param[in]
+    beta        magmaDoubleComplex
+                scalar multiplier; Y is not read when beta = 0
+
+    @param[in,out]
+    dy          magmaDoubleComplex_ptr
+                input/output vectors Y
+
+    @param[in]
+    ldy         magma_int_t
+                leading dimension of Y, ldy >= n^3
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zblas
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zgestencil(
+    magma_int_t n,
+    magma_int_t points,
+    magma_int_t num_vecs,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dx,
+    magma_int_t ldx,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr dy,
+    magma_int_t ldy,
+    magma_queue_t queue )
+{
+    if ( points != 7 && points != 27 ) {
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
+    magma_int_t nn = n*n*n;
+    if ( nn == 0 || num_vecs == 0 ) {
+        return MAGMA_SUCCESS;
+    }
+    dim3 grid( magma_ceildiv( nn, BLOCK_SIZE ) );
+    magma_int_t threads = BLOCK_SIZE;
+    zgestencil_kernel<<< grid, threads, 0, queue->cuda_stream() >>>
+                  ( n, points, num_vecs, alpha, dx, ldx, beta, dy, ldy );
+    return MAGMA_SUCCESS;
+}
@@ -19,7 +19,8 @@
 // These routines merge multiple kernels from zmergebicgstab into one
 // This is the code used for the ASHES2014 paper
 // "Accelerating Krylov Subspace Solvers on Graphics Processing Units".
-// notice that only CSR format is supported so far.
+// notice that only CSR format and matrix-free operators
+// (Magma_SPMVFUNCTION) are supported so far.
 
 
 // accelerated reduction for one vector
@@ -160,6 +161,68 @@ magma_zbicgmerge_spmv1_kernel(
     }
 }
 
+
+// dot product part of magma_zbicgmerge_spmv1_kernel, for operators
+// whose SpMV v = A p was computed separately
+__global__ void
+magma_zbicgmerge_dot1_kernel(  
+    int n,
+    magmaDoubleComplex * r,
+    magmaDoubleComplex * v,
+    magmaDoubleComplex * vtmp)
+{
+    extern __shared__ magmaDoubleComplex temp[]; 
+    int Idx = threadIdx.x;   
+    int i   = blockIdx.x * blockDim.x + Idx;
+
+    temp[ Idx ] = ( i < n ) ? v[ i ] * r[ i ] : MAGMA_Z_MAKE( 0.0, 0.0);
+    __syncthreads();
+    if ( Idx < 128 ){
+        temp[ Idx ] += temp[ Idx + 128 ];
+    }
+    __syncthreads();
+    if ( Idx < 64 ){
+        temp[ Idx ] += temp[ Idx + 64 ];
+    }
+    __syncthreads();
+    #if defined(PRECISION_z) || defined(PRECISION_c)
+        if( Idx < 32 ){
+            temp[ Idx ] += temp[ Idx + 32 ]; __syncthreads();
+            temp[ Idx ] += temp[ Idx + 16 ]; __syncthreads();
+            temp[ Idx ] += temp[ Idx + 8  ]; __syncthreads();
+            temp[ Idx ] += temp[ Idx + 4  ]; __syncthreads();
+            temp[ Idx ] += temp[ Idx + 2  ]; __syncthreads();
+            temp[ Idx ] += temp[ Idx + 1  ]; __syncthreads();
+        }
+    #endif
+    #if defined(PRECISION_d)
+        if( Idx < 32 ){
+            volatile double *temp2 = temp;
+            temp2[ Idx ] += temp2[ Idx + 32 ];
+            temp2[ Idx ] += temp2[ Idx + 16 ];
+            temp2[ Idx ] += temp2[ Idx + 8 ];
+            temp2[ Idx ] += temp2[ Idx + 4 ];
+            temp2[ Idx ] += temp2[ Idx + 2 ];
+            temp2[ Idx ] += temp2[ Idx + 1 ];
+        }
+    #endif
+    #if defined(PRECISION_s)
+        if( Idx < 32 ){
+            volatile float *temp2 = temp;
+            temp2[ Idx ] += temp2[ Idx + 32 ];
+            temp2[ Idx ] += temp2[ Idx + 16 ];
+            temp2[ Idx ] += temp2[ Idx + 8 ];
+            temp2[ Idx ] += temp2[ Idx + 4 ];
+            temp2[ Idx ] += temp2[ Idx + 2 ];
+            temp2[ Idx ] += temp2[ Idx + 1 ];
+        }
+    #endif
+
+    if ( Idx == 0 ){
+            vtmp[ blockIdx.x ] = temp[ 0 ];
+    }
+}
+
 __global__ void
 magma_zbicgstab_alphakernel(  
                     magmaDoubleComplex * skp ){
@@ -176,7 +239,9 @@ magma_zbicgstab_alphakernel(
     -------
 
     Merges the first SpmV using CSR with the dot product 
-    and the computation of alpha
+    and the computation of alpha. For a matrix-free operator
+    (Magma_SPMVFUNCTION) the SpMV goes through its callback and only
+    the dot product is merged.
 
     Arguments
     ---------
@@ -236,11 +301,24 @@ magma_zbicgmerge_spmv1(
     magmaDoubleComplex_ptr aux1 = d1, aux2 = d2;
     int b = 1;        
 
-    if ( A.storage_type == Magma_CSR)
+    if ( A.storage_type == Magma_CSR) {
         magma_zbicgmerge_spmv1_kernel<<< Gs, Bs, Ms, queue->cuda_stream()>>>
                     ( n, A.dval, A.drow, A.dcol, dp, dr, dv, d1 );
-    else
-        printf("error: only CSR format supported.\n");
+    }
+    else if ( A.storage_type == Magma_SPMVFUNCTION && A.op != NULL ) {
+        // matrix-free operator: SpMV through its callback, then the dot product
+        magma_int_t info = A.op->apply( A.op->context, MAGMA_Z_ONE, dp,
+                                        MAGMA_Z_ZERO, dv, queue );
+        if ( info != 0 ) {
+            return info;
+        }
+        magma_zbicgmerge_dot1_kernel<<< Gs, Bs, Ms, queue->cuda_stream()>>>
+                    ( n, dr, dv, d1 );
+    }
+    else {
+        printf("error: only CSR format and operators supported.\n");
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
 
     while( Gs.x > 1 ) {
         Gs_next.x = magma_ceildiv( Gs.x, Bs.x );
@@ -456,6 +534,98 @@ magma_zbicgmerge_spmv2_kernel(
     }
 }
 
+// dot product part of magma_zbicgmerge_spmv2_kernel, for operators
+// whose SpMV t = A s was computed separately
+__global__ void
+magma_zbicgmerge_dot2_kernel(  
+    int n,
+    magmaDoubleComplex * s,
+    magmaDoubleComplex * t,
+    magmaDoubleComplex * vtmp )
+{
+    extern __shared__ magmaDoubleComplex temp[]; 
+    int Idx = threadIdx.x;   
+    int i   = blockIdx.x * blockDim.x + Idx;
+    int j;
+
+    // 2 vectors 
+    if (i<n){
+            magmaDoubleComplex tmp2 = t[i];
+            temp[Idx] = s[i] * tmp2;
+            temp[Idx+blockDim.x] = tmp2 * tmp2;
+    }
+    else {
+        for( j=0; j<2; j++)
+            temp[Idx+j*blockDim.x] = MAGMA_Z_MAKE( 0.0, 0.0);
+    }
+    __syncthreads();
+    if ( Idx < 128 ){
+        for( j=0; j<2; j++){
+            temp[ Idx+j*blockDim.x ] += temp[ Idx+j*blockDim.x + 128 ];
+        }
+    }
+    __syncthreads();
+    if ( Idx < 64 ){
+        for( j=0; j<2; j++){
+            temp[ Idx+j*blockDim.x ] += temp[ Idx+j*blockDim.x + 64 ];
+        }
+    }
+    __syncthreads();
+    #if defined(PRECISION_z) || defined(PRECISION_c)
+        if( Idx < 32 ){
+            for( j=0; j<2; j++)
+                temp[ Idx+j*blockDim.x ] += temp[ Idx+j*blockDim.x + 32 ];
+                __syncthreads();
+            for( j=0; j<2; j++)
+                temp[ Idx+j*blockDim.x ] += temp[ Idx+j*blockDim.x + 16 ];
+                __syncthreads();
+            for( j=0; j<2; j++)
+                temp[ Idx+j*blockDim.x ] += temp[ Idx+j*blockDim.x + 8 ];
+                __syncthreads();
+            for( j=0; j<2; j++)
+                temp[ Idx+j*blockDim.x ] += temp[ Idx+j*blockDim.x + 4 ];
+                __syncthreads();
+            for( j=0; j<2; j++)
+                temp[ Idx+j*blockDim.x ] += temp[ Idx+j*blockDim.x + 2 ];
+                __syncthreads();
+            for( j=0; j<2; j++)
+                temp[ Idx+j*blockDim.x ] += temp[ Idx+j*blockDim.x + 1 ];
+                __syncthreads();
+        }
+    #endif
+    #if defined(PRECISION_d)
+        if( Idx < 32 ){
+            volatile double *temp2 = temp;
+            for( j=0; j<2; j++){
+                temp2[ Idx+j*blockDim.x ] += temp2[ Idx+j*blockDim.x + 32 ];
+                temp2[ Idx+j*blockDim.x ] += temp2[ Idx+j*blockDim.x + 16 ];
+                temp2[ Idx+j*blockDim.x ] += temp2[ Idx+j*blockDim.x + 8 ];
+                temp2[ Idx+j*blockDim.x ] += temp2[ Idx+j*blockDim.x + 4 ];
+                temp2[ Idx+j*blockDim.x ] += temp2[ Idx+j*blockDim.x + 2 ];
+                temp2[ Idx+j*blockDim.x ] += temp2[ Idx+j*blockDim.x + 1 ];
+            }
+        }
+    #endif
+    #if defined(PRECISION_s)
+        if( Idx < 32 ){
+            volatile float *temp2 = temp;
+            for( j=0; j<2; j++){
+                temp2[ Idx+j*blockDim.x ] += temp2[ Idx+j*blockDim.x + 32 ];
+                temp2[ Idx+j*blockDim.x ] += temp2[ Idx+j*blockDim.x + 16 ];
+                temp2[ Idx+j*blockDim.x ] += temp2[ Idx+j*blockDim.x + 8 ];
+                temp2[ Idx+j*blockDim.x ] += temp2[ Idx+j*blockDim.x + 4 ];
+                temp2[ Idx+j*blockDim.x ] += temp2[ Idx+j*blockDim.x + 2 ];
+                temp2[ Idx+j*blockDim.x ] += temp2[ Idx+j*blockDim.x + 1 ];
+            }
+        }
+    #endif
+    if ( Idx == 0 ){
+        for( j=0; j<2; j++){
+            vtmp[ blockIdx.x+j*n ] = temp[ j*blockDim.x ];
+        }
+    }
+}
+
 __global__ void
 magma_zbicgstab_omegakernel(  
                     magmaDoubleComplex * skp ){
@@ -472,7 +642,9 @@ magma_zbicgstab_omegakernel(
     -------
 
     Merges the second SpmV using CSR with the dot product 
-    and the computation of omega
+    and the computation of omega. For a matrix-free operator
+    (Magma_SPMVFUNCTION) the SpMV goes through its callback and only
+    the dot products are merged.
 
     Arguments
     ---------
@@ -526,11 +698,24 @@ magma_zbicgmerge_spmv2(
     int Ms =  2*local_block_size * sizeof( magmaDoubleComplex ); 
     magmaDoubleComplex_ptr aux1 = d1, aux2 = d2;
     int b = 1;        
-    if ( A.storage_type == Magma_CSR)
+    if ( A.storage_type == Magma_CSR) {
         magma_zbicgmerge_spmv2_kernel<<< Gs, Bs, Ms, queue->cuda_stream()>>>
                     ( n, A.dval, A.drow, A.dcol, ds, dt, d1 );
-    else
-        printf("error: only CSR format supported.\n");
+    }
+    else if ( A.storage_type == Magma_SPMVFUNCTION && A.op != NULL ) {
+        // matrix-free operator: SpMV through its callback, then the dot products
+        magma_int_t info = A.op->apply( A.op->context, MAGMA_Z_ONE, ds,
+                                        MAGMA_Z_ZERO, dt, queue );
+        if ( info != 0 ) {
+            return info;
+        }
+        magma_zbicgmerge_dot2_kernel<<< Gs, Bs, Ms, queue->cuda_stream()>>>
+                    ( n, ds, dt, d1 );
+    }
+    else {
+        printf("error: only CSR format and operators supported.\n");
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
 
     while( Gs.x > 1 ) {
         Gs_next.x = magma_ceildiv( Gs.x, Bs.x );
@@ -1078,6 +1078,16 @@ magma_zcgmerge_spmv1(
         magma_zcgmerge_spmvellpackrt_kernel2<<< Gs, Bs, Ms, queue->cuda_stream() >>>
                       ( A.num_rows, dz, dd, d1 );
     }
+    else if ( A.storage_type == Magma_SPMVFUNCTION && A.op != NULL ) {
+        // matrix-free operator: SpMV through its callback, then the dot product
+        magma_int_t info = A.op->apply( A.op->context, MAGMA_Z_ONE, dd,
+                                        MAGMA_Z_ZERO, dz, queue );
+        if ( info != 0 ) {
+            return info;
+        }
+        magma_zcgmerge_spmvellpackrt_kernel2<<< Gs, Bs, Ms, queue->cuda_stream() >>>
+                      ( A.num_rows, dz, dd, d1 );
+    }
     else if ( A.storage_type == Magma_SELLP && A.alignment == 1 ) {
             magma_zcgmerge_spmvell_kernelb1<<< Gs, Bs, Ms, queue->cuda_stream() >>>
             ( A.num_rows, A.blocksize, 
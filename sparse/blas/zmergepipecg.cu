@@ -0,0 +1,334 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+
+*/
+#include "magmasparse_internal.h"
+
+#define BLOCK_SIZE 256
+
+#define PRECISION_z
+
+
+// These routines merge the vector updates and the dot products of the
+// pipelined (P)CG (Ghysels and Vanroose) into one kernel, so that each
+// iteration needs only one global reduction.
+
+/* -------------------------------------------------------------------------- */
+
+// block-wise partial sums of (r,u), (w,u), (r,r) of the updated vectors
+__global__ void
+magma_zpipecg_update_kernel(
+    int n,
+    int update,
+    int prec,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex beta,
+    const magmaDoubleComplex * __restrict__ m,
+    const magmaDoubleComplex * __restrict__ nv,
+    magmaDoubleComplex *z,
+    magmaDoubleComplex *q,
+    magmaDoubleComplex *s,
+    magmaDoubleComplex *p,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *u,
+    magmaDoubleComplex *w,
+    magmaDoubleComplex *vtmp )
+{
+    __shared__ magmaDoubleComplex temp[ 3*BLOCK_SIZE ];
+    int Idx = threadIdx.x;
+    int i   = blockIdx.x * blockDim.x + Idx;
+
+    magmaDoubleComplex ri = MAGMA_Z_ZERO, ui = MAGMA_Z_ZERO, wi = MAGMA_Z_ZERO;
+    if ( i < n ) {
+        ri = r[i];
+        wi = w[i];
+        if ( update ) {
+            magmaDoubleComplex zi, si, pi;
+            zi = nv[i] + beta * z[i];
+            si = wi    + beta * s[i];
+            if ( prec ) {
+                magmaDoubleComplex qi;
+                ui = u[i];
+                qi = m[i] + beta * q[i];
+                pi = ui   + beta * p[i];
+                q[i] = qi;
+                ui = ui - alpha * qi;
+                u[i] = ui;
+            } else {
+                // u = r, q = s, m = w
+                pi = ri + beta * p[i];
+            }
+            x[i] = x[i] + alpha * pi;
+            ri = ri - alpha * si;
+            wi = wi - alpha * zi;
+            z[i] = zi;
+            s[i] = si;
+            p[i] = pi;
+            r[i] = ri;
+            w[i] = wi;
+            if ( ! prec ) {
+                ui = ri;
+            }
+        } else {
+            ui = ( prec ) ? u[i] : ri;
+        }
+    }
+    temp[ Idx ]                = MAGMA_Z_CONJ( ri ) * ui;
+    temp[ Idx +   blockDim.x ] = MAGMA_Z_CONJ( wi ) * ui;
+    temp[ Idx + 2*blockDim.x ] = MAGMA_Z_CONJ( ri ) * ri;
+    __syncthreads();
+
+    for( int stride = blockDim.x/2; stride > 0; stride /= 2 ) {
+        if ( Idx < stride ) {
+            for( int k=0; k < 3; k++ ) {
+                temp[ Idx+k*blockDim.x ] += temp[ Idx+k*blockDim.x+stride ];
+            }
+        }
+        __syncthreads();
+    }
+    if ( Idx == 0 ) {
+        for( int k=0; k < 3; k++ ) {
+            vtmp[ blockIdx.x + k*gridDim.x ] = temp[ k*blockDim.x ];
+        }
+    }
+}
+
+
+// sums the block-wise partial sums, one thread block
+__global__ void
+magma_zpipecg_reduce_kernel(
+    int Gs,
+    const magmaDoubleComplex * __restrict__ vtmp,
+    magmaDoubleComplex *skp )
+{
+    __shared__ magmaDoubleComplex temp[ 3*BLOCK_SIZE ];
+    int Idx = threadIdx.x;
+
+    for( int k=0; k < 3; k++ ) {
+        magmaDoubleComplex sum = MAGMA_Z_ZERO;
+        for( int j = Idx; j < Gs; j += blockDim.x ) {
+            sum += vtmp[ j + k*Gs ];
+        }
+        temp[ Idx + k*blockDim.x ] = sum;
+    }
+    __syncthreads();
+
+    for( int stride = blockDim.x/2; stride > 0; stride /= 2 ) {
+        if ( Idx < stride ) {
+            for( int k=0; k < 3; k++ ) {
+                temp[ Idx+k*blockDim.x ] += temp[ Idx+k*blockDim.x+stride ];
+            }
+        }
+        __syncthreads();
+    }
+    if ( Idx == 0 ) {
+        for( int k=0; k < 3; k++ ) {
+            skp[k] = temp[ k*blockDim.x ];
+        }
+    }
+}
+
+
+/**
+    Purpose
+    -------
+
+    Merges the vector updates of one iteration of the pipelined (P)CG
+    with the dot products needed by the next iteration:
+
+    z = n + beta z
+    q = m + beta q
+    s = w + beta s
+    p = u + beta p
+    x = x + alpha p
+    r = r - alpha s
+    u = u - alpha q
+    w = w - alpha z
+
+    skp = [ (r,u), (w,u), (r,r) ]
+
+    Without preconditioner (prec = 0), u = r, q = s, and m = w; the arrays
+    u, q, and m are not referenced.
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                vector length
+
+    @param[in]
+    prec        magma_int_t
+                0 if the iteration is unpreconditioned
+
+    @param[in]
+    alpha       magmaDoubleComplex
+                scalar
+
+    @param[in]
+    beta        magmaDoubleComplex
+                scalar
+
+    @param[in]
+    m           magmaDoubleComplex_ptr
+                vector M w
+
+    @param[in]
+    nv          magmaDoubleComplex_ptr
+                vector A m
+
+    @param[in,out]
+    z           magmaDoubleComplex_ptr
+                vector
+
+    @param[in,out]
+    q           magmaDoubleComplex_ptr
+                vector
+
+    @param[in,out]
+    s           magmaDoubleComplex_ptr
+                vector
+
+    @param[in,out]
+    p           magmaDoubleComplex_ptr
+                vector
+
+    @param[in,out]
+    x           magmaDoubleComplex_ptr
+                solution approximation
+
+    @param[in,out]
+    r           magmaDoubleComplex_ptr
+                residual
+
+    @param[in,out]
+    u           magmaDoubleComplex_ptr
+                preconditioned residual
+
+    @param[in,out]
+    w           magmaDoubleComplex_ptr
+                vector A u
+
+    @param[in]
+    d1          magmaDoubleComplex_ptr
+                workspace of size 3*ceil(n/256)
+
+    @param[out]
+    skp         magmaDoubleComplex_ptr
+                three dot products, on the device
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgegpuk
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zpipecg_update(
+    magma_int_t n,
+    magma_int_t prec,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr m,
+    magmaDoubleComplex_ptr nv,
+    magmaDoubleComplex_ptr z,
+    magmaDoubleComplex_ptr q,
+    magmaDoubleComplex_ptr s,
+    magmaDoubleComplex_ptr p,
+    magmaDoubleComplex_ptr x,
+    magmaDoubleComplex_ptr r,
+    magmaDoubleComplex_ptr u,
+    magmaDoubleComplex_ptr w,
+    magmaDoubleComplex_ptr d1,
+    magmaDoubleComplex_ptr skp,
+    magma_queue_t queue )
+{
+    dim3 Bs( BLOCK_SIZE );
+    dim3 Gs( magma_ceildiv( n, BLOCK_SIZE ) );
+    magma_zpipecg_update_kernel<<< Gs, Bs, 0, queue->cuda_stream() >>>
+        ( n, 1, prec, alpha, beta, m, nv, z, q, s, p, x, r, u, w, d1 );
+    magma_zpipecg_reduce_kernel<<< 1, Bs, 0, queue->cuda_stream() >>>
+        ( Gs.x, d1, skp );
+
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes the dot products of the pipelined (P)CG without updating
+    any vectors:
+
+    skp = [ (r,u), (w,u), (r,r) ]
+
+    Without preconditioner (prec = 0), u = r and is not referenced.
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                vector length
+
+    @param[in]
+    prec        magma_int_t
+                0 if the iteration is unpreconditioned
+
+    @param[in]
+    r           magmaDoubleComplex_ptr
+                residual
+
+    @param[in]
+    u           magmaDoubleComplex_ptr
+                preconditioned residual
+
+    @param[in]
+    w           magmaDoubleComplex_ptr
+                vector A u
+
+    @param[in]
+    d1          magmaDoubleComplex_ptr
+                workspace of size 3*ceil(n/256)
+
+    @param[out]
+    skp         magmaDoubleComplex_ptr
+                three dot products, on the device
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgegpuk
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zpipecg_dots(
+    magma_int_t n,
+    magma_int_t prec,
+    magmaDoubleComplex_ptr r,
+    magmaDoubleComplex_ptr u,
+    magmaDoubleComplex_ptr w,
+    magmaDoubleComplex_ptr d1,
+    magmaDoubleComplex_ptr skp,
+    magma_queue_t queue )
+{
+    dim3 Bs( BLOCK_SIZE );
+    dim3 Gs( magma_ceildiv( n, BLOCK_SIZE ) );
+    magma_zpipecg_update_kernel<<< Gs, Bs, 0, queue->cuda_stream() >>>
+        ( n, 0, prec, MAGMA_Z_ZERO, MAGMA_Z_ZERO, NULL, NULL, NULL, NULL, NULL,
+          NULL, NULL, r, u, w, d1 );
+    magma_zpipecg_reduce_kernel<<< 1, Bs, 0, queue->cuda_stream() >>>
+        ( Gs.x, d1, skp );
+
+    return MAGMA_SUCCESS;
+}
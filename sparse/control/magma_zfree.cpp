@@ -36,6 +36,20 @@ magma_zmfree(
     magma_z_matrix *A,
     magma_queue_t queue )
 {
+    // matrix-free operator, see magma_zmcreate_operator
+    if ( A->storage_type == Magma_SPMVFUNCTION ) {
+        if ( A->ownership && A->op != NULL ) {
+            if ( A->op->destroy != NULL ) {
+                A->op->destroy( A->op->context );
+            }
+            magma_free_cpu( A->op );
+        }
+        A->op = NULL;
+        A->num_rows = 0;
+        A->num_cols = 0;
+        A->nnz = 0; A->true_nnz = 0;
+        return MAGMA_SUCCESS;
+    }
     if ( A->memory_location == Magma_CPU ) {
         if (A->storage_type == Magma_ELL || A->storage_type == Magma_ELLPACKT) {
             if (A->ownership) {
@@ -474,6 +488,20 @@ magma_zprecondfree(
         magma_free( precond_par->work2.val );
         precond_par->work2.val = NULL;
     }
+    // subdomain factors of the Schwarz preconditioner
+    if ( precond_par->local != NULL ) {
+        magma_zschwarzfree( precond_par, queue );
+    }
+    // matrix-free operators of Magma_FUNCTION preconditioners
+    if ( precond_par->M.storage_type == Magma_SPMVFUNCTION ) {
+        magma_zmfree( &precond_par->M, queue );
+    }
+    if ( precond_par->L.storage_type == Magma_SPMVFUNCTION ) {
+        magma_zmfree( &precond_par->L, queue );
+    }
+    if ( precond_par->U.storage_type == Magma_SPMVFUNCTION ) {
+        magma_zmfree( &precond_par->U, queue );
+    }
     if ( precond_par->M.val != NULL ) {
         if ( precond_par->M.memory_location == Magma_DEV )
             magma_free( precond_par->M.dval );
@@ -346,3 +346,87 @@ cleanup:
     magma_zmfree( &hA, queue );
     return info;
 }
+
+
+
+/**
+    Purpose
+    -------
+
+    Generate a 7-point stencil for a 3D FD discretization.
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                number of grid points in each dimension; A has n^3 rows
+
+    @param[out]
+    A           magma_z_matrix*
+                matrix to generate
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C"
+magma_int_t
+magma_zm_7stencil(
+    magma_int_t n,
+    magma_z_matrix *A,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    
+    magma_int_t k;
+    magma_z_matrix hA={Magma_CSR};
+    
+    // generate matrix of desired structure and size (3d 7-point stencil)
+    magma_int_t nn = n*n*n;
+    magma_int_t offdiags = 3;
+    magma_index_t *diag_offset=NULL;
+    magmaDoubleComplex *diag_vals=NULL;
+    CHECK( magma_zmalloc_cpu( &diag_vals, offdiags+1 ));
+    CHECK( magma_index_malloc_cpu( &diag_offset, offdiags+1 ));
+    
+    diag_offset[0] = 0;
+    diag_offset[1] = 1;
+    diag_offset[2] = n;
+    diag_offset[3] = n*n;
+    
+    diag_vals[0] = MAGMA_Z_MAKE( 6.0, 0.0 );
+    diag_vals[1] = MAGMA_Z_MAKE( -1.0, 0.0 );
+    diag_vals[2] = MAGMA_Z_MAKE( -1.0, 0.0 );
+    diag_vals[3] = MAGMA_Z_MAKE( -1.0, 0.0 );
+    CHECK( magma_zmgenerator( nn, offdiags, diag_offset, diag_vals, &hA, queue ));
+
+    // now set some entries to zero (boundary in x and y; z is bounded by the size)
+    for( magma_index_t row=0; row < nn; row++ ) {
+        magma_int_t ix = row % n;
+        magma_int_t iy = (row / n) % n;
+        for( k=hA.row[row]; k<hA.row[row+1]; k++) {
+            if ( ( hA.col[k] == row-1 && ix == 0   ) ||
+                 ( hA.col[k] == row+1 && ix == n-1 ) ||
+                 ( hA.col[k] == row-n && iy == 0   ) ||
+                 ( hA.col[k] == row+n && iy == n-1 ) )
+                hA.val[k] = MAGMA_Z_MAKE( 0.0, 0.0 );
+        }
+    }
+
+    if (A->ownership) {
+        magma_zmfree( A, queue );
+    }
+    A->ownership = MagmaTrue;
+    CHECK( magma_zmconvert( hA, A, Magma_CSR, Magma_CSR, queue ));
+    magma_zmcsrcompressor( A, queue );
+    A->true_nnz = A->nnz;
+    
+cleanup:
+    magma_free_cpu( diag_vals );
+    magma_free_cpu( diag_offset );
+    magma_zmfree( &hA, queue );
+    return info;
+}
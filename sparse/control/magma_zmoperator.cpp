@@ -0,0 +1,419 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "magmasparse_internal.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+/**
+    Purpose
+    -------
+
+    Creates a matrix-free m x n matrix A from the operator op. The callbacks
+    of op are invoked by magma_z_spmv and the solvers and preconditioners
+    using it, with vectors in the memory location of A. A has storage type
+    Magma_SPMVFUNCTION and keeps a copy of op; magma_zmfree( A ) calls
+    op->destroy( op->context ), if given.
+
+    Only op->apply is required. If op->apply_block is given, it is used for
+    blocks of vectors, otherwise op->apply is called for each vector.
+    Without op->diagonal, preconditioners that need the diagonal of A,
+    e.g., Jacobi, are not supported.
+
+    Arguments
+    ---------
+
+    @param[in]
+    m           magma_int_t
+                number of rows
+
+    @param[in]
+    n           magma_int_t
+                number of columns
+
+    @param[in]
+    location    magma_location_t
+                memory location of the vectors the operator works on
+
+    @param[in]
+    op          const magma_z_operator*
+                operator callbacks and context
+
+    @param[out]
+    A           magma_z_matrix*
+                matrix-free matrix
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmcreate_operator(
+    magma_int_t m,
+    magma_int_t n,
+    magma_location_t location,
+    const magma_z_operator *op,
+    magma_z_matrix *A,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    if ( op == NULL || op->apply == NULL ) {
+        printf("error: operator without apply function.\n");
+        info = MAGMA_ERR_INVALID_PTR;
+        goto cleanup;
+    }
+
+    if ( A->ownership ) {
+        magma_zmfree( A, queue );
+    }
+
+    CHECK( magma_malloc_cpu( (void**) &A->op, sizeof(magma_z_operator) ));
+    *A->op = *op;
+
+    A->storage_type = Magma_SPMVFUNCTION;
+    A->memory_location = location;
+    A->sym = Magma_GENERAL;
+    A->diagorder_type = Magma_VALUE;
+    A->fill_mode = MagmaFull;
+    A->num_rows = m;
+    A->num_cols = n;
+    A->nnz = 0;
+    A->true_nnz = 0;
+    A->ownership = MagmaTrue;
+
+cleanup:
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes y = alpha * A * x + beta * y for a matrix-free matrix A
+    created by magma_zmcreate_operator. x and y are single vectors or
+    column-major blocks of vectors, as for magma_z_spmv.
+
+    Arguments
+    ---------
+
+    @param[in]
+    alpha       magmaDoubleComplex
+                scalar alpha
+
+    @param[in]
+    A           magma_z_matrix
+                matrix-free matrix A
+
+    @param[in]
+    x           magma_z_matrix
+                input vector x
+
+    @param[in]
+    beta        magmaDoubleComplex
+                scalar beta
+
+    @param[out]
+    y           magma_z_matrix
+                output vector y
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zblas
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmoperator_apply(
+    magmaDoubleComplex alpha,
+    magma_z_matrix A,
+    magma_z_matrix x,
+    magmaDoubleComplex beta,
+    magma_z_matrix y,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_z_operator *op = A.op;
+
+    if ( A.storage_type != Magma_SPMVFUNCTION || op == NULL ) {
+        printf("error: matrix is not a matrix-free operator.\n");
+        info = MAGMA_ERR_NOT_SUPPORTED;
+    }
+    else if ( A.num_cols == x.num_rows && x.num_cols == 1 ) {
+        info = op->apply( op->context, alpha, x.dval, beta, y.dval, queue );
+    }
+    else if ( x.major == MagmaRowMajor && x.num_cols > 1 ) {
+        printf("error: format not supported.\n");
+        info = MAGMA_ERR_NOT_SUPPORTED;
+    }
+    else {
+        magma_int_t num_vecs = x.num_rows / A.num_cols * x.num_cols;
+        if ( op->apply_block != NULL ) {
+            info = op->apply_block( op->context, num_vecs,
+                                    alpha, x.dval, A.num_cols,
+                                    beta,  y.dval, A.num_rows, queue );
+        }
+        else {
+            for( magma_int_t j=0; j < num_vecs && info == 0; j++ ) {
+                info = op->apply( op->context, alpha, x.dval + j*A.num_cols,
+                                  beta, y.dval + j*A.num_rows, queue );
+            }
+        }
+    }
+
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Returns the diagonal of a matrix-free matrix A in a vector d,
+    located in the memory of A.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                matrix-free matrix A
+
+    @param[out]
+    d           magma_z_matrix*
+                diagonal of A
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmoperator_diag(
+    magma_z_matrix A,
+    magma_z_matrix *d,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    if ( A.storage_type != Magma_SPMVFUNCTION || A.op == NULL ) {
+        printf("error: matrix is not a matrix-free operator.\n");
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+    if ( A.op->diagonal == NULL ) {
+        printf("error: operator does not provide its diagonal.\n");
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+    CHECK( magma_zvinit( d, A.memory_location, A.num_rows, 1, MAGMA_Z_ZERO, queue ));
+    CHECK( A.op->diagonal( A.op->context, d->dval, queue ));
+
+cleanup:
+    return info;
+}
+
+
+/******************************************************************************/
+// Matrix-free 7-pt and 27-pt stencil, see magma_zm_stencil_operator.
+
+typedef struct {
+    magma_int_t n;
+    magma_int_t points;
+    magma_location_t location;
+} zstencil_context;
+
+
+static magma_int_t
+zstencil_apply_block(
+    void *context, magma_int_t num_vecs,
+    magmaDoubleComplex alpha, magmaDoubleComplex_const_ptr X, magma_int_t ldx,
+    magmaDoubleComplex beta,  magmaDoubleComplex_ptr Y, magma_int_t ldy,
+    magma_queue_t queue )
+{
+    const zstencil_context *ctx = (const zstencil_context*) context;
+    const magma_int_t n = ctx->n;
+    const magma_int_t nn = n*n*n;
+
+    if ( ctx->location == Magma_DEV ) {
+        return magma_zgestencil( n, ctx->points, num_vecs, alpha, X, ldx,
+                                 beta, Y, ldy, queue );
+    }
+
+    const bool beta_zero = MAGMA_Z_EQUAL( beta, MAGMA_Z_ZERO );
+    const magmaDoubleComplex c_diag =
+        MAGMA_Z_MAKE( (ctx->points == 7 ? 6.0 : 26.0), 0.0 );
+
+    #pragma omp parallel for collapse(2) schedule(static)
+    for( magma_int_t v=0; v < num_vecs; v++ ) {
+        for( magma_int_t row=0; row < nn; row++ ) {
+            const magmaDoubleComplex *x = X + v*ldx;
+            magma_int_t ix = row % n;
+            magma_int_t iy = (row / n) % n;
+            magma_int_t iz = row / (n*n);
+            magmaDoubleComplex sum = c_diag * x[ row ];
+            if ( ctx->points == 7 ) {
+                if ( ix > 0   ) sum -= x[ row-1 ];
+                if ( ix < n-1 ) sum -= x[ row+1 ];
+                if ( iy > 0   ) sum -= x[ row-n ];
+                if ( iy < n-1 ) sum -= x[ row+n ];
+                if ( iz > 0   ) sum -= x[ row-n*n ];
+                if ( iz < n-1 ) sum -= x[ row+n*n ];
+            }
+            else {
+                // same couplings as magma_zm_27stencil: the grid rows are
+                // bounded in x, but a row couples to the next one in y
+                for( magma_int_t dz=-1; dz <= 1; dz++ ) {
+                    for( magma_int_t dy=-1; dy <= 1; dy++ ) {
+                        for( magma_int_t dx=-1; dx <= 1; dx++ ) {
+                            magma_int_t col = row + dz*n*n + dy*n + dx;
+                            if ( (dz == 0 && dy == 0 && dx == 0) ||
+                                 ix+dx < 0 || ix+dx >= n ||
+                                 col < 0 || col >= nn )
+                                continue;
+                            sum -= x[ col ];
+                        }
+                    }
+                }
+            }
+            magmaDoubleComplex *y = Y + v*ldy;
+            y[ row ] = (beta_zero ? alpha*sum : alpha*sum + beta*y[ row ]);
+        }
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+static magma_int_t
+zstencil_apply(
+    void *context,
+    magmaDoubleComplex alpha, magmaDoubleComplex_const_ptr x,
+    magmaDoubleComplex beta,  magmaDoubleComplex_ptr y,
+    magma_queue_t queue )
+{
+    const zstencil_context *ctx = (const zstencil_context*) context;
+    magma_int_t nn = ctx->n * ctx->n * ctx->n;
+    return zstencil_apply_block( context, 1, alpha, x, nn, beta, y, nn, queue );
+}
+
+
+static magma_int_t
+zstencil_diagonal(
+    void *context, magmaDoubleComplex_ptr d, magma_queue_t queue )
+{
+    const zstencil_context *ctx = (const zstencil_context*) context;
+    magma_int_t nn = ctx->n * ctx->n * ctx->n;
+    magmaDoubleComplex c_diag =
+        MAGMA_Z_MAKE( (ctx->points == 7 ? 6.0 : 26.0), 0.0 );
+    if ( ctx->location == Magma_DEV ) {
+        magmablas_zlaset( MagmaFull, nn, 1, c_diag, c_diag, d, nn, queue );
+    }
+    else {
+        for( magma_int_t i=0; i < nn; i++ ) {
+            d[ i ] = c_diag;
+        }
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+static void
+zstencil_destroy( void *context )
+{
+    magma_free_cpu( context );
+}
+
+
+/**
+    Purpose
+    -------
+
+    Creates the matrix-free 7-pt or 27-pt stencil operator of a 3D FD
+    discretization on an n x n x n grid. It has the same entries as the
+    matrices of magma_zm_7stencil and magma_zm_27stencil, but does not store
+    them. For a matrix in device memory, the stencil is applied with
+    magma_zgestencil; in CPU memory, with an OpenMP loop.
+
+    This also serves as an example of a user-defined operator,
+    see magma_zmcreate_operator.
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                grid points in each dimension; A has n^3 rows
+
+    @param[in]
+    points      magma_int_t
+                7 or 27
+
+    @param[in]
+    location    magma_location_t
+                Magma_CPU or Magma_DEV
+
+    @param[out]
+    A           magma_z_matrix*
+                matrix-free matrix
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zm_stencil_operator(
+    magma_int_t n,
+    magma_int_t points,
+    magma_location_t location,
+    magma_z_matrix *A,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    zstencil_context *ctx = NULL;
+    magma_z_operator op;
+
+    if ( points != 7 && points != 27 ) {
+        printf("error: only 7-pt and 27-pt stencils are supported.\n");
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    CHECK( magma_malloc_cpu( (void**) &ctx, sizeof(zstencil_context) ));
+    ctx->n = n;
+    ctx->points = points;
+    ctx->location = location;
+
+    op.context     = ctx;
+    op.apply       = zstencil_apply;
+    op.apply_block = zstencil_apply_block;
+    op.diagonal    = zstencil_diagonal;
+    op.destroy     = zstencil_destroy;
+    CHECK( magma_zmcreate_operator( n*n*n, n*n*n, location, &op, A, queue ));
+    A->sym = Magma_SYMMETRIC;
+    A->max_nnz_row = points;
+    ctx = NULL;  // owned by A
+
+cleanup:
+    magma_free_cpu( ctx );
+    return info;
+}
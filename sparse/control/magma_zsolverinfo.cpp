@@ -14,6 +14,36 @@
 #define RTOLERANCE     lapackf77_dlamch( "E" )
 #define ATOLERANCE     lapackf77_dlamch( "E" )
 
+// names of the phases counted in magma_perf_counters
+static const char *magma_perf_phase_names[MAGMA_PERF_NPHASES] = {
+    "spmv", "precond", "dot", "axpy", "ortho", "setup"
+};
+
+
+// prints calls, time, share of runtime and rates of the counted phases
+static void
+magma_perf_print( const magma_perf_counters *perf, real_Double_t runtime )
+{
+    real_Double_t total = 0.0;
+    
+    printf("%%    phase       calls    time (sec)    share    Gflop/s     GB/s\n");
+    for( magma_int_t k=0; k < MAGMA_PERF_NPHASES; k++ ) {
+        if ( perf->calls[k] == 0 ) {
+            continue;
+        }
+        real_Double_t t = perf->time[k];
+        total += t;
+        printf("%%    %-8s %8lld   %11.4f   %5.1f%%   %8.2f %8.2f\n",
+                magma_perf_phase_names[k], (long long) perf->calls[k], t,
+                ( runtime > 0 ? 100.*t/runtime : 0. ),
+                ( t > 0 ? perf->flops[k]/t/1e9 : 0. ),
+                ( t > 0 ? perf->bytes[k]/t/1e9 : 0. ) );
+    }
+    printf("%%    counted  %8s   %11.4f   %5.1f%%\n", "", total,
+            ( runtime > 0 ? 100.*total/runtime : 0. ) );
+}
+
+
 /**
     Purpose
     -------
@@ -241,6 +271,19 @@ magma_zsolverinfo(
             case Magma_ISAI:
                 printf("%%   Preconditioner used: ParILU-SPAI.\n" );
                 break;
+            case Magma_CHEBYSHEV:
+                printf("%%   Preconditioner used: Chebyshev(%lld) on [%.2e, %.2e].\n",
+                        (long long) precond_par->degree,
+                        (double) precond_par->emin, (double) precond_par->emax );
+                break;
+            case Magma_SCHWARZ:
+                printf("%%   Preconditioner used: restricted additive Schwarz, %lld subdomains, overlap %lld.\n",
+                        (long long) precond_par->num_local, (long long) precond_par->overlap );
+                break;
+            case Magma_VBJACOBI:
+                printf("%%   Preconditioner used: variable-block Jacobi, %lld blocks of up to %lld rows.\n",
+                        (long long) precond_par->M.numblocks, (long long) precond_par->M.blocksize );
+                break;
             default:
                 break;
         }
@@ -400,6 +443,10 @@ magma_zsolverinfo(
         case Magma_BAITERO:
             printf("%% Block-asynchronous iteration solver summary:\n");
             break;
+        case Magma_BAITERCPU:
+            printf("%% Block-asynchronous iteration (CPU, version %lld) solver summary:\n",
+                    (long long) solver_par->version );
+            break;
         case Magma_LOBPCG:
             printf("%% LOBPCG iteration solver summary:\n");
             break;
@@ -410,6 +457,27 @@ magma_zsolverinfo(
         case Magma_PARDISO:
             printf("%% PARDISO solver summary:\n");
             break;
+        case Magma_PIPECG:
+            printf("%% pipelined CG solver summary:\n");
+            break;
+        case Magma_PPIPECG:
+            printf("%% pipelined PCG solver summary:\n");
+            break;
+        case Magma_SSTEPCG:
+            printf("%% s-step CG(%lld) solver summary:\n",
+                    (long long) solver_par->sstep );
+            break;
+        case Magma_SSTEPGMRES:
+            printf("%% s-step GMRES(%lld, %lld) solver summary:\n",
+                    (long long) solver_par->sstep, (long long) solver_par->restart );
+            break;
+        case Magma_GCRODR:
+            printf("%% GCRO-DR(%lld) solver summary:\n",
+                    (long long) solver_par->restart );
+            break;
+        case Magma_DEFCG:
+            printf("%% deflated CG solver summary:\n");
+            break;
         default:
             printf("%%   Solver info not supported.\n");
             goto cleanup;
@@ -418,16 +486,146 @@ magma_zsolverinfo(
     printf("%%    preconditioner setup: %.4f sec\n", precond_par->setuptime );
     printf("%%    iterations: %4lld\n", (long long) solver_par->numiter );
     printf("%%    SpMV-count: %4lld\n", (long long) solver_par->spmv_count );
+    if ( solver_par->num_replace > 0 ) {
+        printf("%%    residual replacements: %4lld (largest residual gap %e)\n",
+                (long long) solver_par->num_replace, solver_par->replace_res );
+    }
     printf("%%    exact final residual: %e\n"
            "%%    runtime: %.4f sec\n",
             solver_par->final_res, solver_par->runtime);
     printf("%%    preconditioner runtime: %.4f sec\n", precond_par->runtime );
+    if ( solver_par->perf.enabled ) {
+        magma_zsolverinfo_perf( solver_par, queue );
+    }
+    if ( precond_par->perf.enabled ) {
+        printf("%%    preconditioner counters:\n");
+        magma_perf_print( &precond_par->perf, precond_par->setuptime + precond_par->runtime );
+    }
 cleanup:
     printf("%%=================================================================================%%\n");
     return MAGMA_SUCCESS;
 }
 
 
+/**
+    Purpose
+    -------
+
+    Prints the per-phase performance counters of a previously called solver:
+    number of calls, cumulative time, share of the solver runtime, and the
+    rates derived from the estimated flops and memory traffic. The counters
+    are only filled if solver_par->perf.enabled was set for the solve.
+
+    Arguments
+    ---------
+
+    @param[in]
+    solver_par  magma_z_solver_par*
+                structure containing all solver information
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zsolverinfo_perf(
+    magma_z_solver_par *solver_par,
+    magma_queue_t queue )
+{
+    magma_perf_print( &solver_par->perf, solver_par->runtime );
+    
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Writes the summary of a previously called solver and its per-phase
+    performance counters as a JSON object, e.g. for post-processing of
+    parameter studies. The keys of the phases are spmv, precond, dot, axpy,
+    ortho and setup; each holds calls, time (sec), flops and bytes. The
+    solver counters are written to phases, the preconditioner counters to
+    precond_phases.
+
+    Arguments
+    ---------
+
+    @param[in]
+    solver_par  magma_z_solver_par*
+                structure containing all solver information
+
+    @param[in]
+    precond_par magma_z_preconditioner*
+                structure containing all preconditioner information
+
+    @param[in]
+    filename    const char*
+                output file, the object is appended; NULL writes to stdout
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zsolverinfo_json(
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    const char *filename,
+    magma_queue_t queue )
+{
+    const magma_perf_counters *perf = &solver_par->perf;
+    const magma_perf_counters *pperf = &precond_par->perf;
+    FILE *fp = stdout;
+    
+    if ( filename != NULL ) {
+        fp = fopen( filename, "a" );
+        if ( fp == NULL ) {
+            printf("%% error: cannot open file %s.\n", filename );
+            return MAGMA_ERR_NOT_FOUND;
+        }
+    }
+    
+    fprintf( fp, "{\"solver\": %d, \"precond\": %d, \"iterations\": %lld, "
+                 "\"spmv_count\": %lld,\n",
+             (int) solver_par->solver, (int) precond_par->solver,
+             (long long) solver_par->numiter, (long long) solver_par->spmv_count );
+    fprintf( fp, " \"init_res\": %.6e, \"final_res\": %.6e, \"runtime\": %.6e, "
+                 "\"precond_setup\": %.6e, \"precond_runtime\": %.6e,\n",
+             solver_par->init_res, solver_par->final_res, solver_par->runtime,
+             precond_par->setuptime, precond_par->runtime );
+    fprintf( fp, " \"phases\": {" );
+    for( magma_int_t k=0; k < MAGMA_PERF_NPHASES; k++ ) {
+        fprintf( fp, "%s\n  \"%s\": {\"calls\": %lld, \"time\": %.6e, "
+                     "\"flops\": %.6e, \"bytes\": %.6e}",
+                 ( k == 0 ? "" : "," ), magma_perf_phase_names[k],
+                 (long long) perf->calls[k], perf->time[k],
+                 perf->flops[k], perf->bytes[k] );
+    }
+    fprintf( fp, "},\n \"precond_phases\": {" );
+    for( magma_int_t k=0; k < MAGMA_PERF_NPHASES; k++ ) {
+        fprintf( fp, "%s\n  \"%s\": {\"calls\": %lld, \"time\": %.6e, "
+                     "\"flops\": %.6e, \"bytes\": %.6e}",
+                 ( k == 0 ? "" : "," ), magma_perf_phase_names[k],
+                 (long long) pperf->calls[k], pperf->time[k],
+                 pperf->flops[k], pperf->bytes[k] );
+    }
+    fprintf( fp, "}}\n" );
+    
+    if ( filename != NULL ) {
+        fclose( fp );
+    }
+    return MAGMA_SUCCESS;
+}
+
+
 /**
     Purpose
     -------
@@ -489,6 +687,8 @@ magma_zsolverinfo_free(
     -------
 
     Initializes all solver and preconditioner parameters.
+    solver_par->perf.enabled is kept as set by the caller
+    (magma_zparse_opts defaults it to 0).
 
     Arguments
     ---------
@@ -517,10 +717,14 @@ magma_zsolverinfo_init(
     solver_par->runtime         = 0.;
     solver_par->numiter = 0;
     solver_par->spmv_count = 0;
+    solver_par->num_replace = 0;
+    solver_par->replace_res = 0.;
+    magma_perf_reset( &solver_par->perf );
     precond_par->numiter = 0;
     precond_par->spmv_count = 0;
     precond_par->runtime       = 0.;
     precond_par->setuptime  = 0.;
+    magma_perf_reset( &precond_par->perf );
     solver_par->res_vec = NULL;
     solver_par->timing = NULL;
     solver_par->eigenvectors = NULL;
@@ -532,6 +736,8 @@ magma_zsolverinfo_init(
         solver_par->version = 0;
     if( solver_par->restart == 0 )
         solver_par->restart = 30;
+    if( solver_par->sstep <= 0 )
+        solver_par->sstep = 4;
     if( solver_par->solver == 0 )
         solver_par->solver = Magma_CG;
 
@@ -554,16 +760,19 @@ magma_zsolverinfo_init(
     precond_par->M.col = NULL;
     precond_par->M.row = NULL;
     precond_par->M.blockinfo = NULL;
+    precond_par->M.op = NULL;
 
     precond_par->L.val = NULL;
     precond_par->L.col = NULL;
     precond_par->L.row = NULL;
     precond_par->L.blockinfo = NULL;
+    precond_par->L.op = NULL;
 
     precond_par->U.val = NULL;
     precond_par->U.col = NULL;
     precond_par->U.row = NULL;
     precond_par->U.blockinfo = NULL;
+    precond_par->U.op = NULL;
     
     precond_par->LT.val = NULL;
     precond_par->LT.col = NULL;
@@ -605,6 +814,9 @@ magma_zsolverinfo_init(
     precond_par->L_dgraphindegree_bak = NULL;
     precond_par->U_dgraphindegree_bak = NULL;
 
+    precond_par->num_local = 0;
+    precond_par->local = NULL;
+
 cleanup:
     if( info != 0 ){
         magma_free( solver_par->timing );
@@ -25,14 +25,21 @@ static const char *usage_sparse =
 "Options are:\n"
 " --solver      Possibility to choose a solver:\n"
 "               CG, PCG, BICGSTAB, PBICGSTAB, GMRES, PGMRES, LOBPCG, JACOBI,\n"
-"               BAITER, IDR, PIDR, CGS, PCGS, TFQMR, PTFQMR, QMR, PQMR, BICG,\n"
-"               PBICG, BOMBARDMENT, ITERREF.\n"
+"               BA, BAO, BACPU, IDR, PIDR, CGS, PCGS, TFQMR, PTFQMR, QMR, PQMR, BICG,\n"
+"               PBICG, BOMBARDMENT, ITERREF, PIPECG, SSTEPCG, SSTEPGMRES,\n"
+"               GCRODR, DEFCG.\n"
 " --basic       Use non-optimized version\n"
 " --ev x        For eigensolvers, set number of eigenvalues/eigenvectors to compute.\n"
 " --restart     For GMRES: possibility to choose the restart.\n"
 "               For IDR: Number of distinct subspaces (1,2,4,8).\n"
+" --sstep s     For SSTEPCG, SSTEPGMRES: number of steps s per block.\n"
+" --version x   For SSTEPCG, SSTEPGMRES: Krylov basis: 0 Newton, 1 Chebyshev, 2 monomial.\n"
+"               For BACPU: 0 asynchronous, 1 asynchronous Southwell, 2 synchronous.\n"
+" --recycle k   For GCRODR, DEFCG: dimension of the subspace recycled between solves.\n"
 " --atol x      Set an absolute residual stopping criterion.\n"
 " --verbose x   Possibility to print intermediate residuals every x iteration.\n"
+" --perf k      Per-phase performance counters of the solver (synchronizes the queue):\n"
+"               0 off (default), 1 print breakdown, 2 also print it as JSON.\n"
 " --maxiter x   Set an upper limit for the iteration count.\n"
 " --rtol x      Set a relative residual stopping criterion.\n"
 " --format      Possibility to choose a format for the sparse matrix:\n"
@@ -45,14 +52,18 @@ static const char *usage_sparse =
 " --precond x   Possibility to choose a preconditioner:\n"
 "               CG, BICGSTAB, GMRES, LOBPCG, JACOBI,\n"
 "               BAITER, IDR, CGS, TFQMR, QMR, BICG\n"
-"               BOMBARDMENT, ITERREF, ILU, PARILU, PARILUT, NONE.\n"
+"               BOMBARDMENT, ITERREF, ILU, PARILU, PARILUT, CHEBYSHEV, SCHWARZ, VBJACOBI, NONE.\n"
 "                   --patol atol  Absolute residual stopping criterion for preconditioner.\n"
 "                   --prtol rtol  Relative residual stopping criterion for preconditioner.\n"
 "                   --piters k    Iteration count for iterative preconditioner.\n"
 "                   --plevels k   Number of ILU levels.\n"
 "                   --triolver k  Solver for triangular ILU factors: e.g. CUSOLVE, JACOBI, ISAI.\n"
-"                   --ppattern k  Pattern used for ISAI preconditioner.\n"
+"                   --ppattern k  Pattern used for ISAI preconditioner, largest VBJACOBI block.\n"
 "                   --psweeps x   Number of iterative ParILU sweeps.\n"
+"                   --pdegree k   Polynomial degree of the Chebyshev preconditioner.\n"
+"                   --psubdomains k  Number of Schwarz subdomains (default: one per thread).\n"
+"                   --poverlap k  Overlap of the Schwarz subdomains in matrix graph levels.\n"
+"                   --pbsize k    Schwarz subdomains up to k rows use dense LU, larger ones ILU(plevels).\n"
 " --trisolver   Possibility to choose a triangular solver for ILU preconditioning: \n"
 "               e.g. CUSOLVE, ISPTRSV, JACOBI, VBJACOBI, ISAI.\n"
 " --ppattern k  Possibility to choose a pattern for the trisolver: ISAI(k) or Block Jacobi.\n"
@@ -123,8 +134,17 @@ magma_zparse_opts(
     #endif
     opts->solver_par.maxiter = 1000;
     opts->solver_par.verbose = 0;
+    opts->solver_par.perf.enabled = 0;
     opts->solver_par.version = 0;
     opts->solver_par.restart = 50;
+    opts->recycle.k = 8;
+    opts->recycle.num_vecs = 0;
+    opts->recycle.ld = 0;
+    opts->recycle.capacity = 0;
+    opts->recycle.num_updates = 0;
+    opts->recycle.dU = NULL;
+    opts->recycle.dC = NULL;
+    opts->solver_par.sstep = 4;
     opts->solver_par.num_eigenvalues = 0;
     opts->precond_par.solver = Magma_NONE;
     opts->precond_par.trisolver = Magma_CUSOLVE;
@@ -141,6 +161,11 @@ magma_zparse_opts(
     opts->precond_par.sweeps = 5;
     opts->precond_par.maxiter = 1;
     opts->precond_par.pattern = 1;
+    opts->precond_par.degree = 4;
+    opts->precond_par.subdomains = 0;
+    opts->precond_par.overlap = 1;
+    opts->precond_par.bsize = 0;
+    opts->precond_par.perf.enabled = 0;
     opts->solver_par.solver = Magma_CGMERGE;
     
     printf( usage_sparse_short, argv[0] );
@@ -242,6 +267,9 @@ magma_zparse_opts(
             else if ( strcmp("BAO", argv[i]) == 0 ) {
                 opts->solver_par.solver = Magma_BAITERO;
             }
+            else if ( strcmp("BACPU", argv[i]) == 0 ) {
+                opts->solver_par.solver = Magma_BAITERCPU;
+            }
             else if ( strcmp("IDR", argv[i]) == 0 ) {
                 opts->solver_par.solver = Magma_PIDRMERGE;
             }
@@ -263,11 +291,33 @@ magma_zparse_opts(
             else if ( strcmp("PARDISO", argv[i]) == 0 ) {
                 opts->solver_par.solver = Magma_PARDISO;
             }
+            else if ( strcmp("PIPECG", argv[i]) == 0 ) {
+                opts->solver_par.solver = Magma_PPIPECG;
+            }
+            else if ( strcmp("PPIPECG", argv[i]) == 0 ) {
+                opts->solver_par.solver = Magma_PPIPECG;
+            }
+            else if ( strcmp("SSTEPCG", argv[i]) == 0 ) {
+                opts->solver_par.solver = Magma_SSTEPCG;
+            }
+            else if ( strcmp("SSTEPGMRES", argv[i]) == 0 ) {
+                opts->solver_par.solver = Magma_SSTEPGMRES;
+            }
+            else if ( strcmp("GCRODR", argv[i]) == 0 ) {
+                opts->solver_par.solver = Magma_GCRODR;
+            }
+            else if ( strcmp("DEFCG", argv[i]) == 0 ) {
+                opts->solver_par.solver = Magma_DEFCG;
+            }
             else {
                 printf( "%%error: invalid solver.\n" );
             }
         } else if ( strcmp("--restart", argv[i]) == 0 && i+1 < argc ) {
             opts->solver_par.restart = atoi( argv[++i] );
+        } else if ( strcmp("--sstep", argv[i]) == 0 && i+1 < argc ) {
+            opts->solver_par.sstep = atoi( argv[++i] );
+        } else if ( strcmp("--recycle", argv[i]) == 0 && i+1 < argc ) {
+            opts->recycle.k = atoi( argv[++i] );
         } else if ( strcmp("--precond", argv[i]) == 0 && i+1 < argc ) {
             i++;
             if ( strcmp("CG", argv[i]) == 0 ) {
@@ -351,6 +401,15 @@ magma_zparse_opts(
             else if ( strcmp("ISAI", argv[i]) == 0 ) {
                 opts->precond_par.solver = Magma_ISAI;
             }
+            else if ( strcmp("CHEBYSHEV", argv[i]) == 0 ) {
+                opts->precond_par.solver = Magma_CHEBYSHEV;
+            }
+            else if ( strcmp("SCHWARZ", argv[i]) == 0 ) {
+                opts->precond_par.solver = Magma_SCHWARZ;
+            }
+            else if ( strcmp("VBJACOBI", argv[i]) == 0 ) {
+                opts->precond_par.solver = Magma_VBJACOBI;
+            }
             else if ( strcmp("NONE", argv[i]) == 0 ) {
                 opts->precond_par.solver = Magma_NONE;
             }
@@ -423,12 +482,22 @@ magma_zparse_opts(
             opts->precond_par.sweeps = atoi( argv[++i] );
         } else if ( strcmp("--plevels", argv[i]) == 0 && i+1 < argc ) {
             opts->precond_par.levels = atoi( argv[++i] );
+        } else if ( strcmp("--pdegree", argv[i]) == 0 && i+1 < argc ) {
+            opts->precond_par.degree = atoi( argv[++i] );
+        } else if ( strcmp("--psubdomains", argv[i]) == 0 && i+1 < argc ) {
+            opts->precond_par.subdomains = atoi( argv[++i] );
+        } else if ( strcmp("--poverlap", argv[i]) == 0 && i+1 < argc ) {
+            opts->precond_par.overlap = atoi( argv[++i] );
+        } else if ( strcmp("--pbsize", argv[i]) == 0 && i+1 < argc ) {
+            opts->precond_par.bsize = atoi( argv[++i] );
         } else if ( strcmp("--blocksize", argv[i]) == 0 && i+1 < argc ) {
             opts->blocksize = atoi( argv[++i] );
         } else if ( strcmp("--alignment", argv[i]) == 0 && i+1 < argc ) {
             opts->alignment = atoi( argv[++i] );
         } else if ( strcmp("--verbose", argv[i]) == 0 && i+1 < argc ) {
             opts->solver_par.verbose = atoi( argv[++i] );
+        } else if ( strcmp("--perf", argv[i]) == 0 && i+1 < argc ) {
+            opts->solver_par.perf.enabled = atoi( argv[++i] );
         }  else if ( strcmp("--maxiter", argv[i]) == 0 && i+1 < argc ) {
             opts->solver_par.maxiter = atoi( argv[++i] );
         } else if ( strcmp("--atol", argv[i]) == 0 && i+1 < argc ) {
@@ -494,15 +563,18 @@ magma_zparse_opts(
             case  Magma_PIDR:               opts->solver_par.solver = Magma_IDR; break;          
             case  Magma_PIDRMERGE:          opts->solver_par.solver = Magma_IDRMERGE; break;     
             case  Magma_PGMRES:             opts->solver_par.solver = Magma_GMRES; break;        
+            case  Magma_PPIPECG:            opts->solver_par.solver = Magma_PIPECG; break;
             default:    break;
         }
     }
     
     // ensure to take a symmetric preconditioner for the PCG
-    if ( ( opts->solver_par.solver == Magma_PCG || opts->solver_par.solver == Magma_PCGMERGE )
+    if ( ( opts->solver_par.solver == Magma_PCG || opts->solver_par.solver == Magma_PCGMERGE
+           || opts->solver_par.solver == Magma_PPIPECG || opts->solver_par.solver == Magma_DEFCG )
         && opts->precond_par.solver == Magma_ILU )
             opts->precond_par.solver = Magma_ICC;
-    if ( ( opts->solver_par.solver == Magma_PCG || opts->solver_par.solver == Magma_PCGMERGE )
+    if ( ( opts->solver_par.solver == Magma_PCG || opts->solver_par.solver == Magma_PCGMERGE
+           || opts->solver_par.solver == Magma_PPIPECG || opts->solver_par.solver == Magma_DEFCG )
         && opts->precond_par.solver == Magma_PARILU )
             opts->precond_par.solver = Magma_PARIC;
             
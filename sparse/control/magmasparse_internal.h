@@ -74,6 +74,83 @@ magma_int_t cusparse2magma_error( cusparseStatus_t status );
     } while(0)
 
 
+/**
+    Starts timing a solver phase: synchronizes the queue and returns the
+    wall-clock time if the performance counters are enabled, 0 otherwise.
+    
+    Example:
+    
+        real_Double_t t = magma_perf_tic( &solver_par->perf, queue );
+        CHECK( magma_z_spmv( c_one, A, p, c_zero, q, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, t,
+                        MAGMA_Z_PERF_FLOPS( A.nnz, A.nnz ), spmv_bytes, queue );
+    
+    @see magma_perf_toc
+    @ingroup magmasparse_internal
+    ********************************************************************/
+static inline real_Double_t
+magma_perf_tic( magma_perf_counters *perf, magma_queue_t queue )
+{
+    return ( perf->enabled ? magma_sync_wtime( queue ) : 0.0 );
+}
+
+
+/**
+    Ends timing a solver phase started with magma_perf_tic and adds time,
+    call, and the estimated flops and bytes to the counters of the phase.
+    Does nothing if the performance counters are disabled.
+    
+    @see magma_perf_tic
+    @ingroup magmasparse_internal
+    ********************************************************************/
+static inline void
+magma_perf_toc(
+    magma_perf_counters *perf, magma_perf_phase phase, real_Double_t start,
+    double flops, double bytes, magma_queue_t queue )
+{
+    if ( perf->enabled ) {
+        perf->time[phase]  += magma_sync_wtime( queue ) - start;
+        perf->calls[phase] += 1;
+        perf->flops[phase] += flops;
+        perf->bytes[phase] += bytes;
+    }
+}
+
+
+/**
+    Clears the performance counters, keeping them enabled or disabled.
+    
+    @ingroup magmasparse_internal
+    ********************************************************************/
+static inline void
+magma_perf_reset( magma_perf_counters *perf )
+{
+    for( int k=0; k < MAGMA_PERF_NPHASES; k++ ) {
+        perf->calls[k] = 0;
+        perf->time[k]  = 0.0;
+        perf->flops[k] = 0.0;
+        perf->bytes[k] = 0.0;
+    }
+}
+
+
+/*
+    Flops of fmuls multiplications and fadds additions in each precision,
+    counted as in testing/flops.h (a complex multiplication is 6 real flops,
+    a complex addition 2), and of a 2-norm of n entries. The solvers pass
+    these to magma_perf_toc so that complex runs are not under-reported.
+*/
+#define MAGMA_Z_PERF_FLOPS( fmuls, fadds ) ( 6. * (fmuls) + 2. * (fadds) )
+#define MAGMA_C_PERF_FLOPS( fmuls, fadds ) ( 6. * (fmuls) + 2. * (fadds) )
+#define MAGMA_D_PERF_FLOPS( fmuls, fadds ) (      (fmuls) +      (fadds) )
+#define MAGMA_S_PERF_FLOPS( fmuls, fadds ) (      (fmuls) +      (fadds) )
+
+#define MAGMA_Z_PERF_FLOPS_NRM2( n ) ( 4. * (n) )
+#define MAGMA_C_PERF_FLOPS_NRM2( n ) ( 4. * (n) )
+#define MAGMA_D_PERF_FLOPS_NRM2( n ) ( 2. * (n) )
+#define MAGMA_S_PERF_FLOPS_NRM2( n ) ( 2. * (n) )
+
+
 #ifdef __cplusplus
 } // extern C
 #endif
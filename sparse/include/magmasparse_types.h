@@ -33,6 +33,30 @@ extern "C" {
 
 #define MAGMA_CSR5_OMEGA 32
 
+/*
+    Matrix-free operator, see magma_zmcreate_operator.
+    Vectors are in the memory location of the magma_z_matrix holding the operator.
+*/
+typedef struct magma_z_operator
+{
+    void               *context;                // user data passed to the callbacks
+    // y = alpha*A*x + beta*y
+    magma_int_t (*apply)( void *context,
+                          magmaDoubleComplex alpha, magmaDoubleComplex_const_ptr x,
+                          magmaDoubleComplex beta,  magmaDoubleComplex_ptr y,
+                          magma_queue_t queue );
+    // opt: Y = alpha*A*X + beta*Y for num_vecs column-major vectors
+    magma_int_t (*apply_block)( void *context, magma_int_t num_vecs,
+                          magmaDoubleComplex alpha, magmaDoubleComplex_const_ptr X, magma_int_t ldx,
+                          magmaDoubleComplex beta,  magmaDoubleComplex_ptr Y, magma_int_t ldy,
+                          magma_queue_t queue );
+    // opt: d = diag(A)
+    magma_int_t (*diagonal)( void *context, magmaDoubleComplex_ptr d,
+                          magma_queue_t queue );
+    // opt: releases context when the matrix is freed
+    void        (*destroy)( void *context );
+} magma_z_operator;
+
 typedef struct magma_z_matrix
 {
     magma_storage_t    storage_type;            // matrix format - CSR, ELL, SELL-P, CSR5
@@ -104,8 +128,33 @@ typedef struct magma_z_matrix
     magma_index_t      csr5_tail_tile_start;    // opt: info for CSR5
     magma_order_t      major;                   // opt: row/col major for dense matrices
     magma_int_t        ld;                      // opt: leading dimension for dense
+    magma_z_operator  *op;                     // opt: matrix-free operator for SPMVFUNCTION
 } magma_z_matrix;
 
+/*
+    Matrix-free operator, see magma_cmcreate_operator.
+    Vectors are in the memory location of the magma_c_matrix holding the operator.
+*/
+typedef struct magma_c_operator
+{
+    void               *context;                // user data passed to the callbacks
+    // y = alpha*A*x + beta*y
+    magma_int_t (*apply)( void *context,
+                          magmaFloatComplex alpha, magmaFloatComplex_const_ptr x,
+                          magmaFloatComplex beta,  magmaFloatComplex_ptr y,
+                          magma_queue_t queue );
+    // opt: Y = alpha*A*X + beta*Y for num_vecs column-major vectors
+    magma_int_t (*apply_block)( void *context, magma_int_t num_vecs,
+                          magmaFloatComplex alpha, magmaFloatComplex_const_ptr X, magma_int_t ldx,
+                          magmaFloatComplex beta,  magmaFloatComplex_ptr Y, magma_int_t ldy,
+                          magma_queue_t queue );
+    // opt: d = diag(A)
+    magma_int_t (*diagonal)( void *context, magmaFloatComplex_ptr d,
+                          magma_queue_t queue );
+    // opt: releases context when the matrix is freed
+    void        (*destroy)( void *context );
+} magma_c_operator;
+
 typedef struct magma_c_matrix
 {
     magma_storage_t    storage_type;            // matrix format - CSR, ELL, SELL-P, CSR5
@@ -177,9 +226,34 @@ typedef struct magma_c_matrix
     magma_index_t      csr5_tail_tile_start;    // opt: info for CSR5
     magma_order_t      major;                   // opt: row/col major for dense matrices
     magma_int_t        ld;                      // opt: leading dimension for dense
+    magma_c_operator  *op;                     // opt: matrix-free operator for SPMVFUNCTION
 } magma_c_matrix;
 
 
+/*
+    Matrix-free operator, see magma_dmcreate_operator.
+    Vectors are in the memory location of the magma_d_matrix holding the operator.
+*/
+typedef struct magma_d_operator
+{
+    void               *context;                // user data passed to the callbacks
+    // y = alpha*A*x + beta*y
+    magma_int_t (*apply)( void *context,
+                          double alpha, magmaDouble_const_ptr x,
+                          double beta,  magmaDouble_ptr y,
+                          magma_queue_t queue );
+    // opt: Y = alpha*A*X + beta*Y for num_vecs column-major vectors
+    magma_int_t (*apply_block)( void *context, magma_int_t num_vecs,
+                          double alpha, magmaDouble_const_ptr X, magma_int_t ldx,
+                          double beta,  magmaDouble_ptr Y, magma_int_t ldy,
+                          magma_queue_t queue );
+    // opt: d = diag(A)
+    magma_int_t (*diagonal)( void *context, magmaDouble_ptr d,
+                          magma_queue_t queue );
+    // opt: releases context when the matrix is freed
+    void        (*destroy)( void *context );
+} magma_d_operator;
+
 typedef struct magma_d_matrix
 {
     magma_storage_t    storage_type;            // matrix format - CSR, ELL, SELL-P, CSR5
@@ -251,9 +325,34 @@ typedef struct magma_d_matrix
     magma_index_t      csr5_tail_tile_start;    // opt: info for CSR5
     magma_order_t      major;                   // opt: row/col major for dense matrices
     magma_int_t        ld;                      // opt: leading dimension for dense
+    magma_d_operator  *op;                     // opt: matrix-free operator for SPMVFUNCTION
 } magma_d_matrix;
 
 
+/*
+    Matrix-free operator, see magma_smcreate_operator.
+    Vectors are in the memory location of the magma_s_matrix holding the operator.
+*/
+typedef struct magma_s_operator
+{
+    void               *context;                // user data passed to the callbacks
+    // y = alpha*A*x + beta*y
+    magma_int_t (*apply)( void *context,
+                          float alpha, magmaFloat_const_ptr x,
+                          float beta,  magmaFloat_ptr y,
+                          magma_queue_t queue );
+    // opt: Y = alpha*A*X + beta*Y for num_vecs column-major vectors
+    magma_int_t (*apply_block)( void *context, magma_int_t num_vecs,
+                          float alpha, magmaFloat_const_ptr X, magma_int_t ldx,
+                          float beta,  magmaFloat_ptr Y, magma_int_t ldy,
+                          magma_queue_t queue );
+    // opt: d = diag(A)
+    magma_int_t (*diagonal)( void *context, magmaFloat_ptr d,
+                          magma_queue_t queue );
+    // opt: releases context when the matrix is freed
+    void        (*destroy)( void *context );
+} magma_s_operator;
+
 typedef struct magma_s_matrix
 {
     magma_storage_t    storage_type;            // matrix format - CSR, ELL, SELL-P, CSR5
@@ -325,6 +424,7 @@ typedef struct magma_s_matrix
     magma_index_t      csr5_tail_tile_start;    // opt: info for CSR5
     magma_order_t      major;                   // opt: row/col major for dense matrices
     magma_int_t        ld;                      // opt: leading dimension for dense
+    magma_s_operator  *op;                     // opt: matrix-free operator for SPMVFUNCTION
 } magma_s_matrix;
 
 
@@ -398,6 +498,38 @@ typedef struct magma_s_vector
 
 //*****************     solver parameters     ********************************//
 
+/*
+    Performance counters of the phases of an iterative solver, filled by the
+    solvers if enabled is set and reported by magma_zsolverinfo_perf.
+    Timing a phase synchronizes the queue, so counters are off by default.
+    All Krylov solvers fill the counters; fused kernels are counted in their
+    dominant phase. The multi-queue IDR variants and Bombard time only the
+    SpMV and the preconditioner. Jacobi, BAITER and LOBPCG report only
+    runtime; the Chebyshev preconditioner shows up in the PRECOND phase.
+    The preconditioner keeps its own counters of the setup and of every
+    apply through the wrappers, enabled by magma_z_precondsetup.
+*/
+#define MAGMA_PERF_NPHASES 6
+
+typedef enum {
+    Magma_PERF_SPMV    = 0,                     // sparse matrix-vector products
+    Magma_PERF_PRECOND = 1,                     // preconditioner application
+    Magma_PERF_DOT     = 2,                     // dot products and norms
+    Magma_PERF_AXPY    = 3,                     // vector updates and copies
+    Magma_PERF_ORTHO   = 4,                     // orthogonalization and small dense operations
+    Magma_PERF_SETUP   = 5                      // preconditioner setup
+} magma_perf_phase;
+
+typedef struct magma_perf_counters
+{
+    magma_int_t        enabled;                 // 0 = counters are not updated
+    magma_int_t        calls[MAGMA_PERF_NPHASES];   // number of calls per phase
+    real_Double_t      time[MAGMA_PERF_NPHASES];    // cumulative runtime per phase
+    double             flops[MAGMA_PERF_NPHASES];   // estimated flops per phase
+    double             bytes[MAGMA_PERF_NPHASES];   // estimated memory traffic per phase
+} magma_perf_counters;
+
+
 typedef struct magma_z_solver_par
 {
     magma_solver_type  solver;                  // solver type
@@ -407,11 +539,14 @@ typedef struct magma_z_solver_par
     magma_int_t        maxiter;                 // upper iteration limit
     magma_int_t        restart;                 // for GMRES
     magma_ortho_t      ortho;                   // for GMRES
+    magma_int_t        sstep;                   // for s-step CG/GMRES: basis length s
     magma_int_t        numiter;                 // feedback: number of needed iterations
     magma_int_t        spmv_count;              // feedback: number of needed SpMV - can be different to iteration count
     double             init_res;                // feedback: initial residual
     double             final_res;               // feedback: final residual
     double             iter_res;                // feedback: iteratively computed residual
+    magma_int_t        num_replace;             // feedback: number of residual replacements
+    double             replace_res;             // feedback: largest gap between recursive and true residual
     real_Double_t      runtime;                 // feedback: runtime needed
     real_Double_t      *res_vec;                // feedback: array containing residuals
     real_Double_t      *timing;                 // feedback: detailed timing
@@ -421,6 +556,7 @@ typedef struct magma_z_solver_par
     double             *eigenvalues;            // feedback: array containing eigenvalues
     magmaDoubleComplex_ptr      eigenvectors;   // feedback: array containing eigenvectors on DEV
     magma_int_t        info;                    // feedback: did the solver converge etc.
+    magma_perf_counters perf;                   // feedback: per-phase performance counters
 
     //---------------------------------
     // the input for verbose is:
@@ -446,11 +582,14 @@ typedef struct magma_c_solver_par
     magma_int_t        maxiter;                 // upper iteration limit
     magma_int_t        restart;                 // for GMRES
     magma_ortho_t      ortho;                   // for GMRES
+    magma_int_t        sstep;                   // for s-step CG/GMRES: basis length s
     magma_int_t        numiter;                 // feedback: number of needed iterations
     magma_int_t        spmv_count;              // feedback: number of needed SpMV - can be different to iteration count
     float              init_res;                // feedback: initial residual
     float              final_res;               // feedback: final residual
     float              iter_res;                // feedback: iteratively computed residual
+    magma_int_t        num_replace;             // feedback: number of residual replacements
+    float              replace_res;             // feedback: largest gap between recursive and true residual
     real_Double_t      runtime;                 // feedback: runtime needed
     real_Double_t      *res_vec;                // feedback: array containing residuals
     real_Double_t      *timing;                 // feedback: detailed timing
@@ -460,6 +599,7 @@ typedef struct magma_c_solver_par
     float              *eigenvalues;            // feedback: array containing eigenvalues
     magmaFloatComplex_ptr       eigenvectors;   // feedback: array containing eigenvectors on DEV
     magma_int_t        info;                    // feedback: did the solver converge etc.
+    magma_perf_counters perf;                   // feedback: per-phase performance counters
 
     //---------------------------------
     // the input for verbose is:
@@ -485,11 +625,14 @@ typedef struct magma_d_solver_par
     magma_int_t        maxiter;                 // upper iteration limit
     magma_int_t        restart;                 // for GMRES
     magma_ortho_t      ortho;                   // for GMRES
+    magma_int_t        sstep;                   // for s-step CG/GMRES: basis length s
     magma_int_t        numiter;                 // feedback: number of needed iterations
     magma_int_t        spmv_count;              // feedback: number of needed SpMV - can be different to iteration count
     double             init_res;                // feedback: initial residual
     double             final_res;               // feedback: final residual
     double             iter_res;                // feedback: iteratively computed residual
+    magma_int_t        num_replace;             // feedback: number of residual replacements
+    double             replace_res;             // feedback: largest gap between recursive and true residual
     real_Double_t      runtime;                 // feedback: runtime needed
     real_Double_t      *res_vec;                // feedback: array containing residuals
     real_Double_t      *timing;                 // feedback: detailed timing
@@ -499,6 +642,7 @@ typedef struct magma_d_solver_par
     double             *eigenvalues;            // feedback: array containing eigenvalues
     magmaDouble_ptr             eigenvectors;   // feedback: array containing eigenvectors on DEV
     magma_int_t        info;                    // feedback: did the solver converge etc.
+    magma_perf_counters perf;                   // feedback: per-phase performance counters
 
     //---------------------------------
     // the input for verbose is:
@@ -524,11 +668,14 @@ typedef struct magma_s_solver_par
     magma_int_t        maxiter;                 // upper iteration limit
     magma_int_t        restart;                 // for GMRES
     magma_ortho_t      ortho;                   // for GMRES
+    magma_int_t        sstep;                   // for s-step CG/GMRES: basis length s
     magma_int_t        numiter;                 // feedback: number of needed iterations
     magma_int_t        spmv_count;              // feedback: number of needed SpMV - can be different to iteration count
     float              init_res;                // feedback: initial residual
     float              final_res;               // feedback: final residual
     float              iter_res;                // feedback: iteratively computed residual
+    magma_int_t        num_replace;             // feedback: number of residual replacements
+    float              replace_res;             // feedback: largest gap between recursive and true residual
     real_Double_t      runtime;                 // feedback: runtime needed
     real_Double_t      *res_vec;                // feedback: array containing residuals
     real_Double_t      *timing;                 // feedback: detailed timing
@@ -538,6 +685,7 @@ typedef struct magma_s_solver_par
     float              *eigenvalues;            // feedback: array containing eigenvalues
     magmaFloat_ptr              eigenvectors;   // feedback: array containing eigenvectors on DEV
     magma_int_t        info;                    // feedback: did the solver converge etc.
+    magma_perf_counters perf;                   // feedback: per-phase performance counters
 
     //---------------------------------
     // the input for verbose is:
@@ -572,12 +720,20 @@ typedef struct magma_z_preconditioner
     double                  rtol;    
     magma_int_t             maxiter;
     magma_int_t             restart; 
+    magma_int_t             degree;                  // polynomial preconditioner: degree
+    double                  emin;                    // polynomial preconditioner: spectral interval
+    double                  emax;
+    magma_int_t             subdomains;              // Schwarz: number of subdomains, 0: one per thread
+    magma_int_t             overlap;                 // Schwarz: overlap in levels of the matrix graph
+    magma_int_t             num_local;               // Schwarz: number of subdomains in local
+    magma_z_matrix          *local;                  // Schwarz: factored subdomain matrices on the CPU
     magma_int_t             numiter;
     magma_int_t             spmv_count;  
     double                  init_res;
     double                  final_res;
     real_Double_t      runtime;                 // feedback: preconditioner runtime needed
     real_Double_t      setuptime;               // feedback: preconditioner setup time needed
+    magma_perf_counters perf;                   // feedback: setup and apply counters
     magma_z_matrix   M;
     magma_z_matrix   L;
     magma_z_matrix   LT;
@@ -630,12 +786,20 @@ typedef struct magma_c_preconditioner
     float                   rtol;               
     magma_int_t             maxiter;
     magma_int_t             restart; 
+    magma_int_t             degree;                  // polynomial preconditioner: degree
+    float                   emin;                    // polynomial preconditioner: spectral interval
+    float                   emax;
+    magma_int_t             subdomains;              // Schwarz: number of subdomains, 0: one per thread
+    magma_int_t             overlap;                 // Schwarz: overlap in levels of the matrix graph
+    magma_int_t             num_local;               // Schwarz: number of subdomains in local
+    magma_c_matrix          *local;                  // Schwarz: factored subdomain matrices on the CPU
     magma_int_t             numiter;
     magma_int_t             spmv_count;
     float                   init_res;
     float                   final_res;
     real_Double_t      runtime;                // feedback: preconditioner runtime needed
     real_Double_t      setuptime;           // feedback: preconditioner setup time needed
+    magma_perf_counters perf;               // feedback: setup and apply counters
     magma_c_matrix   M;
     magma_c_matrix   L;
     magma_c_matrix   LT;
@@ -689,12 +853,20 @@ typedef struct magma_d_preconditioner
     double                  rtol; 
     magma_int_t             maxiter;
     magma_int_t             restart; 
+    magma_int_t             degree;                  // polynomial preconditioner: degree
+    double                  emin;                    // polynomial preconditioner: spectral interval
+    double                  emax;
+    magma_int_t             subdomains;              // Schwarz: number of subdomains, 0: one per thread
+    magma_int_t             overlap;                 // Schwarz: overlap in levels of the matrix graph
+    magma_int_t             num_local;               // Schwarz: number of subdomains in local
+    magma_d_matrix          *local;                  // Schwarz: factored subdomain matrices on the CPU
     magma_int_t             numiter;
     magma_int_t             spmv_count;
     double                  init_res;
     double                  final_res;
     real_Double_t      runtime;                // feedback: preconditioner runtime needed
     real_Double_t      setuptime;           // feedback: preconditioner setup time needed
+    magma_perf_counters perf;               // feedback: setup and apply counters
     magma_d_matrix   M;
     magma_d_matrix   L;
     magma_d_matrix   LT;
@@ -748,12 +920,20 @@ typedef struct magma_s_preconditioner
     float                   rtol;    
     magma_int_t             maxiter;
     magma_int_t             restart; 
+    magma_int_t             degree;                  // polynomial preconditioner: degree
+    float                   emin;                    // polynomial preconditioner: spectral interval
+    float                   emax;
+    magma_int_t             subdomains;              // Schwarz: number of subdomains, 0: one per thread
+    magma_int_t             overlap;                 // Schwarz: overlap in levels of the matrix graph
+    magma_int_t             num_local;               // Schwarz: number of subdomains in local
+    magma_s_matrix          *local;                  // Schwarz: factored subdomain matrices on the CPU
     magma_int_t             numiter;
     magma_int_t             spmv_count;
     float                   init_res;
     float                   final_res;
     real_Double_t      runtime;                // feedback: preconditioner runtime needed
     real_Double_t      setuptime;           // feedback: preconditioner setup time needed
+    magma_perf_counters perf;               // feedback: setup and apply counters
     magma_s_matrix   M;
     magma_s_matrix   L;
     magma_s_matrix   LT;
@@ -793,6 +973,57 @@ typedef struct magma_s_preconditioner
 } magma_s_preconditioner;
 
 
+//##############################################################################
+//
+//              recycled Krylov subspace for sequences of linear systems
+//
+//##############################################################################
+
+typedef struct magma_z_recycle
+{
+    magma_int_t             k;                // requested dimension of the recycled subspace
+    magma_int_t             num_vecs;         // current dimension, 0 if empty
+    magma_int_t             ld;               // leading dimension of dU and dC
+    magma_int_t             capacity;         // allocated columns of dU and dC
+    magma_int_t             num_updates;      // feedback: number of subspace updates
+    magmaDoubleComplex_ptr  dU;               // recycled subspace U, ld x k
+    magmaDoubleComplex_ptr  dC;               // C = A U with orthonormal columns, ld x k
+} magma_z_recycle;
+
+typedef struct magma_c_recycle
+{
+    magma_int_t             k;                // requested dimension of the recycled subspace
+    magma_int_t             num_vecs;         // current dimension, 0 if empty
+    magma_int_t             ld;               // leading dimension of dU and dC
+    magma_int_t             capacity;         // allocated columns of dU and dC
+    magma_int_t             num_updates;      // feedback: number of subspace updates
+    magmaFloatComplex_ptr   dU;               // recycled subspace U, ld x k
+    magmaFloatComplex_ptr   dC;               // C = A U with orthonormal columns, ld x k
+} magma_c_recycle;
+
+typedef struct magma_d_recycle
+{
+    magma_int_t             k;                // requested dimension of the recycled subspace
+    magma_int_t             num_vecs;         // current dimension, 0 if empty
+    magma_int_t             ld;               // leading dimension of dU and dC
+    magma_int_t             capacity;         // allocated columns of dU and dC
+    magma_int_t             num_updates;      // feedback: number of subspace updates
+    magmaDouble_ptr         dU;               // recycled subspace U, ld x k
+    magmaDouble_ptr         dC;               // C = A U with orthonormal columns, ld x k
+} magma_d_recycle;
+
+typedef struct magma_s_recycle
+{
+    magma_int_t             k;                // requested dimension of the recycled subspace
+    magma_int_t             num_vecs;         // current dimension, 0 if empty
+    magma_int_t             ld;               // leading dimension of dU and dC
+    magma_int_t             capacity;         // allocated columns of dU and dC
+    magma_int_t             num_updates;      // feedback: number of subspace updates
+    magmaFloat_ptr          dU;               // recycled subspace U, ld x k
+    magmaFloat_ptr          dC;               // C = A U with orthonormal columns, ld x k
+} magma_s_recycle;
+
+
 //##############################################################################
 //
 //              opts for the testers
@@ -805,6 +1036,7 @@ typedef struct magma_zopts
     magma_location_t        compute_location;
     magma_z_solver_par      solver_par;
     magma_z_preconditioner  precond_par;
+    magma_z_recycle         recycle;
     magma_storage_t         input_format;
     magma_trans_t           trans;
     magma_int_t             blocksize;
@@ -821,6 +1053,7 @@ typedef struct magma_copts
     magma_location_t        compute_location;
     magma_c_solver_par      solver_par;
     magma_c_preconditioner  precond_par;
+    magma_c_recycle         recycle;
     magma_storage_t         input_format;
     magma_trans_t           trans;
     magma_int_t             blocksize;
@@ -837,6 +1070,7 @@ typedef struct magma_dopts
     magma_location_t        compute_location;
     magma_d_solver_par      solver_par;
     magma_d_preconditioner  precond_par;
+    magma_d_recycle         recycle;
     magma_storage_t         input_format;
     magma_trans_t           trans;
     magma_int_t             blocksize;
@@ -853,6 +1087,7 @@ typedef struct magma_sopts
     magma_location_t        compute_location;
     magma_s_solver_par      solver_par;
     magma_s_preconditioner  precond_par;
+    magma_s_recycle         recycle;
     magma_storage_t         input_format;
     magma_trans_t           trans;
     magma_int_t             blocksize;
@@ -635,6 +635,35 @@ magma_zm_5stencil(
     magma_z_matrix *A,
     magma_queue_t queue );
 
+magma_int_t
+magma_zm_7stencil(
+    magma_int_t n,
+    magma_z_matrix *A,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zm_stencil_operator(
+    magma_int_t n,
+    magma_int_t points,
+    magma_location_t location,
+    magma_z_matrix *A,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmcreate_operator(
+    magma_int_t m,
+    magma_int_t n,
+    magma_location_t location,
+    const magma_z_operator *op,
+    magma_z_matrix *A,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmoperator_diag(
+    magma_z_matrix A,
+    magma_z_matrix *d,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zsolverinfo(
     magma_z_solver_par *solver_par, 
@@ -647,6 +676,18 @@ magma_zsolverinfo_init(
     magma_z_preconditioner *precond,
     magma_queue_t queue );
 
+magma_int_t
+magma_zsolverinfo_perf(
+    magma_z_solver_par *solver_par,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zsolverinfo_json(
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    const char *filename,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zeigensolverinfo_init(
     magma_z_solver_par *solver_par,
@@ -1564,6 +1605,23 @@ magma_zisai_generator_regs(
     magma_z_matrix *M,
     magma_queue_t queue );
 
+magma_int_t
+magma_zisai_generator_cpu(
+    magma_uplo_t uplotype,
+    magma_trans_t transtype,
+    magma_diag_t diagtype,
+    magma_z_matrix L,
+    magma_z_matrix *M,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmisai_pattern(
+    magma_uplo_t uplotype,
+    magma_int_t power,
+    magma_z_matrix L,
+    magma_z_matrix *S,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zcsr_sort(
     magma_z_matrix *A,
@@ -1762,6 +1820,106 @@ magma_zbpcg(
     magma_z_preconditioner *precond_par,
     magma_queue_t queue );
 
+magma_int_t
+magma_zpipecg(
+    magma_z_matrix A, magma_z_matrix b, 
+    magma_z_matrix *x, magma_z_solver_par *solver_par, 
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zsstep_cg(
+    magma_z_matrix A, magma_z_matrix b, 
+    magma_z_matrix *x, magma_z_solver_par *solver_par, 
+    magma_queue_t queue );
+
+magma_int_t
+magma_zsstep_gmres(
+    magma_z_matrix A, magma_z_matrix b, 
+    magma_z_matrix *x, magma_z_solver_par *solver_par, 
+    magma_queue_t queue );
+
+magma_int_t
+magma_zsstep_basis_param(
+    magma_int_t s,
+    magma_int_t version,
+    magma_int_t ntheta,
+    magmaDoubleComplex *theta,
+    magmaDoubleComplex *a,
+    magmaDoubleComplex *c,
+    magmaDoubleComplex *g,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zsstep_basis(
+    magma_z_matrix A,
+    magma_int_t s,
+    magmaDoubleComplex *a,
+    magmaDoubleComplex *c,
+    magmaDoubleComplex *g,
+    magmaDoubleComplex_ptr dV,
+    magma_int_t lddv,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zsstep_change_of_basis(
+    magma_int_t s,
+    magmaDoubleComplex *a,
+    magmaDoubleComplex *c,
+    magmaDoubleComplex *g,
+    magmaDoubleComplex *B,
+    magma_int_t ldb,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zgcrodr(
+    magma_z_matrix A, magma_z_matrix b, 
+    magma_z_matrix *x, magma_z_recycle *recycle,
+    magma_z_solver_par *solver_par, 
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zdefcg(
+    magma_z_matrix A, magma_z_matrix b, 
+    magma_z_matrix *x, magma_z_recycle *recycle,
+    magma_z_solver_par *solver_par, 
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zrecycle_init(
+    magma_int_t k,
+    magma_z_recycle *recycle,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zrecycle_free(
+    magma_z_recycle *recycle,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zrecycle_orthonormalize(
+    magma_z_recycle *recycle,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zrecycle_store(
+    magma_int_t n,
+    magma_int_t num,
+    magmaDoubleComplex_ptr dU,
+    magma_int_t lddu,
+    magmaDoubleComplex_ptr dC,
+    magma_int_t lddc,
+    magma_z_recycle *recycle,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zrecycle_update(
+    magma_z_matrix A,
+    magma_z_recycle *recycle,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zpbicg(
     magma_z_matrix A, magma_z_matrix b, 
@@ -1876,6 +2034,13 @@ magma_zbaiter_overlap(
     magma_z_preconditioner *precond_par,
     magma_queue_t queue );
 
+magma_int_t
+magma_zbaiter_cpu(
+    magma_z_matrix A, magma_z_matrix b,
+    magma_z_matrix *x, magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zftjacobicontractions(
     magma_z_matrix xkm2,
@@ -2072,6 +2237,79 @@ magma_zapplycustomprecond_r(
     magma_z_preconditioner *precond,
     magma_queue_t queue );
 
+// Chebyshev polynomial preconditioner
+magma_int_t
+magma_zchebyshevsetup(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zapplychebyshev(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zchebyshevsmooth(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+// restricted additive Schwarz preconditioner, CPU subdomain solves
+magma_int_t
+magma_zschwarz_setup(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zapplyschwarz(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zapplyschwarz_trans(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zschwarzfree(
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+// variable-block Jacobi preconditioner, CPU
+magma_int_t
+magma_zvbjacobisetup(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zapplyvbjacobi(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zapplyvbjacobi_trans(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
 
 // CUSPARSE preconditioner
 
@@ -2244,6 +2482,15 @@ magma_z_spmv(
     magma_z_matrix y,
     magma_queue_t queue );
 
+magma_int_t
+magma_zmoperator_apply(
+    magmaDoubleComplex alpha,
+    magma_z_matrix A,
+    magma_z_matrix x,
+    magmaDoubleComplex beta,
+    magma_z_matrix y,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zcustomspmv(
     magma_int_t m,
@@ -2845,6 +3092,37 @@ magma_zidr_smoothing_2(
     magmaDoubleComplex_ptr dxs, 
     magma_queue_t queue );
 
+magma_int_t
+magma_zpipecg_update(
+    magma_int_t n,
+    magma_int_t prec,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr m,
+    magmaDoubleComplex_ptr nv,
+    magmaDoubleComplex_ptr z,
+    magmaDoubleComplex_ptr q,
+    magmaDoubleComplex_ptr s,
+    magmaDoubleComplex_ptr p,
+    magmaDoubleComplex_ptr x,
+    magmaDoubleComplex_ptr r,
+    magmaDoubleComplex_ptr u,
+    magmaDoubleComplex_ptr w,
+    magmaDoubleComplex_ptr d1,
+    magmaDoubleComplex_ptr skp,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zpipecg_dots(
+    magma_int_t n,
+    magma_int_t prec,
+    magmaDoubleComplex_ptr r,
+    magmaDoubleComplex_ptr u,
+    magmaDoubleComplex_ptr w,
+    magmaDoubleComplex_ptr d1,
+    magmaDoubleComplex_ptr skp,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zcgs_1(  
     magma_int_t num_rows, 
@@ -3363,6 +3641,19 @@ magma_zge3pt(
     magmaDoubleComplex_ptr dy,
     magma_queue_t queue );
 
+magma_int_t
+magma_zgestencil(
+    magma_int_t n,
+    magma_int_t points,
+    magma_int_t num_vecs,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dx,
+    magma_int_t ldx,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr dy,
+    magma_int_t ldy,
+    magma_queue_t queue );
+
 //#############  Big data analytics
 magma_int_t
 magma_zjaccard_weights(
@@ -1,41 +1,36 @@
-import ctypes
-from magma_interface import *
-from datetime import datetime
-
-#libmagma = ctypes.CDLL('/home/hanzt/magma_dev/magma/trunk/lib/libmagma.so')
-#libmagma_sparse = ctypes.CDLL('/home/hanzt/magma_dev/magma/trunk/lib/libmagma_sparse.so')
-
-
-A = MATRIX()
-B = MATRIX()
-x = VECTOR()
-b = VECTOR()
-
-matrix_read( ctypes.byref(A), "../testing/test_matrices/Trefethen_20.mtx" )
-matrix_transfer( A, ctypes.byref(B), CPU, DEV )
+"""
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
 
+    Solves a system with a matrix from the test collection with CG through
+    the NumPy/SciPy interface.
 
-vector_init( ctypes.byref(b), DEV, A.num_rows, c_double(5.0) )
-vector_init( ctypes.byref(x), DEV, A.num_rows, c_double(1.0) )
-vector_visualize( x, 0, 5 )
+    usage: MAGMA_LIBDIR=../../lib python3 cg_example.py [matrix.mtx]
+"""
 
-solver_par = solver_parameter()
-solver_par.maxiter=10000
-solver_par.epsilon=0.0000001
-
-#mv( c_double(1.0), B, b, c_double(0.0), x )
-
-startTime = datetime.now()
-
-cg( B, b, ctypes.byref(x), ctypes.byref(solver_par) )
+import sys
+from datetime import datetime
 
-endTime = datetime.now()
+import numpy
+import scipy.io
 
-vector_visualize( x, 0, 5 )
+import magma_interface as magma
 
+name = sys.argv[1] if len( sys.argv ) > 1 else '../testing/test_matrices/Trefethen_20.mtx'
+A = scipy.io.mmread( name ).tocsr()
+b = 5.0 * numpy.ones( A.shape[0] )
 
-print "iterations: %d" %solver_par.numiter
-print (endTime-startTime)
+magma.init()
+with magma.Solver( A, '--solver CG --maxiter 10000 --rtol 1e-7' ) as solver:
+    startTime = datetime.now()
+    x = solver.solve( b, x0=numpy.ones( A.shape[0] ) )
+    endTime = datetime.now()
 
-matrix_free(ctypes.byref(A))
-matrix_free(ctypes.byref(B))
+    print( x[:5] )
+    print( "iterations: %d" % solver.numiter )
+    print( "residual:   %e" % ( numpy.linalg.norm( A @ x - b ) / numpy.linalg.norm( b ) ) )
+    print( endTime - startTime )
+magma.finalize()
@@ -1,94 +1,559 @@
+"""
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+    NumPy/SciPy interface to MAGMA-sparse.
+
+    SciPy CSR/CSC matrices and NumPy vectors are wrapped as magma_?_matrix
+    structures without copying (ownership = MagmaFalse); the arrays stay owned
+    by Python and are referenced by the wrapper objects as long as MAGMA may
+    use them. Copies are only made if the index arrays are not int32 or the
+    values are not in one of the four MAGMA precisions.
+
+    The bindings use ctypes. Calls into foreign libraries through ctypes.CDLL
+    release the GIL, so other Python threads keep running during a solve.
+
+    The structures below mirror sparse/include/magmasparse_types.h for a
+    build without HAVE_PASTIX. Set MAGMA_ILP64=1 in the environment for a
+    library built with 64-bit magma_int_t. test_magma_interface.py checks the
+    member lists against the header.
+
+    Example:
+
+        import scipy.sparse, numpy
+        import magma_interface as magma
+
+        magma.init()
+        A = scipy.sparse.random( 1000, 1000, 0.01, format='csr' ) \
+            + 10*scipy.sparse.identity( 1000, format='csr' )
+        b = numpy.ones( 1000 )
+        with magma.Solver( A, "--solver PBICGSTAB --precond ILU" ) as s:
+            x = s.solve( b )
+            print( s.numiter, s.final_res, s.runtime )
+        magma.finalize()
+"""
+
 import ctypes
-from ctypes import *
-
-#libmagma = ctypes.CDLL('/home/hanzt/magma_dev/magma/trunk/lib/libmagma.so')
-#libmagma_sparse = ctypes.CDLL('/home/hanzt/magma_dev/magma/trunk/lib/libmagma_sparse.so')
-
-class MATRIX(Structure):
-    _fields_ = [("storage_type", c_int),
-                ("memory_location", c_int),
-                ("num_rows", c_int),
-                ("num_cols", c_int),
-                ("nnz", c_int),
-                ("max_nnz_row", c_int),
-                ("diameter", c_int),
-                ("val", POINTER(c_double)),
-                ("row", POINTER(c_int)),
-                ("col", POINTER(c_int)),
-                ("blockinfo", POINTER(c_int)),
-                ("blocksize", c_int),
-                ("numblocks", c_int)]
-
-class VECTOR(Structure):
-    _fields_ = [("memory_location", c_int),
-                ("num_rows", c_int),
-                ("nnz", c_int),
-                ("val", POINTER(c_double))]
-
-class solver_parameter(Structure):
-    _fields_ = [("epsilon", c_double),
-                ("maxiter", c_int),
-                ("restart", c_int),
-                ("numiter", c_int),
-                ("residual",c_double)]
-
-class precond_parameter(Structure):
-    _fields_ = [("precond_type", c_double),
-                ("precision", c_int),
-                ("epsilon", c_double),
-                ("maxiter", c_int),
-                ("restart", c_int),
-                ("numiter", c_int),
-                ("residual",c_double)]
-
-
-# matrix functions
-matrix_read=libmagma_sparse.magma_d_csr_mtx
-matrix_visualize=libmagma_sparse.magma_d_mvisu
-matrix_write=libmagma_sparse.write_d_csrtomtx
-matrix_transpose=libmagma_sparse.magma_d_mtranspose
-matrix_transfer=libmagma_sparse.magma_d_mtransfer
-matrix_convert=libmagma_sparse.magma_d_mconvert
-matrix_free=libmagma_sparse.magma_d_mfree
-
-
-# vector functions
-vector_init=libmagma_sparse.magma_d_vinit
-vector_read=libmagma_sparse.magma_d_vread
-vector_visualize=libmagma_sparse.magma_d_vvisu
-vector_transfer=libmagma_sparse.magma_d_vtransfer
-vector_free=libmagma_sparse.magma_d_vfree
-
-#iterative linear solvers
-cg=libmagma_sparse.magma_dcg
-gmres=libmagma_sparse.magma_dgmres
-bicgstab=libmagma_sparse.magma_dbicgstab
-pcg=libmagma_sparse.magma_dpcg
-pgmres=libmagma_sparse.magma_dpcg
-dpbicgstab=libmagma_sparse.magma_dpcg
-jacobi=libmagma_sparse.magma_djacobi
-ir=libmagma_sparse.magma_dir
-mv=libmagma_sparse.magma_d_spmv
-
-CSR           = 411
-ELLPACK       = 412
-ELLPACKT      = 413
-DENSE         = 414  
-BCSR          = 415
-CSC           = 416
-HYB           = 417
-COO           = 418
-
-CPU           = 421
-DEV           = 422
-
-CG            = 431
-GMRES         = 432
-BICGSTAB      = 433
-JACOBI        = 434
-GS            = 435
-
-DCOMPLEX      = 451
-FCOMPLEX      = 452
-DOUBLE        = 453
-FLOAT         = 454
+import ctypes.util
+import os
+import shlex
+
+import numpy
+
+try:
+    import scipy.sparse
+except ImportError:
+    scipy = None
+
+
+# ------------------------------------------------------------------------------
+# constants from include/magma_types.h
+
+MagmaFalse    = 0
+MagmaTrue     = 1
+MagmaColMajor = 102
+MagmaNoTrans  = 111
+
+Magma_CSR     = 611
+Magma_DENSE   = 614
+Magma_CSC     = 616
+
+Magma_CPU     = 571
+Magma_DEV     = 572
+
+magma_int_t   = ctypes.c_longlong if os.environ.get( 'MAGMA_ILP64', '0' ) != '0' else ctypes.c_int
+magma_index_t = ctypes.c_int
+magma_enum_t  = ctypes.c_int
+magma_ptr_t   = ctypes.c_void_p
+
+MAGMA_PERF_NPHASES = 6
+MAGMA_PERF_PHASES  = ( 'spmv', 'precond', 'dot', 'axpy', 'ortho', 'setup' )
+
+# precision prefix, NumPy type, and real type of the residuals for each precision
+PRECISIONS = {
+    's': ( numpy.float32,    ctypes.c_float  ),
+    'd': ( numpy.float64,    ctypes.c_double ),
+    'c': ( numpy.complex64,  ctypes.c_float  ),
+    'z': ( numpy.complex128, ctypes.c_double ),
+}
+
+
+def precision_of( dtype ):
+    """Returns the MAGMA precision prefix for a NumPy dtype, or None."""
+    for p, (t, real) in PRECISIONS.items():
+        if numpy.dtype( dtype ) == numpy.dtype( t ):
+            return p
+    return None
+
+
+# ------------------------------------------------------------------------------
+# structures, see sparse/include/magmasparse_types.h
+
+class magma_perf_counters( ctypes.Structure ):
+    _fields_ = [
+        ( 'enabled',            magma_int_t ),
+        ( 'calls',              magma_int_t * MAGMA_PERF_NPHASES ),
+        ( 'time',               ctypes.c_double * MAGMA_PERF_NPHASES ),
+        ( 'flops',              ctypes.c_double * MAGMA_PERF_NPHASES ),
+        ( 'bytes',              ctypes.c_double * MAGMA_PERF_NPHASES ),
+    ]
+
+
+class magma_matrix( ctypes.Structure ):
+    """magma_?_matrix; the layout is the same for all precisions."""
+    _fields_ = [
+        ( 'storage_type',               magma_enum_t ),
+        ( 'memory_location',            magma_enum_t ),
+        ( 'sym',                        magma_enum_t ),
+        ( 'diagorder_type',             magma_enum_t ),
+        ( 'fill_mode',                  magma_enum_t ),
+        ( 'num_rows',                   magma_int_t ),
+        ( 'num_cols',                   magma_int_t ),
+        ( 'nnz',                        magma_int_t ),
+        ( 'max_nnz_row',                magma_int_t ),
+        ( 'diameter',                   magma_int_t ),
+        ( 'true_nnz',                   magma_int_t ),
+        ( 'ownership',                  magma_enum_t ),
+        ( 'val',                        magma_ptr_t ),   # union with dval
+        ( 'diag',                       magma_ptr_t ),
+        ( 'row',                        magma_ptr_t ),
+        ( 'rowidx',                     magma_ptr_t ),
+        ( 'col',                        magma_ptr_t ),
+        ( 'list',                       magma_ptr_t ),
+        ( 'tile_ptr',                   magma_ptr_t ),
+        ( 'tile_desc',                  magma_ptr_t ),
+        ( 'tile_desc_offset_ptr',       magma_ptr_t ),
+        ( 'tile_desc_offset',           magma_ptr_t ),
+        ( 'calibrator',                 magma_ptr_t ),
+        ( 'blockinfo',                  magma_ptr_t ),
+        ( 'blocksize',                  magma_int_t ),
+        ( 'numblocks',                  magma_int_t ),
+        ( 'alignment',                  magma_int_t ),
+        ( 'csr5_sigma',                 magma_int_t ),
+        ( 'csr5_bit_y_offset',          magma_int_t ),
+        ( 'csr5_bit_scansum_offset',    magma_int_t ),
+        ( 'csr5_num_packets',           magma_int_t ),
+        ( 'csr5_p',                     magma_index_t ),
+        ( 'csr5_num_offsets',           magma_index_t ),
+        ( 'csr5_tail_tile_start',       magma_index_t ),
+        ( 'major',                      magma_enum_t ),
+        ( 'ld',                         magma_int_t ),
+        ( 'op',                         magma_ptr_t ),
+    ]
+
+
+def _solver_par( real ):
+    class magma_solver_par( ctypes.Structure ):
+        _fields_ = [
+            ( 'solver',             magma_enum_t ),
+            ( 'version',            magma_int_t ),
+            ( 'atol',               real ),
+            ( 'rtol',               real ),
+            ( 'maxiter',            magma_int_t ),
+            ( 'restart',            magma_int_t ),
+            ( 'ortho',              magma_enum_t ),
+            ( 'sstep',              magma_int_t ),
+            ( 'numiter',            magma_int_t ),
+            ( 'spmv_count',         magma_int_t ),
+            ( 'init_res',           real ),
+            ( 'final_res',          real ),
+            ( 'iter_res',           real ),
+            ( 'num_replace',        magma_int_t ),
+            ( 'replace_res',        real ),
+            ( 'runtime',            ctypes.c_double ),
+            ( 'res_vec',            magma_ptr_t ),
+            ( 'timing',             magma_ptr_t ),
+            ( 'verbose',            magma_int_t ),
+            ( 'num_eigenvalues',    magma_int_t ),
+            ( 'ev_length',          magma_int_t ),
+            ( 'eigenvalues',        magma_ptr_t ),
+            ( 'eigenvectors',       magma_ptr_t ),
+            ( 'info',               magma_int_t ),
+            ( 'perf',               magma_perf_counters ),
+        ]
+    return magma_solver_par
+
+
+def _preconditioner( real ):
+    class magma_preconditioner( ctypes.Structure ):
+        _fields_ = [
+            ( 'solver',             magma_enum_t ),
+            ( 'trisolver',          magma_enum_t ),
+            ( 'levels',             magma_int_t ),
+            ( 'sweeps',             magma_int_t ),
+            ( 'pattern',            magma_int_t ),
+            ( 'bsize',              magma_int_t ),
+            ( 'offset',             magma_int_t ),
+            ( 'format',             magma_enum_t ),
+            ( 'atol',               real ),
+            ( 'rtol',               real ),
+            ( 'maxiter',            magma_int_t ),
+            ( 'restart',            magma_int_t ),
+            ( 'degree',             magma_int_t ),
+            ( 'emin',               real ),
+            ( 'emax',               real ),
+            ( 'subdomains',         magma_int_t ),
+            ( 'overlap',            magma_int_t ),
+            ( 'num_local',          magma_int_t ),
+            ( 'local',              magma_ptr_t ),
+            ( 'numiter',            magma_int_t ),
+            ( 'spmv_count',         magma_int_t ),
+            ( 'init_res',           real ),
+            ( 'final_res',          real ),
+            ( 'runtime',            ctypes.c_double ),
+            ( 'setuptime',          ctypes.c_double ),
+            ( 'perf',               magma_perf_counters ),
+            ( 'M',                  magma_matrix ),
+            ( 'L',                  magma_matrix ),
+            ( 'LT',                 magma_matrix ),
+            ( 'U',                  magma_matrix ),
+            ( 'UT',                 magma_matrix ),
+            ( 'LD',                 magma_matrix ),
+            ( 'UD',                 magma_matrix ),
+            ( 'LDT',                magma_matrix ),
+            ( 'UDT',                magma_matrix ),
+            ( 'Lnz',                magma_ptr_t ),
+            ( 'Unz',                magma_ptr_t ),
+            ( 'Lja',                magma_ptr_t ),
+            ( 'Uja',                magma_ptr_t ),
+            ( 'Lma',                magma_ptr_t ),
+            ( 'Uma',                magma_ptr_t ),
+            ( 'd',                  magma_matrix ),
+            ( 'd2',                 magma_matrix ),
+            ( 'work1',              magma_matrix ),
+            ( 'work2',              magma_matrix ),
+            ( 'int_array_1',        magma_ptr_t ),
+            ( 'int_array_2',        magma_ptr_t ),
+            ( 'L_dgraphindegree',       magma_ptr_t ),
+            ( 'L_dgraphindegree_bak',   magma_ptr_t ),
+            ( 'U_dgraphindegree',       magma_ptr_t ),
+            ( 'U_dgraphindegree_bak',   magma_ptr_t ),
+            ( 'cuinfo',             magma_ptr_t ),
+            ( 'cuinfoL',            magma_ptr_t ),
+            ( 'cuinfoLT',           magma_ptr_t ),
+            ( 'cuinfoU',            magma_ptr_t ),
+            ( 'cuinfoUT',           magma_ptr_t ),
+            ( 'transpose',          magma_enum_t ),
+        ]
+    return magma_preconditioner
+
+
+class magma_recycle( ctypes.Structure ):
+    _fields_ = [
+        ( 'k',                  magma_int_t ),
+        ( 'num_vecs',           magma_int_t ),
+        ( 'ld',                 magma_int_t ),
+        ( 'capacity',           magma_int_t ),
+        ( 'num_updates',        magma_int_t ),
+        ( 'dU',                 magma_ptr_t ),
+        ( 'dC',                 magma_ptr_t ),
+    ]
+
+
+def _opts( real ):
+    class magma_opts( ctypes.Structure ):
+        _fields_ = [
+            ( 'operation',          magma_enum_t ),
+            ( 'compute_location',   magma_enum_t ),
+            ( 'solver_par',         _solver_par( real ) ),
+            ( 'precond_par',        _preconditioner( real ) ),
+            ( 'recycle',            magma_recycle ),
+            ( 'input_format',       magma_enum_t ),
+            ( 'trans',              magma_enum_t ),
+            ( 'blocksize',          magma_int_t ),
+            ( 'alignment',          magma_int_t ),
+            ( 'output_format',      magma_enum_t ),
+            ( 'input_location',     magma_enum_t ),
+            ( 'output_location',    magma_enum_t ),
+            ( 'scaling',            magma_enum_t ),
+        ]
+    return magma_opts
+
+
+OPTS = { p: _opts( real ) for p, (t, real) in PRECISIONS.items() }
+
+
+# ------------------------------------------------------------------------------
+# library handling
+
+_lib   = None      # libmagma_sparse, loaded with RTLD_GLOBAL after libmagma
+_queue = None
+
+
+def _load_library( name, libdir ):
+    if libdir is not None:
+        return ctypes.CDLL( os.path.join( libdir, 'lib' + name + '.so' ),
+                            mode=ctypes.RTLD_GLOBAL )
+    path = ctypes.util.find_library( name )
+    if path is None:
+        raise OSError( 'cannot find lib%s; set MAGMA_LIBDIR' % name )
+    return ctypes.CDLL( path, mode=ctypes.RTLD_GLOBAL )
+
+
+def init( libdir=None, device=0 ):
+    """Loads libmagma and libmagma_sparse (from libdir, $MAGMA_LIBDIR, or the
+    loader path), initializes MAGMA and creates the queue used by all calls."""
+    global _lib, _queue
+    if _lib is not None:
+        return
+    libdir = libdir or os.environ.get( 'MAGMA_LIBDIR' )
+    _load_library( 'magma', libdir )
+    lib = _load_library( 'magma_sparse', libdir )
+    lib.magma_init()
+    queue = ctypes.c_void_p()
+    lib.magma_queue_create_internal( magma_int_t( device ), ctypes.byref( queue ),
+                                     b'init', b'magma_interface.py', 0 )
+    _lib, _queue = lib, queue
+
+
+def finalize():
+    """Destroys the queue and finalizes MAGMA."""
+    global _lib, _queue
+    if _lib is None:
+        return
+    _lib.magma_queue_destroy_internal( _queue, b'finalize', b'magma_interface.py', 0 )
+    _lib.magma_finalize()
+    _lib, _queue = None, None
+
+
+def _call( name, p, *args ):
+    """Calls magma_<p><name> (name contains the '%s' for the precision) and
+    raises RuntimeError for a non-zero MAGMA error code."""
+    if _lib is None:
+        raise RuntimeError( 'magma_interface.init() was not called' )
+    fn = getattr( _lib, name % p )
+    fn.restype = magma_int_t
+    info = fn( *( args + ( _queue, ) ) )
+    if info != 0:
+        raise RuntimeError( '%s returned %d' % ( name % p, info ) )
+    return info
+
+
+# ------------------------------------------------------------------------------
+# zero-copy wrappers
+
+class SparseMatrix( object ):
+    """Wraps a SciPy CSR or CSC matrix as a magma_?_matrix on the CPU without
+    copying. The SciPy arrays must not be resized while the wrapper is used."""
+
+    def __init__( self, A, precision=None ):
+        if scipy is None or not scipy.sparse.issparse( A ):
+            raise TypeError( 'expected a scipy.sparse matrix' )
+        if A.format not in ( 'csr', 'csc' ):
+            A = A.tocsr()
+        p = precision or precision_of( A.dtype ) or 'd'
+        dtype = PRECISIONS[ p ][ 0 ]
+        # these are no-ops, i.e., no copy, for matching types
+        self.val    = numpy.ascontiguousarray( A.data,    dtype=dtype )
+        self.ptr    = numpy.ascontiguousarray( A.indptr,  dtype=numpy.int32 )
+        self.idx    = numpy.ascontiguousarray( A.indices, dtype=numpy.int32 )
+        self.format = A.format
+        self.shape  = A.shape
+        self.precision = p
+
+        M = magma_matrix()
+        M.memory_location = Magma_CPU
+        M.num_rows  = A.shape[0]
+        M.num_cols  = A.shape[1]
+        M.nnz       = self.val.size
+        M.true_nnz  = self.val.size
+        M.ownership = MagmaFalse
+        M.val = self.val.ctypes.data
+        if A.format == 'csr':
+            M.storage_type = Magma_CSR
+            M.row = self.ptr.ctypes.data
+            M.col = self.idx.ctypes.data
+        else:
+            # MAGMA's CSC keeps the column pointer in col and the row indices in row
+            M.storage_type = Magma_CSC
+            M.col = self.ptr.ctypes.data
+            M.row = self.idx.ctypes.data
+        self.matrix = M
+
+    def to_scipy( self ):
+        """Returns a SciPy matrix sharing the wrapped arrays."""
+        cls = scipy.sparse.csr_matrix if self.format == 'csr' else scipy.sparse.csc_matrix
+        return cls( ( self.val, self.idx, self.ptr ), shape=self.shape, copy=False )
+
+
+class DenseVector( object ):
+    """Wraps a 1-D NumPy array, or a 2-D array with column-major layout, as a
+    dense magma_?_matrix on the CPU without copying."""
+
+    def __init__( self, v, precision=None ):
+        p = precision or precision_of( v.dtype ) or 'd'
+        self.array = numpy.asarray( v, dtype=PRECISIONS[ p ][ 0 ], order='F' )
+        self.precision = p
+        m = self.array.shape[0]
+        n = self.array.shape[1] if self.array.ndim > 1 else 1
+        M = magma_matrix()
+        M.storage_type = Magma_DENSE
+        M.memory_location = Magma_CPU
+        M.num_rows  = m
+        M.num_cols  = n
+        M.nnz       = m*n
+        M.major     = MagmaColMajor
+        M.ld        = m
+        M.ownership = MagmaFalse
+        M.val = self.array.ctypes.data
+        self.matrix = M
+
+
+def to_device( A ):
+    """Copies a wrapped matrix or vector to the device; returns a
+    magma_?_matrix to be released with free()."""
+    dA = magma_matrix()
+    _call( 'magma_%smtransfer', A.precision, A.matrix, ctypes.byref( dA ),
+           magma_enum_t( Magma_CPU ), magma_enum_t( Magma_DEV ) )
+    if A.matrix.storage_type == Magma_CSC:
+        dB = magma_matrix()
+        _call( 'magma_%smconvert', A.precision, dA, ctypes.byref( dB ),
+               magma_enum_t( Magma_CSC ), magma_enum_t( Magma_CSR ) )
+        free( dA, A.precision )
+        dA = dB
+    return dA
+
+
+def get_vector( dx, x ):
+    """Copies the device vector dx into the NumPy array of the DenseVector x."""
+    if _lib is None:
+        raise RuntimeError( 'magma_interface.init() was not called' )
+    _lib.magma_getvector_internal(
+        magma_int_t( x.array.size ), magma_int_t( x.array.itemsize ),
+        ctypes.c_void_p( dx.val ), magma_int_t( 1 ),
+        ctypes.c_void_p( x.array.ctypes.data ), magma_int_t( 1 ),
+        _queue, b'get_vector', b'magma_interface.py', 0 )
+
+
+def free( A, precision ):
+    """Releases a magma_?_matrix allocated by MAGMA."""
+    _call( 'magma_%smfree', precision, ctypes.byref( A ) )
+
+
+# ------------------------------------------------------------------------------
+# solvers and preconditioners
+
+class Solver( object ):
+    """Iterative solver with preconditioner for a SciPy matrix.
+
+    options uses the syntax of the MAGMA-sparse testers, e.g.
+    "--solver PCG --precond ILU --maxiter 500 --rtol 1e-8 --perf 1", and is
+    parsed by magma_?parse_opts, so all solvers, preconditioners and their
+    parameters are available. The matrix is copied to the device once; the
+    preconditioner is set up in the constructor and reused by solve().
+    """
+
+    def __init__( self, A, options='', precision=None ):
+        self.A = A if isinstance( A, SparseMatrix ) else SparseMatrix( A, precision )
+        p = self.precision = self.A.precision
+        self.n = self.A.shape[0]
+
+        self.opts = OPTS[ p ]()
+        argv = [ b'magma_interface' ] + [ s.encode() for s in shlex.split( options ) ]
+        c_argv = ( ctypes.c_char_p * len( argv ) )( *argv )
+        i = ctypes.c_int( 1 )
+        _call( 'magma_%sparse_opts', p, ctypes.c_int( len( argv ) ), c_argv,
+               ctypes.byref( self.opts ), ctypes.byref( i ) )
+        _call( 'magma_%ssolverinfo_init', p, ctypes.byref( self.opts.solver_par ),
+               ctypes.byref( self.opts.precond_par ) )
+
+        # device copy in the requested format
+        self.dA = None
+        if self.opts.output_format != Magma_CSR:
+            if self.A.format != 'csr':
+                self.A = SparseMatrix( self.A.to_scipy().tocsr(), p )
+            hB = magma_matrix()
+            _call( 'magma_%smconvert', p, self.A.matrix, ctypes.byref( hB ),
+                   magma_enum_t( Magma_CSR ), magma_enum_t( self.opts.output_format ) )
+            self.dA = magma_matrix()
+            _call( 'magma_%smtransfer', p, hB, ctypes.byref( self.dA ),
+                   magma_enum_t( Magma_CPU ), magma_enum_t( Magma_DEV ) )
+            free( hB, p )
+        else:
+            self.dA = to_device( self.A )
+
+        db = to_device( DenseVector( numpy.ones( self.n ), p ) )
+        try:
+            _call( 'magma_%s_precondsetup', p, self.dA, db,
+                   ctypes.byref( self.opts.solver_par ),
+                   ctypes.byref( self.opts.precond_par ) )
+        finally:
+            free( db, p )
+
+    def solve( self, b, x0=None ):
+        """Solves A x = b; returns x as a NumPy array. Raises RuntimeError for
+        MAGMA errors, slow convergence is reported through info."""
+        p = self.precision
+        b = DenseVector( b, p )
+        x = DenseVector( numpy.zeros( self.n ) if x0 is None else numpy.array( x0 ), p )
+        db = to_device( b )
+        dx = to_device( x )
+        try:
+            fn = getattr( _lib, 'magma_%s_solver' % p )
+            fn.restype = magma_int_t
+            self.info = fn( self.dA, db, ctypes.byref( dx ),
+                            ctypes.byref( self.opts ), _queue )
+            get_vector( dx, x )
+        finally:
+            free( db, p )
+            free( dx, p )
+        return x.array
+
+    def precond( self, b ):
+        """Applies the left and right preconditioner to b."""
+        p = self.precision
+        b = DenseVector( b, p )
+        t = DenseVector( numpy.zeros( self.n ), p )
+        db, dt, dx = to_device( b ), to_device( t ), to_device( t )
+        try:
+            _call( 'magma_%s_applyprecond_left', p, magma_enum_t( MagmaNoTrans ), self.dA, db,
+                   ctypes.byref( dt ), ctypes.byref( self.opts.precond_par ) )
+            _call( 'magma_%s_applyprecond_right', p, magma_enum_t( MagmaNoTrans ), self.dA, dt,
+                   ctypes.byref( dx ), ctypes.byref( self.opts.precond_par ) )
+            get_vector( dx, t )
+        finally:
+            free( db, p )
+            free( dt, p )
+            free( dx, p )
+        return t.array
+
+    # feedback of the last solve
+    numiter     = property( lambda self: self.opts.solver_par.numiter )
+    spmv_count  = property( lambda self: self.opts.solver_par.spmv_count )
+    init_res    = property( lambda self: self.opts.solver_par.init_res )
+    final_res   = property( lambda self: self.opts.solver_par.final_res )
+    runtime     = property( lambda self: self.opts.solver_par.runtime )
+    setuptime   = property( lambda self: self.opts.precond_par.setuptime )
+
+    @staticmethod
+    def _perf( c ):
+        return { name: { 'calls': c.calls[k], 'time': c.time[k],
+                         'flops': c.flops[k], 'bytes': c.bytes[k] }
+                 for k, name in enumerate( MAGMA_PERF_PHASES ) }
+
+    @property
+    def perf( self ):
+        """Per-phase performance counters (enable with --perf 1)."""
+        return self._perf( self.opts.solver_par.perf )
+
+    @property
+    def precond_perf( self ):
+        """Counters of the preconditioner setup and applies (enable with --perf 1)."""
+        return self._perf( self.opts.precond_par.perf )
+
+    def close( self ):
+        if self.dA is not None:
+            free( self.dA, self.precision )
+            _call( 'magma_%ssolverinfo_free', self.precision,
+                   ctypes.byref( self.opts.solver_par ),
+                   ctypes.byref( self.opts.precond_par ) )
+            self.dA = None
+
+    def __enter__( self ):
+        return self
+
+    def __exit__( self, *args ):
+        self.close()
@@ -0,0 +1,194 @@
+"""
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+    Tests of the NumPy/SciPy interface to MAGMA-sparse.
+
+    The layout test compares the ctypes structures with
+    sparse/include/magmasparse_types.h and needs no library. The other tests
+    load libmagma_sparse (see magma_interface.init) and are skipped if it is
+    not found.
+
+    usage: python3 test_magma_interface.py [-v]
+"""
+
+import os
+import re
+import tempfile
+import threading
+import time
+import unittest
+
+import numpy
+import scipy.io
+import scipy.sparse
+
+import magma_interface as magma
+
+HEADER = os.path.join( os.path.dirname( os.path.abspath( __file__ ) ),
+                       '..', 'include', 'magmasparse_types.h' )
+
+
+def header_members( name ):
+    """Member names of 'typedef struct name' in the header; for unions the
+    first member, without the HAVE_PASTIX members."""
+    with open( HEADER ) as f:
+        text = f.read()
+    m = re.search( r'typedef struct %s\s*\{(.*?)\n\}\s*%s;' % ( name, name ), text, re.S )
+    body = re.sub( r'//[^\n]*', '', m.group( 1 ) )
+    body = re.sub( r'#if defined\(HAVE_PASTIX\).*?#endif', '', body, flags=re.S )
+    # keep the first member of unions
+    body = re.sub( r'union\s*\{\s*([^;]*;)[^}]*\}\s*;', r'\1', body )
+    members = []
+    for decl in body.split( ';' ):
+        decl = decl.strip()
+        if decl:
+            members.append( re.findall( r'(\w+)\s*(?:\[\w+\])?$', decl )[0] )
+    return members
+
+
+def laplace2d( n, dtype=numpy.float64 ):
+    T = scipy.sparse.diags( [ -1., 2., -1. ], [ -1, 0, 1 ], shape=( n, n ) )
+    I = scipy.sparse.identity( n )
+    return ( scipy.sparse.kron( T, I ) + scipy.sparse.kron( I, T ) ).tocsr().astype( dtype )
+
+
+class TestLayout( unittest.TestCase ):
+
+    def check( self, cls, name ):
+        self.assertEqual( [ f[0] for f in cls._fields_ ], header_members( name ) )
+
+    def test_matrix( self ):
+        for p in 'sdcz':
+            self.check( magma.magma_matrix, 'magma_%s_matrix' % p )
+
+    def test_solver_par( self ):
+        for p in 'sdcz':
+            self.check( magma.OPTS[p]._fields_[2][1], 'magma_%s_solver_par' % p )
+
+    def test_preconditioner( self ):
+        for p in 'sdcz':
+            self.check( magma.OPTS[p]._fields_[3][1], 'magma_%s_preconditioner' % p )
+
+    def test_opts( self ):
+        self.check( magma.magma_recycle, 'magma_d_recycle' )
+        self.check( magma.magma_perf_counters, 'magma_perf_counters' )
+        for p in 'sdcz':
+            self.check( magma.OPTS[p], 'magma_%sopts' % p )
+
+
+def have_library():
+    try:
+        magma.init()
+        return True
+    except OSError:
+        return False
+
+
+@unittest.skipUnless( have_library(), 'libmagma_sparse not found' )
+class TestLibrary( unittest.TestCase ):
+
+    def test_roundtrip( self ):
+        for dtype in ( numpy.float32, numpy.float64, numpy.complex64, numpy.complex128 ):
+            A = laplace2d( 20, dtype )
+            W = magma.SparseMatrix( A )
+            # zero-copy on the host
+            self.assertTrue( numpy.shares_memory( W.val, A.data ) )
+            self.assertEqual( W.matrix.ownership, magma.MagmaFalse )
+            B = W.to_scipy()
+            self.assertTrue( numpy.shares_memory( B.data, A.data ) )
+            # through the device and back
+            dA = magma.to_device( W )
+            hB = magma.magma_matrix()
+            magma._call( 'magma_%smtransfer', W.precision, dA, magma.ctypes.byref( hB ),
+                         magma.magma_enum_t( magma.Magma_DEV ),
+                         magma.magma_enum_t( magma.Magma_CPU ) )
+            n = A.shape[0]
+            nnz = hB.nnz
+            row = numpy.ctypeslib.as_array( magma.ctypes.cast( hB.row,
+                    magma.ctypes.POINTER( magma.ctypes.c_int ) ), ( n+1, ) )
+            col = numpy.ctypeslib.as_array( magma.ctypes.cast( hB.col,
+                    magma.ctypes.POINTER( magma.ctypes.c_int ) ), ( nnz, ) )
+            val = numpy.frombuffer( ( magma.ctypes.c_char * ( nnz * A.data.itemsize ) )
+                    .from_address( hB.val ), dtype=dtype )
+            C = scipy.sparse.csr_matrix( ( val.copy(), col.copy(), row.copy() ), shape=A.shape )
+            self.assertEqual( abs( C - A ).max(), 0 )
+            magma.free( dA, W.precision )
+            magma.free( hB, W.precision )
+
+    def test_csc( self ):
+        A = laplace2d( 16 ) + scipy.sparse.diags( numpy.arange( 256.0 ), 1, shape=( 256, 256 ) )
+        b = numpy.ones( 256 )
+        with magma.Solver( A.tocsc(), '--solver GMRES --restart 60 --rtol 1e-10' ) as s:
+            x = s.solve( b )
+        self.assertLess( numpy.linalg.norm( A @ x - b ) / numpy.linalg.norm( b ), 1e-8 )
+
+    def test_solve( self ):
+        A = laplace2d( 32 )
+        b = numpy.ones( A.shape[0] )
+        for opts in ( '--solver CG', '--solver PCG --precond JACOBI',
+                      '--solver PBICGSTAB --precond ILU', '--solver PCG --precond ILU --perf 1' ):
+            with magma.Solver( A, opts + ' --rtol 1e-10 --maxiter 2000' ) as s:
+                x = s.solve( b )
+                self.assertEqual( s.info, 0 )
+                self.assertGreater( s.numiter, 0 )
+                res = numpy.linalg.norm( A @ x - b ) / numpy.linalg.norm( b )
+                self.assertLess( res, 1e-8, opts )
+                if '--perf' in opts:
+                    self.assertEqual( s.perf['spmv']['calls'], s.spmv_count )
+                    self.assertEqual( s.precond_perf['setup']['calls'], 1 )
+                    self.assertGreater( s.precond_perf['precond']['calls'], s.numiter )
+
+    def test_precond( self ):
+        A = laplace2d( 16 )
+        b = numpy.random.rand( A.shape[0] )
+        with magma.Solver( A, '--solver PCG --precond JACOBI' ) as s:
+            y = s.precond( b )
+        self.assertTrue( numpy.allclose( y, b / A.diagonal() ) )
+
+    def test_gil_released( self ):
+        A = laplace2d( 256 )
+        b = numpy.ones( A.shape[0] )
+        ticks = [ 0 ]
+        done = threading.Event()
+
+        def count():
+            while not done.is_set():
+                ticks[0] += 1
+
+        with magma.Solver( A, '--solver CG --rtol 1e-12 --maxiter 3000' ) as s:
+            t = threading.Thread( target=count )
+            t.start()
+            before = ticks[0]
+            s.solve( b )
+            during = ticks[0] - before
+            done.set()
+            t.join()
+        self.assertGreater( during, 0 )
+
+    def test_performance( self ):
+        # zero-copy wrapping against the previous .mtx round trip
+        A = laplace2d( 300 )
+        start = time.time()
+        for k in range( 10 ):
+            W = magma.SparseMatrix( A )
+        t_wrap = ( time.time() - start ) / 10
+
+        with tempfile.TemporaryDirectory() as d:
+            name = os.path.join( d, 'A.mtx' )
+            start = time.time()
+            scipy.io.mmwrite( name, A )
+            hA = magma.magma_matrix()
+            magma._call( 'magma_%s_csr_mtx', 'd', magma.ctypes.byref( hA ), name.encode() )
+            t_mtx = time.time() - start
+            magma.free( hA, 'd' )
+        print( '\n%% n = %d, nnz = %d: wrap %.2e sec, mtx write/read %.2e sec'
+               % ( A.shape[0], A.nnz, t_wrap, t_mtx ) )
+        self.assertLess( t_wrap, t_mtx )
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -62,9 +62,11 @@ magma_z_precond(
     psolver_par.maxiter = precond->maxiter;
     psolver_par.restart = precond->restart;
     psolver_par.verbose = 0;
+    psolver_par.perf.enabled = 0;
     magma_z_preconditioner pprecond;
     pprecond.solver = Magma_NONE;
     pprecond.maxiter = 3;
+    pprecond.perf.enabled = 0;
 
     switch( precond->solver ) {
         case  Magma_CG:
@@ -96,6 +98,54 @@ cleanup:
 
 
 
+/**
+    Purpose
+    -------
+
+    Generates the approximate inverses precond->LD and precond->UD of the
+    triangular factors precond->L and precond->U. For the ISAI with
+    precond->pattern > 1, the sparsity patterns are the ones of the powers
+    L^pattern and U^pattern, otherwise the patterns of the factors are used.
+
+    Arguments
+    ---------
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner containing the triangular factors
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+static magma_int_t
+magma_zisai_factors_setup(
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_z_matrix SL={Magma_CSR}, SU={Magma_CSR};
+
+    if ( precond->trisolver == Magma_ISAI && precond->pattern > 1 ) {
+        CHECK( magma_zmisai_pattern( MagmaLower, precond->pattern, precond->L, &SL, queue ));
+        CHECK( magma_zmisai_pattern( MagmaUpper, precond->pattern, precond->U, &SU, queue ));
+        CHECK( magma_ziluisaisetup_lower( precond->L, SL, &precond->LD, queue ));
+        CHECK( magma_ziluisaisetup_upper( precond->U, SU, &precond->UD, queue ));
+    } else {
+        CHECK( magma_ziluisaisetup_lower( precond->L, precond->L, &precond->LD, queue ));
+        CHECK( magma_ziluisaisetup_upper( precond->U, precond->U, &precond->UD, queue ));
+    }
+
+cleanup:
+    magma_zmfree( &SL, queue );
+    magma_zmfree( &SU, queue );
+    return info;
+}
+
+
 /**
     Purpose
     -------
@@ -143,10 +193,15 @@ magma_z_precondsetup(
     // magma_zprecondfree( precond, queue );
     
     //Chronometry
-    real_Double_t tempo1, tempo2;
+    real_Double_t tempo1, tempo2, tp;
     
     tempo1 = magma_sync_wtime( queue );
     
+    // the preconditioner counters follow the solver counters
+    precond->perf.enabled = solver->perf.enabled;
+    magma_perf_reset( &precond->perf );
+    tp = magma_perf_tic( &precond->perf, queue );
+    
     if( A.num_rows != A.num_cols ){
         printf("%% warning: non-square matrix.\n");
         printf("%% Fallback: no preconditioner.\n");
@@ -166,12 +221,7 @@ magma_z_precondsetup(
             precond->trisolver == Magma_JACOBI ||
             precond->trisolver == Magma_VBJACOBI ){
             info = magma_zcumilusetup( A, precond, queue );
-            info = magma_ziluisaisetup_lower( precond->L, precond->L, &precond->LD, queue );
-            info = magma_ziluisaisetup_upper( precond->U, precond->U, &precond->UD, queue );
-            if (info == Magma_CUSOLVE) {
-                precond->trisolver = Magma_CUSOLVE;
-                info = 0;
-            }
+            info = magma_zisai_factors_setup( precond, queue );
         } else {
             info = magma_zcumilusetup( A, precond, queue );
         }
@@ -181,12 +231,7 @@ magma_z_precondsetup(
         if ( precond->trisolver == Magma_ISAI ||
              precond->trisolver == Magma_JACOBI ||
              precond->trisolver == Magma_VBJACOBI ){
-             info = magma_ziluisaisetup_lower( precond->L, precond->L, &precond->LD, queue );
-             info = magma_ziluisaisetup_upper( precond->U, precond->U, &precond->UD, queue );
-             if (info == Magma_CUSOLVE) {
-                precond->trisolver = Magma_CUSOLVE;
-                info = 0;
-             }
+             info = magma_zisai_factors_setup( precond, queue );
         }
     }
     else if ( precond->solver == Magma_ILUT ) {
@@ -201,12 +246,7 @@ magma_z_precondsetup(
             if ( precond->trisolver == Magma_ISAI  ||
                 precond->trisolver == Magma_JACOBI ||
                 precond->trisolver == Magma_VBJACOBI ){
-                info = magma_ziluisaisetup_lower( precond->L, precond->L, &precond->LD, queue );
-                info = magma_ziluisaisetup_upper( precond->U, precond->U, &precond->UD, queue );
-                if (info == Magma_CUSOLVE) {
-                    precond->trisolver = Magma_CUSOLVE;
-                    info = 0;
-                }
+                info = magma_zisai_factors_setup( precond, queue );
              }
             precond->solver = Magma_PARILU; // handle as PARILU
         #else
@@ -224,8 +264,7 @@ magma_z_precondsetup(
              precond->trisolver == Magma_JACOBI ||
              precond->trisolver == Magma_VBJACOBI ){
             info = magma_zcumiccsetup( A, precond, queue );
-            info = magma_ziluisaisetup_lower( precond->L, precond->L, &precond->LD, queue );
-            info = magma_ziluisaisetup_upper( precond->U, precond->U, &precond->UD, queue );
+            info = magma_zisai_factors_setup( precond, queue );
         } else {
             info = magma_zcumiccsetup( A, precond, queue );
         }
@@ -246,6 +285,26 @@ magma_z_precondsetup(
         info = magma_zcustomicsetup( A, b, precond, queue );
         precond->solver = Magma_PARIC; // handle as PARIC
     }
+    // matrix-free: the user provides precond->M (left) and/or precond->U (right)
+    else if ( precond->solver == Magma_FUNCTION ) {
+        if ( ( precond->M.storage_type != Magma_SPMVFUNCTION || precond->M.op == NULL ) &&
+             ( precond->U.storage_type != Magma_SPMVFUNCTION || precond->U.op == NULL ) ) {
+            printf( "error: no preconditioner operator given.\n" );
+            info = MAGMA_ERR_BADPRECOND;
+        }
+    }
+    // polynomial preconditioner, SpMV only
+    else if ( precond->solver == Magma_CHEBYSHEV ) {
+        info = magma_zchebyshevsetup( A, b, precond, queue );
+    }
+    // restricted additive Schwarz, subdomain solves on the CPU
+    else if ( precond->solver == Magma_SCHWARZ ) {
+        info = magma_zschwarz_setup( A, b, precond, queue );
+    }
+    // variable-block Jacobi, blocks from supernode detection, CPU
+    else if ( precond->solver == Magma_VBJACOBI ) {
+        info = magma_zvbjacobisetup( A, b, precond, queue );
+    }
     // none case
     else if ( precond->solver == Magma_NONE ) {
         info = MAGMA_SUCCESS;
@@ -276,6 +335,9 @@ magma_z_precondsetup(
         }
     }
     
+    // estimated traffic: one pass over A
+    magma_perf_toc( &precond->perf, Magma_PERF_SETUP, tp, 0.0,
+                    A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)), queue );
     tempo2 = magma_sync_wtime( queue );
     precond->setuptime = tempo2-tempo1;
     
@@ -330,6 +392,7 @@ magma_z_applyprecond(
     magma_int_t info = 0;
     
     magma_z_matrix tmp={Magma_CSR};
+    real_Double_t tp = magma_perf_tic( &precond->perf, queue );
 
     if ( precond->solver == Magma_JACOBI ) {
         CHECK( magma_zjacobi_diagscal( b.num_rows, precond->d, b, x, queue ));
@@ -344,6 +407,15 @@ magma_z_applyprecond(
     else if ( precond->solver == Magma_ICC ) {
         CHECK( magma_zvinit( &tmp, Magma_DEV, b.num_rows, b.num_cols, MAGMA_Z_ZERO, queue ));
     }
+    else if ( precond->solver == Magma_CHEBYSHEV ) {
+        CHECK( magma_zapplychebyshev( A, b, x, precond, queue ));
+    }
+    else if ( precond->solver == Magma_SCHWARZ ) {
+        CHECK( magma_zapplyschwarz( b, x, precond, queue ));
+    }
+    else if ( precond->solver == Magma_VBJACOBI ) {
+        CHECK( magma_zapplyvbjacobi( b, x, precond, queue ));
+    }
     else if ( precond->solver == Magma_NONE ) {
         magma_zcopy( b.num_rows*b.num_cols, b.dval, 1, x->dval, 1, queue );      //  x = b
     }
@@ -351,6 +423,8 @@ magma_z_applyprecond(
         printf( "error: preconditioner type not yet supported.\n" );
         info = MAGMA_ERR_NOT_SUPPORTED;
     }
+    magma_perf_toc( &precond->perf, Magma_PERF_PRECOND, tp, 0.0,
+                    2. * b.num_rows * b.num_cols * sizeof(magmaDoubleComplex), queue );
 cleanup:
     magma_zmfree( &tmp, queue );
     //magmablasSetKernelStream( orig_queue );
@@ -409,9 +483,10 @@ magma_z_applyprecond_left(
     magma_int_t info = 0;
     
         //Chronometry
-    real_Double_t tempo1, tempo2;
+    real_Double_t tempo1, tempo2, tp;
     
     tempo1 = magma_sync_wtime( queue );
+    tp = magma_perf_tic( &precond->perf, queue );
 
     magma_zopts zopts;
     zopts.solver_par.solver = precond->trisolver;
@@ -421,6 +496,7 @@ magma_z_applyprecond_left(
     zopts.solver_par.restart = 50;
     zopts.solver_par.atol = 1e-16;
     zopts.solver_par.rtol = 1e-10;
+    zopts.solver_par.perf.enabled = 0;
     
     if( trans == MagmaNoTrans ) {
         if ( precond->solver == Magma_JACOBI ) {
@@ -471,6 +547,15 @@ magma_z_applyprecond_left(
         else if ( precond->solver == Magma_NONE ) {
             magma_zcopy( b.num_rows*b.num_cols, b.dval, 1, x->dval, 1, queue );      //  x = b
         }
+        else if ( precond->solver == Magma_CHEBYSHEV ) {
+            CHECK( magma_zapplychebyshev( A, b, x, precond, queue ));
+        }
+        else if ( precond->solver == Magma_SCHWARZ ) {
+            CHECK( magma_zapplyschwarz( b, x, precond, queue ));
+        }
+        else if ( precond->solver == Magma_VBJACOBI ) {
+            CHECK( magma_zapplyvbjacobi( b, x, precond, queue ));
+        }
         else if ( precond->solver == Magma_FUNCTION ) {
             CHECK( magma_zapplycustomprecond_l( b, x, precond, queue ));
         }
@@ -508,6 +593,15 @@ magma_z_applyprecond_left(
         else if ( precond->solver == Magma_NONE ) {
             magma_zcopy( b.num_rows*b.num_cols, b.dval, 1, x->dval, 1, queue );      //  x = b
         }
+        else if ( precond->solver == Magma_CHEBYSHEV ) {
+            CHECK( magma_zapplychebyshev( A, b, x, precond, queue ));
+        }
+        else if ( precond->solver == Magma_SCHWARZ ) {
+            CHECK( magma_zapplyschwarz_trans( b, x, precond, queue ));
+        }
+        else if ( precond->solver == Magma_VBJACOBI ) {
+            CHECK( magma_zapplyvbjacobi_trans( b, x, precond, queue ));
+        }
         else if ( precond->solver == Magma_FUNCTION ) {
             CHECK( magma_zapplycustomprecond_l( b, x, precond, queue ));
         }
@@ -520,6 +614,8 @@ magma_z_applyprecond_left(
         info = MAGMA_ERR_NOT_SUPPORTED; 
     }
     
+    magma_perf_toc( &precond->perf, Magma_PERF_PRECOND, tp, 0.0,
+                    2. * b.num_rows * b.num_cols * sizeof(magmaDoubleComplex), queue );
     tempo2 = magma_sync_wtime( queue );
     precond->runtime += tempo2-tempo1;
     
@@ -579,9 +675,10 @@ magma_z_applyprecond_right(
     magma_int_t info = 0;
     
         //Chronometry
-    real_Double_t tempo1, tempo2;
+    real_Double_t tempo1, tempo2, tp;
     
     tempo1 = magma_sync_wtime( queue );
+    tp = magma_perf_tic( &precond->perf, queue );
     
     magma_zopts zopts;
     zopts.solver_par.solver = precond->trisolver;
@@ -591,6 +688,7 @@ magma_z_applyprecond_right(
     zopts.solver_par.restart = 50;
     zopts.solver_par.atol = 1e-16;
     zopts.solver_par.rtol = 1e-10;
+    zopts.solver_par.perf.enabled = 0;
     
     if( trans == MagmaNoTrans ) {
         if ( precond->solver == Magma_JACOBI ) {
@@ -645,6 +743,15 @@ magma_z_applyprecond_right(
       //      CHECK( magma_zisai_r( b, x, precond, queue ) );
       //      // magma_z_spmv( MAGMA_Z_ONE, precond->U, b,MAGMA_Z_ZERO, *x, queue ); // SPAI
       //  }
+        else if ( precond->solver == Magma_CHEBYSHEV ) {
+            magma_zcopy( b.num_rows*b.num_cols, b.dval, 1, x->dval, 1, queue );    // x = b
+        }
+        else if ( precond->solver == Magma_SCHWARZ ) {
+            magma_zcopy( b.num_rows*b.num_cols, b.dval, 1, x->dval, 1, queue );    // x = b
+        }
+        else if ( precond->solver == Magma_VBJACOBI ) {
+            magma_zcopy( b.num_rows*b.num_cols, b.dval, 1, x->dval, 1, queue );    // x = b
+        }
         else if ( precond->solver == Magma_FUNCTION ) {
             CHECK( magma_zapplycustomprecond_r( b, x, precond, queue ));
         }
@@ -683,6 +790,18 @@ magma_z_applyprecond_right(
         else if ( precond->solver == Magma_NONE ) {
             magma_zcopy( b.num_rows*b.num_cols, b.dval, 1, x->dval, 1, queue );      //  x = b
         }
+        else if ( precond->solver == Magma_CHEBYSHEV ) {
+            magma_zcopy( b.num_rows*b.num_cols, b.dval, 1, x->dval, 1, queue );    // x = b
+        }
+        else if ( precond->solver == Magma_SCHWARZ ) {
+            // RAS is a left preconditioner only; M^{-T} is applied by the
+            // left transpose, the transposed right factor is the identity
+            magma_zcopy( b.num_rows*b.num_cols, b.dval, 1, x->dval, 1, queue );    // x = b
+        }
+        else if ( precond->solver == Magma_VBJACOBI ) {
+            // left preconditioner only, see Magma_SCHWARZ
+            magma_zcopy( b.num_rows*b.num_cols, b.dval, 1, x->dval, 1, queue );    // x = b
+        }
         else if ( precond->solver == Magma_FUNCTION ) {
             CHECK( magma_zapplycustomprecond_r( b, x, precond, queue ));
         }
@@ -692,6 +811,8 @@ magma_z_applyprecond_right(
         }
     }
     
+    magma_perf_toc( &precond->perf, Magma_PERF_PRECOND, tp, 0.0,
+                    2. * b.num_rows * b.num_cols * sizeof(magmaDoubleComplex), queue );
     tempo2 = magma_sync_wtime( queue );
     precond->runtime += tempo2-tempo1;
         
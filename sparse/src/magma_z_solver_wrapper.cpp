@@ -118,6 +118,18 @@ magma_z_solver(
                     CHECK( magma_zfgmres( A, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
             case  Magma_PGMRES:
                     CHECK( magma_zfgmres( A, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
+            case  Magma_SSTEPGMRES:
+                    CHECK( magma_zsstep_gmres( A, b, x, &zopts->solver_par, queue )); break;
+            case  Magma_PIPECG:
+                    CHECK( magma_zpipecg( A, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
+            case  Magma_PPIPECG:
+                    CHECK( magma_zpipecg( A, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
+            case  Magma_SSTEPCG:
+                    CHECK( magma_zsstep_cg( A, b, x, &zopts->solver_par, queue )); break;
+            case  Magma_GCRODR:
+                    CHECK( magma_zgcrodr( A, b, x, &zopts->recycle, &zopts->solver_par, &zopts->precond_par, queue )); break;
+            case  Magma_DEFCG:
+                    CHECK( magma_zdefcg( A, b, x, &zopts->recycle, &zopts->solver_par, &zopts->precond_par, queue )); break;
             case  Magma_IDR:
                     CHECK( magma_zidr( A, b, x, &zopts->solver_par, queue )); break;
             case  Magma_IDRMERGE:
@@ -138,6 +150,8 @@ magma_z_solver(
                     CHECK( magma_zbaiter( A, b, x, &zopts->solver_par, &zopts->precond_par, queue ) ); break;
             case  Magma_BAITERO:
                     CHECK( magma_zbaiter_overlap( A, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
+            case  Magma_BAITERCPU:
+                    CHECK( magma_zbaiter_cpu( A, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
             case  Magma_BOMBARD:
                     CHECK( magma_zbombard( A, b, x, &zopts->solver_par, queue ) ); break;
             case  Magma_BOMBARDMERGE:
@@ -20,7 +20,8 @@
     -------
 
     This is an interface to the left solve for any custom preconditioner.
-    It should compute x = FUNCTION(b)
+    It computes x = M(b), where M is the matrix-free operator in precond->M,
+    see magma_zmcreate_operator. Without it, x = b.
     The vectors are located on the device.
 
     Arguments
@@ -52,8 +53,14 @@ magma_zapplycustomprecond_l(
     magma_queue_t queue )
 {
     magma_int_t info = 0;
-    // vector access via x.dval, y->dval
-    
+
+    if ( precond->M.storage_type == Magma_SPMVFUNCTION && precond->M.op != NULL ) {
+        CHECK( magma_z_spmv( MAGMA_Z_ONE, precond->M, b, MAGMA_Z_ZERO, *x, queue ));
+    } else {
+        magma_zcopy( b.num_rows*b.num_cols, b.dval, 1, x->dval, 1, queue );  // x = b
+    }
+
+cleanup:
     return info;
 }
 
@@ -63,7 +70,8 @@ magma_zapplycustomprecond_l(
     -------
 
     This is an interface to the right solve for any custom preconditioner.
-    It should compute x = FUNCTION(b)
+    It computes x = U(b), where U is the matrix-free operator in precond->U,
+    see magma_zmcreate_operator. Without it, x = b.
     The vectors are located on the device.
 
     Arguments
@@ -95,9 +103,13 @@ magma_zapplycustomprecond_r(
     magma_queue_t queue )
 {
     magma_int_t info = 0;
-    // vector access via x.dval, y->dval
-    // sizes are x.num_rows, x.num_cols
-    
-    
+
+    if ( precond->U.storage_type == Magma_SPMVFUNCTION && precond->U.op != NULL ) {
+        CHECK( magma_z_spmv( MAGMA_Z_ONE, precond->U, b, MAGMA_Z_ZERO, *x, queue ));
+    } else {
+        magma_zcopy( b.num_rows*b.num_cols, b.dval, 1, x->dval, 1, queue );  // x = b
+    }
+
+cleanup:
     return info;
 }
@@ -0,0 +1,383 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define PRECISION_z
+
+// stride of the per-thread residual estimates, avoids false sharing
+#define RES_STRIDE 8
+
+
+// Relaxed atomic access to the shared iterate. Complex values are read and
+// written one real component at a time; a torn value is just another
+// asynchronous update and does not affect convergence.
+static inline magmaDoubleComplex
+magma_zbaiter_cpu_load( const magmaDoubleComplex *x, magma_int_t i )
+{
+    const double *p = (const double*) &x[i];
+    double re;
+    #pragma omp atomic read
+    re = p[0];
+    #if defined(PRECISION_z) || defined(PRECISION_c)
+    double im;
+    #pragma omp atomic read
+    im = p[1];
+    return MAGMA_Z_MAKE( re, im );
+    #else
+    return re;
+    #endif
+}
+
+static inline void
+magma_zbaiter_cpu_store( magmaDoubleComplex *x, magma_int_t i, magmaDoubleComplex v )
+{
+    double *p = (double*) &x[i];
+    double re = MAGMA_Z_REAL( v );
+    #pragma omp atomic write
+    p[0] = re;
+    #if defined(PRECISION_z) || defined(PRECISION_c)
+    double im = MAGMA_Z_IMAG( v );
+    #pragma omp atomic write
+    p[1] = im;
+    #endif
+}
+
+
+/**
+    Purpose
+    -------
+
+    Relaxes the rows [start, end) of the shared iterate x: localiter
+    Gauss-Seidel sweeps over the block, reading the values owned by other
+    threads with relaxed atomics. Returns the squared 2-norm of the block
+    residual b - A x before the relaxation.
+
+    @ingroup magmasparse_zgesv
+    ********************************************************************/
+
+static double
+magma_zbaiter_cpu_relax(
+    magma_z_matrix A,
+    const magmaDoubleComplex *d,
+    const magmaDoubleComplex *b,
+    magmaDoubleComplex *x,
+    magma_int_t start,
+    magma_int_t end,
+    magma_int_t localiter )
+{
+    double res = 0.0;
+
+    for( magma_int_t it=0; it < localiter; it++ ) {
+        for( magma_int_t i=start; i < end; i++ ) {
+            magmaDoubleComplex s = b[i];
+            for( magma_int_t j=A.row[i]; j < A.row[i+1]; j++ ) {
+                if ( A.col[j] != i ) {
+                    s = s - A.val[j] * magma_zbaiter_cpu_load( x, A.col[j] );
+                }
+            }
+            if ( it == 0 ) {
+                // x[i] is only written by this thread
+                magmaDoubleComplex r = s - d[i] * x[i];
+                res += MAGMA_Z_REAL( MAGMA_Z_CONJ( r ) * r );
+            }
+            magma_zbaiter_cpu_store( x, i, s / d[i] );
+        }
+    }
+    return res;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes the 2-norm of b - A x on the CPU.
+
+    @ingroup magmasparse_zgesv
+    ********************************************************************/
+
+static double
+magma_zbaiter_cpu_residual(
+    magma_z_matrix A,
+    const magmaDoubleComplex *b,
+    const magmaDoubleComplex *x )
+{
+    double res = 0.0;
+
+    #pragma omp parallel for reduction(+:res)
+    for( magma_int_t i=0; i < A.num_rows; i++ ) {
+        magmaDoubleComplex r = b[i];
+        for( magma_int_t j=A.row[i]; j < A.row[i+1]; j++ ) {
+            r = r - A.val[j] * x[ A.col[j] ];
+        }
+        res += MAGMA_Z_REAL( MAGMA_Z_CONJ( r ) * r );
+    }
+    return sqrt( res );
+}
+
+
+/**
+    Purpose
+    -------
+
+    Solves a system of linear equations
+       A * x = b
+    via block-asynchronous iteration on the CPU.
+
+    The rows are split into blocks of precond_par->bsize rows (default 256),
+    and each OpenMP thread owns a contiguous range of blocks. Each thread
+    relaxes its blocks with precond_par->maxiter local Gauss-Seidel sweeps,
+    reading the values of the other threads with relaxed atomics, without
+    any barrier. Convergence is detected from the block residuals computed
+    during the relaxations: each thread publishes the sum over its blocks,
+    and the first thread that sees the global estimate below the tolerance
+    raises a stop flag.
+
+    solver_par->version selects the variant:
+        0   asynchronous;
+        1   asynchronous with Southwell prioritization: a thread skips the
+            blocks whose last residual is below the mean of its blocks
+            (each block is relaxed at least every 4th pass);
+        2   synchronous reference, a barrier after each pass.
+
+    The asynchronous variants assume one thread per core: a descheduled
+    thread stops propagating its values, and the others keep relaxing
+    against stale data.
+
+    solver_par->numiter returns the largest number of passes of a thread,
+    solver_par->spmv_count the number of relaxed rows in units of the
+    matrix size (equivalent Jacobi sweeps).
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b
+
+    @param[in,out]
+    x           magma_z_matrix*
+                solution approximation
+
+    @param[in,out]
+    solver_par  magma_z_solver_par*
+                solver parameters
+
+    @param[in]
+    precond_par magma_z_preconditioner*
+                block size (bsize) and local sweeps (maxiter)
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgesv
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zbaiter_cpu(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue )
+{
+    magma_int_t info = MAGMA_NOTCONVERGED;
+
+    // prepare solver feedback
+    solver_par->solver = Magma_BAITERCPU;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+
+    real_Double_t tempo1, tempo2;
+    double nomb, tol;
+    magma_int_t n, nb, nthreads = 1;
+    magma_int_t localiter = max( 1, precond_par->maxiter );
+    magma_int_t bs = ( precond_par->bsize > 0 ) ? precond_par->bsize : 256;
+    magma_int_t version = solver_par->version;
+    magma_int_t maxpass = 0, done = 0;
+    long long relaxed = 0;
+
+    magma_z_matrix hAT={Magma_CSR}, hA={Magma_CSR}, hb={Magma_CSR}, hx={Magma_CSR};
+    magmaDoubleComplex *d = NULL;
+    double *res_est = NULL, *res_part = NULL;
+    magma_int_t *age = NULL;
+
+    // the iteration runs on the CPU
+    if ( A.memory_location != Magma_CPU || A.storage_type != Magma_CSR ) {
+        CHECK( magma_zmtransfer( A, &hAT, A.memory_location, Magma_CPU, queue ));
+        CHECK( magma_zmconvert( hAT, &hA, hAT.storage_type, Magma_CSR, queue ));
+        magma_zmfree( &hAT, queue );
+    } else {
+        CHECK( magma_zmtransfer( A, &hA, Magma_CPU, Magma_CPU, queue ));
+    }
+    CHECK( magma_zmtransfer( b, &hb, b.memory_location, Magma_CPU, queue ));
+    CHECK( magma_zmtransfer( *x, &hx, x->memory_location, Magma_CPU, queue ));
+    n = hA.num_rows;
+    nb = magma_ceildiv( n, bs );
+
+    CHECK( magma_zmalloc_cpu( &d, n ));
+    for( magma_int_t i=0; i < n; i++ ) {
+        d[i] = MAGMA_Z_ZERO;
+        for( magma_int_t j=hA.row[i]; j < hA.row[i+1]; j++ ) {
+            if ( hA.col[j] == i ) {
+                d[i] = hA.val[j];
+            }
+        }
+        if ( MAGMA_Z_ABS( d[i] ) == 0.0 ) {
+            printf("%%  error: zero diagonal element in row %lld.\n", (long long) i );
+            info = MAGMA_ERR_NOT_SUPPORTED;
+            goto cleanup;
+        }
+    }
+
+    #ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+    #endif
+    CHECK( magma_dmalloc_cpu( &res_est, nb ));
+    CHECK( magma_dmalloc_cpu( &res_part, nthreads*RES_STRIDE ));
+    CHECK( magma_imalloc_cpu( &age, nb ));
+    for( magma_int_t k=0; k < nb; k++ ) {
+        res_est[k] = -1.0;      // unknown: relax
+        age[k] = 0;
+    }
+    for( magma_int_t t=0; t < nthreads*RES_STRIDE; t++ ) {
+        res_part[t] = HUGE_VAL; // no estimate before the first pass
+    }
+
+    nomb = 0.0;
+    for( magma_int_t i=0; i < n; i++ ) {
+        nomb += MAGMA_Z_REAL( MAGMA_Z_CONJ( hb.val[i] ) * hb.val[i] );
+    }
+    nomb = sqrt( nomb );
+    if ( nomb == 0.0 ) {
+        nomb = 1.0;
+    }
+    tol = max( solver_par->rtol * nomb, solver_par->atol );
+    solver_par->init_res = magma_zbaiter_cpu_residual( hA, hb.val, hx.val );
+    if ( solver_par->verbose > 0 ) {
+        solver_par->res_vec[0] = (real_Double_t) solver_par->init_res;
+        solver_par->timing[0] = 0.0;
+    }
+
+    tempo1 = magma_wtime();
+    #pragma omp parallel num_threads( nthreads )
+    {
+        magma_int_t t = 0, nt = 1;
+        #ifdef _OPENMP
+        t = omp_get_thread_num();
+        nt = omp_get_num_threads();
+        #endif
+        magma_int_t kb0 = (t*nb) / nt, kb1 = ((t+1)*nb) / nt;
+        magma_int_t pass = 0, stop = 0;
+        long long rows = 0;
+
+        while ( ! stop ) {
+            double sum = 0.0, mean = 0.0;
+            if ( version == 1 ) {
+                for( magma_int_t k=kb0; k < kb1; k++ ) {
+                    mean += res_est[k];
+                }
+                mean /= max( 1, kb1-kb0 );
+            }
+            for( magma_int_t k=kb0; k < kb1; k++ ) {
+                if ( version == 1 && res_est[k] >= 0.0
+                     && res_est[k] < mean && age[k] < 3 ) {
+                    age[k]++;
+                    sum += res_est[k];
+                    continue;
+                }
+                magma_int_t start = k*bs, end = min( n, (k+1)*bs );
+                res_est[k] = magma_zbaiter_cpu_relax( hA, d, hb.val, hx.val,
+                                                      start, end, localiter );
+                age[k] = 0;
+                sum += res_est[k];
+                rows += end - start;
+            }
+            pass++;
+            #pragma omp atomic write
+            res_part[ t*RES_STRIDE ] = sum;
+
+            double total = 0.0;
+            if ( version == 2 ) {
+                #pragma omp barrier
+                for( magma_int_t s=0; s < nt; s++ ) {
+                    total += res_part[ s*RES_STRIDE ];
+                }
+                #pragma omp barrier
+                stop = ( sqrt( total ) <= tol || pass >= solver_par->maxiter );
+            } else {
+                // distributed residual estimate, no synchronization
+                for( magma_int_t s=0; s < nt; s++ ) {
+                    double part;
+                    #pragma omp atomic read
+                    part = res_part[ s*RES_STRIDE ];
+                    total += part;
+                }
+                if ( sqrt( total ) <= tol ) {
+                    #pragma omp atomic write
+                    done = 1;
+                }
+                magma_int_t flag;
+                #pragma omp atomic read
+                flag = done;
+                stop = ( flag || pass >= solver_par->maxiter );
+            }
+        }
+        #pragma omp atomic
+        relaxed += rows;
+        #pragma omp critical
+        maxpass = max( maxpass, pass );
+    }
+    tempo2 = magma_wtime();
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    solver_par->numiter = maxpass;
+    solver_par->spmv_count = (magma_int_t) (relaxed / max( 1, n ));
+
+    solver_par->final_res = magma_zbaiter_cpu_residual( hA, hb.val, hx.val );
+    solver_par->iter_res = solver_par->final_res;
+    if ( x->memory_location == Magma_DEV ) {
+        magma_zsetvector( n, hx.val, 1, x->dval, 1, queue );
+    } else {
+        for( magma_int_t i=0; i < n; i++ ) {
+            x->val[i] = hx.val[i];
+        }
+    }
+
+    if ( solver_par->final_res <= tol ) {
+        info = MAGMA_SUCCESS;
+    } else if ( solver_par->init_res > solver_par->final_res ) {
+        info = MAGMA_SLOW_CONVERGENCE;
+    } else {
+        info = MAGMA_DIVERGENCE;
+    }
+
+cleanup:
+    magma_zmfree( &hAT, queue );
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &hb, queue );
+    magma_zmfree( &hx, queue );
+    magma_free_cpu( d );
+    magma_free_cpu( res_est );
+    magma_free_cpu( res_part );
+    magma_free_cpu( age );
+
+    solver_par->info = info;
+    return info;
+}   /* magma_zbaiter_cpu */
@@ -68,6 +68,12 @@ magma_zbicg(
     magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
     
     magma_int_t dofs = A.num_rows * b.num_cols;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) * b.num_cols
+                        + 2 * vbytes;
 
     // workspace
     magma_z_matrix r={Magma_CSR}, rt={Magma_CSR}, p={Magma_CSR}, pt={Magma_CSR}, 
@@ -140,23 +146,29 @@ magma_zbicg(
 
     solver_par->numiter = 0;
     solver_par->spmv_count = 0;
+    magma_perf_reset( &solver_par->perf );
     // start iteration
     do
     {
         solver_par->numiter++;
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zcopy( dofs, r.dval, 1 , y.dval, 1, queue );             // y=r
         magma_zcopy( dofs, y.dval, 1 , z.dval, 1, queue );             // z=y
         magma_zcopy( dofs, rt.dval, 1 , yt.dval, 1, queue );           // yt=rt
         magma_zcopy( dofs, yt.dval, 1 , zt.dval, 1, queue );           // zt=yt
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, 0.0, 8*vbytes, queue );
         
         rho= rho_new;
+        tp = magma_perf_tic( &solver_par->perf, queue );
         rho_new = magma_zdotc( dofs, rt.dval, 1, z.dval, 1, queue );  // rho=<rt,z>
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
         if( magma_z_isnan_inf( rho_new ) ){
             info = MAGMA_DIVERGENCE;
             break;
         }
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         if( solver_par->numiter==1 ){
             magma_zcopy( dofs, z.dval, 1 , p.dval, 1, queue );           // yt=rt
             magma_zcopy( dofs, zt.dval, 1 , pt.dval, 1, queue );           // zt=yt
@@ -167,19 +179,30 @@ magma_zbicg(
             magma_zscal( dofs, MAGMA_Z_CONJ(beta), pt.dval, 1, queue );   // pt = beta*pt
             magma_zaxpy( dofs, c_one , zt.dval, 1 , pt.dval, 1, queue );  // pt = zt+beta*pt
         }
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 4.*dofs, 2.*dofs ), 10*vbytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, p, c_zero, q, queue ));      // v = Ap
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, AT, pt, c_zero, qt, queue ));   // v = Ap
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
         solver_par->spmv_count++;
         solver_par->spmv_count++;
+        tp = magma_perf_tic( &solver_par->perf, queue );
         ptq = magma_zdotc( dofs, pt.dval, 1, q.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
         alpha = rho_new /ptq;
         
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zaxpy( dofs, alpha, p.dval, 1 , x->dval, 1, queue );                // x=x+alpha*p
         magma_zaxpy( dofs, c_neg_one * alpha, q.dval, 1 , r.dval, 1, queue );     // r=r+alpha*q
         magma_zaxpy( dofs, c_neg_one * MAGMA_Z_CONJ(alpha), qt.dval, 1 , rt.dval, 1, queue );     // r=r+alpha*q
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 3.*dofs, 3.*dofs ), 9*vbytes, queue );
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         res = magma_dznrm2( dofs, r.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( dofs ), vbytes, queue );
 
         if ( solver_par->verbose > 0 ) {
             tempo2 = magma_sync_wtime( queue );
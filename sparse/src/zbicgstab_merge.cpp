@@ -67,6 +67,12 @@ magma_zbicgstab_merge(
     magmaDoubleComplex c_one  = MAGMA_Z_ONE;
     
     magma_int_t dofs = A.num_rows * b.num_cols;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) * b.num_cols
+                        + 2 * vbytes;
 
     // workspace
     magma_z_matrix r={Magma_CSR}, rr={Magma_CSR}, p={Magma_CSR}, v={Magma_CSR}, 
@@ -126,13 +132,16 @@ magma_zbicgstab_merge(
 
     solver_par->numiter = 0;
     solver_par->spmv_count = 0;
+    magma_perf_reset( &solver_par->perf );
     // start iteration
     do
     {
         solver_par->numiter++;
         rho_old = rho_new;                                    // rho_old=rho
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         rho_new = magma_zdotc( dofs, rr.dval, 1, r.dval, 1, queue );  // rho=<rr,r>
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
         beta = rho_new/rho_old * alpha/omega;   // beta=rho/rho_old *alpha/omega
         if( magma_z_isnan_inf( beta ) ){
             info = MAGMA_DIVERGENCE;
@@ -140,6 +149,7 @@ magma_zbicgstab_merge(
         }
         
         // p = r + beta * ( p - omega * v )
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zbicgstab_1(  
         r.num_rows, 
         r.num_cols, 
@@ -149,16 +159,22 @@ magma_zbicgstab_merge(
         v.dval,
         p.dval,
         queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 4*vbytes, queue );
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, p, c_zero, v, queue ));      // v = Ap
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
         //alpha = rho_new / tmpval;
+        tp = magma_perf_tic( &solver_par->perf, queue );
         alpha = rho_new /magma_zdotc( dofs, rr.dval, 1, v.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
         if( magma_z_isnan_inf( alpha ) ){
             info = MAGMA_DIVERGENCE;
             break;
         }
         // s = r - alpha v
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zbicgstab_2(  
         r.num_rows, 
         r.num_cols, 
@@ -167,14 +183,20 @@ magma_zbicgstab_merge(
         v.dval,
         s.dval, 
         queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 3*vbytes, queue );
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, s, c_zero, t, queue ));       // t=As
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         omega = magma_zdotc( dofs, t.dval, 1, s.dval, 1, queue )   // omega = <s,t>/<t,t>
                    / magma_zdotc( dofs, t.dval, 1, t.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 3*vbytes, queue );
                         
         // x = x + alpha * p + omega * s
         // r = s - omega * t
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zbicgstab_3(  
         r.num_rows, 
         r.num_cols, 
@@ -186,8 +208,11 @@ magma_zbicgstab_merge(
         x->dval,
         r.dval,
         queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 3.*dofs, 3.*dofs ), 7*vbytes, queue );
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         res = betanom = magma_dznrm2( dofs, r.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( dofs ), vbytes, queue );
 
         //nom = betanom*betanom;
 
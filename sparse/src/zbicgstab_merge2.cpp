@@ -74,6 +74,12 @@ magma_zbicgstab_merge2(
     magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
     
     magma_int_t dofs = A.num_rows;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) * b.num_cols
+                        + 2 * vbytes;
 
 
     // workspace
@@ -150,20 +156,31 @@ magma_zbicgstab_merge2(
 
     solver_par->numiter = 0;
     solver_par->spmv_count = 0;
+    magma_perf_reset( &solver_par->perf );
     // start iteration
     do
     {
         solver_par->numiter++;
 
         // computes p=r+beta*(p-omega*v)
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_zbicgmerge1( dofs, skp, v.dval, r.dval, p.dval, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 4*vbytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_zbicgmerge_spmv1(  A, d1, d2, q(2), q(0), q(3), skp, queue ));
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz + dofs, A.nnz + dofs ), spmv_bytes + vbytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_zbicgmerge2( dofs, skp, r.dval, v.dval, s.dval, queue )); // s=r-alpha*v
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 3*vbytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_zbicgmerge_spmv2( A, d1, d2, q(4), q(5), skp, queue ));
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz + 2.*dofs, A.nnz + 2.*dofs ), spmv_bytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_zbicgmerge_xrbeta( dofs, d1, d2, q(0), q(1), q(2),
                                                     q(4), q(5), x->dval, skp, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 5.*dofs, 5.*dofs ), 10*vbytes, queue );
 
         // check stopping criterion (asynchronous copy)
         magma_zgetvector( 1 , skp+5, 1, skp_h+5, 1, queue );
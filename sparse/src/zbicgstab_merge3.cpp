@@ -73,6 +73,12 @@ magma_zbicgstab_merge3(
     magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
     
     magma_int_t dofs = A.num_rows;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) * b.num_cols
+                        + 2 * vbytes;
 
     // workspace
     magma_z_matrix q={Magma_CSR}, r={Magma_CSR}, rr={Magma_CSR}, p={Magma_CSR}, v={Magma_CSR}, s={Magma_CSR}, t={Magma_CSR};
@@ -147,27 +153,42 @@ magma_zbicgstab_merge3(
 
     solver_par->numiter = 0;
     solver_par->spmv_count = 0;
+    magma_perf_reset( &solver_par->perf );
     // start iteration
     do
     {
         solver_par->numiter++;
 
         // computes p=r+beta*(p-omega*v)
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_zbicgmerge1( dofs, skp, v.dval, r.dval, p.dval, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 4*vbytes, queue );
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, p, c_zero, v, queue ));         // v = Ap
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_zmdotc( dofs, 1, q.dval, v.dval, d1, d2, skp, queue ));
         CHECK( magma_zbicgmerge4(  1, skp, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_zbicgmerge2( dofs, skp, r.dval, v.dval, s.dval, queue )); // s=r-alpha*v
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 3*vbytes, queue );
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, s, c_zero, t, queue ));         // t=As
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_zmdotc( dofs, 2, q.dval+4*dofs, t.dval, d1, d2, skp+6, queue ));
         CHECK( magma_zbicgmerge4(  2, skp, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 3*vbytes, queue );
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_zbicgmerge_xrbeta( dofs, d1, d2, q.dval, r.dval, p.dval,
                                                     s.dval, t.dval, x->dval, skp, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 5.*dofs, 5.*dofs ), 10*vbytes, queue );
 
         // check stopping criterion
         magma_zgetvector_async( 1 , skp+5, 1, skp_h+5, 1, queue );
@@ -95,6 +95,12 @@ magma_zbombard(
     magmaDoubleComplex B_alpha, B_beta, B_omega, B_rho_old, B_rho_new;
     
     magma_int_t dofs = A.num_rows* b.num_cols;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) * b.num_cols
+                        + 2 * vbytes;
 
     // need to transpose the matrix
     
@@ -270,6 +276,9 @@ magma_zbombard(
     
     solver_par->numiter = 0;
     solver_par->spmv_count = 0;
+    // the four solvers share one queue and their vector updates are
+    // interleaved, so only the SpMVs are timed
+    magma_perf_reset( &solver_par->perf );
     // start iteration
     do
     {
@@ -385,6 +394,7 @@ magma_zbombard(
         queue );
         
         //QMR
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, Q_p, c_zero, Q_pt, queue ));
         //TFQMR
         CHECK( magma_z_spmv( c_one, A, T_pu_m, c_zero, T_Au_new, queue ));
@@ -392,6 +402,7 @@ magma_zbombard(
         CHECK( magma_z_spmv( c_one, A, C_p, c_zero, C_v_hat, queue ));
         // BiCGSTAB
         CHECK( magma_z_spmv( c_one, A, B_p, c_zero, B_v, queue ));      // v = Ap
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( 4*A.nnz*b.num_cols, 4*A.nnz*b.num_cols ), 4 * spmv_bytes, queue );
         
         solver_par->spmv_count++;
         
@@ -494,6 +505,7 @@ magma_zbombard(
         Q_rho = magma_zsqrt( magma_zdotc( dofs, Q_y.dval, 1, Q_y.dval, 1, queue ) );
         
             //QMR wt = A' * q - beta' * w;
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, AT, Q_q, c_zero, Q_wt, queue ));
         //TFQMR
         CHECK( magma_z_spmv( c_one, A, T_pu_m, c_zero, T_Au_new, queue ));
@@ -501,6 +513,7 @@ magma_zbombard(
         CHECK( magma_z_spmv( c_one, A, C_t, c_zero, C_rt, queue )); 
             //BiCGSTAB
         CHECK( magma_z_spmv( c_one, A, B_s, c_zero, B_t, queue ));       // t=As
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( 4*A.nnz*b.num_cols, 4*A.nnz*b.num_cols ), 4 * spmv_bytes, queue );
         
         solver_par->spmv_count++;
         
@@ -95,6 +95,12 @@ magma_zbombard_merge(
     magmaDoubleComplex B_alpha, B_beta, B_omega, B_rho_old, B_rho_new;
     
     magma_int_t dofs = A.num_rows* b.num_cols;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) * b.num_cols
+                        + 2 * vbytes;
 
     // need to transpose the matrix
     
@@ -296,6 +302,9 @@ magma_zbombard_merge(
     
     solver_par->numiter = 0;
     solver_par->spmv_count = 0;
+    // the four solvers share one queue and their vector updates are
+    // interleaved, so only the SpMVs are timed
+    magma_perf_reset( &solver_par->perf );
     // start iteration
     do
     {
@@ -412,7 +421,9 @@ magma_zbombard_merge(
 
         
         // block SpMV
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, SpMV_in_1, c_zero, SpMV_out_1, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( 4*A.nnz*b.num_cols, 4*A.nnz*b.num_cols ), 4 * spmv_bytes, queue );
         // QMR
         //CHECK( magma_z_spmv( c_one, A, Q_p, c_zero, Q_pt, queue ));
         //TFQMR
@@ -523,11 +534,13 @@ magma_zbombard_merge(
         Q_rho = magma_zsqrt( magma_zdotc( dofs, Q_y.dval, 1, Q_y.dval, 1, queue ) );
 
         //   // block SpMV
+           tp = magma_perf_tic( &solver_par->perf, queue );
            CHECK( magma_z_spmv( c_one, A, SpMV_in_2, c_zero, SpMV_out_2, queue ));
                 // individual SpMV as QMR needs transpose
             CHECK( magma_z_spmv( c_one, AT, Q_q, c_zero, Q_wt, queue ));
                 //TFQMR
             CHECK( magma_z_spmv( c_one, A, T_pu_m, c_zero, T_Au_new, queue ));
+           magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( 4*A.nnz*b.num_cols, 4*A.nnz*b.num_cols ), 4 * spmv_bytes, queue );
 
         solver_par->spmv_count++;
         
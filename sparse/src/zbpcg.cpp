@@ -83,6 +83,12 @@ magma_zbpcg(
     magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
     
     magma_int_t dofs = A.num_rows;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) * num_vecs
+                        + 2 * vbytes * num_vecs;
 
     // GPU workspace
     magma_z_matrix r={Magma_CSR}, rt={Magma_CSR}, p={Magma_CSR}, q={Magma_CSR}, h={Magma_CSR};
@@ -170,45 +176,62 @@ magma_zbpcg(
     
     solver_par->numiter = 0;
     solver_par->spmv_count = 0;
+    magma_perf_reset( &solver_par->perf );
     // start iteration
     do
     {
         solver_par->numiter++;
         // preconditioner
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, r, &rt, precond_par, queue ));
         CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, rt, &h, precond_par, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0, 2*vbytes*num_vecs, queue );
 
-
+        tp = magma_perf_tic( &solver_par->perf, queue );
         for( i=0; i<num_vecs; i++)
             gammanew[i] = MAGMA_Z_REAL( magma_zdotc( dofs, r(i), 1, h(i), 1, queue ) );  // gn = < r,h>
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs*num_vecs, dofs*num_vecs ), 2*vbytes*num_vecs, queue );
 
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         if ( solver_par->numiter==1 ) {
             magma_zcopy( dofs*num_vecs, h.dval, 1, p.dval, 1, queue );                    // p = h
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, 0, 2*vbytes*num_vecs, queue );
         } else {
             for( i=0; i<num_vecs; i++) {
                 beta[i] = MAGMA_Z_MAKE(gammanew[i]/gammaold[i], 0.);       // beta = gn/go
                 magma_zscal( dofs, beta[i], p(i), 1, queue );            // p = beta*p
                 magma_zaxpy( dofs, c_one, h(i), 1, p(i), 1, queue ); // p = p + h
             }
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs*num_vecs, dofs*num_vecs ), 5*vbytes*num_vecs, queue );
         }
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, p, c_zero, q, queue ));   // q = A p
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*num_vecs, A.nnz*num_vecs ), spmv_bytes, queue );
      //   magma_z_bspmv_tuned( dofs, num_vecs, c_one, A, p.dval, c_zero, q.dval, queue );
 
 
-        for( i=0; i<num_vecs; i++) {
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        for( i=0; i<num_vecs; i++)
             den[i] = MAGMA_Z_REAL(magma_zdotc( dofs, p(i), 1, q(i), 1, queue) );
                 // den = p dot q
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs*num_vecs, dofs*num_vecs ), 2*vbytes*num_vecs, queue );
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        for( i=0; i<num_vecs; i++) {
             alpha[i] = MAGMA_Z_MAKE(gammanew[i]/den[i], 0.);
             magma_zaxpy( dofs,  alpha[i], p(i), 1, x->dval+dofs*i, 1, queue ); // x = x + alpha p
             magma_zaxpy( dofs, -alpha[i], q(i), 1, r(i), 1, queue );      // r = r - alpha q
             gammaold[i] = gammanew[i];
+        }
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs*num_vecs, 2.*dofs*num_vecs ), 6*vbytes*num_vecs, queue );
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        for( i=0; i<num_vecs; i++)
             res[i] = magma_dznrm2( dofs, r(i), 1, queue );
-        }
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( dofs*num_vecs ), vbytes*num_vecs, queue );
 
         if ( solver_par->verbose > 0 ) {
             tempo2 = magma_sync_wtime( queue );
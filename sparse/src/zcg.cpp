@@ -67,6 +67,12 @@ magma_zcg(
     magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
     
     magma_int_t dofs = A.num_rows * b.num_cols;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) * b.num_cols
+                        + 2 * vbytes;
 
     // GPU workspace
     magma_z_matrix r={Magma_CSR}, p={Magma_CSR}, q={Magma_CSR};
@@ -117,14 +123,20 @@ magma_zcg(
     
     solver_par->numiter = 0;
     solver_par->spmv_count = 0;
+    magma_perf_reset( &solver_par->perf );
     // start iteration
     do
     {
         solver_par->numiter++;
+        tp = magma_perf_tic( &solver_par->perf, queue );
         alpha = MAGMA_Z_MAKE(nom/den, 0.);
         magma_zaxpy( dofs,  alpha, p.dval, 1, x->dval, 1, queue );     // x = x + alpha p
         magma_zaxpy( dofs, -alpha, q.dval, 1, r.dval, 1, queue );      // r = r - alpha q
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 6*vbytes, queue );
+
+        tp = magma_perf_tic( &solver_par->perf, queue );
         betanom = magma_dznrm2( dofs, r.dval, 1, queue );             // betanom = || r ||
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( dofs ), vbytes, queue );
         betanomsq = betanom * betanom;                      // betanoms = r' * r
 
         if ( solver_par->verbose > 0 ) {
@@ -141,13 +153,21 @@ magma_zcg(
             break;
         }
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         beta = MAGMA_Z_MAKE(betanomsq/nom, 0.);           // beta = betanoms/nom
         magma_zscal( dofs, beta, p.dval, 1, queue );                // p = beta*p
         magma_zaxpy( dofs, c_one, r.dval, 1, p.dval, 1, queue );     // p = p + r
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, dofs ), 5*vbytes, queue );
+
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, p, c_zero, q, queue ));   // q = A p
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
+
+        tp = magma_perf_tic( &solver_par->perf, queue );
         den = MAGMA_Z_REAL(magma_zdotc( dofs, p.dval, 1, q.dval, 1, queue) );
                 // den = p dot q
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
         nom = betanomsq;
     }
     while ( solver_par->numiter+1 <= solver_par->maxiter );
@@ -71,6 +71,12 @@ magma_zcg_merge(
     // some useful variables
     magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
     magma_int_t dofs = A.num_rows*b.num_cols;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) * b.num_cols
+                        + 2 * vbytes;
 
     magma_z_matrix r={Magma_CSR}, d={Magma_CSR}, z={Magma_CSR}, B={Magma_CSR}, C={Magma_CSR};
     magmaDoubleComplex *d1=NULL, *d2=NULL, *skp=NULL;
@@ -139,16 +145,21 @@ magma_zcg_merge(
 
     solver_par->numiter = 0;
     solver_par->spmv_count = 0;
+    magma_perf_reset( &solver_par->perf );
     // start iteration
     do
     {
         solver_par->numiter++;
 
         // computes SpMV and dot product
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_zcgmerge_spmv1(  A, d1, d2, d.dval, z.dval, skp, queue ));
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols + dofs, A.nnz*b.num_cols + dofs ), spmv_bytes, queue );
         // updates x, r, computes scalars and updates d
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_zcgmerge_xrbeta( dofs, d1, d2, x->dval, r.dval, d.dval, z.dval, skp, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 4.*dofs, 4.*dofs ), 7*vbytes, queue );
 
         // check stopping criterion (asynchronous copy)
         magma_zgetvector( 1 , skp+1, 1, skp_h+1, 1, queue );
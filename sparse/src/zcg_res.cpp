@@ -73,6 +73,12 @@ magma_zcg_res(
     magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
     
     magma_int_t dofs = A.num_rows* b.num_cols;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) * b.num_cols
+                        + 2 * vbytes;
 
     // GPU workspace
     magma_z_matrix r={Magma_CSR}, p={Magma_CSR}, q={Magma_CSR};
@@ -119,14 +125,18 @@ magma_zcg_res(
     
     solver_par->numiter = 0;
     solver_par->spmv_count = 0;
+    magma_perf_reset( &solver_par->perf );
     // start iteration
     do
     {
         solver_par->numiter++;
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         gammanew = magma_zdotc( dofs, r.dval, 1, r.dval, 1, queue );
                                                             // gn = < r,r>
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( dofs ), vbytes, queue );
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         if ( solver_par->numiter == 1 ) {
             magma_zcopy( dofs, r.dval, 1, p.dval, 1, queue );                    // p = r
         } else {
@@ -134,18 +144,28 @@ magma_zcg_res(
             magma_zscal( dofs, beta, p.dval, 1, queue );            // p = beta*p
             magma_zaxpy( dofs, c_one, r.dval, 1, p.dval, 1, queue ); // p = p + r
         }
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, dofs ), 5*vbytes, queue );
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, p, c_zero, q, queue ));   // q = A p
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
+
+        tp = magma_perf_tic( &solver_par->perf, queue );
         den = magma_zdotc( dofs, p.dval, 1, q.dval, 1, queue );
                 // den = p dot q
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         alpha = gammanew / den;
         magma_zaxpy( dofs,  alpha, p.dval, 1, x->dval, 1, queue );     // x = x + alpha p
         magma_zaxpy( dofs, -alpha, q.dval, 1, r.dval, 1, queue );      // r = r - alpha q
         gammaold = gammanew;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 6*vbytes, queue );
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         res = magma_dznrm2( dofs, r.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( dofs ), vbytes, queue );
         if ( solver_par->verbose > 0 ) {
             tempo2 = magma_sync_wtime( queue );
             if ( (solver_par->numiter)%solver_par->verbose == 0 ) {
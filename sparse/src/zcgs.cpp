@@ -75,6 +75,12 @@ magma_zcgs(
     magmaDoubleComplex rho, rho_l = c_one, alpha, beta;
     
     magma_int_t dofs = A.num_rows* b.num_cols;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) * b.num_cols
+                        + 2 * vbytes;
 
     // GPU workspace
     magma_z_matrix r={Magma_CSR}, rt={Magma_CSR}, r_tld={Magma_CSR},
@@ -123,18 +129,22 @@ magma_zcgs(
     
     solver_par->numiter = 0;
     solver_par->spmv_count = 0;
+    magma_perf_reset( &solver_par->perf );
     // start iteration
     do
     {
         solver_par->numiter++;
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         rho = magma_zdotc( dofs, r_tld.dval, 1, r.dval, 1, queue );
                                                             // rho = < r,r_tld>    
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
         if( magma_z_isnan_inf( rho ) ){
             info = MAGMA_DIVERGENCE;
             break;
         }
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         if ( solver_par->numiter > 1 ) {                        // direction vectors
             beta = rho / rho_l;            
             magma_zcopy( dofs, r.dval, 1, u.dval, 1, queue );          // u = r
@@ -150,24 +160,37 @@ magma_zcgs(
             magma_zcopy( dofs, r.dval, 1, u.dval, 1, queue );          // u = r
             magma_zcopy( dofs, r.dval, 1, p.dval, 1, queue );          // p = r
         }
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 4.*dofs, 4.*dofs ), 13*vbytes, queue );
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, p, c_zero, v_hat, queue ));   // v = A p
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         alpha = rho / magma_zdotc( dofs, r_tld.dval, 1, v_hat.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zcopy( dofs, u.dval, 1, q.dval, 1, queue );              // q = u
         magma_zaxpy( dofs,  -alpha, v_hat.dval, 1, q.dval, 1, queue );   // q = u - alpha v_hat
         
         magma_zcopy( dofs, u.dval, 1, t.dval, 1, queue );             // t = q
         magma_zaxpy( dofs,  c_one, q.dval, 1, t.dval, 1, queue );       // t = u + q
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 10*vbytes, queue );
 
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, t, c_zero, rt, queue ));   // t = A u_hat
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zaxpy( dofs,  c_neg_one*alpha, rt.dval, 1, r.dval, 1, queue );       // r = r -alpha*A u_hat
         magma_zaxpy( dofs,  alpha, t.dval, 1, x->dval, 1, queue );      // x = x + alpha u_hat
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 6*vbytes, queue );
         rho_l = rho;
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         res = magma_dznrm2( dofs, r.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( dofs ), vbytes, queue );
         if ( solver_par->verbose > 0 ) {
             tempo2 = magma_sync_wtime( queue );
             if ( (solver_par->numiter)%solver_par->verbose == 0 ) {
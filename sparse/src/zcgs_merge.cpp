@@ -71,6 +71,12 @@ magma_zcgs_merge(
     magmaDoubleComplex rho, rho_l = c_one, alpha, beta;
     
     magma_int_t dofs = A.num_rows* b.num_cols;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) * b.num_cols
+                        + 2 * vbytes;
 
     // GPU workspace
     magma_z_matrix r={Magma_CSR}, rt={Magma_CSR}, r_tld={Magma_CSR},
@@ -119,13 +125,16 @@ magma_zcgs_merge(
     
     solver_par->numiter = 0;
     solver_par->spmv_count = 0;
+    magma_perf_reset( &solver_par->perf );
     // start iteration
     do
     {
         solver_par->numiter++;
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         rho = magma_zdotc( dofs, r_tld.dval, 1, r.dval, 1, queue );
                                                             // rho = < r,r_tld>    
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
         if( magma_z_isnan_inf( rho ) ){
             info = MAGMA_DIVERGENCE;
             break;
@@ -133,6 +142,7 @@ magma_zcgs_merge(
         
         if ( solver_par->numiter > 1 ) {                        // direction vectors
             beta = rho / rho_l;     
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zcgs_1(  
             r.num_rows, 
             r.num_cols, 
@@ -142,10 +152,12 @@ magma_zcgs_merge(
             u.dval,
             p.dval,
             queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 3.*dofs, 3.*dofs ), 6*vbytes, queue );
           //u = r + beta*q;
           //p = u + beta*( q + beta*p );
         }
         else{
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zcgs_2(  
             r.num_rows, 
             r.num_cols, 
@@ -153,14 +165,20 @@ magma_zcgs_merge(
             u.dval,
             p.dval,
             queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, 0, 3*vbytes, queue );
             // u = r
             // p = r
         }
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, p, c_zero, v_hat, queue ));   // v = A p
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         alpha = rho / magma_zdotc( dofs, r_tld.dval, 1, v_hat.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zcgs_3(  
         r.num_rows, 
         r.num_cols, 
@@ -170,11 +188,15 @@ magma_zcgs_merge(
         q.dval,
         t.dval, 
         queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs, 2.*dofs ), 5*vbytes, queue );
         // q = u - alpha v_hat
         // t = u + q
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, t, c_zero, rt, queue ));   // t = A u_hat
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zcgs_4(  
         r.num_rows, 
         r.num_cols, 
@@ -184,11 +206,14 @@ magma_zcgs_merge(
         x->dval, 
         r.dval,
         queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 6*vbytes, queue );
         // r = r -alpha*A u_hat
         // x = x + alpha u_hat
         rho_l = rho;
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         res = magma_dznrm2( dofs, r.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( dofs ), vbytes, queue );
         if ( solver_par->verbose > 0 ) {
             tempo2 = magma_sync_wtime( queue );
             if ( (solver_par->numiter)%solver_par->verbose == 0 ) {
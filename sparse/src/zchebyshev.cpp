@@ -0,0 +1,362 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+
+// number of Lanczos steps for the spectral interval
+#define NLANCZOS 20
+
+
+/**
+    Purpose
+    -------
+
+    Runs degree-1 steps of the Chebyshev iteration for the Jacobi-scaled
+    system D^{-1} A on the interval [precond->emin, precond->emax]
+    and adds the correction to x.
+    On entry, precond->work1 contains the residual b - A x.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                system matrix, assembled or matrix-free
+
+    @param[in]
+    zero_guess  magma_int_t
+                if 1, x is overwritten with the correction
+
+    @param[in,out]
+    x           magma_z_matrix*
+                approximation
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+    ********************************************************************/
+
+static magma_int_t
+magma_zchebyshev_iterate(
+    magma_z_matrix A,
+    magma_int_t zero_guess,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t dofs = A.num_rows;
+    magmaDoubleComplex c_one = MAGMA_Z_ONE, c_neg_one = MAGMA_Z_NEG_ONE;
+
+    // r = work1, d = work2 (update), t = d2 (scaled residual)
+    magma_z_matrix *r = &precond->work1, *d = &precond->work2, *t = &precond->d2;
+
+    double theta = ( precond->emax + precond->emin ) / 2.0;
+    double delta = ( precond->emax - precond->emin ) / 2.0;
+    double sigma = theta / delta;
+    double rho = 1.0 / sigma, rhonew;
+
+    // d = D^{-1} r / theta
+    CHECK( magma_zjacobi_diagscal( dofs, precond->d, *r, d, queue ));
+    magma_zdscal( dofs, 1.0 / theta, d->dval, 1, queue );
+    if ( zero_guess == 1 ) {
+        magma_zcopy( dofs, d->dval, 1, x->dval, 1, queue );
+    } else {
+        magma_zaxpy( dofs, c_one, d->dval, 1, x->dval, 1, queue );
+    }
+
+    for( magma_int_t k=1; k < precond->degree; k++ ) {
+        // r = r - A d
+        CHECK( magma_z_spmv( c_neg_one, A, *d, c_one, *r, queue ));
+        rhonew = 1.0 / ( 2.0 * sigma - rho );
+        // d = rhonew rho d + 2 rhonew / delta D^{-1} r
+        CHECK( magma_zjacobi_diagscal( dofs, precond->d, *r, t, queue ));
+        magma_zdscal( dofs, rhonew * rho, d->dval, 1, queue );
+        magma_zaxpy( dofs, MAGMA_Z_MAKE( 2.0 * rhonew / delta, 0.0 ),
+                     t->dval, 1, d->dval, 1, queue );
+        magma_zaxpy( dofs, c_one, d->dval, 1, x->dval, 1, queue );
+        rho = rhonew;
+    }
+
+cleanup:
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Prepares the Chebyshev polynomial preconditioner
+        M^{-1} = p( D^{-1} A ) D^{-1},
+    where D is the diagonal of A and p is the Chebyshev polynomial of
+    degree precond->degree (--pdegree) for the spectral interval of D^{-1} A.
+    The interval [precond->emin, precond->emax] is estimated from the Ritz
+    values of a few Lanczos steps, taken from the coefficients of a
+    Jacobi-preconditioned CG started with a random vector; the upper bound
+    is enlarged by 10% so that the polynomial stays positive on the spectrum.
+    The preconditioner is Hermitian positive definite for Hermitian
+    positive definite A and can be used with CG.
+
+    The setup and the application need only SpMVs, the diagonal, and vector
+    updates, so A may also be a matrix-free operator (Magma_SPMVFUNCTION).
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                system matrix, on the CPU or the device, or matrix-free
+
+    @param[in]
+    b           magma_z_matrix
+                RHS (not referenced)
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zchebyshevsetup(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
+    magma_int_t dofs = A.num_rows;
+    magma_int_t nlanczos = min( NLANCZOS, dofs );
+    magma_int_t ilanczos = 0, lapack_info = 0;
+    magma_int_t distr = 2, iseed[4] = {0, 0, 0, 1};
+
+    magma_z_matrix hA={Magma_CSR}, hACSR={Magma_CSR}, dA={Magma_CSR}, hv={Magma_CSR};
+    magma_z_matrix r={Magma_CSR}, z={Magma_CSR}, p={Magma_CSR}, q={Magma_CSR};
+    magma_z_matrix *Ap = &A;
+    magmaDoubleComplex alpha, beta, pq, alphaold = c_one, betaold = c_zero;
+    double rho, rho0, rhonew;
+    double *diag=NULL, *offdiag=NULL;
+
+    if ( precond->degree <= 0 ) {
+        precond->degree = 4;
+    }
+
+    // inverse diagonal for the Jacobi scaling
+    CHECK( magma_zjacobisetup_diagscal( A, &precond->d, queue ));
+
+    // the Lanczos steps run on the device
+    if ( A.storage_type != Magma_SPMVFUNCTION && A.memory_location != Magma_DEV ) {
+        CHECK( magma_zmtransfer( A, &hA, A.memory_location, Magma_CPU, queue ));
+        CHECK( magma_zmconvert( hA, &hACSR, hA.storage_type, Magma_CSR, queue ));
+        CHECK( magma_zmtransfer( hACSR, &dA, Magma_CPU, Magma_DEV, queue ));
+        Ap = &dA;
+    }
+
+    CHECK( magma_dmalloc_cpu( &diag, nlanczos ));
+    CHECK( magma_dmalloc_cpu( &offdiag, nlanczos ));
+    CHECK( magma_zvinit( &hv, Magma_CPU, dofs, 1, c_zero, queue ));
+    lapackf77_zlarnv( &distr, iseed, &dofs, hv.val );
+    CHECK( magma_zmtransfer( hv, &r, Magma_CPU, Magma_DEV, queue ));
+    CHECK( magma_zvinit( &z, Magma_DEV, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &p, Magma_DEV, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &q, Magma_DEV, dofs, 1, c_zero, queue ));
+
+    // Jacobi-preconditioned CG, the coefficients give the Lanczos tridiagonal
+    CHECK( magma_zjacobi_diagscal( dofs, precond->d, r, &z, queue ));
+    magma_zcopy( dofs, z.dval, 1, p.dval, 1, queue );
+    rho = rho0 = MAGMA_Z_REAL( magma_zdotc( dofs, r.dval, 1, z.dval, 1, queue ));
+    while( ilanczos < nlanczos && rho > 0.0 ) {
+        CHECK( magma_z_spmv( c_one, *Ap, p, c_zero, q, queue ));
+        pq = magma_zdotc( dofs, p.dval, 1, q.dval, 1, queue );
+        if ( MAGMA_Z_REAL( pq ) <= 0.0 ) {
+            break;
+        }
+        alpha = MAGMA_Z_MAKE( rho, 0.0 ) / pq;
+        magma_zaxpy( dofs, -alpha, q.dval, 1, r.dval, 1, queue );
+        CHECK( magma_zjacobi_diagscal( dofs, precond->d, r, &z, queue ));
+        rhonew = MAGMA_Z_REAL( magma_zdotc( dofs, r.dval, 1, z.dval, 1, queue ));
+        beta = MAGMA_Z_MAKE( rhonew / rho, 0.0 );
+
+        diag[ilanczos] = 1.0 / MAGMA_Z_REAL( alpha );
+        if ( ilanczos > 0 ) {
+            diag[ilanczos] += MAGMA_Z_REAL( betaold ) / MAGMA_Z_REAL( alphaold );
+        }
+        offdiag[ilanczos] = sqrt( MAGMA_Z_ABS( beta ) ) / MAGMA_Z_REAL( alpha );
+        alphaold = alpha;
+        betaold = beta;
+        ilanczos++;
+
+        rho = rhonew;
+        if ( rho <= lapackf77_dlamch( "E" ) * rho0 ) {
+            break;     // Krylov space exhausted
+        }
+        magma_zscal( dofs, beta, p.dval, 1, queue );
+        magma_zaxpy( dofs, c_one, z.dval, 1, p.dval, 1, queue );
+    }
+
+    if ( ilanczos > 0 ) {
+        lapackf77_dsterf( &ilanczos, diag, offdiag, &lapack_info );
+    }
+    if ( ilanczos == 0 || lapack_info != 0 || diag[ilanczos-1] <= 0.0 ) {
+        // bound of the Gershgorin disks for diagonally dominant A
+        printf( "%% warning: no spectral estimate for the Chebyshev preconditioner.\n" );
+        printf( "%% Fallback: interval [0.1, 2].\n" );
+        precond->emin = 0.1;
+        precond->emax = 2.0;
+    } else {
+        precond->emax = 1.1 * diag[ilanczos-1];
+        precond->emin = diag[0];
+        if ( precond->emin <= 0.0 || precond->emin >= precond->emax ) {
+            precond->emin = precond->emax / 30.0;
+        }
+    }
+
+    // workspace for the application
+    CHECK( magma_zvinit( &precond->work1, Magma_DEV, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &precond->work2, Magma_DEV, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &precond->d2,    Magma_DEV, dofs, 1, c_zero, queue ));
+    precond->spmv_count = ilanczos;
+
+cleanup:
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &hACSR, queue );
+    magma_zmfree( &dA, queue );
+    magma_zmfree( &hv, queue );
+    magma_zmfree( &r, queue );
+    magma_zmfree( &z, queue );
+    magma_zmfree( &p, queue );
+    magma_zmfree( &q, queue );
+    magma_free_cpu( diag );
+    magma_free_cpu( offdiag );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Applies the Chebyshev polynomial preconditioner:
+        x = p( D^{-1} A ) D^{-1} b,
+    i.e., precond->degree steps of the Chebyshev iteration with zero
+    initial guess. This needs degree-1 SpMVs.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                system matrix, assembled or matrix-free
+
+    @param[in]
+    b           magma_z_matrix
+                input vector b
+
+    @param[in,out]
+    x           magma_z_matrix*
+                output vector x
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zapplychebyshev(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_zcopy( b.num_rows, b.dval, 1, precond->work1.dval, 1, queue );
+    CHECK( magma_zchebyshev_iterate( A, 1, x, precond, queue ));
+
+cleanup:
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Chebyshev smoother: improves the approximation x of A x = b by
+    precond->degree steps of the Chebyshev iteration, starting from x.
+    This needs degree SpMVs.
+
+    For smoothing in a multilevel method, only the upper part of the
+    spectrum should be damped: after magma_zchebyshevsetup, set precond->emin
+    to a fraction of precond->emax, e.g., emax / 30.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                system matrix, assembled or matrix-free
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b
+
+    @param[in,out]
+    x           magma_z_matrix*
+                approximation
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zchebyshevsmooth(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    // work1 = b - A x
+    magma_zcopy( b.num_rows, b.dval, 1, precond->work1.dval, 1, queue );
+    CHECK( magma_z_spmv( MAGMA_Z_NEG_ONE, A, *x, MAGMA_Z_ONE, precond->work1, queue ));
+    CHECK( magma_zchebyshev_iterate( A, 0, x, precond, queue ));
+
+cleanup:
+    return info;
+}
@@ -0,0 +1,461 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+
+#define PRECISION_z
+
+#define RTOLERANCE     lapackf77_dlamch( "E" )
+#define ATOLERANCE     lapackf77_dlamch( "E" )
+
+
+/*******************************************************************************
+    Purpose
+    -------
+
+    Computes the new recycled subspace of the deflated CG from the nz search
+    directions Z and AZ = A Z of the last solve (the first columns hold the
+    previous recycled subspace). The harmonic Ritz vectors of A belonging to
+    the smallest harmonic Ritz values are obtained from the generalized
+    Hermitian eigenproblem
+
+        (AZ)^H AZ y = theta sym( Z^H AZ ) y,
+
+    and U = Z Y, C = AZ Y are stored in recycle.
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                number of rows
+
+    @param[in]
+    nz          magma_int_t
+                number of search directions
+
+    @param[in]
+    dZ          magmaDoubleComplex_ptr
+                search directions, n x nz
+
+    @param[in]
+    dAZ         magmaDoubleComplex_ptr
+                A times the search directions, n x nz
+
+    @param[in,out]
+    recycle     magma_z_recycle*
+                recycled subspace
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zposv
+*******************************************************************************/
+
+static magma_int_t
+magma_zdefcg_harmonic(
+    magma_int_t n,
+    magma_int_t nz,
+    magmaDoubleComplex_ptr dZ,
+    magmaDoubleComplex_ptr dAZ,
+    magma_z_recycle *recycle,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0, lapack_info = 0;
+    magma_int_t itype = 1, knew = min( recycle->k, nz );
+    magma_int_t lwork = 1 + 6*nz + 2*nz*nz, liwork = 3 + 5*nz;
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
+    magmaDoubleComplex *F=NULL, *G=NULL, *work=NULL;
+    magmaDoubleComplex_ptr dF=NULL, dUnew=NULL, dCnew=NULL;
+    double *w=NULL;
+    magma_int_t *iwork=NULL;
+    #if defined(PRECISION_z) || defined(PRECISION_c)
+    magma_int_t lrwork = 1 + 5*nz + 2*nz*nz;
+    double *rwork=NULL;
+    CHECK( magma_dmalloc_cpu( &rwork, lrwork ));
+    #endif
+
+    CHECK( magma_zmalloc_cpu( &F, nz*nz ));
+    CHECK( magma_zmalloc_cpu( &G, nz*nz ));
+    CHECK( magma_zmalloc_cpu( &work, lwork ));
+    CHECK( magma_dmalloc_cpu( &w, nz ));
+    CHECK( magma_imalloc_cpu( &iwork, liwork ));
+    CHECK( magma_zmalloc( &dF, nz*nz ));
+    CHECK( magma_zmalloc( &dUnew, n*knew ));
+    CHECK( magma_zmalloc( &dCnew, n*knew ));
+
+    // F = AZ^H AZ, G = Z^H AZ
+    magma_zgemm( MagmaConjTrans, MagmaNoTrans, nz, nz, n,
+                 c_one, dAZ, n, dAZ, n, c_zero, dF, nz, queue );
+    magma_zgetmatrix( nz, nz, dF, nz, F, nz, queue );
+    magma_zgemm( MagmaConjTrans, MagmaNoTrans, nz, nz, n,
+                 c_one, dZ, n, dAZ, n, c_zero, dF, nz, queue );
+    magma_zgetmatrix( nz, nz, dF, nz, G, nz, queue );
+    // Z^H A Z is Hermitian in exact arithmetic
+    for( magma_int_t j=0; j < nz; j++ ) {
+        for( magma_int_t i=0; i <= j; i++ ) {
+            G[ i + j*nz ] = MAGMA_Z_MAKE( 0.5, 0.0 ) *
+                            ( G[ i + j*nz ] + MAGMA_Z_CONJ( G[ j + i*nz ] ) );
+        }
+    }
+
+    lapackf77_zhegvd( &itype, "V", "U", &nz, F, &nz, G, &nz, w,
+                      work, &lwork,
+                      #if defined(PRECISION_z) || defined(PRECISION_c)
+                      rwork, &lrwork,
+                      #endif
+                      iwork, &liwork, &lapack_info );
+    if ( lapack_info != 0 ) {
+        // Z^H A Z not positive definite: keep the old subspace
+        goto cleanup;
+    }
+
+    // eigenvalues are in ascending order, F holds the eigenvectors
+    magma_zsetmatrix( nz, knew, F, nz, dF, nz, queue );
+    magma_zgemm( MagmaNoTrans, MagmaNoTrans, n, knew, nz,
+                 c_one, dZ, n, dF, nz, c_zero, dUnew, n, queue );
+    magma_zgemm( MagmaNoTrans, MagmaNoTrans, n, knew, nz,
+                 c_one, dAZ, n, dF, nz, c_zero, dCnew, n, queue );
+    CHECK( magma_zrecycle_store( n, knew, dUnew, n, dCnew, n, recycle, queue ));
+
+cleanup:
+    magma_free_cpu( F );
+    magma_free_cpu( G );
+    magma_free_cpu( work );
+    magma_free_cpu( w );
+    magma_free_cpu( iwork );
+    #if defined(PRECISION_z) || defined(PRECISION_c)
+    magma_free_cpu( rwork );
+    #endif
+    magma_free( dF );
+    magma_free( dUnew );
+    magma_free( dCnew );
+    return info;
+}
+
+
+/*******************************************************************************
+    Purpose
+    -------
+
+    Solves a system of linear equations
+       A * X = B
+    where A is a complex Hermitian N-by-N positive definite matrix A.
+    This is a GPU implementation of the deflated (augmented) preconditioned
+    Conjugate Gradient method for sequences of linear systems.
+
+    The search directions are kept A-orthogonal to the recycled subspace U
+    (C = A U) carried in recycle, and the initial guess is corrected by the
+    Galerkin projection onto U. The first solver_par->restart search
+    directions are stored, and after the solve the recycled subspace is
+    replaced by the recycle->k harmonic Ritz vectors of A belonging to the
+    smallest harmonic Ritz values in span{U, search directions}.
+    If the matrix changes between solves, call magma_zrecycle_update first.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b
+
+    @param[in,out]
+    x           magma_z_matrix*
+                solution approximation
+
+    @param[in,out]
+    recycle     magma_z_recycle*
+                recycled subspace
+
+    @param[in,out]
+    solver_par  magma_z_solver_par*
+                solver parameters
+
+    @param[in]
+    precond_par magma_z_preconditioner*
+                preconditioner
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zposv
+*******************************************************************************/
+
+extern "C" magma_int_t
+magma_zdefcg(
+    magma_z_matrix A, magma_z_matrix b, magma_z_matrix *x,
+    magma_z_recycle *recycle,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue )
+{
+    magma_int_t info = MAGMA_NOTCONVERGED, lapack_info = 0;
+
+    // prepare solver feedback
+    solver_par->solver = Magma_DEFCG;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+
+    // solver variables
+    magmaDoubleComplex alpha, beta;
+    double nom0, r0, res=0.0, nomb, nrmp;
+    magmaDoubleComplex den, gammanew, gammaold = MAGMA_Z_MAKE(1.0,0.0);
+    // local variables
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE, c_mone = MAGMA_Z_NEG_ONE;
+    magma_int_t ione = 1;
+
+    magma_int_t dofs = A.num_rows;
+    magma_int_t kmax = max( 0, recycle->k );
+    magma_int_t ms = max( 0, solver_par->restart );
+    magma_int_t kk, nstored = 0;
+
+    real_Double_t tempo1, tempo2, tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) + 2 * vbytes;
+
+    // GPU workspace
+    magma_z_matrix r={Magma_CSR}, rt={Magma_CSR}, p={Magma_CSR}, q={Magma_CSR}, h={Magma_CSR};
+    magmaDoubleComplex_ptr dZ=NULL, dAZ=NULL, dmu=NULL;
+    magmaDoubleComplex *E=NULL, *mu=NULL;
+
+    if ( recycle->num_vecs > 0 && recycle->ld != dofs ) {
+        magma_zrecycle_free( recycle, queue );
+    }
+    kk = min( recycle->num_vecs, kmax );
+
+    CHECK( magma_zvinit( &r, Magma_DEV, A.num_rows, b.num_cols, c_zero, queue ));
+    CHECK( magma_zvinit( &rt,Magma_DEV, A.num_rows, b.num_cols, c_zero, queue ));
+    CHECK( magma_zvinit( &p, Magma_DEV, A.num_rows, b.num_cols, c_zero, queue ));
+    CHECK( magma_zvinit( &q, Magma_DEV, A.num_rows, b.num_cols, c_zero, queue ));
+    CHECK( magma_zvinit( &h, Magma_DEV, A.num_rows, b.num_cols, c_zero, queue ));
+    if ( kmax > 0 ) {
+        CHECK( magma_zmalloc( &dZ,  dofs*(kmax+ms) ));
+        CHECK( magma_zmalloc( &dAZ, dofs*(kmax+ms) ));
+        CHECK( magma_zmalloc( &dmu, kmax ));
+        CHECK( magma_zmalloc_cpu( &E, kmax*kmax ));
+        CHECK( magma_zmalloc_cpu( &mu, kmax ));
+    }
+
+    // solver setup
+    CHECK(  magma_zresidualvec( A, b, *x, &r, &nom0, queue));
+    solver_par->init_res = nom0;
+
+    if ( kk > 0 ) {
+        // E = U^H C = U^H A U, factored once per solve; dZ is still unused
+        magma_zgemm( MagmaConjTrans, MagmaNoTrans, kk, kk, dofs,
+                     c_one, recycle->dU, dofs, recycle->dC, dofs, c_zero, dZ, kk, queue );
+        magma_zgetmatrix( kk, kk, dZ, kk, E, kk, queue );
+        lapackf77_zpotrf( "U", &kk, E, &kk, &lapack_info );
+        if ( lapack_info != 0 ) {
+            kk = 0;
+        }
+    }
+    if ( kk > 0 ) {
+        // Galerkin projection of the initial guess:
+        // x = x + U E^{-1} U^H r,  r = r - C E^{-1} U^H r
+        magma_zgemv( MagmaConjTrans, dofs, kk, c_one, recycle->dU, dofs,
+                     r.dval, 1, c_zero, dmu, 1, queue );
+        magma_zgetvector( kk, dmu, 1, mu, 1, queue );
+        lapackf77_zpotrs( "U", &kk, &ione, E, &kk, mu, &kk, &lapack_info );
+        magma_zsetvector( kk, mu, 1, dmu, 1, queue );
+        magma_zgemv( MagmaNoTrans, dofs, kk, c_one, recycle->dU, dofs,
+                     dmu, 1, c_one, x->dval, 1, queue );
+        magma_zgemv( MagmaNoTrans, dofs, kk, c_mone, recycle->dC, dofs,
+                     dmu, 1, c_one, r.dval, 1, queue );
+        // the recycled subspace leads the stored search directions
+        magmablas_zlacpy( MagmaFull, dofs, kk, recycle->dU, dofs, dZ, dofs, queue );
+        magmablas_zlacpy( MagmaFull, dofs, kk, recycle->dC, dofs, dAZ, dofs, queue );
+    }
+    res = magma_dznrm2( dofs, r.dval, 1, queue );
+
+    nomb = magma_dznrm2( dofs, b.dval, 1, queue );
+    if ( nomb == 0.0 ){
+        nomb=1.0;
+    }
+    if ( (r0 = nomb * solver_par->rtol) < ATOLERANCE ){
+        r0 = ATOLERANCE;
+    }
+    solver_par->final_res = solver_par->init_res;
+    solver_par->iter_res = solver_par->init_res;
+    if ( solver_par->verbose > 0 ) {
+        solver_par->res_vec[0] = (real_Double_t)nom0;
+        solver_par->timing[0] = 0.0;
+    }
+    if ( nom0 < r0 || res < r0 ) {
+        info = MAGMA_SUCCESS;
+        solver_par->iter_res = res;
+        solver_par->final_res = res;
+        goto cleanup;
+    }
+
+    //Chronometry
+    tempo1 = magma_sync_wtime( queue );
+
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+    magma_perf_reset( &solver_par->perf );
+    // start iteration
+    do
+    {
+        solver_par->numiter++;
+
+        // preconditioner
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, r, &rt, precond_par, queue ));
+        CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, rt, &h, precond_par, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0, 2*vbytes, queue );
+
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        gammanew = magma_zdotc( dofs, r.dval, 1, h.dval, 1, queue );
+                                                            // gn = < r,h>
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
+
+        if ( solver_par->numiter == 1 ) {
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            magma_zcopy( dofs, h.dval, 1, p.dval, 1, queue );                    // p = h
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, 0, 2*vbytes, queue );
+        } else {
+            beta = (gammanew/gammaold);       // beta = gn/go
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            magma_zscal( dofs, beta, p.dval, 1, queue );            // p = beta*p
+            magma_zaxpy( dofs, c_one, h.dval, 1, p.dval, 1, queue ); // p = p + h
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, dofs ), 5*vbytes, queue );
+        }
+        if ( kk > 0 ) {
+            // p = p - U E^{-1} C^H h, keeps p A-orthogonal to U
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            magma_zgemv( MagmaConjTrans, dofs, kk, c_one, recycle->dC, dofs,
+                         h.dval, 1, c_zero, dmu, 1, queue );
+            magma_zgetvector( kk, dmu, 1, mu, 1, queue );
+            lapackf77_zpotrs( "U", &kk, &ione, E, &kk, mu, &kk, &lapack_info );
+            magma_zsetvector( kk, mu, 1, dmu, 1, queue );
+            magma_zgemv( MagmaNoTrans, dofs, kk, c_mone, recycle->dU, dofs,
+                         dmu, 1, c_one, p.dval, 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_ORTHO, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs*kk, 2.*dofs*kk ), 2*vbytes*(kk+1), queue );
+        }
+
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        CHECK( magma_z_spmv( c_one, A, p, c_zero, q, queue ));   // q = A p
+        solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz, A.nnz ), spmv_bytes, queue );
+
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        den = magma_zdotc( dofs, p.dval, 1, q.dval, 1, queue );
+                // den = p dot q
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
+        if ( MAGMA_Z_REAL( den ) <= 0.0 ) {
+            info = MAGMA_NONSPD;
+            break;
+        }
+
+        // store the normalized search direction for the subspace update
+        if ( kmax > 0 && nstored < ms ) {
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            nrmp = sqrt( MAGMA_Z_REAL( magma_zdotc( dofs, p.dval, 1, p.dval, 1, queue )));
+            magma_zcopy( dofs, p.dval, 1, dZ  + (kk+nstored)*dofs, 1, queue );
+            magma_zcopy( dofs, q.dval, 1, dAZ + (kk+nstored)*dofs, 1, queue );
+            magma_zscal( dofs, MAGMA_Z_MAKE( 1.0/nrmp, 0.0 ), dZ  + (kk+nstored)*dofs, 1, queue );
+            magma_zscal( dofs, MAGMA_Z_MAKE( 1.0/nrmp, 0.0 ), dAZ + (kk+nstored)*dofs, 1, queue );
+            nstored++;
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 3.*dofs, dofs ), 9*vbytes, queue );
+        }
+
+        alpha = gammanew / den;
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        magma_zaxpy( dofs,  alpha, p.dval, 1, x->dval, 1, queue );     // x = x + alpha p
+        magma_zaxpy( dofs, -alpha, q.dval, 1, r.dval, 1, queue );      // r = r - alpha q
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 6*vbytes, queue );
+        gammaold = gammanew;
+
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        res = magma_dznrm2( dofs, r.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( dofs ), vbytes, queue );
+        if ( solver_par->verbose > 0 ) {
+            tempo2 = magma_sync_wtime( queue );
+            if ( (solver_par->numiter)%solver_par->verbose == 0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) res;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+
+        if ( res/nomb <= solver_par->rtol || res <= solver_par->atol ){
+            break;
+        }
+    }
+    while ( solver_par->numiter+1 <= solver_par->maxiter );
+
+    // new recycled subspace from span{U, search directions}
+    if ( kmax > 0 && kk + nstored > 0 ) {
+        CHECK( magma_zdefcg_harmonic( dofs, kk + nstored, dZ, dAZ, recycle, queue ));
+    }
+
+    tempo2 = magma_sync_wtime( queue );
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    double residual;
+    CHECK(  magma_zresidualvec( A, b, *x, &r, &residual, queue));
+    solver_par->iter_res = res;
+    solver_par->final_res = residual;
+
+    if ( info == MAGMA_NONSPD ) {
+        // keep MAGMA_NONSPD
+    } else if ( solver_par->numiter < solver_par->maxiter ) {
+        info = MAGMA_SUCCESS;
+    } else if ( solver_par->init_res > solver_par->final_res ) {
+        if ( solver_par->verbose > 0 ) {
+            if ( (solver_par->numiter)%solver_par->verbose == 0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) res;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        info = MAGMA_SLOW_CONVERGENCE;
+        if( solver_par->iter_res < solver_par->rtol*nomb ||
+            solver_par->iter_res < solver_par->atol ) {
+            info = MAGMA_SUCCESS;
+        }
+    }
+    else {
+        if ( solver_par->verbose > 0 ) {
+            if ( (solver_par->numiter)%solver_par->verbose == 0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) res;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        info = MAGMA_DIVERGENCE;
+    }
+
+cleanup:
+    magma_zmfree(&r, queue );
+    magma_zmfree(&rt, queue );
+    magma_zmfree(&p, queue );
+    magma_zmfree(&q, queue );
+    magma_zmfree(&h, queue );
+    magma_free( dZ );
+    magma_free( dAZ );
+    magma_free( dmu );
+    magma_free_cpu( E );
+    magma_free_cpu( mu );
+
+    solver_par->info = info;
+    return info;
+}   /* magma_zdefcg */
@@ -158,6 +158,11 @@ magma_zfgmres(
     
     magmaDoubleComplex *H={0}, *s={0}, *cs={0}, *sn={0};
 
+    // estimated traffic per call for the performance counters
+    real_Double_t tp;
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) + 2 * vbytes;
+
     CHECK( magma_zvinit( &t, Magma_DEV, dofs, 1, MAGMA_Z_ZERO, queue ));
     CHECK( magma_zvinit( &t2, Magma_DEV, dofs, 1, MAGMA_Z_ZERO, queue ));
     
@@ -181,16 +186,18 @@ magma_zfgmres(
     
     solver_par->numiter = 0;
     solver_par->spmv_count = 0;
-    
+    magma_perf_reset( &solver_par->perf );
 
     tempo1 = magma_sync_wtime( queue );
     do
     {
         // compute initial residual and its norm
         // A.mult(n, 1, x, n, V(0), n);                        // V(0) = A*x
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( MAGMA_Z_ONE, A, *x, MAGMA_Z_ZERO, t, queue ));
         solver_par->numiter++;
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz, A.nnz ), spmv_bytes, queue );
         magma_zcopy( dofs, t.dval, 1, V(0), 1, queue );
         
         temp = MAGMA_Z_MAKE(-1.0, 0.0);
@@ -241,17 +248,22 @@ magma_zfgmres(
             
             // M.apply(n, 1, V(i), n, W(i), n);
             v_t.dval = V(i);
+            tp = magma_perf_tic( &solver_par->perf, queue );
             CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, v_t, &t, precond_par, queue ));
             CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, t, &t2, precond_par, queue ));
             magma_zcopy( dofs, t2.dval, 1, W(i), 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0.0, 4*vbytes, queue );
 
             // A.mult(n, 1, W(i), n, V(i+1), n);
             w_t.dval = W(i);
+            tp = magma_perf_tic( &solver_par->perf, queue );
             CHECK( magma_z_spmv( MAGMA_Z_ONE, A, w_t, MAGMA_Z_ZERO, t, queue ));
             solver_par->numiter++;
             solver_par->spmv_count++;
             magma_zcopy( dofs, t.dval, 1, V(i+1), 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz, A.nnz ), spmv_bytes + 2*vbytes, queue );
             
+            tp = magma_perf_tic( &solver_par->perf, queue );
             for (k = 0; k <= i; k++)
             {
                 H(k, i) = magma_zdotc( dofs, V(k), 1, V(i+1), 1, queue );
@@ -264,6 +276,10 @@ magma_zfgmres(
             temp = 1.0 / H(i+1, i);
             // V(i+1) = V(i+1) / H(i+1, i)
             magma_zscal( dofs, temp, V(i+1), 1, queue );    //  (to be fused)
+            magma_perf_toc( &solver_par->perf, Magma_PERF_ORTHO, tp,
+                            MAGMA_Z_PERF_FLOPS( 2.*dofs*(i+1) + dofs, 2.*dofs*(i+1) )
+                            + MAGMA_Z_PERF_FLOPS_NRM2( dofs ),
+                            (5.0*(i+1) + 3.0)*vbytes, queue );
     
             for (k = 0; k < i; k++)
                 ApplyPlaneRotation(&H(k,i), &H(k+1,i), cs[k], sn[k]);
@@ -299,11 +315,14 @@ magma_zfgmres(
         }
 
         // update the solution
+        tp = magma_perf_tic( &solver_par->perf, queue );
         for (j = 0; j <= i; j++)
         {
             // x = x + s[j] * W(j)
             magma_zaxpy( dofs, s[j], W(j), 1, x->dval, 1, queue );
         }
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp,
+                        MAGMA_Z_PERF_FLOPS( dofs*(i+1), dofs*(i+1) ), 3.0*(i+1)*vbytes, queue );
     }
     while (rel_resid > solver_par->rtol
                 && solver_par->numiter+1 <= solver_par->maxiter);
@@ -0,0 +1,549 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "magmasparse_internal.h"
+
+#define PRECISION_z
+
+// simulate 2-D arrays at the cost of some arithmetic
+#define W(i)   (dW + (i)*dofs)
+#define Z(i)   (dZ + (i)*dofs)
+#define G(i,j) (G[(i) + (j)*ldg])
+#define H(i,j) (H[(i) + (j)*ldg])
+
+
+static void
+GeneratePlaneRotation(magmaDoubleComplex dx, magmaDoubleComplex dy, magmaDoubleComplex *cs, magmaDoubleComplex *sn)
+{
+#if defined(PRECISION_s) | defined(PRECISION_d)
+    if (dy == MAGMA_Z_ZERO) {
+        *cs = MAGMA_Z_ONE;
+        *sn = MAGMA_Z_ZERO;
+    } else if (MAGMA_Z_ABS((dy)) > MAGMA_Z_ABS((dx))) {
+        magmaDoubleComplex temp = dx / dy;
+        *sn = MAGMA_Z_ONE / magma_zsqrt( ( MAGMA_Z_ONE + temp*temp));
+        *cs = temp * (*sn);
+    } else {
+        magmaDoubleComplex temp = dy / dx;
+        *cs = MAGMA_Z_ONE / magma_zsqrt( ( MAGMA_Z_ONE + temp*temp ));
+        *sn = temp * (*cs);
+    }
+#else
+    real_Double_t rho = sqrt(MAGMA_Z_REAL(MAGMA_Z_CONJ(dx)*dx + MAGMA_Z_CONJ(dy)*dy));
+    *cs = dx / rho;
+    *sn = dy / rho;
+#endif
+}
+
+static void ApplyPlaneRotation(magmaDoubleComplex *dx, magmaDoubleComplex *dy, magmaDoubleComplex cs, magmaDoubleComplex sn)
+{
+#if defined(PRECISION_s) | defined(PRECISION_d)
+    magmaDoubleComplex temp = (*dx);
+    *dx =  cs * (*dx) + sn * (*dy);
+    *dy = -sn * temp + cs * (*dy);
+#else
+    magmaDoubleComplex temp  =  MAGMA_Z_CONJ(cs) * (*dx) +  MAGMA_Z_CONJ(sn) * (*dy);
+    *dy = -(sn) * (*dx) + cs * (*dy);
+    *dx = temp;
+#endif
+}
+
+
+/*
+    Harmonic Ritz update of the recycled subspace after a cycle with
+    A Z(0:mm) = W(0:mm+1) G, W orthonormal:
+    solve G^H G p = theta G^H (W^H Z) p for the kmax harmonic Ritz values
+    of smallest magnitude, as ( G^H G )^{-1} G^H (W^H Z) p = (1/theta) p,
+    then with G P = Q R: C = W Q and U = Z P R^{-1}.
+    The subspace is left unchanged if the small problems fail.
+*/
+static magma_int_t
+magma_zgcrodr_harmonic(
+    magma_int_t dofs,
+    magma_int_t mm,
+    magma_int_t kmax,
+    magmaDoubleComplex *G, magma_int_t ldg,
+    magmaDoubleComplex_ptr dW,
+    magmaDoubleComplex_ptr dZ,
+    magmaDoubleComplex_ptr dtmp,
+    magmaDoubleComplex_ptr dUnew,
+    magmaDoubleComplex_ptr dCnew,
+    magma_z_recycle *recycle,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0, lapack_info = 0;
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
+    magma_int_t mm1 = mm+1, ione = 1, knew = 0;
+    magma_int_t lwork = 64*ldg;
+    magmaDoubleComplex *GG=NULL, *WZ=NULL, *B=NULL, *P=NULL, *Pk=NULL, *GP=NULL,
+                       *tau=NULL, *work=NULL, *R=NULL;
+    magmaDoubleComplex *w=NULL;
+    double *wr=NULL, *wi=NULL, *rwork=NULL, *absmu=NULL;
+    magma_int_t *used=NULL;
+
+    CHECK( magma_zmalloc_cpu( &GG,   mm*mm ));
+    CHECK( magma_zmalloc_cpu( &WZ,   mm1*mm ));
+    CHECK( magma_zmalloc_cpu( &B,    mm*mm ));
+    CHECK( magma_zmalloc_cpu( &P,    mm*mm ));
+    CHECK( magma_zmalloc_cpu( &Pk,   mm*kmax ));
+    CHECK( magma_zmalloc_cpu( &GP,   mm1*kmax ));
+    CHECK( magma_zmalloc_cpu( &R,    kmax*kmax ));
+    CHECK( magma_zmalloc_cpu( &tau,  kmax ));
+    CHECK( magma_zmalloc_cpu( &work, lwork ));
+    CHECK( magma_zmalloc_cpu( &w,    mm ));
+    CHECK( magma_dmalloc_cpu( &wr,   mm ));
+    CHECK( magma_dmalloc_cpu( &wi,   mm ));
+    CHECK( magma_dmalloc_cpu( &rwork, 2*mm ));
+    CHECK( magma_dmalloc_cpu( &absmu, mm ));
+    CHECK( magma_imalloc_cpu( &used, mm ));
+
+    // G^H G and G^H (W^H Z)
+    blasf77_zgemm( "C", "N", &mm, &mm, &mm1, &c_one, G, &ldg, G, &ldg, &c_zero, GG, &mm );
+    magma_zgemm( MagmaConjTrans, MagmaNoTrans, mm1, mm, dofs,
+                 c_one, dW, dofs, dZ, dofs, c_zero, dtmp, mm1, queue );
+    magma_zgetmatrix( mm1, mm, dtmp, mm1, WZ, mm1, queue );
+    blasf77_zgemm( "C", "N", &mm, &mm, &mm1, &c_one, G, &ldg, WZ, &mm1, &c_zero, B, &mm );
+
+    lapackf77_zpotrf( "U", &mm, GG, &mm, &lapack_info );
+    if ( lapack_info != 0 ) {
+        goto cleanup;
+    }
+    lapackf77_zpotrs( "U", &mm, &mm, GG, &mm, B, &mm, &lapack_info );
+
+    #if defined(PRECISION_z) || defined(PRECISION_c)
+    lapackf77_zgeev( "N", "V", &mm, B, &mm, w, NULL, &ione, P, &mm,
+                     work, &lwork, rwork, &lapack_info );
+    for( magma_int_t i=0; i < mm; i++ ) {
+        absmu[i] = MAGMA_Z_ABS( w[i] );
+    }
+    #else
+    lapackf77_zgeev( "N", "V", &mm, B, &mm, wr, wi, NULL, &ione, P, &mm,
+                     work, &lwork, &lapack_info );
+    for( magma_int_t i=0; i < mm; i++ ) {
+        absmu[i] = sqrt( wr[i]*wr[i] + wi[i]*wi[i] );
+    }
+    #endif
+    if ( lapack_info != 0 ) {
+        goto cleanup;
+    }
+
+    // eigenvectors of the kmax largest |1/theta|; in real arithmetic,
+    // a complex pair contributes its real and imaginary part
+    for( magma_int_t i=0; i < mm; i++ ) {
+        used[i] = 0;
+    }
+    while( knew < kmax ) {
+        magma_int_t best = -1;
+        for( magma_int_t i=0; i < mm; i++ ) {
+            if ( ! used[i] && ( best < 0 || absmu[i] > absmu[best] )) {
+                best = i;
+            }
+        }
+        if ( best < 0 ) {
+            break;
+        }
+        #if defined(PRECISION_s) || defined(PRECISION_d)
+        if ( wi[best] != 0.0 ) {
+            magma_int_t re = ( wi[best] > 0.0 ) ? best : best-1;
+            used[re] = used[re+1] = 1;
+            blasf77_zcopy( &mm, &P[re*mm], &ione, &Pk[knew*mm], &ione );
+            knew++;
+            if ( knew < kmax ) {
+                blasf77_zcopy( &mm, &P[(re+1)*mm], &ione, &Pk[knew*mm], &ione );
+                knew++;
+            }
+            continue;
+        }
+        #endif
+        used[best] = 1;
+        blasf77_zcopy( &mm, &P[best*mm], &ione, &Pk[knew*mm], &ione );
+        knew++;
+    }
+
+    // G P = Q R
+    blasf77_zgemm( "N", "N", &mm1, &knew, &mm, &c_one, G, &ldg, Pk, &mm, &c_zero, GP, &mm1 );
+    lapackf77_zgeqrf( &mm1, &knew, GP, &mm1, tau, work, &lwork, &lapack_info );
+    for( magma_int_t j=0; j < knew; j++ ) {
+        for( magma_int_t i=0; i < knew; i++ ) {
+            R[ i + j*knew ] = ( i <= j ) ? GP[ i + j*mm1 ] : c_zero;
+        }
+    }
+    lapackf77_zungqr( &mm1, &knew, &knew, GP, &mm1, tau, work, &lwork, &lapack_info );
+    blasf77_ztrsm( "R", "U", "N", "N", &mm, &knew, &c_one, R, &knew, Pk, &mm );
+
+    // C = W Q, U = Z P R^{-1}
+    magma_zsetmatrix( mm1, knew, GP, mm1, dtmp, mm1, queue );
+    magma_zgemm( MagmaNoTrans, MagmaNoTrans, dofs, knew, mm1,
+                 c_one, dW, dofs, dtmp, mm1, c_zero, dCnew, dofs, queue );
+    magma_zsetmatrix( mm, knew, Pk, mm, dtmp, mm, queue );
+    magma_zgemm( MagmaNoTrans, MagmaNoTrans, dofs, knew, mm,
+                 c_one, dZ, dofs, dtmp, mm, c_zero, dUnew, dofs, queue );
+    CHECK( magma_zrecycle_store( dofs, knew, dUnew, dofs, dCnew, dofs, recycle, queue ));
+
+cleanup:
+    magma_free_cpu( GG );
+    magma_free_cpu( WZ );
+    magma_free_cpu( B );
+    magma_free_cpu( P );
+    magma_free_cpu( Pk );
+    magma_free_cpu( GP );
+    magma_free_cpu( R );
+    magma_free_cpu( tau );
+    magma_free_cpu( work );
+    magma_free_cpu( w );
+    magma_free_cpu( wr );
+    magma_free_cpu( wi );
+    magma_free_cpu( rwork );
+    magma_free_cpu( absmu );
+    magma_free_cpu( used );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Solves a system of linear equations
+       A * X = B
+    where A is a complex sparse matrix stored in the GPU memory.
+    X and B are complex vectors stored on the GPU memory.
+    This is a GPU implementation of the flexible, right-preconditioned
+    GCRO-DR(m, k) method (Parks, de Sturler et al.) for sequences of
+    linear systems.
+
+    The recycled subspace U with A U = C, C^H C = I, is carried between
+    solves in recycle. Each solve first projects the residual onto C^perp;
+    each cycle then runs m-k Arnoldi steps for (I - C C^H) A M^{-1}
+    and minimizes the residual over span(U, M^{-1} V). After each cycle,
+    the k harmonic Ritz vectors of smallest magnitude of the cycle's
+    subspace replace U. The first cycle without a recycled subspace is
+    a GMRES(m) cycle.
+    If the matrix changes between solves, call magma_zrecycle_update first.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                descriptor for matrix A
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b vector
+
+    @param[in,out]
+    x           magma_z_matrix*
+                solution approximation
+
+    @param[in,out]
+    recycle     magma_z_recycle*
+                recycled subspace, see magma_zrecycle_init;
+                recycle->k is limited to restart-1
+
+    @param[in,out]
+    solver_par  magma_z_solver_par*
+                solver parameters
+
+    @param[in]
+    precond_par magma_z_preconditioner*
+                preconditioner
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgesv
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zgcrodr(
+    magma_z_matrix A, magma_z_matrix b, magma_z_matrix *x,
+    magma_z_recycle *recycle,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue )
+{
+    magma_int_t info = MAGMA_NOTCONVERGED;
+
+    magma_int_t dofs = A.num_rows;
+
+    // prepare solver feedback
+    solver_par->solver = Magma_GCRODR;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+
+    //Chronometry
+    real_Double_t tempo1, tempo2, tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) + 2 * vbytes;
+
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
+    magma_int_t m = max( 2, solver_par->restart );
+    magma_int_t ldg = m+1;
+    magma_int_t kmax = min( recycle->k, m-1 );
+    magma_int_t kk = 0, mm = 0, i, j, l;
+    double betanom = 0.0, nom0, nomb, h;
+
+    magma_z_matrix r={Magma_CSR}, t={Magma_CSR}, t2={Magma_CSR};
+    magma_z_matrix v_t={Magma_CSR}, z_t={Magma_CSR}, w_t={Magma_CSR};
+    magmaDoubleComplex_ptr dW=NULL, dZ=NULL, dy=NULL, dtmp=NULL, dUnew=NULL, dCnew=NULL;
+    magmaDoubleComplex *G=NULL, *H=NULL, *s=NULL, *cs=NULL, *sn=NULL, *y=NULL;
+
+    v_t.memory_location = Magma_DEV;
+    v_t.num_rows = dofs;
+    v_t.num_cols = 1;
+    v_t.dval = NULL;
+    v_t.storage_type = Magma_DENSE;
+    v_t.ownership = MagmaFalse;
+    z_t = v_t;
+    w_t = v_t;
+
+    if ( kmax < 0 ) {
+        kmax = 0;
+    }
+    if ( recycle->num_vecs > 0 && recycle->ld != dofs ) {
+        magma_zrecycle_free( recycle, queue );
+    }
+
+    CHECK( magma_zvinit( &r,  Magma_DEV, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &t,  Magma_DEV, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &t2, Magma_DEV, dofs, 1, c_zero, queue ));
+    CHECK( magma_zmalloc( &dW, dofs*(m+1) ));
+    CHECK( magma_zmalloc( &dZ, dofs*m ));
+    CHECK( magma_zmalloc( &dy, m+1 ));
+    CHECK( magma_zmalloc( &dtmp, ldg*m ));
+    CHECK( magma_zmalloc( &dUnew, dofs*max( 1, kmax )));
+    CHECK( magma_zmalloc( &dCnew, dofs*max( 1, kmax )));
+    CHECK( magma_zmalloc_cpu( &G, ldg*m ));
+    CHECK( magma_zmalloc_cpu( &H, ldg*m ));
+    CHECK( magma_zmalloc_cpu( &s, m+1 ));
+    CHECK( magma_zmalloc_cpu( &y, m+1 ));
+    CHECK( magma_zmalloc_cpu( &cs, m ));
+    CHECK( magma_zmalloc_cpu( &sn, m ));
+
+    nomb = magma_dznrm2( dofs, b.dval, 1, queue );
+    if ( nomb == 0.0 ) {
+        nomb = 1.0;
+    }
+    CHECK( magma_zresidualvec( A, b, *x, &r, &nom0, queue ));
+    solver_par->spmv_count++;
+    solver_par->init_res = nom0;
+    solver_par->final_res = nom0;
+    solver_par->iter_res = nom0;
+    if ( solver_par->verbose > 0 ) {
+        solver_par->res_vec[0] = (real_Double_t) nom0;
+        solver_par->timing[0] = 0.0;
+    }
+
+    tempo1 = magma_sync_wtime( queue );
+    magma_perf_reset( &solver_par->perf );
+
+    // project onto C^perp: x = x + U C^H r, r = r - C C^H r
+    kk = min( recycle->num_vecs, kmax );
+    if ( kk > 0 ) {
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        magma_zgemv( MagmaConjTrans, dofs, kk, c_one, recycle->dC, dofs,
+                     r.dval, 1, c_zero, dy, 1, queue );
+        magma_zgemv( MagmaNoTrans, dofs, kk, c_one, recycle->dU, dofs,
+                     dy, 1, c_one, x->dval, 1, queue );
+        magma_zgemv( MagmaNoTrans, dofs, kk, MAGMA_Z_NEG_ONE, recycle->dC, dofs,
+                     dy, 1, c_one, r.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_ORTHO, tp, MAGMA_Z_PERF_FLOPS( 3.*dofs*kk, 3.*dofs*kk ), (3.0*kk + 4.0)*vbytes, queue );
+    }
+
+    do
+    {
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        betanom = magma_dznrm2( dofs, r.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( dofs ), vbytes, queue );
+        if ( magma_z_isnan_inf( MAGMA_Z_MAKE( betanom, 0.0 ) ) ) {
+            info = MAGMA_DIVERGENCE;
+            break;
+        }
+        if ( betanom/nomb <= solver_par->rtol || betanom <= solver_par->atol ) {
+            info = MAGMA_SUCCESS;
+            break;
+        }
+
+        for( i=0; i < ldg*m; i++ ) {
+            G[i] = c_zero;
+            H[i] = c_zero;
+        }
+        for( i=0; i < m+1; i++ ) {
+            s[i] = c_zero;
+        }
+
+        // recycled part: W = [ C, V ], Z = [ U D, M^{-1} V ], D scales U to unit columns
+        kk = min( recycle->num_vecs, kmax );
+        if ( kk > 0 ) {
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            magmablas_zlacpy( MagmaFull, dofs, kk, recycle->dC, dofs, dW, dofs, queue );
+            magmablas_zlacpy( MagmaFull, dofs, kk, recycle->dU, dofs, dZ, dofs, queue );
+            for( j=0; j < kk; j++ ) {
+                h = 1.0 / magma_dznrm2( dofs, Z(j), 1, queue );
+                magma_zdscal( dofs, h, Z(j), 1, queue );
+                G(j,j) = MAGMA_Z_MAKE( h, 0.0 );
+                H(j,j) = G(j,j);
+            }
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs*kk, 0 ) + MAGMA_Z_PERF_FLOPS_NRM2( dofs*kk ), 7.0*kk*vbytes, queue );
+        }
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        magma_zcopy( dofs, r.dval, 1, W(kk), 1, queue );
+        magma_zdscal( dofs, 1.0/betanom, W(kk), 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs, 0 ), 4*vbytes, queue );
+        s[kk] = MAGMA_Z_MAKE( betanom, 0.0 );
+
+        mm = kk;
+        for( j=kk; j < m && solver_par->numiter+1 <= solver_par->maxiter; j++ ) {
+            // Z(j) = M^{-1} W(j)
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            v_t.dval = W(j);
+            CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, v_t, &t, precond_par, queue ));
+            CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, t, &t2, precond_par, queue ));
+            magma_zcopy( dofs, t2.dval, 1, Z(j), 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0.0, 4*vbytes, queue );
+
+            // W(j+1) = A Z(j), orthogonalized against C and V
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            z_t.dval = Z(j);
+            w_t.dval = W(j+1);
+            CHECK( magma_z_spmv( c_one, A, z_t, c_zero, w_t, queue ));
+            solver_par->numiter++;
+            solver_par->spmv_count++;
+            magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz, A.nnz ), spmv_bytes, queue );
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            for( i=0; i <= j; i++ ) {
+                G(i,j) = magma_zdotc( dofs, W(i), 1, W(j+1), 1, queue );
+                magma_zaxpy( dofs, -G(i,j), W(i), 1, W(j+1), 1, queue );
+            }
+            h = magma_dznrm2( dofs, W(j+1), 1, queue );
+            G(j+1,j) = MAGMA_Z_MAKE( h, 0.0 );
+            if ( h > 0.0 ) {
+                magma_zdscal( dofs, 1.0/h, W(j+1), 1, queue );
+            }
+            magma_perf_toc( &solver_par->perf, Magma_PERF_ORTHO, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs*(j+1) + dofs, 2.*dofs*(j+1) ) + MAGMA_Z_PERF_FLOPS_NRM2( dofs ), (5.0*(j+1) + 3.0)*vbytes, queue );
+
+            // G is upper Hessenberg: Givens rotations on the Arnoldi part
+            for( i=0; i <= j+1; i++ ) {
+                H(i,j) = G(i,j);
+            }
+            for( i=kk; i < j; i++ ) {
+                ApplyPlaneRotation( &H(i,j), &H(i+1,j), cs[i], sn[i] );
+            }
+            GeneratePlaneRotation( H(j,j), H(j+1,j), &cs[j], &sn[j] );
+            ApplyPlaneRotation( &H(j,j), &H(j+1,j), cs[j], sn[j] );
+            ApplyPlaneRotation( &s[j], &s[j+1], cs[j], sn[j] );
+            mm = j+1;
+
+            betanom = MAGMA_Z_ABS( s[j+1] );
+            if ( solver_par->verbose > 0 ) {
+                tempo2 = magma_sync_wtime( queue );
+                if ( (solver_par->numiter)%solver_par->verbose == 0 ) {
+                    solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                            = (real_Double_t) betanom;
+                    solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                            = (real_Double_t) tempo2-tempo1;
+                }
+            }
+            if ( betanom/nomb <= solver_par->rtol || betanom <= solver_par->atol ) {
+                break;
+            }
+        }
+        if ( mm == kk ) {
+            break;      // maxiter reached
+        }
+
+        // x = x + Z y with the triangular solve H y = s
+        for( j=mm-1; j >= 0; j-- ) {
+            y[j] = s[j];
+            for( l=j+1; l < mm; l++ ) {
+                y[j] -= H(j,l) * y[l];
+            }
+            y[j] = y[j] / H(j,j);
+        }
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        magma_zsetvector( mm, y, 1, dy, 1, queue );
+        magma_zgemv( MagmaNoTrans, dofs, mm, c_one, dZ, dofs, dy, 1, c_one, x->dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs*mm, dofs*mm ), (mm + 2.0)*vbytes, queue );
+
+        // true residual for the next cycle
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        CHECK( magma_zresidualvec( A, b, *x, &r, &betanom, queue ));
+        solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz + dofs, A.nnz + dofs ) + MAGMA_Z_PERF_FLOPS_NRM2( dofs ), spmv_bytes + 3*vbytes, queue );
+
+        // new recycled subspace from this cycle
+        if ( kmax > 0 ) {
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            CHECK( magma_zgcrodr_harmonic( dofs, mm, kmax, G, ldg, dW, dZ, dtmp,
+                                           dUnew, dCnew, recycle, queue ));
+            magma_perf_toc( &solver_par->perf, Magma_PERF_ORTHO, tp, 0.0, 2.0*mm*vbytes, queue );
+        }
+    }
+    while ( solver_par->numiter+1 <= solver_par->maxiter );
+
+    tempo2 = magma_sync_wtime( queue );
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    double residual;
+    CHECK( magma_zresidual( A, b, *x, &residual, queue ));
+    solver_par->iter_res = betanom;
+    solver_par->final_res = residual;
+
+    if ( solver_par->numiter < solver_par->maxiter && info == MAGMA_SUCCESS ) {
+        info = MAGMA_SUCCESS;
+    } else if ( solver_par->init_res > solver_par->final_res ) {
+        if ( solver_par->verbose > 0 ) {
+            if ( (solver_par->numiter)%solver_par->verbose == 0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        info = MAGMA_SLOW_CONVERGENCE;
+        if( solver_par->iter_res < solver_par->rtol*nomb ||
+            solver_par->iter_res < solver_par->atol ) {
+            info = MAGMA_SUCCESS;
+        }
+    }
+    else {
+        if ( solver_par->verbose > 0 ) {
+            if ( (solver_par->numiter)%solver_par->verbose == 0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        info = MAGMA_DIVERGENCE;
+    }
+
+cleanup:
+    magma_zmfree( &r, queue );
+    magma_zmfree( &t, queue );
+    magma_zmfree( &t2, queue );
+    magma_free( dW );
+    magma_free( dZ );
+    magma_free( dy );
+    magma_free( dtmp );
+    magma_free( dUnew );
+    magma_free( dCnew );
+    magma_free_cpu( G );
+    magma_free_cpu( H );
+    magma_free_cpu( s );
+    magma_free_cpu( y );
+    magma_free_cpu( cs );
+    magma_free_cpu( sn );
+
+    solver_par->info = info;
+    return info;
+}   /* magma_zgcrodr */
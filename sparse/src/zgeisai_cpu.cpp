@@ -0,0 +1,543 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// entries of the packed workspace holding the local systems of one batch
+#define ISAI_CPU_WORKSPACE (1 << 22)
+
+
+/**
+    Purpose
+    -------
+
+    Sorts the column indices (and values) of each row of a CPU CSR matrix
+    by insertion sort; the rows are short.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+static void
+magma_zisai_cpu_sortrows(
+    magma_z_matrix *A )
+{
+    #pragma omp parallel for schedule(dynamic,256)
+    for( magma_int_t i=0; i < A->num_rows; i++ ) {
+        for( magma_int_t j=A->row[i]+1; j < A->row[i+1]; j++ ) {
+            magma_index_t c = A->col[j];
+            magmaDoubleComplex v = A->val[j];
+            magma_int_t k = j-1;
+            while ( k >= A->row[i] && A->col[k] > c ) {
+                A->col[k+1] = A->col[k];
+                A->val[k+1] = A->val[k];
+                k--;
+            }
+            A->col[k+1] = c;
+            A->val[k+1] = v;
+        }
+    }
+}
+
+
+/**
+    Purpose
+    -------
+
+    Copies a matrix to the CPU in CSR format with sorted rows.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+static magma_int_t
+magma_zisai_cpu_csr(
+    magma_z_matrix A,
+    magma_z_matrix *hA,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_z_matrix hAT={Magma_CSR};
+
+    if ( A.memory_location != Magma_CPU || A.storage_type != Magma_CSR ) {
+        CHECK( magma_zmtransfer( A, &hAT, A.memory_location, Magma_CPU, queue ));
+        CHECK( magma_zmconvert( hAT, hA, hAT.storage_type, Magma_CSR, queue ));
+    } else {
+        CHECK( magma_zmtransfer( A, hA, Magma_CPU, Magma_CPU, queue ));
+    }
+    magma_zisai_cpu_sortrows( hA );
+
+cleanup:
+    magma_zmfree( &hAT, queue );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Solves one local ISAI system T x = x in place, T dense row-major
+    lower or upper triangular. For S > 0 the system size is the template
+    parameter; S = 0 is the generic kernel for any size s.
+
+    Returns 0, or p+1 if the p-th diagonal element is zero.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+template< int S >
+static magma_int_t
+magma_zisai_cpu_trsv(
+    magma_uplo_t uplotype,
+    magma_diag_t diagtype,
+    magma_int_t s_,
+    const magmaDoubleComplex *T,
+    magmaDoubleComplex *x )
+{
+    const magma_int_t s = ( S > 0 ) ? S : s_;
+
+    if ( uplotype == MagmaLower ) {
+        for( magma_int_t p=0; p < s; p++ ) {
+            magmaDoubleComplex sum = x[p];
+            for( magma_int_t q=0; q < p; q++ ) {
+                sum = sum - T[p*s+q] * x[q];
+            }
+            if ( diagtype == MagmaUnit ) {
+                x[p] = sum;
+            } else if ( MAGMA_Z_ABS1( T[p*s+p] ) == 0.0 ) {
+                return p+1;
+            } else {
+                x[p] = sum / T[p*s+p];
+            }
+        }
+    } else {
+        for( magma_int_t p=s-1; p >= 0; p-- ) {
+            magmaDoubleComplex sum = x[p];
+            for( magma_int_t q=p+1; q < s; q++ ) {
+                sum = sum - T[p*s+q] * x[q];
+            }
+            if ( diagtype == MagmaUnit ) {
+                x[p] = sum;
+            } else if ( MAGMA_Z_ABS1( T[p*s+p] ) == 0.0 ) {
+                return p+1;
+            } else {
+                x[p] = sum / T[p*s+p];
+            }
+        }
+    }
+    return 0;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Solves the local systems at positions [p0, p1) of the packed workspace,
+    which all have size s. Called from inside a parallel region; the systems
+    are shared among the threads.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+template< int S >
+static void
+magma_zisai_cpu_solve_group(
+    magma_uplo_t uplotype,
+    magma_diag_t diagtype,
+    magma_int_t s_,
+    magma_int_t p0,
+    magma_int_t p1,
+    const magma_int_t *offset,
+    magmaDoubleComplex *work,
+    magma_int_t *info )
+{
+    const magma_int_t s = ( S > 0 ) ? S : s_;
+
+    #pragma omp for schedule(static) nowait
+    for( magma_int_t p=p0; p < p1; p++ ) {
+        magmaDoubleComplex *T = work + offset[p];
+        if ( magma_zisai_cpu_trsv<S>( uplotype, diagtype, s, T, T + s*s ) != 0 ) {
+            #pragma omp atomic write
+            *info = MAGMA_ERR_BADPRECOND;
+        }
+    }
+}
+
+
+/**
+    Purpose
+    -------
+
+    Generates the incomplete sparse approximate inverse (ISAI) of a
+    triangular factor on the CPU. This is the host counterpart of
+    magma_zisai_generator_regs, without its limit of 32 nonzeros per
+    column of the approximate inverse.
+
+    M holds the sparsity pattern of the transpose of the ISAI: row j of M is
+    column j of the approximate inverse, with the row indices I. Its values
+    are the solution of the local triangular system L(I,I) m = e_j.
+
+    The local systems are processed in batches. Each batch is extracted
+    from L into a packed workspace, then solved in parallel grouped by
+    size with kernels specialized for the common sizes, then scattered into
+    M. Both matrices may reside on the CPU or the device; M is returned in
+    its original location with sorted rows.
+
+    Arguments
+    ---------
+
+    @param[in]
+    uplotype    magma_uplo_t
+                lower or upper triangular
+
+    @param[in]
+    transtype   magma_trans_t
+                only MagmaNoTrans is supported
+
+    @param[in]
+    diagtype    magma_diag_t
+                unit diagonal or not
+
+    @param[in]
+    L           magma_z_matrix
+                triangular factor
+
+    @param[in,out]
+    M           magma_z_matrix*
+                transposed ISAI pattern on input, transposed ISAI on output
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zisai_generator_cpu(
+    magma_uplo_t uplotype,
+    magma_trans_t transtype,
+    magma_diag_t diagtype,
+    magma_z_matrix L,
+    magma_z_matrix *M,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_z_matrix hL={Magma_CSR}, hM={Magma_CSR};
+    magma_location_t location = M->memory_location;
+    magma_int_t n, smax = 0, p0, p1, lwork;
+    magma_int_t *perm = NULL, *group = NULL, *offset = NULL;
+    magmaDoubleComplex *work = NULL;
+
+    if ( transtype != MagmaNoTrans ) {
+        printf("%%  error: transposed ISAI generation is not supported on the CPU.\n");
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    CHECK( magma_zisai_cpu_csr( L, &hL, queue ));
+    CHECK( magma_zisai_cpu_csr( *M, &hM, queue ));
+    n = hM.num_rows;
+
+    for( magma_int_t j=0; j < n; j++ ) {
+        smax = max( smax, hM.row[j+1] - hM.row[j] );
+    }
+    // counting sort of the local systems by size
+    CHECK( magma_imalloc_cpu( &group, smax+2 ));
+    CHECK( magma_imalloc_cpu( &perm, n ));
+    CHECK( magma_imalloc_cpu( &offset, n+1 ));
+    for( magma_int_t s=0; s < smax+2; s++ ) {
+        group[s] = 0;
+    }
+    for( magma_int_t j=0; j < n; j++ ) {
+        group[ hM.row[j+1] - hM.row[j] + 1 ]++;
+    }
+    for( magma_int_t s=1; s < smax+2; s++ ) {
+        group[s] += group[s-1];
+    }
+    for( magma_int_t j=0; j < n; j++ ) {
+        perm[ group[ hM.row[j+1] - hM.row[j] ]++ ] = j;
+    }
+    for( magma_int_t s=smax+1; s > 0; s-- ) {
+        group[s] = group[s-1];
+    }
+    group[0] = 0;
+
+    lwork = max( ISAI_CPU_WORKSPACE, smax*smax + smax );
+    CHECK( magma_zmalloc_cpu( &work, lwork ));
+
+    for( p0 = group[1]; p0 < n; p0 = p1 ) {
+        // next batch: the systems in [p0, p1) that fit into the workspace
+        offset[p0] = 0;
+        for( p1 = p0; p1 < n; p1++ ) {
+            magma_int_t s = hM.row[ perm[p1]+1 ] - hM.row[ perm[p1] ];
+            if ( p1 > p0 && offset[p1] + s*s + s > lwork ) {
+                break;
+            }
+            offset[p1+1] = offset[p1] + s*s + s;
+        }
+
+        // extraction of L(I,I) and e_j into the packed workspace
+        #pragma omp parallel for schedule(dynamic,64)
+        for( magma_int_t p=p0; p < p1; p++ ) {
+            magma_int_t j = perm[p];
+            magma_int_t s = hM.row[j+1] - hM.row[j];
+            const magma_index_t *I = hM.col + hM.row[j];
+            magmaDoubleComplex *T = work + offset[p], *x = T + s*s;
+            for( magma_int_t k=0; k < s*s; k++ ) {
+                T[k] = MAGMA_Z_ZERO;
+            }
+            for( magma_int_t r=0; r < s; r++ ) {
+                magma_int_t k = hL.row[ I[r] ], q = 0;
+                while ( k < hL.row[ I[r]+1 ] && q < s ) {
+                    if ( hL.col[k] == I[q] ) {
+                        T[r*s+q] = hL.val[k];
+                        k++;
+                        q++;
+                    } else if ( hL.col[k] < I[q] ) {
+                        k++;
+                    } else {
+                        q++;
+                    }
+                }
+                x[r] = ( I[r] == j ) ? MAGMA_Z_ONE : MAGMA_Z_ZERO;
+            }
+        }
+
+        // triangular solves, one group of equally sized systems at a time
+        #pragma omp parallel
+        {
+            for( magma_int_t s=1; s <= smax; s++ ) {
+                magma_int_t g0 = max( group[s], p0 ), g1 = min( group[s+1], p1 );
+                if ( g0 >= g1 ) {
+                    continue;
+                }
+                switch( s ) {
+                    case 1:  magma_zisai_cpu_solve_group<1>(  uplotype, diagtype, s, g0, g1, offset, work, &info ); break;
+                    case 2:  magma_zisai_cpu_solve_group<2>(  uplotype, diagtype, s, g0, g1, offset, work, &info ); break;
+                    case 3:  magma_zisai_cpu_solve_group<3>(  uplotype, diagtype, s, g0, g1, offset, work, &info ); break;
+                    case 4:  magma_zisai_cpu_solve_group<4>(  uplotype, diagtype, s, g0, g1, offset, work, &info ); break;
+                    case 5:  magma_zisai_cpu_solve_group<5>(  uplotype, diagtype, s, g0, g1, offset, work, &info ); break;
+                    case 6:  magma_zisai_cpu_solve_group<6>(  uplotype, diagtype, s, g0, g1, offset, work, &info ); break;
+                    case 7:  magma_zisai_cpu_solve_group<7>(  uplotype, diagtype, s, g0, g1, offset, work, &info ); break;
+                    case 8:  magma_zisai_cpu_solve_group<8>(  uplotype, diagtype, s, g0, g1, offset, work, &info ); break;
+                    case 16: magma_zisai_cpu_solve_group<16>( uplotype, diagtype, s, g0, g1, offset, work, &info ); break;
+                    case 32: magma_zisai_cpu_solve_group<32>( uplotype, diagtype, s, g0, g1, offset, work, &info ); break;
+                    default: magma_zisai_cpu_solve_group<0>(  uplotype, diagtype, s, g0, g1, offset, work, &info ); break;
+                }
+            }
+        }
+        if ( info != 0 ) {
+            printf("%%  error: zero diagonal element in a local ISAI system.\n");
+            goto cleanup;
+        }
+
+        // scatter into the pattern
+        #pragma omp parallel for schedule(dynamic,64)
+        for( magma_int_t p=p0; p < p1; p++ ) {
+            magma_int_t j = perm[p];
+            magma_int_t s = hM.row[j+1] - hM.row[j];
+            const magmaDoubleComplex *x = work + offset[p] + s*s;
+            for( magma_int_t q=0; q < s; q++ ) {
+                hM.val[ hM.row[j] + q ] = x[q];
+            }
+        }
+    }
+
+    magma_zmfree( M, queue );
+    CHECK( magma_zmtransfer( hM, M, Magma_CPU, location, queue ));
+
+cleanup:
+    magma_zmfree( &hL, queue );
+    magma_zmfree( &hM, queue );
+    magma_free_cpu( perm );
+    magma_free_cpu( group );
+    magma_free_cpu( offset );
+    magma_free_cpu( work );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Generates the sparsity pattern of the ISAI of a triangular factor as
+    the pattern of L^power, computed symbolically on the CPU. Only the
+    lower (upper) triangular part of L is used, and the diagonal is always
+    included. S has unit values and is returned in the memory location of L.
+
+    Arguments
+    ---------
+
+    @param[in]
+    uplotype    magma_uplo_t
+                lower or upper triangular
+
+    @param[in]
+    power       magma_int_t
+                power of the pattern, at least 1
+
+    @param[in]
+    L           magma_z_matrix
+                triangular factor
+
+    @param[out]
+    S           magma_z_matrix*
+                sparsity pattern of L^power
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmisai_pattern(
+    magma_uplo_t uplotype,
+    magma_int_t power,
+    magma_z_matrix L,
+    magma_z_matrix *S,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_z_matrix hL={Magma_CSR}, P={Magma_CSR}, Q={Magma_CSR};
+    magma_int_t n;
+
+    CHECK( magma_zisai_cpu_csr( L, &hL, queue ));
+    n = hL.num_rows;
+
+    // P = triangular part of L plus the diagonal
+    P.storage_type = Magma_CSR;
+    P.memory_location = Magma_CPU;
+    P.num_rows = n;
+    P.num_cols = n;
+    CHECK( magma_index_malloc_cpu( &P.row, n+1 ));
+    P.row[0] = 0;
+    for( magma_int_t i=0; i < n; i++ ) {
+        magma_int_t cnt = 1;
+        for( magma_int_t j=hL.row[i]; j < hL.row[i+1]; j++ ) {
+            magma_index_t c = hL.col[j];
+            if ( ( uplotype == MagmaLower && c < i ) ||
+                 ( uplotype == MagmaUpper && c > i ) ) {
+                cnt++;
+            }
+        }
+        P.row[i+1] = P.row[i] + cnt;
+    }
+    P.nnz = P.row[n];
+    CHECK( magma_index_malloc_cpu( &P.col, P.nnz ));
+    CHECK( magma_zmalloc_cpu( &P.val, P.nnz ));
+    #pragma omp parallel for
+    for( magma_int_t i=0; i < n; i++ ) {
+        magma_int_t k = P.row[i];
+        if ( uplotype == MagmaUpper ) {
+            P.col[k++] = i;
+        }
+        for( magma_int_t j=hL.row[i]; j < hL.row[i+1]; j++ ) {
+            magma_index_t c = hL.col[j];
+            if ( ( uplotype == MagmaLower && c < i ) ||
+                 ( uplotype == MagmaUpper && c > i ) ) {
+                P.col[k++] = c;
+            }
+        }
+        if ( uplotype == MagmaLower ) {
+            P.col[k++] = i;
+        }
+        for( magma_int_t j=P.row[i]; j < P.row[i+1]; j++ ) {
+            P.val[j] = MAGMA_Z_ONE;
+        }
+    }
+
+    // symbolic products Q = P * P_1, with P_1 the pattern of power one
+    for( magma_int_t z=1; z < power; z++ ) {
+        Q.storage_type = Magma_CSR;
+        Q.memory_location = Magma_CPU;
+        Q.num_rows = n;
+        Q.num_cols = n;
+        CHECK( magma_index_malloc_cpu( &Q.row, n+1 ));
+        for( magma_int_t pass=0; pass < 2; pass++ ) {
+            if ( pass == 1 ) {
+                Q.row[0] = 0;
+                for( magma_int_t i=0; i < n; i++ ) {
+                    Q.row[i+1] += Q.row[i];
+                }
+                Q.nnz = Q.row[n];
+                CHECK( magma_index_malloc_cpu( &Q.col, Q.nnz ));
+                CHECK( magma_zmalloc_cpu( &Q.val, Q.nnz ));
+            }
+            #pragma omp parallel
+            {
+                magma_index_t *mark = NULL;
+                if ( magma_index_malloc_cpu( &mark, n ) != 0 ) {
+                    #pragma omp atomic write
+                    info = MAGMA_ERR_HOST_ALLOC;
+                } else {
+                    for( magma_int_t i=0; i < n; i++ ) {
+                        mark[i] = -1;
+                    }
+                    #pragma omp for schedule(dynamic,256)
+                    for( magma_int_t i=0; i < n; i++ ) {
+                        magma_int_t cnt = 0;
+                        for( magma_int_t j=P.row[i]; j < P.row[i+1]; j++ ) {
+                            magma_index_t r = P.col[j];
+                            // row r of the power-one pattern
+                            for( magma_int_t k=hL.row[r]; k <= hL.row[r+1]; k++ ) {
+                                magma_index_t c = ( k < hL.row[r+1] ) ? hL.col[k] : r;
+                                if ( ( uplotype == MagmaLower && c > r ) ||
+                                     ( uplotype == MagmaUpper && c < r ) ||
+                                     mark[c] == i ) {
+                                    continue;
+                                }
+                                mark[c] = i;
+                                if ( pass == 1 ) {
+                                    Q.col[ Q.row[i] + cnt ] = c;
+                                }
+                                cnt++;
+                            }
+                        }
+                        if ( pass == 0 ) {
+                            Q.row[i+1] = cnt;
+                        } else {
+                            magma_zindexsort( Q.col, Q.row[i], Q.row[i+1]-1, queue );
+                            for( magma_int_t j=Q.row[i]; j < Q.row[i+1]; j++ ) {
+                                Q.val[j] = MAGMA_Z_ONE;
+                            }
+                        }
+                    }
+                }
+                magma_free_cpu( mark );
+            }
+            if ( info != 0 ) {
+                goto cleanup;
+            }
+        }
+        magma_zmfree( &P, queue );
+        P = Q;
+        Q.row = NULL;
+        Q.col = NULL;
+        Q.val = NULL;
+    }
+
+    magma_zmfree( S, queue );
+    CHECK( magma_zmtransfer( P, S, Magma_CPU, L.memory_location, queue ));
+
+cleanup:
+    magma_zmfree( &hL, queue );
+    magma_zmfree( &P, queue );
+    if ( Q.row != NULL ) {
+        magma_zmfree( &Q, queue );
+    }
+    return info;
+}
@@ -23,9 +23,10 @@
     Prepares Incomplete LU preconditioner using a sparse approximate inverse
     instead of sparse triangular solves.
     
-    This routine only handles the upper triangular part. The return value is 0
-    in case of success, and Magma_CUSOLVE if the pattern is too large to be 
-    handled.
+    This routine only handles the upper triangular part. Local systems that
+    do not fit the register kernel on the GPU (more than 32 entries), and all
+    systems of a factor that resides on the CPU, are generated on the CPU
+    using magma_zisai_generator_cpu.
 
     Arguments
     ---------
@@ -65,34 +66,45 @@ magma_ziluisaisetup_upper(
     int warpsize=32;
 
     // we need this in any case as the ISAI matrix is generated in transpose fashion
-    CHECK( magma_zmtranspose( S, &MT, queue ) );
+    if ( S.memory_location == Magma_CPU ) {
+        CHECK( magma_zmtranspose_cpu( S, &MT, queue ) );
+    } else {
+        CHECK( magma_zmtranspose( S, &MT, queue ) );
+    }
 
-    CHECK( magma_index_malloc_cpu( &sizes_h, U.num_rows+1 ) );
-    #pragma omp parallel for
-    for( magma_int_t i=0; i<U.num_rows; i++ ){
-            maxsize = sizes_h[i] = 0;
+    // the rows of MT are the local systems
+    CHECK( magma_index_malloc_cpu( &sizes_h, MT.num_rows+1 ) );
+    if ( MT.memory_location == Magma_CPU ) {
+        for( magma_int_t i=0; i<MT.num_rows+1; i++ ){
+            sizes_h[i] = MT.row[i];
+        }
+    } else {
+        magma_index_getvector( MT.num_rows+1, MT.drow, 1, sizes_h, 1, queue );
     }
-    magma_index_getvector( S.num_rows+1, S.drow, 1, sizes_h, 1, queue );
     maxsize = 0;
-    for( magma_int_t i=0; i<U.num_rows; i++ ){
+    for( magma_int_t i=0; i<MT.num_rows; i++ ){
         nnzloc = sizes_h[i+1]-sizes_h[i];
         if( nnzloc > maxsize ){
-            maxsize = sizes_h[i+1]-sizes_h[i];
-        }
-        if( maxsize > warpsize ){
-            printf("%% error for ISAI U: size of system %d is too large by %d\n", (int) i, (int) (maxsize-32));
-            printf("%% fallback: use exact triangular solve (cuSOLVE)\n");
-            info = Magma_CUSOLVE;
-            goto cleanup;
+            maxsize = nnzloc;
         }
     }
 
-    // printf("%% nnz in ISAI factor U (total max/row): %d %d\n", (int) S.nnz, (int) maxsize);
-    // generation of the ISAI on the GPU - all operations in registers
-     CHECK( magma_zisai_generator_regs( MagmaUpper, MagmaNoTrans, MagmaNonUnit,
+    if( maxsize > warpsize || MT.memory_location == Magma_CPU ){
+        // generation of the ISAI on the CPU - no limit on the system size
+        CHECK( magma_zisai_generator_cpu( MagmaUpper, MagmaNoTrans, MagmaNonUnit,
                     U, &MT, queue ) );
+    } else {
+        // printf("%% nnz in ISAI factor U (total max/row): %d %d\n", (int) S.nnz, (int) maxsize);
+        // generation of the ISAI on the GPU - all operations in registers
+        CHECK( magma_zisai_generator_regs( MagmaUpper, MagmaNoTrans, MagmaNonUnit,
+                    U, &MT, queue ) );
+    }
 
-    CHECK( magma_zmtranspose( MT, ISAIU, queue ) );
+    if ( MT.memory_location == Magma_CPU ) {
+        CHECK( magma_zmtranspose_cpu( MT, ISAIU, queue ) );
+    } else {
+        CHECK( magma_zmtranspose( MT, ISAIU, queue ) );
+    }
 
 cleanup:
     magma_free_cpu( sizes_h );
@@ -125,7 +125,11 @@ magma_zidr_strms(
     magma_queue_t queues[nqueues];    
 
     // chronometry
-    real_Double_t tempo1, tempo2;
+    real_Double_t tempo1, tempo2, tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = b.num_rows * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) + 2 * vbytes;
 
     // create additional queues
     queues[0] = queue;
@@ -312,6 +316,9 @@ cudaProfilerStart();
     om = MAGMA_Z_ONE;
     gamma = MAGMA_Z_ZERO;
     innerflag = 0;
+    // only the SpMV and the preconditioner are timed, on the queue they run
+    // on; the vector updates overlap on three queues and are not split up
+    magma_perf_reset( &solver_par->perf );
 
     // new RHS for small systems
     // f = P' r
@@ -350,8 +357,10 @@ cudaProfilerStart();
 
             // G(:,k) = A U(:,k)
             // Q1
+            tp = magma_perf_tic( &solver_par->perf, queues[1] );
             CHECK( magma_z_spmv( c_one, A, dv, c_zero, dGcol, queues[1] ));
             solver_par->spmv_count++;
+            magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz, A.nnz ), spmv_bytes, queues[1] );
 
             // bi-orthogonalize the new basis vectors
             for ( i = 0; i < k; ++i ) {
@@ -492,8 +501,10 @@ cudaProfilerStart();
             if ( (k + 1) == s ) {
                // t = A r
                // Q2
+               tp = magma_perf_tic( &solver_par->perf, queues[2] );
                CHECK( magma_z_spmv( c_one, A, dr, c_zero, dt, queues[2] ));
                solver_par->spmv_count++;
+               magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz, A.nnz ), spmv_bytes, queues[2] );
 
                // t't
                // t'r
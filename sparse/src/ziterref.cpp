@@ -74,6 +74,12 @@ magma_ziterref(
     solver_par->spmv_count = 0;
     
     magma_int_t dofs = A.num_rows*b.num_cols;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) * b.num_cols
+                        + 2 * vbytes;
 
     // solver variables
     double nom, nom0;
@@ -107,6 +113,7 @@ magma_ziterref(
     //Chronometry
     real_Double_t tempo1, tempo2;
     tempo1 = magma_sync_wtime( queue );
+    magma_perf_reset( &solver_par->perf );
     if ( solver_par->verbose > 0 ) {
         solver_par->res_vec[0] = nom0;
         solver_par->timing[0] = 0.0;
@@ -115,14 +122,26 @@ magma_ziterref(
     // start iteration
     for( solver_par->numiter= 1; solver_par->numiter<solver_par->maxiter;
                                                     solver_par->numiter++ ) {
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zscal( dofs, MAGMA_Z_MAKE(1./nom, 0.), r.dval, 1, queue );  // scale it
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs, 0 ), 2*vbytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_precond( A, r, &z, precond_par, queue )); // inner solver:  A * z = r
+        magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0, 2*vbytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zscal( dofs, MAGMA_Z_MAKE(nom, 0.), z.dval, 1, queue );  // scale it
         magma_zaxpy( dofs,  c_one, z.dval, 1, x->dval, 1, queue );        // x = x + z
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, dofs ), 5*vbytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_neg_one, A, *x, c_zero, r, queue ));      // r = - A x
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zaxpy( dofs,  c_one, b.dval, 1, r.dval, 1, queue );         // r = r + b
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 3*vbytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         nom = magma_dznrm2( dofs, r.dval, 1, queue );                    // nom = || r ||
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( dofs ), vbytes, queue );
 
         if ( solver_par->verbose > 0 ) {
             tempo2 = magma_sync_wtime( queue );
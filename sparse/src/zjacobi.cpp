@@ -288,7 +288,21 @@ magma_zjacobisetup_diagscal(
     magma_z_matrix diag={Magma_CSR};
     CHECK( magma_zvinit( &diag, Magma_CPU, A.num_rows, 1, MAGMA_Z_ZERO, queue ));
 
-    if ( A.storage_type != Magma_CSR || A.memory_location != Magma_CPU ) {
+    if ( A.storage_type == Magma_SPMVFUNCTION ) {
+        // matrix-free operator: diagonal from the operator's callback
+        CHECK( magma_zmoperator_diag( A, &A_h1, queue ));
+        CHECK( magma_zmtransfer( A_h1, &B, A_h1.memory_location, Magma_CPU, queue ));
+        for( magma_int_t rowindex=0; rowindex<B.num_rows; rowindex++ ) {
+            if ( B.val[rowindex] == MAGMA_Z_ZERO ){
+                printf(" error: zero diagonal element in row %d!\n",
+                                                            int(rowindex));
+                info = MAGMA_ERR_BADPRECOND;
+                goto cleanup;
+            }
+            diag.val[rowindex] = 1.0/B.val[rowindex];
+        }
+    }
+    else if ( A.storage_type != Magma_CSR || A.memory_location != Magma_CPU ) {
         CHECK( magma_zmtransfer( A, &A_h1, A.memory_location, Magma_CPU, queue ));
         CHECK( magma_zmconvert( A_h1, &B, A_h1.storage_type, Magma_CSR, queue ));
         
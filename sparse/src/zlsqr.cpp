@@ -72,6 +72,13 @@ magma_zlsqr(
     
     magma_int_t m = A.num_rows * b.num_cols;
     magma_int_t n = A.num_cols * b.num_cols;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = n * sizeof(magmaDoubleComplex);
+    double ubytes = m * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) * b.num_cols
+                        + vbytes + ubytes;
     
     // local variables
     magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
@@ -158,24 +165,37 @@ magma_zlsqr(
     real_Double_t tempo1, tempo2;
     tempo1 = magma_sync_wtime( queue );
     solver_par->numiter = 0;
+    magma_perf_reset( &solver_par->perf );
     // start iteration
     do
     {
         solver_par->numiter++;
         if( precond_par->solver == Magma_NONE ) {
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zcopy( n, v.dval, 1 , z.dval, 1, queue );    
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, 0.0, 2*vbytes, queue );
         } else {
+            tp = magma_perf_tic( &solver_par->perf, queue );
             CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, v, &zt, precond_par, queue ));
             CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, zt, &z, precond_par, queue ));
+            magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0.0, 2*vbytes, queue );
         }
         //CHECK( magma_z_spmv( c_one, A, z, MAGMA_Z_MAKE(-alpha,0.0), u, queue ));
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, z, c_zero, ut, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zscal( m, MAGMA_Z_MAKE(-alpha, 0.0 ), u.dval, 1, queue ); 
         magma_zaxpy( m, c_one, ut.dval, 1, u.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*m, m ), 5*ubytes, queue );
         
         solver_par->spmv_count++;
+        tp = magma_perf_tic( &solver_par->perf, queue );
         beta = magma_dznrm2( m, u.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( m ), ubytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zscal( m, MAGMA_Z_MAKE(1./beta, 0.0 ), u.dval, 1, queue ); 
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( m, 0 ), 2*ubytes, queue );
         // norma = norm([norma alpha beta]);
         norma = sqrt(norma*norma + alpha*alpha + beta*beta );
         
@@ -190,10 +210,14 @@ magma_zlsqr(
         phibar = s * phibar;
         
         // d = (z - thet * d) / rho;
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zscal( n, MAGMA_Z_MAKE(-thet, 0.0 ), d.dval, 1, queue ); 
         magma_zaxpy( n, c_one, z.dval, 1, d.dval, 1, queue );
         magma_zscal( n, MAGMA_Z_MAKE(1./rho, 0.0 ), d.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 3.*n, n ), 7*vbytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         normd = magma_dznrm2( n, d.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( n ), vbytes, queue );
         sumnormd2 = sumnormd2 + normd*normd;
         
         // convergence check
@@ -211,7 +235,9 @@ magma_zlsqr(
             break;
         }
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zaxpy( n, MAGMA_Z_MAKE( phi, 0.0 ), d.dval, 1, x->dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( n, n ), 3*vbytes, queue );
         normr = fabs(s) * normr;
         if ( solver_par->verbose > 0 ) {
             tempo2 = magma_sync_wtime( queue );
@@ -222,19 +248,29 @@ magma_zlsqr(
                         = (real_Double_t) tempo2-tempo1;
             }
         }
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, AT, u, c_zero, vt, queue ));
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
         if( precond_par->solver == Magma_NONE ){
             ;    
         } else {
+            tp = magma_perf_tic( &solver_par->perf, queue );
             CHECK( magma_z_applyprecond_right( MagmaTrans, A, vt, &zt, precond_par, queue ));
             CHECK( magma_z_applyprecond_left( MagmaTrans, A, zt, &vt, precond_par, queue ));
+            magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0.0, 2*vbytes, queue );
         }
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zscal( n, MAGMA_Z_MAKE(-beta, 0.0 ), v.dval, 1, queue ); 
         magma_zaxpy( n, c_one, vt.dval, 1, v.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*n, n ), 5*vbytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         alpha = magma_dznrm2( n, v.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( n ), vbytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zscal( n, MAGMA_Z_MAKE(1./alpha, 0.0 ), v.dval, 1, queue ); 
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( n, 0 ), 2*vbytes, queue );
         normar = alpha * fabs(s*phi);    
     }
     while ( solver_par->numiter+1 <= solver_par->maxiter );
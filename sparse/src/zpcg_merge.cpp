@@ -78,6 +78,12 @@ magma_zpcg_merge(
     // some useful variables
     magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
     magma_int_t dofs = A.num_rows*b.num_cols;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) * b.num_cols
+                        + 2 * vbytes;
 
     magma_z_matrix r={Magma_CSR}, d={Magma_CSR}, z={Magma_CSR}, h={Magma_CSR},
                     rt={Magma_CSR};
@@ -153,36 +159,51 @@ magma_zpcg_merge(
     
     solver_par->numiter = 0;
     solver_par->spmv_count = 0;
+    magma_perf_reset( &solver_par->perf );
     // start iteration
     do
     {
         solver_par->numiter++;
         
         // computes SpMV and dot product
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_zcgmerge_spmv1(  A, d1, d2, d.dval, z.dval, skp, queue ));            
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols + dofs, A.nnz*b.num_cols + dofs ), spmv_bytes, queue );
             
         
         if( precond_par->solver == Magma_JACOBI ){
+                tp = magma_perf_tic( &solver_par->perf, queue );
                 CHECK( magma_zjcgmerge_xrbeta( dofs, d1, d2, precond_par->d.dval, x->dval, r.dval, d.dval, z.dval, h.dval, skp, queue ));
+                magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 6.*dofs, 5.*dofs ), 10*vbytes, queue );
         }
         else if( precond_par->solver == Magma_NONE ){
             // updates x, r
+            tp = magma_perf_tic( &solver_par->perf, queue );
             CHECK( magma_zpcgmerge_xrbeta1( dofs, x->dval, r.dval, d.dval, z.dval, skp, queue ));
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 6*vbytes, queue );
             // computes scalars and updates d
+            tp = magma_perf_tic( &solver_par->perf, queue );
             CHECK( magma_zpcgmerge_xrbeta2( dofs, d1, d2, r.dval, r.dval, d.dval, skp, queue ));
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 3.*dofs, 3.*dofs ), 4*vbytes, queue );
         }
         else {
             // updates x, r
+            tp = magma_perf_tic( &solver_par->perf, queue );
             CHECK( magma_zpcgmerge_xrbeta1( dofs, x->dval, r.dval, d.dval, z.dval, skp, queue ));
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 6*vbytes, queue );
             
             // preconditioner in between
+            tp = magma_perf_tic( &solver_par->perf, queue );
             CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, r, &rt, precond_par, queue ));
             CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, rt, &h, precond_par, queue ));
+            magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0, 2*vbytes, queue );
             //            magma_zcopy( dofs, r.dval, 1, h.dval, 1 );  
             
             // computes scalars and updates d
+            tp = magma_perf_tic( &solver_par->perf, queue );
             CHECK( magma_zpcgmerge_xrbeta2( dofs, d1, d2, h.dval, r.dval, d.dval, skp, queue ));
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 3.*dofs, 3.*dofs ), 4*vbytes, queue );
         }
         
         //if( solver_par->numiter==1){
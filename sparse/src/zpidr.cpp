@@ -123,7 +123,11 @@ magma_zpidr(
     magma_z_matrix dlu = {Magma_CSR};
 
     // chronometry
-    real_Double_t tempo1, tempo2;
+    real_Double_t tempo1, tempo2, tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = b.num_rows * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) + 2 * vbytes;
 
     // initial s space
     // TODO: add option for 's' (shadow space number)
@@ -256,6 +260,7 @@ magma_zpidr(
 
     om = MAGMA_Z_ONE;
     innerflag = 0;
+    magma_perf_reset( &solver_par->perf );
 
     // start iteration
     do
@@ -264,34 +269,45 @@ magma_zpidr(
     
         // new RHS for small systems
         // f = P' r
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magmablas_zgemv( MagmaConjTrans, dP.num_rows, dP.num_cols, c_one, dP.dval, dP.ld, dr.dval, 1, c_zero, df.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_ORTHO, tp, MAGMA_Z_PERF_FLOPS( dP.num_rows*s, dP.num_rows*s ), (s+1)*vbytes, queue );
 
         // shadow space loop
         for ( k = 0; k < s; ++k ) {
             sk = s - k;
     
             // f(k:s) = M(k:s,k:s) c(k:s)
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zcopyvector( sk, &df.dval[k], 1, &dc.dval[k], 1, queue );
             magma_ztrsv( MagmaLower, MagmaNoTrans, MagmaNonUnit, sk, &dM.dval[k*dM.ld+k], dM.ld, &dc.dval[k], 1, queue );
 
             // v = r - G(:,k:s) c(k:s)
             magma_zcopyvector( dr.num_rows, dr.dval, 1, dv.dval, 1, queue );
             magmablas_zgemv( MagmaNoTrans, dG.num_rows, sk, c_n_one, &dG.dval[k*dG.ld], dG.ld, &dc.dval[k], 1, c_one, dv.dval, 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_ORTHO, tp, MAGMA_Z_PERF_FLOPS( dG.num_rows*sk, dG.num_rows*sk ), (sk+3)*vbytes, queue );
 
             // preconditioning operation 
             // v = L \ v;
             // v = U \ v;
+            tp = magma_perf_tic( &solver_par->perf, queue );
             CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, dv, &dlu, precond_par, queue )); 
             CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, dlu, &dv, precond_par, queue )); 
+            magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0.0, 2*vbytes, queue );
 
             // U(:,k) = om * v + U(:,k:s) c(k:s)
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magmablas_zgemv( MagmaNoTrans, dU.num_rows, sk, c_one, &dU.dval[k*dU.ld], dU.ld, &dc.dval[k], 1, om, dv.dval, 1, queue );
             magma_zcopyvector( dU.num_rows, dv.dval, 1, &dU.dval[k*dU.ld], 1, queue );
             magma_zcopyvector( dU.num_rows, dv.dval, 1, dvtmp.dval, 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_ORTHO, tp, MAGMA_Z_PERF_FLOPS( dU.num_rows*(sk+1), dU.num_rows*sk ), (sk+6)*vbytes, queue );
 
             // G(:,k) = A U(:,k)
+            tp = magma_perf_tic( &solver_par->perf, queue );
             CHECK( magma_z_spmv( c_one, A, dvtmp, c_zero, dv, queue ));
             solver_par->spmv_count++;
+            magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz, A.nnz ), spmv_bytes, queue );
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zcopyvector( dG.num_rows, dv.dval, 1, &dG.dval[k*dG.ld], 1, queue );
 
             // bi-orthogonalize the new basis vectors
@@ -309,10 +325,13 @@ magma_zpidr(
                 // U(:,k) = U(:,k) - alpha * U(:,i)
                 magma_zaxpy( dU.num_rows, -alpha, &dU.dval[i*dU.ld], 1, &dU.dval[k*dU.ld], 1, queue );
             }
+            magma_perf_toc( &solver_par->perf, Magma_PERF_ORTHO, tp, MAGMA_Z_PERF_FLOPS( 3.*k*dP.num_rows, 3.*k*dP.num_rows ), (2+8.*k)*vbytes, queue );
 
             // new column of M = P'G, first k-1 entries are zero
             // M(k:s,k) = P(:,k:s)' G(:,k)
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magmablas_zgemv( MagmaConjTrans, dP.num_rows, sk, c_one, &dP.dval[k*dP.ld], dP.ld, &dG.dval[k*dG.ld], 1, c_zero, &dM.dval[k*dM.ld+k], 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_ORTHO, tp, MAGMA_Z_PERF_FLOPS( dP.num_rows*sk, dP.num_rows*sk ), (sk+1)*vbytes, queue );
 
             // check M(k,k) == 0
             magma_zgetvector( 1, &dM.dval[k*dM.ld+k], 1, &mkk, 1, queue );
@@ -334,16 +353,21 @@ magma_zpidr(
             }
 
             // r = r - beta * G(:,k)
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zaxpy( dr.num_rows, -hbeta.val[k], &dG.dval[k*dG.ld], 1, dr.dval, 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( b.num_rows, b.num_rows ), 3*vbytes, queue );
 
             // smoothing disabled
             if ( smoothing <= 0 ) {
                 // |r|
+                tp = magma_perf_tic( &solver_par->perf, queue );
                 nrmr = magma_dznrm2( dr.num_rows, dr.dval, 1, queue );
+                magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( b.num_rows ), vbytes, queue );
 
             // smoothing enabled
             } else {
                 // x = x + beta * U(:,k)
+                tp = magma_perf_tic( &solver_par->perf, queue );
                 magma_zaxpy( x->num_rows, hbeta.val[k], &dU.dval[k*dU.ld], 1, x->dval, 1, queue );
 
                 // smoothing operation
@@ -351,25 +375,32 @@ magma_zpidr(
                 // t = rs - r
                 magma_zcopyvector( drs.num_rows, drs.dval, 1, dt.dval, 1, queue );
                 magma_zaxpy( dt.num_rows, c_n_one, dr.dval, 1, dt.dval, 1, queue );
+                magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*b.num_rows, 2.*b.num_rows ), 8*vbytes, queue );
 
                 // t't
                 // t'rs 
+                tp = magma_perf_tic( &solver_par->perf, queue );
                 tt = magma_zdotc( dt.num_rows, dt.dval, 1, dt.dval, 1, queue );
                 tr = magma_zdotc( dt.num_rows, dt.dval, 1, drs.dval, 1, queue );
+                magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( 2.*b.num_rows, 2.*b.num_rows ), 3*vbytes, queue );
 
                 // gamma = (t' * rs) / (t' * t)
                 gamma = tr / tt;
 
                 // rs = rs - gamma * (rs - r) 
+                tp = magma_perf_tic( &solver_par->perf, queue );
                 magma_zaxpy( drs.num_rows, -gamma, dt.dval, 1, drs.dval, 1, queue );
 
                 // xs = xs - gamma * (xs - x) 
                 magma_zcopyvector( dxs.num_rows, dxs.dval, 1, dt.dval, 1, queue );
                 magma_zaxpy( dt.num_rows, c_n_one, x->dval, 1, dt.dval, 1, queue );
                 magma_zaxpy( dxs.num_rows, -gamma, dt.dval, 1, dxs.dval, 1, queue );
+                magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 3.*b.num_rows, 3.*b.num_rows ), 11*vbytes, queue );
 
                 // |rs|
+                tp = magma_perf_tic( &solver_par->perf, queue );
                 nrmr = magma_dznrm2( drs.num_rows, drs.dval, 1, queue );           
+                magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( b.num_rows ), vbytes, queue );
 //---------------------------------------
             }
 
@@ -414,25 +445,35 @@ magma_zpidr(
         }
 
         // v = r
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zcopyvector( dr.num_rows, dr.dval, 1, dv.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, 0.0, 2*vbytes, queue );
 
         // preconditioning operation 
         // v = L \ v;
         // v = U \ v;
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, dv, &dlu, precond_par, queue )); 
         CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, dlu, &dv, precond_par, queue )); 
+        magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0.0, 2*vbytes, queue );
 
         // t = A v
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, dv, c_zero, dt, queue ));
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz, A.nnz ), spmv_bytes, queue );
 
         // computation of a new omega
 //---------------------------------------
         // |t|
+        tp = magma_perf_tic( &solver_par->perf, queue );
         nrmt = magma_dznrm2( dt.num_rows, dt.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( b.num_rows ), vbytes, queue );
 
         // t'r 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         tr = magma_zdotc( dt.num_rows, dt.dval, 1, dr.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( b.num_rows, b.num_rows ), 2*vbytes, queue );
 
         // rho = abs(t' * r) / (|t| * |r|))
         rho = MAGMA_D_ABS( MAGMA_Z_REAL(tr) / (nrmt * nrmr) );
@@ -450,43 +491,55 @@ magma_zpidr(
 
         // update approximation vector
         // x = x + om * v
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zaxpy( x->num_rows, om, dv.dval, 1, x->dval, 1, queue );
 
         // update residual vector
         // r = r - om * t
         magma_zaxpy( dr.num_rows, -om, dt.dval, 1, dr.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*b.num_rows, 2.*b.num_rows ), 6*vbytes, queue );
 
         // smoothing disabled
         if ( smoothing <= 0 ) {
             // residual norm
+            tp = magma_perf_tic( &solver_par->perf, queue );
             nrmr = magma_dznrm2( b.num_rows, dr.dval, 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( b.num_rows ), vbytes, queue );
 
         // smoothing enabled
         } else {
             // smoothing operation
 //---------------------------------------
             // t = rs - r
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zcopyvector( drs.num_rows, drs.dval, 1, dt.dval, 1, queue );
             magma_zaxpy( dt.num_rows, c_n_one, dr.dval, 1, dt.dval, 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( b.num_rows, b.num_rows ), 5*vbytes, queue );
 
             // t't
             // t'rs
+            tp = magma_perf_tic( &solver_par->perf, queue );
             tt = magma_zdotc( dt.num_rows, dt.dval, 1, dt.dval, 1, queue );
             tr = magma_zdotc( dt.num_rows, dt.dval, 1, drs.dval, 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( 2.*b.num_rows, 2.*b.num_rows ), 3*vbytes, queue );
 
             // gamma = (t' * rs) / (|t| * |t|)
             gamma = tr / tt;
 
             // rs = rs - gamma * (rs - r) 
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zaxpy( drs.num_rows, -gamma, dt.dval, 1, drs.dval, 1, queue );
 
             // xs = xs - gamma * (xs - x) 
             magma_zcopyvector( dxs.num_rows, dxs.dval, 1, dt.dval, 1, queue );
             magma_zaxpy( dt.num_rows, c_n_one, x->dval, 1, dt.dval, 1, queue );
             magma_zaxpy( dxs.num_rows, -gamma, dt.dval, 1, dxs.dval, 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 3.*b.num_rows, 3.*b.num_rows ), 11*vbytes, queue );
 
             // |rs|
+            tp = magma_perf_tic( &solver_par->perf, queue );
             nrmr = magma_dznrm2( b.num_rows, drs.dval, 1, queue );           
+            magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( b.num_rows ), vbytes, queue );
 //---------------------------------------
         }
 
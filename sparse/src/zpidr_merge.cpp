@@ -122,7 +122,11 @@ magma_zpidr_merge(
     magmaDoubleComplex *d1 = NULL, *d2 = NULL;
 
     // chronometry
-    real_Double_t tempo1, tempo2;
+    real_Double_t tempo1, tempo2, tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = b.num_rows * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) + 2 * vbytes;
 
     // initial s space
     // TODO: add option for 's' (shadow space number)
@@ -303,6 +307,7 @@ magma_zpidr_merge(
 
     om = MAGMA_Z_ONE;
     innerflag = 0;
+    magma_perf_reset( &solver_par->perf );
 
     // start iteration
     do
@@ -311,36 +316,47 @@ magma_zpidr_merge(
     
         // new RHS for small systems
         // f = P' r
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zgemvmdot_shfl( dP.num_rows, dP.num_cols, dP.dval, dr.dval, d1, d2, df.dval, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_ORTHO, tp, MAGMA_Z_PERF_FLOPS( dP.num_rows*s, dP.num_rows*s ), (s+1)*vbytes, queue );
 
         // shadow space loop
         for ( k = 0; k < s; ++k ) {
             sk = s - k;
     
             // c(k:s) = M(k:s,k:s) \ f(k:s)
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zcopyvector( sk, &df.dval[k], 1, &dc.dval[k], 1, queue );
             magma_ztrsv( MagmaLower, MagmaNoTrans, MagmaNonUnit, sk, &dM.dval[k*dM.ld+k], dM.ld, &dc.dval[k], 1, queue );
 
             // v = r - G(:,k:s) c(k:s)
             magma_zcopyvector( dr.num_rows, dr.dval, 1, dv.dval, 1, queue );
             magmablas_zgemv( MagmaNoTrans, dG.num_rows, sk, c_n_one, &dG.dval[k*dG.ld], dG.ld, &dc.dval[k], 1, c_one, dv.dval, 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_ORTHO, tp, MAGMA_Z_PERF_FLOPS( dG.num_rows*sk, dG.num_rows*sk ), (sk+3)*vbytes, queue );
 
             // preconditioning operation 
             // v = L \ v;
             // v = U \ v;
+            tp = magma_perf_tic( &solver_par->perf, queue );
             CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, dv, &dlu, precond_par, queue )); 
             CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, dlu, &dv, precond_par, queue )); 
+            magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0, 2*vbytes, queue );
             
             // U(:,k) = om * v + U(:,k:s) c(k:s)
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magmablas_zgemv( MagmaNoTrans, dU.num_rows, sk, c_one, &dU.dval[k*dU.ld], dU.ld, &dc.dval[k], 1, om, dv.dval, 1, queue );
             magma_zcopyvector( dU.num_rows, dv.dval, 1, &dU.dval[k*dU.ld], 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_ORTHO, tp, MAGMA_Z_PERF_FLOPS( dU.num_rows*(sk+1), dU.num_rows*sk ), (sk+4)*vbytes, queue );
 
             // G(:,k) = A U(:,k)
+            tp = magma_perf_tic( &solver_par->perf, queue );
             dGcol.dval = dG.dval + k * dG.ld;
             CHECK( magma_z_spmv( c_one, A, dv, c_zero, dGcol, queue ));
             solver_par->spmv_count++;
+            magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz, A.nnz ), spmv_bytes, queue );
 
             // bi-orthogonalize the new basis vectors
+            tp = magma_perf_tic( &solver_par->perf, queue );
             for ( i = 0; i < k; ++i ) {
                 // alpha = P(:,i)' G(:,k)
                 halpha.val[i] = magma_zdotc( dP.num_rows, &dP.dval[i*dP.ld], 1, &dG.dval[k*dG.ld], 1, queue );
@@ -359,11 +375,14 @@ magma_zpidr_merge(
                 magma_zsetvector( k, halpha.val, 1, dalpha.dval, 1, queue );
                 magmablas_zgemv( MagmaNoTrans, dU.num_rows, k, c_n_one, dU.dval, dU.ld, dalpha.dval, 1, c_one, &dU.dval[k*dU.ld], 1, queue );
             }
+            magma_perf_toc( &solver_par->perf, Magma_PERF_ORTHO, tp, MAGMA_Z_PERF_FLOPS( 3.*k*dP.num_rows, 3.*k*dP.num_rows ), (2+6.*k)*vbytes, queue );
 
             // new column of M = P'G, first k-1 entries are zero
             // M(k:s,k) = P(:,k:s)' G(:,k)
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zgemvmdot_shfl( dP.num_rows, sk, &dP.dval[k*dP.ld], &dG.dval[k*dG.ld], d1, d2, &dM.dval[k*dM.ld+k], queue );
             magma_zgetvector( 1, &dM.dval[k*dM.ld+k], 1, &hMdiag.val[k], 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_ORTHO, tp, MAGMA_Z_PERF_FLOPS( dP.num_rows*sk, dP.num_rows*sk ), (sk+1)*vbytes, queue );
 
             // check M(k,k) == 0
             if ( MAGMA_Z_EQUAL(hMdiag.val[k], MAGMA_Z_ZERO) ) {
@@ -384,39 +403,51 @@ magma_zpidr_merge(
             }
 
             // r = r - beta * G(:,k)
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zaxpy( dr.num_rows, -hbeta.val[k], &dG.dval[k*dG.ld], 1, dr.dval, 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( b.num_rows, b.num_rows ), 3*vbytes, queue );
 
             // smoothing disabled
             if ( smoothing <= 0 ) {
                 // |r|
+                tp = magma_perf_tic( &solver_par->perf, queue );
                 nrmr = magma_dznrm2( dr.num_rows, dr.dval, 1, queue );
+                magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( b.num_rows ), vbytes, queue );
 
             // smoothing enabled
             } else {
                 // x = x + beta * U(:,k)
+                tp = magma_perf_tic( &solver_par->perf, queue );
                 magma_zaxpy( x->num_rows, hbeta.val[k], &dU.dval[k*dU.ld], 1, x->dval, 1, queue );
 
                 // smoothing operation
 //---------------------------------------
                 // t = rs - r
                 magma_zidr_smoothing_1( drs.num_rows, drs.num_cols, drs.dval, dr.dval, dtt.dval, queue );
+                magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*b.num_rows, 2.*b.num_rows ), 6*vbytes, queue );
 
                 // t't
                 // t'rs
+                tp = magma_perf_tic( &solver_par->perf, queue );
                 CHECK( magma_zgemvmdot_shfl( dt.ld, 2, dtt.dval, dtt.dval, d1, d2, &dskp.dval[2], queue ));
                 magma_zgetvector( 2, &dskp.dval[2], 1, &hskp.val[2], 1, queue );
+                magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( 2.*b.num_rows, 2.*b.num_rows ), 2*vbytes, queue );
 
                 // gamma = (t' * rs) / (t' * t)
                 gamma = hskp.val[3] / hskp.val[2];
                 
                 // rs = rs - gamma * (rs - r) 
+                tp = magma_perf_tic( &solver_par->perf, queue );
                 magma_zaxpy( drs.num_rows, -gamma, dtt.dval, 1, drs.dval, 1, queue );
 
                 // xs = xs - gamma * (xs - x) 
                 magma_zidr_smoothing_2( dxs.num_rows, dxs.num_cols, -gamma, x->dval, dxs.dval, queue );
+                magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 3.*b.num_rows, 3.*b.num_rows ), 7*vbytes, queue );
 
                 // |rs|
+                tp = magma_perf_tic( &solver_par->perf, queue );
                 nrmr = magma_dznrm2( drs.num_rows, drs.dval, 1, queue );       
+                magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( b.num_rows ), vbytes, queue );
 //---------------------------------------
             }
 
@@ -451,8 +482,10 @@ magma_zpidr_merge(
         if ( smoothing <= 0 && innerflag != 1 ) {
             // update solution approximation x
             // x = x + U(:,1:s) * beta(1:s)
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zsetvector( s, hbeta.val, 1, dbeta.dval, 1, queue );
             magmablas_zgemv( MagmaNoTrans, dU.num_rows, s, c_one, dU.dval, dU.ld, dbeta.dval, 1, c_one, x->dval, 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dU.num_rows*s, dU.num_rows*s ), (s+2)*vbytes, queue );
         }
 
         // check convergence or iteration limit or invalid result of inner loop
@@ -461,24 +494,32 @@ magma_zpidr_merge(
         }
 
         // v = r
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zcopy( dr.num_rows, dr.dval, 1, dv.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, 0, 2*vbytes, queue );
 
         // preconditioning operation 
         // v = L \ v;
         // v = U \ v;
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, dv, &dlu, precond_par, queue )); 
         CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, dlu, &dv, precond_par, queue )); 
+        magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0, 2*vbytes, queue );
             
         // t = A v
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, dv, c_zero, dt, queue ));
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz, A.nnz ), spmv_bytes, queue );
 
         // computation of a new omega
 //---------------------------------------
         // t't
         // t'r 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_zgemvmdot_shfl( dt.ld, 2, dt.dval, dt.dval, d1, d2, dskp.dval, queue ));
         magma_zgetvector( 2, dskp.dval, 1, hskp.val, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( 2.*b.num_rows, 2.*b.num_rows ), 2*vbytes, queue );
 
         // |t| 
         nrmt = magma_dsqrt( MAGMA_Z_REAL(hskp.val[0]) );
@@ -499,40 +540,52 @@ magma_zpidr_merge(
 
         // update approximation vector
         // x = x + om * v
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zaxpy( x->num_rows, om, dv.dval, 1, x->dval, 1, queue );
 
         // update residual vector
         // r = r - om * t
         magma_zaxpy( dr.num_rows, -om, dt.dval, 1, dr.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*b.num_rows, 2.*b.num_rows ), 6*vbytes, queue );
 
         // smoothing disabled
         if ( smoothing <= 0 ) {
             // residual norm
+            tp = magma_perf_tic( &solver_par->perf, queue );
             nrmr = magma_dznrm2( dr.num_rows, dr.dval, 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( b.num_rows ), vbytes, queue );
 
         // smoothing enabled
         } else {
             // smoothing operation
 //---------------------------------------
             // t = rs - r
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zidr_smoothing_1( drs.num_rows, drs.num_cols, drs.dval, dr.dval, dtt.dval, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( b.num_rows, b.num_rows ), 3*vbytes, queue );
 
             // t't
             // t'rs
+            tp = magma_perf_tic( &solver_par->perf, queue );
             CHECK( magma_zgemvmdot_shfl( dt.ld, 2, dtt.dval, dtt.dval, d1, d2, &dskp.dval[2], queue ));
             magma_zgetvector( 2, &dskp.dval[2], 1, &hskp.val[2], 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( 2.*b.num_rows, 2.*b.num_rows ), 2*vbytes, queue );
 
             // gamma = (t' * rs) / (t' * t)
             gamma = hskp.val[3] / hskp.val[2];
 
             // rs = rs - gamma * (rs - r) 
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zaxpy( drs.num_rows, -gamma, dtt.dval, 1, drs.dval, 1, queue );
 
             // xs = xs - gamma * (xs - x) 
             magma_zidr_smoothing_2( dxs.num_rows, dxs.num_cols, -gamma, x->dval, dxs.dval, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 3.*b.num_rows, 3.*b.num_rows ), 7*vbytes, queue );
 
             // |rs|
+            tp = magma_perf_tic( &solver_par->perf, queue );
             nrmr = magma_dznrm2( drs.num_rows, drs.dval, 1, queue );           
+            magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( b.num_rows ), vbytes, queue );
 //---------------------------------------
         }
 
@@ -130,7 +130,11 @@ magma_zpidr_strms(
     magma_queue_t queues[nqueues];    
 
     // chronometry
-    real_Double_t tempo1, tempo2;
+    real_Double_t tempo1, tempo2, tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = b.num_rows * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) + 2 * vbytes;
 
     // create additional queues
     queues[0] = queue;
@@ -318,6 +322,9 @@ magma_zpidr_strms(
     om = MAGMA_Z_ONE;
     gamma = MAGMA_Z_ZERO;
     innerflag = 0;
+    // only the SpMV and the preconditioner are timed, on the queue they run
+    // on; the vector updates overlap on three queues and are not split up
+    magma_perf_reset( &solver_par->perf );
 
     // start iteration
     do
@@ -354,8 +361,10 @@ magma_zpidr_strms(
             // v = L \ v;
             // v = U \ v;
             // Q1
+            tp = magma_perf_tic( &solver_par->perf, queues[1] );
             CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, dv, &dlu, precond_par, queues[1] )); 
             CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, dlu, &dv, precond_par, queues[1] )); 
+            magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0, 2*vbytes, queues[1] );
 
             // sync Q0 --> U(:,k) = U(:,k) - U(:,1:k) * alpha(1:k)
             magma_queue_sync( queues[0] );
@@ -366,8 +375,10 @@ magma_zpidr_strms(
 
             // G(:,k) = A U(:,k)
             // Q1
+            tp = magma_perf_tic( &solver_par->perf, queues[1] );
             CHECK( magma_z_spmv( c_one, A, dv, c_zero, dGcol, queues[1] ));
             solver_par->spmv_count++;
+            magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz, A.nnz ), spmv_bytes, queues[1] );
 
             // bi-orthogonalize the new basis vectors
             for ( i = 0; i < k; ++i ) {
@@ -549,13 +560,17 @@ magma_zpidr_strms(
         // v = L \ v;
         // v = U \ v;
         // Q2
+        tp = magma_perf_tic( &solver_par->perf, queues[2] );
         CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, dv, &dlu, precond_par, queues[2] )); 
         CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, dlu, &dv, precond_par, queues[2] )); 
+        magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0, 2*vbytes, queues[2] );
 
         // t = A v
         // Q2
+        tp = magma_perf_tic( &solver_par->perf, queues[2] );
         CHECK( magma_z_spmv( c_one, A, dv, c_zero, dt, queues[2] ));
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz, A.nnz ), spmv_bytes, queues[2] );
 
         // computation of a new omega
 //---------------------------------------
@@ -0,0 +1,377 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+
+#define RTOLERANCE     lapackf77_dlamch( "E" )
+#define ATOLERANCE     lapackf77_dlamch( "E" )
+
+
+/*******************************************************************************
+    Purpose
+    -------
+
+    Solves a system of linear equations
+       A * X = B
+    where A is a complex Hermitian N-by-N positive definite matrix A.
+    This is a GPU implementation of the pipelined (preconditioned)
+    Conjugate Gradient method of Ghysels and Vanroose. The recurrences
+    for M w and A M w replace the SpMV and the preconditioner of the
+    classical PCG, so that the three dot products of one iteration are
+    computed in a single reduction, merged with the vector updates
+    (magma_zpipecg_update). The copy of the reduction result to the host
+    is asynchronous, and the preconditioner and SpMV of the next iteration
+    are issued before the host waits for it; this costs one additional
+    SpMV in the last iteration.
+
+    The recurrences let the recursively computed residual drift away from
+    the true residual b - A x. Following Sleijpen and van der Vorst, the
+    residual and the auxiliary vectors are recomputed from x and p
+    whenever the residual norm dropped by a factor sqrt(eps) since the
+    last replacement. The number of replacements and the largest gap
+    between recursive and true residual observed are returned in
+    solver_par->num_replace and solver_par->replace_res.
+
+    If precond_par->solver is Magma_NONE, the unpreconditioned variant is
+    used, which needs neither the preconditioned vectors nor their
+    storage.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b
+
+    @param[in,out]
+    x           magma_z_matrix*
+                solution approximation
+
+    @param[in,out]
+    solver_par  magma_z_solver_par*
+                solver parameters
+
+    @param[in]
+    precond_par magma_z_preconditioner*
+                preconditioner
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zposv
+*******************************************************************************/
+
+extern "C" magma_int_t
+magma_zpipecg(
+    magma_z_matrix A, magma_z_matrix b, magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue )
+{
+    magma_int_t info = MAGMA_NOTCONVERGED;
+
+    magma_int_t prec = ( precond_par->solver != Magma_NONE &&
+                         precond_par->solver != 0 );
+
+    // prepare solver feedback
+    solver_par->solver = ( prec ) ? Magma_PPIPECG : Magma_PIPECG;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+    solver_par->num_replace = 0;
+    solver_par->replace_res = 0.0;
+
+    // solver variables
+    magmaDoubleComplex alpha = MAGMA_Z_ZERO, beta = MAGMA_Z_ZERO, alphaold = MAGMA_Z_ONE;
+    magmaDoubleComplex gammanew, gammaold = MAGMA_Z_ONE, delta;
+    double nom0, r0, res, resmax, nomb, restrue, gap;
+    // replace the residual once it dropped by sqrt(eps)
+    double replace_tol = sqrt( lapackf77_dlamch( "E" ) );
+    // local variables
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE, c_neg_one = MAGMA_Z_NEG_ONE;
+
+    magma_int_t dofs = A.num_rows;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) + 2 * vbytes;
+
+    // GPU workspace
+    magma_z_matrix r={Magma_CSR}, u={Magma_CSR}, w={Magma_CSR}, m={Magma_CSR},
+                   nv={Magma_CSR}, z={Magma_CSR}, q={Magma_CSR}, s={Magma_CSR},
+                   p={Magma_CSR}, t={Magma_CSR};
+    magmaDoubleComplex_ptr d1=NULL, skp=NULL;
+    magmaDoubleComplex *skp_h=NULL;
+
+    CHECK( magma_zvinit( &r, Magma_DEV, A.num_rows, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &w, Magma_DEV, A.num_rows, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &nv,Magma_DEV, A.num_rows, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &z, Magma_DEV, A.num_rows, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &s, Magma_DEV, A.num_rows, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &p, Magma_DEV, A.num_rows, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &t, Magma_DEV, A.num_rows, 1, c_zero, queue ));
+    if ( prec ) {
+        CHECK( magma_zvinit( &u, Magma_DEV, A.num_rows, 1, c_zero, queue ));
+        CHECK( magma_zvinit( &m, Magma_DEV, A.num_rows, 1, c_zero, queue ));
+        CHECK( magma_zvinit( &q, Magma_DEV, A.num_rows, 1, c_zero, queue ));
+    } else {
+        // without preconditioner u = r, m = w, q = s
+        u = r;
+        m = w;
+        q = s;
+        u.ownership = MagmaFalse;
+        m.ownership = MagmaFalse;
+        q.ownership = MagmaFalse;
+    }
+    CHECK( magma_zmalloc( &d1, 3*magma_ceildiv( dofs, 256 ) ));
+    CHECK( magma_zmalloc( &skp, 3 ));
+    CHECK( magma_zmalloc_pinned( &skp_h, 3 ));
+
+    // solver setup
+    CHECK(  magma_zresidualvec( A, b, *x, &r, &nom0, queue));
+
+    // u = M r, w = A u
+    if ( prec ) {
+        CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, r, &t, precond_par, queue ));
+        CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, t, &u, precond_par, queue ));
+        CHECK( magma_z_spmv( c_one, A, u, c_zero, w, queue ));
+    } else {
+        CHECK( magma_z_spmv( c_one, A, r, c_zero, w, queue ));
+    }
+    solver_par->spmv_count++;
+    magma_zpipecg_dots( dofs, prec, r.dval, u.dval, w.dval, d1, skp, queue );
+    magma_zgetvector( 3, skp, 1, skp_h, 1, queue );
+    solver_par->init_res = nom0;
+
+    nomb = magma_dznrm2( dofs, b.dval, 1, queue );
+    if ( nomb == 0.0 ){
+        nomb=1.0;
+    }
+    if ( (r0 = nomb * solver_par->rtol) < ATOLERANCE ){
+        r0 = ATOLERANCE;
+    }
+    solver_par->final_res = solver_par->init_res;
+    solver_par->iter_res = solver_par->init_res;
+    if ( solver_par->verbose > 0 ) {
+        solver_par->res_vec[0] = (real_Double_t)nom0;
+        solver_par->timing[0] = 0.0;
+    }
+    if ( nom0 < r0 ) {
+        info = MAGMA_SUCCESS;
+        goto cleanup;
+    }
+    // check positive definite
+    if ( MAGMA_Z_ABS( skp_h[1] ) <= 0.0 ) {
+        info = MAGMA_NONSPD;
+        goto cleanup;
+    }
+
+    //Chronometry
+    real_Double_t tempo1, tempo2;
+    tempo1 = magma_sync_wtime( queue );
+
+    res = resmax = nom0;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+    magma_perf_reset( &solver_par->perf );
+
+    // m = M w, n = A m for the first iteration
+    if ( prec ) {
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, w, &t, precond_par, queue ));
+        CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, t, &m, precond_par, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0, 2*vbytes, queue );
+    }
+    tp = magma_perf_tic( &solver_par->perf, queue );
+    CHECK( magma_z_spmv( c_one, A, m, c_zero, nv, queue ));
+    solver_par->spmv_count++;
+    magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz, A.nnz ), spmv_bytes, queue );
+
+    // start iteration
+    do
+    {
+        gammanew = skp_h[0];                                 // gn = < r,u>
+        delta    = skp_h[1];                                 // delta = < w,u>
+
+        if ( solver_par->numiter == 0 ) {
+            beta  = c_zero;
+            alpha = gammanew / delta;
+        } else {
+            beta  = gammanew / gammaold;
+            alpha = gammanew / ( delta - beta * gammanew / alphaold );
+        }
+        if ( magma_z_isnan_inf( alpha ) ) {
+            info = MAGMA_DIVERGENCE;
+            break;
+        }
+        solver_par->numiter++;
+
+        // z = n + beta z, q = m + beta q, s = w + beta s, p = u + beta p,
+        // x = x + alpha p, r = r - alpha s, u = u - alpha q, w = w - alpha z
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        magma_zpipecg_update( dofs, prec, alpha, beta, m.dval, nv.dval, z.dval, q.dval,
+                              s.dval, p.dval, x->dval, r.dval, u.dval, w.dval,
+                              d1, skp, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( ( prec ? 11. : 9. )*dofs, ( prec ? 11. : 9. )*dofs ), ( prec ? 18 : 13 )*vbytes, queue );
+        gammaold = gammanew;
+        alphaold = alpha;
+
+        // the dot products are copied back asynchronously; m = M w and
+        // n = A m of the next iteration only depend on the updated w and
+        // are issued before the host waits for the reduction; the timed
+        // phases synchronize the queue, so the overlap is lost while the
+        // performance counters are enabled
+        magma_zgetvector_async( 3, skp, 1, skp_h, 1, queue );
+        if ( prec ) {
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, w, &t, precond_par, queue ));
+            CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, t, &m, precond_par, queue ));
+            magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0, 2*vbytes, queue );
+        }
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        CHECK( magma_z_spmv( c_one, A, m, c_zero, nv, queue ));
+        solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz, A.nnz ), spmv_bytes, queue );
+        magma_queue_sync( queue );
+
+        res = sqrt( MAGMA_Z_ABS( skp_h[2] ) );
+        if ( solver_par->verbose > 0 ) {
+            tempo2 = magma_sync_wtime( queue );
+            if ( (solver_par->numiter)%solver_par->verbose == 0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) res;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+
+        if ( res/nomb <= solver_par->rtol || res <= solver_par->atol ){
+            break;
+        }
+
+        // residual replacement
+        resmax = max( resmax, res );
+        if ( res <= replace_tol * resmax ) {
+            // t = b - A x, gap = || t - r ||, r = t
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            CHECK( magma_zresidualvec( A, b, *x, &t, &restrue, queue ));
+            magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz + dofs, A.nnz + dofs ) + MAGMA_Z_PERF_FLOPS_NRM2( dofs ), spmv_bytes + 3*vbytes, queue );
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            magma_zaxpy( dofs, c_neg_one, t.dval, 1, r.dval, 1, queue );
+            gap = magma_dznrm2( dofs, r.dval, 1, queue );
+            solver_par->replace_res = max( solver_par->replace_res, gap );
+            magma_zcopy( dofs, t.dval, 1, r.dval, 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ) + MAGMA_Z_PERF_FLOPS_NRM2( dofs ), 6*vbytes, queue );
+            // u = M r, w = A u, s = A p, q = M s, z = A q
+            if ( prec ) {
+                tp = magma_perf_tic( &solver_par->perf, queue );
+                CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, r, &t, precond_par, queue ));
+                CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, t, &u, precond_par, queue ));
+                magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0, 2*vbytes, queue );
+            }
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            CHECK( magma_z_spmv( c_one, A, u, c_zero, w, queue ));
+            magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz, A.nnz ), spmv_bytes, queue );
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            CHECK( magma_z_spmv( c_one, A, p, c_zero, s, queue ));
+            magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz, A.nnz ), spmv_bytes, queue );
+            if ( prec ) {
+                tp = magma_perf_tic( &solver_par->perf, queue );
+                CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, s, &t, precond_par, queue ));
+                CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, t, &q, precond_par, queue ));
+                magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0, 2*vbytes, queue );
+            }
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            CHECK( magma_z_spmv( c_one, A, q, c_zero, z, queue ));
+            magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz, A.nnz ), spmv_bytes, queue );
+            solver_par->spmv_count += 4;
+            solver_par->num_replace++;
+
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            magma_zpipecg_dots( dofs, prec, r.dval, u.dval, w.dval, d1, skp, queue );
+            magma_zgetvector( 3, skp, 1, skp_h, 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( 3.*dofs, 3.*dofs ), ( prec ? 3 : 2 )*vbytes, queue );
+            res = resmax = restrue;
+
+            // m = M w, n = A m from the replaced w
+            if ( prec ) {
+                tp = magma_perf_tic( &solver_par->perf, queue );
+                CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, w, &t, precond_par, queue ));
+                CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, t, &m, precond_par, queue ));
+                magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0, 2*vbytes, queue );
+            }
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            CHECK( magma_z_spmv( c_one, A, m, c_zero, nv, queue ));
+            solver_par->spmv_count++;
+            magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz, A.nnz ), spmv_bytes, queue );
+        }
+    }
+    while ( solver_par->numiter+1 <= solver_par->maxiter );
+
+    tempo2 = magma_sync_wtime( queue );
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    double residual;
+    CHECK(  magma_zresidualvec( A, b, *x, &t, &residual, queue));
+    solver_par->iter_res = res;
+    solver_par->final_res = residual;
+
+    if ( info == MAGMA_DIVERGENCE ) {
+        // keep
+    } else if ( solver_par->numiter < solver_par->maxiter ) {
+        info = MAGMA_SUCCESS;
+    } else if ( solver_par->init_res > solver_par->final_res ) {
+        if ( solver_par->verbose > 0 ) {
+            if ( (solver_par->numiter)%solver_par->verbose == 0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) res;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        info = MAGMA_SLOW_CONVERGENCE;
+        if( solver_par->iter_res < solver_par->rtol*nomb ||
+            solver_par->iter_res < solver_par->atol ) {
+            info = MAGMA_SUCCESS;
+        }
+    }
+    else {
+        if ( solver_par->verbose > 0 ) {
+            if ( (solver_par->numiter)%solver_par->verbose == 0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) res;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        info = MAGMA_DIVERGENCE;
+    }
+
+cleanup:
+    magma_zmfree(&r, queue );
+    magma_zmfree(&u, queue );
+    magma_zmfree(&w, queue );
+    magma_zmfree(&m, queue );
+    magma_zmfree(&nv, queue );
+    magma_zmfree(&z, queue );
+    magma_zmfree(&q, queue );
+    magma_zmfree(&s, queue );
+    magma_zmfree(&p, queue );
+    magma_zmfree(&t, queue );
+    magma_free( d1 );
+    magma_free( skp );
+    magma_free_pinned( skp_h );
+
+    solver_par->info = info;
+    return info;
+}   /* magma_zpipecg */
@@ -81,6 +81,12 @@ magma_zpqmr(
                         gamm = c_one, gamm1 = c_one, psi = c_one;
     
     magma_int_t dofs = A.num_rows* b.num_cols;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) * b.num_cols
+                        + 2 * vbytes;
 
     // need to transpose the matrix
     magma_z_matrix AT={Magma_CSR}, Ah1={Magma_CSR}, Ah2={Magma_CSR};
@@ -170,6 +176,7 @@ magma_zpqmr(
     tempo1 = magma_sync_wtime( queue );
     
     solver_par->numiter = 0;
+    magma_perf_reset( &solver_par->perf );
     // start iteration
     do
     {
@@ -179,7 +186,9 @@ magma_zpqmr(
             break;
         }
             // delta = z' * y;
+        tp = magma_perf_tic( &solver_par->perf, queue );
         delta = magma_zdotc( dofs, z.dval, 1, y.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
         if( magma_z_isnan_inf( delta ) ){
             info = MAGMA_DIVERGENCE;
             break;
@@ -187,10 +196,13 @@ magma_zpqmr(
             // no precond: yt = y, zt = z
         // magma_zcopy( dofs, y.dval, 1, yt.dval, 1, queue );
         // magma_zcopy( dofs, z.dval, 1, zt.dval, 1, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, y, &yt, precond_par, queue ));
         CHECK( magma_z_applyprecond_left( MagmaTrans, A, z, &zt, precond_par, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0.0, 4*vbytes, queue );
 
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         if( solver_par->numiter == 1 ){
                 // p = y;
                 // q = z;
@@ -207,15 +219,20 @@ magma_zpqmr(
             magma_zscal( dofs, -rde, q.dval, 1, queue );    
             magma_zaxpy( dofs, c_one, zt.dval, 1, q.dval, 1, queue );
         }
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 4.*dofs, 2.*dofs ), 10*vbytes, queue );
         if( magma_z_isnan_inf( rho ) || magma_z_isnan_inf( psi ) ){
             info = MAGMA_DIVERGENCE;
             break;
         }
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, p, c_zero, pt, queue ));
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
             // epsilon = q' * pt;
+        tp = magma_perf_tic( &solver_par->perf, queue );
         epsilon = magma_zdotc( dofs, q.dval, 1, pt.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
         beta = epsilon / delta;
 
         if( magma_z_isnan_inf( epsilon ) || magma_z_isnan_inf( beta ) ){
@@ -223,27 +240,37 @@ magma_zpqmr(
             break;
         }
             // vt = pt - beta * v;
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zcopy( dofs, v.dval, 1, vt.dval, 1, queue );
         magma_zscal( dofs, -beta, vt.dval, 1, queue ); 
         magma_zaxpy( dofs, c_one, pt.dval, 1, vt.dval, 1, queue ); 
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, dofs ), 7*vbytes, queue );
             // no precond: y = v
         //magma_zcopy( dofs, v.dval, 1, y.dval, 1, queue );
 
             // wt = A' * q - beta' * w;
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, AT, q, c_zero, wt, queue ));
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
         
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zaxpy( dofs, - MAGMA_Z_CONJ( beta ), w.dval, 1, wt.dval, 1, queue );  
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 3*vbytes, queue );
             // no precond: z = wt
         // magma_zcopy( dofs, wt.dval, 1, z.dval, 1, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_applyprecond_right( MagmaTrans, A, wt, &z, precond_par, queue ));
         
         CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, vt, &y, precond_par, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0.0, 4*vbytes, queue );
 
         rho1 = rho;      
             // rho = norm(y);
+        tp = magma_perf_tic( &solver_par->perf, queue );
         rho = magma_zsqrt( magma_zdotc( dofs, y.dval, 1, y.dval, 1, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
 
         thet1 = thet;        
         thet = rho / (gamm * MAGMA_Z_MAKE( MAGMA_Z_ABS(beta), 0.0 ));
@@ -256,6 +283,7 @@ magma_zpqmr(
             info = MAGMA_DIVERGENCE;
             break;
         }
+        tp = magma_perf_tic( &solver_par->perf, queue );
         if( solver_par->numiter == 1 ){
                 // d = eta * p;
                 // s = eta * pt;
@@ -281,10 +309,15 @@ magma_zpqmr(
                 // r = r - s;
             magma_zaxpy( dofs, -c_one, s.dval, 1, r.dval, 1, queue );
         }
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 6.*dofs, 4.*dofs ), 16*vbytes, queue );
             // psi = norm(z);
+        tp = magma_perf_tic( &solver_par->perf, queue );
         psi = magma_zsqrt( magma_zdotc( dofs, z.dval, 1, z.dval, 1, queue ) );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         res = magma_dznrm2( dofs, r.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( dofs ), vbytes, queue );
         
         if ( solver_par->verbose > 0 ) {
             tempo2 = magma_sync_wtime( queue );
@@ -300,6 +333,7 @@ magma_zpqmr(
         // y = y / rho
         // w = wt / psi
         // z = z / psi
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zqmr_8(  
         r.num_rows, 
         r.num_cols, 
@@ -312,6 +346,7 @@ magma_zpqmr(
         v.dval,
         w.dval,
         queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 4.*dofs, 0 ), 10*vbytes, queue );
 
         if ( res/nomb <= solver_par->rtol || res <= solver_par->atol ){
             break;
@@ -81,6 +81,12 @@ magma_zpqmr_merge(
                         gamm = c_one, gamm1 = c_one, psi = c_one;
     
     magma_int_t dofs = A.num_rows* b.num_cols;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) * b.num_cols
+                        + 2 * vbytes;
 
     // need to transpose the matrix
     magma_z_matrix AT={Magma_CSR}, Ah1={Magma_CSR}, Ah2={Magma_CSR};
@@ -176,6 +182,7 @@ magma_zpqmr_merge(
     tempo1 = magma_sync_wtime( queue );
     
     solver_par->numiter = 0;
+    magma_perf_reset( &solver_par->perf );
     // start iteration
     do
     {
@@ -185,7 +192,9 @@ magma_zpqmr_merge(
             break;
         }
             // delta = z' * y;
+        tp = magma_perf_tic( &solver_par->perf, queue );
         delta = magma_zdotc( dofs, z.dval, 1, y.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
         if( magma_z_isnan_inf( delta ) ){
             info = MAGMA_DIVERGENCE;
             break;
@@ -193,14 +202,18 @@ magma_zpqmr_merge(
             // no precond: yt = y, zt = z
         // magma_zcopy( dofs, y.dval, 1, yt.dval, 1, queue );
         // magma_zcopy( dofs, z.dval, 1, zt.dval, 1, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, y, &yt, precond_par, queue ));
         CHECK( magma_z_applyprecond_left( MagmaTrans, A, z, &zt, precond_par, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0.0, 4*vbytes, queue );
 
         
         if( solver_par->numiter == 1 ){
                 // p = y;
                 // q = z;
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zcopy( dofs, yt.dval, 1, p.dval, 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, 0, 4*vbytes, queue );
             magma_zcopy( dofs, zt.dval, 1, q.dval, 1, queue );
         }
         else{
@@ -208,6 +221,7 @@ magma_zpqmr_merge(
             rde = rho * MAGMA_Z_CONJ(delta/epsilon);
                 // p = yt - pde * p
                 // q = zt - rde * q
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zqmr_2(  
             r.num_rows, 
             r.num_cols, 
@@ -218,16 +232,21 @@ magma_zpqmr_merge(
             p.dval, 
             q.dval, 
             queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 6*vbytes, queue );
         }
         if( magma_z_isnan_inf( rho ) || magma_z_isnan_inf( psi ) ){
             info = MAGMA_DIVERGENCE;
             break;
         }
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, p, c_zero, pt, queue ));
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
             // epsilon = q' * pt;
+        tp = magma_perf_tic( &solver_par->perf, queue );
         epsilon = magma_zdotc( dofs, q.dval, 1, pt.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
         beta = epsilon / delta;
 
         if( magma_z_isnan_inf( epsilon ) || magma_z_isnan_inf( beta ) ){
@@ -235,6 +254,7 @@ magma_zpqmr_merge(
             break;
         }
             // vt = pt - beta * v;
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zqmr_7(  
         r.num_rows, 
         r.num_cols, 
@@ -243,21 +263,30 @@ magma_zpqmr_merge(
         v.dval,
         vt.dval,
         queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 3*vbytes, queue );
         
             // wt = A' * q - beta' * w;
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, AT, q, c_zero, wt, queue ));
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zaxpy( dofs, - MAGMA_Z_CONJ( beta ), w.dval, 1, wt.dval, 1, queue );  
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 3*vbytes, queue );
             // no precond: z = wt
         // magma_zcopy( dofs, wt.dval, 1, z.dval, 1, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_applyprecond_right( MagmaTrans, A, wt, &z, precond_par, queue ));
             // no precond: y = vt
         // magma_zcopy( dofs, vt.dval, 1, y.dval, 1, queue );
         CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, vt, &y, precond_par, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0.0, 4*vbytes, queue );
 
         rho1 = rho;      
             // rho = norm(y);
+        tp = magma_perf_tic( &solver_par->perf, queue );
         rho = magma_zsqrt( magma_zdotc( dofs, y.dval, 1, y.dval, 1, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), vbytes, queue );
         
         thet1 = thet;        
         thet = rho / (gamm * MAGMA_Z_MAKE( MAGMA_Z_ABS(beta), 0.0 ));
@@ -276,6 +305,7 @@ magma_zpqmr_merge(
                 // s = eta * pt + pds * d;
                 // x = x + d;
                 // r = r - s;
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zqmr_4(  
             r.num_rows, 
             r.num_cols, 
@@ -287,6 +317,7 @@ magma_zpqmr_merge(
             x->dval, 
             r.dval, 
             queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 10*vbytes, queue );
         }
         else{
                 // pds = (thet1 * gamm)^2;
@@ -295,6 +326,7 @@ magma_zpqmr_merge(
                 // s = eta * pt + pds * d;
                 // x = x + d;
                 // r = r - s;
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zqmr_5(  
             r.num_rows, 
             r.num_cols, 
@@ -307,11 +339,16 @@ magma_zpqmr_merge(
             x->dval, 
             r.dval, 
             queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 4.*dofs, 4.*dofs ), 10*vbytes, queue );
         }
             // psi = norm(z);
+        tp = magma_perf_tic( &solver_par->perf, queue );
         psi = magma_zsqrt( magma_zdotc( dofs, z.dval, 1, z.dval, 1, queue ) );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), vbytes, queue );
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         res = magma_dznrm2( dofs, r.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( dofs ), vbytes, queue );
         
         if ( solver_par->verbose > 0 ) {
             tempo2 = magma_sync_wtime( queue );
@@ -79,6 +79,12 @@ magma_zptfqmr_merge(
                         sigma = c_zero;
     
     magma_int_t dofs = A.num_rows* b.num_cols;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) * b.num_cols
+                        + 2 * vbytes;
 
     // GPU workspace
     magma_z_matrix r={Magma_CSR}, r_tld={Magma_CSR}, pu_m={Magma_CSR},
@@ -139,15 +145,19 @@ magma_zptfqmr_merge(
     
     solver_par->numiter = 0;
     solver_par->spmv_count = 0;
+    magma_perf_reset( &solver_par->perf );
     // start iteration
     do
     {
         solver_par->numiter++;
         
         // do this every iteration as unrolled
+        tp = magma_perf_tic( &solver_par->perf, queue );
         alpha = rho / magma_zdotc( dofs, v.dval, 1, r_tld.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
         sigma = theta * theta / alpha * eta; 
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_ztfqmr_1(  
         r.num_rows, 
         r.num_cols, 
@@ -162,8 +172,11 @@ magma_zptfqmr_merge(
         d.dval,
         Ad.dval,
         queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 4.*dofs, 4.*dofs ), 12*vbytes, queue );
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         theta = magma_zsqrt( magma_zdotc(dofs, w.dval, 1, w.dval, 1, queue) ) / tau;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), vbytes, queue );
         c = c_one / magma_zsqrt( c_one + theta*theta );
         tau = tau * theta *c;
         eta = c * c * alpha;
@@ -178,6 +191,7 @@ magma_zptfqmr_merge(
             break;
         }
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_ztfqmr_2(  
         r.num_rows, 
         r.num_cols, 
@@ -187,8 +201,11 @@ magma_zptfqmr_merge(
         x->dval, 
         r.dval, 
         queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 6*vbytes, queue );
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         res = magma_dznrm2( dofs, r.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( dofs ), vbytes, queue );
         
         if ( solver_par->verbose > 0 ) {
             tempo2 = magma_sync_wtime( queue );
@@ -206,15 +223,22 @@ magma_zptfqmr_merge(
         }
 
         // preconditioner
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, u_mp1, &t, precond_par, queue ));
         CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, t, &pu_m, precond_par, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0, 2*vbytes, queue );
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, pu_m, c_zero, Au_new, queue )); // Au_new = A u_mp1
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zcopy( dofs, Au_new.dval, 1, Au.dval, 1, queue );  
         magma_zcopy( dofs, u_mp1.dval, 1, u_m.dval, 1, queue );  
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, 0, 4*vbytes, queue );
 
         // here starts the second part of the loop #################################
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_ztfqmr_5(  
         r.num_rows, 
         r.num_cols, 
@@ -227,14 +251,18 @@ magma_zptfqmr_merge(
         d.dval,
         Ad.dval,
         queue ); 
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 4.*dofs, 4.*dofs ), 11*vbytes, queue );
         
         sigma = theta * theta / alpha * eta;  
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         theta = magma_zsqrt( magma_zdotc(dofs, w.dval, 1, w.dval, 1, queue) ) / tau;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), vbytes, queue );
         c = c_one / magma_zsqrt( c_one + theta*theta );
         tau = tau * theta *c;
         eta = c * c * alpha;
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_ztfqmr_2(  
         r.num_rows, 
         r.num_cols, 
@@ -244,8 +272,11 @@ magma_zptfqmr_merge(
         x->dval, 
         r.dval, 
         queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 6*vbytes, queue );
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         res = magma_dznrm2( dofs, r.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( dofs ), vbytes, queue );
         
         if ( solver_par->verbose > 0 ) {
             tempo2 = magma_sync_wtime( queue );
@@ -262,10 +293,13 @@ magma_zptfqmr_merge(
             break;
         }
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         rho = magma_zdotc( dofs, w.dval, 1, r_tld.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
         beta = rho / rho_l;
         rho_l = rho;
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_ztfqmr_3(  
         r.num_rows, 
         r.num_cols, 
@@ -274,14 +308,20 @@ magma_zptfqmr_merge(
         u_m.dval,
         u_mp1.dval, 
         queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 3*vbytes, queue );
               
         // preconditioner
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, u_mp1, &t, precond_par, queue ));
         CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, t, &pu_m, precond_par, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_PRECOND, tp, 0, 2*vbytes, queue );
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, pu_m, c_zero, Au_new, queue )); // Au_new = A pu_m
 
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_ztfqmr_4(  
         r.num_rows, 
         r.num_cols, 
@@ -290,8 +330,11 @@ magma_zptfqmr_merge(
         v.dval,
         Au.dval, 
         queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 4*vbytes, queue );
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zcopy( dofs, u_mp1.dval, 1, u_m.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, 0, 2*vbytes, queue );
     }
     while ( solver_par->numiter+1 <= solver_par->maxiter );
     
@@ -74,6 +74,12 @@ magma_zqmr_merge(
                         gamm = c_one, gamm1 = c_one, psi = c_one;
     
     magma_int_t dofs = A.num_rows* b.num_cols;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) * b.num_cols
+                        + 2 * vbytes;
 
     // need to transpose the matrix
     magma_z_matrix AT={Magma_CSR}, Ah1={Magma_CSR}, Ah2={Magma_CSR};
@@ -161,6 +167,7 @@ magma_zqmr_merge(
     
     solver_par->numiter = 0;
     solver_par->spmv_count = 0;
+    magma_perf_reset( &solver_par->perf );
     // start iteration
     do
     {
@@ -171,7 +178,9 @@ magma_zqmr_merge(
         }
  
             // delta = z' * y;
+        tp = magma_perf_tic( &solver_par->perf, queue );
         delta = magma_zdotc( dofs, z.dval, 1, y.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
         
         if( magma_z_isnan_inf( delta ) ){
             info = MAGMA_DIVERGENCE;
@@ -185,8 +194,10 @@ magma_zqmr_merge(
         if( solver_par->numiter == 1 ){
                 // p = y;
                 // q = z;
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zcopy( dofs, y.dval, 1, p.dval, 1, queue );
             magma_zcopy( dofs, z.dval, 1, q.dval, 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, 0, 4*vbytes, queue );
         }
         else{
             pde = psi * delta / epsilon;
@@ -194,6 +205,7 @@ magma_zqmr_merge(
             
                 // p = y - pde * p
                 // q = z - rde * q
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zqmr_2(  
             r.num_rows, 
             r.num_cols, 
@@ -204,16 +216,21 @@ magma_zqmr_merge(
             p.dval, 
             q.dval, 
             queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 6*vbytes, queue );
         }
         if( magma_z_isnan_inf( rho ) || magma_z_isnan_inf( psi ) ){
             info = MAGMA_DIVERGENCE;
             break;
         }
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, p, c_zero, pt, queue ));
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
             // epsilon = q' * pt;
+        tp = magma_perf_tic( &solver_par->perf, queue );
         epsilon = magma_zdotc( dofs, q.dval, 1, pt.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
         beta = epsilon / delta;
 
         if( magma_z_isnan_inf( epsilon ) || magma_z_isnan_inf( beta ) ){
@@ -222,6 +239,7 @@ magma_zqmr_merge(
         }
             // v = pt - beta * v
             // y = v
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zqmr_3(  
         r.num_rows, 
         r.num_cols, 
@@ -230,19 +248,26 @@ magma_zqmr_merge(
         v.dval,
         y.dval,
         queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 4*vbytes, queue );
         
         
         rho1 = rho;      
             // rho = norm(y);
+        tp = magma_perf_tic( &solver_par->perf, queue );
         rho = magma_zsqrt( magma_zdotc( dofs, y.dval, 1, y.dval, 1, queue ));
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), vbytes, queue );
         
             // wt = A' * q - beta' * w;
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, AT, q, c_zero, wt, queue ));
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zaxpy( dofs, - MAGMA_Z_CONJ( beta ), w.dval, 1, wt.dval, 1, queue );  
         
                     // no precond: z = wt
         magma_zcopy( dofs, wt.dval, 1, z.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 5*vbytes, queue );
         
 
 
@@ -263,6 +288,7 @@ magma_zqmr_merge(
                 // s = eta * pt + pds * d;
                 // x = x + d;
                 // r = r - s;
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zqmr_4(  
             r.num_rows, 
             r.num_cols, 
@@ -274,6 +300,7 @@ magma_zqmr_merge(
             x->dval, 
             r.dval, 
             queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 10*vbytes, queue );
         }
         else{
             pds = (thet1 * gamm) * (thet1 * gamm);
@@ -282,6 +309,7 @@ magma_zqmr_merge(
                 // s = eta * pt + pds * d;
                 // x = x + d;
                 // r = r - s;
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zqmr_5(  
             r.num_rows, 
             r.num_cols, 
@@ -294,11 +322,16 @@ magma_zqmr_merge(
             x->dval, 
             r.dval, 
             queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 4.*dofs, 4.*dofs ), 10*vbytes, queue );
         }
             // psi = norm(z);
+        tp = magma_perf_tic( &solver_par->perf, queue );
         psi = magma_zsqrt( magma_zdotc( dofs, z.dval, 1, z.dval, 1, queue ) );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), vbytes, queue );
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         res = magma_dznrm2( dofs, r.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( dofs ), vbytes, queue );
         
         if ( solver_par->verbose > 0 ) {
             tempo2 = magma_sync_wtime( queue );
@@ -0,0 +1,303 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+
+
+/**
+    Purpose
+    -------
+
+    Initializes an empty recycled subspace of dimension k for the recycling
+    solvers magma_zgcrodr and magma_zdefcg. The subspace is allocated by
+    the first solve and carried over to the following solves.
+
+    Arguments
+    ---------
+
+    @param[in]
+    k           magma_int_t
+                dimension of the recycled subspace
+
+    @param[out]
+    recycle     magma_z_recycle*
+                recycled subspace
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zrecycle_init(
+    magma_int_t k,
+    magma_z_recycle *recycle,
+    magma_queue_t queue )
+{
+    recycle->k = k;
+    recycle->num_vecs = 0;
+    recycle->ld = 0;
+    recycle->capacity = 0;
+    recycle->num_updates = 0;
+    recycle->dU = NULL;
+    recycle->dC = NULL;
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Frees the recycled subspace. The requested dimension k is kept, so the
+    structure can be used for a new sequence of linear systems.
+
+    Arguments
+    ---------
+
+    @param[in,out]
+    recycle     magma_z_recycle*
+                recycled subspace
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zrecycle_free(
+    magma_z_recycle *recycle,
+    magma_queue_t queue )
+{
+    magma_free( recycle->dU );
+    magma_free( recycle->dC );
+    recycle->dU = NULL;
+    recycle->dC = NULL;
+    recycle->num_vecs = 0;
+    recycle->ld = 0;
+    recycle->capacity = 0;
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Restores the invariant of the recycled subspace: C has orthonormal
+    columns and A U = C. With the Cholesky factor R of C^H C, C and U are
+    replaced by C R^{-1} and U R^{-1}; this is done twice (CholQR2).
+    If C is numerically rank deficient, the subspace is discarded.
+
+    Arguments
+    ---------
+
+    @param[in,out]
+    recycle     magma_z_recycle*
+                recycled subspace
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zrecycle_orthonormalize(
+    magma_z_recycle *recycle,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0, lapack_info = 0;
+    magma_int_t k = recycle->num_vecs, ld = recycle->ld;
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
+    magmaDoubleComplex *R=NULL;
+    magmaDoubleComplex_ptr dR=NULL;
+
+    if ( k == 0 ) {
+        goto cleanup;
+    }
+    CHECK( magma_zmalloc_cpu( &R, k*k ));
+    CHECK( magma_zmalloc( &dR, k*k ));
+
+    for( magma_int_t pass=0; pass < 2; pass++ ) {
+        magma_zgemm( MagmaConjTrans, MagmaNoTrans, k, k, ld,
+                     c_one, recycle->dC, ld, recycle->dC, ld, c_zero, dR, k, queue );
+        magma_zgetmatrix( k, k, dR, k, R, k, queue );
+        lapackf77_zpotrf( "U", &k, R, &k, &lapack_info );
+        if ( lapack_info != 0 ) {
+            recycle->num_vecs = 0;
+            goto cleanup;
+        }
+        for( magma_int_t j=0; j < k; j++ ) {
+            for( magma_int_t i=j+1; i < k; i++ ) {
+                R[ i + j*k ] = c_zero;
+            }
+        }
+        magma_zsetmatrix( k, k, R, k, dR, k, queue );
+        magma_ztrsm( MagmaRight, MagmaUpper, MagmaNoTrans, MagmaNonUnit,
+                     ld, k, c_one, dR, k, recycle->dC, ld, queue );
+        magma_ztrsm( MagmaRight, MagmaUpper, MagmaNoTrans, MagmaNonUnit,
+                     ld, k, c_one, dR, k, recycle->dU, ld, queue );
+    }
+
+cleanup:
+    magma_free_cpu( R );
+    magma_free( dR );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Stores a new recycled subspace: copies the n x num blocks U and C = A U
+    into the recycled subspace (allocating it if needed) and
+    orthonormalizes C. Used by the recycling solvers after each cycle.
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                number of rows
+
+    @param[in]
+    num         magma_int_t
+                number of vectors, num <= recycle->k
+
+    @param[in]
+    dU          magmaDoubleComplex_ptr
+                array of dimension lddu x num on the device
+
+    @param[in]
+    lddu        magma_int_t
+                leading dimension of dU
+
+    @param[in]
+    dC          magmaDoubleComplex_ptr
+                array of dimension lddc x num on the device, C = A U
+
+    @param[in]
+    lddc        magma_int_t
+                leading dimension of dC
+
+    @param[in,out]
+    recycle     magma_z_recycle*
+                recycled subspace
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zrecycle_store(
+    magma_int_t n,
+    magma_int_t num,
+    magmaDoubleComplex_ptr dU,
+    magma_int_t lddu,
+    magmaDoubleComplex_ptr dC,
+    magma_int_t lddc,
+    magma_z_recycle *recycle,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    // reallocate if n changed or k grew beyond the allocated columns
+    if ( recycle->ld != n || recycle->dU == NULL || recycle->k > recycle->capacity ) {
+        magma_zrecycle_free( recycle, queue );
+        CHECK( magma_zmalloc( &recycle->dU, n*recycle->k ));
+        CHECK( magma_zmalloc( &recycle->dC, n*recycle->k ));
+        recycle->ld = n;
+        recycle->capacity = recycle->k;
+    }
+    num = min( num, recycle->k );
+    magmablas_zlacpy( MagmaFull, n, num, dU, lddu, recycle->dU, n, queue );
+    magmablas_zlacpy( MagmaFull, n, num, dC, lddc, recycle->dC, n, queue );
+    recycle->num_vecs = num;
+    recycle->num_updates++;
+    CHECK( magma_zrecycle_orthonormalize( recycle, queue ));
+
+cleanup:
+    if ( info != 0 ) {
+        magma_zrecycle_free( recycle, queue );
+    }
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Adapts the recycled subspace to a new matrix A of a sequence of linear
+    systems: recomputes C = A U (num_vecs SpMVs) and orthonormalizes C.
+    Call this before the next solve whenever the matrix has changed;
+    a subspace of the wrong size is discarded.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                new system matrix
+
+    @param[in,out]
+    recycle     magma_z_recycle*
+                recycled subspace
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zrecycle_update(
+    magma_z_matrix A,
+    magma_z_recycle *recycle,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_z_matrix u_t={Magma_CSR}, c_t={Magma_CSR};
+
+    if ( recycle->num_vecs == 0 ) {
+        goto cleanup;
+    }
+    if ( recycle->ld != A.num_rows ) {
+        magma_zrecycle_free( recycle, queue );
+        goto cleanup;
+    }
+
+    u_t.memory_location = Magma_DEV;
+    u_t.num_rows = recycle->ld;
+    u_t.num_cols = 1;
+    u_t.storage_type = Magma_DENSE;
+    u_t.ownership = MagmaFalse;
+    c_t = u_t;
+    for( magma_int_t j=0; j < recycle->num_vecs; j++ ) {
+        u_t.dval = recycle->dU + j*recycle->ld;
+        c_t.dval = recycle->dC + j*recycle->ld;
+        CHECK( magma_z_spmv( MAGMA_Z_ONE, A, u_t, MAGMA_Z_ZERO, c_t, queue ));
+    }
+    CHECK( magma_zrecycle_orthonormalize( recycle, queue ));
+
+cleanup:
+    return info;
+}
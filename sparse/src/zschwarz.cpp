@@ -0,0 +1,689 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+/**
+    Purpose
+    -------
+
+    Incomplete LU factorization (IKJ variant) of a CPU CSR matrix in place,
+    restricted to the sparsity pattern of the matrix. The column indices of
+    each row have to be sorted, and A->list[i] has to point to the diagonal
+    element of row i. L has unit diagonal and is stored below, U on and
+    above the diagonal.
+
+    Arguments
+    ---------
+
+    @param[in,out]
+    A           magma_z_matrix*
+                matrix on the CPU, overwritten by the ILU factors
+
+    @param[in]
+    iw          magma_index_t*
+                workspace of size A->num_rows, all entries -1 on entry and exit
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+static magma_int_t
+magma_zschwarz_ilu(
+    magma_z_matrix *A,
+    magma_index_t *iw,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    for( magma_int_t i=0; i < A->num_rows; i++ ) {
+        for( magma_int_t j=A->row[i]; j < A->row[i+1]; j++ ) {
+            iw[ A->col[j] ] = j;
+        }
+        for( magma_int_t j=A->row[i]; j < A->list[i]; j++ ) {
+            magma_index_t k = A->col[j];
+            A->val[j] = A->val[j] / A->val[ A->list[k] ];
+            for( magma_int_t jj=A->list[k]+1; jj < A->row[k+1]; jj++ ) {
+                magma_index_t p = iw[ A->col[jj] ];
+                if ( p >= 0 ) {
+                    A->val[p] = A->val[p] - A->val[j] * A->val[jj];
+                }
+            }
+        }
+        for( magma_int_t j=A->row[i]; j < A->row[i+1]; j++ ) {
+            iw[ A->col[j] ] = -1;
+        }
+        if ( MAGMA_Z_ABS( A->val[ A->list[i] ] ) == 0.0 ) {
+            info = MAGMA_ERR_BADPRECOND;
+            break;
+        }
+    }
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Extracts and factors one subdomain of the Schwarz preconditioner: the
+    rows [start, end) are extended by `overlap` levels of the matrix graph,
+    and the principal submatrix of A for this index set is factored with
+    dense LU (partial pivoting) if it has at most bsize rows, and with
+    ILU(levels) otherwise.
+
+    On exit, loc->rowidx holds the global row indices (ascending),
+    loc->list the diagonal positions (CSR) or the pivots (DENSE), and
+    loc->diag a work vector of length loc->num_rows.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                system matrix in CSR on the CPU
+
+    @param[in]
+    start       magma_int_t
+                first row of the subdomain
+
+    @param[in]
+    end         magma_int_t
+                last row of the subdomain + 1
+
+    @param[in]
+    precond     magma_z_preconditioner*
+                overlap, levels, and bsize
+
+    @param[in]
+    mark        magma_index_t*
+                workspace of size A.num_rows, all entries -1 on entry and exit
+
+    @param[in]
+    idx         magma_index_t*
+                workspace of size A.num_rows
+
+    @param[out]
+    loc         magma_z_matrix*
+                factored subdomain matrix on the CPU
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+static magma_int_t
+magma_zschwarz_local(
+    magma_z_matrix A,
+    magma_int_t start,
+    magma_int_t end,
+    magma_z_preconditioner *precond,
+    magma_index_t *mark,
+    magma_index_t *idx,
+    magma_z_matrix *loc,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t m, nnz, lo, hi, ione = 1;
+    magma_int_t *ipiv = NULL;
+    magma_z_matrix L={Magma_CSR}, U={Magma_CSR};
+
+    // index set: core rows plus the overlap, mark[] holds the local index
+    m = 0;
+    for( magma_int_t i=start; i < end; i++ ) {
+        idx[m] = i;
+        mark[i] = m;
+        m++;
+    }
+    lo = 0;
+    hi = m;
+    for( magma_int_t lev=0; lev < precond->overlap; lev++ ) {
+        for( magma_int_t t=lo; t < hi; t++ ) {
+            magma_index_t g = idx[t];
+            for( magma_int_t j=A.row[g]; j < A.row[g+1]; j++ ) {
+                if ( mark[ A.col[j] ] < 0 ) {
+                    idx[m] = A.col[j];
+                    mark[ A.col[j] ] = m;
+                    m++;
+                }
+            }
+        }
+        lo = hi;
+        hi = m;
+    }
+    // ascending global order keeps the local rows sorted
+    if ( m > end-start ) {
+        CHECK( magma_zindexsort( idx, 0, m-1, queue ));
+    }
+    for( magma_int_t t=0; t < m; t++ ) {
+        mark[ idx[t] ] = t;
+    }
+
+    // principal submatrix in CSR, local column indices
+    loc->storage_type = Magma_CSR;
+    loc->memory_location = Magma_CPU;
+    loc->num_rows = m;
+    loc->num_cols = m;
+    nnz = 0;
+    for( magma_int_t t=0; t < m; t++ ) {
+        for( magma_int_t j=A.row[ idx[t] ]; j < A.row[ idx[t]+1 ]; j++ ) {
+            nnz += ( mark[ A.col[j] ] >= 0 );
+        }
+    }
+    loc->nnz = nnz;
+    CHECK( magma_index_malloc_cpu( &loc->row, m+1 ));
+    CHECK( magma_index_malloc_cpu( &loc->col, nnz ));
+    CHECK( magma_zmalloc_cpu( &loc->val, nnz ));
+    CHECK( magma_index_malloc_cpu( &loc->rowidx, m ));
+    CHECK( magma_zmalloc_cpu( &loc->diag, m ));
+    nnz = 0;
+    for( magma_int_t t=0; t < m; t++ ) {
+        loc->row[t] = nnz;
+        loc->rowidx[t] = idx[t];
+        for( magma_int_t j=A.row[ idx[t] ]; j < A.row[ idx[t]+1 ]; j++ ) {
+            magma_index_t c = mark[ A.col[j] ];
+            if ( c >= 0 ) {
+                // insertion sort, the rows of A are usually sorted already
+                magma_int_t p = nnz;
+                while ( p > loc->row[t] && loc->col[p-1] > c ) {
+                    loc->col[p] = loc->col[p-1];
+                    loc->val[p] = loc->val[p-1];
+                    p--;
+                }
+                loc->col[p] = c;
+                loc->val[p] = A.val[j];
+                nnz++;
+            }
+        }
+    }
+    loc->row[m] = nnz;
+    for( magma_int_t t=0; t < m; t++ ) {
+        mark[ idx[t] ] = -1;
+    }
+
+    if ( m <= precond->bsize ) {
+        // dense LU with partial pivoting
+        magmaDoubleComplex *D = NULL;
+        CHECK( magma_zmalloc_cpu( &D, m*m ));
+        for( magma_int_t k=0; k < m*m; k++ ) {
+            D[k] = MAGMA_Z_ZERO;
+        }
+        for( magma_int_t t=0; t < m; t++ ) {
+            for( magma_int_t j=loc->row[t]; j < loc->row[t+1]; j++ ) {
+                D[ t + loc->col[j]*m ] = loc->val[j];
+            }
+        }
+        magma_free_cpu( loc->val );
+        magma_free_cpu( loc->col );
+        magma_free_cpu( loc->row );
+        loc->val = D;
+        loc->col = NULL;
+        loc->row = NULL;
+        loc->storage_type = Magma_DENSE;
+        loc->major = MagmaColMajor;
+        loc->ld = m;
+        loc->nnz = m*m;
+
+        CHECK( magma_imalloc_cpu( &ipiv, m ));
+        CHECK( magma_index_malloc_cpu( &loc->list, m ));
+        lapackf77_zgetrf( &m, &m, loc->val, &m, ipiv, &info );
+        if ( info != 0 ) {
+            info = MAGMA_ERR_BADPRECOND;
+            goto cleanup;
+        }
+        for( magma_int_t t=0; t < m; t++ ) {
+            loc->list[t] = ipiv[t] - ione;
+        }
+    } else {
+        // ILU(levels) restricted to the symbolic fill pattern
+        if ( precond->levels > 0 ) {
+            CHECK( magma_zsymbilu( loc, precond->levels, &L, &U, queue ));
+            magma_zmfree( &L, queue );
+            magma_zmfree( &U, queue );
+            for( magma_int_t t=0; t < m; t++ ) {
+                for( magma_int_t j=loc->row[t]+1; j < loc->row[t+1]; j++ ) {
+                    magma_index_t c = loc->col[j];
+                    magmaDoubleComplex v = loc->val[j];
+                    magma_int_t p = j;
+                    while ( p > loc->row[t] && loc->col[p-1] > c ) {
+                        loc->col[p] = loc->col[p-1];
+                        loc->val[p] = loc->val[p-1];
+                        p--;
+                    }
+                    loc->col[p] = c;
+                    loc->val[p] = v;
+                }
+            }
+        }
+        CHECK( magma_index_malloc_cpu( &loc->list, m ));
+        for( magma_int_t t=0; t < m; t++ ) {
+            loc->list[t] = loc->row[t+1];
+            for( magma_int_t j=loc->row[t]; j < loc->row[t+1]; j++ ) {
+                if ( loc->col[j] >= t ) {
+                    loc->list[t] = j;
+                    break;
+                }
+            }
+            if ( loc->list[t] == loc->row[t+1] || loc->col[ loc->list[t] ] != t ) {
+                // structurally zero diagonal
+                info = MAGMA_ERR_BADPRECOND;
+                goto cleanup;
+            }
+        }
+        // idx is free again and serves as the ILU workspace
+        for( magma_int_t t=0; t < m; t++ ) {
+            idx[t] = -1;
+        }
+        CHECK( magma_zschwarz_ilu( loc, idx, queue ));
+    }
+
+cleanup:
+    magma_free_cpu( ipiv );
+    magma_zmfree( &L, queue );
+    magma_zmfree( &U, queue );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Prepares the restricted additive Schwarz (RAS) preconditioner
+
+        M^{-1} = sum_s R_s^T D_s A_s^{-1} R_s,
+
+    where the rows are split into precond->subdomains contiguous blocks
+    (one per OpenMP thread if 0), each block is extended by
+    precond->overlap levels of the matrix graph, A_s is the principal
+    submatrix of A for the extended block, and D_s restricts the update to
+    the rows owned by the subdomain. Each A_s is factored on the CPU in
+    parallel, with dense LU for subdomains up to precond->bsize rows and
+    ILU(precond->levels) otherwise.
+
+    The preconditioner is not symmetric; use it with GMRES, BiCGSTAB, etc.
+    Solvers that need M^{-T} (BiCG, QMR, LSQR) get it from
+    magma_zapplyschwarz_trans.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A
+
+    @param[in]
+    b           magma_z_matrix
+                input RHS b
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zschwarz_setup(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_z_matrix hA={Magma_CSR}, hAT={Magma_CSR};
+    magma_int_t n, nsub;
+
+    magma_zschwarzfree( precond, queue );
+
+    if ( A.num_rows != A.num_cols ) {
+        printf("%%  error: only supported for square matrices.\n");
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    // the subdomain solves run on the CPU
+    if ( A.memory_location != Magma_CPU || A.storage_type != Magma_CSR ) {
+        CHECK( magma_zmtransfer( A, &hAT, A.memory_location, Magma_CPU, queue ));
+        CHECK( magma_zmconvert( hAT, &hA, hAT.storage_type, Magma_CSR, queue ));
+        magma_zmfree( &hAT, queue );
+    } else {
+        CHECK( magma_zmtransfer( A, &hA, Magma_CPU, Magma_CPU, queue ));
+    }
+    n = hA.num_rows;
+
+    nsub = precond->subdomains;
+    if ( nsub <= 0 ) {
+        #ifdef _OPENMP
+        nsub = omp_get_max_threads();
+        #else
+        nsub = 1;
+        #endif
+    }
+    nsub = max( 1, min( nsub, n ));
+
+    CHECK( magma_imalloc_cpu( &precond->int_array_1, nsub+1 ));
+    for( magma_int_t s=0; s <= nsub; s++ ) {
+        precond->int_array_1[s] = (s*n) / nsub;
+    }
+    CHECK( magma_malloc_cpu( (void**) &precond->local, nsub*sizeof(magma_z_matrix) ));
+    for( magma_int_t s=0; s < nsub; s++ ) {
+        magma_z_matrix empty={Magma_CSR};
+        precond->local[s] = empty;
+    }
+    precond->num_local = nsub;
+    // host copies of the input (column 0) and output (column 1) vectors
+    CHECK( magma_zvinit( &precond->M, Magma_CPU, n, 2, MAGMA_Z_ZERO, queue ));
+
+    #pragma omp parallel
+    {
+        magma_int_t tinfo = 0;
+        magma_index_t *mark = NULL, *idx = NULL;
+        tinfo += magma_index_malloc_cpu( &mark, n );
+        tinfo += magma_index_malloc_cpu( &idx, n );
+        if ( tinfo == 0 ) {
+            for( magma_int_t i=0; i < n; i++ ) {
+                mark[i] = -1;
+            }
+        }
+        #pragma omp for schedule(dynamic,1)
+        for( magma_int_t s=0; s < nsub; s++ ) {
+            if ( tinfo == 0 ) {
+                tinfo = magma_zschwarz_local( hA, precond->int_array_1[s],
+                            precond->int_array_1[s+1], precond, mark, idx,
+                            &precond->local[s], queue );
+            }
+        }
+        if ( tinfo != 0 ) {
+            #pragma omp critical
+            info = tinfo;
+        }
+        magma_free_cpu( mark );
+        magma_free_cpu( idx );
+    }
+
+cleanup:
+    if ( info != 0 ) {
+        magma_zschwarzfree( precond, queue );
+    }
+    magma_zmfree( &hAT, queue );
+    magma_zmfree( &hA, queue );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Applies the restricted additive Schwarz preconditioner, x = M^{-1} b.
+    The vector is copied to the CPU, the subdomain solves run concurrently
+    (one subdomain per OpenMP task), and each subdomain writes only the rows
+    it owns.
+
+    Arguments
+    ---------
+
+    @param[in]
+    b           magma_z_matrix
+                input vector b
+
+    @param[in,out]
+    x           magma_z_matrix*
+                output vector x
+
+    @param[in]
+    precond     magma_z_preconditioner*
+                preconditioner
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zapplyschwarz(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t n = b.num_rows, nsub = precond->num_local;
+    magmaDoubleComplex *bh = precond->M.val, *xh = precond->M.val + n;
+    const magma_int_t *bound = precond->int_array_1;
+
+    if ( precond->local == NULL || precond->M.num_rows != n ) {
+        info = MAGMA_ERR_BADPRECOND;
+        goto cleanup;
+    }
+
+    magma_zgetvector( n, b.dval, 1, bh, 1, queue );
+
+    #pragma omp parallel for schedule(dynamic,1)
+    for( magma_int_t s=0; s < nsub; s++ ) {
+        magma_z_matrix *loc = &precond->local[s];
+        magmaDoubleComplex *w = loc->diag;
+        magma_int_t m = loc->num_rows, ione = 1;
+
+        for( magma_int_t i=0; i < m; i++ ) {
+            w[i] = bh[ loc->rowidx[i] ];
+        }
+        if ( loc->storage_type == Magma_DENSE ) {
+            for( magma_int_t i=0; i < m; i++ ) {
+                magmaDoubleComplex tmp = w[i];
+                w[i] = w[ loc->list[i] ];
+                w[ loc->list[i] ] = tmp;
+            }
+            blasf77_ztrsv( "L", "N", "U", &m, loc->val, &m, w, &ione );
+            blasf77_ztrsv( "U", "N", "N", &m, loc->val, &m, w, &ione );
+        } else {
+            for( magma_int_t i=0; i < m; i++ ) {
+                magmaDoubleComplex sum = w[i];
+                for( magma_int_t j=loc->row[i]; j < loc->list[i]; j++ ) {
+                    sum = sum - loc->val[j] * w[ loc->col[j] ];
+                }
+                w[i] = sum;
+            }
+            for( magma_int_t i=m-1; i >= 0; i-- ) {
+                magmaDoubleComplex sum = w[i];
+                for( magma_int_t j=loc->list[i]+1; j < loc->row[i+1]; j++ ) {
+                    sum = sum - loc->val[j] * w[ loc->col[j] ];
+                }
+                w[i] = sum / loc->val[ loc->list[i] ];
+            }
+        }
+        // restriction: only the rows owned by this subdomain
+        for( magma_int_t i=0; i < m; i++ ) {
+            magma_index_t g = loc->rowidx[i];
+            if ( g >= bound[s] && g < bound[s+1] ) {
+                xh[g] = w[i];
+            }
+        }
+    }
+
+    magma_zsetvector( n, xh, 1, x->dval, 1, queue );
+
+cleanup:
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Applies the transpose of the restricted additive Schwarz
+    preconditioner,
+
+        x = M^{-T} b = sum_s R_s^T A_s^{-T} D_s R_s b,
+
+    as needed by BiCG, QMR, and LSQR. Compared to magma_zapplyschwarz the
+    roles of restriction and prolongation are swapped: each subdomain takes
+    only the entries of b it owns, solves with the transposed local factors,
+    and adds the whole local solution, overlap included, to x. The local
+    solves run concurrently; the sums are formed afterwards.
+
+    Arguments
+    ---------
+
+    @param[in]
+    b           magma_z_matrix
+                input vector b
+
+    @param[in,out]
+    x           magma_z_matrix*
+                output vector x
+
+    @param[in]
+    precond     magma_z_preconditioner*
+                preconditioner
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zapplyschwarz_trans(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t n = b.num_rows, nsub = precond->num_local;
+    magmaDoubleComplex *bh = precond->M.val, *xh = precond->M.val + n;
+    const magma_int_t *bound = precond->int_array_1;
+
+    if ( precond->local == NULL || precond->M.num_rows != n ) {
+        info = MAGMA_ERR_BADPRECOND;
+        goto cleanup;
+    }
+
+    magma_zgetvector( n, b.dval, 1, bh, 1, queue );
+
+    #pragma omp parallel for schedule(dynamic,1)
+    for( magma_int_t s=0; s < nsub; s++ ) {
+        magma_z_matrix *loc = &precond->local[s];
+        magmaDoubleComplex *w = loc->diag;
+        magma_int_t m = loc->num_rows, ione = 1;
+
+        // restriction: only the rows owned by this subdomain
+        for( magma_int_t i=0; i < m; i++ ) {
+            magma_index_t g = loc->rowidx[i];
+            w[i] = ( g >= bound[s] && g < bound[s+1] ) ? bh[g] : MAGMA_Z_ZERO;
+        }
+        if ( loc->storage_type == Magma_DENSE ) {
+            // A_s = P^T L U, so A_s^{-T} = P^T L^{-T} U^{-T}
+            blasf77_ztrsv( "U", "T", "N", &m, loc->val, &m, w, &ione );
+            blasf77_ztrsv( "L", "T", "U", &m, loc->val, &m, w, &ione );
+            for( magma_int_t i=m-1; i >= 0; i-- ) {
+                magmaDoubleComplex tmp = w[i];
+                w[i] = w[ loc->list[i] ];
+                w[ loc->list[i] ] = tmp;
+            }
+        } else {
+            // U^T and L^T solves, column-oriented on the CSR factors
+            for( magma_int_t i=0; i < m; i++ ) {
+                w[i] = w[i] / loc->val[ loc->list[i] ];
+                for( magma_int_t j=loc->list[i]+1; j < loc->row[i+1]; j++ ) {
+                    w[ loc->col[j] ] = w[ loc->col[j] ] - loc->val[j] * w[i];
+                }
+            }
+            for( magma_int_t i=m-1; i >= 0; i-- ) {
+                for( magma_int_t j=loc->row[i]; j < loc->list[i]; j++ ) {
+                    w[ loc->col[j] ] = w[ loc->col[j] ] - loc->val[j] * w[i];
+                }
+            }
+        }
+    }
+
+    // prolongation: overlapping subdomains add up
+    for( magma_int_t i=0; i < n; i++ ) {
+        xh[i] = MAGMA_Z_ZERO;
+    }
+    for( magma_int_t s=0; s < nsub; s++ ) {
+        magma_z_matrix *loc = &precond->local[s];
+        for( magma_int_t i=0; i < loc->num_rows; i++ ) {
+            xh[ loc->rowidx[i] ] = xh[ loc->rowidx[i] ] + loc->diag[i];
+        }
+    }
+
+    magma_zsetvector( n, xh, 1, x->dval, 1, queue );
+
+cleanup:
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Frees the subdomain factors and the CPU workspace of the Schwarz
+    preconditioner.
+
+    Arguments
+    ---------
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zschwarzfree(
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    if ( precond->local != NULL ) {
+        for( magma_int_t s=0; s < precond->num_local; s++ ) {
+            magma_z_matrix *loc = &precond->local[s];
+            magma_free_cpu( loc->val );
+            magma_free_cpu( loc->row );
+            magma_free_cpu( loc->col );
+            magma_free_cpu( loc->rowidx );
+            magma_free_cpu( loc->list );
+            magma_free_cpu( loc->diag );
+        }
+        magma_free_cpu( precond->local );
+        magma_free_cpu( precond->int_array_1 );
+        magma_free_cpu( precond->M.val );
+        precond->M.val = NULL;
+    }
+    precond->local = NULL;
+    precond->int_array_1 = NULL;
+    precond->num_local = 0;
+    return MAGMA_SUCCESS;
+}
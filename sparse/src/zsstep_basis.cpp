@@ -0,0 +1,317 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+
+#define PRECISION_z
+
+
+/**
+    Purpose
+    -------
+
+    Computes the coefficients of the three-term recurrence
+        g[k] v(k+1) = A v(k) - a[k] v(k) - c[k] v(k-1),   k = 0, ..., s-1,
+    that generates the Krylov basis of the s-step solvers
+    (magma_zsstep_cg, magma_zsstep_gmres) from the Ritz values theta:
+
+    version = 0: Newton basis. The shifts a[k] are the first s Ritz values
+                 in Leja ordering; g[k] is half the spread of the Ritz
+                 values, c[k] = 0.
+    version = 1: Chebyshev basis for the interval spanned by the real parts
+                 of the Ritz values.
+    version = 2: monomial basis, a[k] = c[k] = 0, g[k] = 1.
+
+    Without Ritz values (ntheta = 0), the monomial basis is used.
+
+    Arguments
+    ---------
+
+    @param[in]
+    s           magma_int_t
+                number of basis vectors to generate
+
+    @param[in]
+    version     magma_int_t
+                basis type, see above
+
+    @param[in]
+    ntheta      magma_int_t
+                number of Ritz values
+
+    @param[in,out]
+    theta       magmaDoubleComplex*
+                array of dimension ntheta, the Ritz values;
+                on exit in Leja ordering if version = 0
+
+    @param[out]
+    a           magmaDoubleComplex*
+                array of dimension s
+
+    @param[out]
+    c           magmaDoubleComplex*
+                array of dimension s
+
+    @param[out]
+    g           magmaDoubleComplex*
+                array of dimension s
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zsstep_basis_param(
+    magma_int_t s,
+    magma_int_t version,
+    magma_int_t ntheta,
+    magmaDoubleComplex *theta,
+    magmaDoubleComplex *a,
+    magmaDoubleComplex *c,
+    magmaDoubleComplex *g,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    double lo, hi, spread = 0.0;
+
+    for( magma_int_t k=0; k < s; k++ ) {
+        a[k] = MAGMA_Z_ZERO;
+        c[k] = MAGMA_Z_ZERO;
+        g[k] = MAGMA_Z_ONE;
+    }
+    if ( ntheta <= 0 || version == 2 ) {
+        goto cleanup;
+    }
+
+    lo = hi = MAGMA_Z_REAL( theta[0] );
+    for( magma_int_t i=0; i < ntheta; i++ ) {
+        lo = min( lo, MAGMA_Z_REAL( theta[i] ));
+        hi = max( hi, MAGMA_Z_REAL( theta[i] ));
+        for( magma_int_t j=0; j < i; j++ ) {
+            spread = max( spread, MAGMA_Z_ABS( theta[i] - theta[j] ));
+        }
+    }
+
+    if ( version == 1 ) {
+        // scaled and shifted Chebyshev polynomials on [lo, hi]
+        double center = (hi + lo) / 2.0;
+        double width  = (hi - lo) / 2.0;
+        if ( width <= 0.0 ) {
+            width = max( MAGMA_D_ABS( center ), 1.0 );
+        }
+        for( magma_int_t k=0; k < s; k++ ) {
+            a[k] = MAGMA_Z_MAKE( center, 0.0 );
+            g[k] = MAGMA_Z_MAKE( (k == 0 ? width : width/2.0), 0.0 );
+            c[k] = MAGMA_Z_MAKE( (k == 0 ? 0.0   : width/2.0), 0.0 );
+        }
+    }
+    else {
+        // Leja ordering: start with the largest Ritz value, then add the
+        // one maximizing the product of distances to those chosen so far
+        // (sum of logarithms, to avoid overflow)
+        magma_int_t first = 0;
+        for( magma_int_t i=1; i < ntheta; i++ ) {
+            if ( MAGMA_Z_ABS( theta[i] ) > MAGMA_Z_ABS( theta[first] ) ) {
+                first = i;
+            }
+        }
+        magmaDoubleComplex tmp = theta[0];
+        theta[0] = theta[first];
+        theta[first] = tmp;
+        for( magma_int_t k=1; k < ntheta; k++ ) {
+            magma_int_t next = k;
+            double best = -1e300;
+            for( magma_int_t i=k; i < ntheta; i++ ) {
+                double logprod = 0.0;
+                for( magma_int_t j=0; j < k; j++ ) {
+                    double dist = MAGMA_Z_ABS( theta[i] - theta[j] );
+                    logprod += ( dist > 0.0 ) ? log( dist ) : -1e100;
+                }
+                if ( logprod > best ) {
+                    best = logprod;
+                    next = i;
+                }
+            }
+            tmp = theta[k];
+            theta[k] = theta[next];
+            theta[next] = tmp;
+        }
+        if ( spread <= 0.0 ) {
+            spread = max( MAGMA_Z_ABS( theta[0] ), 1.0 );
+        }
+        for( magma_int_t k=0; k < s; k++ ) {
+            a[k] = theta[ k % ntheta ];
+            g[k] = MAGMA_Z_MAKE( spread/2.0, 0.0 );
+        }
+    }
+
+cleanup:
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Generates the Krylov basis of the s-step solvers: given v(0), the
+    first column of V, computes
+        v(k+1) = ( A v(k) - a[k] v(k) - c[k] v(k-1) ) / g[k],
+    for k = 0, ..., s-1, with the coefficients of magma_zsstep_basis_param.
+    This needs s SpMVs.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                system matrix
+
+    @param[in]
+    s           magma_int_t
+                number of basis vectors to generate
+
+    @param[in]
+    a           magmaDoubleComplex*
+                array of dimension s
+
+    @param[in]
+    c           magmaDoubleComplex*
+                array of dimension s
+
+    @param[in]
+    g           magmaDoubleComplex*
+                array of dimension s
+
+    @param[in,out]
+    dV          magmaDoubleComplex_ptr
+                array of dimension lddv x (s+1) on the device;
+                on entry the first column is v(0)
+
+    @param[in]
+    lddv        magma_int_t
+                leading dimension of dV, lddv >= A.num_rows
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zsstep_basis(
+    magma_z_matrix A,
+    magma_int_t s,
+    magmaDoubleComplex *a,
+    magmaDoubleComplex *c,
+    magmaDoubleComplex *g,
+    magmaDoubleComplex_ptr dV,
+    magma_int_t lddv,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t dofs = A.num_rows;
+
+    magma_z_matrix v_t={Magma_CSR}, w_t={Magma_CSR};
+    v_t.memory_location = Magma_DEV;
+    v_t.num_rows = dofs;
+    v_t.num_cols = 1;
+    v_t.storage_type = Magma_DENSE;
+    v_t.ownership = MagmaFalse;
+    w_t = v_t;
+
+    for( magma_int_t k=0; k < s; k++ ) {
+        magmaDoubleComplex ginv = MAGMA_Z_ONE / g[k];
+        v_t.dval = dV + k*lddv;
+        w_t.dval = dV + (k+1)*lddv;
+        CHECK( magma_z_spmv( ginv, A, v_t, MAGMA_Z_ZERO, w_t, queue ));
+        if ( a[k] != MAGMA_Z_ZERO ) {
+            magma_zaxpy( dofs, -a[k]*ginv, v_t.dval, 1, w_t.dval, 1, queue );
+        }
+        if ( k > 0 && c[k] != MAGMA_Z_ZERO ) {
+            magma_zaxpy( dofs, -c[k]*ginv, dV + (k-1)*lddv, 1, w_t.dval, 1, queue );
+        }
+    }
+
+cleanup:
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Sets up the (s+1) x s change of basis matrix B with
+        A [ v(0), ..., v(s-1) ] = [ v(0), ..., v(s) ] B
+    for the basis generated by magma_zsstep_basis:
+    B(k,k) = a[k], B(k+1,k) = g[k], B(k-1,k) = c[k].
+
+    Arguments
+    ---------
+
+    @param[in]
+    s           magma_int_t
+                number of basis vectors
+
+    @param[in]
+    a           magmaDoubleComplex*
+                array of dimension s
+
+    @param[in]
+    c           magmaDoubleComplex*
+                array of dimension s
+
+    @param[in]
+    g           magmaDoubleComplex*
+                array of dimension s
+
+    @param[out]
+    B           magmaDoubleComplex*
+                array of dimension ldb x s; only the (s+1) x s leading
+                part is written
+
+    @param[in]
+    ldb         magma_int_t
+                leading dimension of B, ldb >= s+1
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zsstep_change_of_basis(
+    magma_int_t s,
+    magmaDoubleComplex *a,
+    magmaDoubleComplex *c,
+    magmaDoubleComplex *g,
+    magmaDoubleComplex *B,
+    magma_int_t ldb,
+    magma_queue_t queue )
+{
+    for( magma_int_t k=0; k < s; k++ ) {
+        for( magma_int_t i=0; i < s+1; i++ ) {
+            B[ i + k*ldb ] = MAGMA_Z_ZERO;
+        }
+        B[ k   + k*ldb ] = a[k];
+        B[ k+1 + k*ldb ] = g[k];
+        if ( k > 0 ) {
+            B[ k-1 + k*ldb ] = c[k];
+        }
+    }
+    return MAGMA_SUCCESS;
+}
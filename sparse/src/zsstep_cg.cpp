@@ -0,0 +1,414 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+
+#define PRECISION_z
+
+#define RTOLERANCE     lapackf77_dlamch( "E" )
+#define ATOLERANCE     lapackf77_dlamch( "E" )
+
+#define V(i)   (V.dval + (i)*dofs)
+#define G(i,j) (G[(i) + (j)*ldg])
+#define B(i,j) (B[(i) + (j)*ldg])
+
+
+// u^H G v for the Gram matrix G of dimension n
+static magmaDoubleComplex
+zsstep_gdot(
+    magma_int_t n,
+    const magmaDoubleComplex *G, magma_int_t ldg,
+    const magmaDoubleComplex *u,
+    const magmaDoubleComplex *v )
+{
+    magmaDoubleComplex sum = MAGMA_Z_ZERO;
+    for( magma_int_t j=0; j < n; j++ ) {
+        if ( v[j] == MAGMA_Z_ZERO ) {
+            continue;
+        }
+        magmaDoubleComplex Gv = MAGMA_Z_ZERO;
+        for( magma_int_t i=0; i < n; i++ ) {
+            Gv += MAGMA_Z_CONJ( u[i] ) * G(i,j);
+        }
+        sum += Gv * v[j];
+    }
+    return sum;
+}
+
+
+/*******************************************************************************
+    Purpose
+    -------
+
+    Solves a system of linear equations
+       A * X = B
+    where A is a complex Hermitian N-by-N positive definite matrix A.
+    This is a GPU implementation of the s-step (communication-avoiding)
+    Conjugate Gradient method (Chronopoulos and Gear; Carson and Demmel).
+
+    Every outer iteration generates the Krylov bases
+    P = [p, ..., p_s] of K_{s+1}(A,p) and R = [r, ..., r_{s-1}] of K_s(A,r)
+    with 2s-1 SpMVs and computes the blocked Gram matrix G = [P,R]^H [P,R]
+    with one GEMM, i.e., one global reduction. The s CG iterations are then
+    carried out on the host in the coordinates of [P,R], and x, r, p are
+    updated with one GEMM.
+
+    The basis is chosen by solver_par->version:
+    0 = Newton basis with Leja-ordered Ritz shifts (default),
+    1 = Chebyshev basis, 2 = monomial basis.
+    The Ritz values come from the Lanczos coefficients of the first 2s
+    iterations, which are run with s = 1.
+
+    The recursively updated residual is replaced by the true residual
+    b - A x whenever its norm dropped by a factor sqrt(eps) since the
+    last replacement. The number of replacements and the largest gap
+    between recursive and true residual observed are returned in
+    solver_par->num_replace and solver_par->replace_res.
+
+    The s-step length is solver_par->sstep. There is no preconditioned
+    version.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b
+
+    @param[in,out]
+    x           magma_z_matrix*
+                solution approximation
+
+    @param[in,out]
+    solver_par  magma_z_solver_par*
+                solver parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zposv
+*******************************************************************************/
+
+extern "C" magma_int_t
+magma_zsstep_cg(
+    magma_z_matrix A, magma_z_matrix b, magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_queue_t queue )
+{
+    magma_int_t info = MAGMA_NOTCONVERGED;
+
+    // prepare solver feedback
+    solver_par->solver = Magma_SSTEPCG;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+    solver_par->num_replace = 0;
+    solver_par->replace_res = 0.0;
+
+    magma_int_t dofs = A.num_rows;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) + 2 * vbytes;
+    magma_int_t s = max( 1, solver_par->sstep );
+    magma_int_t ldg = 2*s+1;
+    // the first nritz iterations run with s = 1 to get Ritz values
+    magma_int_t nritz = ( solver_par->version == 2 || s == 1 ) ? 0 : 2*s;
+    magma_int_t cur_s, nb, ilanczos = 0;
+
+    // solver variables
+    magmaDoubleComplex alpha, beta, den, rr, rrnew;
+    magmaDoubleComplex alphaold = MAGMA_Z_ONE, betaold = MAGMA_Z_ZERO;
+    double nom0, r0, res, resmax, nomb, restrue, gap;
+    double replace_tol = sqrt( lapackf77_dlamch( "E" ) );
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE, c_neg_one = MAGMA_Z_NEG_ONE;
+
+    // GPU workspace
+    magma_z_matrix r={Magma_CSR}, p={Magma_CSR}, t={Magma_CSR}, V={Magma_CSR}, Y={Magma_CSR};
+    magmaDoubleComplex_ptr dG=NULL, dC=NULL;
+    // CPU workspace
+    magmaDoubleComplex *G=NULL, *B=NULL, *C=NULL, *wc=NULL, *theta=NULL,
+                       *a=NULL, *c=NULL, *g=NULL, *a1=NULL, *c1=NULL, *g1=NULL;
+    magmaDoubleComplex *xc, *rc, *pc;
+    double *diag=NULL, *offdiag=NULL;
+
+    CHECK( magma_zvinit( &r, Magma_DEV, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &p, Magma_DEV, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &t, Magma_DEV, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &V, Magma_DEV, dofs*ldg, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &Y, Magma_DEV, dofs*3, 1, c_zero, queue ));
+    CHECK( magma_zmalloc( &dG, ldg*ldg ));
+    CHECK( magma_zmalloc( &dC, ldg*3 ));
+    CHECK( magma_zmalloc_cpu( &G, ldg*ldg ));
+    CHECK( magma_zmalloc_cpu( &B, ldg*ldg ));
+    CHECK( magma_zmalloc_cpu( &C, ldg*3 ));
+    CHECK( magma_zmalloc_cpu( &wc, ldg ));
+    CHECK( magma_zmalloc_cpu( &a, s ));
+    CHECK( magma_zmalloc_cpu( &c, s ));
+    CHECK( magma_zmalloc_cpu( &g, s ));
+    CHECK( magma_zmalloc_cpu( &a1, 1 ));
+    CHECK( magma_zmalloc_cpu( &c1, 1 ));
+    CHECK( magma_zmalloc_cpu( &g1, 1 ));
+    CHECK( magma_zmalloc_cpu( &theta, max( 1, nritz ) ));
+    CHECK( magma_dmalloc_cpu( &diag, max( 1, nritz ) ));
+    CHECK( magma_dmalloc_cpu( &offdiag, max( 1, nritz ) ));
+    xc = C;
+    rc = C + ldg;
+    pc = C + 2*ldg;
+
+    // s = 1 uses the monomial basis
+    magma_zsstep_basis_param( 1, 2, 0, theta, a1, c1, g1, queue );
+    magma_zsstep_basis_param( s, 2, 0, theta, a, c, g, queue );
+
+    // solver setup
+    CHECK( magma_zresidualvec( A, b, *x, &r, &nom0, queue ));
+    magma_zcopy( dofs, r.dval, 1, p.dval, 1, queue );
+    solver_par->init_res = nom0;
+
+    nomb = magma_dznrm2( dofs, b.dval, 1, queue );
+    if ( nomb == 0.0 ){
+        nomb=1.0;
+    }
+    if ( (r0 = nomb * solver_par->rtol) < ATOLERANCE ){
+        r0 = ATOLERANCE;
+    }
+    solver_par->final_res = solver_par->init_res;
+    solver_par->iter_res = solver_par->init_res;
+    if ( solver_par->verbose > 0 ) {
+        solver_par->res_vec[0] = (real_Double_t)nom0;
+        solver_par->timing[0] = 0.0;
+    }
+    if ( nom0 < r0 ) {
+        info = MAGMA_SUCCESS;
+        goto cleanup;
+    }
+
+    //Chronometry
+    real_Double_t tempo1, tempo2;
+    tempo1 = magma_sync_wtime( queue );
+
+    res = resmax = nom0;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+    magma_perf_reset( &solver_par->perf );
+    // start iteration
+    do
+    {
+        cur_s = ( ilanczos < nritz ) ? 1 : s;
+        nb = 2*cur_s + 1;
+        magmaDoubleComplex *ca = ( cur_s == 1 ) ? a1 : a;
+        magmaDoubleComplex *cc = ( cur_s == 1 ) ? c1 : c;
+        magmaDoubleComplex *cg = ( cur_s == 1 ) ? g1 : g;
+
+        // V = [P, R], P = [p, ..., p_s], R = [r, ..., r_{s-1}]
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        magma_zcopy( dofs, p.dval, 1, V(0), 1, queue );
+        magma_zcopy( dofs, r.dval, 1, V(cur_s+1), 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, 0, 4*vbytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        CHECK( magma_zsstep_basis( A, cur_s,   ca, cc, cg, V(0),       dofs, queue ));
+        CHECK( magma_zsstep_basis( A, cur_s-1, ca, cc, cg, V(cur_s+1), dofs, queue ));
+        solver_par->spmv_count += 2*cur_s - 1;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, (2*cur_s - 1) * MAGMA_Z_PERF_FLOPS( A.nnz + 2.*dofs, A.nnz + 2.*dofs ), (2*cur_s - 1) * ( spmv_bytes + 2*vbytes ), queue );
+
+        // blocked Gram matrix, the only global reduction of the s steps
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        magma_zgemm( MagmaConjTrans, MagmaNoTrans, nb, nb, dofs,
+                     c_one, V.dval, dofs, V.dval, dofs, c_zero, dG, ldg, queue );
+        magma_zgetmatrix( nb, nb, dG, ldg, G, ldg, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_ORTHO, tp, MAGMA_Z_PERF_FLOPS( (double) nb*nb*dofs, (double) nb*nb*dofs ), nb*vbytes, queue );
+
+        // change of basis: A [P(:,0:s-1), R(:,0:s-2)] = [P, R] B
+        for( magma_int_t i=0; i < ldg*nb; i++ ) {
+            B[i] = c_zero;
+        }
+        magma_zsstep_change_of_basis( cur_s, ca, cc, cg, &B(0,0), ldg, queue );
+        if ( cur_s > 1 ) {
+            magma_zsstep_change_of_basis( cur_s-1, ca, cc, cg, &B(cur_s+1,cur_s+1), ldg, queue );
+        }
+
+        // s CG iterations in the coordinates of [P, R]
+        for( magma_int_t i=0; i < 3*ldg; i++ ) {
+            C[i] = c_zero;
+        }
+        pc[0] = c_one;
+        rc[cur_s+1] = c_one;
+        rr = zsstep_gdot( nb, G, ldg, rc, rc );
+        for( magma_int_t j=0; j < cur_s; j++ ) {
+            // wc = B pc
+            for( magma_int_t i=0; i < nb; i++ ) {
+                wc[i] = c_zero;
+                for( magma_int_t k=0; k < nb; k++ ) {
+                    wc[i] += B(i,k) * pc[k];
+                }
+            }
+            den = zsstep_gdot( nb, G, ldg, pc, wc );
+            if ( MAGMA_Z_REAL( den ) <= 0.0 ) {
+                info = MAGMA_NONSPD;
+                break;
+            }
+            alpha = rr / den;
+            for( magma_int_t i=0; i < nb; i++ ) {
+                xc[i] += alpha * pc[i];
+                rc[i] -= alpha * wc[i];
+            }
+            rrnew = zsstep_gdot( nb, G, ldg, rc, rc );
+            beta = rrnew / rr;
+            for( magma_int_t i=0; i < nb; i++ ) {
+                pc[i] = rc[i] + beta * pc[i];
+            }
+            // Lanczos tridiagonal from the CG coefficients
+            if ( ilanczos < nritz ) {
+                diag[ilanczos] = 1.0 / MAGMA_Z_REAL( alpha );
+                if ( ilanczos > 0 ) {
+                    diag[ilanczos] += MAGMA_Z_REAL( betaold ) / MAGMA_Z_REAL( alphaold );
+                }
+                offdiag[ilanczos] = sqrt( MAGMA_Z_ABS( beta ) ) / MAGMA_Z_REAL( alpha );
+                alphaold = alpha;
+                betaold = beta;
+                ilanczos++;
+            }
+            rr = rrnew;
+            solver_par->numiter++;
+
+            res = sqrt( MAGMA_Z_ABS( rr ) );
+            if ( solver_par->verbose > 0 ) {
+                tempo2 = magma_sync_wtime( queue );
+                if ( (solver_par->numiter)%solver_par->verbose == 0 ) {
+                    solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                            = (real_Double_t) res;
+                    solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                            = (real_Double_t) tempo2-tempo1;
+                }
+            }
+            if ( res/nomb <= solver_par->rtol || res <= solver_par->atol ||
+                 solver_par->numiter+1 > solver_par->maxiter ) {
+                break;
+            }
+        }
+        if ( info == MAGMA_NONSPD ) {
+            break;
+        }
+
+        // [x_upd, r, p] = [P, R] [xc, rc, pc]
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        magma_zsetmatrix( nb, 3, C, ldg, dC, ldg, queue );
+        magma_zgemm( MagmaNoTrans, MagmaNoTrans, dofs, 3, nb,
+                     c_one, V.dval, dofs, dC, ldg, c_zero, Y.dval, dofs, queue );
+        magma_zaxpy( dofs, c_one, Y.dval, 1, x->dval, 1, queue );
+        magma_zcopy( dofs, Y.dval+dofs,   1, r.dval, 1, queue );
+        magma_zcopy( dofs, Y.dval+2*dofs, 1, p.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 3.*nb*dofs + dofs, 3.*nb*dofs + dofs ), (nb + 13)*vbytes, queue );
+
+        // switch to the Newton or Chebyshev basis
+        if ( nritz > 0 && ilanczos == nritz ) {
+            magma_int_t lapack_info;
+            lapackf77_dsterf( &nritz, diag, offdiag, &lapack_info );
+            if ( lapack_info == 0 ) {
+                for( magma_int_t i=0; i < nritz; i++ ) {
+                    theta[i] = MAGMA_Z_MAKE( diag[i], 0.0 );
+                }
+                magma_zsstep_basis_param( s, solver_par->version, nritz, theta, a, c, g, queue );
+            }
+            ilanczos++;
+        }
+
+        if ( res/nomb <= solver_par->rtol || res <= solver_par->atol ){
+            break;
+        }
+
+        // residual replacement
+        resmax = max( resmax, res );
+        if ( res <= replace_tol * resmax ) {
+            // t = b - A x, gap = || t - r ||, r = t
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            CHECK( magma_zresidualvec( A, b, *x, &t, &restrue, queue ));
+            magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz + dofs, A.nnz + dofs ) + MAGMA_Z_PERF_FLOPS_NRM2( dofs ), spmv_bytes + 3*vbytes, queue );
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            magma_zaxpy( dofs, c_neg_one, t.dval, 1, r.dval, 1, queue );
+            gap = magma_dznrm2( dofs, r.dval, 1, queue );
+            solver_par->replace_res = max( solver_par->replace_res, gap );
+            magma_zcopy( dofs, t.dval, 1, r.dval, 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ) + MAGMA_Z_PERF_FLOPS_NRM2( dofs ), 6*vbytes, queue );
+            solver_par->spmv_count++;
+            solver_par->num_replace++;
+            res = resmax = restrue;
+        }
+    }
+    while ( solver_par->numiter+1 <= solver_par->maxiter );
+
+    tempo2 = magma_sync_wtime( queue );
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    double residual;
+    CHECK(  magma_zresidualvec( A, b, *x, &t, &residual, queue));
+    solver_par->iter_res = res;
+    solver_par->final_res = residual;
+
+    if ( info == MAGMA_NONSPD ) {
+        // keep
+    } else if ( solver_par->numiter < solver_par->maxiter ) {
+        info = MAGMA_SUCCESS;
+    } else if ( solver_par->init_res > solver_par->final_res ) {
+        if ( solver_par->verbose > 0 ) {
+            if ( (solver_par->numiter)%solver_par->verbose == 0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) res;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        info = MAGMA_SLOW_CONVERGENCE;
+        if( solver_par->iter_res < solver_par->rtol*nomb ||
+            solver_par->iter_res < solver_par->atol ) {
+            info = MAGMA_SUCCESS;
+        }
+    }
+    else {
+        if ( solver_par->verbose > 0 ) {
+            if ( (solver_par->numiter)%solver_par->verbose == 0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) res;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        info = MAGMA_DIVERGENCE;
+    }
+
+cleanup:
+    magma_zmfree(&r, queue );
+    magma_zmfree(&p, queue );
+    magma_zmfree(&t, queue );
+    magma_zmfree(&V, queue );
+    magma_zmfree(&Y, queue );
+    magma_free( dG );
+    magma_free( dC );
+    magma_free_cpu( G );
+    magma_free_cpu( B );
+    magma_free_cpu( C );
+    magma_free_cpu( wc );
+    magma_free_cpu( a );
+    magma_free_cpu( c );
+    magma_free_cpu( g );
+    magma_free_cpu( a1 );
+    magma_free_cpu( c1 );
+    magma_free_cpu( g1 );
+    magma_free_cpu( theta );
+    magma_free_cpu( diag );
+    magma_free_cpu( offdiag );
+
+    solver_par->info = info;
+    return info;
+}   /* magma_zsstep_cg */
@@ -0,0 +1,480 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+
+#define PRECISION_z
+
+#define RTOLERANCE     lapackf77_dlamch( "E" )
+#define ATOLERANCE     lapackf77_dlamch( "E" )
+
+#define Q(i)    (Q.dval + (i)*dofs)
+#define HU(i,j) (Hu[(i) + (j)*ldh])
+#define HR(i,j) (Hr[(i) + (j)*ldh])
+#define RF(i,j) (Rf[(i) + (j)*ldh])
+
+
+static void
+GeneratePlaneRotation(magmaDoubleComplex dx, magmaDoubleComplex dy, magmaDoubleComplex *cs, magmaDoubleComplex *sn)
+{
+#if defined(PRECISION_s) | defined(PRECISION_d)
+    if (dy == MAGMA_Z_ZERO) {
+        *cs = MAGMA_Z_ONE;
+        *sn = MAGMA_Z_ZERO;
+    } else if (MAGMA_Z_ABS((dy)) > MAGMA_Z_ABS((dx))) {
+        magmaDoubleComplex temp = dx / dy;
+        *sn = MAGMA_Z_ONE / magma_zsqrt( ( MAGMA_Z_ONE + temp*temp));
+        *cs = temp * (*sn);
+    } else {
+        magmaDoubleComplex temp = dy / dx;
+        *cs = MAGMA_Z_ONE / magma_zsqrt( ( MAGMA_Z_ONE + temp*temp ));
+        *sn = temp * (*cs);
+    }
+#else
+    real_Double_t rho = sqrt(MAGMA_Z_REAL(MAGMA_Z_CONJ(dx)*dx + MAGMA_Z_CONJ(dy)*dy));
+    *cs = dx / rho;
+    *sn = dy / rho;
+#endif
+}
+
+static void ApplyPlaneRotation(magmaDoubleComplex *dx, magmaDoubleComplex *dy, magmaDoubleComplex cs, magmaDoubleComplex sn)
+{
+#if defined(PRECISION_s) | defined(PRECISION_d)
+    magmaDoubleComplex temp = (*dx);
+    *dx =  cs * (*dx) + sn * (*dy);
+    *dy = -sn * temp + cs * (*dy);
+#else
+    magmaDoubleComplex temp  =  MAGMA_Z_CONJ(cs) * (*dx) +  MAGMA_Z_CONJ(sn) * (*dy);
+    *dy = -(sn) * (*dx) + cs * (*dy);
+    *dx = temp;
+#endif
+}
+
+
+/**
+    Purpose
+    -------
+
+    Solves a system of linear equations
+       A * X = B
+    where A is a complex sparse matrix stored in the GPU memory.
+    X and B are complex vectors stored on the GPU memory.
+    This is a GPU implementation of the s-step (communication-avoiding)
+    GMRES of Hoemmen.
+
+    Every block of s Arnoldi steps generates s Krylov vectors with s SpMVs,
+    orthogonalizes them against the previous basis with block classical
+    Gram-Schmidt, run twice (BCGS2), and among themselves with CholQR, run
+    twice (CholQR2). Each of these is one GEMM with a blocked Gram matrix,
+    i.e., one global reduction, instead of the j+1 dot products of
+    step j of the classical Arnoldi process. The Hessenberg matrix is
+    recovered on the host from the R factors and the change of basis
+    matrix.
+
+    The basis is chosen by solver_par->version:
+    0 = Newton basis with Leja-ordered Ritz shifts (default),
+    1 = Chebyshev basis, 2 = monomial basis.
+    The Ritz values come from the Hessenberg matrix of the first restart
+    cycle, which is run with s = 1. In real arithmetic, the real parts of
+    the Ritz values are used as shifts.
+
+    The restart length solver_par->restart is rounded down to a multiple
+    of the s-step length solver_par->sstep. At every restart, the true
+    residual replaces the least-squares estimate; the number of
+    replacements and the largest difference between estimated and true
+    residual norm are returned in solver_par->num_replace and
+    solver_par->replace_res. There is no preconditioned version.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                descriptor for matrix A
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b vector
+
+    @param[in,out]
+    x           magma_z_matrix*
+                solution approximation
+
+    @param[in,out]
+    solver_par  magma_z_solver_par*
+                solver parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgesv
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zsstep_gmres(
+    magma_z_matrix A, magma_z_matrix b, magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_queue_t queue )
+{
+    magma_int_t info = MAGMA_NOTCONVERGED;
+
+    magma_int_t dofs = A.num_rows;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) + 2 * vbytes;
+
+    // prepare solver feedback
+    solver_par->solver = Magma_SSTEPGMRES;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+    solver_par->num_replace = 0;
+    solver_par->replace_res = 0.0;
+
+    //Chronometry
+    real_Double_t tempo1, tempo2;
+
+    magma_int_t s = max( 1, solver_par->sstep );
+    magma_int_t dim = max( s, (solver_par->restart / s) * s );
+    magma_int_t ldh = dim+1, ldb = s+1;
+    magma_int_t ione = 1, lwork = 11*dim, lapack_info;
+    magma_int_t i, j, k, cur_s, cycle = 0, fallback = 0, breakdown = 0;
+    // the first cycle runs with s = 1 to get Ritz values
+    magma_int_t ritz = ( solver_par->version != 2 && s > 1 );
+
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE, c_neg_one = MAGMA_Z_NEG_ONE;
+    double nom0, r0, res = 0.0, betanom, nomb;
+
+    magma_z_matrix r={Magma_CSR}, Q={Magma_CSR};
+    magmaDoubleComplex_ptr dC=NULL, dR=NULL, dy=NULL;
+    magmaDoubleComplex *Hu=NULL, *Hr=NULL, *Rf=NULL, *B=NULL, *C=NULL, *R=NULL, *Rw=NULL,
+                       *gvec=NULL, *cs=NULL, *sn=NULL, *Htmp=NULL, *theta=NULL, *work=NULL,
+                       *a=NULL, *c=NULL, *g=NULL, *a1=NULL, *c1=NULL, *g1=NULL;
+    magmaDoubleComplex *ca, *cc, *cg;
+    double *wi=NULL;
+
+    CHECK( magma_zvinit( &r, Magma_DEV, dofs, 1, c_zero, queue ));
+    CHECK( magma_zvinit( &Q, Magma_DEV, dofs*(dim+1), 1, c_zero, queue ));
+    CHECK( magma_zmalloc( &dC, ldh*s ));
+    CHECK( magma_zmalloc( &dR, s*s ));
+    CHECK( magma_zmalloc( &dy, dim ));
+    CHECK( magma_zmalloc_pinned( &Hu, ldh*dim ));
+    CHECK( magma_zmalloc_pinned( &Hr, ldh*dim ));
+    CHECK( magma_zmalloc_pinned( &Rf, ldh*(s+1) ));
+    CHECK( magma_zmalloc_pinned( &C,  ldh*s ));
+    CHECK( magma_zmalloc_pinned( &R,  s*s ));
+    CHECK( magma_zmalloc_pinned( &Rw, s*s ));
+    CHECK( magma_zmalloc_cpu( &B, ldb*s ));
+    CHECK( magma_zmalloc_cpu( &gvec, dim+1 ));
+    CHECK( magma_zmalloc_cpu( &cs, dim ));
+    CHECK( magma_zmalloc_cpu( &sn, dim ));
+    CHECK( magma_zmalloc_cpu( &Htmp, dim*dim ));
+    CHECK( magma_zmalloc_cpu( &theta, dim ));
+    CHECK( magma_zmalloc_cpu( &work, lwork ));
+    CHECK( magma_dmalloc_cpu( &wi, dim ));
+    CHECK( magma_zmalloc_cpu( &a, s ));
+    CHECK( magma_zmalloc_cpu( &c, s ));
+    CHECK( magma_zmalloc_cpu( &g, s ));
+    CHECK( magma_zmalloc_cpu( &a1, 1 ));
+    CHECK( magma_zmalloc_cpu( &c1, 1 ));
+    CHECK( magma_zmalloc_cpu( &g1, 1 ));
+
+    // s = 1 and the initial s-step basis are monomial
+    magma_zsstep_basis_param( 1, 2, 0, theta, a1, c1, g1, queue );
+    magma_zsstep_basis_param( s, 2, 0, theta, a, c, g, queue );
+
+    CHECK( magma_zresidualvec( A, b, *x, &r, &nom0, queue ));
+    nomb = magma_dznrm2( dofs, b.dval, 1, queue );
+    if ( nomb == 0.0 ){
+        nomb=1.0;
+    }
+    solver_par->init_res = nom0;
+    solver_par->final_res = solver_par->init_res;
+    solver_par->iter_res = solver_par->init_res;
+    if ( solver_par->verbose > 0 ) {
+        solver_par->res_vec[0] = (real_Double_t)nom0;
+        solver_par->timing[0] = 0.0;
+    }
+    if ( (r0 = nomb * solver_par->rtol) < ATOLERANCE ){
+        r0 = ATOLERANCE;
+    }
+    if ( nom0 < r0 ) {
+        info = MAGMA_SUCCESS;
+        goto cleanup;
+    }
+
+    tempo1 = magma_sync_wtime( queue );
+    betanom = res = nom0;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+    magma_perf_reset( &solver_par->perf );
+    do
+    {
+        if ( cycle > 0 ) {
+            // the true residual replaces the least-squares estimate
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            CHECK( magma_zresidualvec( A, b, *x, &r, &betanom, queue ));
+            solver_par->spmv_count++;
+            magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz + dofs, A.nnz + dofs ) + MAGMA_Z_PERF_FLOPS_NRM2( dofs ), spmv_bytes + 3*vbytes, queue );
+            solver_par->num_replace++;
+            solver_par->replace_res = max( solver_par->replace_res,
+                                           MAGMA_D_ABS( betanom - res ));
+            res = betanom;
+            if ( res/nomb <= solver_par->rtol || res <= solver_par->atol ) {
+                info = MAGMA_SUCCESS;
+                break;
+            }
+            if ( breakdown ) {
+                break;
+            }
+        }
+
+        // Q(0) = r / ||r||
+        tp = magma_perf_tic( &solver_par->perf, queue );
+        magma_zcopy( dofs, r.dval, 1, Q(0), 1, queue );
+        magma_zscal( dofs, MAGMA_Z_MAKE( 1.0/betanom, 0.0 ), Q(0), 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs, 0 ), 4*vbytes, queue );
+        for( i=0; i < dim+1; i++ ) {
+            gvec[i] = c_zero;
+        }
+        gvec[0] = MAGMA_Z_MAKE( betanom, 0.0 );
+        for( i=0; i < ldh*dim; i++ ) {
+            Hu[i] = c_zero;
+            Hr[i] = c_zero;
+        }
+
+        cur_s = ( ritz || fallback ) ? 1 : s;
+        ca = ( cur_s == 1 ) ? a1 : a;
+        cc = ( cur_s == 1 ) ? c1 : c;
+        cg = ( cur_s == 1 ) ? g1 : g;
+        magma_zsstep_change_of_basis( cur_s, ca, cc, cg, B, ldb, queue );
+
+        k = 0;
+        for( j=0; j < dim; j += cur_s ) {
+            // Q(j+1:j+s) = Krylov basis from Q(j)
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            CHECK( magma_zsstep_basis( A, cur_s, ca, cc, cg, Q(j), dofs, queue ));
+            solver_par->spmv_count += cur_s;
+            magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, cur_s * MAGMA_Z_PERF_FLOPS( A.nnz + 2.*dofs, A.nnz + 2.*dofs ), cur_s * ( spmv_bytes + 2*vbytes ), queue );
+
+            // BCGS2: Q(j+1:j+s) -= Q(0:j) C, C = Q(0:j)^H Q(j+1:j+s)
+            for( i=0; i < ldh*(s+1); i++ ) {
+                Rf[i] = c_zero;
+            }
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            for( magma_int_t pass=0; pass < 2; pass++ ) {
+                magma_zgemm( MagmaConjTrans, MagmaNoTrans, j+1, cur_s, dofs,
+                             c_one, Q(0), dofs, Q(j+1), dofs, c_zero, dC, ldh, queue );
+                magma_zgemm( MagmaNoTrans, MagmaNoTrans, dofs, cur_s, j+1,
+                             c_neg_one, Q(0), dofs, dC, ldh, c_one, Q(j+1), dofs, queue );
+                magma_zgetmatrix( j+1, cur_s, dC, ldh, C, ldh, queue );
+                for( magma_int_t jj=0; jj < cur_s; jj++ ) {
+                    for( i=0; i < j+1; i++ ) {
+                        RF(i,jj+1) += C[ i + jj*ldh ];
+                    }
+                }
+            }
+            magma_perf_toc( &solver_par->perf, Magma_PERF_ORTHO, tp, 2 * MAGMA_Z_PERF_FLOPS( 2.*dofs*(j+1)*cur_s, 2.*dofs*(j+1)*cur_s ), 2 * ( 2.*(j+1) + 3.*cur_s )*vbytes, queue );
+
+            // CholQR2: Q(j+1:j+s) = Q(j+1:j+s) Rw^{-1}
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            for( magma_int_t pass=0; pass < 2; pass++ ) {
+                magma_zgemm( MagmaConjTrans, MagmaNoTrans, cur_s, cur_s, dofs,
+                             c_one, Q(j+1), dofs, Q(j+1), dofs, c_zero, dR, cur_s, queue );
+                magma_zgetmatrix( cur_s, cur_s, dR, cur_s, R, cur_s, queue );
+                lapackf77_zpotrf( MagmaUpperStr, &cur_s, R, &cur_s, &lapack_info );
+                if ( lapack_info != 0 ) {
+                    break;
+                }
+                for( magma_int_t jj=0; jj < cur_s; jj++ ) {
+                    for( i=jj+1; i < cur_s; i++ ) {
+                        R[ i + jj*cur_s ] = c_zero;
+                    }
+                }
+                magma_zsetmatrix( cur_s, cur_s, R, cur_s, dR, cur_s, queue );
+                magma_ztrsm( MagmaRight, MagmaUpper, MagmaNoTrans, MagmaNonUnit,
+                             dofs, cur_s, c_one, dR, cur_s, Q(j+1), dofs, queue );
+                if ( pass == 0 ) {
+                    lapackf77_zlacpy( MagmaFullStr, &cur_s, &cur_s, R, &cur_s, Rw, &cur_s );
+                } else {
+                    blasf77_ztrmm( MagmaLeftStr, MagmaUpperStr, MagmaNoTransStr, MagmaNonUnitStr,
+                                   &cur_s, &cur_s, &c_one, R, &cur_s, Rw, &cur_s );
+                }
+            }
+            magma_perf_toc( &solver_par->perf, Magma_PERF_ORTHO, tp, 2 * MAGMA_Z_PERF_FLOPS( 1.5*dofs*cur_s*cur_s, 1.5*dofs*cur_s*cur_s ), 6.*cur_s*vbytes, queue );
+            if ( lapack_info != 0 ) {
+                // the basis block is numerically rank deficient: keep the
+                // columns so far and continue with s = 1; for s = 1, the
+                // Krylov space is invariant
+                if ( cur_s > 1 ) {
+                    fallback = 1;
+                } else {
+                    breakdown = 1;
+                }
+                break;
+            }
+
+            // [Q(j), Q(j+1:j+s)] = Q(0:j+s) Rf
+            RF(j,0) = c_one;
+            for( magma_int_t jj=0; jj < cur_s; jj++ ) {
+                for( i=0; i <= jj; i++ ) {
+                    RF(j+1+i,jj+1) = Rw[ i + jj*cur_s ];
+                }
+            }
+
+            // H(:,j:j+s-1) = ( Rf B - [ H(0:j,0:j-1) Rf(0:j-1,0:s-1); 0 ] ) T^{-1},
+            // T = Rf(j:j+s-1,0:s-1) upper triangular
+            magma_int_t rows = j+1+cur_s, sp1 = cur_s+1;
+            blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &rows, &cur_s, &sp1,
+                           &c_one, Rf, &ldh, B, &ldb, &c_zero, &HU(0,j), &ldh );
+            if ( j > 0 ) {
+                magma_int_t jp1 = j+1;
+                blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &jp1, &cur_s, &j,
+                               &c_neg_one, Hu, &ldh, Rf, &ldh, &c_one, &HU(0,j), &ldh );
+            }
+            blasf77_ztrsm( MagmaRightStr, MagmaUpperStr, MagmaNoTransStr, MagmaNonUnitStr,
+                           &rows, &cur_s, &c_one, &RF(j,0), &ldh, &HU(0,j), &ldh );
+
+            // least-squares problem, one Givens rotation per column
+            for( i=j; i < j+cur_s; i++ ) {
+                for( magma_int_t ii=0; ii <= i+1; ii++ ) {
+                    HR(ii,i) = HU(ii,i);
+                }
+                for( magma_int_t kk=0; kk < i; kk++ ) {
+                    ApplyPlaneRotation( &HR(kk,i), &HR(kk+1,i), cs[kk], sn[kk] );
+                }
+                GeneratePlaneRotation( HR(i,i), HR(i+1,i), &cs[i], &sn[i] );
+                ApplyPlaneRotation( &HR(i,i), &HR(i+1,i), cs[i], sn[i] );
+                ApplyPlaneRotation( &gvec[i], &gvec[i+1], cs[i], sn[i] );
+
+                solver_par->numiter++;
+                k = i+1;
+                res = MAGMA_Z_ABS( gvec[i+1] );
+                if ( solver_par->verbose > 0 ) {
+                    tempo2 = magma_sync_wtime( queue );
+                    if ( (solver_par->numiter)%solver_par->verbose==0 ) {
+                        solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                                = (real_Double_t) res;
+                        solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                                = (real_Double_t) tempo2-tempo1;
+                    }
+                }
+                if ( res/nomb <= solver_par->rtol || res <= solver_par->atol ||
+                     solver_par->numiter+1 > solver_par->maxiter ) {
+                    break;
+                }
+            }
+            if ( i < j+cur_s ) {
+                break;
+            }
+        }
+
+        // solve upper triangular system in place, x = x + Q y
+        if ( k > 0 ) {
+            for( j=k-1; j >= 0; j-- ) {
+                gvec[j] /= HR(j,j);
+                for( i=j-1; i >= 0; i-- ) {
+                    gvec[i] -= HR(i,j) * gvec[j];
+                }
+            }
+            tp = magma_perf_tic( &solver_par->perf, queue );
+            magma_zsetvector( k, gvec, 1, dy, 1, queue );
+            magma_zgemv( MagmaNoTrans, dofs, k, c_one, Q(0), dofs, dy, 1,
+                         c_one, x->dval, 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs*k, dofs*k ), (k + 2)*vbytes, queue );
+        }
+
+        // Ritz values of the first cycle for the Newton or Chebyshev basis
+        if ( ritz && k > 0 ) {
+            lapackf77_zlacpy( MagmaFullStr, &k, &k, Hu, &ldh, Htmp, &k );
+            #if defined(PRECISION_z) || defined(PRECISION_c)
+            lapackf77_zhseqr( "E", "N", &k, &ione, &k, Htmp, &k, theta,
+                              NULL, &ione, work, &lwork, &lapack_info );
+            #else
+            lapackf77_zhseqr( "E", "N", &k, &ione, &k, Htmp, &k, theta, wi,
+                              NULL, &ione, work, &lwork, &lapack_info );
+            #endif
+            if ( lapack_info == 0 ) {
+                magma_zsstep_basis_param( s, solver_par->version, k, theta, a, c, g, queue );
+            }
+            ritz = 0;
+        }
+        cycle++;
+    }
+    while ( solver_par->numiter+1 <= solver_par->maxiter );
+
+    tempo2 = magma_sync_wtime( queue );
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    double residual;
+    CHECK( magma_zresidual( A, b, *x, &residual, queue ));
+    solver_par->iter_res = res;
+    solver_par->final_res = residual;
+
+    if ( solver_par->numiter < solver_par->maxiter && info == MAGMA_SUCCESS ) {
+        info = MAGMA_SUCCESS;
+    } else if ( solver_par->init_res > solver_par->final_res ) {
+        if ( solver_par->verbose > 0 ) {
+            if ( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) res;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        info = MAGMA_SLOW_CONVERGENCE;
+        if( solver_par->iter_res < solver_par->rtol*nomb ||
+            solver_par->iter_res < solver_par->atol ) {
+            info = MAGMA_SUCCESS;
+        }
+    }
+    else {
+        if ( solver_par->verbose > 0 ) {
+            if ( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) res;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        info = MAGMA_DIVERGENCE;
+    }
+
+cleanup:
+    magma_zmfree( &r, queue );
+    magma_zmfree( &Q, queue );
+    magma_free( dC );
+    magma_free( dR );
+    magma_free( dy );
+    magma_free_pinned( Hu );
+    magma_free_pinned( Hr );
+    magma_free_pinned( Rf );
+    magma_free_pinned( C );
+    magma_free_pinned( R );
+    magma_free_pinned( Rw );
+    magma_free_cpu( B );
+    magma_free_cpu( gvec );
+    magma_free_cpu( cs );
+    magma_free_cpu( sn );
+    magma_free_cpu( Htmp );
+    magma_free_cpu( theta );
+    magma_free_cpu( work );
+    magma_free_cpu( wi );
+    magma_free_cpu( a );
+    magma_free_cpu( c );
+    magma_free_cpu( g );
+    magma_free_cpu( a1 );
+    magma_free_cpu( c1 );
+    magma_free_cpu( g1 );
+
+    solver_par->info = info;
+    return info;
+}   /* magma_zsstep_gmres */
@@ -74,6 +74,12 @@ magma_ztfqmr(
                         sigma = c_zero;
     
     magma_int_t dofs = A.num_rows* b.num_cols;
+    real_Double_t tp;
+
+    // estimated traffic per call for the performance counters
+    double vbytes = dofs * sizeof(magmaDoubleComplex);
+    double spmv_bytes = A.nnz * (sizeof(magmaDoubleComplex) + sizeof(magma_index_t)) * b.num_cols
+                        + 2 * vbytes;
     
     // magma_int_t stag = 0;
 
@@ -130,24 +136,33 @@ magma_ztfqmr(
     
     solver_par->numiter = 0;
     solver_par->spmv_count = 0;
+    magma_perf_reset( &solver_par->perf );
     // start iteration
     do
     {
         solver_par->numiter++;
         if( solver_par->numiter%2 == 1 ){
+            tp = magma_perf_tic( &solver_par->perf, queue );
             alpha = rho / magma_zdotc( dofs, v.dval, 1, r_tld.dval, 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zcopy( dofs, u_m.dval, 1, u_mp1.dval, 1, queue );   
             magma_zaxpy( dofs,  -alpha, v.dval, 1, u_mp1.dval, 1, queue );     // u_mp1 = u_m - alpha*v;
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 5*vbytes, queue );
         }
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zaxpy( dofs,  -alpha, Au.dval, 1, w.dval, 1, queue );     // w = w - alpha*Au;
         sigma = theta * theta / alpha * eta;    
         magma_zscal( dofs, sigma, d.dval, 1, queue );    
         magma_zaxpy( dofs, c_one, pu_m.dval, 1, d.dval, 1, queue );     // d = pu_m + sigma*d;
         magma_zscal( dofs, sigma, Ad.dval, 1, queue );         
         magma_zaxpy( dofs, c_one, Au.dval, 1, Ad.dval, 1, queue );     // Ad = Au + sigma*Ad;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 5.*dofs, 3.*dofs ), 13*vbytes, queue );
 
         
+        tp = magma_perf_tic( &solver_par->perf, queue );
         theta = magma_zsqrt( magma_zdotc(dofs, w.dval, 1, w.dval, 1, queue) ) / tau;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
         c = c_one / magma_zsqrt( c_one + theta*theta );
         tau = tau * theta *c;
         eta = c * c * alpha;
@@ -161,9 +176,13 @@ magma_ztfqmr(
         //     stag = 0;
         // }
 
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zaxpy( dofs, eta, d.dval, 1, x->dval, 1, queue );     // x = x + eta * d
         magma_zaxpy( dofs, -eta, Ad.dval, 1, r.dval, 1, queue );     // r = r - eta * Ad
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 2.*dofs, 2.*dofs ), 6*vbytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         res = magma_dznrm2( dofs, r.dval, 1, queue );
+        magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS_NRM2( dofs ), vbytes, queue );
         // normr_act = res;
         
         if ( solver_par->verbose > 0 ) {
@@ -191,23 +210,33 @@ magma_ztfqmr(
     
     
         if( solver_par->numiter%2 == 0 ){
+            tp = magma_perf_tic( &solver_par->perf, queue );
             rho = magma_zdotc( dofs, w.dval, 1, r_tld.dval, 1, queue );
+            magma_perf_toc( &solver_par->perf, Magma_PERF_DOT, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 2*vbytes, queue );
             beta = rho / rho_l;
             rho_l = rho;
+            tp = magma_perf_tic( &solver_par->perf, queue );
             magma_zcopy( dofs, w.dval, 1, u_mp1.dval, 1, queue );  
             magma_zaxpy( dofs, beta, u_m.dval, 1, u_mp1.dval, 1, queue );     // u_mp1 = w + beta*u_m;
             magma_zscal( dofs, beta*beta, v.dval, 1, queue );                    
             magma_zaxpy( dofs, beta, Au.dval, 1, v.dval, 1, queue );            // v = beta*(Au+beta*v);
+            magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( 3.*dofs, 2.*dofs ), 10*vbytes, queue );
             
         }
               
+        tp = magma_perf_tic( &solver_par->perf, queue );
         magma_zcopy( dofs, u_mp1.dval, 1, pu_m.dval, 1, queue );  
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, 0.0, 2*vbytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         CHECK( magma_z_spmv( c_one, A, pu_m, c_zero, Au, queue )); // Au = A pu_m
         solver_par->spmv_count++;
+        magma_perf_toc( &solver_par->perf, Magma_PERF_SPMV, tp, MAGMA_Z_PERF_FLOPS( A.nnz*b.num_cols, A.nnz*b.num_cols ), spmv_bytes, queue );
+        tp = magma_perf_tic( &solver_par->perf, queue );
         if( solver_par->numiter%2 == 0 ){
             magma_zaxpy( dofs, c_one, Au.dval, 1, v.dval, 1, queue );      // v = Au + v;
         }
         magma_zcopy( dofs, u_mp1.dval, 1, u_m.dval, 1, queue );  
+        magma_perf_toc( &solver_par->perf, Magma_PERF_AXPY, tp, MAGMA_Z_PERF_FLOPS( dofs, dofs ), 5*vbytes, queue );
     }
     while ( solver_par->numiter+1 <= solver_par->maxiter );
     
@@ -0,0 +1,511 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+/**
+    Purpose
+    -------
+
+    Inverts a dense s x s block in place (row-major) by Gauss-Jordan
+    elimination with partial pivoting. For S > 0 the block size is the
+    template parameter, so the loops are fully known at compile time;
+    S = 0 is the generic kernel for any size s.
+
+    Returns 0, or k+1 if the k-th pivot is exactly zero.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+template< int S >
+static magma_int_t
+magma_zvbjacobi_invert(
+    magma_int_t s_,
+    magmaDoubleComplex *B,
+    magma_int_t *piv )
+{
+    const magma_int_t s = ( S > 0 ) ? S : s_;
+
+    for( magma_int_t k=0; k < s; k++ ) {
+        magma_int_t p = k;
+        double pmax = MAGMA_Z_ABS1( B[k*s+k] );
+        for( magma_int_t i=k+1; i < s; i++ ) {
+            if ( MAGMA_Z_ABS1( B[i*s+k] ) > pmax ) {
+                pmax = MAGMA_Z_ABS1( B[i*s+k] );
+                p = i;
+            }
+        }
+        if ( pmax == 0.0 ) {
+            return k+1;
+        }
+        piv[k] = p;
+        if ( p != k ) {
+            for( magma_int_t j=0; j < s; j++ ) {
+                magmaDoubleComplex tmp = B[k*s+j];
+                B[k*s+j] = B[p*s+j];
+                B[p*s+j] = tmp;
+            }
+        }
+        magmaDoubleComplex pinv = MAGMA_Z_ONE / B[k*s+k];
+        B[k*s+k] = MAGMA_Z_ONE;
+        for( magma_int_t j=0; j < s; j++ ) {
+            B[k*s+j] = B[k*s+j] * pinv;
+        }
+        for( magma_int_t i=0; i < s; i++ ) {
+            if ( i != k ) {
+                magmaDoubleComplex f = B[i*s+k];
+                B[i*s+k] = MAGMA_Z_ZERO;
+                for( magma_int_t j=0; j < s; j++ ) {
+                    B[i*s+j] = B[i*s+j] - f * B[k*s+j];
+                }
+            }
+        }
+    }
+    // (P A)^{-1} = A^{-1} P^T: undo the row interchanges on the columns
+    for( magma_int_t k=s-1; k >= 0; k-- ) {
+        if ( piv[k] != k ) {
+            for( magma_int_t i=0; i < s; i++ ) {
+                magmaDoubleComplex tmp = B[i*s+k];
+                B[i*s+k] = B[i*s+piv[k]];
+                B[i*s+piv[k]] = tmp;
+            }
+        }
+    }
+    return 0;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Gathers and inverts the diagonal blocks of one size group. Block k
+    starts at row start[k], its inverse is stored row-major at
+    Binv + offset[k]. Called from inside a parallel region; the blocks are
+    shared among the threads.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+template< int S >
+static void
+magma_zvbjacobi_setup_group(
+    magma_int_t s_,
+    magma_int_t kb0,
+    magma_int_t kb1,
+    magma_z_matrix A,
+    const magma_index_t *start,
+    const magma_index_t *offset,
+    magmaDoubleComplex *Binv,
+    magma_int_t *piv,
+    magma_int_t *info )
+{
+    const magma_int_t s = ( S > 0 ) ? S : s_;
+
+    #pragma omp for schedule(static) nowait
+    for( magma_int_t k=kb0; k < kb1; k++ ) {
+        magmaDoubleComplex *B = Binv + offset[k];
+        magma_index_t r0 = start[k];
+        for( magma_int_t j=0; j < s*s; j++ ) {
+            B[j] = MAGMA_Z_ZERO;
+        }
+        for( magma_int_t i=0; i < s; i++ ) {
+            for( magma_int_t j=A.row[r0+i]; j < A.row[r0+i+1]; j++ ) {
+                magma_index_t c = A.col[j] - r0;
+                if ( c >= 0 && c < s ) {
+                    B[i*s+c] = A.val[j];
+                }
+            }
+        }
+        if ( magma_zvbjacobi_invert<S>( s, B, piv ) != 0 ) {
+            #pragma omp atomic write
+            *info = MAGMA_ERR_BADPRECOND;
+        }
+    }
+}
+
+
+/**
+    Purpose
+    -------
+
+    Applies the inverted diagonal blocks of one size group, x = Binv b,
+    or with trans the transposed blocks, x = Binv^T b, as a batch of small
+    dense matrix-vector products. Called from inside a parallel region; the
+    blocks are shared among the threads.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+template< int S >
+static void
+magma_zvbjacobi_apply_group(
+    magma_int_t s_,
+    magma_int_t kb0,
+    magma_int_t kb1,
+    const magma_index_t *start,
+    const magma_index_t *offset,
+    const magmaDoubleComplex *Binv,
+    bool trans,
+    const magmaDoubleComplex *b,
+    magmaDoubleComplex *x )
+{
+    const magma_int_t s = ( S > 0 ) ? S : s_;
+
+    #pragma omp for schedule(static) nowait
+    for( magma_int_t k=kb0; k < kb1; k++ ) {
+        const magmaDoubleComplex *B = Binv + offset[k];
+        const magmaDoubleComplex *bk = b + start[k];
+        magmaDoubleComplex *xk = x + start[k];
+        if ( trans ) {
+            for( magma_int_t i=0; i < s; i++ ) {
+                magmaDoubleComplex sum = MAGMA_Z_ZERO;
+                for( magma_int_t j=0; j < s; j++ ) {
+                    sum = sum + B[j*s+i] * bk[j];
+                }
+                xk[i] = sum;
+            }
+        } else {
+            for( magma_int_t i=0; i < s; i++ ) {
+                magmaDoubleComplex sum = MAGMA_Z_ZERO;
+                for( magma_int_t j=0; j < s; j++ ) {
+                    sum = sum + B[i*s+j] * bk[j];
+                }
+                xk[i] = sum;
+            }
+        }
+    }
+}
+
+
+/**
+    Purpose
+    -------
+
+    Prepares the variable-block Jacobi preconditioner on the CPU.
+
+    The diagonal blocks are found by supernode detection (magma_zmsupernodal)
+    with at most precond->pattern rows per block: consecutive rows with
+    identical sparsity patterns form a supernode, and neighboring supernodes
+    are merged up to the size limit. The blocks are gathered into contiguous
+    row-major storage grouped by block size, and inverted in parallel with
+    Gauss-Jordan kernels specialized for the common sizes.
+
+    The inverses are kept in precond->M on the CPU:
+        M.val        the block inverses, followed by 2n entries of workspace;
+        M.row[k]     first row of the k-th stored block;
+        M.col[k]     offset of its inverse in M.val (numblocks+1 entries);
+        M.blockinfo  first stored block of each size 0..blocksize+1;
+        M.numblocks  number of blocks, M.blocksize the largest block size.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A
+
+    @param[in]
+    b           magma_z_matrix
+                input RHS b
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zvbjacobisetup(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_z_matrix hA={Magma_CSR}, hAT={Magma_CSR}, S={Magma_CSR};
+    magma_int_t n, nblocks = 0, smax = 0, maxbs;
+    magma_int_t *count = NULL;
+    magma_z_matrix *M = &precond->M;
+
+    if ( A.num_rows != A.num_cols ) {
+        printf("%%  error: only supported for square matrices.\n");
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    // the blocks are extracted and inverted on the CPU
+    if ( A.memory_location != Magma_CPU || A.storage_type != Magma_CSR ) {
+        CHECK( magma_zmtransfer( A, &hAT, A.memory_location, Magma_CPU, queue ));
+        CHECK( magma_zmconvert( hAT, &hA, hAT.storage_type, Magma_CSR, queue ));
+        magma_zmfree( &hAT, queue );
+    } else {
+        CHECK( magma_zmtransfer( A, &hA, Magma_CPU, Magma_CPU, queue ));
+    }
+    n = hA.num_rows;
+
+    maxbs = max( 1, precond->pattern );
+    CHECK( magma_zmsupernodal( &maxbs, hA, &S, queue ));
+    // the block boundaries; skip empty blocks
+    for( magma_int_t k=0; k < S.numblocks; k++ ) {
+        magma_int_t s = S.tile_desc_offset_ptr[k+1] - S.tile_desc_offset_ptr[k];
+        if ( s > 0 ) {
+            nblocks++;
+            smax = max( smax, s );
+        }
+    }
+
+    // counting sort of the blocks by size
+    CHECK( magma_imalloc_cpu( &count, smax+2 ));
+    for( magma_int_t s=0; s < smax+2; s++ ) {
+        count[s] = 0;
+    }
+    for( magma_int_t k=0; k < S.numblocks; k++ ) {
+        count[ S.tile_desc_offset_ptr[k+1] - S.tile_desc_offset_ptr[k] ]++;
+    }
+    count[0] = 0;
+
+    M->memory_location = Magma_CPU;
+    M->storage_type = Magma_DENSE;
+    M->num_rows = n;
+    M->num_cols = n;
+    M->numblocks = nblocks;
+    M->blocksize = smax;
+    CHECK( magma_index_malloc_cpu( &M->blockinfo, smax+2 ));
+    CHECK( magma_index_malloc_cpu( &M->row, nblocks ));
+    CHECK( magma_index_malloc_cpu( &M->col, nblocks+1 ));
+    M->blockinfo[0] = 0;
+    for( magma_int_t s=1; s < smax+2; s++ ) {
+        M->blockinfo[s] = M->blockinfo[s-1] + count[s-1];
+    }
+    for( magma_int_t s=0; s < smax+1; s++ ) {
+        count[s] = M->blockinfo[s];
+    }
+    for( magma_int_t k=0; k < S.numblocks; k++ ) {
+        magma_int_t s = S.tile_desc_offset_ptr[k+1] - S.tile_desc_offset_ptr[k];
+        if ( s > 0 ) {
+            M->row[ count[s]++ ] = S.tile_desc_offset_ptr[k];
+        }
+    }
+    M->col[0] = 0;
+    for( magma_int_t s=1; s <= smax; s++ ) {
+        for( magma_int_t k=M->blockinfo[s]; k < M->blockinfo[s+1]; k++ ) {
+            M->col[k+1] = M->col[k] + s*s;
+        }
+    }
+    M->nnz = M->col[nblocks];
+    // block inverses, then host copies of the input and output vectors
+    CHECK( magma_zmalloc_cpu( &M->val, M->nnz + 2*n ));
+
+    #pragma omp parallel
+    {
+        magma_int_t *piv = NULL;
+        if ( magma_imalloc_cpu( &piv, smax ) != 0 ) {
+            #pragma omp atomic write
+            info = MAGMA_ERR_HOST_ALLOC;
+        } else {
+            for( magma_int_t s=1; s <= smax; s++ ) {
+                magma_int_t kb0 = M->blockinfo[s], kb1 = M->blockinfo[s+1];
+                if ( kb0 == kb1 ) {
+                    continue;
+                }
+                switch( s ) {
+                    case 1:  magma_zvbjacobi_setup_group<1>(  s, kb0, kb1, hA, M->row, M->col, M->val, piv, &info ); break;
+                    case 2:  magma_zvbjacobi_setup_group<2>(  s, kb0, kb1, hA, M->row, M->col, M->val, piv, &info ); break;
+                    case 3:  magma_zvbjacobi_setup_group<3>(  s, kb0, kb1, hA, M->row, M->col, M->val, piv, &info ); break;
+                    case 4:  magma_zvbjacobi_setup_group<4>(  s, kb0, kb1, hA, M->row, M->col, M->val, piv, &info ); break;
+                    case 5:  magma_zvbjacobi_setup_group<5>(  s, kb0, kb1, hA, M->row, M->col, M->val, piv, &info ); break;
+                    case 6:  magma_zvbjacobi_setup_group<6>(  s, kb0, kb1, hA, M->row, M->col, M->val, piv, &info ); break;
+                    case 7:  magma_zvbjacobi_setup_group<7>(  s, kb0, kb1, hA, M->row, M->col, M->val, piv, &info ); break;
+                    case 8:  magma_zvbjacobi_setup_group<8>(  s, kb0, kb1, hA, M->row, M->col, M->val, piv, &info ); break;
+                    case 16: magma_zvbjacobi_setup_group<16>( s, kb0, kb1, hA, M->row, M->col, M->val, piv, &info ); break;
+                    case 32: magma_zvbjacobi_setup_group<32>( s, kb0, kb1, hA, M->row, M->col, M->val, piv, &info ); break;
+                    default: magma_zvbjacobi_setup_group<0>(  s, kb0, kb1, hA, M->row, M->col, M->val, piv, &info ); break;
+                }
+            }
+        }
+        magma_free_cpu( piv );
+    }
+    if ( info == MAGMA_ERR_BADPRECOND ) {
+        printf("%%  error: singular diagonal block.\n");
+    }
+
+cleanup:
+    if ( S.tile_desc_offset_ptr != NULL ) {
+        magma_free_cpu( S.tile_desc_offset_ptr );
+        S.tile_desc_offset_ptr = NULL;
+    }
+    magma_zmfree( &S, queue );
+    magma_zmfree( &hAT, queue );
+    magma_zmfree( &hA, queue );
+    magma_free_cpu( count );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Applies the variable-block Jacobi preconditioner or its transpose;
+    the common part of magma_zapplyvbjacobi and magma_zapplyvbjacobi_trans.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+static magma_int_t
+magma_zapplyvbjacobi_op(
+    bool trans,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t n = b.num_rows;
+    const magma_z_matrix *M = &precond->M;
+    const magmaDoubleComplex *bh;
+    magmaDoubleComplex *xh;
+
+    if ( M->val == NULL || M->blockinfo == NULL || M->num_rows != n ) {
+        info = MAGMA_ERR_BADPRECOND;
+        goto cleanup;
+    }
+
+    if ( b.memory_location == Magma_CPU ) {
+        bh = b.val;
+    } else {
+        magma_zgetvector( n, b.dval, 1, M->val + M->nnz, 1, queue );
+        bh = M->val + M->nnz;
+    }
+    xh = ( x->memory_location == Magma_CPU ) ? x->val : M->val + M->nnz + n;
+
+    #pragma omp parallel
+    {
+        for( magma_int_t s=1; s <= M->blocksize; s++ ) {
+            magma_int_t kb0 = M->blockinfo[s], kb1 = M->blockinfo[s+1];
+            if ( kb0 == kb1 ) {
+                continue;
+            }
+            switch( s ) {
+                case 1:  magma_zvbjacobi_apply_group<1>(  s, kb0, kb1, M->row, M->col, M->val, trans, bh, xh ); break;
+                case 2:  magma_zvbjacobi_apply_group<2>(  s, kb0, kb1, M->row, M->col, M->val, trans, bh, xh ); break;
+                case 3:  magma_zvbjacobi_apply_group<3>(  s, kb0, kb1, M->row, M->col, M->val, trans, bh, xh ); break;
+                case 4:  magma_zvbjacobi_apply_group<4>(  s, kb0, kb1, M->row, M->col, M->val, trans, bh, xh ); break;
+                case 5:  magma_zvbjacobi_apply_group<5>(  s, kb0, kb1, M->row, M->col, M->val, trans, bh, xh ); break;
+                case 6:  magma_zvbjacobi_apply_group<6>(  s, kb0, kb1, M->row, M->col, M->val, trans, bh, xh ); break;
+                case 7:  magma_zvbjacobi_apply_group<7>(  s, kb0, kb1, M->row, M->col, M->val, trans, bh, xh ); break;
+                case 8:  magma_zvbjacobi_apply_group<8>(  s, kb0, kb1, M->row, M->col, M->val, trans, bh, xh ); break;
+                case 16: magma_zvbjacobi_apply_group<16>( s, kb0, kb1, M->row, M->col, M->val, trans, bh, xh ); break;
+                case 32: magma_zvbjacobi_apply_group<32>( s, kb0, kb1, M->row, M->col, M->val, trans, bh, xh ); break;
+                default: magma_zvbjacobi_apply_group<0>(  s, kb0, kb1, M->row, M->col, M->val, trans, bh, xh ); break;
+            }
+        }
+    }
+
+    if ( x->memory_location != Magma_CPU ) {
+        magma_zsetvector( n, xh, 1, x->dval, 1, queue );
+    }
+
+cleanup:
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Applies the variable-block Jacobi preconditioner, x = D^{-1} b, as one
+    batched small dense matrix-vector product per block size on the CPU.
+    Vectors on the device are staged through the workspace in precond->M.
+
+    Arguments
+    ---------
+
+    @param[in]
+    b           magma_z_matrix
+                input vector b
+
+    @param[in,out]
+    x           magma_z_matrix*
+                output vector x
+
+    @param[in]
+    precond     magma_z_preconditioner*
+                preconditioner
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zapplyvbjacobi(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    return magma_zapplyvbjacobi_op( false, b, x, precond, queue );
+}
+
+
+/**
+    Purpose
+    -------
+
+    Applies the transposed variable-block Jacobi preconditioner,
+    x = D^{-T} b, with the transposed block inverses, as needed by BiCG,
+    QMR, and LSQR. The block inverses of a nonsymmetric A are not
+    symmetric, so this differs from magma_zapplyvbjacobi.
+
+    Arguments
+    ---------
+
+    @param[in]
+    b           magma_z_matrix
+                input vector b
+
+    @param[in,out]
+    x           magma_z_matrix*
+                output vector x
+
+    @param[in]
+    precond     magma_z_preconditioner*
+                preconditioner
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zapplyvbjacobi_trans(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    return magma_zapplyvbjacobi_op( true, b, x, precond, queue );
+}
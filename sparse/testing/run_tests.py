@@ -174,6 +174,7 @@ parser.add_option(      '--lobpcg'           , action='store_true', dest='lobpcg
 parser.add_option(      '--iterref'          , action='store_true', dest='iterref'       , help='run iterref'       )
 parser.add_option(      '--jacobi'           , action='store_true', dest='jacobi'        , help='run jacobi'        )
 parser.add_option(      '--ba'               , action='store_true', dest='ba'            , help='run ba-iter'       )
+parser.add_option(      '--bacpu'            , action='store_true', dest='bacpu'         , help='run ba-iter on CPU')
 parser.add_option(      '--idr'              , action='store_true', dest='idr'           , help='run idr'           )
 parser.add_option(      '--idr_merge'        , action='store_true', dest='idr_merge'     , help='run idr_merge'     )
 parser.add_option(      '--pidr'             , action='store_true', dest='pidr'          , help='run pidr'          )
@@ -190,6 +191,11 @@ parser.add_option(      '--bombard_merge'    , action='store_true', dest='bombar
 parser.add_option(      '--lsqr'             , action='store_true', dest='lsqr'          , help='run lsqr'          )
 parser.add_option(      '--bicg'             , action='store_true', dest='bicg'          , help='run bicg'          )
 parser.add_option(      '--pbicg'            , action='store_true', dest='pbicg'         , help='run pbicg'         )
+parser.add_option(      '--pipecg'           , action='store_true', dest='pipecg'        , help='run pipelined cg'  )
+parser.add_option(      '--sstepcg'          , action='store_true', dest='sstepcg'       , help='run s-step cg'     )
+parser.add_option(      '--sstepgmres'       , action='store_true', dest='sstepgmres'    , help='run s-step gmres'  )
+parser.add_option(      '--gcrodr'           , action='store_true', dest='gcrodr'        , help='run gcro-dr'       )
+parser.add_option(      '--defcg'            , action='store_true', dest='defcg'         , help='run deflated cg'   )
 
                                                                                            
 parser.add_option(      '--jacobi-prec'      , action='store_true', dest='jacobi_prec'   , help='run Jacobi preconditioner')
@@ -198,6 +204,9 @@ parser.add_option(      '--ilu-jac'          , action='store_true', dest='ilu_ja
 parser.add_option(      '--ilu-bjac'         , action='store_true', dest='ilu_bjac_prec',  help='run ILU + Block Jacobi solve preconditioner')
 parser.add_option(      '--ilu-isai-prec'    , action='store_true', dest='ilu_isai_prec' , help='run ILU + ISAI preconditioner')
 parser.add_option(      '--ilut-prec'        , action='store_true', dest='ilut_prec',      help='run threshold ILU + exact solve preconditioner')
+parser.add_option(      '--cheb-prec'        , action='store_true', dest='cheb_prec',      help='run Chebyshev polynomial preconditioner')
+parser.add_option(      '--schwarz-prec'     , action='store_true', dest='schwarz_prec',   help='run restricted additive Schwarz preconditioner')
+parser.add_option(      '--vbjac-prec'       , action='store_true', dest='vbjac_prec',     help='run variable-block Jacobi preconditioner')
 
 (opts, args) = parser.parse_args()
 
@@ -254,6 +263,12 @@ if (     not opts.cg
      and not opts.bicg
      and not opts.pbicg
      and not opts.lsqr
+     and not opts.pipecg
+     and not opts.sstepcg
+     and not opts.sstepgmres
+     and not opts.gcrodr
+     and not opts.defcg
+     and not opts.bacpu
      and not opts.pidr ):
     opts.cg             = True
     opts.cg_merge       = True
@@ -283,6 +298,12 @@ if (     not opts.cg
     opts.bicg           = True
     opts.pbicg          = True
     opts.lsqr           = True
+    opts.pipecg         = True
+    opts.sstepcg        = True
+    opts.sstepgmres     = True
+    opts.gcrodr         = True
+    opts.defcg          = True
+    opts.bacpu          = True
 # end
 
 # default if no preconditioners given all
@@ -291,13 +312,19 @@ if (     not opts.jacobi_prec
      and not opts.ilut_prec
      and not opts.ilu_jac_prec
      and not opts.ilu_bjac_prec
-     and not opts.ilu_isai_prec ):
+     and not opts.ilu_isai_prec
+     and not opts.cheb_prec
+     and not opts.schwarz_prec
+     and not opts.vbjac_prec ):
     opts.jacobi_prec      = True
     opts.ilu_prec         = True
     opts.ilu_jac_prec     = True
     opts.ilu_isai_prec    = True
     opts.ilu_bjac_prec    = True
     opts.ilut_prec        = True
+    opts.cheb_prec        = True
+    opts.schwarz_prec     = True
+    opts.vbjac_prec       = True
 # end
 
 # default if no sizes given is all sizes
@@ -355,6 +382,9 @@ if ( opts.jacobi ):
 if ( opts.ba ):
     solvers += ['--solver BA']
 # end
+if ( opts.bacpu ):
+    solvers += ['--solver BACPU --version 0', '--solver BACPU --version 1']
+# end
 if ( opts.idr ):
     solvers += ['--solver IDR --basic']
 # end
@@ -385,6 +415,21 @@ if ( opts.bombard ):
 if ( opts.bombard_merge ):
     solvers += ['--solver BOMBARDMENT --basic']
 # end
+if ( opts.pipecg ):
+    solvers += ['--solver PIPECG']
+# end
+if ( opts.sstepcg ):
+    solvers += ['--solver SSTEPCG --sstep 4', '--solver SSTEPCG --sstep 8 --version 1']
+# end
+if ( opts.sstepgmres ):
+    solvers += ['--solver SSTEPGMRES --sstep 4 --restart 32']
+# end
+if ( opts.gcrodr ):
+    solvers += ['--solver GCRODR --restart 40 --recycle 10']
+# end
+if ( opts.defcg ):
+    solvers += ['--solver DEFCG --restart 50 --recycle 8']
+# end
 
 
 # looping over precsolvers
@@ -413,6 +458,9 @@ if ( opts.pbicg ):
 if ( opts.lsqr ):
     precsolvers += ['--solver PLSQR ']
 # end
+if ( opts.pipecg ):
+    precsolvers += ['--solver PPIPECG ']
+# end
 
 
 
@@ -443,6 +491,10 @@ if ( opts.ilu_bjac_prec ):
 # end
 if ( opts.ilu_isai_prec ):
     precs += ['--precond ILU --trisolver ISAI --ppattern 1 --piters 1 ']
+    precs += ['--precond ILU --trisolver ISAI --ppattern 2 --piters 1 ']
+# end
+if ( opts.cheb_prec ):
+    precs += ['--precond CHEBYSHEV --pdegree 4 ']
 # end
 
 
@@ -605,6 +657,92 @@ if ( opts.sparse_blas):
                     tests.append( [cmd, alignment + ' ' + blocksize, size, ''] )
 
 
+# ----------------------------------------------------------------------
+if ( opts.sparse_blas):
+    for precision in opts.precisions:
+        # precision generation
+        cmd = substitute( 'testing_zspmv_operator', 'z', precision )
+        tests.append( [cmd, '--solver PCG --precond JACOBI', 'LAPLACE3D7 32 LAPLACE3D27 32', ''] )
+
+
+# ----------------------------------------------------------------------
+# time-to-solution of the Chebyshev preconditioner against ParILU + ISAI,
+# on 27-point stencils (assembled and matrix-free) and the bundled matrices
+if ( opts.cheb_prec ):
+    chebprecs = ['--precond CHEBYSHEV --pdegree 2',
+                 '--precond CHEBYSHEV --pdegree 4',
+                 '--precond CHEBYSHEV --pdegree 8',
+                 '--precond PARILU --psweeps 5 --trisolver ISAI --ppattern 1 --piters 1']
+    for precision in opts.precisions:
+        for prec in chebprecs:
+            # precision generation
+            cmd = substitute( 'testing_zsolver', 'z', precision )
+            tests.append( [cmd, '--solver PCG ' + prec, 'LAPLACE3D27 32 test_matrices/Trefethen_2000.mtx', ''] )
+            tests.append( [cmd, '--solver PGMRES ' + prec, 'test_matrices/ani5_crop.mtx test_matrices/pores_1.mtx', ''] )
+        cmd = substitute( 'testing_zspmv_operator', 'z', precision )
+        tests.append( [cmd, '--solver PCG --precond CHEBYSHEV --pdegree 4', 'LAPLACE3D7 32 LAPLACE3D27 32', ''] )
+
+
+# ----------------------------------------------------------------------
+# restricted additive Schwarz: dense and ILU subdomain solves, and the
+# strong scaling of the CPU setup and solves on the 27-point stencil
+if ( opts.schwarz_prec ):
+    schwarzprecs = ['--precond SCHWARZ --poverlap 1',
+                    '--precond SCHWARZ --poverlap 2 --plevels 1',
+                    '--precond SCHWARZ --poverlap 1 --pbsize 1000']
+    for precision in opts.precisions:
+        for prec in schwarzprecs:
+            # precision generation
+            cmd = substitute( 'testing_zsolver', 'z', precision )
+            tests.append( [cmd, '--solver PGMRES ' + prec, 'test_matrices/ani5_crop.mtx test_matrices/pores_1.mtx', ''] )
+            tests.append( [cmd, '--solver PBICGSTAB ' + prec, 'LAPLACE3D27 32', ''] )
+        cmd = substitute( 'testing_zsolver_schwarz', 'z', precision )
+        tests.append( [cmd, '--poverlap 1', 'LAPLACE3D27 64', ''] )
+
+
+# ----------------------------------------------------------------------
+# variable-block Jacobi on the CPU: supernodal blocks up to 32 rows
+# against scalar Jacobi
+if ( opts.vbjac_prec ):
+    for precision in opts.precisions:
+        # precision generation
+        cmd = substitute( 'testing_zsolver', 'z', precision )
+        for bs in ['4', '16']:
+            tests.append( [cmd, '--solver PCG --precond VBJACOBI --ppattern ' + bs, 'LAPLACE3D27 32 test_matrices/ani5_crop.mtx', ''] )
+        cmd = substitute( 'testing_zvbjacobi', 'z', precision )
+        tests.append( [cmd, '', 'LAPLACE3D27 32 test_matrices/ani5_crop.mtx', ''] )
+
+
+# ----------------------------------------------------------------------
+# block-asynchronous iteration on the CPU against synchronous Jacobi
+if ( opts.bacpu ):
+    for precision in opts.precisions:
+        # precision generation
+        cmd = substitute( 'testing_zsolver_async', 'z', precision )
+        tests.append( [cmd, '--maxiter 2000 --rtol 1e-6', 'LAPLACE2D 64 test_matrices/Trefethen_2000.mtx', ''] )
+
+
+# ----------------------------------------------------------------------
+if ( opts.pipecg or opts.sstepcg or opts.sstepgmres ):
+    for size in sizes:
+        for precision in opts.precisions:
+            # precision generation
+            cmd = substitute( 'testing_zsolver_sstep', 'z', precision )
+            tests.append( [cmd, '--sstep 4', size, ''] )
+
+
+# ----------------------------------------------------------------------
+# total iterations over a sequence of systems, with and without recycling
+if ( opts.gcrodr or opts.defcg ):
+    for precision in opts.precisions:
+        # precision generation
+        cmd = substitute( 'testing_zsolver_rhs', 'z', precision )
+        if ( opts.gcrodr ):
+            tests.append( [cmd, '--solver GCRODR --restart 40 --recycle 10', 'LAPLACE2D 64', ''] )
+        if ( opts.defcg ):
+            tests.append( [cmd, '--solver DEFCG --restart 50 --recycle 8', 'LAPLACE2D 64', ''] )
+
+
 # ----------------------------------------------------------------------
 for solver in solvers:
     for size in sizes:
@@ -50,6 +50,14 @@ int main(  int argc, char** argv )
             i++;
             magma_int_t laplace_size = atoi( argv[i] );
             TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else if ( strcmp("LAPLACE3D7", argv[i]) == 0 && i+1 < argc ) {
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_7stencil(  laplace_size, &A, queue ));
+        } else if ( strcmp("LAPLACE3D27", argv[i]) == 0 && i+1 < argc ) {
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_27stencil(  laplace_size, &A, queue ));
         } else {                        // file-matrix test
             TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
         }
@@ -103,6 +111,12 @@ int main(  int argc, char** argv )
         magma_zsolverinfo( &zopts.solver_par, &zopts.precond_par, queue );
         printf("];\n\n");
         
+        if ( zopts.solver_par.perf.enabled > 1 ) {
+            printf("%% performance counters (JSON):\n");
+            magma_zsolverinfo_json( &zopts.solver_par, &zopts.precond_par, NULL, queue );
+            printf("\n");
+        }
+        
         printf("precondinfo = [\n");
         printf("%%   setup  runtime\n");        
         printf("  %.6f  %.6f\n",
@@ -0,0 +1,124 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing block-asynchronous iteration on the CPU
+   Solves the same system with the synchronous Jacobi method and with the
+   CPU block-asynchronous iteration in its synchronous, asynchronous, and
+   asynchronous Southwell variants, and compares iterations (passes of the
+   slowest thread), equivalent Jacobi sweeps, and wall time.
+   The block size and the local sweeps are given by --pbsize and --piters.
+
+   usage: testing_zsolver_async [ solver options ] LAPLACE2D n | matrix.mtx ...
+*/
+int main(  int argc, char** argv )
+{
+    magma_int_t info = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts;
+    magma_queue_t queue;
+    magma_queue_create( 0, &queue );
+
+    magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    magma_z_matrix A={Magma_CSR}, B={Magma_CSR}, dB={Magma_CSR};
+    magma_z_matrix x={Magma_CSR}, b={Magma_CSR};
+
+    const magma_int_t nsolvers = 4;
+    const magma_solver_type solvers[] = { Magma_JACOBI, Magma_BAITERCPU,
+                                          Magma_BAITERCPU, Magma_BAITERCPU };
+    const magma_int_t versions[]      = { 0, 2, 0, 1 };
+    const char *names[]               = { "Jacobi", "block, synchronous",
+                                          "block, asynchronous", "block, async Southwell" };
+
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+    B.blocksize = zopts.blocksize;
+    B.alignment = zopts.alignment;
+    zopts.precond_par.solver = Magma_NONE;
+
+    magma_int_t nthreads = 1;
+    #ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+    #endif
+
+    TESTING_CHECK( magma_zsolverinfo_init( &zopts.solver_par, &zopts.precond_par, queue ));
+
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else if ( strcmp("LAPLACE3D27", argv[i]) == 0 && i+1 < argc ) {
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_27stencil(  laplace_size, &A, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+        TESTING_CHECK( magma_zmscale( &A, zopts.scaling, queue ));
+        TESTING_CHECK( magma_zmconvert( A, &B, Magma_CSR, zopts.output_format, queue ));
+        TESTING_CHECK( magma_zmtransfer( B, &dB, Magma_CPU, Magma_DEV, queue ));
+
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros, %lld threads, block size %lld, local sweeps %lld\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz,
+                (long long) nthreads,
+                (long long) (zopts.precond_par.bsize > 0 ? zopts.precond_par.bsize : 256),
+                (long long) zopts.precond_par.maxiter );
+        printf( "%% solver                     iter   sweeps   runtime (sec)   |b-Ax|/|b|   info\n" );
+        printf( "%%==============================================================================\n" );
+
+        TESTING_CHECK( magma_zvinit( &b, Magma_DEV, A.num_rows, 1, c_one, queue ));
+        double nomb = magma_dznrm2( A.num_rows, b.dval, 1, queue );
+        for( magma_int_t k=0; k < nsolvers; k++ ) {
+            TESTING_CHECK( magma_zvinit( &x, Magma_DEV, A.num_cols, 1, c_zero, queue ));
+            zopts.solver_par.solver  = solvers[k];
+            zopts.solver_par.version = versions[k];
+            info = magma_z_solver( dB, b, &x, &zopts, queue );
+            // Jacobi counts one SpMV per iteration
+            magma_int_t sweeps = ( solvers[k] == Magma_JACOBI )
+                                 ? zopts.solver_par.numiter : zopts.solver_par.spmv_count;
+            printf( "  %-24s  %5lld   %6lld       %9.4f    %9.2e   %lld\n",
+                    names[k], (long long) zopts.solver_par.numiter, (long long) sweeps,
+                    zopts.solver_par.runtime, zopts.solver_par.final_res / nomb,
+                    (long long) info );
+            fflush( stdout );
+            magma_zmfree( &x, queue );
+        }
+
+        magma_zmfree( &dB, queue );
+        magma_zmfree( &B, queue );
+        magma_zmfree( &A, queue );
+        magma_zmfree( &b, queue );
+        i++;
+    }
+
+    magma_zsolverinfo_free( &zopts.solver_par, &zopts.precond_par, queue );
+    magma_queue_destroy( queue );
+    TESTING_CHECK( magma_finalize() );
+    return 0;
+}
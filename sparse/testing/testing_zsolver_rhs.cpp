@@ -23,6 +23,10 @@
 
 /* ////////////////////////////////////////////////////////////////////////////
    -- testing any solver
+   For the recycling solvers (--solver GCRODR or DEFCG), additionally solves
+   a sequence of slowly changing systems (A + j*1e-3 I) x = b, j = 0..7,
+   once without and once with the recycled subspace carried between the
+   solves, and compares the total number of iterations.
 */
 int main(  int argc, char** argv )
 {
@@ -40,6 +44,9 @@ int main(  int argc, char** argv )
     magmaDoubleComplex zero = MAGMA_Z_MAKE(0.0, 0.0);
     magma_z_matrix A={Magma_CSR}, B={Magma_CSR}, dB={Magma_CSR};
     magma_z_matrix x={Magma_CSR}, x_h={Magma_CSR}, b_h={Magma_DENSE}, b={Magma_DENSE};
+    magma_z_matrix dS={Magma_CSR};
+    const magma_int_t nseq = 8;
+    const double shift = 1e-3;
     
     int i=1;
     TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
@@ -131,6 +138,53 @@ int main(  int argc, char** argv )
         printf("];\n\n");
         
         //printf("transfer_time = %.6f;\n\n", t_transfer);
+
+        // sequence of linear systems, with and without recycling
+        magma_solver_type recycler = zopts.solver_par.solver;
+        if ( recycler == Magma_GCRODR || recycler == Magma_DEFCG ) {
+            magma_solver_type seq_solvers[2] = {
+                (recycler == Magma_GCRODR ? Magma_GMRES : Magma_PCG), recycler };
+            magma_int_t total_iter[2] = { 0, 0 };
+            real_Double_t total_time[2] = { 0.0, 0.0 };
+
+            printf("\n%% sequence of %lld systems (A + j*%.0e I) x = b, recycled subspace k = %lld\n",
+                   (long long) nseq, shift, (long long) zopts.recycle.k );
+            printf("%%  system   iter (no recycling)   iter (recycling)   recycled vectors\n");
+            printf("%%=====================================================================%%\n");
+            magma_zrecycle_free( &zopts.recycle, queue );
+            for( magma_int_t j=0; j < nseq; j++ ) {
+                magma_int_t iter[2] = { 0, 0 };
+                for( magma_int_t pass=0; pass < 2; pass++ ) {
+                    TESTING_CHECK( magma_zmtransfer( B, &dS, Magma_CPU, Magma_DEV, queue ));
+                    TESTING_CHECK( magma_zmdiagadd( &dS, MAGMA_Z_MAKE( j*shift, 0.0 ), queue ));
+                    if ( pass == 1 ) {
+                        // the matrix has changed: C = A U for the new A
+                        TESTING_CHECK( magma_zrecycle_update( dS, &zopts.recycle, queue ));
+                    }
+                    TESTING_CHECK( magma_zvinit( &x, Magma_DEV, A.num_cols, 1, zero, queue ));
+                    zopts.solver_par.solver = seq_solvers[pass];
+                    info = magma_z_solver( dS, b, &x, &zopts, queue );
+                    if( info != 0 ) {
+                        printf("%%error: solver returned: %s (%lld).\n",
+                            magma_strerror( info ), (long long) info );
+                    }
+                    iter[pass] = zopts.solver_par.numiter;
+                    total_iter[pass] += zopts.solver_par.numiter;
+                    total_time[pass] += zopts.solver_par.runtime;
+                    magma_zmfree(&x, queue );
+                    magma_zmfree(&dS, queue );
+                }
+                printf("  %6lld   %19lld   %16lld   %16lld\n",
+                       (long long) j, (long long) iter[0], (long long) iter[1],
+                       (long long) zopts.recycle.num_vecs );
+            }
+            printf("%%=====================================================================%%\n");
+            printf("%%  total    %19lld   %16lld\n",
+                   (long long) total_iter[0], (long long) total_iter[1] );
+            printf("%%  runtime  %19.4f   %16.4f\n", total_time[0], total_time[1] );
+            zopts.solver_par.solver = recycler;
+            magma_zrecycle_free( &zopts.recycle, queue );
+        }
         
 
         magma_zmfree(&x, queue );
@@ -157,6 +211,7 @@ int main(  int argc, char** argv )
         i++;
     }
 
+    magma_zrecycle_free( &zopts.recycle, queue );
     magma_queue_destroy( queue );
     TESTING_CHECK( magma_finalize() );
     return info;
@@ -0,0 +1,154 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing the restricted additive Schwarz preconditioner
+   Strong scaling of the CPU subdomain factorization and solves: the number
+   of subdomains is fixed (--psubdomains, default: maximum number of
+   threads), and setup, application, and solve are timed for 1, 2, 4, ...
+   OpenMP threads. The overlap and local solver are given by --poverlap,
+   --pbsize, and --plevels; the Krylov solver by --solver (default GMRES).
+
+   usage: testing_zsolver_schwarz [ solver options ] LAPLACE3D27 n | matrix.mtx ...
+*/
+int main(  int argc, char** argv )
+{
+    magma_int_t info = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts;
+    magma_queue_t queue;
+    magma_queue_create( 0, &queue );
+
+    magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    magma_z_matrix A={Magma_CSR}, B={Magma_CSR}, dB={Magma_CSR};
+    magma_z_matrix x={Magma_CSR}, b={Magma_CSR}, y={Magma_CSR};
+    real_Double_t tempo1, tempo2, t_apply, t_apply1 = 0.0, t_solve1 = 0.0;
+    const magma_int_t napply = 10;
+
+    int status = 0;
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+    B.blocksize = zopts.blocksize;
+    B.alignment = zopts.alignment;
+    if ( zopts.solver_par.solver == Magma_CGMERGE ) {
+        // the parser default; RAS is not symmetric
+        zopts.solver_par.solver = Magma_PGMRES;
+    }
+    zopts.precond_par.solver = Magma_SCHWARZ;
+
+    magma_int_t max_threads = 1;
+    #ifdef _OPENMP
+    max_threads = omp_get_max_threads();
+    #endif
+    if ( zopts.precond_par.subdomains <= 0 ) {
+        zopts.precond_par.subdomains = max_threads;
+    }
+
+    TESTING_CHECK( magma_zsolverinfo_init( &zopts.solver_par, &zopts.precond_par, queue ));
+    double tol = 100 * zopts.solver_par.rtol;
+
+    while( i < argc ) {
+        if ( strcmp("LAPLACE3D27", argv[i]) == 0 && i+1 < argc ) {   // 27-point stencil
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_27stencil(  laplace_size, &A, queue ));
+        } else if ( strcmp("LAPLACE3D7", argv[i]) == 0 && i+1 < argc ) {
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_7stencil(  laplace_size, &A, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+        TESTING_CHECK( magma_zmscale( &A, zopts.scaling, queue ));
+        TESTING_CHECK( magma_zmconvert( A, &B, Magma_CSR, zopts.output_format, queue ));
+        TESTING_CHECK( magma_zmtransfer( B, &dB, Magma_CPU, Magma_DEV, queue ));
+        TESTING_CHECK( magma_zvinit( &b, Magma_DEV, A.num_rows, 1, c_one, queue ));
+        TESTING_CHECK( magma_zvinit( &y, Magma_DEV, A.num_rows, 1, c_zero, queue ));
+        double nomb = magma_dznrm2( A.num_rows, b.dval, 1, queue );
+
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz );
+        printf( "%% %lld subdomains, overlap %lld, dense LU up to %lld rows, ILU(%lld) otherwise\n\n",
+                (long long) zopts.precond_par.subdomains, (long long) zopts.precond_par.overlap,
+                (long long) zopts.precond_par.bsize, (long long) zopts.precond_par.levels );
+        printf( "%% threads   setup (sec)   apply (sec)   speedup   iter   solve (sec)   speedup   |b-Ax|/|b|\n" );
+        printf( "%%=========================================================================================\n" );
+
+        for( magma_int_t nthreads=1; nthreads <= max_threads;
+             nthreads = (nthreads < max_threads ? min( 2*nthreads, max_threads ) : max_threads+1) ) {
+            #ifdef _OPENMP
+            omp_set_num_threads( nthreads );
+            #endif
+            TESTING_CHECK( magma_z_precondsetup( A, b, &zopts.solver_par, &zopts.precond_par, queue ));
+
+            tempo1 = magma_sync_wtime( queue );
+            for( magma_int_t k=0; k < napply; k++ ) {
+                TESTING_CHECK( magma_z_applyprecond( dB, b, &y, &zopts.precond_par, queue ));
+            }
+            tempo2 = magma_sync_wtime( queue );
+            t_apply = (tempo2 - tempo1) / napply;
+
+            TESTING_CHECK( magma_zvinit( &x, Magma_DEV, A.num_cols, 1, c_zero, queue ));
+            info = magma_z_solver( dB, b, &x, &zopts, queue );
+            if ( info != 0 && info != MAGMA_SLOW_CONVERGENCE ) {
+                printf( "%% error: solver returned: %s (%lld).\n",
+                        magma_strerror( info ), (long long) info );
+            }
+            if ( nthreads == 1 ) {
+                t_apply1 = t_apply;
+                t_solve1 = zopts.solver_par.runtime;
+            }
+            double error = zopts.solver_par.final_res / nomb;
+            bool okay = (error < tol);
+            status += ! okay;
+            printf( "  %7lld   %11.4f   %11.6f   %7.2f  %5lld   %11.4f   %7.2f    %9.2e   %s\n",
+                    (long long) nthreads, zopts.precond_par.setuptime, t_apply,
+                    t_apply1 / t_apply, (long long) zopts.solver_par.numiter,
+                    zopts.solver_par.runtime, t_solve1 / zopts.solver_par.runtime,
+                    error, (okay ? "ok" : "failed") );
+            fflush( stdout );
+            magma_zmfree( &x, queue );
+            magma_zprecondfree( &zopts.precond_par, queue );
+        }
+        #ifdef _OPENMP
+        omp_set_num_threads( max_threads );
+        #endif
+
+        magma_zmfree( &dB, queue );
+        magma_zmfree( &B, queue );
+        magma_zmfree( &A, queue );
+        magma_zmfree( &b, queue );
+        magma_zmfree( &y, queue );
+        i++;
+    }
+
+    magma_zsolverinfo_free( &zopts.solver_par, &zopts.precond_par, queue );
+    magma_queue_destroy( queue );
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
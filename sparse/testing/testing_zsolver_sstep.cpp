@@ -0,0 +1,121 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing pipelined and s-step solvers
+   Solves the same Hermitian positive definite system with the classical
+   CG and GMRES and with the pipelined CG and the s-step CG and GMRES
+   (Newton and Chebyshev basis), and compares iterations, SpMVs, time per
+   iteration, and residual replacements.
+   The s-step length and the GMRES restart are given by --sstep and --restart.
+
+   usage: testing_zsolver_sstep [ solver options ] LAPLACE2D n | matrix.mtx ...
+*/
+int main(  int argc, char** argv )
+{
+    magma_int_t info = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts;
+    magma_queue_t queue;
+    magma_queue_create( 0, &queue );
+
+    magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    magma_z_matrix A={Magma_CSR}, B={Magma_CSR}, dB={Magma_CSR};
+    magma_z_matrix x={Magma_CSR}, b={Magma_CSR};
+
+    const magma_int_t nsolvers = 7;
+    const magma_solver_type solvers[] = { Magma_CG, Magma_CGMERGE, Magma_PIPECG,
+                                          Magma_SSTEPCG, Magma_SSTEPCG,
+                                          Magma_GMRES, Magma_SSTEPGMRES };
+    const magma_int_t versions[]      = { 0, 0, 0, 0, 1, 0, 0 };
+    const char *names[]               = { "CG", "CG (merged)", "pipelined CG",
+                                          "s-step CG, Newton", "s-step CG, Chebyshev",
+                                          "GMRES", "s-step GMRES, Newton" };
+
+    int status = 0;
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+    B.blocksize = zopts.blocksize;
+    B.alignment = zopts.alignment;
+    zopts.precond_par.solver = Magma_NONE;
+
+    TESTING_CHECK( magma_zsolverinfo_init( &zopts.solver_par, &zopts.precond_par, queue ));
+    double tol = 100 * zopts.solver_par.rtol;
+
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+        TESTING_CHECK( magma_zmscale( &A, zopts.scaling, queue ));
+        TESTING_CHECK( magma_zmconvert( A, &B, Magma_CSR, zopts.output_format, queue ));
+        TESTING_CHECK( magma_zmtransfer( B, &dB, Magma_CPU, Magma_DEV, queue ));
+
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros, s = %lld, restart = %lld\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz,
+                (long long) zopts.solver_par.sstep, (long long) zopts.solver_par.restart );
+        printf( "%% solver                   iter    SpMV   runtime (sec)   sec/iter   replacements   |b-Ax|/|b|\n" );
+        printf( "%%=============================================================================================\n" );
+
+        TESTING_CHECK( magma_zvinit( &b, Magma_DEV, A.num_rows, 1, c_one, queue ));
+        double nomb = magma_dznrm2( A.num_rows, b.dval, 1, queue );
+        for( magma_int_t k=0; k < nsolvers; k++ ) {
+            TESTING_CHECK( magma_zvinit( &x, Magma_DEV, A.num_cols, 1, c_zero, queue ));
+            zopts.solver_par.solver  = solvers[k];
+            zopts.solver_par.version = versions[k];
+            info = magma_z_solver( dB, b, &x, &zopts, queue );
+            if ( info != 0 && info != MAGMA_SLOW_CONVERGENCE ) {
+                printf( "%% error: %s returned: %s (%lld).\n",
+                        names[k], magma_strerror( info ), (long long) info );
+            }
+            magma_int_t numiter = max( 1, zopts.solver_par.numiter );
+            double error = zopts.solver_par.final_res / nomb;
+            bool okay = (error < tol);
+            status += ! okay;
+            printf( "  %-22s  %5lld  %6lld       %9.4f  %9.2e          %5lld    %9.2e   %s\n",
+                    names[k], (long long) zopts.solver_par.numiter,
+                    (long long) zopts.solver_par.spmv_count,
+                    zopts.solver_par.runtime, zopts.solver_par.runtime / numiter,
+                    (long long) zopts.solver_par.num_replace, error,
+                    (okay ? "ok" : "failed") );
+            fflush( stdout );
+            magma_zmfree( &x, queue );
+        }
+
+        magma_zmfree( &dB, queue );
+        magma_zmfree( &B, queue );
+        magma_zmfree( &A, queue );
+        magma_zmfree( &b, queue );
+        i++;
+    }
+
+    magma_zsolverinfo_free( &zopts.solver_par, &zopts.precond_par, queue );
+    magma_queue_destroy( queue );
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
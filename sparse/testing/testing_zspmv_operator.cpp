@@ -0,0 +1,217 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_operators.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing matrix-free operators
+   Compares the matrix-free 7-pt and 27-pt stencil operators
+   (magma_zm_stencil_operator) with the assembled CSR matrices
+   (magma_zm_7stencil, magma_zm_27stencil): SpMV, SpMV with a block of
+   vectors, and the solver given by the options, e.g., --solver CG --precond JACOBI.
+
+   usage: testing_zspmv_operator [ solver options ] LAPLACE3D7 n LAPLACE3D27 n ...
+*/
+int main(  int argc, char** argv )
+{
+    magma_int_t info = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts;
+    magma_queue_t queue;
+    magma_queue_create( 0, &queue );
+
+    magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    magmaDoubleComplex c_zero    = MAGMA_Z_ZERO;
+
+    magma_z_matrix hA={Magma_CSR}, dA={Magma_CSR}, dOp={Magma_CSR}, hOp={Magma_CSR};
+    magma_z_matrix hx={Magma_CSR}, hy={Magma_CSR}, dx={Magma_CSR}, dy={Magma_CSR},
+                   dyref={Magma_CSR}, dX={Magma_CSR}, dY={Magma_CSR}, dYref={Magma_CSR},
+                   hyop={Magma_CSR}, b={Magma_CSR}, x={Magma_CSR};
+
+    const magma_int_t nrepeat = 100;
+    const magma_int_t num_vecs = 4;
+    real_Double_t start, end, csr_time, op_time, csr_solve, op_solve;
+    magma_int_t csr_iter, op_iter;
+    double error, norm, tol = 1e-12;
+
+    #define PRECISION_z
+    #if defined(PRECISION_c) || defined(PRECISION_s)
+        tol = 1e-5;
+    #endif
+
+    int status = 0;
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+    TESTING_CHECK( magma_zsolverinfo_init( &zopts.solver_par, &zopts.precond_par, queue ));
+
+    printf( "%%   n  points      rows        nnz   CSR SpMV (sec)   operator SpMV (sec)   block CSR/op (sec)         error   "
+            "CSR solve (iter, sec)   operator solve (iter, sec)\n" );
+    printf( "%%==============================================================================="
+            "=================================================================================\n" );
+    while( i+1 < argc ) {
+        magma_int_t points;
+        if ( strcmp("LAPLACE3D7", argv[i]) == 0 ) {
+            points = 7;
+        } else if ( strcmp("LAPLACE3D27", argv[i]) == 0 ) {
+            points = 27;
+        } else {
+            printf( "%% error: unknown matrix %s\n", argv[i] );
+            status += 1;
+            break;
+        }
+        magma_int_t n = atoi( argv[i+1] );
+        magma_int_t nn = n*n*n;
+        i += 2;
+
+        if ( points == 7 ) {
+            TESTING_CHECK( magma_zm_7stencil( n, &hA, queue ));
+        } else {
+            TESTING_CHECK( magma_zm_27stencil( n, &hA, queue ));
+        }
+        TESTING_CHECK( magma_zmtransfer( hA, &dA, Magma_CPU, Magma_DEV, queue ));
+        TESTING_CHECK( magma_zm_stencil_operator( n, points, Magma_DEV, &dOp, queue ));
+        TESTING_CHECK( magma_zm_stencil_operator( n, points, Magma_CPU, &hOp, queue ));
+
+        // deterministic, non-constant x
+        TESTING_CHECK( magma_zvinit( &hx, Magma_CPU, nn, num_vecs, c_zero, queue ));
+        for( magma_int_t k=0; k < nn*num_vecs; k++ ) {
+            hx.val[k] = MAGMA_Z_MAKE( ((k*37) % 101) / 101., ((k*17) % 53) / 53. );
+        }
+        TESTING_CHECK( magma_zmtransfer( hx, &dX, Magma_CPU, Magma_DEV, queue ));
+        TESTING_CHECK( magma_zvinit( &dY,    Magma_DEV, nn, num_vecs, c_zero, queue ));
+        TESTING_CHECK( magma_zvinit( &dYref, Magma_DEV, nn, num_vecs, c_zero, queue ));
+        TESTING_CHECK( magma_zvinit( &dy,    Magma_DEV, nn, 1, c_zero, queue ));
+        TESTING_CHECK( magma_zvinit( &dyref, Magma_DEV, nn, 1, c_zero, queue ));
+        // dx is the first column of dX
+        TESTING_CHECK( magma_zvinit( &dx, Magma_DEV, nn, 1, c_zero, queue ));
+        magma_zcopy( nn, dX.dval, 1, dx.dval, 1, queue );
+
+        // SpMV, assembled CSR
+        TESTING_CHECK( magma_z_spmv( c_one, dA, dx, c_zero, dyref, queue ));
+        start = magma_sync_wtime( queue );
+        for( magma_int_t j=0; j < nrepeat; j++ ) {
+            TESTING_CHECK( magma_z_spmv( c_one, dA, dx, c_zero, dyref, queue ));
+        }
+        end = magma_sync_wtime( queue );
+        csr_time = (end - start) / nrepeat;
+
+        // SpMV, matrix-free
+        TESTING_CHECK( magma_z_spmv( c_one, dOp, dx, c_zero, dy, queue ));
+        start = magma_sync_wtime( queue );
+        for( magma_int_t j=0; j < nrepeat; j++ ) {
+            TESTING_CHECK( magma_z_spmv( c_one, dOp, dx, c_zero, dy, queue ));
+        }
+        end = magma_sync_wtime( queue );
+        op_time = (end - start) / nrepeat;
+
+        norm = magma_dznrm2( nn, dyref.dval, 1, queue );
+        magma_zaxpy( nn, c_neg_one, dyref.dval, 1, dy.dval, 1, queue );
+        error = magma_dznrm2( nn, dy.dval, 1, queue ) / norm;
+
+        // SpMV with a block of vectors
+        real_Double_t csr_block, op_block;
+        start = magma_sync_wtime( queue );
+        TESTING_CHECK( magma_z_spmv( c_one, dA, dX, c_zero, dYref, queue ));
+        end = magma_sync_wtime( queue );
+        csr_block = end - start;
+        start = magma_sync_wtime( queue );
+        TESTING_CHECK( magma_z_spmv( c_one, dOp, dX, c_zero, dY, queue ));
+        end = magma_sync_wtime( queue );
+        op_block = end - start;
+        norm = magma_dznrm2( nn*num_vecs, dYref.dval, 1, queue );
+        magma_zaxpy( nn*num_vecs, c_neg_one, dYref.dval, 1, dY.dval, 1, queue );
+        error = max( error, magma_dznrm2( nn*num_vecs, dY.dval, 1, queue ) / norm );
+
+        // SpMV, matrix-free on the CPU
+        TESTING_CHECK( magma_zvinit( &hy, Magma_CPU, nn, 1, c_zero, queue ));
+        TESTING_CHECK( magma_zvinit( &hyop, Magma_CPU, nn, 1, c_zero, queue ));
+        for( magma_int_t k=0; k < nn; k++ ) {
+            hyop.val[k] = hx.val[k];  // first column of hx
+        }
+        TESTING_CHECK( magma_z_spmv( c_one, hOp, hyop, c_zero, hy, queue ));
+        magma_zmfree( &hyop, queue );
+        TESTING_CHECK( magma_zmtransfer( dyref, &hyop, Magma_DEV, Magma_CPU, queue ));
+        double diff = 0, ref = 0;
+        for( magma_int_t k=0; k < nn; k++ ) {
+            diff += MAGMA_Z_ABS( hy.val[k] - hyop.val[k] ) * MAGMA_Z_ABS( hy.val[k] - hyop.val[k] );
+            ref  += MAGMA_Z_ABS( hyop.val[k] ) * MAGMA_Z_ABS( hyop.val[k] );
+        }
+        error = max( error, sqrt( diff / ref ));
+
+        // solver, assembled CSR and matrix-free
+        TESTING_CHECK( magma_zvinit( &b, Magma_DEV, nn, 1, c_one, queue ));
+        TESTING_CHECK( magma_zvinit( &x, Magma_DEV, nn, 1, c_zero, queue ));
+        TESTING_CHECK( magma_z_precondsetup( hA, b, &zopts.solver_par, &zopts.precond_par, queue ));
+        info = magma_z_solver( dA, b, &x, &zopts, queue );
+        csr_iter  = zopts.solver_par.numiter;
+        csr_solve = zopts.solver_par.runtime;
+        magma_zprecondfree( &zopts.precond_par, queue );
+        if ( info != 0 ) {
+            printf( "%% error: CSR solver returned: %s (%lld).\n",
+                    magma_strerror( info ), (long long) info );
+        }
+
+        TESTING_CHECK( magma_zvinit( &x, Magma_DEV, nn, 1, c_zero, queue ));
+        TESTING_CHECK( magma_z_precondsetup( dOp, b, &zopts.solver_par, &zopts.precond_par, queue ));
+        info = magma_z_solver( dOp, b, &x, &zopts, queue );
+        op_iter  = zopts.solver_par.numiter;
+        op_solve = zopts.solver_par.runtime;
+        magma_zprecondfree( &zopts.precond_par, queue );
+        if ( info != 0 ) {
+            printf( "%% error: operator solver returned: %s (%lld).\n",
+                    magma_strerror( info ), (long long) info );
+        }
+
+        // iteration counts may differ slightly due to rounding
+        bool okay = (error < tol);
+        status += ! okay;
+        printf( "%5lld  %6lld  %8lld  %9lld   %9.2e        %9.2e          %9.2e %9.2e   %9.2e   %5lld %9.2e       %5lld %9.2e   %s\n",
+                (long long) n, (long long) points, (long long) nn, (long long) hA.nnz,
+                csr_time, op_time, csr_block, op_block, error,
+                (long long) csr_iter, csr_solve, (long long) op_iter, op_solve,
+                (okay ? "ok" : "failed") );
+        fflush( stdout );
+
+        magma_zmfree( &hA, queue );
+        magma_zmfree( &dA, queue );
+        magma_zmfree( &dOp, queue );
+        magma_zmfree( &hOp, queue );
+        magma_zmfree( &hx, queue );
+        magma_zmfree( &hy, queue );
+        magma_zmfree( &hyop, queue );
+        magma_zmfree( &dx, queue );
+        magma_zmfree( &dy, queue );
+        magma_zmfree( &dyref, queue );
+        magma_zmfree( &dX, queue );
+        magma_zmfree( &dY, queue );
+        magma_zmfree( &dYref, queue );
+        magma_zmfree( &b, queue );
+        magma_zmfree( &x, queue );
+    }
+
+    magma_zsolverinfo_free( &zopts.solver_par, &zopts.precond_par, queue );
+    magma_queue_destroy( queue );
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
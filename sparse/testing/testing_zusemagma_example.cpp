@@ -71,6 +71,7 @@ int main ()
     opts.solver_par.maxiter = 1000;
     opts.solver_par.rtol = 1e-10;
     opts.solver_par.maxiter = 1000;
+    opts.solver_par.perf.enabled = 0;
     opts.precond_par.solver = Magma_ILU;
     opts.precond_par.levels = 0;
     opts.precond_par.trisolver = Magma_CUSOLVE;
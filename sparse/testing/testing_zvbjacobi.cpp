@@ -0,0 +1,150 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing the variable-block Jacobi preconditioner
+   Compares scalar Jacobi with the CPU variable-block Jacobi for largest
+   block sizes 1, 2, 4, ..., 32: number of blocks, setup time, time of one
+   application on host vectors, and iterations and time of a preconditioned
+   solve (--solver, default PCG).
+
+   usage: testing_zvbjacobi [ solver options ] LAPLACE2D n | matrix.mtx ...
+*/
+int main(  int argc, char** argv )
+{
+    magma_int_t info = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts;
+    magma_queue_t queue;
+    magma_queue_create( 0, &queue );
+
+    magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    magma_z_matrix A={Magma_CSR}, B={Magma_CSR}, dB={Magma_CSR};
+    magma_z_matrix x={Magma_CSR}, b={Magma_CSR}, y={Magma_CSR};
+    magma_z_matrix hb={Magma_CSR}, hy={Magma_CSR};
+    real_Double_t tempo1, tempo2, t_apply;
+    const magma_int_t napply = 10;
+    const magma_int_t maxbs = 32;
+
+    int status = 0;
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+    B.blocksize = zopts.blocksize;
+    B.alignment = zopts.alignment;
+    if ( zopts.solver_par.solver == Magma_CGMERGE ) {
+        // the parser default does not take a preconditioner
+        zopts.solver_par.solver = Magma_PCG;
+    }
+
+    TESTING_CHECK( magma_zsolverinfo_init( &zopts.solver_par, &zopts.precond_par, queue ));
+    double tol = 100 * zopts.solver_par.rtol;
+
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else if ( strcmp("LAPLACE3D27", argv[i]) == 0 && i+1 < argc ) {
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_27stencil(  laplace_size, &A, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+        TESTING_CHECK( magma_zmscale( &A, zopts.scaling, queue ));
+        TESTING_CHECK( magma_zmconvert( A, &B, Magma_CSR, zopts.output_format, queue ));
+        TESTING_CHECK( magma_zmtransfer( B, &dB, Magma_CPU, Magma_DEV, queue ));
+        TESTING_CHECK( magma_zvinit( &b, Magma_DEV, A.num_rows, 1, c_one, queue ));
+        TESTING_CHECK( magma_zvinit( &y, Magma_DEV, A.num_rows, 1, c_zero, queue ));
+        TESTING_CHECK( magma_zvinit( &hb, Magma_CPU, A.num_rows, 1, c_one, queue ));
+        TESTING_CHECK( magma_zvinit( &hy, Magma_CPU, A.num_rows, 1, c_zero, queue ));
+        double nomb = magma_dznrm2( A.num_rows, b.dval, 1, queue );
+
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz );
+        printf( "%% preconditioner     blocks   setup (sec)   apply (sec)   iter   solve (sec)   |b-Ax|/|b|\n" );
+        printf( "%%=========================================================================================\n" );
+
+        // scalar Jacobi (device) as the reference, then block sizes 1..32 on the CPU
+        for( magma_int_t bs=0; bs <= maxbs; bs = (bs == 0 ? 1 : 2*bs) ) {
+            magma_int_t nblocks;
+            if ( bs == 0 ) {
+                zopts.precond_par.solver = Magma_JACOBI;
+            } else {
+                zopts.precond_par.solver = Magma_VBJACOBI;
+                zopts.precond_par.pattern = bs;
+            }
+            TESTING_CHECK( magma_z_precondsetup( dB, b, &zopts.solver_par, &zopts.precond_par, queue ));
+
+            tempo1 = magma_sync_wtime( queue );
+            for( magma_int_t k=0; k < napply; k++ ) {
+                if ( bs == 0 ) {
+                    TESTING_CHECK( magma_z_applyprecond_left( MagmaNoTrans, dB, b, &y, &zopts.precond_par, queue ));
+                } else {
+                    TESTING_CHECK( magma_zapplyvbjacobi( hb, &hy, &zopts.precond_par, queue ));
+                }
+            }
+            tempo2 = magma_sync_wtime( queue );
+            t_apply = (tempo2 - tempo1) / napply;
+            nblocks = ( bs == 0 ) ? A.num_rows : zopts.precond_par.M.numblocks;
+
+            TESTING_CHECK( magma_zvinit( &x, Magma_DEV, A.num_cols, 1, c_zero, queue ));
+            info = magma_z_solver( dB, b, &x, &zopts, queue );
+            if ( info != 0 && info != MAGMA_SLOW_CONVERGENCE ) {
+                printf( "%% error: solver returned: %s (%lld).\n",
+                        magma_strerror( info ), (long long) info );
+            }
+            double error = zopts.solver_par.final_res / nomb;
+            bool okay = (error < tol);
+            status += ! okay;
+            if ( bs == 0 ) {
+                printf( "  Jacobi           " );
+            } else {
+                printf( "  block Jacobi %3lld ", (long long) bs );
+            }
+            printf( " %8lld   %11.6f   %11.6f  %5lld   %11.4f    %9.2e   %s\n",
+                    (long long) nblocks, zopts.precond_par.setuptime, t_apply,
+                    (long long) zopts.solver_par.numiter, zopts.solver_par.runtime,
+                    error, (okay ? "ok" : "failed") );
+            fflush( stdout );
+            magma_zmfree( &x, queue );
+            magma_zprecondfree( &zopts.precond_par, queue );
+        }
+
+        magma_zmfree( &dB, queue );
+        magma_zmfree( &B, queue );
+        magma_zmfree( &A, queue );
+        magma_zmfree( &b, queue );
+        magma_zmfree( &y, queue );
+        magma_zmfree( &hb, queue );
+        magma_zmfree( &hy, queue );
+        i++;
+    }
+
+    magma_zsolverinfo_free( &zopts.solver_par, &zopts.precond_par, queue );
+    magma_queue_destroy( queue );
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
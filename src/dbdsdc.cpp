@@ -0,0 +1,726 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal d -> s
+
+       Bidiagonal divide and conquer SVD on the host.
+       The tree and the deflation follow LAPACK dbdsdc, dlasd0, dlasd1;
+       independent subproblems are solved and merged by OpenMP threads, and
+       the secular equations of each merge are solved in parallel.
+*/
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(MAGMA_WITH_MKL)
+#include <mkl_service.h>
+#endif
+
+#include "magma_internal.h"
+
+#define U(i_, j_)   (U   + (i_) + (j_)*ldu)
+#define VT(i_, j_)  (VT  + (i_) + (j_)*ldvt)
+#define Q(i_, j_)   (Q   + (i_) + (j_)*ldq)
+#define U2(i_, j_)  (U2  + (i_) + (j_)*ldu2)
+#define VT2(i_, j_) (VT2 + (i_) + (j_)*ldvt2)
+
+// Leaves of the tree are at most this size (LAPACK ilaenv( 9, "DBDSDC" ))
+static const magma_int_t bdsdc_smlsiz = 25;
+
+
+/******************************************************************************/
+// Inside a parallel region, each thread calls sequential BLAS on its
+// subproblem. MKL is told so per thread; OpenMP builds of other BLAS
+// libraries already do not nest.
+static int dbdsdc_blas_local_begin()
+{
+    #if defined(MAGMA_WITH_MKL)
+    return mkl_set_num_threads_local( 1 );
+    #else
+    return 0;
+    #endif
+}
+
+static void dbdsdc_blas_local_end( int saved )
+{
+    #if defined(MAGMA_WITH_MKL)
+    mkl_set_num_threads_local( saved );
+    #endif
+}
+
+
+/******************************************************************************/
+// Finds the K nonzero singular values of the deflated merged problem by
+// solving the secular equations, and updates U and VT. Same as LAPACK
+// dlasd3, except the secular equations, the updated z, and the singular
+// vectors of the rank-one modified diagonal matrix are computed by nthread
+// threads, one root or one row per iteration.
+static void dbdsdc_lasd3(
+    magma_int_t nl, magma_int_t nr, magma_int_t sqre, magma_int_t k,
+    double *d, double *Q, magma_int_t ldq, double *dsigma,
+    double *U,   magma_int_t ldu,
+    double *U2,  magma_int_t ldu2,
+    double *VT,  magma_int_t ldvt,
+    double *VT2, magma_int_t ldvt2,
+    const magma_int_t *idxc, const magma_int_t *ctot, double *z,
+    magma_int_t nthread, magma_int_t *info )
+{
+    const double c_zero = 0, c_one = 1;
+    const magma_int_t ione = 1, izero = 0;
+
+    magma_int_t n    = nl + nr + 1;
+    magma_int_t m    = n + sqre;
+    magma_int_t nlp1 = nl + 1;
+    magma_int_t nrp1, ktemp, ctemp, i, iinfo;
+    double rho;
+
+    *info = 0;
+
+    // Quick return if possible
+    if (k == 1) {
+        d[0] = fabs( z[0] );
+        blasf77_dcopy( &m, VT2, &ldvt2, VT, &ldvt );
+        if (z[0] > 0) {
+            blasf77_dcopy( &n, U2, &ione, U, &ione );
+        }
+        else {
+            for (i = 0; i < n; ++i) {
+                U[i] = -U2[i];
+            }
+        }
+        return;
+    }
+
+    // Modify values DSIGMA(i) to make sure all DSIGMA(i)-DSIGMA(j) can
+    // be computed with high relative accuracy (barring over/underflow);
+    // see dlaex3.
+    for (i = 0; i < k; ++i) {
+        dsigma[i] = lapackf77_dlamc3( &dsigma[i], &dsigma[i] ) - dsigma[i];
+    }
+
+    // Keep a copy of z in Q(:,0), and normalize z.
+    blasf77_dcopy( &k, z, &ione, Q, &ione );
+    rho = magma_cblas_dnrm2( k, z, 1 );
+    lapackf77_dlascl( "G", &izero, &izero, &rho, &c_one, &k, &ione, z, &k, &iinfo );
+    rho = rho*rho;
+
+    // Find the new singular values.
+    #pragma omp parallel for num_threads( nthread ) schedule(dynamic, 8)
+    for (magma_int_t j = 0; j < k; ++j) {
+        magma_int_t jp1 = j + 1;
+        magma_int_t jinfo = 0;
+        lapackf77_dlasd4( &k, &jp1, dsigma, z, U(0,j), &rho, &d[j], VT(0,j), &jinfo );
+        // If the zero finder fails, report the convergence failure.
+        if (jinfo != 0) {
+            #pragma omp critical (dbdsdc_info)
+            *info = jinfo;
+        }
+    }
+    if (*info != 0) {
+        return;
+    }
+
+    // Compute updated z, from the old z kept in Q(:,0).
+    #pragma omp parallel for num_threads( nthread ) schedule(static)
+    for (magma_int_t ii = 0; ii < k; ++ii) {
+        double zi = *U(ii,k-1) * *VT(ii,k-1);
+        for (magma_int_t j = 0; j < ii; ++j) {
+            zi *= ( *U(ii,j) * *VT(ii,j) / (dsigma[ii] - dsigma[j]) / (dsigma[ii] + dsigma[j]) );
+        }
+        for (magma_int_t j = ii; j < k-1; ++j) {
+            zi *= ( *U(ii,j) * *VT(ii,j) / (dsigma[ii] - dsigma[j+1]) / (dsigma[ii] + dsigma[j+1]) );
+        }
+        z[ii] = copysign( sqrt( fabs( zi )), *Q(ii,0) );
+    }
+
+    // Compute left singular vectors of the modified diagonal matrix,
+    // and store related information for the right singular vectors.
+    #pragma omp parallel for num_threads( nthread ) schedule(static)
+    for (magma_int_t ii = 0; ii < k; ++ii) {
+        *VT(0,ii) = z[0] / *U(0,ii) / *VT(0,ii);
+        *U(0,ii)  = -c_one;
+        for (magma_int_t j = 1; j < k; ++j) {
+            *VT(j,ii) = z[j] / *U(j,ii) / *VT(j,ii);
+            *U(j,ii)  = dsigma[j] * *VT(j,ii);
+        }
+        double temp = magma_cblas_dnrm2( k, U(0,ii), 1 );
+        *Q(0,ii) = *U(0,ii) / temp;
+        for (magma_int_t j = 1; j < k; ++j) {
+            *Q(j,ii) = *U(idxc[j]-1, ii) / temp;
+        }
+    }
+
+    // Update the left singular vector matrix.
+    if (k == 2) {
+        blasf77_dgemm( "N", "N", &n, &k, &k,
+                       &c_one,  U2, &ldu2, Q, &ldq,
+                       &c_zero, U,  &ldu );
+    }
+    else {
+        if (ctot[0] > 0) {
+            blasf77_dgemm( "N", "N", &nl, &k, &ctot[0],
+                           &c_one,  U2(0,1), &ldu2, Q(1,0), &ldq,
+                           &c_zero, U(0,0),  &ldu );
+            if (ctot[2] > 0) {
+                ktemp = 1 + ctot[0] + ctot[1];
+                blasf77_dgemm( "N", "N", &nl, &k, &ctot[2],
+                               &c_one, U2(0,ktemp), &ldu2, Q(ktemp,0), &ldq,
+                               &c_one, U(0,0),      &ldu );
+            }
+        }
+        else if (ctot[2] > 0) {
+            ktemp = 1 + ctot[0] + ctot[1];
+            blasf77_dgemm( "N", "N", &nl, &k, &ctot[2],
+                           &c_one,  U2(0,ktemp), &ldu2, Q(ktemp,0), &ldq,
+                           &c_zero, U(0,0),      &ldu );
+        }
+        else {
+            lapackf77_dlacpy( "F", &nl, &k, U2, &ldu2, U, &ldu );
+        }
+        blasf77_dcopy( &k, Q(0,0), &ldq, U(nl,0), &ldu );
+        ktemp = 1 + ctot[0];
+        ctemp = ctot[1] + ctot[2];
+        blasf77_dgemm( "N", "N", &nr, &k, &ctemp,
+                       &c_one,  U2(nlp1,ktemp), &ldu2, Q(ktemp,0), &ldq,
+                       &c_zero, U(nlp1,0),      &ldu );
+    }
+
+    // Generate the right singular vectors.
+    #pragma omp parallel for num_threads( nthread ) schedule(static)
+    for (magma_int_t ii = 0; ii < k; ++ii) {
+        double temp = magma_cblas_dnrm2( k, VT(0,ii), 1 );
+        *Q(ii,0) = *VT(0,ii) / temp;
+        for (magma_int_t j = 1; j < k; ++j) {
+            *Q(ii,j) = *VT(idxc[j]-1, ii) / temp;
+        }
+    }
+
+    // Update the right singular vector matrix.
+    if (k == 2) {
+        blasf77_dgemm( "N", "N", &k, &m, &k,
+                       &c_one,  Q,  &ldq, VT2, &ldvt2,
+                       &c_zero, VT, &ldvt );
+        return;
+    }
+    ktemp = 1 + ctot[0];
+    blasf77_dgemm( "N", "N", &k, &nlp1, &ktemp,
+                   &c_one,  Q(0,0),  &ldq, VT2(0,0), &ldvt2,
+                   &c_zero, VT(0,0), &ldvt );
+    ktemp = 1 + ctot[0] + ctot[1];
+    if (ktemp < ldvt2) {
+        blasf77_dgemm( "N", "N", &k, &nlp1, &ctot[2],
+                       &c_one, Q(0,ktemp), &ldq, VT2(ktemp,0), &ldvt2,
+                       &c_one, VT(0,0),    &ldvt );
+    }
+
+    ktemp = ctot[0];
+    nrp1  = nr + sqre;
+    if (ktemp > 0) {
+        for (i = 0; i < k; ++i) {
+            *Q(i,ktemp) = *Q(i,0);
+        }
+        for (i = nlp1; i < m; ++i) {
+            *VT2(ktemp,i) = *VT2(0,i);
+        }
+    }
+    ctemp = 1 + ctot[1] + ctot[2];
+    blasf77_dgemm( "N", "N", &k, &nrp1, &ctemp,
+                   &c_one,  Q(0,ktemp),     &ldq, VT2(ktemp,nlp1), &ldvt2,
+                   &c_zero, VT(0,nlp1),     &ldvt );
+}
+
+
+/******************************************************************************/
+// Merges the SVDs of two adjacent upper bidiagonal subproblems, of sizes
+// NL and NR, joined by the row [alpha, beta]. Same as LAPACK dlasd1, with
+// the secular equations solved by dbdsdc_lasd3.
+// work is 3*M^2 + 2*M and iwork is 4*N, with N = NL + NR + 1, M = N + SQRE.
+static void dbdsdc_lasd1(
+    magma_int_t nl, magma_int_t nr, magma_int_t sqre,
+    double *d, double alpha, double beta,
+    double *U,  magma_int_t ldu,
+    double *VT, magma_int_t ldvt,
+    magma_int_t *idxq, magma_int_t *iwork, double *work,
+    magma_int_t nthread, magma_int_t *info )
+{
+    const double c_one = 1;
+    const magma_int_t ione = 1, izero = 0, ineg_one = -1;
+
+    magma_int_t n     = nl + nr + 1;
+    magma_int_t m     = n + sqre;
+    magma_int_t ldu2  = n;
+    magma_int_t ldvt2 = m;
+    magma_int_t k, ldq, n1, n2, i;
+    double orgnrm;
+
+    // Pointers into the workspace used by dlasd2 and dbdsdc_lasd3.
+    double *z      = work;
+    double *dsigma = z + m;
+    double *U2     = dsigma + n;
+    double *VT2    = U2 + ldu2*n;
+    double *Q      = VT2 + ldvt2*m;
+
+    magma_int_t *idx    = iwork;
+    magma_int_t *idxc   = idx  + n;
+    magma_int_t *coltyp = idxc + n;
+    magma_int_t *idxp   = coltyp + n;
+
+    // Scale.
+    orgnrm = max( fabs( alpha ), fabs( beta ));
+    d[nl] = 0;
+    for (i = 0; i < n; ++i) {
+        if (fabs( d[i] ) > orgnrm) {
+            orgnrm = fabs( d[i] );
+        }
+    }
+    lapackf77_dlascl( "G", &izero, &izero, &orgnrm, &c_one, &n, &ione, d, &n, info );
+    alpha /= orgnrm;
+    beta  /= orgnrm;
+
+    // Deflate singular values.
+    lapackf77_dlasd2( &nl, &nr, &sqre, &k, d, z, &alpha, &beta,
+                      U, &ldu, VT, &ldvt, dsigma, U2, &ldu2, VT2, &ldvt2,
+                      idxp, idx, idxc, idxq, coltyp, info );
+
+    // Solve the secular equation and update singular vectors.
+    ldq = k;
+    dbdsdc_lasd3( nl, nr, sqre, k, d, Q, ldq, dsigma,
+                  U, ldu, U2, ldu2, VT, ldvt, VT2, ldvt2,
+                  idxc, coltyp, z, nthread, info );
+    if (*info != 0) {
+        return;
+    }
+
+    // Unscale.
+    lapackf77_dlascl( "G", &izero, &izero, &c_one, &orgnrm, &n, &ione, d, &n, info );
+
+    // Prepare the IDXQ sorting permutation.
+    n1 = k;
+    n2 = n - k;
+    lapackf77_dlamrg( &n1, &n2, d, &ione, &ineg_one, idxq );
+}
+
+
+/******************************************************************************/
+// Computes the SVD of an N-by-M upper bidiagonal matrix, M = N + SQRE, by
+// divide and conquer, as LAPACK dlasd0. The subproblems at the leaves of the
+// tree are solved in parallel. The merges of one level of the tree are
+// independent: when there are at least as many as threads, and their
+// workspaces fit in lwork, each thread merges whole subproblems with
+// sequential BLAS. Otherwise, the merges are done one after the other,
+// each with nthread threads and threaded BLAS.
+// iwork is 8*N, and work is at least 3*M^2 + 2*M.
+static void dbdsdc_lasd0(
+    magma_int_t n, magma_int_t sqre,
+    double *d, double *e,
+    double *U,  magma_int_t ldu,
+    double *VT, magma_int_t ldvt,
+    magma_int_t smlsiz,
+    magma_int_t *iwork, double *work, magma_int_t lwork,
+    magma_int_t nthread, magma_int_t *info )
+{
+    const magma_int_t izero = 0;
+
+    magma_int_t m = n + sqre;
+    magma_int_t nlvl, nd, ndb1, lvl, lf, ll, nnode, wsize, i;
+
+    *info = 0;
+    if (n <= smlsiz) {
+        lapackf77_dlasdq( "U", &sqre, &n, &m, &n, &izero, d, e,
+                          VT, &ldvt, U, &ldu, U, &ldu, work, info );
+        return;
+    }
+
+    // Set up the computation tree. inode holds the (1-based) center row of
+    // each node, ndiml and ndimr the sizes of its left and right subproblems.
+    magma_int_t *inode = iwork;
+    magma_int_t *ndiml = inode + n;
+    magma_int_t *ndimr = ndiml + n;
+    magma_int_t *idxq  = ndimr + n;
+    magma_int_t *iwk   = idxq  + n;
+
+    lapackf77_dlasdt( &n, &nlvl, &nd, inode, ndiml, ndimr, &smlsiz );
+
+    // For the nodes on the bottom level of the tree, solve their
+    // subproblems by dlasdq. Each uses 4*size of work, at its rows.
+    ndb1 = (nd + 1)/2;
+    #pragma omp parallel num_threads( nthread )
+    {
+        int saved = dbdsdc_blas_local_begin();
+
+        #pragma omp for schedule(dynamic)
+        for (magma_int_t inod = ndb1-1; inod < nd; ++inod) {
+            magma_int_t ic  = inode[inod] - 1;
+            magma_int_t nl  = ndiml[inod];
+            magma_int_t nr  = ndimr[inod];
+            magma_int_t nlf = ic - nl;
+            magma_int_t nrf = ic + 1;
+            magma_int_t sqrei = 1;
+            magma_int_t nlp1  = nl + 1;
+            magma_int_t nrp1, iinfo;
+
+            lapackf77_dlasdq( "U", &sqrei, &nl, &nlp1, &nl, &izero, &d[nlf], &e[nlf],
+                              VT(nlf,nlf), &ldvt, U(nlf,nlf), &ldu, U(nlf,nlf), &ldu,
+                              &work[4*nlf], &iinfo );
+            if (iinfo != 0) {
+                #pragma omp critical (dbdsdc_info)
+                *info = iinfo;
+            }
+            for (magma_int_t j = 0; j < nl; ++j) {
+                idxq[nlf + j] = j + 1;
+            }
+
+            sqrei = (inod == nd-1 ? sqre : 1);
+            nrp1  = nr + sqrei;
+            lapackf77_dlasdq( "U", &sqrei, &nr, &nrp1, &nr, &izero, &d[nrf], &e[nrf],
+                              VT(nrf,nrf), &ldvt, U(nrf,nrf), &ldu, U(nrf,nrf), &ldu,
+                              &work[4*nrf], &iinfo );
+            if (iinfo != 0) {
+                #pragma omp critical (dbdsdc_info)
+                *info = iinfo;
+            }
+            for (magma_int_t j = 0; j < nr; ++j) {
+                idxq[nrf + j] = j + 1;
+            }
+        }
+
+        dbdsdc_blas_local_end( saved );
+    }
+    if (*info != 0) {
+        return;
+    }
+
+    // Now conquer each subproblem bottom-up.
+    for (lvl = nlvl; lvl >= 1; --lvl) {
+        // Find the first node lf and last node ll on the current level lvl.
+        if (lvl == 1) {
+            lf = 1;
+            ll = 1;
+        }
+        else {
+            lf = 1 << (lvl-1);
+            ll = 2*lf - 1;
+        }
+        nnode = ll - lf + 1;
+
+        // Workspace for all merges of this level at once
+        wsize = 0;
+        for (i = lf-1; i < ll; ++i) {
+            magma_int_t mi = ndiml[i] + ndimr[i] + 2;
+            wsize += 3*mi*mi + 2*mi;
+        }
+
+        if (nthread > 1 && nnode >= nthread && wsize <= lwork) {
+            #pragma omp parallel num_threads( nthread )
+            {
+                int saved = dbdsdc_blas_local_begin();
+
+                #pragma omp for schedule(dynamic)
+                for (magma_int_t inod = lf-1; inod < ll; ++inod) {
+                    // offset of this merge's workspace
+                    magma_int_t woff = 0;
+                    for (magma_int_t j = lf-1; j < inod; ++j) {
+                        magma_int_t mj = ndiml[j] + ndimr[j] + 2;
+                        woff += 3*mj*mj + 2*mj;
+                    }
+                    magma_int_t ic  = inode[inod] - 1;
+                    magma_int_t nl  = ndiml[inod];
+                    magma_int_t nr  = ndimr[inod];
+                    magma_int_t nlf = ic - nl;
+                    magma_int_t sqrei = (sqre == 0 && inod == ll-1 ? sqre : 1);
+                    magma_int_t iinfo;
+
+                    dbdsdc_lasd1( nl, nr, sqrei, &d[nlf], d[ic], e[ic],
+                                  U(nlf,nlf), ldu, VT(nlf,nlf), ldvt,
+                                  &idxq[nlf], &iwk[4*nlf], &work[woff], 1, &iinfo );
+                    if (iinfo != 0) {
+                        #pragma omp critical (dbdsdc_info)
+                        *info = iinfo;
+                    }
+                }
+
+                dbdsdc_blas_local_end( saved );
+            }
+        }
+        else {
+            for (i = lf-1; i < ll; ++i) {
+                magma_int_t ic  = inode[i] - 1;
+                magma_int_t nl  = ndiml[i];
+                magma_int_t nr  = ndimr[i];
+                magma_int_t nlf = ic - nl;
+                magma_int_t sqrei = (sqre == 0 && i == ll-1 ? sqre : 1);
+
+                dbdsdc_lasd1( nl, nr, sqrei, &d[nlf], d[ic], e[ic],
+                              U(nlf,nlf), ldu, VT(nlf,nlf), ldvt,
+                              &idxq[nlf], &iwk[4*nlf], work, nthread, info );
+                if (*info != 0) {
+                    return;
+                }
+            }
+        }
+        // Report the possible convergence failure.
+        if (*info != 0) {
+            return;
+        }
+    }
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    DBDSDC computes the singular value decomposition (SVD) of a real
+    N-by-N (upper or lower) bidiagonal matrix B:  B = U * S * VT,
+    using a divide and conquer method, where S is a diagonal matrix
+    with non-negative diagonal elements (the singular values of B), and
+    U and VT are orthogonal matrices of left and right singular vectors,
+    respectively. It is a drop-in replacement for LAPACK dbdsdc with
+    COMPQ = 'N' or 'I', with the same workspace; the compact form
+    COMPQ = 'P' is not supported.
+
+    With singular vectors, the divide and conquer tree is the same as in
+    LAPACK, but independent subproblems are solved in parallel by OpenMP
+    threads: all the leaves, and the merges of the lower levels of the tree,
+    where there are many small merges. The few large merges near the root
+    are done one after the other, each solving its secular equations in
+    parallel and updating the singular vectors with threaded dgemm.
+    Matrices of size at most 25 are left to LAPACK dbdsdc, as are
+    singular values only (COMPQ = 'N'), which LAPACK computes with the
+    dqds algorithm.
+
+    The number of threads is magma_get_parallel_numthreads().
+
+    Arguments
+    ---------
+    @param[in]
+    uplo    magma_uplo_t
+      -     = MagmaUpper:  B is upper bidiagonal;
+      -     = MagmaLower:  B is lower bidiagonal.
+
+    @param[in]
+    compq   magma_vec_t
+            Specifies whether singular vectors are to be computed
+            as follows:
+      -     = MagmaNoVec:  Compute singular values only;
+      -     = MagmaIVec:   Compute singular values and singular vectors.
+
+    @param[in]
+    n       INTEGER
+            The order of the matrix B.  N >= 0.
+
+    @param[in,out]
+    d       DOUBLE PRECISION array, dimension (N)
+            On entry, the n diagonal elements of the bidiagonal matrix B.
+            On exit, if INFO=0, the singular values of B, in decreasing
+            order.
+
+    @param[in,out]
+    e       DOUBLE PRECISION array, dimension (N-1)
+            On entry, the elements of E contain the offdiagonal
+            elements of the bidiagonal matrix whose SVD is desired.
+            On exit, E has been destroyed.
+
+    @param[out]
+    U       DOUBLE PRECISION array, dimension (LDU,N)
+            If COMPQ = MagmaIVec, then:
+            On exit, if INFO = 0, U contains the left singular vectors
+            of the bidiagonal matrix.
+            If COMPQ = MagmaNoVec, U is not referenced.
+
+    @param[in]
+    ldu     INTEGER
+            The leading dimension of the array U.  LDU >= 1.
+            If singular vectors are desired, then LDU >= max( 1, N ).
+
+    @param[out]
+    VT      DOUBLE PRECISION array, dimension (LDVT,N)
+            If COMPQ = MagmaIVec, then:
+            On exit, if INFO = 0, VT^T contains the right singular
+            vectors of the bidiagonal matrix.
+            If COMPQ = MagmaNoVec, VT is not referenced.
+
+    @param[in]
+    ldvt    INTEGER
+            The leading dimension of the array VT.  LDVT >= 1.
+            If singular vectors are desired, then LDVT >= max( 1, N ).
+
+    @param
+    work    (workspace) DOUBLE PRECISION array, dimension (MAX(1,LWORK))
+            If COMPQ = MagmaNoVec then LWORK >= 4*N.
+            If COMPQ = MagmaIVec  then LWORK >= 3*N**2 + 4*N.
+
+    @param
+    iwork   (workspace) INTEGER array, dimension (8*N)
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit.
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value.
+      -     > 0:  The algorithm failed to compute a singular value.
+                  The update process of divide and conquer failed.
+
+    Further Details
+    ---------------
+    Based on contributions by
+       Ming Gu and Huan Ren, Computer Science Division, University of
+       California at Berkeley, USA
+
+    @ingroup magma_bdsdc
+*******************************************************************************/
+extern "C" magma_int_t
+magma_dbdsdc(
+    magma_uplo_t uplo, magma_vec_t compq, magma_int_t n,
+    double *d, double *e,
+    double *U,  magma_int_t ldu,
+    double *VT, magma_int_t ldvt,
+    double *work, magma_int_t *iwork,
+    magma_int_t *info )
+{
+    const double c_zero = 0, c_one = 1;
+    const magma_int_t izero = 0, ione = 1;
+
+    magma_int_t nm1, wstart, lwork, nthread, start, nsize, i, ii, j, kk, iinfo;
+    double cs, sn, r, p, orgnrm, eps;
+    double dummy[1];
+    magma_int_t idummy[1];
+
+    bool wantq = (compq == MagmaIVec);
+
+    *info = 0;
+    if (uplo != MagmaUpper && uplo != MagmaLower) {
+        *info = -1;
+    } else if (compq != MagmaNoVec && ! wantq) {
+        *info = -2;
+    } else if (n < 0) {
+        *info = -3;
+    } else if (ldu < 1 || (wantq && ldu < n)) {
+        *info = -7;
+    } else if (ldvt < 1 || (wantq && ldvt < n)) {
+        *info = -9;
+    }
+
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    // Quick return if possible
+    if (n == 0) {
+        return *info;
+    }
+
+    // Singular values only, and small matrices, are left to LAPACK.
+    if (! wantq || n <= bdsdc_smlsiz) {
+        lapackf77_dbdsdc( lapack_uplo_const( uplo ), lapack_vec_const( compq ), &n,
+                          d, e, U, &ldu, VT, &ldvt, dummy, idummy, work, iwork, info );
+        return *info;
+    }
+
+    nthread = magma_get_parallel_numthreads();
+    nm1     = n - 1;
+    lwork   = 3*n*n + 4*n;
+
+    // If matrix lower bidiagonal, rotate to be upper bidiagonal
+    // by applying Givens rotations on the left. The rotations are saved
+    // in work( 0 : 2*n-3 ).
+    wstart = 0;
+    if (uplo == MagmaLower) {
+        wstart = 2*n - 2;
+        for (i = 0; i < nm1; ++i) {
+            lapackf77_dlartg( &d[i], &e[i], &cs, &sn, &r );
+            d[i]   = r;
+            e[i]   = sn*d[i+1];
+            d[i+1] = cs*d[i+1];
+            work[i]       = cs;
+            work[nm1 + i] = -sn;
+        }
+    }
+
+    lapackf77_dlaset( "A", &n, &n, &c_zero, &c_one, U,  &ldu  );
+    lapackf77_dlaset( "A", &n, &n, &c_zero, &c_one, VT, &ldvt );
+
+    // Scale.
+    orgnrm = lapackf77_dlanst( "M", &n, d, e );
+    if (orgnrm == 0) {
+        return *info;
+    }
+    lapackf77_dlascl( "G", &izero, &izero, &orgnrm, &c_one, &n,   &ione, d, &n,   &iinfo );
+    lapackf77_dlascl( "G", &izero, &izero, &orgnrm, &c_one, &nm1, &ione, e, &nm1, &iinfo );
+
+    eps = 0.9*lapackf77_dlamch( "Epsilon" );
+
+    for (i = 0; i < n; ++i) {
+        if (fabs( d[i] ) < eps) {
+            d[i] = copysign( eps, d[i] );
+        }
+    }
+
+    // Split at negligible off-diagonal elements, and apply divide and
+    // conquer to each subproblem.
+    start = 0;
+    for (i = 0; i < nm1; ++i) {
+        if (fabs( e[i] ) < eps || i == nm1-1) {
+            if (i < nm1-1) {
+                // A subproblem with e(i) small for i < n-2.
+                nsize = i - start + 1;
+            }
+            else if (fabs( e[i] ) >= eps) {
+                // A subproblem with e(n-2) not too small but i = n-2.
+                nsize = n - start;
+            }
+            else {
+                // A subproblem with e(n-2) small. This implies an
+                // 1-by-1 subproblem at d(n-1). Solve this 1-by-1 problem
+                // first.
+                nsize = i - start + 1;
+                *U(n-1,n-1)  = copysign( c_one, d[n-1] );
+                *VT(n-1,n-1) = c_one;
+                d[n-1] = fabs( d[n-1] );
+            }
+            dbdsdc_lasd0( nsize, 0, &d[start], &e[start],
+                          U(start,start), ldu, VT(start,start), ldvt,
+                          bdsdc_smlsiz, iwork, &work[wstart], lwork - wstart,
+                          nthread, info );
+            if (*info != 0) {
+                return *info;
+            }
+            start = i + 1;
+        }
+    }
+
+    // Unscale
+    lapackf77_dlascl( "G", &izero, &izero, &c_one, &orgnrm, &n, &ione, d, &n, &iinfo );
+
+    // Use Selection Sort to minimize swaps of singular vectors
+    for (ii = 1; ii < n; ++ii) {
+        i  = ii - 1;
+        kk = i;
+        p  = d[i];
+        for (j = ii; j < n; ++j) {
+            if (d[j] > p) {
+                kk = j;
+                p  = d[j];
+            }
+        }
+        if (kk != i) {
+            d[kk] = d[i];
+            d[i]  = p;
+            blasf77_dswap( &n, U(0,i),  &ione, U(0,kk),  &ione );
+            blasf77_dswap( &n, VT(i,0), &ldvt, VT(kk,0), &ldvt );
+        }
+    }
+
+    // If B is lower bidiagonal, update U by those Givens rotations
+    // which rotated B to be upper bidiagonal
+    if (uplo == MagmaLower) {
+        for (i = nm1-1; i >= 0; --i) {
+            blasf77_drot( &n, U(i,0), &ldu, U(i+1,0), &ldu, &work[i], &work[nm1 + i] );
+        }
+    }
+
+    return *info;
+} /* magma_dbdsdc */
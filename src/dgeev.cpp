@@ -30,6 +30,12 @@
  */
 #define TREVC_VERSION 4
 
+/*
+ * HSEQR version 1 - LAPACK
+ * HSEQR version 2 - multishift QR with AED, multi-threaded (MAGMA)
+ */
+#define HSEQR_VERSION 2
+
 /***************************************************************************//**
     Purpose
     -------
@@ -303,8 +309,13 @@ magma_dgeev(
          *  - including N reserved for gebal/gebak, unused by dhseqr */
         iwrk = itau;
         liwrk = lwork - iwrk;
+        #if HSEQR_VERSION == 1
         lapackf77_dhseqr( "S", "V", &n, &ilo, &ihi, A, &lda, wr, wi,
                           VL, &ldvl, &work[iwrk], &liwrk, info );
+        #elif HSEQR_VERSION == 2
+        magma_dhseqr_mt( MagmaTrue, MagmaVec, n, ilo, ihi, A, lda, wr, wi,
+                         VL, ldvl, magma_get_parallel_numthreads(), info );
+        #endif
         time_sum += timer_stop( time_hseqr );
         flop_sum += flops_stop( flop_hseqr );
 
@@ -344,8 +355,13 @@ magma_dgeev(
         flops_start( flop_hseqr );
         iwrk = itau;
         liwrk = lwork - iwrk;
+        #if HSEQR_VERSION == 1
         lapackf77_dhseqr( "S", "V", &n, &ilo, &ihi, A, &lda, wr, wi,
                           VR, &ldvr, &work[iwrk], &liwrk, info );
+        #elif HSEQR_VERSION == 2
+        magma_dhseqr_mt( MagmaTrue, MagmaVec, n, ilo, ihi, A, lda, wr, wi,
+                         VR, ldvr, magma_get_parallel_numthreads(), info );
+        #endif
         time_sum += timer_stop( time_hseqr );
         flop_sum += flops_stop( flop_hseqr );
     }
@@ -357,8 +373,13 @@ magma_dgeev(
         flops_start( flop_hseqr );
         iwrk = itau;
         liwrk = lwork - iwrk;
+        #if HSEQR_VERSION == 1
         lapackf77_dhseqr( "E", "N", &n, &ilo, &ihi, A, &lda, wr, wi,
                           VR, &ldvr, &work[iwrk], &liwrk, info );
+        #elif HSEQR_VERSION == 2
+        magma_dhseqr_mt( MagmaFalse, MagmaNoVec, n, ilo, ihi, A, lda, wr, wi,
+                         VR, ldvr, magma_get_parallel_numthreads(), info );
+        #endif
         time_sum += timer_stop( time_hseqr );
         flop_sum += flops_stop( flop_hseqr );
     }
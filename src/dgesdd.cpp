@@ -786,7 +786,7 @@ magma_dgesdd(
                 // computing left  singular vectors of bidiagonal matrix in WORK[IU] and
                 // computing right singular vectors of bidiagonal matrix in VT
                 // Workspace: need   N*N [R] + 3*N [e, tauq, taup] + N*N [U] + (3*N*N + 4*N) [bdsdc work]
-                lapackf77_dbdsdc( "U", "I", &n, s, &work[ie], &work[iu], &n, VT, &ldvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, n, s, &work[ie], &work[iu], n, VT, ldvt, &work[nwork], iwork, info );
 
                 // Overwrite WORK[IU] by left  singular vectors of R, and
                 // overwrite VT       by right singular vectors of R
@@ -865,7 +865,7 @@ magma_dgesdd(
                 // computing left  singular vectors of bidiagonal matrix in U and
                 // computing right singular vectors of bidiagonal matrix in VT
                 // Workspace: need   N*N [R] + 3*N [e, tauq, taup] + (3*N*N + 4*N) [bdsdc work]
-                lapackf77_dbdsdc( "U", "I", &n, s, &work[ie], U, &ldu, VT, &ldvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, n, s, &work[ie], U, ldu, VT, ldvt, &work[nwork], iwork, info );
 
                 // Overwrite U  by left  singular vectors of R, and
                 // overwrite VT by right singular vectors of R
@@ -940,7 +940,7 @@ magma_dgesdd(
                 // computing left  singular vectors of bidiagonal matrix in WORK[IU] and
                 // computing right singular vectors of bidiagonal matrix in VT
                 // Workspace: need   N*N [U] + 3*N [e, tauq, taup] + (3*N*N + 4*N) [bdsdc work]
-                lapackf77_dbdsdc( "U", "I", &n, s, &work[ie], &work[iu], &n, VT, &ldvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, n, s, &work[ie], &work[iu], n, VT, ldvt, &work[nwork], iwork, info );
 
                 // Overwrite WORK[IU] by left  singular vectors of R, and
                 // overwrite VT       by right singular vectors of R
@@ -1017,7 +1017,7 @@ magma_dgesdd(
                 // computing left  singular vectors of bidiagonal matrix in WORK[IU] and
                 // computing right singular vectors of bidiagonal matrix in VT
                 // Workspace: need   3*N [e, tauq, taup] + N*N [U] + (3*N*N + 4*N) [bdsdc work]
-                lapackf77_dbdsdc( "U", "I", &n, s, &work[ie], &work[iu], &ldwrku, VT, &ldvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, n, s, &work[ie], &work[iu], ldwrku, VT, ldvt, &work[nwork], iwork, info );
 
                 // Overwrite VT by right singular vectors of A
                 // Workspace: need   3*N [e, tauq, taup] + N*N [U] + N    [ormbr work]
@@ -1075,7 +1075,7 @@ magma_dgesdd(
                 // computing right singular vectors of bidiagonal matrix in VT
                 // Workspace: need   3*N [e, tauq, taup] + (3*N*N + 4*N) [bdsdc work]
                 lapackf77_dlaset( "F", &m, &n, &c_zero, &c_zero, U, &ldu );
-                lapackf77_dbdsdc( "U", "I", &n, s, &work[ie], U, &ldu, VT, &ldvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, n, s, &work[ie], U, ldu, VT, ldvt, &work[nwork], iwork, info );
 
                 // Overwrite U  by left  singular vectors of A, and
                 // overwrite VT by right singular vectors of A
@@ -1098,7 +1098,7 @@ magma_dgesdd(
                 // computing right singular vectors of bidiagonal matrix in VT
                 // Workspace: need   3*N [e, tauq, taup] + (3*N*N + 4*N) [bdsdc work]
                 lapackf77_dlaset( "F", &m, &m, &c_zero, &c_zero, U, &ldu );
-                lapackf77_dbdsdc( "U", "I", &n, s, &work[ie], U, &ldu, VT, &ldvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, n, s, &work[ie], U, ldu, VT, ldvt, &work[nwork], iwork, info );
 
                 // Set the right corner of U to identity matrix
                 if (m > n) {
@@ -1225,7 +1225,7 @@ magma_dgesdd(
                 // computing left  singular vectors of bidiagonal matrix in U, and
                 // computing right singular vectors of bidiagonal matrix in WORK[IVT]
                 // Workspace: need   M*M [VT] + M*M [L] + 3*M [e, tauq, taup] + (3*M*M + 4*M) [bdsdc work]
-                lapackf77_dbdsdc( "U", "I", &m, s, &work[ie], U, &ldu, &work[ivt], &m, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, m, s, &work[ie], U, ldu, &work[ivt], m, &work[nwork], iwork, info );
 
                 // Overwrite U         by left  singular vectors of L, and
                 // overwrite WORK[IVT] by right singular vectors of L
@@ -1308,7 +1308,7 @@ magma_dgesdd(
                 // computing left  singular vectors of bidiagonal matrix in U and
                 // computing right singular vectors of bidiagonal matrix in VT
                 // Workspace: need   M*M [L] + 3*M [e, tauq, taup] + (3*M*M + 4*M) [bdsdc work]
-                lapackf77_dbdsdc( "U", "I", &m, s, &work[ie], U, &ldu, VT, &ldvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, m, s, &work[ie], U, ldu, VT, ldvt, &work[nwork], iwork, info );
 
                 // Overwrite U  by left  singular vectors of L, and
                 // overwrite VT by right singular vectors of L
@@ -1383,7 +1383,7 @@ magma_dgesdd(
                 // computing left  singular vectors of bidiagonal matrix in U and
                 // computing right singular vectors of bidiagonal matrix in WORK[IVT]
                 // Workspace: need   M*M [VT] + 3*M [e, tauq, taup] + (3*M*M + 4*M) [bdsdc work]
-                lapackf77_dbdsdc( "U", "I", &m, s, &work[ie], U, &ldu, &work[ivt], &ldwrkvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, m, s, &work[ie], U, ldu, &work[ivt], ldwrkvt, &work[nwork], iwork, info );
 
                 // Overwrite U         by left  singular vectors of L, and
                 // overwrite WORK[IVT] by right singular vectors of L
@@ -1460,7 +1460,7 @@ magma_dgesdd(
                 // computing left  singular vectors of bidiagonal matrix in U and
                 // computing right singular vectors of bidiagonal matrix in WORK[IVT]
                 // Workspace: need   3*M [e, tauq, taup] + M*M [VT] + (3*M*M + 4*M) [bdsdc work]
-                lapackf77_dbdsdc( "L", "I", &m, s, &work[ie], U, &ldu, &work[ivt], &ldwrkvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaIVec, m, s, &work[ie], U, ldu, &work[ivt], ldwrkvt, &work[nwork], iwork, info );
 
                 // Overwrite U by left singular vectors of A
                 // Workspace: need   3*M [e, tauq, taup] + M*M [VT] + M    [ormbr work]
@@ -1517,7 +1517,7 @@ magma_dgesdd(
                 // computing right singular vectors of bidiagonal matrix in VT
                 // Workspace: need   3*M [e, tauq, taup] + (3*M*M + 4*M) [bdsdc work]
                 lapackf77_dlaset( "F", &m, &n, &c_zero, &c_zero, VT, &ldvt );
-                lapackf77_dbdsdc( "L", "I", &m, s, &work[ie], U, &ldu, VT, &ldvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaIVec, m, s, &work[ie], U, ldu, VT, ldvt, &work[nwork], iwork, info );
 
                 // Overwrite U  by left  singular vectors of A, and
                 // overwrite VT by right singular vectors of A
@@ -1540,7 +1540,7 @@ magma_dgesdd(
                 // computing right singular vectors of bidiagonal matrix in VT
                 // Workspace: need   3*M [e, tauq, taup] + (3*M*M + 4*M) [bdsdc work]
                 lapackf77_dlaset( "F", &n, &n, &c_zero, &c_zero, VT, &ldvt );
-                lapackf77_dbdsdc( "L", "I", &m, s, &work[ie], U, &ldu, VT, &ldvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaIVec, m, s, &work[ie], U, ldu, VT, ldvt, &work[nwork], iwork, info );
 
                 // Set the right corner of VT to identity matrix
                 if (n > m) {
@@ -0,0 +1,563 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal d -> s
+*/
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(MAGMA_WITH_MKL)
+#include <mkl_service.h>
+#endif
+
+#include "magma_internal.h"
+
+// block size of the tiled solve
+const magma_int_t laqtrs3d_nb = 64;
+
+
+/******************************************************************************/
+// Inside the parallel region, each thread calls sequential BLAS on its tiles.
+static int dlaqtrs3d_blas_local_begin()
+{
+    #if defined(MAGMA_WITH_MKL)
+    return mkl_set_num_threads_local( 1 );
+    #else
+    return 0;
+    #endif
+}
+
+static void dlaqtrs3d_blas_local_end( int saved )
+{
+    #if defined(MAGMA_WITH_MKL)
+    mkl_set_num_threads_local( saved );
+    #endif
+}
+
+
+/******************************************************************************/
+// Solves the diagonal tile, (T - (wr + i*wi) I)**op * x = s*b, where x and b
+// are real (nw = 1) or hold the real and imaginary parts of a complex vector
+// (nw = 2), by substitution over the 1x1 and 2x2 blocks of T with dlaln2, as
+// in dlaqtrsd. The tile x is scaled by s, which is returned.
+// cnorm holds the 1-norms of the columns of the strictly upper triangle of T.
+static double dlaqtrs3d_diag(
+    bool notran, magma_int_t m,
+    const double *T, magma_int_t ldt,
+    double wr, double wi, magma_int_t nw,
+    double *x, magma_int_t ldx,
+    const double *cnorm, double smlnum, double bignum )
+{
+    #define T(i_, j_)  (T + (i_) + (j_)*ldt)
+    #define x(i_, j_)  (x + (i_) + (j_)*ldx)
+    #define W(i_, j_)  (W + (i_) + (j_)*2)
+
+    const magma_int_t ione = 1;
+    const double ulp = lapackf77_dlamch( "Precision" );
+
+    magma_int_t ierr, j, j1, j2, jnxt, na, c, r;
+    double smin, s, xnorm, vmax, vcrit, rec, beta, tmp, scale;
+    double W[4];
+
+    smin = max( ulp*(fabs(wr) + fabs(wi)), smlnum );
+    scale = 1.;
+
+    if ( notran ) {
+        // backward substitution; update the right-hand side by columns
+        jnxt = m-1;
+        for( j=m-1; j >= 0; --j ) {
+            if ( j > jnxt ) {
+                continue;
+            }
+            j1 = j;
+            j2 = j;
+            jnxt = j - 1;
+            if ( j > 0 && *T(j,j-1) != 0. ) {
+                j1   = j - 1;
+                jnxt = j - 2;
+            }
+            na = j2 - j1 + 1;
+
+            magma_dlaln2( false, na, nw, smin, 1., T(j1,j1), ldt, 1., 1.,
+                          x(j1,0), ldx, wr, wi, W, 2, &s, &xnorm, &ierr );
+
+            // Scale W to avoid overflow when updating the right-hand side.
+            if ( xnorm > 1. ) {
+                beta = max( cnorm[j1], cnorm[j2] );
+                if ( beta > bignum / xnorm ) {
+                    rec = 1. / xnorm;
+                    for( c=0; c < 4; ++c ) {
+                        W[c] *= rec;
+                    }
+                    s *= rec;
+                }
+            }
+
+            // Scale if necessary
+            if ( s != 1. ) {
+                for( c=0; c < nw; ++c ) {
+                    blasf77_dscal( &m, &s, x(0,c), &ione );
+                }
+                scale *= s;
+            }
+            for( c=0; c < nw; ++c ) {
+                for( r=0; r < na; ++r ) {
+                    *x(j1+r,c) = *W(r,c);
+                }
+            }
+
+            // Update the right-hand side
+            for( c=0; c < nw; ++c ) {
+                for( r=0; r < na; ++r ) {
+                    tmp = -(*W(r,c));
+                    blasf77_daxpy( &j1, &tmp, T(0,j1+r), &ione, x(0,c), &ione );
+                }
+            }
+        }
+    }
+    else {
+        // forward substitution; form the right-hand side by dot products
+        vmax = 1.;
+        vcrit = bignum;
+        jnxt = 0;
+        for( j=0; j < m; ++j ) {
+            if ( j < jnxt ) {
+                continue;
+            }
+            j1 = j;
+            j2 = j;
+            jnxt = j + 1;
+            if ( j < m-1 && *T(j+1,j) != 0. ) {
+                j2   = j + 1;
+                jnxt = j + 2;
+            }
+            na = j2 - j1 + 1;
+
+            // Scale if necessary to avoid overflow when forming the
+            // right-hand side.
+            beta = max( cnorm[j1], cnorm[j2] );
+            if ( beta > vcrit ) {
+                rec = 1. / vmax;
+                for( c=0; c < nw; ++c ) {
+                    blasf77_dscal( &m, &rec, x(0,c), &ione );
+                }
+                scale *= rec;
+                vmax = 1.;
+                vcrit = bignum;
+            }
+            for( c=0; c < nw; ++c ) {
+                for( r=0; r < na; ++r ) {
+                    *x(j1+r,c) -= magma_cblas_ddot( j1, T(0,j1+r), ione, x(0,c), ione );
+                }
+            }
+
+            magma_dlaln2( true, na, nw, smin, 1., T(j1,j1), ldt, 1., 1.,
+                          x(j1,0), ldx, wr, wi, W, 2, &s, &xnorm, &ierr );
+
+            // Scale if necessary
+            if ( s != 1. ) {
+                for( c=0; c < nw; ++c ) {
+                    blasf77_dscal( &m, &s, x(0,c), &ione );
+                }
+                scale *= s;
+            }
+            for( c=0; c < nw; ++c ) {
+                for( r=0; r < na; ++r ) {
+                    *x(j1+r,c) = *W(r,c);
+                    vmax = max( fabs( *W(r,c) ), vmax );
+                }
+            }
+            vcrit = bignum / vmax;
+        }
+    }
+    return scale;
+
+    #undef T
+    #undef x
+    #undef W
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    DLAQTRS3D solves one of the quasi-triangular systems with modified
+    diagonals
+       (T - lambda(j)*I)    * x(j) = scale(j)*b(j),  or
+       (T - lambda(j)*I)**T * x(j) = scale(j)*b(j),
+    for a set of right-hand sides b(j), with scaling to prevent overflow.
+    Here T is an upper quasi-triangular matrix with 1x1 and 2x2 diagonal
+    blocks, in Schur canonical form. Each right-hand side has its own shift
+    lambda(j) = wr(j) + i*wi(j). If lambda(j) is real, x(j) and b(j) are
+    real and take one column of X; if it is complex, they are complex and
+    take two consecutive columns of X, the real part and the imaginary part.
+
+    This is the blocked, multiple right-hand side counterpart of dlaqtrsd,
+    following the robust triangular solve of Mikkelsen and Karlsson
+    (LAPACK's dlatrs3). T is cut into tiles of about nb rows, without
+    splitting its 2x2 blocks. The diagonal tiles are solved one right-hand
+    side at a time with dlaln2; the off-diagonal tiles update all
+    right-hand sides with dgemm. Each tile of each right-hand side keeps its
+    own scale factor, and before each update magma_dlarmm picks the factor
+    that keeps the update from overflowing. The local factors are
+    reconciled at the end into scale(j). As in dlaqtrsd, diagonal entries
+    of T - lambda(j)*I smaller than about ulp*|lambda(j)| are perturbed,
+    so T - lambda(j)*I is never singular.
+
+    The right-hand sides are solved in parallel on the diagonal tiles, and
+    the updates in parallel over the tile rows, by nthread OpenMP threads.
+    It does not modify T during the computation.
+
+    Arguments
+    ---------
+    @param[in]
+    trans   magma_trans_t
+            Specifies the operation applied to T.
+      -     = MagmaNoTrans:    Solve (T - lambda*I)    * X = B*diag(scale)
+      -     = MagmaTrans:      Solve (T - lambda*I)**T * X = B*diag(scale)
+
+    @param[in]
+    n       INTEGER
+            The order of the matrix T. n >= 0.
+
+    @param[in]
+    nrhs    INTEGER
+            The number of columns of X. nrhs >= 0.
+
+    @param[in]
+    T       DOUBLE PRECISION array, dimension (ldt,n)
+            The upper quasi-triangular matrix T, in Schur canonical form.
+
+    @param[in]
+    ldt     INTEGER
+            The leading dimension of the array T. ldt >= max(1,n).
+
+    @param[in]
+    wr      DOUBLE PRECISION array, dimension (nrhs)
+    @param[in]
+    wi      DOUBLE PRECISION array, dimension (nrhs)
+            The shift of column j is wr(j) + i*wi(j). If wi(j) != 0,
+            columns j and j+1 of X hold the real and imaginary parts of one
+            complex right-hand side, and wr(j+1), wi(j+1) are not referenced.
+
+    @param[in,out]
+    X       DOUBLE PRECISION array, dimension (ldx,nrhs)
+            On entry, the right-hand sides B.
+            On exit, the solutions X.
+
+    @param[in]
+    ldx     INTEGER
+            The leading dimension of the array X. ldx >= max(1,n).
+
+    @param[out]
+    scale   DOUBLE PRECISION array, dimension (nrhs)
+            The scaling factor of each column. The two columns of a complex
+            right-hand side have the same scaling factor. If scale(j) = 0,
+            the solution is too large to be represented as x(j)/scale(j) and
+            x(j) is set to zero, as in LAPACK's dlatrs3.
+
+    @param[in]
+    nthread INTEGER
+            Number of threads to use. nthread >= 1.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if info = -k, the k-th argument had an illegal value
+
+    @ingroup magma_laqtrs3d
+*******************************************************************************/
+extern "C"
+magma_int_t magma_dlaqtrs3d(
+    magma_trans_t trans, magma_int_t n, magma_int_t nrhs,
+    const double *T, magma_int_t ldt,
+    const double *wr, const double *wi,
+    double *X, magma_int_t ldx,
+    double *scale,
+    magma_int_t nthread,
+    magma_int_t *info )
+{
+    #define      T(i_, j_)  (T      + (i_) + (j_)*ldt)
+    #define      X(i_, j_)  (X      + (i_) + (j_)*ldx)
+    #define lscale(i_, j_)  (lscale + (i_) + (j_)*nba)
+
+    const double c_neg_one = MAGMA_D_NEG_ONE;
+    const double c_one     = MAGMA_D_ONE;
+    const magma_int_t ione = 1;
+    const magma_int_t nb = laqtrs3d_nb;
+
+    magma_int_t notran, nba, i, j, k, ldw;
+    double unfl, ovfl, ulp, smlnum, bignum;
+    double *cnorm = NULL, *lscale = NULL, *xnrm = NULL, *work = NULL;
+    magma_int_t *tile = NULL, *width = NULL;
+
+    notran = (trans == MagmaNoTrans);
+
+    *info = 0;
+    if ( ! notran && trans != MagmaTrans ) {
+        *info = -1;
+    }
+    else if ( n < 0 ) {
+        *info = -2;
+    }
+    else if ( nrhs < 0 ) {
+        *info = -3;
+    }
+    else if ( ldt < max(1,n) ) {
+        *info = -5;
+    }
+    else if ( ldx < max(1,n) ) {
+        *info = -9;
+    }
+    else if ( nthread < 1 ) {
+        *info = -11;
+    }
+
+    if ( *info != 0 ) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    for( k=0; k < nrhs; ++k ) {
+        scale[k] = 1.;
+    }
+
+    // Quick return if possible
+    if ( n == 0 || nrhs == 0 ) {
+        return *info;
+    }
+
+    // Set the constants to control overflow, as in dlaqtrsd.
+    unfl = lapackf77_dlamch( "Safe minimum" );
+    ovfl = 1. / unfl;
+    lapackf77_dlabad( &unfl, &ovfl );
+    ulp = lapackf77_dlamch( "Precision" );
+    smlnum = unfl*( n / ulp );
+    bignum = (1. - ulp) / smlnum;
+
+    // at most n/nb + 1 tiles, since 2x2 blocks stretch tiles by one row
+    nba = n/nb + 1;
+    ldw = nb + 1;
+    if ( MAGMA_SUCCESS != magma_dmalloc_cpu( &cnorm,  n )        ||
+         MAGMA_SUCCESS != magma_dmalloc_cpu( &lscale, nba*nrhs ) ||
+         MAGMA_SUCCESS != magma_dmalloc_cpu( &xnrm,   nrhs )     ||
+         MAGMA_SUCCESS != magma_dmalloc_cpu( &work,   nthread*ldw*nrhs ) ||
+         MAGMA_SUCCESS != magma_imalloc_cpu( &tile,   nba+1 )    ||
+         MAGMA_SUCCESS != magma_imalloc_cpu( &width,  nrhs ))
+    {
+        *info = MAGMA_ERR_HOST_ALLOC;
+        goto cleanup;
+    }
+
+    // Tile boundaries; a tile that would end inside a 2x2 block takes its
+    // second row as well.
+    tile[0] = 0;
+    nba = 0;
+    while ( tile[nba] < n ) {
+        j = min( tile[nba] + nb, n );
+        if ( j < n && *T(j,j-1) != 0. ) {
+            j += 1;
+        }
+        nba += 1;
+        tile[nba] = j;
+    }
+
+    // Columns per right-hand side: 1 for real, 2 for the first column of a
+    // complex pair, 0 for its second column.
+    for( k=0; k < nrhs; ++k ) {
+        if ( wi[k] != 0. && k < nrhs-1 ) {
+            width[k]   = 2;
+            width[k+1] = 0;
+            k += 1;
+        }
+        else {
+            width[k] = 1;
+        }
+    }
+
+    // 1-norms of the columns of the strictly upper triangle of each
+    // diagonal tile.
+    for( i=0; i < nba; ++i ) {
+        for( j=tile[i]; j < tile[i+1]; ++j ) {
+            magma_int_t len = j - tile[i];
+            cnorm[j] = magma_cblas_dasum( len, T(tile[i],j), ione );
+        }
+    }
+    for( k=0; k < nba*nrhs; ++k ) {
+        lscale[k] = 1.;
+    }
+
+    #pragma omp parallel num_threads( nthread )
+    {
+        int saved = dlaqtrs3d_blas_local_begin();
+        #ifdef _OPENMP
+        magma_int_t tid = omp_get_thread_num();
+        #else
+        magma_int_t tid = 0;
+        #endif
+        double *W = work + tid*ldw*nrhs;
+        double dwork[ laqtrs3d_nb+1 ];  // for dlange "I"
+
+        // NoTrans goes up the tiles, Trans down.
+        for( magma_int_t jj=0; jj < nba; ++jj ) {
+            magma_int_t J  = (notran ? nba-1-jj : jj);
+            magma_int_t j1 = tile[J];
+            magma_int_t jb = tile[J+1] - j1;
+
+            // Solve the diagonal tile for each right-hand side.
+            #pragma omp for schedule(dynamic)
+            for( magma_int_t kk=0; kk < nrhs; ++kk ) {
+                magma_int_t nw = width[kk];
+                if ( nw == 0 ) {
+                    continue;
+                }
+                double sloc = dlaqtrs3d_diag(
+                    notran, jb, T(j1,j1), ldt, wr[kk], (nw == 2 ? wi[kk] : 0.), nw,
+                    X(j1,kk), ldx, &cnorm[j1], smlnum, bignum );
+                if ( sloc * (*lscale(J,kk)) == 0. ) {
+                    // The combined scale factor underflows. Keep the
+                    // smallest one and move the rest into x if it fits;
+                    // otherwise the solution cannot be represented and is
+                    // set to zero, with scale 0, as in LAPACK's dlatrs3.
+                    sloc *= *lscale(J,kk) / unfl;
+                    *lscale(J,kk) = unfl;
+                    double rscal = 1. / sloc;
+                    double xn = lapackf77_dlange( "I", &jb, &nw, X(j1,kk), &ldx, dwork );
+                    if ( xn * rscal <= ovfl ) {
+                        for( magma_int_t c=0; c < nw; ++c ) {
+                            blasf77_dscal( &jb, &rscal, X(j1,kk+c), &ione );
+                        }
+                    }
+                    else {
+                        for( magma_int_t c=0; c < nw; ++c ) {
+                            scale[kk+c] = 0.;
+                            for( magma_int_t ir=0; ir < n; ++ir ) {
+                                *X(ir,kk+c) = 0.;
+                            }
+                            for( magma_int_t I=0; I < nba; ++I ) {
+                                *lscale(I,kk+c) = 1.;
+                            }
+                        }
+                    }
+                    sloc = 1.;
+                }
+                *lscale(J,kk) *= sloc;
+                xnrm[kk] = lapackf77_dlange( "I", &jb, &nw, X(j1,kk), &ldx, dwork );
+                if ( nw == 2 ) {
+                    *lscale(J,kk+1) = *lscale(J,kk);
+                }
+            }
+
+            // Update the tiles that remain to be solved:
+            // NoTrans: X(I) -= T(I,J)    * X(J) for I < J,
+            // Trans:   X(I) -= T(J,I)**T * X(J) for I > J.
+            magma_int_t nrem = (notran ? J : nba-1-J);
+            #pragma omp for schedule(dynamic)
+            for( magma_int_t ii=0; ii < nrem; ++ii ) {
+                magma_int_t I  = (notran ? J-1-ii : J+1+ii);
+                magma_int_t i1 = tile[I];
+                magma_int_t ib = tile[I+1] - i1;
+                double anrm;
+                if ( notran ) {
+                    anrm = lapackf77_dlange( "I", &ib, &jb, T(i1,j1), &ldt, dwork );
+                }
+                else {
+                    anrm = lapackf77_dlange( "1", &jb, &ib, T(j1,i1), &ldt, dwork );
+                }
+
+                // Bring X(I) and X(J) to a common scale at which the update
+                // cannot overflow. X(J) is shared by all tiles I, so if it
+                // has to be scaled down for this tile, use a scaled copy.
+                bool copy = false;
+                for( magma_int_t kk=0; kk < nrhs; ++kk ) {
+                    magma_int_t nw = width[kk];
+                    if ( nw == 0 ) {
+                        continue;
+                    }
+                    double scamin = min( *lscale(I,kk), *lscale(J,kk) );
+                    double bnrm = lapackf77_dlange( "I", &ib, &nw, X(i1,kk), &ldx, dwork );
+                    bnrm *= scamin / *lscale(I,kk);
+                    double xn = xnrm[kk] * (scamin / *lscale(J,kk));
+                    scamin *= magma_dlarmm( anrm, xn, bnrm );
+                    double rscal = scamin / *lscale(I,kk);
+                    if ( rscal != 1. ) {
+                        for( magma_int_t c=0; c < nw; ++c ) {
+                            blasf77_dscal( &ib, &rscal, X(i1,kk+c), &ione );
+                        }
+                    }
+                    for( magma_int_t c=0; c < nw; ++c ) {
+                        *lscale(I,kk+c) = scamin;
+                    }
+                    if ( scamin != *lscale(J,kk) ) {
+                        copy = true;
+                    }
+                }
+
+                const double *B = X(j1,0);
+                magma_int_t ldb = ldx;
+                if ( copy ) {
+                    lapackf77_dlacpy( "F", &jb, &nrhs, X(j1,0), &ldx, W, &jb );
+                    for( magma_int_t kk=0; kk < nrhs; ++kk ) {
+                        double rscal = *lscale(I,kk) / *lscale(J,kk);
+                        if ( rscal != 1. ) {
+                            blasf77_dscal( &jb, &rscal, &W[kk*jb], &ione );
+                        }
+                    }
+                    B = W;
+                    ldb = jb;
+                }
+
+                if ( notran ) {
+                    blasf77_dgemm( "N", "N", &ib, &nrhs, &jb,
+                                   &c_neg_one, T(i1,j1), &ldt,
+                                               B, &ldb,
+                                   &c_one,     X(i1,0), &ldx );
+                }
+                else {
+                    blasf77_dgemm( "T", "N", &ib, &nrhs, &jb,
+                                   &c_neg_one, T(j1,i1), &ldt,
+                                               B, &ldb,
+                                   &c_one,     X(i1,0), &ldx );
+                }
+            }
+        }
+        dlaqtrs3d_blas_local_end( saved );
+    }
+
+    // Reduce the local scale factors to one per right-hand side.
+    for( k=0; k < nrhs; ++k ) {
+        double smin = *lscale(0,k);
+        for( i=1; i < nba; ++i ) {
+            smin = min( smin, *lscale(i,k) );
+        }
+        for( i=0; i < nba; ++i ) {
+            double rscal = smin / *lscale(i,k);
+            if ( rscal != 1. ) {
+                magma_int_t ib = tile[i+1] - tile[i];
+                blasf77_dscal( &ib, &rscal, X(tile[i],k), &ione );
+            }
+        }
+        if ( scale[k] != 0. ) {
+            scale[k] = smin;
+        }
+    }
+
+cleanup:
+    magma_free_cpu( cnorm );
+    magma_free_cpu( lscale );
+    magma_free_cpu( xnrm );
+    magma_free_cpu( work );
+    magma_free_cpu( tile );
+    magma_free_cpu( width );
+
+    return *info;
+
+    #undef T
+    #undef X
+    #undef lscale
+}
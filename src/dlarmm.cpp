@@ -0,0 +1,67 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal d -> s
+*/
+#include "magma_internal.h"
+
+/***************************************************************************//**
+    Purpose
+    -------
+    DLARMM returns a factor s in (0, 1] such that the linear updates
+
+        (s * C) - A * (s * B)  and  (s * C) - (s * A) * B
+
+    cannot overflow, where A, B, and C are matrices of conforming
+    dimensions. It is used by the robust triangular solvers to scale the
+    right-hand side before each Level 3 BLAS update.
+
+    This is a translation of LAPACK's dlarmm, see
+    A. Kjelgaard Mikkelsen and L. Karlsson, "Blocked algorithms for robust
+    solution of triangular linear systems", PPAM 2017.
+
+    Arguments
+    ---------
+    @param[in]
+    anorm   DOUBLE PRECISION
+            The infinity norm of A. anorm >= 0.
+
+    @param[in]
+    bnorm   DOUBLE PRECISION
+            The infinity norm of B. bnorm >= 0.
+
+    @param[in]
+    cnorm   DOUBLE PRECISION
+            The infinity norm of C. cnorm >= 0.
+
+    @return The scaling factor s.
+
+    @ingroup magma_larmm
+*******************************************************************************/
+extern "C"
+double magma_dlarmm( double anorm, double bnorm, double cnorm )
+{
+    double smlnum, bignum, s;
+
+    // Determine machine dependent parameters to control overflow.
+    smlnum = lapackf77_dlamch( "Safe minimum" ) / lapackf77_dlamch( "Precision" );
+    bignum = (1. / smlnum) / 4.;
+
+    // Compute a scale factor.
+    s = 1.;
+    if ( bnorm <= 1. ) {
+        if ( anorm * bnorm > bignum - cnorm ) {
+            s = 0.5;
+        }
+    }
+    else {
+        if ( anorm > (bignum - cnorm) / bnorm ) {
+            s = 0.5 / bnorm;
+        }
+    }
+    return s;
+}
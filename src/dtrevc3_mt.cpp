@@ -111,6 +111,79 @@ private:
 };
 
 
+/******************************************************************************/
+// Solves the rows of a block of nb2 eigenvectors that are not in their tails.
+// The k-by-nb2 tails Xt are already solved; through the k-by-m (Trans)
+// or m-by-k (NoTrans) block T12 they give the right-hand sides
+// Xh = -op(T12) * Xt of the remaining m rows, which are solved together,
+// (T22 - (wr(j) + i*wi(j))*I)**op * Xh(:,j) = scale(j) * Xh(:,j), with
+// dlaqtrs3d; wi(j) != 0 marks columns j and j+1 as the real and imaginary
+// parts of a complex vector.
+// Each vector's tail is normalized beforehand, leaving the whole range for the
+// growth in Xh, and scaled so the GEMM cannot overflow; afterwards it is
+// scaled by scale(j). On exit, scale(j) = 0 marks a vector that could not be
+// represented this way; the caller must solve it again as a whole.
+static void dtrevc3_mt_solve_block(
+    magma_trans_t trans, magma_int_t m, magma_int_t k, magma_int_t nb2,
+    const double *T12, const double *T22, magma_int_t ldt,
+    const double *wr, const double *wi, double *scale,
+    double *Xt, double *Xh, magma_int_t ldx,
+    magma_thread_queue& queue, magma_int_t gemm_nb, magma_int_t nthread )
+{
+    const double c_zero    = 0;
+    const double c_one     = 1;
+    const double c_neg_one = -1;
+    const magma_int_t izero = 0, ione = 1;
+    const magma_int_t mb = 64;
+
+    magma_int_t i, ib, j, nw, info;
+    double anrm, xnrm, s, dwork[ mb ];
+
+    // |op(T12)|_inf, in row blocks for the workspace of dlange
+    anrm = 0;
+    if ( trans == MagmaNoTrans ) {
+        for( i=0; i < m; i += mb ) {
+            ib = min( mb, m-i );
+            anrm = max( anrm, lapackf77_dlange( "I", &ib, &k, T12 + i, &ldt, dwork ));
+        }
+    }
+    else {
+        anrm = lapackf77_dlange( "1", &k, &m, T12, &ldt, dwork );
+    }
+    for( j=0; j < nb2; j += nw ) {
+        nw = (wi[j] != 0 && j < nb2-1 ? 2 : 1);
+        xnrm = lapackf77_dlange( "M", &k, &nw, Xt + j*ldx, &ldx, dwork );
+        if ( xnrm != 0 ) {
+            lapackf77_dlascl( "G", &izero, &izero, &xnrm, &c_one, &k, &nw,
+                              Xt + j*ldx, &ldx, &info );
+        }
+        s = magma_dlarmm( anrm, c_one, c_zero );
+        if ( s != c_one ) {
+            lapackf77_dlascl( "G", &izero, &izero, &c_one, &s, &k, &nw,
+                              Xt + j*ldx, &ldx, &info );
+        }
+    }
+
+    // split gemm into multiple tasks, each doing one block row
+    for( i=0; i < m; i += gemm_nb ) {
+        ib = min( gemm_nb, m-i );
+        queue.push_task( new dgemm_task(
+            trans, MagmaNoTrans, ib, nb2, k, c_neg_one,
+            (trans == MagmaNoTrans ? T12 + i : T12 + i*ldt), ldt,
+            Xt, ldx, c_zero,
+            Xh + i, ldx ));
+    }
+    queue.sync();
+
+    magma_dlaqtrs3d( trans, m, nb2, T22, ldt, wr, wi, Xh, ldx, scale, nthread, &info );
+    for( j=0; j < nb2; ++j ) {
+        if ( scale[j] != c_one ) {
+            blasf77_dscal( &k, &scale[j], Xt + j*ldx, &ione );
+        }
+    }
+}
+
+
 /***************************************************************************//**
     Purpose
     -------
@@ -296,6 +369,8 @@ magma_int_t magma_dtrevc3_mt(
     // .. Local Arrays ..
     // since iv is a 1-based index, allocate one extra here
     magma_int_t iscomplex[ nbmax+1 ];
+    // shifts and scale factors of the block solves in version 2
+    double wr[ nbmax ], wi[ nbmax ], scale[ nbmax ];
 
     // Decode and test the input parameters
     bothv  = (side == MagmaBothSides);
@@ -474,8 +549,12 @@ magma_int_t magma_dtrevc3_mt(
                 // Real right eigenvector
                 // Solve upper quasi-triangular system:
                 // [ T(0:ki-1,0:ki-1) - wr ]*X = -T(0:ki-1,ki)
-                queue.push_task( new magma_dlaqtrsd_task(
-                    MagmaNoTrans, ki+1, T(0,0), ldt, work(0,iv), n, work(0,0) ));
+                // The blocked back-transform instead solves its whole block
+                // of vectors together, below.
+                if ( ! over || version == 1 ) {
+                    queue.push_task( new magma_dlaqtrsd_task(
+                        MagmaNoTrans, ki+1, T(0,0), ldt, work(0,iv), n, work(0,0) ));
+                }
                 
                 // Copy the vector x or Q*x to VR and normalize.
                 if ( ! over ) {
@@ -528,8 +607,10 @@ magma_int_t magma_dtrevc3_mt(
                 // Complex right eigenvector
                 // Solve upper quasi-triangular system:
                 // [ T(0:ki-2,0:ki-2) - (wr+i*wi) ]*x = u
-                queue.push_task( new magma_dlaqtrsd_task(
-                    MagmaNoTrans, ki+1, T(0,0), ldt, work(0,iv-1), n, work(0,0) ));
+                if ( ! over || version == 1 ) {
+                    queue.push_task( new magma_dlaqtrsd_task(
+                        MagmaNoTrans, ki+1, T(0,0), ldt, work(0,iv-1), n, work(0,0) ));
+                }
 
                 // Copy the vector x or Q*x to VR and normalize.
                 if ( ! over ) {
@@ -615,11 +696,63 @@ magma_int_t magma_dtrevc3_mt(
                 // When the number of vectors stored reaches nb-1 or nb,
                 // or if this was last vector, do the GEMM
                 if ( (iv <= 2) || (ki2 == 0) ) {
+                    nb2 = nb-iv+1;
+                    n2  = ki2+nb-iv+1;
+
+                    // Solve the block of vectors, columns iv:nb for
+                    // eigenvalues ki2:ki2+nb2-1. First the tail of each vector,
+                    // rows ki2:j of the column for eigenvalue j (j+1 for a
+                    // conjugate pair), with dlaqtrsd, ...
+                    for( k=iv; k <= nb; ++k ) {
+                        j = ki2 + k-iv;
+                        if ( iscomplex[k] == 0 ) {
+                            queue.push_task( new magma_dlaqtrsd_task(
+                                MagmaNoTrans, j-ki2+1, T(ki2,ki2), ldt, work(ki2,k), n, work(ki2,0) ));
+                        }
+                        else if ( iscomplex[k] == 1 ) {
+                            queue.push_task( new magma_dlaqtrsd_task(
+                                MagmaNoTrans, j-ki2+2, T(ki2,ki2), ldt, work(ki2,k), n, work(ki2,0) ));
+                        }
+                    }
                     queue.sync();
+                    // ... then rows 0:ki2-1 of all of them together, with dlaqtrs3d.
+                    if ( ki2 > 0 ) {
+                        for( k=iv; k <= nb; ++k ) {
+                            j = ki2 + k-iv;
+                            if ( iscomplex[k] == 0 ) {
+                                wr[k-iv] = *T(j,j);
+                                wi[k-iv] = c_zero;
+                            }
+                            else if ( iscomplex[k] == 1 ) {
+                                wr[k-iv] = *T(j+1,j+1);
+                                wi[k-iv] = sqrt( fabs( *T(j,j+1) ) ) * sqrt( fabs( *T(j+1,j) ) );
+                                wr[k-iv+1] = wr[k-iv];
+                                wi[k-iv+1] = wi[k-iv];
+                            }
+                        }
+                        dtrevc3_mt_solve_block(
+                            MagmaNoTrans, ki2, nb2, nb2,
+                            T(0,ki2), T, ldt, wr, wi, scale,
+                            work(ki2,iv), work(0,iv), n,
+                            queue, gemm_nb, nthread );
+
+                        // solve any vector that could not be represented
+                        // in two parts as a whole, as in version 1
+                        for( k=iv; k <= nb; ++k ) {
+                            j = ki2 + k-iv;
+                            if ( iscomplex[k] == 0 && scale[k-iv] == c_zero ) {
+                                queue.push_task( new magma_dlaqtrsd_task(
+                                    MagmaNoTrans, j+1, T(0,0), ldt, work(0,k), n, work(0,0) ));
+                            }
+                            else if ( iscomplex[k] == 1 && scale[k-iv] == c_zero ) {
+                                queue.push_task( new magma_dlaqtrsd_task(
+                                    MagmaNoTrans, j+2, T(0,0), ldt, work(0,k), n, work(0,0) ));
+                            }
+                        }
+                        queue.sync();
+                    }
                     time_trsv_sum += timer_stop( time_trsv );
                     timer_start( time_gemm );
-                    nb2 = nb-iv+1;
-                    n2  = ki2+nb-iv+1;
                     
                     // split gemm into multiple tasks, each doing one block row
                     for( i=0; i < n; i += gemm_nb ) {
@@ -721,8 +854,12 @@ magma_int_t magma_dtrevc3_mt(
                 // Real left eigenvector
                 // Solve transposed quasi-triangular system:
                 // [ T(ki+1:n,ki+1:n) - wr ]**T * X = -T(ki+1:n,ki)
-                queue.push_task( new magma_dlaqtrsd_task(
-                    MagmaTrans, n-ki, T(ki,ki), ldt, work(ki,iv), n, work(ki,0) ));
+                // The blocked back-transform instead solves its whole block
+                // of vectors together, below.
+                if ( ! over || version == 1 ) {
+                    queue.push_task( new magma_dlaqtrsd_task(
+                        MagmaTrans, n-ki, T(ki,ki), ldt, work(ki,iv), n, work(ki,0) ));
+                }
     
                 // Copy the vector x or Q*x to VL and normalize.
                 if ( ! over ) {
@@ -772,8 +909,10 @@ magma_int_t magma_dtrevc3_mt(
                 // Complex left eigenvector
                 // Solve transposed quasi-triangular system:
                 // [ T(ki+2:n,ki+2:n)**T - (wr-i*wi) ]*X = V
-                queue.push_task( new magma_dlaqtrsd_task(
-                    MagmaTrans, n-ki, T(ki,ki), ldt, work(ki,iv), n, work(ki,0) ));
+                if ( ! over || version == 1 ) {
+                    queue.push_task( new magma_dlaqtrsd_task(
+                        MagmaTrans, n-ki, T(ki,ki), ldt, work(ki,iv), n, work(ki,0) ));
+                }
     
                 // Copy the vector x or Q*x to VL and normalize.
                 if ( ! over ) {
@@ -856,7 +995,49 @@ magma_int_t magma_dtrevc3_mt(
                 // When the number of vectors stored reaches nb-1 or nb,
                 // or if this was last vector, do the GEMM
                 if ( (iv >= nb-1) || (ki2 == n-1) ) {
+                    // Solve the block of vectors, columns 1:iv for
+                    // eigenvalues ki2-iv+1:ki2. First the tail of each vector,
+                    // rows j:ki2 of the column for eigenvalue j, with dlaqtrsd, ...
+                    for( k=1; k <= iv; ++k ) {
+                        j = ki2-iv+k;
+                        if ( iscomplex[k] != -1 ) {
+                            queue.push_task( new magma_dlaqtrsd_task(
+                                MagmaTrans, ki2-j+1, T(j,j), ldt, work(j,k), n, work(j,0) ));
+                        }
+                    }
                     queue.sync();
+                    // ... then rows ki2+1:n-1 of all of them together, with dlaqtrs3d.
+                    if ( ki2 < n-1 ) {
+                        for( k=1; k <= iv; ++k ) {
+                            j = ki2-iv+k;
+                            if ( iscomplex[k] == 0 ) {
+                                wr[k-1] = *T(j,j);
+                                wi[k-1] = c_zero;
+                            }
+                            else if ( iscomplex[k] == 1 ) {
+                                wr[k-1] = *T(j,j);
+                                wi[k-1] = -sqrt( fabs( *T(j,j+1) ) ) * sqrt( fabs( *T(j+1,j) ) );
+                                wr[k] = wr[k-1];
+                                wi[k] = wi[k-1];
+                            }
+                        }
+                        dtrevc3_mt_solve_block(
+                            MagmaTrans, n-ki2-1, iv, iv,
+                            T(ki2-iv+1,ki2+1), T(ki2+1,ki2+1), ldt, wr, wi, scale,
+                            work(ki2-iv+1,1), work(ki2+1,1), n,
+                            queue, gemm_nb, nthread );
+
+                        // solve any vector that could not be represented
+                        // in two parts as a whole, as in version 1
+                        for( k=1; k <= iv; ++k ) {
+                            j = ki2-iv+k;
+                            if ( iscomplex[k] != -1 && scale[k-1] == c_zero ) {
+                                queue.push_task( new magma_dlaqtrsd_task(
+                                    MagmaTrans, n-j, T(j,j), ldt, work(j,k), n, work(j,0) ));
+                            }
+                        }
+                        queue.sync();
+                    }
                     n2 = n-(ki2+1)+iv;
                     
                     // split gemm into multiple tasks, each doing one block row
@@ -0,0 +1,504 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions mixed zc -> ds
+
+*/
+#include <stdint.h>
+
+#include "magma_internal.h"
+
+
+/******************************************************************************/
+// Rounds the m-by-n single precision matrix SA to bfloat16 precision
+// (8 significant bits, with the exponent range of single), rounding to
+// nearest even, as the packed conversions of AVX-512 BF16 do. The result is
+// kept in single precision, so the factorization of SA emulates a bfloat16
+// input, single precision accumulate factorization.
+static void zcgesv_gmres_cpu_round_bf16(
+    magma_int_t m, magma_int_t n,
+    magmaFloatComplex *SA, magma_int_t ldsa )
+{
+    // each element is one float in real, two floats in complex
+    const magma_int_t len = m * magma_int_t( sizeof(magmaFloatComplex) / sizeof(float) );
+
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t j=0; j < n; ++j ) {
+        float *s = (float*) (SA + j*ldsa);
+        #pragma omp simd
+        for( magma_int_t i=0; i < len; ++i ) {
+            uint32_t u;
+            memcpy( &u, &s[i], sizeof(u) );
+            // leave Inf and NaN alone
+            if ( (u & 0x7f800000u) != 0x7f800000u ) {
+                u += 0x7fffu + ((u >> 16) & 1);
+                u &= 0xffff0000u;
+            }
+            memcpy( &s[i], &u, sizeof(u) );
+        }
+    }
+}
+
+
+/******************************************************************************/
+// Applies the preconditioner, r = op( P L U )^{-1} r, with the single
+// precision factors SA of A. r is scaled to unit max-norm before it is
+// narrowed to single precision, so it cannot overflow, and scaled back after.
+// SX is a workspace of n single precision elements.
+static void zcgesv_gmres_cpu_precond(
+    magma_trans_t trans, magma_int_t n,
+    const magmaFloatComplex *SA, magma_int_t ldsa, const magma_int_t *ipiv,
+    magmaDoubleComplex *r, magmaFloatComplex *SX )
+{
+    const magma_int_t izero = 0, ione = 1;
+    const double d_one = 1.;
+
+    magma_int_t i, info;
+    double rmax;
+
+    i = blasf77_izamax( &n, r, &ione ) - 1;
+    rmax = MAGMA_Z_ABS( r[i] );
+    if ( rmax == 0. ) {
+        return;
+    }
+    lapackf77_zlascl( "G", &izero, &izero, &rmax, &d_one, &n, &ione, r, &n, &info );
+    lapackf77_zlag2c( &n, &ione, r, &n, SX, &n, &info );
+    lapackf77_cgetrs( lapack_trans_const( trans ), &n, &ione, SA, &ldsa, ipiv, SX, &n, &info );
+    lapackf77_clag2z( &n, &ione, SX, &n, r, &n, &info );
+    lapackf77_zlascl( "G", &izero, &izero, &d_one, &rmax, &n, &ione, r, &n, &info );
+}
+
+
+/******************************************************************************/
+// Solves op(A) d = r with left preconditioned GMRES, one cycle of at most m
+// iterations, until the preconditioned residual is reduced by innertol.
+// The preconditioner is the single precision LU factorization SA of A; all
+// other operations are in double precision. On entry r is the right-hand
+// side; on exit it is the solution d. V is an n-by-(m+1) workspace, H an
+// (m+1)-by-m workspace, cs, sn, g, t workspaces of m+1 elements.
+// The Arnoldi vectors are orthogonalized by classical Gram-Schmidt applied
+// twice, which is as stable as modified Gram-Schmidt but uses gemv.
+// Returns the number of iterations.
+static magma_int_t zcgesv_gmres_cpu_gmres(
+    magma_trans_t trans, magma_int_t n,
+    const magmaDoubleComplex *A, magma_int_t lda,
+    const magmaFloatComplex *SA, magma_int_t ldsa, const magma_int_t *ipiv,
+    magmaDoubleComplex *r,
+    magma_int_t m, double innertol,
+    magmaDoubleComplex *V, magma_int_t ldv,
+    magmaDoubleComplex *H, magma_int_t ldh,
+    double *cs, magmaDoubleComplex *sn, magmaDoubleComplex *g,
+    magmaDoubleComplex *t, magmaFloatComplex *SX )
+{
+    #define V(i_, j_)  (V + (i_) + (j_)*ldv)
+    #define H(i_, j_)  (H + (i_) + (j_)*ldh)
+
+    const magmaDoubleComplex c_zero    = MAGMA_Z_ZERO;
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    const magma_int_t ione = 1;
+
+    magma_int_t i, k, k1;
+    double beta, hnrm, work[1];
+    magmaDoubleComplex temp;
+
+    // v_0 = M^{-1} r / beta
+    blasf77_zcopy( &n, r, &ione, V(0,0), &ione );
+    zcgesv_gmres_cpu_precond( trans, n, SA, ldsa, ipiv, V(0,0), SX );
+    beta = lapackf77_zlange( "F", &n, &ione, V(0,0), &ldv, work );
+    if ( beta == 0. ) {
+        lapackf77_zlaset( "F", &n, &ione, &c_zero, &c_zero, r, &n );
+        return 0;
+    }
+    temp = MAGMA_Z_MAKE( 1. / beta, 0. );
+    blasf77_zscal( &n, &temp, V(0,0), &ione );
+    g[0] = MAGMA_Z_MAKE( beta, 0. );
+
+    for( k=0; k < m; ) {
+        // v_{k+1} = M^{-1} op(A) v_k, orthogonalized against v_0, ..., v_k
+        blasf77_zgemv( lapack_trans_const( trans ), &n, &n,
+                       &c_one,  A, &lda, V(0,k), &ione,
+                       &c_zero, V(0,k+1), &ione );
+        zcgesv_gmres_cpu_precond( trans, n, SA, ldsa, ipiv, V(0,k+1), SX );
+        k1 = k+1;
+        blasf77_zgemv( "ConjTrans", &n, &k1,
+                       &c_one,     V, &ldv, V(0,k+1), &ione,
+                       &c_zero,    H(0,k), &ione );
+        blasf77_zgemv( "NoTrans", &n, &k1,
+                       &c_neg_one, V, &ldv, H(0,k), &ione,
+                       &c_one,     V(0,k+1), &ione );
+        blasf77_zgemv( "ConjTrans", &n, &k1,
+                       &c_one,     V, &ldv, V(0,k+1), &ione,
+                       &c_zero,    t, &ione );
+        blasf77_zgemv( "NoTrans", &n, &k1,
+                       &c_neg_one, V, &ldv, t, &ione,
+                       &c_one,     V(0,k+1), &ione );
+        blasf77_zaxpy( &k1, &c_one, t, &ione, H(0,k), &ione );
+        hnrm = lapackf77_zlange( "F", &n, &ione, V(0,k+1), &ldv, work );
+        *H(k+1,k) = MAGMA_Z_MAKE( hnrm, 0. );
+        if ( hnrm != 0. ) {
+            temp = MAGMA_Z_MAKE( 1. / hnrm, 0. );
+            blasf77_zscal( &n, &temp, V(0,k+1), &ione );
+        }
+
+        // apply the previous rotations to the new column of H,
+        // then annihilate H(k+1,k)
+        for( i=0; i < k; ++i ) {
+            temp       =  cs[i]*(*H(i,k)) + sn[i]*(*H(i+1,k));
+            *H(i+1,k)  = -MAGMA_Z_CONJ( sn[i] )*(*H(i,k)) + cs[i]*(*H(i+1,k));
+            *H(i,k)    =  temp;
+        }
+        lapackf77_zlartg( H(k,k), H(k+1,k), &cs[k], &sn[k], &temp );
+        *H(k,k)   = temp;
+        *H(k+1,k) = c_zero;
+        g[k+1] = -MAGMA_Z_CONJ( sn[k] )*g[k];
+        g[k]   = cs[k]*g[k];
+        k += 1;
+
+        // |g[k]| is the norm of the preconditioned residual
+        if ( MAGMA_Z_ABS( g[k] ) <= innertol*beta || hnrm == 0. ) {
+            break;
+        }
+    }
+
+    // d = V y, where H y = g
+    blasf77_ztrsv( "Upper", "NoTrans", "NonUnit", &k, H, &ldh, g, &ione );
+    blasf77_zgemv( "NoTrans", &n, &k,
+                   &c_one,  V, &ldv, g, &ione,
+                   &c_zero, r, &ione );
+    return k;
+
+    #undef V
+    #undef H
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZCGESV_GMRES_CPU computes the solution to a complex system of linear
+    equations
+       A * X = B,  A**T * X = B,  or  A**H * X = B,
+    where A is an N-by-N matrix and X and B are N-by-NRHS matrices,
+    on the CPU.
+
+    It first factorizes the matrix in complex SINGLE PRECISION, or in single
+    precision after rounding it to bfloat16, and uses this factorization
+    within an iterative refinement procedure to produce a solution with
+    complex DOUBLE PRECISION norm-wise backward error quality (see below).
+    The correction in each step is either solved directly with the single
+    precision factors (classical iterative refinement), or with GMRES in
+    double precision, preconditioned by the single precision factors
+    (GMRES-IR), which converges for matrices that are too ill-conditioned
+    for the former. If the approach fails the method switches to a complex
+    DOUBLE PRECISION factorization and solve.
+
+    The iterative refinement process is stopped if
+        ITER > ITERMAX
+    or for all the RHS we have:
+        RNRM < SQRT(N)*XNRM*ANRM*EPS*BWDMAX
+    where
+        o ITER is the number of the current iteration in the iterative
+          refinement process
+        o RNRM is the infinity-norm of the residual
+        o XNRM is the infinity-norm of the solution
+        o ANRM is the infinity-operator-norm of the matrix A
+        o EPS is the machine epsilon returned by DLAMCH('Epsilon')
+    The value BWDMAX is fixed to 1.0. ITERMAX is 30 for classical iterative
+    refinement, and 10 for GMRES-IR, where each step does up to 50 GMRES
+    iterations, stopped when the preconditioned residual is reduced by 1e-4.
+
+    See
+    Erin Carson and Nicholas J. Higham. 2018. Accelerating the solution of
+    linear systems by iterative refinement in three precisions. SIAM J. Sci.
+    Comput. 40(2), A817-A847.
+
+    Arguments
+    ---------
+    @param[in]
+    trans   magma_trans_t
+            Specifies the form of the system of equations:
+      -     = MagmaNoTrans:    A    * X = B  (No transpose)
+      -     = MagmaTrans:      A**T * X = B  (Transpose)
+      -     = MagmaConjTrans:  A**H * X = B  (Conjugate transpose)
+
+    @param[in]
+    n       INTEGER
+            The number of linear equations, i.e., the order of the
+            matrix A.  N >= 0.
+
+    @param[in]
+    nrhs    INTEGER
+            The number of right hand sides, i.e., the number of columns
+            of the matrix B.  NRHS >= 0.
+
+    @param[in,out]
+    A       COMPLEX_16 array, dimension (LDA,N)
+            On entry, the N-by-N coefficient matrix A.
+            On exit, if iterative refinement has been successfully used
+            (info.EQ.0 and ITER.GE.0, see description below), A is
+            unchanged. If double precision factorization has been used
+            (info.EQ.0 and ITER.LT.0, see description below), then the
+            array A contains the factors L and U from the factorization
+            A = P*L*U; the unit diagonal elements of L are not stored.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A.  LDA >= max(1,N).
+
+    @param[out]
+    ipiv    INTEGER array, dimension (N)
+            The pivot indices that define the permutation matrix P;
+            row i of the matrix was interchanged with row IPIV(i).
+            Corresponds either to the single precision factorization
+            (if info.EQ.0 and ITER.GE.0) or the double precision
+            factorization (if info.EQ.0 and ITER.LT.0).
+
+    @param[in]
+    B       COMPLEX_16 array, dimension (LDB,NRHS)
+            The N-by-NRHS right hand side matrix B.
+
+    @param[in]
+    ldb     INTEGER
+            The leading dimension of the array B.  LDB >= max(1,N).
+
+    @param[out]
+    X       COMPLEX_16 array, dimension (LDX,NRHS)
+            If info = 0, the N-by-NRHS solution matrix X.
+
+    @param[in]
+    ldx     INTEGER
+            The leading dimension of the array X.  LDX >= max(1,N).
+
+    @param[in]
+    facto_type    magma_refinement_t
+            Specifies the low precision factorization:
+      -     = Magma_PREC_SS:  single precision.
+      -     = Magma_PREC_SB:  single precision, of A rounded to bfloat16.
+
+    @param[in]
+    solver_type   magma_refinement_t
+            Specifies how the corrections are solved:
+      -     = Magma_REFINE_IRSTRS:    classical iterative refinement, with
+                                      single precision triangular solves.
+      -     = Magma_REFINE_IRGMSTRS:  GMRES-IR, GMRES preconditioned with
+                                      single precision triangular solves.
+
+    @param[out]
+    iter    INTEGER
+      -     < 0: iterative refinement has failed, double precision
+                 factorization has been performed
+        +        -2 : narrowing the precision induced an overflow,
+                      the routine fell back to full precision
+        +        -3 : failure of CGETRF
+        +        -31: stop the iterative refinement after the 30th
+                      classical iteration
+        +        -11: stop the GMRES-IR refinement after the 10th
+                      iteration
+      -     > 0: iterative refinement has been successfully used.
+                 Returns the number of iterations; for GMRES-IR, the total
+                 number of GMRES iterations.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if info = -i, the i-th argument had an illegal value
+      -     > 0:  if info = i, U(i,i) computed in DOUBLE PRECISION is
+                  exactly zero.  The factorization has been completed,
+                  but the factor U is exactly singular, so the solution
+                  could not be computed.
+
+    @ingroup magma_gesv
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zcgesv_gmres_cpu(
+    magma_trans_t trans, magma_int_t n, magma_int_t nrhs,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magma_int_t *ipiv,
+    const magmaDoubleComplex *B, magma_int_t ldb,
+    magmaDoubleComplex *X, magma_int_t ldx,
+    magma_refinement_t facto_type,
+    magma_refinement_t solver_type,
+    magma_int_t *iter,
+    magma_int_t *info )
+{
+    #define B(i_, j_)  (B + (i_) + (j_)*ldb)
+    #define X(i_, j_)  (X + (i_) + (j_)*ldx)
+    #define R(i_, j_)  (R + (i_) + (j_)*ldr)
+
+    // Constants
+    const double      BWDMAX  = 1.0;
+    const magma_int_t ITERMAX = 30;
+    const magma_int_t GMRES_ITERMAX = 10, GMRES_M = 50;
+    const double      GMRES_TOL = 1e-4;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magma_int_t ione = 1;
+
+    // Local variables
+    magmaDoubleComplex *R=NULL, *V=NULL, *H=NULL, *sn=NULL, *g=NULL, *t=NULL;
+    magmaFloatComplex *SA=NULL, *SX=NULL;
+    double *cs=NULL, *dwork=NULL;
+    double Anrm, Xnrm, Rnrm, cte, eps;
+    magma_int_t i, j, iiter, itermax, ldsa, ldr, ldv, ldh, gmres_iters;
+    bool gmres, converged;
+
+    /* Check arguments */
+    *iter = 0;
+    *info = 0;
+    gmres = (solver_type == Magma_REFINE_IRGMSTRS);
+    if ( trans != MagmaNoTrans && trans != MagmaTrans && trans != MagmaConjTrans )
+        *info = -1;
+    else if ( n < 0 )
+        *info = -2;
+    else if ( nrhs < 0 )
+        *info = -3;
+    else if ( lda < max(1,n))
+        *info = -5;
+    else if ( ldb < max(1,n))
+        *info = -8;
+    else if ( ldx < max(1,n))
+        *info = -10;
+    else if ( facto_type != Magma_PREC_SS && facto_type != Magma_PREC_SB )
+        *info = -11;
+    else if ( solver_type != Magma_REFINE_IRSTRS && ! gmres )
+        *info = -12;
+
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    if ( n == 0 || nrhs == 0 )
+        return *info;
+
+    ldsa = n;
+    ldr  = n;
+    ldv  = n;
+    ldh  = GMRES_M + 1;
+    itermax = (gmres ? GMRES_ITERMAX : ITERMAX);
+    gmres_iters = 0;
+
+    if ( MAGMA_SUCCESS != magma_cmalloc_cpu( &SA, ldsa*n ) ||
+         MAGMA_SUCCESS != magma_cmalloc_cpu( &SX, n ) ||
+         MAGMA_SUCCESS != magma_zmalloc_cpu( &R,  ldr*nrhs ) ||
+         MAGMA_SUCCESS != magma_dmalloc_cpu( &dwork, n ))
+    {
+        *info = MAGMA_ERR_HOST_ALLOC;
+        goto cleanup;
+    }
+    if ( gmres ) {
+        if ( MAGMA_SUCCESS != magma_zmalloc_cpu( &V,  ldv*(GMRES_M + 1) ) ||
+             MAGMA_SUCCESS != magma_zmalloc_cpu( &H,  ldh*GMRES_M ) ||
+             MAGMA_SUCCESS != magma_dmalloc_cpu( &cs, GMRES_M + 1 ) ||
+             MAGMA_SUCCESS != magma_zmalloc_cpu( &sn, GMRES_M + 1 ) ||
+             MAGMA_SUCCESS != magma_zmalloc_cpu( &g,  GMRES_M + 1 ) ||
+             MAGMA_SUCCESS != magma_zmalloc_cpu( &t,  GMRES_M + 1 ))
+        {
+            *info = MAGMA_ERR_HOST_ALLOC;
+            goto cleanup;
+        }
+    }
+
+    eps  = lapackf77_dlamch("Epsilon");
+    Anrm = lapackf77_zlange( "I", &n, &n, A, &lda, dwork );
+    cte  = Anrm * eps * magma_dsqrt( (double) n ) * BWDMAX;
+
+    /*
+     * Convert to single precision, optionally round to bfloat16, and factor
+     */
+    lapackf77_zlag2c( &n, &n, A, &lda, SA, &ldsa, info );
+    if (*info != 0) {
+        *iter = -2;
+        goto fallback;
+    }
+    if ( facto_type == Magma_PREC_SB ) {
+        zcgesv_gmres_cpu_round_bf16( n, n, SA, ldsa );
+    }
+
+    lapackf77_cgetrf( &n, &n, SA, &ldsa, ipiv, info );
+    if (*info != 0) {
+        *iter = -3;
+        goto fallback;
+    }
+
+    // initial solution X = (P L U)^{-1} B in single precision
+    lapackf77_zlacpy( "F", &n, &nrhs, B, &ldb, X, &ldx );
+    for( j=0; j < nrhs; ++j ) {
+        zcgesv_gmres_cpu_precond( trans, n, SA, ldsa, ipiv, X(0,j), SX );
+    }
+
+    for( iiter=0; iiter <= itermax; ++iiter ) {
+        if ( iiter > 0 ) {
+            // solve the correction op(A) D = R, with D overwriting R,
+            // and add it to X
+            for( j=0; j < nrhs; ++j ) {
+                if ( gmres ) {
+                    gmres_iters += zcgesv_gmres_cpu_gmres(
+                        trans, n, A, lda, SA, ldsa, ipiv, R(0,j),
+                        GMRES_M, GMRES_TOL, V, ldv, H, ldh, cs, sn, g, t, SX );
+                }
+                else {
+                    zcgesv_gmres_cpu_precond( trans, n, SA, ldsa, ipiv, R(0,j), SX );
+                }
+            }
+            for( j=0; j < nrhs; ++j ) {
+                blasf77_zaxpy( &n, &c_one, R(0,j), &ione, X(0,j), &ione );
+            }
+        }
+
+        // residual R = B - op(A) X in double precision
+        lapackf77_zlacpy( "F", &n, &nrhs, B, &ldb, R, &ldr );
+        blasf77_zgemm( lapack_trans_const( trans ), "NoTrans", &n, &nrhs, &n,
+                       &c_neg_one, A, &lda,
+                                   X, &ldx,
+                       &c_one,     R, &ldr );
+
+        /*  Check whether the nrhs normwise backward errors satisfy the
+         *  stopping criterion; written so a NaN residual does not. */
+        converged = true;
+        for( j=0; j < nrhs && converged; ++j ) {
+            i = blasf77_izamax( &n, X(0,j), &ione ) - 1;
+            Xnrm = lapackf77_zlange( "F", &ione, &ione, X(i,j), &ione, dwork );
+            i = blasf77_izamax( &n, R(0,j), &ione ) - 1;
+            Rnrm = lapackf77_zlange( "F", &ione, &ione, R(i,j), &ione, dwork );
+            converged = (Rnrm <= Xnrm*cte);
+        }
+        if ( converged ) {
+            *iter = (gmres ? gmres_iters : iiter);
+            goto cleanup;
+        }
+    }
+
+    /* If we are at this place of the code, this is because we have
+     * performed ITER=itermax iterations and never satisified the
+     * stopping criterion. Set up the ITER flag accordingly and follow
+     * up on double precision routine. */
+    *iter = -itermax - 1;
+
+fallback:
+    /* Single-precision iterative refinement failed to converge to a
+     * satisfactory solution, so we resort to double precision. */
+    lapackf77_zgetrf( &n, &n, A, &lda, ipiv, info );
+    if (*info == 0) {
+        lapackf77_zlacpy( "F", &n, &nrhs, B, &ldb, X, &ldx );
+        lapackf77_zgetrs( lapack_trans_const( trans ), &n, &nrhs, A, &lda, ipiv, X, &ldx, info );
+    }
+
+cleanup:
+    magma_free_cpu( SA );
+    magma_free_cpu( SX );
+    magma_free_cpu( R  );
+    magma_free_cpu( dwork );
+    magma_free_cpu( V  );
+    magma_free_cpu( H  );
+    magma_free_cpu( cs );
+    magma_free_cpu( sn );
+    magma_free_cpu( g  );
+    magma_free_cpu( t  );
+    return *info;
+}
@@ -30,6 +30,12 @@
  */
 #define TREVC_VERSION 4
 
+/*
+ * HSEQR version 1 - LAPACK
+ * HSEQR version 2 - multishift QR with AED, multi-threaded (MAGMA)
+ */
+#define HSEQR_VERSION 2
+
 /***************************************************************************//**
     Purpose
     -------
@@ -306,8 +312,13 @@ magma_zgeev(
          *  - including N reserved for gebal/gebak, unused by zhseqr */
         iwrk = itau;
         liwrk = lwork - iwrk;
+        #if HSEQR_VERSION == 1
         lapackf77_zhseqr( "S", "V", &n, &ilo, &ihi, A, &lda, w,
                           VL, &ldvl, &work[iwrk], &liwrk, info );
+        #elif HSEQR_VERSION == 2
+        magma_zhseqr_mt( MagmaTrue, MagmaVec, n, ilo, ihi, A, lda, w,
+                         VL, ldvl, magma_get_parallel_numthreads(), info );
+        #endif
         time_sum += timer_stop( time_hseqr );
         flop_sum += flops_stop( flop_hseqr );
 
@@ -349,8 +360,13 @@ magma_zgeev(
         flops_start( flop_hseqr );
         iwrk = itau;
         liwrk = lwork - iwrk;
+        #if HSEQR_VERSION == 1
         lapackf77_zhseqr( "S", "V", &n, &ilo, &ihi, A, &lda, w,
                           VR, &ldvr, &work[iwrk], &liwrk, info );
+        #elif HSEQR_VERSION == 2
+        magma_zhseqr_mt( MagmaTrue, MagmaVec, n, ilo, ihi, A, lda, w,
+                         VR, ldvr, magma_get_parallel_numthreads(), info );
+        #endif
         time_sum += timer_stop( time_hseqr );
         flop_sum += flops_stop( flop_hseqr );
     }
@@ -363,8 +379,13 @@ magma_zgeev(
         flops_start( flop_hseqr );
         iwrk = itau;
         liwrk = lwork - iwrk;
+        #if HSEQR_VERSION == 1
         lapackf77_zhseqr( "E", "N", &n, &ilo, &ihi, A, &lda, w,
                           VR, &ldvr, &work[iwrk], &liwrk, info );
+        #elif HSEQR_VERSION == 2
+        magma_zhseqr_mt( MagmaFalse, MagmaNoVec, n, ilo, ihi, A, lda, w,
+                         VR, ldvr, magma_get_parallel_numthreads(), info );
+        #endif
         time_sum += timer_stop( time_hseqr );
         flop_sum += flops_stop( flop_hseqr );
     }
@@ -0,0 +1,340 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+#include "magma_internal.h"
+
+#define COMPLEX
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZGEQP3_RAND computes a QR factorization with column pivoting of the first
+    K columns of a matrix A:
+
+        A*P = Q * [ R11  R12 ]
+                  [  0   A22 ],
+
+    where R11 is K-by-K upper triangular, choosing the pivots NB columns at a
+    time from a random sketch of A instead of from the column norms
+    (randomized QRCP, also known as HQRRP):
+
+        Y = S A, an L-by-N sketch with L = NB + P;
+        for each block of NB columns:
+            1. zgeqp3 on the small sketch Y picks the next NB pivot columns,
+               which are moved to the front of the trailing matrix;
+            2. zgeqp3 factors that M-by-NB panel, ordering the pivots
+               within the block;
+            3. the reflectors are applied to the trailing matrix with zlarfb;
+            4. the sketch of the trailing matrix is downdated as
+               Y2 = Y2 - Y1 R11^{-1} R12, or drawn again if R11 is too
+               ill-conditioned for the downdate.
+
+    Unlike zgeqp3, whose column norm updates make half of the flops BLAS-2,
+    all the O(M N K) work is in zlarfb, ztrsm, and zgemm.
+    The pivots are as rank-revealing as those of zgeqp3 in practice, but
+    they are not the same; the diagonal of R is decreasing between blocks
+    only approximately.
+
+    See P. G. Martinsson, G. Quintana-Orti, N. Heavner, R. van de Geijn,
+    "Householder QR factorization with randomization for column pivoting
+    (HQRRP)", SIAM J. Sci. Comput., 2017; and
+    J. Duersch, M. Gu, "Randomized QR with column pivoting",
+    SIAM J. Sci. Comput., 2017.
+
+    Arguments
+    ---------
+    @param[in]
+    sketch  magma_sketch_t
+            The kind of random sketch; see magma_zsketch.
+
+    @param[in]
+    m       INTEGER
+            The number of rows of the matrix A. M >= 0.
+
+    @param[in]
+    n       INTEGER
+            The number of columns of the matrix A.  N >= 0.
+
+    @param[in]
+    k       INTEGER
+            The number of columns to factor. 0 <= K <= min(M,N).
+            K = min(M,N) gives the full factorization; a smaller K gives
+            the rank-K truncated factorization, A*P ~= Q(:,1:K) [R11 R12].
+
+    @param[in,out]
+    A       COMPLEX_16 array, dimension (LDA,N)
+            On entry, the M-by-N matrix A.
+            On exit, the upper triangle of the leading K columns, and the
+            leading K rows of the trailing columns, contain the K-by-N upper
+            trapezoidal matrix [R11 R12]; the elements below the diagonal of
+            the leading K columns, together with the array TAU, represent
+            the unitary matrix Q as a product of K elementary reflectors.
+            The trailing (M-K)-by-(N-K) matrix contains A22.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A. LDA >= max(1,M).
+
+    @param[out]
+    jpvt    INTEGER array, dimension (N)
+            On exit, if JPVT(J)=K, then the J-th column of A*P was the
+            the K-th column of A.
+
+    @param[out]
+    tau     COMPLEX_16 array, dimension (K)
+            The scalar factors of the elementary reflectors.
+
+    @param[in]
+    nb      INTEGER
+            The number of pivots chosen at a time. NB >= 1.
+            Typically 64 to 128.
+
+    @param[in]
+    p       INTEGER
+            The oversampling of the sketch. P >= 0. Typically 5 to 10.
+
+    @param[in,out]
+    iseed   INTEGER array, dimension (4)
+            The seed of the random number generator; see magma_zsketch.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+                  or another error occured, such as memory allocation failed.
+
+    @ingroup magma_geqp3_rand
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zgeqp3_rand(
+    magma_sketch_t sketch,
+    magma_int_t m, magma_int_t n, magma_int_t k,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magma_int_t *jpvt, magmaDoubleComplex *tau,
+    magma_int_t nb, magma_int_t p,
+    magma_int_t *iseed,
+    magma_int_t *info )
+{
+    #define A(i_, j_)  (A  + (i_) + (j_)*lda)
+    #define Y(i_, j_)  (Y  + (i_) + (j_)*ldy)
+
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    const magma_int_t ione = 1, ineg_one = -1;
+
+    magma_int_t i, j, jb, c, s, t, l, ldy, mrem, nrem, ntrail, lwork, ldtmp, iinfo;
+    double dmin, dmax, d, tol;
+    magmaDoubleComplex *Y = NULL, *Yw = NULL, *W = NULL, *T = NULL,
+                       *tmp = NULL, *tauw = NULL, *work = NULL, query[1];
+    magma_int_t *jpw = NULL, *pos = NULL, *at = NULL;
+    #ifdef COMPLEX
+    double *rwork = NULL;
+    #endif
+
+    *info = 0;
+    if ( sketch != MagmaSketchGaussian && sketch != MagmaSketchSparseSign ) {
+        *info = -1;
+    } else if ( m < 0 ) {
+        *info = -2;
+    } else if ( n < 0 ) {
+        *info = -3;
+    } else if ( k < 0 || k > min(m,n) ) {
+        *info = -4;
+    } else if ( lda < max(1,m) ) {
+        *info = -6;
+    } else if ( nb < 1 ) {
+        *info = -9;
+    } else if ( p < 0 ) {
+        *info = -10;
+    }
+
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    for( j=0; j < n; ++j ) {
+        jpvt[j] = j+1;
+    }
+
+    // Quick return if possible
+    if ( k == 0 ) {
+        return *info;
+    }
+
+    nb    = min( nb, k );
+    l     = nb + p;
+    ldy   = l;
+    ldtmp = max( m, l );
+    // R11 closer to singular than this is not used for the downdate
+    tol   = magma_dsqrt( lapackf77_dlamch( "Epsilon" ));
+
+    // workspace for zgeqp3 of the l-by-n sketch and the m-by-nb panels
+    lapackf77_zgeqp3( &l, &n, NULL, &ldy, NULL, NULL, query, &ineg_one,
+                      #ifdef COMPLEX
+                      NULL,
+                      #endif
+                      &iinfo );
+    lwork = magma_int_t( MAGMA_Z_REAL( query[0] ));
+    lapackf77_zgeqp3( &m, &nb, NULL, &lda, NULL, NULL, query, &ineg_one,
+                      #ifdef COMPLEX
+                      NULL,
+                      #endif
+                      &iinfo );
+    lwork = max( lwork, magma_int_t( MAGMA_Z_REAL( query[0] )));
+
+    if (MAGMA_SUCCESS != magma_zmalloc_cpu( &Y,    l*n      ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &Yw,   l*n      ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &W,    n*nb     ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &T,    nb*nb    ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &tmp,  ldtmp*nb ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &tauw, l        ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &work, lwork    ) ||
+        MAGMA_SUCCESS != magma_imalloc_cpu( &jpw,  n        ) ||
+        MAGMA_SUCCESS != magma_imalloc_cpu( &pos,  n        ) ||
+        #ifdef COMPLEX
+        MAGMA_SUCCESS != magma_dmalloc_cpu( &rwork, 2*n     ) ||
+        #endif
+        MAGMA_SUCCESS != magma_imalloc_cpu( &at,   n        ))
+    {
+        *info = MAGMA_ERR_HOST_ALLOC;
+        goto cleanup;
+    }
+
+    // Y = S A
+    magma_zsketch( sketch, MagmaLeft, m, n, l, A, lda, Y, ldy, iseed, info );
+    if (*info != 0) {
+        goto cleanup;
+    }
+
+    for( j=0; j < k; j += jb ) {
+        jb     = min( nb, k-j );
+        mrem   = m - j;
+        nrem   = n - j;
+        ntrail = nrem - jb;
+
+        // 1. QRCP of the sketch of the trailing matrix picks jb pivots.
+        //    Move them to the front, tracking which column is where.
+        lapackf77_zlacpy( "F", &l, &nrem, Y(0,j), &ldy, Yw, &l );
+        for( i=0; i < nrem; ++i ) {
+            jpw[i] = 0;
+            pos[i] = i;
+            at[i]  = i;
+        }
+        lapackf77_zgeqp3( &l, &nrem, Yw, &l, jpw, tauw, work, &lwork,
+                          #ifdef COMPLEX
+                          rwork,
+                          #endif
+                          &iinfo );
+        for( i=0; i < jb; ++i ) {
+            c = jpw[i] - 1;
+            s = pos[c];
+            if ( s != i ) {
+                blasf77_zswap( &m, A(0,j+i), &ione, A(0,j+s), &ione );
+                blasf77_zswap( &l, Y(0,j+i), &ione, Y(0,j+s), &ione );
+                t = jpvt[j+i];  jpvt[j+i] = jpvt[j+s];  jpvt[j+s] = t;
+                t = at[i];
+                at[i] = c;  pos[c] = i;
+                at[s] = t;  pos[t] = s;
+            }
+        }
+
+        // 2. QRCP of the panel orders the pivots within the block.
+        //    Apply its permutation to the rows above the panel, the
+        //    sketch, and jpvt, too.
+        for( i=0; i < jb; ++i ) {
+            jpw[i] = 0;
+        }
+        lapackf77_zgeqp3( &mrem, &jb, A(j,j), &lda, jpw, &tau[j], work, &lwork,
+                          #ifdef COMPLEX
+                          rwork,
+                          #endif
+                          &iinfo );
+        for( i=0; i < jb; ++i ) {
+            c = jpw[i] - 1;
+            if ( j > 0 ) {
+                blasf77_zcopy( &j, A(0,j+c), &ione, &tmp[i*ldtmp], &ione );
+            }
+            pos[i] = jpvt[j+c];
+        }
+        for( i=0; i < jb; ++i ) {
+            jpvt[j+i] = pos[i];
+        }
+        if ( j > 0 ) {
+            lapackf77_zlacpy( "F", &j, &jb, tmp, &ldtmp, A(0,j), &lda );
+        }
+        for( i=0; i < jb; ++i ) {
+            c = jpw[i] - 1;
+            blasf77_zcopy( &l, Y(0,j+c), &ione, &tmp[i*ldtmp], &ione );
+        }
+        lapackf77_zlacpy( "F", &l, &jb, tmp, &ldtmp, Y(0,j), &ldy );
+
+        if ( ntrail > 0 ) {
+            // 3. Update the trailing matrix, A22 = Q^H A22
+            magma_zlarft_cpu( MagmaForward, MagmaColumnwise, mrem, jb,
+                              A(j,j), lda, &tau[j], T, jb, &iinfo );
+            magma_zlarfb_cpu( MagmaLeft, Magma_ConjTrans, MagmaForward, MagmaColumnwise,
+                              mrem, ntrail, jb,
+                              A(j,j), lda, T, jb,
+                              A(j,j+jb), lda, W, n*nb, &iinfo );
+        }
+
+        if ( j + jb < k ) {
+            // 4. Downdate the sketch, Y2 = Y2 - Y1 R11^{-1} R12, with the
+            //    sketch Y1 of the panel before it was factored. If R11 is
+            //    too ill-conditioned, sketch the trailing matrix again.
+            dmin = dmax = MAGMA_Z_ABS( *A(j,j) );
+            for( i=1; i < jb; ++i ) {
+                d = MAGMA_Z_ABS( *A(j+i,j+i) );
+                dmin = min( dmin, d );
+                dmax = max( dmax, d );
+            }
+            if ( dmin > tol * dmax ) {
+                lapackf77_zlacpy( "F", &jb, &ntrail, A(j,j+jb), &lda, W, &jb );
+                blasf77_ztrsm( MagmaLeftStr, MagmaUpperStr, MagmaNoTransStr, MagmaNonUnitStr,
+                               &jb, &ntrail,
+                               &c_one, A(j,j), &lda,
+                                       W,      &jb );
+                blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &l, &ntrail, &jb,
+                               &c_neg_one, Y(0,j),    &ldy,
+                                           W,         &jb,
+                               &c_one,     Y(0,j+jb), &ldy );
+            }
+            else {
+                mrem -= jb;
+                magma_zsketch( sketch, MagmaLeft, mrem, ntrail, l,
+                               A(j+jb,j+jb), lda, Y(0,j+jb), ldy, iseed, info );
+                if (*info != 0) {
+                    goto cleanup;
+                }
+            }
+        }
+    }
+
+cleanup:
+    magma_free_cpu( Y );
+    magma_free_cpu( Yw );
+    magma_free_cpu( W );
+    magma_free_cpu( T );
+    magma_free_cpu( tmp );
+    magma_free_cpu( tauw );
+    magma_free_cpu( work );
+    magma_free_cpu( jpw );
+    magma_free_cpu( pos );
+    magma_free_cpu( at );
+    #ifdef COMPLEX
+    magma_free_cpu( rwork );
+    #endif
+
+    return *info;
+
+    #undef A
+    #undef Y
+} /* magma_zgeqp3_rand */
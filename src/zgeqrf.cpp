@@ -185,6 +185,9 @@ magma_zgeqrf(
     magma_queue_create( cdev, &queues[0] );
     magma_queue_create( cdev, &queues[1] );
     
+    /* CPU panels use the recursive version, if enabled */
+    magma_int_t nthread_panel = magma_get_panel_numthreads();
+    
     if ( (nb > 1) && (nb < min_mn) ) {
         /* Use blocked code initially.
            Asynchronously send the matrix to the GPU except the first panel. */
@@ -216,12 +219,19 @@ magma_zgeqrf(
             }
             
             magma_int_t rows = m-i;
-            lapackf77_zgeqrf( &rows, &ib, A(i,i), &lda, tau+i, work, &lwork, info );
-            
-            /* Form the triangular factor of the block reflector
-               H = H(i) H(i+1) . . . H(i+ib-1) */
-            lapackf77_zlarft( MagmaForwardStr, MagmaColumnwiseStr,
-                              &rows, &ib, A(i,i), &lda, tau+i, work, &ib );
+            if (nthread_panel > 0) {
+                /* recursive version forms T, in work, along the way */
+                magma_zgeqrf_rec_cpu( rows, ib, A(i,i), lda, tau+i, work, ib,
+                                      nthread_panel, info );
+            }
+            else {
+                lapackf77_zgeqrf( &rows, &ib, A(i,i), &lda, tau+i, work, &lwork, info );
+                
+                /* Form the triangular factor of the block reflector
+                   H = H(i) H(i+1) . . . H(i+ib-1) */
+                lapackf77_zlarft( MagmaForwardStr, MagmaColumnwiseStr,
+                                  &rows, &ib, A(i,i), &lda, tau+i, work, &ib );
+            }
             
             magma_zpanel_to_q( MagmaUpper, ib, A(i,i), lda, work+ib*ib );
             
@@ -0,0 +1,201 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+#include "magma_internal.h"
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZGEQRF_OOC_CPU computes a QR factorization of a COMPLEX_16 M-by-N matrix A,
+    stored out-of-core in a file, so A may exceed the host memory:
+    A = Q * R.
+
+    This is a left-looking algorithm on block columns (slabs), as wide as
+    the memory budget allows. Each slab is read into host memory, updated by
+    the block reflectors of all previous block columns, which are read one
+    NB-wide panel at a time, with magma_zlarft_cpu and magma_zlarfb_cpu,
+    factored with LAPACK zgeqrf, and written back. Reading the next panel
+    overlaps updating with the current one. The triangular factors T are
+    recomputed from each panel, rather than stored.
+
+    Arguments
+    ---------
+    @param[in,out]
+    A       Out-of-core M-by-N matrix of COMPLEX_16 elements,
+            created by magma_ooc_create, with tile size NB.
+            On entry, the M-by-N matrix A.
+            On exit, the elements on and above the diagonal of the array
+            contain the min(M,N)-by-N upper trapezoidal matrix R (R is
+            upper triangular if m >= n); the elements below the diagonal,
+            with the array TAU, represent the unitary matrix Q as a
+            product of min(m,n) elementary reflectors (see Further
+            Details).
+
+    @param[out]
+    tau     COMPLEX_16 array, dimension (min(M,N))
+            The scalar factors of the elementary reflectors (see Further
+            Details).
+
+    @param[in]
+    mem_budget  SIZE_T
+            Bytes of host memory to use for the slab and panel, in addition
+            to the tile cache of A and O(N*NB) workspace.
+            MEM_BUDGET >= M*(min(NB,N) + NB)*sizeof(COMPLEX_16).
+            A larger budget gives wider slabs, so fewer reads of previous
+            block columns.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+                  or another error occured, such as memory allocation failed
+                  or a file error (MAGMA_ERR_FILESYSTEM).
+
+    Further Details
+    ---------------
+    The matrix Q is represented as a product of elementary reflectors
+
+       Q = H(1) H(2) . . . H(k), where k = min(m,n).
+
+    Each H(i) has the form
+
+       H(i) = I - tau * v * v'
+
+    where tau is a complex scalar, and v is a complex vector with
+    v(1:i-1) = 0 and v(i) = 1; v(i+1:m) is stored on exit in A(i+1:m,i),
+    and tau in TAU(i).
+
+    @ingroup magma_geqrf
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zgeqrf_ooc_cpu(
+    magma_ooc_t A, magmaDoubleComplex *tau, size_t mem_budget,
+    magma_int_t *info )
+{
+    #define B(i_, j_) (B + (i_) + (j_)*ldb)
+
+    /* Local variables */
+    magmaDoubleComplex *work, *B, *P, *T, *hwork, query[1];
+    magma_int_t m, n, nb, minmn, kend, j, jb, k, kb, next, rows, ldb, ldp,
+                lwork, lwork_larfb, lwork_geqrf, iinfo;
+    magma_int_t lquery = -1;
+    size_t elemsize, budget;
+
+    *info = 0;
+    if (A != NULL) {
+        magma_ooc_getsize( A, &m, &n, &nb, &elemsize );
+    }
+    budget = mem_budget / sizeof(magmaDoubleComplex);
+    if (A == NULL || elemsize != sizeof(magmaDoubleComplex)) {
+        *info = -1;
+    } else if (budget < size_t(m)*(min( nb, n ) + nb)) {
+        *info = -3;
+    }
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    /* Quick return */
+    minmn = min( m, n );
+    if (minmn == 0)
+        return *info;
+
+    // widest slab that fits in the budget, in multiples of nb:
+    // m-by-jb slab + m-by-nb panel
+    budget = min( budget, size_t(m)*(n + nb) );
+    jb = min( nb, n );
+    while (jb < n) {
+        next = min( jb + nb, n );
+        if (size_t(m)*(next + nb) > budget)
+            break;
+        jb = next;
+    }
+
+    // workspace for T, zlarfb, and zgeqrf
+    magma_zlarfb_cpu( MagmaLeft, Magma_ConjTrans, MagmaForward, MagmaColumnwise,
+                      m, jb, min( nb, minmn ), NULL, m, NULL, nb, NULL, m,
+                      query, -1, &iinfo );
+    lwork_larfb = magma_int_t( MAGMA_Z_REAL( query[0] ));
+    lapackf77_zgeqrf( &m, &jb, NULL, &m, NULL, query, &lquery, &iinfo );
+    lwork_geqrf = magma_int_t( MAGMA_Z_REAL( query[0] ));
+    lwork = max( lwork_larfb, lwork_geqrf );
+
+    ldb = m;
+    if (MAGMA_SUCCESS != magma_zmalloc_cpu( &work,  budget ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &T,     nb*nb  ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &hwork, lwork  )) {
+        magma_free_cpu( work );
+        magma_free_cpu( T );
+        *info = MAGMA_ERR_HOST_ALLOC;
+        return *info;
+    }
+    B = work;
+    P = work + size_t(ldb)*jb;
+
+    iinfo = 0;
+    for (j = 0; j < n && iinfo == 0; j += jb) {
+        //=========================================================
+        // slab A(0:m, j:j+jb)
+        jb = min( jb, n - j );
+        kend = min( j, minmn );
+        iinfo = magma_ooc_getmatrix( m, jb, A, 0, j, B, ldb );
+        if (iinfo != 0)
+            break;
+        if (kend > 0) {
+            magma_ooc_prefetch( m, nb, A, 0, 0 );
+        }
+
+        for (k = 0; k < kend; k += nb) {
+            // panel V = A(k:m, k:k+kb); read ahead the next one
+            kb   = min( nb, kend - k );
+            rows = m - k;
+            ldp  = rows;
+            iinfo = magma_ooc_getmatrix( rows, kb, A, k, k, P, ldp );
+            if (iinfo != 0)
+                break;
+            if (k + kb < kend) {
+                magma_ooc_prefetch( rows - kb, nb, A, k + kb, k + kb );
+            }
+
+            // B(k:m, :) = (I - V T V^H)^H B(k:m, :)
+            magma_zlarft_cpu( MagmaForward, MagmaColumnwise, rows, kb,
+                              P, ldp, tau + k, T, nb, &iinfo );
+            magma_zlarfb_cpu( MagmaLeft, Magma_ConjTrans, MagmaForward, MagmaColumnwise,
+                              rows, jb, kb, P, ldp, T, nb, B(k, 0), ldb,
+                              hwork, lwork, &iinfo );
+        }
+        if (iinfo != 0)
+            break;
+
+        // factor the slab below the diagonal
+        if (j < minmn) {
+            if (j + jb < n) {
+                magma_ooc_prefetch( m, nb, A, 0, j + jb );
+            }
+            rows = m - j;
+            lapackf77_zgeqrf( &rows, &jb, B(j, 0), &ldb, tau + j, hwork, &lwork, &iinfo );
+        }
+        iinfo = magma_ooc_setmatrix( m, jb, B, ldb, A, 0, j );
+    }
+
+    if (iinfo == 0) {
+        iinfo = magma_ooc_flush( A );
+    }
+    if (iinfo != 0) {
+        *info = iinfo;
+    }
+
+    magma_free_cpu( work );
+    magma_free_cpu( T );
+    magma_free_cpu( hwork );
+
+    return *info;
+} /* magma_zgeqrf_ooc_cpu */
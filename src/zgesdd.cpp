@@ -887,7 +887,7 @@ magma_zgesdd(
                 iru    = ie   + n;
                 irvt   = iru  + n*n;
                 nrwork = irvt + n*n;
-                lapackf77_dbdsdc( "U", "I", &n, s, &rwork[ie], &rwork[iru], &n, &rwork[irvt], &n, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, n, s, &rwork[ie], &rwork[iru], n, &rwork[irvt], n, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRU] to complex matrix WORK[IU]
                 // Overwrite WORK[IU] by the left singular vectors of R
@@ -987,7 +987,7 @@ magma_zgesdd(
                 iru    = ie   + n;
                 irvt   = iru  + n*n;
                 nrwork = irvt + n*n;
-                lapackf77_dbdsdc( "U", "I", &n, s, &rwork[ie], &rwork[iru], &n, &rwork[irvt], &n, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, n, s, &rwork[ie], &rwork[iru], n, &rwork[irvt], n, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRU] to complex matrix U
                 // Overwrite U by left singular vectors of R
@@ -1083,7 +1083,7 @@ magma_zgesdd(
                 iru    = ie   + n;
                 irvt   = iru  + n*n;
                 nrwork = irvt + n*n;
-                lapackf77_dbdsdc( "U", "I", &n, s, &rwork[ie], &rwork[iru], &n, &rwork[irvt], &n, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, n, s, &rwork[ie], &rwork[iru], n, &rwork[irvt], n, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRU] to complex matrix WORK[IU]
                 // Overwrite WORK[IU] by left singular vectors of R
@@ -1199,7 +1199,7 @@ magma_zgesdd(
                 iru    = nrwork;
                 irvt   = iru  + n*n;
                 nrwork = irvt + n*n;
-                lapackf77_dbdsdc( "U", "I", &n, s, &rwork[ie], &rwork[iru], &n, &rwork[irvt], &n, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, n, s, &rwork[ie], &rwork[iru], n, &rwork[irvt], n, &rwork[nrwork], iwork, info );
 
                 // Multiply real matrix RWORK[IRVT] by P**H in VT,
                 // storing the result in WORK[IU], copying to VT
@@ -1256,7 +1256,7 @@ magma_zgesdd(
                 iru    = nrwork;
                 irvt   = iru  + n*n;
                 nrwork = irvt + n*n;
-                lapackf77_dbdsdc( "U", "I", &n, s, &rwork[ie], &rwork[iru], &n, &rwork[irvt], &n, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, n, s, &rwork[ie], &rwork[iru], n, &rwork[irvt], n, &rwork[nrwork], iwork, info );
 
                 // Multiply real matrix RWORK[IRVT] by P**H in VT,
                 // storing the result in A, copying to VT
@@ -1308,7 +1308,7 @@ magma_zgesdd(
                 iru    = nrwork;
                 irvt   = iru  + n*n;
                 nrwork = irvt + n*n;
-                lapackf77_dbdsdc( "U", "I", &n, s, &rwork[ie], &rwork[iru], &n, &rwork[irvt], &n, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, n, s, &rwork[ie], &rwork[iru], n, &rwork[irvt], n, &rwork[nrwork], iwork, info );
 
                 // Multiply real matrix RWORK[IRVT] by P**H in VT,
                 // storing the result in A, copying to VT
@@ -1379,7 +1379,7 @@ magma_zgesdd(
                 iru    = nrwork;
                 irvt   = iru  + n*n;
                 nrwork = irvt + n*n;
-                lapackf77_dbdsdc( "U", "I", &n, s, &rwork[ie], &rwork[iru], &n, &rwork[irvt], &n, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, n, s, &rwork[ie], &rwork[iru], n, &rwork[irvt], n, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRVT] to complex matrix VT
                 // Overwrite VT by right singular vectors of A
@@ -1451,7 +1451,7 @@ magma_zgesdd(
                 iru    = nrwork;
                 irvt   = iru  + n*n;
                 nrwork = irvt + n*n;
-                lapackf77_dbdsdc( "U", "I", &n, s, &rwork[ie], &rwork[iru], &n, &rwork[irvt], &n, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, n, s, &rwork[ie], &rwork[iru], n, &rwork[irvt], n, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRU] to complex matrix U
                 // Overwrite U by left singular vectors of A
@@ -1491,7 +1491,7 @@ magma_zgesdd(
                 iru    = nrwork;
                 irvt   = iru  + n*n;
                 nrwork = irvt + n*n;
-                lapackf77_dbdsdc( "U", "I", &n, s, &rwork[ie], &rwork[iru], &n, &rwork[irvt], &n, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, n, s, &rwork[ie], &rwork[iru], n, &rwork[irvt], n, &rwork[nrwork], iwork, info );
 
                 // Set the right corner of U to identity matrix
                 lapackf77_zlaset( "F", &m, &m, &c_zero, &c_zero, U, &ldu );
@@ -1650,7 +1650,7 @@ magma_zgesdd(
                 iru    = ie   + m;
                 irvt   = iru  + m*m;
                 nrwork = irvt + m*m;
-                lapackf77_dbdsdc( "U", "I", &m, s, &rwork[ie], &rwork[iru], &m, &rwork[irvt], &m, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, m, s, &rwork[ie], &rwork[iru], m, &rwork[irvt], m, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRU] to complex matrix WORK[IU]
                 // Overwrite WORK[IU] by the left singular vectors of L
@@ -1750,7 +1750,7 @@ magma_zgesdd(
                 iru    = ie   + m;
                 irvt   = iru  + m*m;
                 nrwork = irvt + m*m;
-                lapackf77_dbdsdc( "U", "I", &m, s, &rwork[ie], &rwork[iru], &m, &rwork[irvt], &m, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, m, s, &rwork[ie], &rwork[iru], m, &rwork[irvt], m, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRU] to complex matrix U
                 // Overwrite U by left singular vectors of L
@@ -1846,7 +1846,7 @@ magma_zgesdd(
                 iru    = ie   + m;
                 irvt   = iru  + m*m;
                 nrwork = irvt + m*m;
-                lapackf77_dbdsdc( "U", "I", &m, s, &rwork[ie], &rwork[iru], &m, &rwork[irvt], &m, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, m, s, &rwork[ie], &rwork[iru], m, &rwork[irvt], m, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRU] to complex matrix U
                 // Overwrite U by left singular vectors of L
@@ -1964,7 +1964,7 @@ magma_zgesdd(
                 irvt   = nrwork;
                 iru    = irvt + m*m;
                 nrwork = iru  + m*m;
-                lapackf77_dbdsdc( "L", "I", &m, s, &rwork[ie], &rwork[iru], &m, &rwork[irvt], &m, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaIVec, m, s, &rwork[ie], &rwork[iru], m, &rwork[irvt], m, &rwork[nrwork], iwork, info );
 
                 // Multiply Q in U by real matrix RWORK[IRVT]
                 // storing the result in WORK[IVT], copying to U
@@ -2021,7 +2021,7 @@ magma_zgesdd(
                 irvt   = nrwork;
                 iru    = irvt + m*m;
                 nrwork = iru  + m*m;
-                lapackf77_dbdsdc( "L", "I", &m, s, &rwork[ie], &rwork[iru], &m, &rwork[irvt], &m, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaIVec, m, s, &rwork[ie], &rwork[iru], m, &rwork[irvt], m, &rwork[nrwork], iwork, info );
 
                 // Multiply Q in U by real matrix RWORK[IRU],
                 // storing the result in A, copying to U
@@ -2073,7 +2073,7 @@ magma_zgesdd(
                 irvt   = nrwork;
                 iru    = irvt + m*m;
                 nrwork = iru  + m*m;
-                lapackf77_dbdsdc( "L", "I", &m, s, &rwork[ie], &rwork[iru], &m, &rwork[irvt], &m, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaIVec, m, s, &rwork[ie], &rwork[iru], m, &rwork[irvt], m, &rwork[nrwork], iwork, info );
 
                 // Multiply Q in U by real matrix RWORK[IRU],
                 // storing the result in A, copying to U
@@ -2150,7 +2150,7 @@ magma_zgesdd(
                 irvt   = nrwork;
                 iru    = irvt + m*m;
                 nrwork = iru  + m*m;
-                lapackf77_dbdsdc( "L", "I", &m, s, &rwork[ie], &rwork[iru], &m, &rwork[irvt], &m, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaIVec, m, s, &rwork[ie], &rwork[iru], m, &rwork[irvt], m, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRU] to complex matrix U
                 // Overwrite U by left singular vectors of A
@@ -2222,7 +2222,7 @@ magma_zgesdd(
                 irvt   = nrwork;
                 iru    = irvt + m*m;
                 nrwork = iru  + m*m;
-                lapackf77_dbdsdc( "L", "I", &m, s, &rwork[ie], &rwork[iru], &m, &rwork[irvt], &m, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaIVec, m, s, &rwork[ie], &rwork[iru], m, &rwork[irvt], m, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRU] to complex matrix U
                 // Overwrite U by left singular vectors of A
@@ -2262,7 +2262,7 @@ magma_zgesdd(
                 irvt   = nrwork;
                 iru    = irvt + m*m;
                 nrwork = iru  + m*m;
-                lapackf77_dbdsdc( "L", "I", &m, s, &rwork[ie], &rwork[iru], &m, &rwork[irvt], &m, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaIVec, m, s, &rwork[ie], &rwork[iru], m, &rwork[irvt], m, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRU] to complex matrix U
                 // Overwrite U by left singular vectors of A
@@ -0,0 +1,259 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+#include "magma_internal.h"
+
+#define COMPLEX
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZGESVD_RAND computes a rank-K approximation of the M-by-N matrix A from
+    its randomized singular value decomposition (SVD),
+
+        A ~= U * SIGMA * V^H,
+
+    where SIGMA is a K-by-K diagonal matrix, U is an M-by-K matrix with
+    orthonormal columns, and V is an N-by-K matrix with orthonormal columns.
+    The diagonal elements of SIGMA are approximations of the K largest
+    singular values of A, in decreasing order.
+
+    The algorithm is
+        1. Q = magma_zrangefinder( A ), an M-by-L orthonormal basis,
+           with L = min( K + P, M, N ),
+        2. B = Q^H A, an L-by-N matrix,
+        3. B = Ub SIGMA V^H with LAPACK zgesdd,
+        4. U = Q Ub,
+    and returns the leading K singular triplets. All the O(M N L) work is in
+    GEMMs and blocked Householder QRs; the SVD is of the small matrix B only.
+
+    See N. Halko, P. G. Martinsson, J. Tropp, "Finding structure with
+    randomness: Probabilistic algorithms for constructing approximate matrix
+    decompositions", SIAM Review, 2011, Algorithm 5.1.
+
+    Arguments
+    ---------
+    @param[in]
+    jobz    magma_vec_t
+            Specifies options for computing U and V^H:
+      -     = MagmaSomeVec: the first K columns of U and the first K rows of
+                            V^H are returned in the arrays U and VT;
+      -     = MagmaNoVec:   no columns of U or rows of V^H are computed.
+
+    @param[in]
+    sketch  magma_sketch_t
+            The kind of random sketch; see magma_zsketch.
+
+    @param[in]
+    m       INTEGER
+            The number of rows of the matrix A. M >= 0.
+
+    @param[in]
+    n       INTEGER
+            The number of columns of the matrix A. N >= 0.
+
+    @param[in]
+    k       INTEGER
+            The target rank. 0 <= K <= min(M,N).
+
+    @param[in]
+    p       INTEGER
+            The oversampling. P >= 0. Typically 5 to 10.
+
+    @param[in]
+    niter   INTEGER
+            The number of power iterations of the range finder. NITER >= 0.
+
+    @param[in]
+    A       COMPLEX_16 array, dimension (LDA,N)
+            The M-by-N matrix A.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A. LDA >= max(1,M).
+
+    @param[out]
+    s       DOUBLE PRECISION array, dimension (K)
+            The approximate singular values of A, sorted so that
+            S(i) >= S(i+1).
+
+    @param[out]
+    U       COMPLEX_16 array, dimension (LDU,K)
+            If JOBZ = MagmaSomeVec, U contains the first K approximate left
+            singular vectors. If JOBZ = MagmaNoVec, U is not referenced.
+
+    @param[in]
+    ldu     INTEGER
+            The leading dimension of the array U. LDU >= 1; if
+            JOBZ = MagmaSomeVec, LDU >= M.
+
+    @param[out]
+    VT      COMPLEX_16 array, dimension (LDVT,N)
+            If JOBZ = MagmaSomeVec, VT contains the first K approximate right
+            singular vectors, stored rowwise. If JOBZ = MagmaNoVec, VT is not
+            referenced.
+
+    @param[in]
+    ldvt    INTEGER
+            The leading dimension of the array VT. LDVT >= 1; if
+            JOBZ = MagmaSomeVec, LDVT >= K.
+
+    @param[in,out]
+    iseed   INTEGER array, dimension (4)
+            The seed of the random number generator; see magma_zsketch.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+                  or another error occured, such as memory allocation failed.
+      -     > 0:  zgesdd did not converge.
+
+    @ingroup magma_gesvd_rand
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zgesvd_rand(
+    magma_vec_t jobz, magma_sketch_t sketch,
+    magma_int_t m, magma_int_t n, magma_int_t k, magma_int_t p,
+    magma_int_t niter,
+    const magmaDoubleComplex *A, magma_int_t lda,
+    double *s,
+    magmaDoubleComplex *U, magma_int_t ldu,
+    magmaDoubleComplex *VT, magma_int_t ldvt,
+    magma_int_t *iseed,
+    magma_int_t *info )
+{
+    const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    const magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    const magma_int_t ione = 1, ineg_one = -1;
+
+    magma_int_t l, lwork, ldub;
+    magmaDoubleComplex *Q = NULL, *B = NULL, *Ub = NULL, *VTb = NULL, *work = NULL, query[1];
+    double *sb = NULL;
+    magma_int_t *iwork = NULL;
+    #ifdef COMPLEX
+    magma_int_t lrwork;
+    double *rwork = NULL;
+    #endif
+
+    *info = 0;
+    bool wantvec = (jobz == MagmaSomeVec);
+    if ( ! wantvec && jobz != MagmaNoVec ) {
+        *info = -1;
+    } else if ( sketch != MagmaSketchGaussian && sketch != MagmaSketchSparseSign ) {
+        *info = -2;
+    } else if ( m < 0 ) {
+        *info = -3;
+    } else if ( n < 0 ) {
+        *info = -4;
+    } else if ( k < 0 || k > min(m,n) ) {
+        *info = -5;
+    } else if ( p < 0 ) {
+        *info = -6;
+    } else if ( niter < 0 ) {
+        *info = -7;
+    } else if ( lda < max(1,m) ) {
+        *info = -9;
+    } else if ( ldu < 1 || (wantvec && ldu < m) ) {
+        *info = -12;
+    } else if ( ldvt < 1 || (wantvec && ldvt < k) ) {
+        *info = -14;
+    }
+
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    // Quick return if possible
+    if ( k == 0 ) {
+        return *info;
+    }
+
+    l = min( k + p, min( m, n ));
+    ldub = l;
+
+    // workspace for the SVD of the l-by-n matrix B
+    lapackf77_zgesdd( lapack_vec_const( jobz ), &l, &n, NULL, &l, NULL,
+                      NULL, &ldub, NULL, &l, query, &ineg_one,
+                      #ifdef COMPLEX
+                      NULL,
+                      #endif
+                      NULL, info );
+    lwork = magma_int_t( MAGMA_Z_REAL( query[0] ));
+    *info = 0;
+    #ifdef COMPLEX
+    // see zgesdd; l <= n
+    if ( wantvec )
+        lrwork = l*max( 5*l + 7, 2*n + 2*l + 1 );
+    else
+        lrwork = 7*l;
+    #endif
+
+    if (MAGMA_SUCCESS != magma_zmalloc_cpu( &Q,     m*l   ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &B,     l*n   ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &work,  lwork ) ||
+        MAGMA_SUCCESS != magma_dmalloc_cpu( &sb,    l     ) ||
+        MAGMA_SUCCESS != magma_imalloc_cpu( &iwork, 8*l   ) ||
+        #ifdef COMPLEX
+        MAGMA_SUCCESS != magma_dmalloc_cpu( &rwork, lrwork ) ||
+        #endif
+        (wantvec && MAGMA_SUCCESS != magma_zmalloc_cpu( &Ub,  l*l )) ||
+        (wantvec && MAGMA_SUCCESS != magma_zmalloc_cpu( &VTb, l*n )))
+    {
+        *info = MAGMA_ERR_HOST_ALLOC;
+        goto cleanup;
+    }
+
+    // 1. Q = range finder of A
+    magma_zrangefinder( sketch, m, n, l, niter, A, lda, Q, m, iseed, info );
+    if (*info != 0) {
+        goto cleanup;
+    }
+
+    // 2. B = Q^H A
+    blasf77_zgemm( "ConjTrans", "NoTrans", &l, &n, &m,
+                   &c_one,  Q, &m, A, &lda,
+                   &c_zero, B, &l );
+
+    // 3. B = Ub SIGMA VTb
+    lapackf77_zgesdd( lapack_vec_const( jobz ), &l, &n, B, &l, sb,
+                      Ub, &ldub, VTb, &l, work, &lwork,
+                      #ifdef COMPLEX
+                      rwork,
+                      #endif
+                      iwork, info );
+    if (*info != 0) {
+        goto cleanup;
+    }
+    blasf77_dcopy( &k, sb, &ione, s, &ione );
+
+    if ( wantvec ) {
+        // 4. U = Q Ub(:,1:k), and the leading k rows of VTb
+        blasf77_zgemm( "NoTrans", "NoTrans", &m, &k, &l,
+                       &c_one,  Q, &m, Ub, &ldub,
+                       &c_zero, U, &ldu );
+        lapackf77_zlacpy( "F", &k, &n, VTb, &l, VT, &ldvt );
+    }
+
+cleanup:
+    magma_free_cpu( Q );
+    magma_free_cpu( B );
+    magma_free_cpu( Ub );
+    magma_free_cpu( VTb );
+    magma_free_cpu( work );
+    magma_free_cpu( sb );
+    magma_free_cpu( iwork );
+    #ifdef COMPLEX
+    magma_free_cpu( rwork );
+    #endif
+
+    return *info;
+} /* magma_zgesvd_rand */
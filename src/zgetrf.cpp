@@ -134,6 +134,9 @@ magma_zgetrf(
         lddat = maxn;
         ldda  = maxm;
         
+        /* CPU panels use the recursive version, if enabled */
+        magma_int_t nthread_panel = magma_get_panel_numthreads();
+        
         /* set number of GPUs */
         magma_int_t ngpu = magma_num_gpus();
         if ( ngpu > 1 ) {
@@ -209,7 +212,10 @@ magma_zgetrf(
             magmablas_ztranspose( m, n, dA(0,0), ldda, dAT(0,0), lddat, queues[0] );
         }
         
-        lapackf77_zgetrf( &m, &nb, work, &lda, ipiv, &iinfo );
+        if (nthread_panel > 0)
+            magma_zgetrf_rec_cpu( m, nb, work, lda, ipiv, nthread_panel, &iinfo );
+        else
+            lapackf77_zgetrf( &m, &nb, work, &lda, ipiv, &iinfo );
 
         for( j = 0; j < s; j++ ) {
             // get j-th panel from device
@@ -234,7 +240,10 @@ magma_zgetrf(
                 // do the cpu part
                 rows = m - j*nb;
                 magma_queue_sync( queues[1] );
-                lapackf77_zgetrf( &rows, &nb, work, &lda, ipiv+j*nb, &iinfo );
+                if (nthread_panel > 0)
+                    magma_zgetrf_rec_cpu( rows, nb, work, lda, ipiv+j*nb, nthread_panel, &iinfo );
+                else
+                    lapackf77_zgetrf( &rows, &nb, work, &lda, ipiv+j*nb, &iinfo );
             }
             if (*info == 0 && iinfo > 0)
                 *info = iinfo + j*nb;
@@ -286,7 +295,10 @@ magma_zgetrf(
             magma_queue_sync( queues[0] );
             
             // do the cpu part
-            lapackf77_zgetrf( &rows, &nb0, work, &lda, ipiv+s*nb, &iinfo );
+            if (nthread_panel > 0)
+                magma_zgetrf_rec_cpu( rows, nb0, work, lda, ipiv+s*nb, nthread_panel, &iinfo );
+            else
+                lapackf77_zgetrf( &rows, &nb0, work, &lda, ipiv+s*nb, &iinfo );
             if (*info == 0 && iinfo > 0)
                 *info = iinfo + s*nb;
             
@@ -0,0 +1,240 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+#include "magma_internal.h"
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZGETRF_OOC_CPU computes an LU factorization of a general M-by-N matrix A,
+    stored out-of-core in a file, so A may exceed the host memory,
+    using partial pivoting with row interchanges.
+
+    The factorization has the form
+        A = P * L * U
+    where P is a permutation matrix, L is lower triangular with unit
+    diagonal elements (lower trapezoidal if m > n), and U is upper
+    triangular (upper trapezoidal if m < n).
+
+    This is a left-looking algorithm on block columns (slabs), as wide as
+    the memory budget allows. Each slab is read into host memory, has the
+    previous row interchanges applied, is updated by all previous block
+    columns, which are read one NB-wide panel at a time, factored with
+    LAPACK zgetrf, and written back. Reading the next panel overlaps
+    updating with the current one. Previous block columns are not rewritten
+    as each slab is factored; instead, the later interchanges are applied to
+    each panel as it is read, and to the file in a final pass.
+
+    Arguments
+    ---------
+    @param[in,out]
+    A       Out-of-core M-by-N matrix of COMPLEX_16 elements,
+            created by magma_ooc_create, with tile size NB.
+            On entry, the M-by-N matrix to be factored.
+            On exit, the factors L and U from the factorization
+            A = P*L*U; the unit diagonal elements of L are not stored.
+
+    @param[out]
+    ipiv    INTEGER array, dimension (min(M,N))
+            The pivot indices; for 1 <= i <= min(M,N), row i of the
+            matrix was interchanged with row IPIV(i).
+
+    @param[in]
+    mem_budget  SIZE_T
+            Bytes of host memory to use for the slab and panel, in addition
+            to the tile cache of A.
+            MEM_BUDGET >= M*(min(NB,N) + NB)*sizeof(COMPLEX_16).
+            A larger budget gives wider slabs, so fewer reads of previous
+            block columns.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+                  or another error occured, such as memory allocation failed
+                  or a file error (MAGMA_ERR_FILESYSTEM).
+      -     > 0:  if INFO = i, U(i,i) is exactly zero. The factorization
+                  has been completed, but the factor U is exactly
+                  singular, and division by zero will occur if it is used
+                  to solve a system of equations.
+
+    @ingroup magma_getrf
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zgetrf_ooc_cpu(
+    magma_ooc_t A, magma_int_t *ipiv, size_t mem_budget,
+    magma_int_t *info )
+{
+    #define B(i_, j_) (B + (i_) + (j_)*ldb)
+    #define P(i_, j_) (P + (i_) + (j_)*ldp)
+
+    /* Constants */
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    const magma_int_t ione = 1;
+
+    /* Local variables */
+    magmaDoubleComplex *work, *B, *P;
+    magma_int_t *slab_end, *iwork;
+    magma_int_t m, n, nb, minmn, kend, j, jb, j1, k, kb, e, next, rows, i, i1, i2,
+                ldb, ldp, iinfo;
+    size_t elemsize, budget;
+
+    *info = 0;
+    if (A != NULL) {
+        magma_ooc_getsize( A, &m, &n, &nb, &elemsize );
+    }
+    budget = mem_budget / sizeof(magmaDoubleComplex);
+    if (A == NULL || elemsize != sizeof(magmaDoubleComplex)) {
+        *info = -1;
+    } else if (budget < size_t(m)*(min( nb, n ) + nb)) {
+        *info = -3;
+    }
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    /* Quick return */
+    minmn = min( m, n );
+    if (minmn == 0)
+        return *info;
+
+    // the largest slab, plus a panel, needs at most m*(n + nb)
+    budget = min( budget, size_t(m)*(n + nb) );
+    ldb = m;
+    if (MAGMA_SUCCESS != magma_zmalloc_cpu( &work, budget ) ||
+        MAGMA_SUCCESS != magma_imalloc_cpu( &iwork, minmn ) ||
+        MAGMA_SUCCESS != magma_imalloc_cpu( &slab_end, magma_ceildiv( minmn, nb ))) {
+        magma_free_cpu( work );
+        magma_free_cpu( iwork );
+        *info = MAGMA_ERR_HOST_ALLOC;
+        return *info;
+    }
+    B = work;
+
+    // widest slab that fits in the budget, in multiples of nb:
+    // m-by-jb slab + m-by-nb panel
+    jb = min( nb, n );
+    while (jb < n) {
+        next = min( jb + nb, n );
+        if (size_t(m)*(next + nb) > budget)
+            break;
+        jb = next;
+    }
+    P = work + size_t(ldb)*jb;
+
+    iinfo = 0;
+    for (j = 0; j < n && iinfo == 0; j += jb) {
+        //=========================================================
+        // slab A(0:m, j:j+jb)
+        jb = min( jb, n - j );
+        kend = min( j, minmn );
+        iinfo = magma_ooc_getmatrix( m, jb, A, 0, j, B, ldb );
+        if (iinfo != 0)
+            break;
+        if (kend > 0) {
+            magma_ooc_prefetch( m, nb, A, 0, 0 );
+            // apply previous interchanges to the slab
+            lapackf77_zlaswp( &jb, B, &ldb, &ione, &kend, ipiv, &ione );
+        }
+
+        for (k = 0; k < kend; k += nb) {
+            // panel A(k:m, k:k+kb); read ahead the next one
+            kb   = min( nb, kend - k );
+            rows = m - k;
+            ldp  = rows;
+            iinfo = magma_ooc_getmatrix( rows, kb, A, k, k, P, ldp );
+            if (iinfo != 0)
+                break;
+            if (k + kb < kend) {
+                magma_ooc_prefetch( rows - kb, nb, A, k + kb, k + kb );
+            }
+
+            // apply interchanges after this panel's slab, up to j, to the panel
+            e = slab_end[ k/nb ];
+            if (e < kend) {
+                for (i = e; i < kend; ++i) {
+                    iwork[ i - k ] = ipiv[i] - k;
+                }
+                i1 = e - k + 1;
+                i2 = kend - k;
+                lapackf77_zlaswp( &kb, P, &ldp, &i1, &i2, iwork, &ione );
+            }
+
+            // B(k:k+kb, :) = L(k,k)^{-1} B(k:k+kb, :)
+            blasf77_ztrsm( MagmaLeftStr, MagmaLowerStr, MagmaNoTransStr, MagmaUnitStr,
+                           &kb, &jb, &c_one, P(0, 0), &ldp, B(k, 0), &ldb );
+            // B(k+kb:m, :) -= L(k+kb:m, k:k+kb) B(k:k+kb, :)
+            if (rows > kb) {
+                magma_int_t mb = rows - kb;
+                blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &mb, &jb, &kb,
+                               &c_neg_one, P(kb, 0), &ldp,
+                                           B(k,  0), &ldb,
+                               &c_one,     B(k+kb, 0), &ldb );
+            }
+        }
+        if (iinfo != 0)
+            break;
+
+        // factor the slab below the diagonal
+        if (j < minmn) {
+            if (j + jb < n) {
+                magma_ooc_prefetch( m, nb, A, 0, j + jb );
+            }
+            rows = m - j;
+            lapackf77_zgetrf( &rows, &jb, B(j, 0), &ldb, ipiv + j, &iinfo );
+            if (iinfo > 0 && *info == 0) {
+                *info = iinfo + j;
+            }
+            j1 = min( j + jb, minmn );
+            for (i = j; i < j1; ++i) {
+                ipiv[i] += j;
+            }
+            for (k = j; k < j1; k += nb) {
+                slab_end[ k/nb ] = j1;
+            }
+        }
+        iinfo = magma_ooc_setmatrix( m, jb, B, ldb, A, 0, j );
+    }
+
+    //=========================================================
+    // apply later interchanges to L in each earlier slab,
+    // reading and writing the rows below the slab
+    for (k = 0; k < minmn && iinfo == 0; k = e) {
+        e = slab_end[ k/nb ];
+        if (e < minmn) {
+            rows = m - e;
+            kb   = e - k;
+            iinfo = magma_ooc_getmatrix( rows, kb, A, e, k, B, rows );
+            if (iinfo != 0)
+                break;
+            for (i = e; i < minmn; ++i) {
+                iwork[ i - e ] = ipiv[i] - e;
+            }
+            i2 = minmn - e;
+            lapackf77_zlaswp( &kb, B, &rows, &ione, &i2, iwork, &ione );
+            iinfo = magma_ooc_setmatrix( rows, kb, B, rows, A, e, k );
+        }
+    }
+
+    if (iinfo == 0) {
+        iinfo = magma_ooc_flush( A );
+    }
+    if (iinfo != 0) {
+        *info = iinfo;
+    }
+
+    magma_free_cpu( work );
+    magma_free_cpu( iwork );
+    magma_free_cpu( slab_end );
+
+    return *info;
+} /* magma_zgetrf_ooc_cpu */
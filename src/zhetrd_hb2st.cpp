@@ -686,7 +686,7 @@ static void magma_ztile_bulge_computeT_parallel(
     magma_int_t Vm, Vn, mt, nt;
     magma_int_t myrow, mycol, blkj, blki, firstrow;
     magma_int_t blkid, vpos, taupos, tpos;
-    magma_int_t blkpercore, myid;
+    magma_int_t blkpercore, myid, info;
 
     if (n <= 0)
         return;
@@ -737,7 +737,7 @@ static void magma_ztile_bulge_computeT_parallel(
             myid = blkid/blkpercore;
             if ( my_core_id == (myid%cores_num) ) {
                 if ( ( Vm > 0 ) && ( Vn > 0 ) ) {
-                    lapackf77_zlarft( "F", "C", &Vm, &Vn, V(vpos), &ldv, TAU(taupos), T(tpos), &ldt);
+                    magma_zlarft_cpu( MagmaForward, MagmaColumnwise, Vm, Vn, V(vpos), ldv, TAU(taupos), T(tpos), ldt, &info );
                 }
             }
         }
@@ -156,7 +156,7 @@ magma_zhetrf_nopiv(
             // factorize the diagonal block
             magma_queue_sync(queues[1]);
             trace_cpu_start( 0, "potrf", "potrf" );
-            magma_zhetrf_nopiv_cpu( MagmaUpper, jb, ib, A(j, j), lda, info );
+            magma_zhetrf_nopiv_rec_cpu( MagmaUpper, jb, ib, A(j, j), lda, info );
             trace_cpu_end( 0 );
             if (*info != 0) {
                 *info = *info + j;
@@ -233,7 +233,7 @@ magma_zhetrf_nopiv(
             // factorize the diagonal block
             magma_queue_sync(queues[1]);
             trace_cpu_start( 0, "potrf", "potrf" );
-            magma_zhetrf_nopiv_cpu( MagmaLower, jb, ib, A(j, j), lda, info );
+            magma_zhetrf_nopiv_rec_cpu( MagmaLower, jb, ib, A(j, j), lda, info );
             trace_cpu_end( 0 );
             if (*info != 0) {
                 *info = *info + j;
@@ -0,0 +1,427 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+       Recursive, multithreaded LDL^H and LDL^T factorizations without
+       pivoting on the CPU. See magma_zhetrf_nopiv_cpu for the
+       original blocked version.
+*/
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "magma_internal.h"
+
+#define COMPLEX
+
+#define A(i_, j_)  (A + (i_) + (j_)*lda)
+#define W(i_, j_)  (W + (i_) + (j_)*ldw)
+
+// tile size for parallel trsm and trailing matrix updates
+static const magma_int_t tile_nb = 256;
+
+
+/******************************************************************************/
+// Unblocked right-looking factorization of the n-by-n matrix A, for small n.
+// Each rank-1 update is a sequence of unit-stride axpys down the columns,
+// which the compiler can vectorize. Computes LDL^H if herm, else LDL^T.
+// For upper, work holds a contiguous copy of the current row of U, size n.
+// Returns 0, or i if the i-th pivot (1-based) is below eps.
+static magma_int_t zhetrf_nopiv_rec_kernel(
+    magma_uplo_t uplo, bool herm, magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magmaDoubleComplex *work )
+{
+    const double eps = lapackf77_dlamch("Epsilon");
+
+    for (magma_int_t k = 0; k < n; ++k) {
+        magmaDoubleComplex d = *A(k, k);
+        if (herm) {
+            d = MAGMA_Z_MAKE( MAGMA_Z_REAL( d ), 0 );
+        }
+        if ( MAGMA_Z_ABS( d ) < eps ) {
+            return k+1;
+        }
+        *A(k, k) = d;
+        magmaDoubleComplex dinv = MAGMA_Z_DIV( MAGMA_Z_ONE, d );
+
+        if (uplo == MagmaLower) {
+            // l = A(k+1:n, k) / d,  A(j:n, j) -= l(j:n) * d * l_j^H  for j > k
+            magmaDoubleComplex *l = A(0, k);
+            for (magma_int_t i = k+1; i < n; ++i) {
+                l[i] *= dinv;
+            }
+            for (magma_int_t j = k+1; j < n; ++j) {
+                magmaDoubleComplex alpha = d * (herm ? conj( l[j] ) : l[j]);
+                magmaDoubleComplex *a = A(0, j);
+                #pragma omp simd
+                for (magma_int_t i = j; i < n; ++i) {
+                    a[i] -= l[i] * alpha;
+                }
+            }
+        }
+        else {
+            // u = A(k, k+1:n) / d,  A(k+1:j, j) -= u(k+1:j)^H * d * u_j  for j > k
+            magmaDoubleComplex *u = work - (k+1);  // u[i] is column i
+            for (magma_int_t i = k+1; i < n; ++i) {
+                *A(k, i) *= dinv;
+                u[i] = (herm ? conj( *A(k, i) ) : *A(k, i));
+            }
+            for (magma_int_t j = k+1; j < n; ++j) {
+                magmaDoubleComplex alpha = d * (*A(k, j));
+                magmaDoubleComplex *a = A(0, j);
+                #pragma omp simd
+                for (magma_int_t i = k+1; i <= j; ++i) {
+                    a[i] -= u[i] * alpha;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+
+/******************************************************************************/
+// Diagonal tile of the trailing update, C -= X Y^H (lower) or X^H Y (upper),
+// for a k-inner-dimension product. Only the uplo triangle of C is updated;
+// the product is formed in the b-by-b workspace T, then subtracted.
+static void zhetrf_nopiv_rec_diag_update(
+    magma_uplo_t uplo, const char* trans, magma_int_t b, magma_int_t k,
+    const magmaDoubleComplex *X, magma_int_t ldx,
+    const magmaDoubleComplex *Y, magma_int_t ldy,
+    magmaDoubleComplex *C, magma_int_t ldc,
+    magmaDoubleComplex *T )
+{
+    const magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+
+    if (uplo == MagmaLower) {
+        blasf77_zgemm( MagmaNoTransStr, trans, &b, &b, &k,
+                       &c_one,  X, &ldx, Y, &ldy,
+                       &c_zero, T, &b );
+        for (magma_int_t j = 0; j < b; ++j) {
+            #pragma omp simd
+            for (magma_int_t i = j; i < b; ++i) {
+                C[ i + j*ldc ] -= T[ i + j*b ];
+            }
+        }
+    }
+    else {
+        blasf77_zgemm( trans, MagmaNoTransStr, &b, &b, &k,
+                       &c_one,  X, &ldx, Y, &ldy,
+                       &c_zero, T, &b );
+        for (magma_int_t j = 0; j < b; ++j) {
+            #pragma omp simd
+            for (magma_int_t i = 0; i <= j; ++i) {
+                C[ i + j*ldc ] -= T[ i + j*b ];
+            }
+        }
+    }
+}
+
+
+/******************************************************************************/
+// Recursive factorization. Splits A = [ A11 A12; A21 A22 ] with A11 of size
+// n1, a multiple of nb. After factoring A11 and solving for the off-diagonal
+// block, the trailing update (GEMM-based, replacing zherk_d) is the bulk of
+// the flops; it and the triangular solve are split into tiles that run as
+// OpenMP tasks. The D scaling is fused into one pass that both saves
+// W = L21 D1 (or D1 U12) and scales the block to L21 (or U12).
+// Must be called from within an OpenMP single region, or serially.
+static magma_int_t zhetrf_nopiv_rec(
+    magma_uplo_t uplo, bool herm, magma_int_t n, magma_int_t nb,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magmaDoubleComplex *W, magma_int_t ldw,
+    magmaDoubleComplex *T )
+{
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    const char* trans = (herm ? MagmaConjTransStr : MagmaTransStr);
+
+    if (n <= nb) {
+        return zhetrf_nopiv_rec_kernel( uplo, herm, n, A, lda, W );
+    }
+
+    magma_int_t n1 = max( nb, (n/2) / nb * nb );
+    magma_int_t n2 = n - n1;
+    magma_int_t info;
+
+    info = zhetrf_nopiv_rec( uplo, herm, n1, nb, A, lda, W, ldw, T );
+    if (info != 0) {
+        return info;
+    }
+
+    if (uplo == MagmaLower) {
+        // A21 = L21 D1 = A21 L11^{-H};  W = L21 D1;  A21 = L21
+        for (magma_int_t i = 0; i < n2; i += tile_nb) {
+            #pragma omp task
+            {
+                magma_int_t ib = min( tile_nb, n2 - i );
+                blasf77_ztrsm( MagmaRightStr, MagmaLowerStr, trans, MagmaUnitStr,
+                               &ib, &n1,
+                               &c_one, A(0, 0),    &lda,
+                                       A(n1+i, 0), &lda );
+                for (magma_int_t k = 0; k < n1; ++k) {
+                    magmaDoubleComplex dinv = MAGMA_Z_DIV( c_one, *A(k, k) );
+                    magmaDoubleComplex *a = A(n1+i, k);
+                    magmaDoubleComplex *w = W(i, k);
+                    #pragma omp simd
+                    for (magma_int_t r = 0; r < ib; ++r) {
+                        w[r] = a[r];
+                        a[r] *= dinv;
+                    }
+                }
+            }
+        }
+        #pragma omp taskwait
+
+        // A22 -= L21 W^H, lower triangle
+        for (magma_int_t j = 0; j < n2; j += tile_nb) {
+            for (magma_int_t i = j; i < n2; i += tile_nb) {
+                #pragma omp task
+                {
+                    magma_int_t ib = min( tile_nb, n2 - i );
+                    magma_int_t jb = min( tile_nb, n2 - j );
+                    if (i == j) {
+                        zhetrf_nopiv_rec_diag_update(
+                            uplo, trans, jb, n1,
+                            A(n1+i, 0), lda, W(j, 0), ldw,
+                            A(n1+i, n1+j), lda, T + j*tile_nb );
+                    }
+                    else {
+                        blasf77_zgemm( MagmaNoTransStr, trans, &ib, &jb, &n1,
+                                       &c_neg_one, A(n1+i, 0),     &lda,
+                                                   W(j, 0),        &ldw,
+                                       &c_one,     A(n1+i, n1+j),  &lda );
+                    }
+                }
+            }
+        }
+        #pragma omp taskwait
+    }
+    else {
+        // A12 = D1 U12 = U11^{-H} A12;  W = D1 U12;  A12 = U12
+        for (magma_int_t j = 0; j < n2; j += tile_nb) {
+            #pragma omp task
+            {
+                magma_int_t jb = min( tile_nb, n2 - j );
+                blasf77_ztrsm( MagmaLeftStr, MagmaUpperStr, trans, MagmaUnitStr,
+                               &n1, &jb,
+                               &c_one, A(0, 0),    &lda,
+                                       A(0, n1+j), &lda );
+                for (magma_int_t c = 0; c < jb; ++c) {
+                    magmaDoubleComplex *a = A(0, n1+j+c);
+                    magmaDoubleComplex *w = W(0, j+c);
+                    for (magma_int_t k = 0; k < n1; ++k) {
+                        w[k] = a[k];
+                        a[k] = MAGMA_Z_DIV( a[k], *A(k, k) );
+                    }
+                }
+            }
+        }
+        #pragma omp taskwait
+
+        // A22 -= U12^H W, upper triangle
+        for (magma_int_t j = 0; j < n2; j += tile_nb) {
+            for (magma_int_t i = 0; i <= j; i += tile_nb) {
+                #pragma omp task
+                {
+                    magma_int_t ib = min( tile_nb, n2 - i );
+                    magma_int_t jb = min( tile_nb, n2 - j );
+                    if (i == j) {
+                        zhetrf_nopiv_rec_diag_update(
+                            uplo, trans, jb, n1,
+                            A(0, n1+i), lda, W(0, j), ldw,
+                            A(n1+i, n1+j), lda, T + j*tile_nb );
+                    }
+                    else {
+                        blasf77_zgemm( trans, MagmaNoTransStr, &ib, &jb, &n1,
+                                       &c_neg_one, A(0, n1+i),     &lda,
+                                                   W(0, j),        &ldw,
+                                       &c_one,     A(n1+i, n1+j),  &lda );
+                    }
+                }
+            }
+        }
+        #pragma omp taskwait
+    }
+
+    info = zhetrf_nopiv_rec( uplo, herm, n2, nb, A(n1, n1), lda, W, ldw, T );
+    if (info != 0) {
+        info += n1;
+    }
+    return info;
+}
+
+
+/******************************************************************************/
+// Allocates workspace, sets up the OpenMP team, and calls zhetrf_nopiv_rec.
+static magma_int_t zhetrf_nopiv_rec_driver(
+    magma_uplo_t uplo, bool herm, magma_int_t n, magma_int_t nb,
+    magmaDoubleComplex *A, magma_int_t lda )
+{
+    if (nb <= 0) {
+        nb = 32;
+    }
+
+    // W holds the n2-by-n1 (lower) or n1-by-n2 (upper) off-diagonal block
+    // of the top level, n1 <= max( n/2, nb ); T holds one tile per diagonal tile.
+    magma_int_t half  = max( n/2, nb );
+    magma_int_t ldw   = (uplo == MagmaLower ? n : half);
+    magma_int_t lwork = n * half;
+    magmaDoubleComplex *W, *T;
+    if (MAGMA_SUCCESS != magma_zmalloc_cpu( &W, lwork )) {
+        return MAGMA_ERR_HOST_ALLOC;
+    }
+    if (MAGMA_SUCCESS != magma_zmalloc_cpu( &T, tile_nb * max( n, 1 ) )) {
+        magma_free_cpu( W );
+        return MAGMA_ERR_HOST_ALLOC;
+    }
+
+    // tasks call single-threaded BLAS
+    magma_int_t info = 0;
+    magma_int_t lapack_nthread = magma_get_lapack_numthreads();
+    magma_set_lapack_numthreads( 1 );
+    #pragma omp parallel
+    #pragma omp single
+    {
+        info = zhetrf_nopiv_rec( uplo, herm, n, nb, A, lda, W, ldw, T );
+    }
+    magma_set_lapack_numthreads( lapack_nthread );
+
+    magma_free_cpu( W );
+    magma_free_cpu( T );
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZHETRF_NOPIV_REC_CPU computes the LDL^H factorization of a complex
+    Hermitian matrix A without pivoting, on the CPU:
+        A = U^H * D * U,  if UPLO = MagmaUpper, or
+        A = L  * D * L^H, if UPLO = MagmaLower,
+    where U (L) is unit upper (lower) triangular and D is real diagonal.
+
+    It is a drop-in replacement for magma_zhetrf_nopiv_cpu. The algorithm is
+    recursive, splitting the matrix in halves down to blocks of size ib,
+    which are factored by an unblocked kernel. The off-diagonal solve and the
+    GEMM-based trailing updates are split into tiles, which run as OpenMP
+    tasks using single-threaded BLAS. Unlike magma_zhetrf_nopiv_cpu, the
+    strictly upper (lower) triangle of A is not referenced.
+
+    Without pivoting, the factorization is stable only for matrices such as
+    diagonally dominant ones; it stops at the first pivot below eps.
+
+    Arguments
+    ---------
+    @param[in]
+    uplo    magma_uplo_t
+      -     = MagmaUpper:  Upper triangle of A is stored;
+      -     = MagmaLower:  Lower triangle of A is stored.
+
+    @param[in]
+    n       INTEGER
+            The order of the matrix A.  N >= 0.
+
+    @param[in]
+    ib      INTEGER
+            Block size of the unblocked kernel. If ib <= 0, uses 32.
+
+    @param[in,out]
+    A       COMPLEX_16 array, dimension (LDA,N)
+            On entry, the Hermitian matrix A.
+            On exit, the factor U or L and D, with D on the diagonal
+            and the unit diagonal of U or L not stored.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A.  LDA >= max(1,N).
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value,
+                  or another error occured, such as memory allocation failed.
+      -     > 0:  if INFO = i, D(i,i) is below eps; the factorization
+                  was not completed.
+
+    @ingroup magma_hetrf_comp
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zhetrf_nopiv_rec_cpu(
+    magma_uplo_t uplo, magma_int_t n, magma_int_t ib,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magma_int_t *info)
+{
+    *info = 0;
+    if (uplo != MagmaUpper && uplo != MagmaLower) {
+        *info = -1;
+    } else if (n < 0) {
+        *info = -2;
+    } else if (lda < max(1,n)) {
+        *info = -5;
+    }
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    if (n == 0) {
+        return *info;
+    }
+
+    *info = zhetrf_nopiv_rec_driver( uplo, true, n, ib, A, lda );
+    return *info;
+}
+
+
+#ifdef COMPLEX
+/***************************************************************************//**
+    Purpose
+    -------
+    ZSYTRF_NOPIV_REC_CPU computes the LDL^T factorization of a complex
+    symmetric matrix A without pivoting, on the CPU:
+        A = U^T * D * U,  if UPLO = MagmaUpper, or
+        A = L  * D * L^T, if UPLO = MagmaLower,
+    where U (L) is unit upper (lower) triangular and D is complex diagonal.
+
+    It is a drop-in replacement for magma_zsytrf_nopiv_cpu, using the same
+    recursive, task-parallel algorithm as magma_zhetrf_nopiv_rec_cpu.
+    Arguments are as in magma_zhetrf_nopiv_rec_cpu.
+
+    @ingroup magma_sytrf_comp
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zsytrf_nopiv_rec_cpu(
+    magma_uplo_t uplo, magma_int_t n, magma_int_t ib,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magma_int_t *info)
+{
+    *info = 0;
+    if (uplo != MagmaUpper && uplo != MagmaLower) {
+        *info = -1;
+    } else if (n < 0) {
+        *info = -2;
+    } else if (lda < max(1,n)) {
+        *info = -5;
+    }
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    if (n == 0) {
+        return *info;
+    }
+
+    *info = zhetrf_nopiv_rec_driver( uplo, false, n, ib, A, lda );
+    return *info;
+}
+#endif // COMPLEX
@@ -0,0 +1,923 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+       Multishift Hessenberg QR with aggressive early deflation on the host.
+       The iteration follows LAPACK zlaqr0; the QR sweeps chase a chain of
+       tightly coupled 3x3 bulges through a window of the Hessenberg matrix,
+       accumulating the reflectors in a small unitary matrix U, and apply U
+       to the rest of H and to Z with threaded, blocked matrix products.
+*/
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(MAGMA_WITH_MKL)
+#include <mkl_service.h>
+#endif
+
+#include "magma_internal.h"
+
+#define COMPLEX
+
+#define H(i_, j_)  (H + (i_) + (j_)*ldh)
+#define Z(i_, j_)  (Z + (i_) + (j_)*ldz)
+#define U(i_, j_)  (U + (i_) + (j_)*ldu)
+
+// Active blocks smaller than this are left to LAPACK zhseqr (LAPACK's NMIN)
+static const magma_int_t hseqr_nmin = 75;
+
+// Skip a QR sweep if AED deflated more than nibble percent of the window
+static const magma_int_t hseqr_nibble = 14;
+
+// Exceptional deflation window and shifts after this many iterations
+// without deflation
+static const magma_int_t hseqr_kexnw = 5;
+static const magma_int_t hseqr_kexsh = 6;
+
+// Tile size of the threaded off-diagonal updates
+static const magma_int_t hseqr_tile = 128;
+
+
+/******************************************************************************/
+// Number of simultaneous shifts for an active block of order nh,
+// as in LAPACK iparmq.
+static magma_int_t zhseqr_num_shifts( magma_int_t nh )
+{
+    magma_int_t ns = 2;
+    if (nh >= 30)
+        ns = 4;
+    if (nh >= 60)
+        ns = 10;
+    if (nh >= 150)
+        ns = max( 10, nh / magma_int_t( log( double(nh) ) / log( 2. ) + 0.5 ));
+    if (nh >= 590)
+        ns = 64;
+    if (nh >= 3000)
+        ns = 128;
+    if (nh >= 6000)
+        ns = 256;
+    return max( 2, ns - ns % 2 );
+}
+
+
+/******************************************************************************/
+// Chase steps per window of a sweep with nbmps bulges; the window is then
+// about twice as long as the chain of bulges.
+static magma_int_t zhseqr_window_steps( magma_int_t nbmps )
+{
+    return 3*nbmps + 12;
+}
+
+
+/******************************************************************************/
+// Applies the reflector I - tau v v^H, with v = [ 1, v1, v2 ] (nr = 3) or
+// [ 1, v1 ] (nr = 2), from the left to the nr rows starting at A, ncol columns.
+static void zhseqr_reflect_left(
+    magma_int_t nr, magmaDoubleComplex tau,
+    magmaDoubleComplex v1, magmaDoubleComplex v2,
+    magmaDoubleComplex *A, magma_int_t lda, magma_int_t ncol )
+{
+    magmaDoubleComplex sum;
+    magmaDoubleComplex ctau = MAGMA_Z_CONJ( tau );
+    magmaDoubleComplex cv1  = MAGMA_Z_CONJ( v1 );
+    magmaDoubleComplex cv2  = MAGMA_Z_CONJ( v2 );
+    if (nr == 3) {
+        for (magma_int_t j = 0; j < ncol; ++j) {
+            magmaDoubleComplex *a = A + j*lda;
+            sum = ctau * (a[0] + cv1*a[1] + cv2*a[2]);
+            a[0] -= sum;
+            a[1] -= sum*v1;
+            a[2] -= sum*v2;
+        }
+    }
+    else {
+        for (magma_int_t j = 0; j < ncol; ++j) {
+            magmaDoubleComplex *a = A + j*lda;
+            sum = ctau * (a[0] + cv1*a[1]);
+            a[0] -= sum;
+            a[1] -= sum*v1;
+        }
+    }
+}
+
+
+/******************************************************************************/
+// Applies the same reflector from the right to the nr columns starting at A,
+// nrow rows.
+static void zhseqr_reflect_right(
+    magma_int_t nr, magmaDoubleComplex tau,
+    magmaDoubleComplex v1, magmaDoubleComplex v2,
+    magmaDoubleComplex *A, magma_int_t lda, magma_int_t nrow )
+{
+    magmaDoubleComplex sum;
+    magmaDoubleComplex cv1 = MAGMA_Z_CONJ( v1 );
+    magmaDoubleComplex cv2 = MAGMA_Z_CONJ( v2 );
+    magmaDoubleComplex *a0 = A;
+    magmaDoubleComplex *a1 = A + lda;
+    magmaDoubleComplex *a2 = A + 2*lda;
+    if (nr == 3) {
+        for (magma_int_t i = 0; i < nrow; ++i) {
+            sum = tau * (a0[i] + v1*a1[i] + v2*a2[i]);
+            a0[i] -= sum;
+            a1[i] -= sum*cv1;
+            a2[i] -= sum*cv2;
+        }
+    }
+    else {
+        for (magma_int_t i = 0; i < nrow; ++i) {
+            sum = tau * (a0[i] + v1*a1[i]);
+            a0[i] -= sum;
+            a1[i] -= sum*cv1;
+        }
+    }
+}
+
+
+/******************************************************************************/
+// Inside a parallel region, each thread calls sequential BLAS on its tiles.
+// MKL is told so per thread; OpenMP builds of other BLAS libraries already
+// do not nest.
+static int zhseqr_blas_local_begin()
+{
+    #if defined(MAGMA_WITH_MKL)
+    return mkl_set_num_threads_local( 1 );
+    #else
+    return 0;
+    #endif
+}
+
+static void zhseqr_blas_local_end( int saved )
+{
+    #if defined(MAGMA_WITH_MKL)
+    mkl_set_num_threads_local( saved );
+    #endif
+}
+
+
+/******************************************************************************/
+// Applies the accumulated reflectors U of window [wstart, wstart+nwin) to
+// the parts of H and Z outside the window: U^H from the left to the columns
+// right of the window, U from the right to the rows above it and to Z.
+// The three products are cut into tiles of hseqr_tile rows or columns,
+// which the threads update independently.
+static void zhseqr_window_update(
+    bool wantt, bool wantz, magma_int_t n, magma_int_t ktop, magma_int_t kbot,
+    magma_int_t wstart, magma_int_t nwin,
+    magmaDoubleComplex *H, magma_int_t ldh,
+    magma_int_t iloz, magma_int_t ihiz,
+    magmaDoubleComplex *Z, magma_int_t ldz,
+    const magmaDoubleComplex *U, magma_int_t ldu,
+    magmaDoubleComplex *work, magma_int_t nthread )
+{
+    const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    const magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    const magma_int_t nb = hseqr_tile;
+
+    magma_int_t wend = wstart + nwin;
+    magma_int_t cend = (wantt ? n : kbot+1);
+    magma_int_t rtop = (wantt ? 0 : ktop);
+    magma_int_t ncol = cend - wend;
+    magma_int_t nrow = wstart - rtop;
+    magma_int_t nz   = (wantz ? ihiz - iloz + 1 : 0);
+
+    magma_int_t ntile_c = magma_ceildiv( ncol, nb );
+    magma_int_t ntile_r = magma_ceildiv( nrow, nb );
+    magma_int_t ntile_z = magma_ceildiv( nz,   nb );
+    magma_int_t ntile   = ntile_c + ntile_r + ntile_z;
+    magma_int_t nt      = max( 1, min( nthread, ntile ));
+
+    #pragma omp parallel num_threads( nt )
+    {
+        magma_int_t tid = 0;
+        #ifdef _OPENMP
+        tid = omp_get_thread_num();
+        #endif
+        magmaDoubleComplex *W = work + tid*ldu*nb;
+        int saved = zhseqr_blas_local_begin();
+
+        #pragma omp for schedule(dynamic)
+        for (magma_int_t it = 0; it < ntile; ++it) {
+            if (it < ntile_c) {
+                // H(window, j0:j0+jb) = U^H H(window, j0:j0+jb)
+                magma_int_t j0 = wend + it*nb;
+                magma_int_t jb = min( nb, cend - j0 );
+                blasf77_zgemm( MagmaConjTransStr, MagmaNoTransStr, &nwin, &jb, &nwin,
+                               &c_one,  U, &ldu,
+                                        H(wstart, j0), &ldh,
+                               &c_zero, W, &nwin );
+                lapackf77_zlacpy( "A", &nwin, &jb, W, &nwin, H(wstart, j0), &ldh );
+            }
+            else if (it < ntile_c + ntile_r) {
+                // H(i0:i0+ib, window) = H(i0:i0+ib, window) U
+                magma_int_t i0 = rtop + (it - ntile_c)*nb;
+                magma_int_t ib = min( nb, wstart - i0 );
+                blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &ib, &nwin, &nwin,
+                               &c_one,  H(i0, wstart), &ldh,
+                                        U, &ldu,
+                               &c_zero, W, &ib );
+                lapackf77_zlacpy( "A", &ib, &nwin, W, &ib, H(i0, wstart), &ldh );
+            }
+            else {
+                // Z(i0:i0+ib, window) = Z(i0:i0+ib, window) U
+                magma_int_t i0 = iloz + (it - ntile_c - ntile_r)*nb;
+                magma_int_t ib = min( nb, ihiz + 1 - i0 );
+                blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &ib, &nwin, &nwin,
+                               &c_one,  Z(i0, wstart), &ldz,
+                                        U, &ldu,
+                               &c_zero, W, &ib );
+                lapackf77_zlacpy( "A", &ib, &nwin, W, &ib, Z(i0, wstart), &ldz );
+            }
+        }
+
+        zhseqr_blas_local_end( saved );
+    }
+}
+
+
+/******************************************************************************/
+// One multishift QR sweep on the active block H(ktop:kbot, ktop:kbot),
+// 0-based, with the ns (even) shifts s, as LAPACK zlaqr5 does.
+//
+// The ns/2 bulges form a chain three columns apart: at chase step t,
+// bulge j is at column k = ktop - 1 + t - 3j (k = ktop-1 introduces it),
+// and the bulges are moved one column each step, the deepest first.
+// The steps are grouped in windows. Within a window, the reflectors are
+// applied only to H(wstart:wend, wstart:wend), the part the chain moves
+// through, and accumulated in U; zhseqr_window_update then applies U to
+// the rest of H and Z with matrix products.
+// After each step, subdiagonals behind the bulges are checked for
+// negligibility (vigilant deflation, Ahues and Tisseur).
+static void zhseqr_sweep(
+    bool wantt, bool wantz, magma_int_t n, magma_int_t ktop, magma_int_t kbot,
+    magma_int_t ns,
+    #ifdef COMPLEX
+    const magmaDoubleComplex *s,
+    #else
+    const double *sr, const double *si,
+    #endif
+    magmaDoubleComplex *H, magma_int_t ldh,
+    magma_int_t iloz, magma_int_t ihiz,
+    magmaDoubleComplex *Z, magma_int_t ldz,
+    magmaDoubleComplex *U, magma_int_t ldu,
+    magmaDoubleComplex *work, magma_int_t nthread )
+{
+    const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    const magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    const magma_int_t ione   = 1;
+    const magma_int_t ithree = 3;
+
+    magmaDoubleComplex v[3], vt[3], alpha, beta, tau, refsum;
+    magmaDoubleComplex h00, h10, h01, h11;
+    double tst1, tst2, h12a, h21a, h11a, h22a, scl;
+
+    double safmin = lapackf77_dlamch( "Safe minimum" );
+    double ulp    = lapackf77_dlamch( "Precision" );
+    double smlnum = safmin * ( double(kbot - ktop + 1) / ulp );
+
+    magma_int_t nbmps = ns / 2;
+    magma_int_t nstep = zhseqr_window_steps( nbmps );
+    // last step: the top bulge reaches column kbot-2
+    magma_int_t tmax  = kbot - ktop - 1 + 3*(nbmps - 1);
+
+    for (magma_int_t t0 = 0; t0 <= tmax; t0 += nstep) {
+        magma_int_t t1   = min( tmax + 1, t0 + nstep );
+        magma_int_t kmin = max( ktop - 1, ktop - 1 + t0 - 3*(nbmps - 1) );
+        magma_int_t kmax = min( kbot - 2, ktop - 1 + t1 - 1 );
+        magma_int_t wstart = max( ktop, kmin );
+        magma_int_t wend   = min( kbot + 1, kmax + 5 );
+        magma_int_t nwin   = wend - wstart;
+
+        lapackf77_zlaset( "A", &nwin, &nwin, &c_zero, &c_one, U, &ldu );
+
+        for (magma_int_t t = t0; t < t1; ++t) {
+            for (magma_int_t j = 0; j < nbmps; ++j) {
+                magma_int_t k = ktop - 1 + t - 3*j;
+                if (k > kbot - 2)
+                    continue;  // bulge j has left the block
+                if (k < ktop - 1)
+                    break;     // bulges j and above are not introduced yet
+                magma_int_t nr = min( 3, kbot - k );
+
+                if (k == ktop - 1) {
+                    // introduce bulge j from the first column of
+                    // (H - s_{2j} I)(H - s_{2j+1} I)
+                    #ifdef COMPLEX
+                    lapackf77_zlaqr1( &ithree, H(ktop, ktop), &ldh,
+                                      &s[2*j], &s[2*j+1], v );
+                    #else
+                    lapackf77_zlaqr1( &ithree, H(ktop, ktop), &ldh,
+                                      &sr[2*j], &si[2*j], &sr[2*j+1], &si[2*j+1], v );
+                    #endif
+                    alpha = v[0];
+                    lapackf77_zlarfg( &ithree, &alpha, &v[1], &ione, &tau );
+                }
+                else {
+                    // chase bulge j one column down
+                    beta = *H(k+1, k);
+                    v[1] = *H(k+2, k);
+                    v[2] = (nr == 3 ? *H(k+3, k) : c_zero);
+                    lapackf77_zlarfg( &nr, &beta, &v[1], &ione, &tau );
+
+                    if (nr == 3 &&
+                        MAGMA_Z_EQUAL( *H(k+3, k),   c_zero ) &&
+                        MAGMA_Z_EQUAL( *H(k+3, k+1), c_zero ) &&
+                        ! MAGMA_Z_EQUAL( *H(k+3, k+2), c_zero ))
+                    {
+                        // The bulge has collapsed, by vigilant deflation or
+                        // underflow. Start a fresh one here if that
+                        // creates only negligible fill in column k.
+                        #ifdef COMPLEX
+                        lapackf77_zlaqr1( &ithree, H(k+1, k+1), &ldh,
+                                          &s[2*j], &s[2*j+1], vt );
+                        #else
+                        lapackf77_zlaqr1( &ithree, H(k+1, k+1), &ldh,
+                                          &sr[2*j], &si[2*j], &sr[2*j+1], &si[2*j+1], vt );
+                        #endif
+                        alpha = vt[0];
+                        lapackf77_zlarfg( &ithree, &alpha, &vt[1], &ione, &vt[0] );
+                        refsum = MAGMA_Z_CONJ( vt[0] )
+                               * (*H(k+1, k) + MAGMA_Z_CONJ( vt[1] ) * *H(k+2, k));
+                        if (MAGMA_Z_ABS1( *H(k+2, k) - refsum*vt[1] )
+                            + MAGMA_Z_ABS1( refsum*vt[2] )
+                            <= ulp*( MAGMA_Z_ABS1( *H(k,   k  ) )
+                                   + MAGMA_Z_ABS1( *H(k+1, k+1) )
+                                   + MAGMA_Z_ABS1( *H(k+2, k+2) )))
+                        {
+                            beta = *H(k+1, k) - refsum;
+                            tau  = vt[0];
+                            v[1] = vt[1];
+                            v[2] = vt[2];
+                        }
+                    }
+                    *H(k+1, k) = beta;
+                    *H(k+2, k) = c_zero;
+                    if (nr == 3) {
+                        *H(k+3, k) = c_zero;
+                    }
+                }
+
+                // H = P^H H P within the window, U = U P
+                zhseqr_reflect_left( nr, tau, v[1], v[2], H(k+1, k+1), ldh, wend - (k+1) );
+                zhseqr_reflect_right( nr, tau, v[1], v[2], H(wstart, k+1), ldh,
+                                      min( kbot, k + 4 ) + 1 - wstart );
+                zhseqr_reflect_right( nr, tau, v[1], v[2], U(0, k+1-wstart), ldu, nwin );
+            }
+
+            // vigilant deflation behind each bulge moved in this step
+            for (magma_int_t j = 0; j < nbmps; ++j) {
+                magma_int_t k = ktop - 1 + t - 3*j;
+                if (k > kbot - 2)
+                    continue;
+                if (k < ktop)
+                    break;
+                if (MAGMA_Z_EQUAL( *H(k+1, k), c_zero ))
+                    continue;
+                tst1 = MAGMA_Z_ABS1( *H(k, k) ) + MAGMA_Z_ABS1( *H(k+1, k+1) );
+                if (tst1 == 0) {
+                    if (k >= ktop + 1) tst1 += MAGMA_Z_ABS1( *H(k, k-1) );
+                    if (k >= ktop + 2) tst1 += MAGMA_Z_ABS1( *H(k, k-2) );
+                    if (k >= ktop + 3) tst1 += MAGMA_Z_ABS1( *H(k, k-3) );
+                    if (k <= kbot - 2) tst1 += MAGMA_Z_ABS1( *H(k+2, k+1) );
+                    if (k <= kbot - 3) tst1 += MAGMA_Z_ABS1( *H(k+3, k+1) );
+                    if (k <= kbot - 4) tst1 += MAGMA_Z_ABS1( *H(k+4, k+1) );
+                }
+                if (MAGMA_Z_ABS1( *H(k+1, k) ) <= max( smlnum, ulp*tst1 )) {
+                    h00 = *H(k,   k  );
+                    h10 = *H(k+1, k  );
+                    h01 = *H(k,   k+1);
+                    h11 = *H(k+1, k+1);
+                    h12a = max( MAGMA_Z_ABS1( h10 ), MAGMA_Z_ABS1( h01 ));
+                    h21a = min( MAGMA_Z_ABS1( h10 ), MAGMA_Z_ABS1( h01 ));
+                    h11a = max( MAGMA_Z_ABS1( h11 ), MAGMA_Z_ABS1( h00 - h11 ));
+                    h22a = min( MAGMA_Z_ABS1( h11 ), MAGMA_Z_ABS1( h00 - h11 ));
+                    scl  = h11a + h12a;
+                    tst2 = h22a*(h11a/scl);
+                    if (tst2 == 0 || h21a*(h12a/scl) <= max( smlnum, ulp*tst2 )) {
+                        *H(k+1, k) = c_zero;
+                    }
+                }
+            }
+        }
+
+        zhseqr_window_update( wantt, wantz, n, ktop, kbot, wstart, nwin,
+                              H, ldh, iloz, ihiz, Z, ldz, U, ldu, work, nthread );
+    }
+}
+
+
+#ifdef COMPLEX
+/******************************************************************************/
+// Principal square root of a complex number.
+static magmaDoubleComplex zhseqr_sqrt( magmaDoubleComplex z )
+{
+    double x = MAGMA_Z_REAL( z );
+    double y = MAGMA_Z_IMAG( z );
+    if (x == 0 && y == 0) {
+        return MAGMA_Z_ZERO;
+    }
+    double r = sqrt( 0.5*( MAGMA_Z_ABS( z ) + fabs( x )));
+    if (x >= 0) {
+        return MAGMA_Z_MAKE( r, 0.5*y/r );
+    }
+    else {
+        return MAGMA_Z_MAKE( 0.5*fabs( y )/r, (y >= 0 ? r : -r) );
+    }
+}
+#endif
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZHSEQR_MT computes the eigenvalues of an N-by-N Hessenberg matrix H and,
+    optionally, the Schur form T and Schur vectors Z: H = Z T Z^H.
+    It is a replacement for LAPACK zhseqr in the geev drivers.
+
+    Like LAPACK, it uses the small-bulge multishift QR algorithm with
+    aggressive early deflation (AED) of Braman, Byers, and Mathias.
+    Each QR sweep chases a chain of tightly coupled bulges through the
+    active block; the reflectors are accumulated per window of the chain,
+    and the off-diagonal blocks of H and Z are updated with blocked
+    matrix products by nthread threads. The AED windows are processed by
+    LAPACK zlaqr3, and active blocks smaller than 75 by LAPACK zhseqr.
+
+    Arguments
+    ---------
+    @param[in]
+    wantt   magma_bool_t
+      -     = MagmaFalse: compute eigenvalues only;
+      -     = MagmaTrue:  also compute the Schur form T.
+
+    @param[in]
+    compz   magma_vec_t
+      -     = MagmaNoVec: no Schur vectors are computed;
+      -     = MagmaIVec:  Z is initialized to the identity and the
+                          Schur vectors of H are returned;
+      -     = MagmaVec:   Z must contain a unitary matrix Q on entry,
+                          and Q*Z is returned.
+
+    @param[in]
+    n       INTEGER
+            The order of the matrix H. N >= 0.
+
+    @param[in]
+    ilo     INTEGER
+    @param[in]
+    ihi     INTEGER
+            It is assumed that H is already upper triangular in rows and
+            columns 1:ILO-1 and IHI+1:N, as returned by zgebal.
+            1 <= ILO <= IHI <= N, if N > 0; ILO=1 and IHI=0, if N=0.
+
+    @param[in,out]
+    H       COMPLEX_16 array, dimension (LDH,N)
+            On entry, the upper Hessenberg matrix H.
+            On exit, if wantt, H contains the upper triangular matrix T
+            of the Schur form; otherwise, H is overwritten.
+
+    @param[in]
+    ldh     INTEGER
+            The leading dimension of the array H. LDH >= max(1,N).
+
+    @param[out]
+    w       COMPLEX_16 array, dimension (N)
+            The computed eigenvalues, in the order of the diagonal of T
+            if wantt.
+
+    @param[in,out]
+    Z       COMPLEX_16 array, dimension (LDZ,N)
+            See compz. Only rows and columns ILO:IHI of Z are updated.
+            Not referenced if compz = MagmaNoVec.
+
+    @param[in]
+    ldz     INTEGER
+            The leading dimension of the array Z. LDZ >= 1, and
+            LDZ >= max(1,N) if compz != MagmaNoVec.
+
+    @param[in]
+    nthread INTEGER
+            Number of threads for the off-diagonal updates.
+            If nthread <= 0, magma_get_parallel_numthreads() is used.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value.
+      -     > 0:  if INFO = i, the algorithm failed to compute all the
+                  eigenvalues; as in LAPACK zhseqr, elements 1:ILO-1 and
+                  i+1:N of w contain those that were computed.
+
+    @ingroup magma_geev_comp
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zhseqr_mt(
+    magma_bool_t wantt, magma_vec_t compz,
+    magma_int_t n, magma_int_t ilo, magma_int_t ihi,
+    magmaDoubleComplex *H, magma_int_t ldh,
+    #ifdef COMPLEX
+    magmaDoubleComplex *w,
+    #else
+    double *wr, double *wi,
+    #endif
+    magmaDoubleComplex *Z, magma_int_t ldz,
+    magma_int_t nthread,
+    magma_int_t *info )
+{
+    const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    const magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    const magma_int_t ione = 1;
+    const magma_int_t ineg_one = -1;
+    const double wilk1 = 0.75;
+    #ifndef COMPLEX
+    const double wilk2 = -0.4375;
+    double aa, bb, cc, dd, cs, sn, ss, swap;
+    #else
+    magmaDoubleComplex aa, bb, cc, dd, tr2, det, rtdisc, swap;
+    double s;
+    #endif
+
+    bool wantt_ = (wantt != MagmaFalse);
+    bool wantz  = (compz != MagmaNoVec);
+    magma_int_t lwantt = wantt_;
+    magma_int_t lwantz = wantz;
+
+    magma_int_t nh, nsr, nwr, nwmax, nsmax, ldv, ldu, ldhs, itmax;
+    magma_int_t ktop, kbot, kwtop, ks, ls, ld, ns, nw, nwupbd, ndfl, ndec;
+    magma_int_t ilo0, ihi0, ktop1, kbot1, inf, lwork, lhwork, i, k, it;
+    magmaDoubleComplex query;
+    magmaDoubleComplex *V = NULL, *T = NULL, *WV = NULL, *work = NULL;
+    magmaDoubleComplex *U = NULL, *uwork = NULL, *Hs = NULL, *hwork = NULL;
+    bool sorted;
+
+    *info = 0;
+    if (compz != MagmaNoVec && compz != MagmaVec && compz != MagmaIVec) {
+        *info = -2;
+    } else if (n < 0) {
+        *info = -3;
+    } else if (ilo < 1 || ilo > max( 1, n )) {
+        *info = -4;
+    } else if (ihi < min( ilo, n ) || ihi > n) {
+        *info = -5;
+    } else if (ldh < max( 1, n )) {
+        *info = -7;
+    } else if (ldz < 1 || (wantz && ldz < max( 1, n ))) {
+        #ifdef COMPLEX
+        *info = -10;
+        #else
+        *info = -11;
+        #endif
+    }
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    if (n == 0) {
+        return *info;
+    }
+
+    if (nthread <= 0) {
+        nthread = magma_get_parallel_numthreads();
+    }
+
+    nh = ihi - ilo + 1;
+    if (nh < hseqr_nmin) {
+        // small problem; LAPACK's double-shift QR is fine
+        const char *job = (wantt_ ? "S" : "E");
+        lwork = -1;
+        #ifdef COMPLEX
+        lapackf77_zhseqr( job, lapack_vec_const( compz ), &n, &ilo, &ihi, H, &ldh,
+                          w, Z, &ldz, &query, &lwork, info );
+        #else
+        lapackf77_zhseqr( job, lapack_vec_const( compz ), &n, &ilo, &ihi, H, &ldh,
+                          wr, wi, Z, &ldz, &query, &lwork, info );
+        #endif
+        lwork = max( n, magma_int_t( MAGMA_Z_REAL( query )));
+        if (MAGMA_SUCCESS != magma_zmalloc_cpu( &work, lwork )) {
+            *info = MAGMA_ERR_HOST_ALLOC;
+            return *info;
+        }
+        #ifdef COMPLEX
+        lapackf77_zhseqr( job, lapack_vec_const( compz ), &n, &ilo, &ihi, H, &ldh,
+                          w, Z, &ldz, work, &lwork, info );
+        #else
+        lapackf77_zhseqr( job, lapack_vec_const( compz ), &n, &ilo, &ihi, H, &ldh,
+                          wr, wi, Z, &ldz, work, &lwork, info );
+        #endif
+        magma_free_cpu( work );
+        return *info;
+    }
+
+    // eigenvalues isolated by zgebal
+    for (i = 0; i < n; ++i) {
+        if (i == ilo - 1) {
+            i = ihi - 1;
+            continue;
+        }
+        #ifdef COMPLEX
+        w[i] = *H(i, i);
+        #else
+        wr[i] = *H(i, i);
+        wi[i] = 0;
+        #endif
+    }
+    if (compz == MagmaIVec) {
+        lapackf77_zlaset( "A", &n, &n, &c_zero, &c_one, Z, &ldz );
+    }
+
+    ilo0 = ilo - 1;
+    ihi0 = ihi - 1;
+
+    // window and shift parameters, as in LAPACK zlaqr0 with iparmq
+    ns    = zhseqr_num_shifts( nh );
+    nwr   = (nh <= 500 ? ns : 3*ns/2);
+    nwr   = min( min( nh, (n - 1)/3 ), max( 2, nwr ));
+    nsr   = min( min( ns, (n - 3)/6 ), nh - 1 );
+    nsr   = max( 2, nsr - nsr % 2 );
+    nwmax = (n - 1)/3;
+    nsmax = (n - 3)/6;
+    nsmax = nsmax - nsmax % 2;
+    itmax = 30 * max( 10, nh );
+
+    // workspace: AED (V, T, WV, work), sweep (U, uwork), shifts (Hs, hwork)
+    ldv   = max( 1, nwmax );
+    ldu   = 3*nsmax + 14;
+    ldhs  = max( 1, nsmax );
+    ktop1 = ilo;
+    kbot1 = ihi;
+    #ifdef COMPLEX
+    lapackf77_zlaqr3( &lwantt, &lwantz, &n, &ktop1, &kbot1, &nwmax, H, &ldh, &ilo, &ihi,
+                      Z, &ldz, &ls, &ld, w, V, &ldv, &nwmax, T, &ldv, &nwmax, WV, &ldv,
+                      &query, &ineg_one );
+    #else
+    lapackf77_zlaqr3( &lwantt, &lwantz, &n, &ktop1, &kbot1, &nwmax, H, &ldh, &ilo, &ihi,
+                      Z, &ldz, &ls, &ld, wr, wi, V, &ldv, &nwmax, T, &ldv, &nwmax, WV, &ldv,
+                      &query, &ineg_one );
+    #endif
+    lwork = max( 1, magma_int_t( MAGMA_Z_REAL( query )));
+    lhwork = -1;
+    #ifdef COMPLEX
+    lapackf77_zhseqr( "E", "N", &nsmax, &ione, &nsmax, Hs, &ldhs,
+                      w, Hs, &ldhs, &query, &lhwork, &inf );
+    #else
+    lapackf77_zhseqr( "E", "N", &nsmax, &ione, &nsmax, Hs, &ldhs,
+                      wr, wi, Hs, &ldhs, &query, &lhwork, &inf );
+    #endif
+    lhwork = max( nsmax, magma_int_t( MAGMA_Z_REAL( query )));
+
+    if (MAGMA_SUCCESS != magma_zmalloc_cpu( &V,     ldv*ldv   ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &T,     ldv*ldv   ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &WV,    ldv*ldv   ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &work,  lwork     ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &U,     ldu*ldu   ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &uwork, nthread*ldu*hseqr_tile ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &Hs,    ldhs*ldhs ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &hwork, lhwork    ))
+    {
+        *info = MAGMA_ERR_HOST_ALLOC;
+        goto cleanup;
+    }
+
+    nw   = nwmax;
+    ndfl = 1;
+    ndec = -1;
+    kbot = ihi0;
+    for (it = 0; it < itmax; ++it) {
+        if (kbot < ilo0) {
+            break;
+        }
+
+        // locate the active block
+        for (k = kbot; k > ilo0; --k) {
+            if (MAGMA_Z_EQUAL( *H(k, k-1), c_zero ))
+                break;
+        }
+        ktop = k;
+
+        // choose the deflation window size; grow it after kexnw
+        // iterations without deflation, then shrink it again
+        nh = kbot - ktop + 1;
+        nwupbd = min( nh, nwmax );
+        if (ndfl < hseqr_kexnw) {
+            nw = min( nwupbd, nwr );
+        }
+        else {
+            nw = min( nwupbd, 2*nw );
+        }
+        if (nw < nwmax) {
+            if (nw >= nh - 1) {
+                nw = nh;
+            }
+            else {
+                kwtop = kbot - nw + 1;
+                if (MAGMA_Z_ABS1( *H(kwtop, kwtop-1) ) > MAGMA_Z_ABS1( *H(kwtop-1, kwtop-2) ))
+                    nw += 1;
+            }
+        }
+        if (ndfl < hseqr_kexnw) {
+            ndec = -1;
+        }
+        else if (ndec >= 0 || nw >= nwupbd) {
+            ndec += 1;
+            if (nw - ndec < 2)
+                ndec = 0;
+            nw -= ndec;
+        }
+
+        // aggressive early deflation; the ls undeflatable eigenvalues
+        // of the window are returned as shifts in w(ks:kbot)
+        ktop1 = ktop + 1;
+        kbot1 = kbot + 1;
+        #ifdef COMPLEX
+        lapackf77_zlaqr3( &lwantt, &lwantz, &n, &ktop1, &kbot1, &nw, H, &ldh, &ilo, &ihi,
+                          Z, &ldz, &ls, &ld, w, V, &ldv, &nw, T, &ldv, &nw, WV, &ldv,
+                          work, &lwork );
+        #else
+        lapackf77_zlaqr3( &lwantt, &lwantz, &n, &ktop1, &kbot1, &nw, H, &ldh, &ilo, &ihi,
+                          Z, &ldz, &ls, &ld, wr, wi, V, &ldv, &nw, T, &ldv, &nw, WV, &ldv,
+                          work, &lwork );
+        #endif
+        kbot -= ld;
+        ks = kbot - ls + 1;
+
+        // sweep unless AED deflated enough to try again right away
+        if (ld == 0 || (100*ld <= nw*hseqr_nibble
+                        && kbot - ktop + 1 > min( hseqr_nmin, nwmax )))
+        {
+            ns = min( min( nsmax, nsr ), max( 2, kbot - ktop ));
+            ns = ns - ns % 2;
+
+            if (ndfl % hseqr_kexsh == 0) {
+                // exceptional shifts
+                ks = kbot - ns + 1;
+                #ifdef COMPLEX
+                for (i = kbot; i >= ks + 1; i -= 2) {
+                    w[i]   = *H(i, i) + wilk1*MAGMA_Z_ABS1( *H(i, i-1) );
+                    w[i-1] = w[i];
+                }
+                #else
+                for (i = kbot; i >= max( ks + 1, ktop + 2 ); i -= 2) {
+                    ss = fabs( *H(i, i-1) ) + fabs( *H(i-1, i-2) );
+                    aa = wilk1*ss + *H(i, i);
+                    bb = ss;
+                    cc = wilk2*ss;
+                    dd = aa;
+                    lapackf77_dlanv2( &aa, &bb, &cc, &dd, &wr[i-1], &wi[i-1],
+                                      &wr[i], &wi[i], &cs, &sn );
+                }
+                if (ks == ktop) {
+                    wr[ks+1] = *H(ks+1, ks+1);
+                    wi[ks+1] = 0;
+                    wr[ks]   = wr[ks+1];
+                    wi[ks]   = wi[ks+1];
+                }
+                #endif
+            }
+            else {
+                // if AED returned too few shifts, use the eigenvalues of
+                // the trailing ns-by-ns block
+                if (kbot - ks + 1 <= ns/2) {
+                    ks = kbot - ns + 1;
+                    lapackf77_zlacpy( "A", &ns, &ns, H(ks, ks), &ldh, Hs, &ldhs );
+                    #ifdef COMPLEX
+                    lapackf77_zhseqr( "E", "N", &ns, &ione, &ns, Hs, &ldhs, &w[ks],
+                                      Hs, &ldhs, hwork, &lhwork, &inf );
+                    #else
+                    lapackf77_zhseqr( "E", "N", &ns, &ione, &ns, Hs, &ldhs, &wr[ks], &wi[ks],
+                                      Hs, &ldhs, hwork, &lhwork, &inf );
+                    #endif
+                    ks += inf;
+
+                    // if that failed too, use the eigenvalues of the
+                    // trailing 2-by-2 block
+                    if (ks >= kbot) {
+                        #ifdef COMPLEX
+                        s = MAGMA_Z_ABS1( *H(kbot-1, kbot-1) ) + MAGMA_Z_ABS1( *H(kbot, kbot-1) )
+                          + MAGMA_Z_ABS1( *H(kbot-1, kbot  ) ) + MAGMA_Z_ABS1( *H(kbot, kbot  ) );
+                        aa = *H(kbot-1, kbot-1) / s;
+                        cc = *H(kbot,   kbot-1) / s;
+                        bb = *H(kbot-1, kbot  ) / s;
+                        dd = *H(kbot,   kbot  ) / s;
+                        tr2 = (aa + dd) * 0.5;
+                        det = (aa - tr2)*(dd - tr2) - bb*cc;
+                        rtdisc = zhseqr_sqrt( -det );
+                        w[kbot-1] = (tr2 + rtdisc) * s;
+                        w[kbot]   = (tr2 - rtdisc) * s;
+                        #else
+                        aa = *H(kbot-1, kbot-1);
+                        cc = *H(kbot,   kbot-1);
+                        bb = *H(kbot-1, kbot  );
+                        dd = *H(kbot,   kbot  );
+                        lapackf77_dlanv2( &aa, &bb, &cc, &dd, &wr[kbot-1], &wi[kbot-1],
+                                          &wr[kbot], &wi[kbot], &cs, &sn );
+                        #endif
+                        ks = kbot - 1;
+                    }
+                }
+
+                // with more shifts than needed, use the largest ones
+                if (kbot - ks + 1 > ns) {
+                    sorted = false;
+                    for (k = kbot; k >= ks + 1 && ! sorted; --k) {
+                        sorted = true;
+                        for (i = ks; i < k; ++i) {
+                            #ifdef COMPLEX
+                            if (MAGMA_Z_ABS1( w[i] ) < MAGMA_Z_ABS1( w[i+1] )) {
+                                sorted = false;
+                                swap   = w[i];
+                                w[i]   = w[i+1];
+                                w[i+1] = swap;
+                            }
+                            #else
+                            if (fabs( wr[i] ) + fabs( wi[i] ) < fabs( wr[i+1] ) + fabs( wi[i+1] )) {
+                                sorted = false;
+                                swap    = wr[i];
+                                wr[i]   = wr[i+1];
+                                wr[i+1] = swap;
+                                swap    = wi[i];
+                                wi[i]   = wi[i+1];
+                                wi[i+1] = swap;
+                            }
+                            #endif
+                        }
+                    }
+                }
+
+                #ifndef COMPLEX
+                // shuffle the shifts into pairs of real shifts and
+                // complex conjugate pairs
+                for (i = kbot; i >= ks + 2; i -= 2) {
+                    if (wi[i] != -wi[i-1]) {
+                        swap    = wr[i];
+                        wr[i]   = wr[i-1];
+                        wr[i-1] = wr[i-2];
+                        wr[i-2] = swap;
+                        swap    = wi[i];
+                        wi[i]   = wi[i-1];
+                        wi[i-1] = wi[i-2];
+                        wi[i-2] = swap;
+                    }
+                }
+                #endif
+            }
+
+            // of two shifts, use the one closer to H(kbot, kbot) twice
+            if (kbot - ks + 1 == 2) {
+                #ifdef COMPLEX
+                if (MAGMA_Z_ABS1( w[kbot] - *H(kbot, kbot) ) < MAGMA_Z_ABS1( w[kbot-1] - *H(kbot, kbot) ))
+                    w[kbot-1] = w[kbot];
+                else
+                    w[kbot] = w[kbot-1];
+                #else
+                if (wi[kbot] == 0) {
+                    if (fabs( wr[kbot] - *H(kbot, kbot) ) < fabs( wr[kbot-1] - *H(kbot, kbot) ))
+                        wr[kbot-1] = wr[kbot];
+                    else
+                        wr[kbot] = wr[kbot-1];
+                }
+                #endif
+            }
+
+            ns = min( ns, kbot - ks + 1 );
+            ns = ns - ns % 2;
+            ks = kbot - ns + 1;
+
+            #ifdef COMPLEX
+            zhseqr_sweep( wantt_, wantz, n, ktop, kbot, ns, &w[ks],
+                          H, ldh, ilo0, ihi0, Z, ldz, U, ldu, uwork, nthread );
+            #else
+            zhseqr_sweep( wantt_, wantz, n, ktop, kbot, ns, &wr[ks], &wi[ks],
+                          H, ldh, ilo0, ihi0, Z, ldz, U, ldu, uwork, nthread );
+            #endif
+        }
+
+        ndfl = (ld > 0 ? 1 : ndfl + 1);
+    }
+    if (kbot >= ilo0) {
+        // no convergence in itmax iterations
+        *info = kbot + 1;
+    }
+
+    // clear out the trash below the subdiagonal
+    if ((wantt_ || *info != 0) && n > 2) {
+        magma_int_t n2 = n - 2;
+        lapackf77_zlaset( "L", &n2, &n2, &c_zero, &c_zero, H(2, 0), &ldh );
+    }
+
+cleanup:
+    magma_free_cpu( V     );
+    magma_free_cpu( T     );
+    magma_free_cpu( WV    );
+    magma_free_cpu( work  );
+    magma_free_cpu( U     );
+    magma_free_cpu( uwork );
+    magma_free_cpu( Hs    );
+    magma_free_cpu( hwork );
+
+    return *info;
+}
@@ -0,0 +1,783 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+       Block Householder reflectors on the host: the triangular factor T
+       (larft), computed recursively, and the application H C or C H
+       (larfb), by OpenMP threads each updating its own tiles of C.
+*/
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(MAGMA_WITH_MKL)
+#include <mkl_service.h>
+#endif
+
+#include "magma_internal.h"
+
+#define V(i_, j_)  (V + (i_) + (j_)*ldv)
+#define T(i_, j_)  (T + (i_) + (j_)*ldt)
+#define C(i_, j_)  (C + (i_) + (j_)*ldc)
+#define W(i_, j_)  (W + (i_) + (j_)*ldw)
+
+// Below this many reflectors, LAPACK zlarft computes T directly.
+static const magma_int_t larft_nbmin = 8;
+
+// Width of the tiles of C (columns for side = Left, rows for side = Right).
+static const magma_int_t larfb_nb = 128;
+
+
+/******************************************************************************/
+// Inside a parallel region, each thread calls sequential BLAS on its tiles.
+// MKL is told so per thread; OpenMP builds of other BLAS libraries already
+// do not nest.
+static int zlarfb_blas_local_begin()
+{
+    #if defined(MAGMA_WITH_MKL)
+    return mkl_set_num_threads_local( 1 );
+    #else
+    return 0;
+    #endif
+}
+
+static void zlarfb_blas_local_end( int saved )
+{
+    #if defined(MAGMA_WITH_MKL)
+    mkl_set_num_threads_local( saved );
+    #endif
+}
+
+
+/******************************************************************************/
+// T for forward, columnwise V (n-by-k, unit lower trapezoidal).
+// With V = [ V1 V2 ] split after k1 columns,
+//     T = [ T1  -T1 (V1^H V2) T2 ]
+//         [ 0    T2              ],
+// where T1 and T2 are computed recursively, and V2 is zero above row k1.
+static void zlarft_rec_fc(
+    magma_int_t n, magma_int_t k,
+    const magmaDoubleComplex *V, magma_int_t ldv,
+    const magmaDoubleComplex *tau,
+    magmaDoubleComplex *T, magma_int_t ldt )
+{
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+
+    if (k <= larft_nbmin) {
+        lapackf77_zlarft( MagmaForwardStr, MagmaColumnwiseStr, &n, &k,
+                          V, &ldv, tau, T, &ldt );
+        return;
+    }
+
+    magma_int_t k1 = k/2;
+    magma_int_t k2 = k - k1;
+    magma_int_t nk = n - k;
+    magma_int_t n1 = n - k1;
+    zlarft_rec_fc( n,  k1, V,         ldv, tau,      T,          ldt );
+    zlarft_rec_fc( n1, k2, V(k1, k1), ldv, tau + k1, T(k1, k1), ldt );
+
+    // T12 = V1(k1:k-1, :)^H V2(k1:k-1, :) + V1(k:n-1, :)^H V2(k:n-1, :),
+    // where V2(k1:k-1, :) is unit lower triangular
+    magmaDoubleComplex *T12 = T(0, k1);
+    for (magma_int_t j = 0; j < k2; ++j) {
+        for (magma_int_t i = 0; i < k1; ++i) {
+            T12[i + j*ldt] = MAGMA_Z_CONJ( *V(k1 + j, i) );
+        }
+    }
+    blasf77_ztrmm( MagmaRightStr, MagmaLowerStr, MagmaNoTransStr, MagmaUnitStr,
+                   &k1, &k2, &c_one, V(k1, k1), &ldv, T12, &ldt );
+    if (nk > 0) {
+        blasf77_zgemm( MagmaConjTransStr, MagmaNoTransStr, &k1, &k2, &nk,
+                       &c_one, V(k, 0),  &ldv,
+                               V(k, k1), &ldv,
+                       &c_one, T12,      &ldt );
+    }
+
+    // T12 = -T1 T12 T2
+    blasf77_ztrmm( MagmaLeftStr, MagmaUpperStr, MagmaNoTransStr, MagmaNonUnitStr,
+                   &k1, &k2, &c_neg_one, T, &ldt, T12, &ldt );
+    blasf77_ztrmm( MagmaRightStr, MagmaUpperStr, MagmaNoTransStr, MagmaNonUnitStr,
+                   &k1, &k2, &c_one, T(k1, k1), &ldt, T12, &ldt );
+}
+
+
+/******************************************************************************/
+// T for forward, rowwise V (k-by-n, unit upper trapezoidal).
+// Same as zlarft_rec_fc, with T12 = -T1 (V1 V2^H) T2 for V split after k1 rows.
+static void zlarft_rec_fr(
+    magma_int_t n, magma_int_t k,
+    const magmaDoubleComplex *V, magma_int_t ldv,
+    const magmaDoubleComplex *tau,
+    magmaDoubleComplex *T, magma_int_t ldt )
+{
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+
+    if (k <= larft_nbmin) {
+        lapackf77_zlarft( MagmaForwardStr, MagmaRowwiseStr, &n, &k,
+                          V, &ldv, tau, T, &ldt );
+        return;
+    }
+
+    magma_int_t k1 = k/2;
+    magma_int_t k2 = k - k1;
+    magma_int_t nk = n - k;
+    magma_int_t n1 = n - k1;
+    zlarft_rec_fr( n,  k1, V,         ldv, tau,      T,          ldt );
+    zlarft_rec_fr( n1, k2, V(k1, k1), ldv, tau + k1, T(k1, k1), ldt );
+
+    // T12 = V1(:, k1:k-1) V2(:, k1:k-1)^H + V1(:, k:n-1) V2(:, k:n-1)^H,
+    // where V2(:, k1:k-1) is unit upper triangular
+    magmaDoubleComplex *T12 = T(0, k1);
+    lapackf77_zlacpy( MagmaFullStr, &k1, &k2, V(0, k1), &ldv, T12, &ldt );
+    blasf77_ztrmm( MagmaRightStr, MagmaUpperStr, MagmaConjTransStr, MagmaUnitStr,
+                   &k1, &k2, &c_one, V(k1, k1), &ldv, T12, &ldt );
+    if (nk > 0) {
+        blasf77_zgemm( MagmaNoTransStr, MagmaConjTransStr, &k1, &k2, &nk,
+                       &c_one, V(0, k),  &ldv,
+                               V(k1, k), &ldv,
+                       &c_one, T12,      &ldt );
+    }
+
+    // T12 = -T1 T12 T2
+    blasf77_ztrmm( MagmaLeftStr, MagmaUpperStr, MagmaNoTransStr, MagmaNonUnitStr,
+                   &k1, &k2, &c_neg_one, T, &ldt, T12, &ldt );
+    blasf77_ztrmm( MagmaRightStr, MagmaUpperStr, MagmaNoTransStr, MagmaNonUnitStr,
+                   &k1, &k2, &c_one, T(k1, k1), &ldt, T12, &ldt );
+}
+
+
+/******************************************************************************/
+// Applies H = I - V T V^H, or H^H, to one tile of C, for forward,
+// columnwise V, with V = [ V1; V2 ] and V1 unit lower triangular.
+// side = Left:  C is m-by-n, V is m-by-k, W is k-by-n;
+//     W = V^H C,  W = op(T) W,  C = C - V W.
+// side = Right: C is m-by-n, V is n-by-k, W is m-by-k;
+//     W = C V,    W = W op(T),  C = C - W V^H.
+// The tile of C is read twice within one call, while it is in cache.
+static void zlarfb_fc_tile(
+    magma_side_t side, magma_trans_t trans,
+    magma_int_t m, magma_int_t n, magma_int_t k,
+    const magmaDoubleComplex *V, magma_int_t ldv,
+    const magmaDoubleComplex *T, magma_int_t ldt,
+    magmaDoubleComplex *C, magma_int_t ldc,
+    magmaDoubleComplex *W )
+{
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    const char *transT = (trans == MagmaNoTrans ? MagmaNoTransStr : MagmaConjTransStr);
+
+    magma_int_t ldw;
+    if (side == MagmaLeft) {
+        magma_int_t mk = m - k;
+        ldw = k;
+        lapackf77_zlacpy( MagmaFullStr, &k, &n, C, &ldc, W, &ldw );
+        blasf77_ztrmm( MagmaLeftStr, MagmaLowerStr, MagmaConjTransStr, MagmaUnitStr,
+                       &k, &n, &c_one, V, &ldv, W, &ldw );
+        if (mk > 0) {
+            blasf77_zgemm( MagmaConjTransStr, MagmaNoTransStr, &k, &n, &mk,
+                           &c_one, V(k, 0), &ldv,
+                                   C(k, 0), &ldc,
+                           &c_one, W,       &ldw );
+        }
+        blasf77_ztrmm( MagmaLeftStr, MagmaUpperStr, transT, MagmaNonUnitStr,
+                       &k, &n, &c_one, T, &ldt, W, &ldw );
+        if (mk > 0) {
+            blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &mk, &n, &k,
+                           &c_neg_one, V(k, 0), &ldv,
+                                       W,       &ldw,
+                           &c_one,     C(k, 0), &ldc );
+        }
+        blasf77_ztrmm( MagmaLeftStr, MagmaLowerStr, MagmaNoTransStr, MagmaUnitStr,
+                       &k, &n, &c_one, V, &ldv, W, &ldw );
+        for (magma_int_t j = 0; j < n; ++j) {
+            for (magma_int_t i = 0; i < k; ++i) {
+                *C(i, j) = MAGMA_Z_SUB( *C(i, j), *W(i, j) );
+            }
+        }
+    }
+    else {
+        magma_int_t nk = n - k;
+        ldw = m;
+        lapackf77_zlacpy( MagmaFullStr, &m, &k, C, &ldc, W, &ldw );
+        blasf77_ztrmm( MagmaRightStr, MagmaLowerStr, MagmaNoTransStr, MagmaUnitStr,
+                       &m, &k, &c_one, V, &ldv, W, &ldw );
+        if (nk > 0) {
+            blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &m, &k, &nk,
+                           &c_one, C(0, k), &ldc,
+                                   V(k, 0), &ldv,
+                           &c_one, W,       &ldw );
+        }
+        blasf77_ztrmm( MagmaRightStr, MagmaUpperStr, transT, MagmaNonUnitStr,
+                       &m, &k, &c_one, T, &ldt, W, &ldw );
+        if (nk > 0) {
+            blasf77_zgemm( MagmaNoTransStr, MagmaConjTransStr, &m, &nk, &k,
+                           &c_neg_one, W,       &ldw,
+                                       V(k, 0), &ldv,
+                           &c_one,     C(0, k), &ldc );
+        }
+        blasf77_ztrmm( MagmaRightStr, MagmaLowerStr, MagmaConjTransStr, MagmaUnitStr,
+                       &m, &k, &c_one, V, &ldv, W, &ldw );
+        for (magma_int_t j = 0; j < k; ++j) {
+            for (magma_int_t i = 0; i < m; ++i) {
+                *C(i, j) = MAGMA_Z_SUB( *C(i, j), *W(i, j) );
+            }
+        }
+    }
+}
+
+
+/******************************************************************************/
+// Applies H or H^H to one tile of C, with the fused kernel for forward,
+// columnwise V, and with LAPACK zlarfb otherwise. W has k*(n or m) entries.
+static void zlarfb_tile(
+    magma_side_t side, magma_trans_t trans,
+    magma_direct_t direct, magma_storev_t storev,
+    magma_int_t m, magma_int_t n, magma_int_t k,
+    const magmaDoubleComplex *V, magma_int_t ldv,
+    const magmaDoubleComplex *T, magma_int_t ldt,
+    magmaDoubleComplex *C, magma_int_t ldc,
+    magmaDoubleComplex *W )
+{
+    if (direct == MagmaForward && storev == MagmaColumnwise) {
+        zlarfb_fc_tile( side, trans, m, n, k, V, ldv, T, ldt, C, ldc, W );
+    }
+    else {
+        magma_int_t ldw = (side == MagmaLeft ? n : m);
+        lapackf77_zlarfb( lapack_side_const( side ), lapack_trans_const( trans ),
+                          lapack_direct_const( direct ), lapack_storev_const( storev ),
+                          &m, &n, &k, V, &ldv, T, &ldt, C, &ldc, W, &ldw );
+    }
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZLARFT forms the triangular factor T of a complex block reflector H
+    of order n, which is defined as a product of k elementary reflectors.
+
+    If DIRECT = MagmaForward,  H = H(1) H(2) . . . H(k) and T is upper triangular;
+    If DIRECT = MagmaBackward, H = H(k) . . . H(2) H(1) and T is lower triangular.
+
+    If STOREV = MagmaColumnwise, the vector which defines the elementary
+    reflector H(i) is stored in the i-th column of the array V, and
+        H = I - V * T * V^H.
+    If STOREV = MagmaRowwise, the vector which defines the elementary
+    reflector H(i) is stored in the i-th row of the array V, and
+        H = I - V^H * T * V.
+
+    This is the same as LAPACK zlarft. For DIRECT = MagmaForward, T is
+    computed recursively, splitting the reflectors in halves, so most of
+    the work is in Level 3 BLAS zgemm and ztrmm rather than Level 2 zgemv;
+    DIRECT = MagmaBackward calls LAPACK zlarft.
+
+    Arguments
+    ---------
+    @param[in]
+    direct  magma_direct_t
+            Specifies the order in which the elementary reflectors are
+            multiplied to form the block reflector:
+      -     = MagmaForward:  H = H(1) H(2) . . . H(k) (Forward)
+      -     = MagmaBackward: H = H(k) . . . H(2) H(1) (Backward)
+
+    @param[in]
+    storev  magma_storev_t
+            Specifies how the vectors which define the elementary
+            reflectors are stored:
+      -     = MagmaColumnwise: Columnwise
+      -     = MagmaRowwise:    Rowwise
+
+    @param[in]
+    n       INTEGER
+            The order of the block reflector H. n >= k.
+
+    @param[in]
+    k       INTEGER
+            The order of the triangular factor T (= the number of
+            elementary reflectors). k >= 0.
+
+    @param[in]
+    V       COMPLEX_16 array, dimension
+                (ldv,k) if STOREV = MagmaColumnwise
+                (ldv,n) if STOREV = MagmaRowwise
+            The matrix V, as in LAPACK zlarft. The unit diagonal and the
+            zeros of V are not referenced.
+
+    @param[in]
+    ldv     INTEGER
+            The leading dimension of the array V.
+            If STOREV = MagmaColumnwise, ldv >= max(1,n);
+            if STOREV = MagmaRowwise,    ldv >= k.
+
+    @param[in]
+    tau     COMPLEX_16 array, dimension (k)
+            TAU(i) must contain the scalar factor of the elementary
+            reflector H(i).
+
+    @param[out]
+    T       COMPLEX_16 array, dimension (ldt,k)
+            The k-by-k triangular factor T of the block reflector.
+
+    @param[in]
+    ldt     INTEGER
+            The leading dimension of the array T. ldt >= k.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value.
+
+    @ingroup magma_larft
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zlarft_cpu(
+    magma_direct_t direct, magma_storev_t storev,
+    magma_int_t n, magma_int_t k,
+    const magmaDoubleComplex *V, magma_int_t ldv,
+    const magmaDoubleComplex *tau,
+    magmaDoubleComplex *T, magma_int_t ldt,
+    magma_int_t *info )
+{
+    *info = 0;
+    if (direct != MagmaForward && direct != MagmaBackward) {
+        *info = -1;
+    } else if (storev != MagmaColumnwise && storev != MagmaRowwise) {
+        *info = -2;
+    } else if (k < 0) {
+        *info = -4;
+    } else if (n < k) {
+        *info = -3;
+    } else if (ldv < (storev == MagmaColumnwise ? max(1,n) : max(1,k))) {
+        *info = -6;
+    } else if (ldt < max(1,k)) {
+        *info = -9;
+    }
+
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    // Quick return if possible
+    if (k == 0) {
+        return *info;
+    }
+
+    if (direct == MagmaBackward) {
+        lapackf77_zlarft( lapack_direct_const( direct ), lapack_storev_const( storev ),
+                          &n, &k, V, &ldv, tau, T, &ldt );
+    }
+    else if (storev == MagmaColumnwise) {
+        zlarft_rec_fc( n, k, V, ldv, tau, T, ldt );
+    }
+    else {
+        zlarft_rec_fr( n, k, V, ldv, tau, T, ldt );
+    }
+
+    return *info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZLARFB applies a complex block reflector H or its conjugate transpose
+    H^H to a complex m-by-n matrix C, from either the left or the right,
+    on the CPU host.
+
+    This is the same as LAPACK zlarfb. C is split into tiles of columns
+    (side = MagmaLeft) or rows (side = MagmaRight), which are updated in
+    parallel by OpenMP threads, each with sequential BLAS. For forward,
+    columnwise V, each tile is updated by W = V^H C, W = op(T) W,
+    C = C - V W (or the same from the right), so the tile is still in
+    cache when it is updated; other cases call LAPACK zlarfb on each tile.
+
+    Arguments
+    ---------
+    @param[in]
+    side    magma_side_t
+      -     = MagmaLeft:      apply H or H^H from the Left
+      -     = MagmaRight:     apply H or H^H from the Right
+
+    @param[in]
+    trans   magma_trans_t
+      -     = MagmaNoTrans:    Apply H   (No transpose)
+      -     = Magma_ConjTrans: Apply H^H (Conjugate transpose)
+
+    @param[in]
+    direct  magma_direct_t
+            Indicates how H is formed from a product of elementary
+            reflectors
+      -     = MagmaForward:  H = H(1) H(2) . . . H(k) (Forward)
+      -     = MagmaBackward: H = H(k) . . . H(2) H(1) (Backward)
+
+    @param[in]
+    storev  magma_storev_t
+            Indicates how the vectors which define the elementary
+            reflectors are stored:
+      -     = MagmaColumnwise: Columnwise
+      -     = MagmaRowwise:    Rowwise
+
+    @param[in]
+    m       INTEGER
+            The number of rows of the matrix C. m >= 0.
+
+    @param[in]
+    n       INTEGER
+            The number of columns of the matrix C. n >= 0.
+
+    @param[in]
+    k       INTEGER
+            The order of the matrix T (= the number of elementary
+            reflectors whose product defines the block reflector).
+            If side = MagmaLeft, m >= k; if side = MagmaRight, n >= k.
+
+    @param[in]
+    V       COMPLEX_16 array, dimension
+                (ldv,k) if STOREV = MagmaColumnwise
+                (ldv,m) if STOREV = MagmaRowwise and SIDE = MagmaLeft
+                (ldv,n) if STOREV = MagmaRowwise and SIDE = MagmaRight
+            The matrix V, as in LAPACK zlarfb. The unit diagonal and the
+            zeros of V are not referenced.
+
+    @param[in]
+    ldv     INTEGER
+            The leading dimension of the array V.
+            If STOREV = MagmaColumnwise and SIDE = MagmaLeft,  ldv >= max(1,m);
+            if STOREV = MagmaColumnwise and SIDE = MagmaRight, ldv >= max(1,n);
+            if STOREV = MagmaRowwise,                          ldv >= k.
+
+    @param[in]
+    T       COMPLEX_16 array, dimension (ldt,k)
+            The triangular k-by-k matrix T in the representation of the
+            block reflector, as returned by magma_zlarft_cpu.
+
+    @param[in]
+    ldt     INTEGER
+            The leading dimension of the array T. ldt >= k.
+
+    @param[in,out]
+    C       COMPLEX_16 array, dimension (ldc,n)
+            On entry, the m-by-n matrix C.
+            On exit, C is overwritten by H*C, H^H*C, C*H, or C*H^H.
+
+    @param[in]
+    ldc     INTEGER
+            The leading dimension of the array C. ldc >= max(1,m).
+
+    @param[out]
+    work    (workspace) COMPLEX_16 array, dimension (MAX(1,LWORK))
+            On exit, if INFO = 0, WORK[0] returns the optimal LWORK.
+
+    @param[in]
+    lwork   INTEGER
+            The dimension of the array WORK.
+            If side = MagmaLeft, lwork >= max(1, k*min(n, 128));
+            if side = MagmaRight, lwork >= max(1, k*min(m, 128)).
+            With a smaller lwork, fewer threads are used; the optimal
+            lwork is returned by a query.
+    \n
+            If lwork = -1, then a workspace query is assumed; the routine
+            only calculates the optimal size of the WORK array, returns
+            this value as the first entry of the WORK array, and no error
+            message related to LWORK is issued.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value.
+
+    @ingroup magma_larfb
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zlarfb_cpu(
+    magma_side_t side, magma_trans_t trans,
+    magma_direct_t direct, magma_storev_t storev,
+    magma_int_t m, magma_int_t n, magma_int_t k,
+    const magmaDoubleComplex *V, magma_int_t ldv,
+    const magmaDoubleComplex *T, magma_int_t ldt,
+    magmaDoubleComplex *C, magma_int_t ldc,
+    magmaDoubleComplex *work, magma_int_t lwork,
+    magma_int_t *info )
+{
+    bool left = (side == MagmaLeft);
+    magma_int_t nq = (left ? m : n);  // order of H
+    magma_int_t nc = (left ? n : m);  // length that C is tiled along
+    magma_int_t nb = min( larfb_nb, max( 1, nc ));
+    magma_int_t ntile = magma_ceildiv( nc, nb );
+    magma_int_t nthread = max( 1, min( magma_get_parallel_numthreads(), ntile ));
+    magma_int_t lwkmin = max( 1, k*nb );
+    magma_int_t lwkopt = lwkmin*nthread;
+    bool lquery = (lwork == -1);
+
+    *info = 0;
+    if (side != MagmaLeft && side != MagmaRight) {
+        *info = -1;
+    } else if (trans != MagmaNoTrans && trans != Magma_ConjTrans) {
+        *info = -2;
+    } else if (direct != MagmaForward && direct != MagmaBackward) {
+        *info = -3;
+    } else if (storev != MagmaColumnwise && storev != MagmaRowwise) {
+        *info = -4;
+    } else if (m < 0) {
+        *info = -5;
+    } else if (n < 0) {
+        *info = -6;
+    } else if (k < 0 || k > nq) {
+        *info = -7;
+    } else if (ldv < (storev == MagmaColumnwise ? max(1,nq) : max(1,k))) {
+        *info = -9;
+    } else if (ldt < max(1,k)) {
+        *info = -11;
+    } else if (ldc < max(1,m)) {
+        *info = -13;
+    } else if (lwork < lwkmin && ! lquery) {
+        *info = -15;
+    }
+
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    work[0] = magma_zmake_lwork( lwkopt );
+    if (lquery) {
+        return *info;
+    }
+
+    // Quick return if possible
+    if (m == 0 || n == 0 || k == 0) {
+        return *info;
+    }
+
+    // one k-by-nb W per thread
+    nthread = min( nthread, lwork / lwkmin );
+
+    if (nthread == 1) {
+        // tiles in order, with threaded BLAS in each
+        for (magma_int_t i0 = 0; i0 < nc; i0 += nb) {
+            magma_int_t ib = min( nb, nc - i0 );
+            if (left) {
+                zlarfb_tile( side, trans, direct, storev, m, ib, k,
+                             V, ldv, T, ldt, C(0, i0), ldc, work );
+            }
+            else {
+                zlarfb_tile( side, trans, direct, storev, ib, n, k,
+                             V, ldv, T, ldt, C(i0, 0), ldc, work );
+            }
+        }
+    }
+    else {
+        #pragma omp parallel num_threads( nthread )
+        {
+            #ifdef _OPENMP
+            magma_int_t tid = omp_get_thread_num();
+            #else
+            magma_int_t tid = 0;
+            #endif
+            magmaDoubleComplex *W = work + tid*lwkmin;
+            int saved = zlarfb_blas_local_begin();
+
+            #pragma omp for schedule(static)
+            for (magma_int_t it = 0; it < ntile; ++it) {
+                magma_int_t i0 = it*nb;
+                magma_int_t ib = min( nb, nc - i0 );
+                if (left) {
+                    zlarfb_tile( side, trans, direct, storev, m, ib, k,
+                                 V, ldv, T, ldt, C(0, i0), ldc, W );
+                }
+                else {
+                    zlarfb_tile( side, trans, direct, storev, ib, n, k,
+                                 V, ldv, T, ldt, C(i0, 0), ldc, W );
+                }
+            }
+
+            zlarfb_blas_local_end( saved );
+        }
+    }
+
+    return *info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZLARFB_CPU_VBATCHED applies block reflectors H_i or H_i^H to a batch
+    of independent matrices C_i, from either the left or the right, on the
+    CPU host, as magma_zlarfb_cpu does for one matrix:
+        C_i = op(H_i) C_i  or  C_i = C_i op(H_i),   i = 0, ..., batchCount-1.
+    Each problem may have its own size.
+
+    This is meant for many small block reflectors, such as those of the
+    bulge chasing back-transformation. Problems are distributed over OpenMP
+    threads, each updating whole problems with sequential BLAS.
+
+    Arguments
+    ---------
+    @param[in]
+    side    magma_side_t
+      -     = MagmaLeft:      apply H_i or H_i^H from the Left
+      -     = MagmaRight:     apply H_i or H_i^H from the Right
+
+    @param[in]
+    trans   magma_trans_t
+      -     = MagmaNoTrans:    Apply H_i   (No transpose)
+      -     = Magma_ConjTrans: Apply H_i^H (Conjugate transpose)
+
+    @param[in]
+    direct  magma_direct_t
+      -     = MagmaForward:  H_i = H_i(1) H_i(2) . . . H_i(k) (Forward)
+      -     = MagmaBackward: H_i = H_i(k) . . . H_i(2) H_i(1) (Backward)
+
+    @param[in]
+    storev  magma_storev_t
+      -     = MagmaColumnwise: Columnwise
+      -     = MagmaRowwise:    Rowwise
+
+    @param[in]
+    m       INTEGER array, dimension (batchCount)
+            The number of rows of each C_i. m[i] >= 0.
+
+    @param[in]
+    n       INTEGER array, dimension (batchCount)
+            The number of columns of each C_i. n[i] >= 0.
+
+    @param[in]
+    k       INTEGER array, dimension (batchCount)
+            The order of each T_i. If side = MagmaLeft, m[i] >= k[i];
+            if side = MagmaRight, n[i] >= k[i].
+
+    @param[in]
+    V_array Array of pointers, dimension (batchCount).
+            Each is a COMPLEX_16 array V_i, as V in magma_zlarfb_cpu.
+
+    @param[in]
+    ldv     INTEGER array, dimension (batchCount)
+            The leading dimension of each V_i, as in magma_zlarfb_cpu.
+
+    @param[in]
+    T_array Array of pointers, dimension (batchCount).
+            Each is a COMPLEX_16 array T_i of dimension (ldt[i],k[i]).
+
+    @param[in]
+    ldt     INTEGER array, dimension (batchCount)
+            The leading dimension of each T_i. ldt[i] >= k[i].
+
+    @param[in,out]
+    C_array Array of pointers, dimension (batchCount).
+            Each is a COMPLEX_16 array C_i of dimension (ldc[i],n[i]).
+            On exit, C_i is overwritten by op(H_i) C_i or C_i op(H_i).
+
+    @param[in]
+    ldc     INTEGER array, dimension (batchCount)
+            The leading dimension of each C_i. ldc[i] >= max(1,m[i]).
+
+    @param[in]
+    batchCount  INTEGER
+            The number of matrices to operate on.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value,
+                  for at least one problem.
+      -     MAGMA_ERR_HOST_ALLOC: could not allocate workspace.
+
+    @ingroup magma_larfb
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zlarfb_cpu_vbatched(
+    magma_side_t side, magma_trans_t trans,
+    magma_direct_t direct, magma_storev_t storev,
+    const magma_int_t *m, const magma_int_t *n, const magma_int_t *k,
+    const magmaDoubleComplex * const *V_array, const magma_int_t *ldv,
+    const magmaDoubleComplex * const *T_array, const magma_int_t *ldt,
+    magmaDoubleComplex **C_array, const magma_int_t *ldc,
+    magma_int_t batchCount,
+    magma_int_t *info )
+{
+    bool left = (side == MagmaLeft);
+    magmaDoubleComplex *work = NULL;
+    magma_int_t lwork = 1;
+
+    *info = 0;
+    if (side != MagmaLeft && side != MagmaRight) {
+        *info = -1;
+    } else if (trans != MagmaNoTrans && trans != Magma_ConjTrans) {
+        *info = -2;
+    } else if (direct != MagmaForward && direct != MagmaBackward) {
+        *info = -3;
+    } else if (storev != MagmaColumnwise && storev != MagmaRowwise) {
+        *info = -4;
+    } else if (batchCount < 0) {
+        *info = -14;
+    }
+    // check each problem, and find the largest W
+    for (magma_int_t i = 0; i < batchCount && *info == 0; ++i) {
+        magma_int_t nq = (left ? m[i] : n[i]);
+        if (m[i] < 0) {
+            *info = -5;
+        } else if (n[i] < 0) {
+            *info = -6;
+        } else if (k[i] < 0 || k[i] > nq) {
+            *info = -7;
+        } else if (ldv[i] < (storev == MagmaColumnwise ? max(1,nq) : max(1,k[i]))) {
+            *info = -9;
+        } else if (ldt[i] < max(1,k[i])) {
+            *info = -11;
+        } else if (ldc[i] < max(1,m[i])) {
+            *info = -13;
+        }
+        lwork = max( lwork, k[i] * (left ? n[i] : m[i]) );
+    }
+
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    // Quick return if possible
+    if (batchCount == 0) {
+        return *info;
+    }
+
+    magma_int_t nthread = max( 1, min( magma_get_parallel_numthreads(), batchCount ));
+    if (MAGMA_SUCCESS != magma_zmalloc_cpu( &work, lwork*nthread )) {
+        *info = MAGMA_ERR_HOST_ALLOC;
+        return *info;
+    }
+
+    #pragma omp parallel num_threads( nthread )
+    {
+        #ifdef _OPENMP
+        magma_int_t tid = omp_get_thread_num();
+        #else
+        magma_int_t tid = 0;
+        #endif
+        magmaDoubleComplex *W = work + tid*lwork;
+        int saved = zlarfb_blas_local_begin();
+
+        #pragma omp for schedule(dynamic)
+        for (magma_int_t i = 0; i < batchCount; ++i) {
+            if (m[i] > 0 && n[i] > 0 && k[i] > 0) {
+                zlarfb_tile( side, trans, direct, storev, m[i], n[i], k[i],
+                             V_array[i], ldv[i], T_array[i], ldt[i],
+                             C_array[i], ldc[i], W );
+            }
+        }
+
+        zlarfb_blas_local_end( saved );
+    }
+
+    magma_free_cpu( work );
+
+    return *info;
+}
@@ -0,0 +1,375 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c
+*/
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(MAGMA_WITH_MKL)
+#include <mkl_service.h>
+#endif
+
+#include "magma_internal.h"
+
+// block size of the tiled solve
+const magma_int_t latrs3d_nb = 64;
+
+
+/******************************************************************************/
+// Inside the parallel region, each thread calls sequential BLAS on its tiles.
+static int zlatrs3d_blas_local_begin()
+{
+    #if defined(MAGMA_WITH_MKL)
+    return mkl_set_num_threads_local( 1 );
+    #else
+    return 0;
+    #endif
+}
+
+static void zlatrs3d_blas_local_end( int saved )
+{
+    #if defined(MAGMA_WITH_MKL)
+    mkl_set_num_threads_local( saved );
+    #endif
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZLATRS3D solves one of the triangular systems with modified diagonals
+       (T - lambda(j)*I)    * X(:,j) = scale(j)*B(:,j),
+       (T - lambda(j)*I)**T * X(:,j) = scale(j)*B(:,j),  or
+       (T - lambda(j)*I)**H * X(:,j) = scale(j)*B(:,j),
+    for j = 1, ..., nrhs, with scaling to prevent overflow. Here T is an
+    upper triangular matrix, each right-hand side has its own shift
+    lambda(j), and scale(j) <= 1 is chosen so that the components of X(:,j)
+    stay below the overflow threshold.
+
+    This is the blocked, multiple right-hand side version of zlatrsd,
+    following the robust triangular solve of Mikkelsen and Karlsson
+    (LAPACK's zlatrs3). T is cut into nb-by-nb tiles. The diagonal tiles
+    are solved one right-hand side at a time with zlatrsd; the off-diagonal
+    tiles update all right-hand sides with zgemm. Each tile of each
+    right-hand side keeps its own scale factor, and before each update
+    magma_dlarmm picks the factor that keeps the update from overflowing.
+    The local factors are reconciled at the end into scale(j).
+
+    The right-hand sides are solved in parallel on the diagonal tiles, and
+    the updates in parallel over the tile rows, by nthread OpenMP threads.
+    It does not modify T during the computation.
+
+    Arguments
+    ---------
+    @param[in]
+    trans   magma_trans_t
+            Specifies the operation applied to T.
+      -     = MagmaNoTrans:    Solve (T - lambda*I)    * X = B*diag(scale)
+      -     = MagmaTrans:      Solve (T - lambda*I)**T * X = B*diag(scale)
+      -     = MagmaConjTrans:  Solve (T - lambda*I)**H * X = B*diag(scale)
+
+    @param[in]
+    n       INTEGER
+            The order of the matrix T. n >= 0.
+
+    @param[in]
+    nrhs    INTEGER
+            The number of right-hand sides. nrhs >= 0.
+
+    @param[in]
+    T       COMPLEX_16 array, dimension (ldt,n)
+            The upper triangular matrix T. The strictly lower triangular
+            part of T is not referenced.
+
+    @param[in]
+    ldt     INTEGER
+            The leading dimension of the array T. ldt >= max(1,n).
+
+    @param[in]
+    lambda  COMPLEX_16 array, dimension (nrhs)
+            The shift lambda(j) subtracted from the diagonal of T for the
+            j-th right-hand side.
+
+    @param[in,out]
+    X       COMPLEX_16 array, dimension (ldx,nrhs)
+            On entry, the right-hand sides B.
+            On exit, the solutions X.
+
+    @param[in]
+    ldx     INTEGER
+            The leading dimension of the array X. ldx >= max(1,n).
+
+    @param[out]
+    scale   DOUBLE PRECISION array, dimension (nrhs)
+            The scaling factor scale(j) of the j-th system.
+            If scale(j) = 0, then either T - lambda(j)*I is singular and
+            X(:,j) is a non-trivial solution of the homogeneous system, as
+            in zlatrsd, or the solution is too large to be represented as
+            X(:,j)/scale(j) and X(:,j) is set to zero, as in LAPACK's zlatrs3.
+
+    @param[in]
+    nthread INTEGER
+            Number of threads to use. nthread >= 1.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if info = -k, the k-th argument had an illegal value
+
+    @ingroup magma_latrs3d
+*******************************************************************************/
+extern "C"
+magma_int_t magma_zlatrs3d(
+    magma_trans_t trans, magma_int_t n, magma_int_t nrhs,
+    const magmaDoubleComplex *T, magma_int_t ldt,
+    const magmaDoubleComplex *lambda,
+    magmaDoubleComplex *X, magma_int_t ldx,
+    double *scale,
+    magma_int_t nthread,
+    magma_int_t *info )
+{
+    #define      T(i_, j_)  (T      + (i_) + (j_)*ldt)
+    #define      X(i_, j_)  (X      + (i_) + (j_)*ldx)
+    #define lscale(i_, j_)  (lscale + (i_) + (j_)*nba)
+
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magma_int_t ione = 1;
+    const magma_int_t nb = latrs3d_nb;
+
+    magma_int_t notran, nba, j, k;
+    double smlnum, bignum;
+    double *cnorm = NULL, *lscale = NULL, *xnrm = NULL;
+    magmaDoubleComplex *work = NULL;
+
+    notran = (trans == MagmaNoTrans);
+
+    *info = 0;
+    if ( ! notran && trans != MagmaTrans && trans != MagmaConjTrans ) {
+        *info = -1;
+    }
+    else if ( n < 0 ) {
+        *info = -2;
+    }
+    else if ( nrhs < 0 ) {
+        *info = -3;
+    }
+    else if ( ldt < max(1,n) ) {
+        *info = -5;
+    }
+    else if ( ldx < max(1,n) ) {
+        *info = -8;
+    }
+    else if ( nthread < 1 ) {
+        *info = -10;
+    }
+
+    if ( *info != 0 ) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    for( k=0; k < nrhs; ++k ) {
+        scale[k] = 1.;
+    }
+
+    // Quick return if possible
+    if ( n == 0 || nrhs == 0 ) {
+        return *info;
+    }
+
+    smlnum = lapackf77_dlamch( "Safe minimum" );
+    bignum = 1. / smlnum;
+
+    nba = magma_ceildiv( n, nb );
+    if ( MAGMA_SUCCESS != magma_dmalloc_cpu( &cnorm,  n )        ||
+         MAGMA_SUCCESS != magma_dmalloc_cpu( &lscale, nba*nrhs ) ||
+         MAGMA_SUCCESS != magma_dmalloc_cpu( &xnrm,   nrhs )     ||
+         MAGMA_SUCCESS != magma_zmalloc_cpu( &work,   nthread*nb*nrhs ))
+    {
+        *info = MAGMA_ERR_HOST_ALLOC;
+        goto cleanup;
+    }
+
+    // 1-norms of the columns of the strictly upper triangle of each
+    // diagonal tile, for zlatrsd.
+    for( j=0; j < n; ++j ) {
+        magma_int_t j1 = (j / nb)*nb;
+        cnorm[j] = magma_cblas_dzasum( j - j1, T(j1,j), ione );
+    }
+    for( k=0; k < nba*nrhs; ++k ) {
+        lscale[k] = 1.;
+    }
+
+    #pragma omp parallel num_threads( nthread )
+    {
+        int saved = zlatrs3d_blas_local_begin();
+        #ifdef _OPENMP
+        magma_int_t tid = omp_get_thread_num();
+        #else
+        magma_int_t tid = 0;
+        #endif
+        magmaDoubleComplex *W = work + tid*nb*nrhs;
+        double dwork[ latrs3d_nb+1 ];  // for zlange "I"
+
+        // NoTrans goes up the tiles, [Conj]Trans down.
+        for( magma_int_t jj=0; jj < nba; ++jj ) {
+            magma_int_t J  = (notran ? nba-1-jj : jj);
+            magma_int_t j1 = J*nb;
+            magma_int_t jb = min( nb, n-j1 );
+
+            // Solve the diagonal tile for each right-hand side.
+            #pragma omp for schedule(dynamic)
+            for( magma_int_t kk=0; kk < nrhs; ++kk ) {
+                magma_int_t iinfo;
+                double sloc;
+                magma_zlatrsd( MagmaUpper, trans, MagmaNonUnit, MagmaTrue, jb,
+                               T(j1,j1), ldt, lambda[kk], X(j1,kk),
+                               &sloc, &cnorm[j1], &iinfo );
+                if ( sloc == 0. ) {
+                    // The tile is singular. zlatrsd found a solution of the
+                    // homogeneous tile system; extend it by zeros and solve
+                    // the homogeneous system in the remaining tiles.
+                    scale[kk] = 0.;
+                    for( magma_int_t i=0; i < n; ++i ) {
+                        if ( i < j1 || i >= j1+jb ) {
+                            *X(i,kk) = MAGMA_Z_ZERO;
+                        }
+                    }
+                    for( magma_int_t I=0; I < nba; ++I ) {
+                        *lscale(I,kk) = 1.;
+                    }
+                    sloc = 1.;
+                }
+                else if ( sloc * (*lscale(J,kk)) == 0. ) {
+                    // The combined scale factor underflows. Keep the
+                    // smallest one and move the rest into x if it fits;
+                    // otherwise the solution cannot be represented and is
+                    // set to zero, with scale 0, as in LAPACK's zlatrs3.
+                    sloc *= *lscale(J,kk) / smlnum;
+                    *lscale(J,kk) = smlnum;
+                    double rscal = 1. / sloc;
+                    double xn = lapackf77_zlange( "I", &jb, &ione, X(j1,kk), &ldx, dwork );
+                    if ( xn * rscal <= bignum ) {
+                        blasf77_zdscal( &jb, &rscal, X(j1,kk), &ione );
+                    }
+                    else {
+                        scale[kk] = 0.;
+                        for( magma_int_t i=0; i < n; ++i ) {
+                            *X(i,kk) = MAGMA_Z_ZERO;
+                        }
+                        for( magma_int_t I=0; I < nba; ++I ) {
+                            *lscale(I,kk) = 1.;
+                        }
+                    }
+                    sloc = 1.;
+                }
+                *lscale(J,kk) *= sloc;
+                xnrm[kk] = lapackf77_zlange( "I", &jb, &ione, X(j1,kk), &ldx, dwork );
+            }
+
+            // Update the tiles that remain to be solved:
+            // NoTrans:   X(I) -= T(I,J)    * X(J) for I < J,
+            // otherwise: X(I) -= T(J,I)**H * X(J) for I > J.
+            magma_int_t nrem = (notran ? J : nba-1-J);
+            #pragma omp for schedule(dynamic)
+            for( magma_int_t ii=0; ii < nrem; ++ii ) {
+                magma_int_t I  = (notran ? J-1-ii : J+1+ii);
+                magma_int_t i1 = I*nb;
+                magma_int_t ib = min( nb, n-i1 );
+                double anrm;
+                if ( notran ) {
+                    anrm = lapackf77_zlange( "I", &ib, &jb, T(i1,j1), &ldt, dwork );
+                }
+                else {
+                    anrm = lapackf77_zlange( "1", &jb, &ib, T(j1,i1), &ldt, dwork );
+                }
+
+                // Bring X(I) and X(J) to a common scale at which the update
+                // cannot overflow. X(J) is shared by all tiles I, so if it
+                // has to be scaled down for this tile, use a scaled copy.
+                bool copy = false;
+                for( magma_int_t kk=0; kk < nrhs; ++kk ) {
+                    double scamin = min( *lscale(I,kk), *lscale(J,kk) );
+                    double bnrm = lapackf77_zlange( "I", &ib, &ione, X(i1,kk), &ldx, dwork );
+                    bnrm *= scamin / *lscale(I,kk);
+                    double xn = xnrm[kk] * (scamin / *lscale(J,kk));
+                    scamin *= magma_dlarmm( anrm, xn, bnrm );
+                    double rscal = scamin / *lscale(I,kk);
+                    if ( rscal != 1. ) {
+                        blasf77_zdscal( &ib, &rscal, X(i1,kk), &ione );
+                    }
+                    *lscale(I,kk) = scamin;
+                    if ( scamin != *lscale(J,kk) ) {
+                        copy = true;
+                    }
+                }
+
+                const magmaDoubleComplex *B = X(j1,0);
+                magma_int_t ldb = ldx;
+                if ( copy ) {
+                    lapackf77_zlacpy( "F", &jb, &nrhs, X(j1,0), &ldx, W, &jb );
+                    for( magma_int_t kk=0; kk < nrhs; ++kk ) {
+                        double rscal = *lscale(I,kk) / *lscale(J,kk);
+                        if ( rscal != 1. ) {
+                            blasf77_zdscal( &jb, &rscal, &W[kk*jb], &ione );
+                        }
+                    }
+                    B = W;
+                    ldb = jb;
+                }
+
+                if ( notran ) {
+                    blasf77_zgemm( "N", "N", &ib, &nrhs, &jb,
+                                   &c_neg_one, T(i1,j1), &ldt,
+                                               B, &ldb,
+                                   &c_one,     X(i1,0), &ldx );
+                }
+                else {
+                    blasf77_zgemm( lapack_trans_const(trans), "N", &ib, &nrhs, &jb,
+                                   &c_neg_one, T(j1,i1), &ldt,
+                                               B, &ldb,
+                                   &c_one,     X(i1,0), &ldx );
+                }
+            }
+        }
+        zlatrs3d_blas_local_end( saved );
+    }
+
+    // Reduce the local scale factors to one per right-hand side.
+    for( k=0; k < nrhs; ++k ) {
+        double smin = *lscale(0,k);
+        for( magma_int_t I=1; I < nba; ++I ) {
+            smin = min( smin, *lscale(I,k) );
+        }
+        for( magma_int_t I=0; I < nba; ++I ) {
+            double rscal = smin / *lscale(I,k);
+            if ( rscal != 1. ) {
+                magma_int_t i1 = I*nb;
+                magma_int_t ib = min( nb, n-i1 );
+                blasf77_zdscal( &ib, &rscal, X(i1,k), &ione );
+            }
+        }
+        if ( scale[k] != 0. ) {
+            scale[k] = smin;
+        }
+    }
+
+cleanup:
+    magma_free_cpu( cnorm );
+    magma_free_cpu( lscale );
+    magma_free_cpu( xnrm );
+    magma_free_cpu( work );
+
+    return *info;
+
+    #undef T
+    #undef X
+    #undef lscale
+}
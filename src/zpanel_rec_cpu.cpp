@@ -0,0 +1,792 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+       Recursive, multithreaded panel factorizations on the CPU:
+       LU with partial pivoting, Householder QR with its T factor, and
+       Cholesky. These replace the LAPACK calls that factor the panels of the
+       hybrid magma_zgetrf, magma_zgeqrf, and magma_zpotrf;
+       see magma_get_panel_numthreads.
+*/
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(MAGMA_WITH_MKL)
+#include <mkl_service.h>
+#endif
+
+#include "magma_internal.h"
+
+#define A(i_, j_)  (A + (i_) + (j_)*lda)
+#define T(i_, j_)  (T + (i_) + (j_)*ldt)
+
+// tile size for the Cholesky trsm and trailing matrix update tasks
+static const magma_int_t chol_tile_nb = 64;
+
+// Cholesky blocks of this size or smaller are factored by LAPACK
+static const magma_int_t chol_leaf_nb = 32;
+
+
+/******************************************************************************/
+// State shared by the thread team factoring one LU or QR panel.
+// The m rows of the panel are split into nthreads contiguous blocks;
+// thread t always works on block t, so it stays in that thread's cache.
+typedef struct {
+    magma_int_t nthreads;
+    magma_int_t m;
+    magma_int_t mb;             // rows per thread
+    double      *amax;          // LU: per-thread pivot candidate, |.|_1
+    magma_int_t *imax;          // LU: and its row
+    magmaDoubleComplex *W;      // QR: per-thread n-by-n products, and the reduction
+    magmaDoubleComplex *R;      // QR: saved upper triangle of a block of V
+    magma_int_t info;
+} zpanel_team_t;
+
+
+/******************************************************************************/
+// Rows [*lo, *hi) of block tid that are at or below row0.
+static void zpanel_rows(
+    const zpanel_team_t *team, magma_int_t tid, magma_int_t row0,
+    magma_int_t *lo, magma_int_t *hi )
+{
+    *lo = max( row0, tid*team->mb );
+    *hi = min( team->m, (tid+1)*team->mb );
+    if (*hi < *lo) {
+        *hi = *lo;
+    }
+}
+
+
+/******************************************************************************/
+// Sets up the team of nthreads threads for m rows. Each thread needs
+// about an L2 cache worth of rows for the row blocks to pay off.
+static void zpanel_team_init(
+    zpanel_team_t *team, magma_int_t m, magma_int_t nthreads )
+{
+    if (nthreads <= 0) {
+        nthreads = magma_get_parallel_numthreads();
+    }
+    nthreads = max( 1, min( nthreads, m / 128 ));
+    team->nthreads = nthreads;
+    team->m        = m;
+    team->mb       = magma_roundup( magma_ceildiv( m, nthreads ), 8 );
+    team->amax     = NULL;
+    team->imax     = NULL;
+    team->W        = NULL;
+    team->R        = NULL;
+    team->info     = 0;
+}
+
+
+/******************************************************************************/
+// The team calls single-threaded BLAS on its row blocks. OpenMP BLAS
+// libraries already run single-threaded inside an active parallel region;
+// MKL is told so per thread, leaving its global setting untouched.
+static int zpanel_blas_local_begin()
+{
+    #if defined(MAGMA_WITH_MKL)
+    return mkl_set_num_threads_local( 1 );
+    #else
+    return 0;
+    #endif
+}
+
+static void zpanel_blas_local_end( int saved )
+{
+    #if defined(MAGMA_WITH_MKL)
+    mkl_set_num_threads_local( saved );
+    #endif
+}
+
+
+/******************************************************************************/
+// Recursive LU of columns [k, k+nk) of the m-by-n panel, with rows swapped
+// across the whole panel width. Splits the columns in halves; the trsm of
+// A12 is small and done by thread 0, the gemm update of A22 by each thread
+// on its row block. For a single column, each thread searches its own rows
+// for the pivot, then all threads reduce the candidates in the same order,
+// so they agree on the pivot without another barrier.
+// Called by every thread of the team; ends with a barrier.
+static void zgetrf_rec_team(
+    zpanel_team_t *team, magma_int_t tid,
+    magma_int_t n, magma_int_t k, magma_int_t nk,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magma_int_t *ipiv )
+{
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    magma_int_t lo, hi;
+
+    if (nk == 1) {
+        zpanel_rows( team, tid, k, &lo, &hi );
+        double amax = -1;
+        magma_int_t imax = -1;
+        for (magma_int_t i = lo; i < hi; ++i) {
+            double v = MAGMA_Z_ABS1( *A(i, k) );
+            if (v > amax) {
+                amax = v;
+                imax = i;
+            }
+        }
+        team->amax[tid] = amax;
+        team->imax[tid] = imax;
+        #pragma omp barrier
+
+        // first largest, as izamax
+        magma_int_t p = k;
+        amax = -1;
+        for (magma_int_t t = 0; t < team->nthreads; ++t) {
+            if (team->imax[t] >= 0 && team->amax[t] > amax) {
+                amax = team->amax[t];
+                p    = team->imax[t];
+            }
+        }
+        if (tid == 0) {
+            ipiv[k] = p + 1;
+            if (p != k) {
+                blasf77_zswap( &n, A(k, 0), &lda, A(p, 0), &lda );
+            }
+            if (amax == 0 && team->info == 0) {
+                team->info = k + 1;
+            }
+        }
+        #pragma omp barrier
+
+        // scale column k below the diagonal
+        if (amax != 0) {
+            const double sfmin = lapackf77_dlamch("S");
+            magmaDoubleComplex pivot = *A(k, k);
+            zpanel_rows( team, tid, k+1, &lo, &hi );
+            if (MAGMA_Z_ABS( pivot ) >= sfmin) {
+                magmaDoubleComplex rpivot = MAGMA_Z_DIV( c_one, pivot );
+                for (magma_int_t i = lo; i < hi; ++i) {
+                    *A(i, k) *= rpivot;
+                }
+            }
+            else {
+                for (magma_int_t i = lo; i < hi; ++i) {
+                    *A(i, k) = MAGMA_Z_DIV( *A(i, k), pivot );
+                }
+            }
+        }
+        #pragma omp barrier
+        return;
+    }
+
+    magma_int_t n1 = nk / 2;
+    magma_int_t n2 = nk - n1;
+    zgetrf_rec_team( team, tid, n, k, n1, A, lda, ipiv );
+
+    // A12 = L11^{-1} A12
+    if (tid == 0) {
+        blasf77_ztrsm( MagmaLeftStr, MagmaLowerStr, MagmaNoTransStr, MagmaUnitStr,
+                       &n1, &n2,
+                       &c_one, A(k, k),    &lda,
+                               A(k, k+n1), &lda );
+    }
+    #pragma omp barrier
+
+    // A22 -= A21 A12, by row blocks
+    zpanel_rows( team, tid, k+n1, &lo, &hi );
+    magma_int_t mt = hi - lo;
+    if (mt > 0) {
+        blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &mt, &n2, &n1,
+                       &c_neg_one, A(lo, k),    &lda,
+                                   A(k,  k+n1), &lda,
+                       &c_one,     A(lo, k+n1), &lda );
+    }
+    #pragma omp barrier
+
+    zgetrf_rec_team( team, tid, n, k+n1, n2, A, lda, ipiv );
+}
+
+
+/******************************************************************************/
+// Sets the nb-by-nb block A to unit lower triangular, saving its
+// upper triangle and diagonal in R; or restores them if restore.
+static void zpanel_unit_lower(
+    bool restore, magma_int_t nb,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magmaDoubleComplex *R )
+{
+    for (magma_int_t j = 0; j < nb; ++j) {
+        for (magma_int_t i = 0; i <= j; ++i) {
+            if (restore) {
+                *A(i, j) = R[ i + j*nb ];
+            }
+            else {
+                R[ i + j*nb ] = *A(i, j);
+                *A(i, j) = (i == j ? MAGMA_Z_ONE : MAGMA_Z_ZERO);
+            }
+        }
+    }
+}
+
+
+/******************************************************************************/
+// W0 = sum over threads of X(rows)^H Y(rows), for X m-by-p and Y m-by-q
+// starting at row row0; each thread multiplies its row block, thread 0
+// adds the products. W0 is p-by-q in team->W.
+// Called by every thread of the team; ends with a barrier.
+static void zpanel_team_gemm_reduce(
+    zpanel_team_t *team, magma_int_t tid, magma_int_t row0,
+    magma_int_t p, magma_int_t q, magma_int_t wsize,
+    const magmaDoubleComplex *X, const magmaDoubleComplex *Y, magma_int_t lda )
+{
+    const magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    magma_int_t lo, hi;
+
+    magmaDoubleComplex *Wt = team->W + tid*wsize;
+    zpanel_rows( team, tid, row0, &lo, &hi );
+    magma_int_t mt = hi - lo;
+    if (mt > 0) {
+        blasf77_zgemm( MagmaConjTransStr, MagmaNoTransStr, &p, &q, &mt,
+                       &c_one,  X + lo - row0, &lda,
+                                Y + lo - row0, &lda,
+                       &c_zero, Wt, &p );
+    }
+    else {
+        lapackf77_zlaset( MagmaFullStr, &p, &q, &c_zero, &c_zero, Wt, &p );
+    }
+    #pragma omp barrier
+
+    if (tid == 0) {
+        for (magma_int_t t = 1; t < team->nthreads; ++t) {
+            magmaDoubleComplex *Ws = team->W + t*wsize;
+            for (magma_int_t i = 0; i < p*q; ++i) {
+                Wt[i] += Ws[i];
+            }
+        }
+    }
+    #pragma omp barrier
+}
+
+
+/******************************************************************************/
+// Recursive QR of columns [k, k+nk) of the m-by-n panel (Elmroth and
+// Gustavson), forming T(k:k+nk, k:k+nk) on the way, so no zlarft is needed:
+//     T = [ T1  -T1 (V1^H V2) T2 ]
+//         [ 0    T2              ].
+// The products with V are taken by row blocks and reduced by
+// zpanel_team_gemm_reduce. The Householder vector of a single column is
+// generated by thread 0.
+// Called by every thread of the team; ends with a barrier.
+static void zgeqrf_rec_team(
+    zpanel_team_t *team, magma_int_t tid,
+    magma_int_t n, magma_int_t k, magma_int_t nk,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magmaDoubleComplex *tau,
+    magmaDoubleComplex *T, magma_int_t ldt )
+{
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    const magma_int_t ione = 1;
+    magma_int_t lo, hi;
+    magma_int_t m = team->m;
+    magma_int_t wsize = n*n;
+
+    if (nk == 1) {
+        if (tid == 0) {
+            magma_int_t rows = m - k;
+            lapackf77_zlarfg( &rows, A(k, k), A(min(k+1, m-1), k), &ione, &tau[k] );
+            *T(k, k) = tau[k];
+        }
+        #pragma omp barrier
+        return;
+    }
+
+    magma_int_t n1 = nk / 2;
+    magma_int_t n2 = nk - n1;
+    zgeqrf_rec_team( team, tid, n, k, n1, A, lda, tau, T, ldt );
+
+    // A2 = H1^H A2 = A2 - V1 T1^H (V1^H A2)
+    if (tid == 0) {
+        zpanel_unit_lower( false, n1, A(k, k), lda, team->R );
+    }
+    #pragma omp barrier
+    zpanel_team_gemm_reduce( team, tid, k, n1, n2, wsize, A(k, k), A(k, k+n1), lda );
+    if (tid == 0) {
+        blasf77_ztrmm( MagmaLeftStr, MagmaUpperStr, MagmaConjTransStr, MagmaNonUnitStr,
+                       &n1, &n2, &c_one, T(k, k), &ldt, team->W, &n1 );
+    }
+    #pragma omp barrier
+
+    zpanel_rows( team, tid, k, &lo, &hi );
+    magma_int_t mt = hi - lo;
+    if (mt > 0) {
+        blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &mt, &n2, &n1,
+                       &c_neg_one, A(lo, k),    &lda,
+                                   team->W,     &n1,
+                       &c_one,     A(lo, k+n1), &lda );
+    }
+    #pragma omp barrier
+    if (tid == 0) {
+        zpanel_unit_lower( true, n1, A(k, k), lda, team->R );
+    }
+
+    zgeqrf_rec_team( team, tid, n, k+n1, n2, A, lda, tau, T, ldt );
+
+    // T12 = -T1 (V1^H V2) T2; rows k:k+n1 of V2 are zero
+    if (tid == 0) {
+        zpanel_unit_lower( false, n2, A(k+n1, k+n1), lda, team->R );
+    }
+    #pragma omp barrier
+    zpanel_team_gemm_reduce( team, tid, k+n1, n1, n2, wsize, A(k+n1, k), A(k+n1, k+n1), lda );
+    if (tid == 0) {
+        zpanel_unit_lower( true, n2, A(k+n1, k+n1), lda, team->R );
+        lapackf77_zlacpy( MagmaFullStr, &n1, &n2, team->W, &n1, T(k, k+n1), &ldt );
+        blasf77_ztrmm( MagmaLeftStr, MagmaUpperStr, MagmaNoTransStr, MagmaNonUnitStr,
+                       &n1, &n2, &c_neg_one, T(k, k),       &ldt, T(k, k+n1), &ldt );
+        blasf77_ztrmm( MagmaRightStr, MagmaUpperStr, MagmaNoTransStr, MagmaNonUnitStr,
+                       &n1, &n2, &c_one,     T(k+n1, k+n1), &ldt, T(k, k+n1), &ldt );
+    }
+    #pragma omp barrier
+}
+
+
+/******************************************************************************/
+// Recursive Cholesky of the n-by-n matrix A. Splits A = [ A11 A12; A21 A22 ]
+// in halves; the trsm and the herk/gemm trailing update are split into tiles
+// that run as OpenMP tasks. Blocks up to chol_leaf_nb go to LAPACK.
+// Must be called from within an OpenMP single region, or serially.
+static magma_int_t zpotrf_rec(
+    magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda )
+{
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    const double d_one     =  1.0;
+    const double d_neg_one = -1.0;
+    magma_int_t info;
+
+    if (n <= chol_leaf_nb) {
+        lapackf77_zpotrf( lapack_uplo_const(uplo), &n, A, &lda, &info );
+        return info;
+    }
+
+    magma_int_t n1 = n / 2;
+    magma_int_t n2 = n - n1;
+
+    info = zpotrf_rec( uplo, n1, A, lda );
+    if (info != 0) {
+        return info;
+    }
+
+    if (uplo == MagmaLower) {
+        // A21 = A21 L11^{-H}
+        for (magma_int_t i = 0; i < n2; i += chol_tile_nb) {
+            #pragma omp task
+            {
+                magma_int_t ib = min( chol_tile_nb, n2 - i );
+                blasf77_ztrsm( MagmaRightStr, MagmaLowerStr, MagmaConjTransStr, MagmaNonUnitStr,
+                               &ib, &n1,
+                               &c_one, A(0, 0),    &lda,
+                                       A(n1+i, 0), &lda );
+            }
+        }
+        #pragma omp taskwait
+
+        // A22 -= A21 A21^H, lower triangle
+        for (magma_int_t j = 0; j < n2; j += chol_tile_nb) {
+            for (magma_int_t i = j; i < n2; i += chol_tile_nb) {
+                #pragma omp task
+                {
+                    magma_int_t ib = min( chol_tile_nb, n2 - i );
+                    magma_int_t jb = min( chol_tile_nb, n2 - j );
+                    if (i == j) {
+                        blasf77_zherk( MagmaLowerStr, MagmaNoTransStr, &jb, &n1,
+                                       &d_neg_one, A(n1+j, 0),    &lda,
+                                       &d_one,     A(n1+j, n1+j), &lda );
+                    }
+                    else {
+                        blasf77_zgemm( MagmaNoTransStr, MagmaConjTransStr, &ib, &jb, &n1,
+                                       &c_neg_one, A(n1+i, 0),    &lda,
+                                                   A(n1+j, 0),    &lda,
+                                       &c_one,     A(n1+i, n1+j), &lda );
+                    }
+                }
+            }
+        }
+        #pragma omp taskwait
+    }
+    else {
+        // A12 = U11^{-H} A12
+        for (magma_int_t j = 0; j < n2; j += chol_tile_nb) {
+            #pragma omp task
+            {
+                magma_int_t jb = min( chol_tile_nb, n2 - j );
+                blasf77_ztrsm( MagmaLeftStr, MagmaUpperStr, MagmaConjTransStr, MagmaNonUnitStr,
+                               &n1, &jb,
+                               &c_one, A(0, 0),    &lda,
+                                       A(0, n1+j), &lda );
+            }
+        }
+        #pragma omp taskwait
+
+        // A22 -= A12^H A12, upper triangle
+        for (magma_int_t j = 0; j < n2; j += chol_tile_nb) {
+            for (magma_int_t i = 0; i <= j; i += chol_tile_nb) {
+                #pragma omp task
+                {
+                    magma_int_t ib = min( chol_tile_nb, n2 - i );
+                    magma_int_t jb = min( chol_tile_nb, n2 - j );
+                    if (i == j) {
+                        blasf77_zherk( MagmaUpperStr, MagmaConjTransStr, &jb, &n1,
+                                       &d_neg_one, A(0,    n1+j), &lda,
+                                       &d_one,     A(n1+j, n1+j), &lda );
+                    }
+                    else {
+                        blasf77_zgemm( MagmaConjTransStr, MagmaNoTransStr, &ib, &jb, &n1,
+                                       &c_neg_one, A(0,    n1+i), &lda,
+                                                   A(0,    n1+j), &lda,
+                                       &c_one,     A(n1+i, n1+j), &lda );
+                    }
+                }
+            }
+        }
+        #pragma omp taskwait
+    }
+
+    info = zpotrf_rec( uplo, n2, A(n1, n1), lda );
+    if (info != 0) {
+        info += n1;
+    }
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZGETRF_REC_CPU computes an LU factorization of a general M-by-N matrix A
+    using partial pivoting with row interchanges, on the CPU:
+        A = P * L * U.
+    It is a drop-in replacement for lapackf77_zgetrf, intended for the tall
+    and skinny panels of the hybrid magma_zgetrf.
+
+    The columns are split recursively in halves. The rows are split into
+    contiguous blocks, one per thread of an OpenMP team, and each thread
+    updates and searches for pivots only in its own block, which stays in
+    its cache (as the PLASMA recursive panel). Each thread calls
+    single-threaded BLAS; the global BLAS thread setting is not changed.
+
+    Arguments
+    ---------
+    @param[in]
+    m       INTEGER
+            The number of rows of the matrix A.  M >= 0.
+
+    @param[in]
+    n       INTEGER
+            The number of columns of the matrix A.  N >= 0.
+
+    @param[in,out]
+    A       COMPLEX_16 array, dimension (LDA,N)
+            On entry, the M-by-N matrix to be factored.
+            On exit, the factors L and U from the factorization
+            A = P*L*U; the unit diagonal elements of L are not stored.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A.  LDA >= max(1,M).
+
+    @param[out]
+    ipiv    INTEGER array, dimension (min(M,N))
+            The pivot indices; for 1 <= i <= min(M,N), row i of the
+            matrix was interchanged with row IPIV(i).
+
+    @param[in]
+    nthreads INTEGER
+            Number of threads in the team. If nthreads <= 0, uses
+            magma_get_parallel_numthreads(). Fewer are used for small M.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+                  or another error occured, such as memory allocation failed.
+      -     > 0:  if INFO = i, U(i,i) is exactly zero. The factorization
+                  has been completed, but the factor U is exactly
+                  singular, and division by zero will occur if it is used
+                  to solve a system of equations.
+
+    @ingroup magma_getrf_comp
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zgetrf_rec_cpu(
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magma_int_t *ipiv,
+    magma_int_t nthreads,
+    magma_int_t *info)
+{
+    *info = 0;
+    if (m < 0) {
+        *info = -1;
+    } else if (n < 0) {
+        *info = -2;
+    } else if (lda < max(1,m)) {
+        *info = -4;
+    }
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    if (m == 0 || n == 0) {
+        return *info;
+    }
+
+    zpanel_team_t team;
+    zpanel_team_init( &team, m, nthreads );
+    if (MAGMA_SUCCESS != magma_dmalloc_cpu( &team.amax, team.nthreads ) ||
+        MAGMA_SUCCESS != magma_imalloc_cpu( &team.imax, team.nthreads )) {
+        magma_free_cpu( team.amax );
+        magma_free_cpu( team.imax );
+        *info = MAGMA_ERR_HOST_ALLOC;
+        return *info;
+    }
+
+    // for m < n, factor the left m-by-m block, then U12 = L11^{-1} A12
+    magma_int_t min_mn = min( m, n );
+
+    #pragma omp parallel num_threads( team.nthreads )
+    {
+        int saved = zpanel_blas_local_begin();
+        #ifdef _OPENMP
+        magma_int_t tid = omp_get_thread_num();
+        #else
+        magma_int_t tid = 0;
+        #endif
+        zgetrf_rec_team( &team, tid, n, 0, min_mn, A, lda, ipiv );
+        zpanel_blas_local_end( saved );
+    }
+
+    if (n > m) {
+        const magmaDoubleComplex c_one = MAGMA_Z_ONE;
+        magma_int_t n2 = n - m;
+        blasf77_ztrsm( MagmaLeftStr, MagmaLowerStr, MagmaNoTransStr, MagmaUnitStr,
+                       &m, &n2,
+                       &c_one, A(0, 0), &lda,
+                               A(0, m), &lda );
+    }
+
+    *info = team.info;
+    magma_free_cpu( team.amax );
+    magma_free_cpu( team.imax );
+    return *info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZGEQRF_REC_CPU computes a QR factorization of a complex M-by-N matrix A,
+    M >= N, on the CPU:
+        A = Q * R,
+    together with the upper triangular factor T of the block reflector
+        Q = H(1) H(2) . . . H(n) = I - V T V^H.
+    It replaces lapackf77_zgeqrf followed by lapackf77_zlarft
+    (forward, columnwise), for the tall and skinny panels of the hybrid
+    magma_zgeqrf.
+
+    The columns are split recursively in halves (Elmroth and Gustavson),
+    and T is built from the T of each half as the recursion returns.
+    The rows are split into contiguous blocks, one per thread of an OpenMP
+    team, as in magma_zgetrf_rec_cpu.
+
+    Arguments
+    ---------
+    @param[in]
+    m       INTEGER
+            The number of rows of the matrix A.  M >= N.
+
+    @param[in]
+    n       INTEGER
+            The number of columns of the matrix A.  N >= 0.
+
+    @param[in,out]
+    A       COMPLEX_16 array, dimension (LDA,N)
+            On entry, the M-by-N matrix A.
+            On exit, R and the Householder vectors V, as from zgeqrf.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A.  LDA >= max(1,M).
+
+    @param[out]
+    tau     COMPLEX_16 array, dimension (N)
+            The scalar factors of the elementary reflectors.
+
+    @param[out]
+    T       COMPLEX_16 array, dimension (LDT,N)
+            The N-by-N upper triangular factor of the block reflector,
+            as from zlarft. The strictly lower triangle is not referenced.
+
+    @param[in]
+    ldt     INTEGER
+            The leading dimension of the array T.  LDT >= max(1,N).
+
+    @param[in]
+    nthreads INTEGER
+            Number of threads in the team. If nthreads <= 0, uses
+            magma_get_parallel_numthreads(). Fewer are used for small M.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+                  or another error occured, such as memory allocation failed.
+
+    @ingroup magma_geqrf_comp
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zgeqrf_rec_cpu(
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magmaDoubleComplex *tau,
+    magmaDoubleComplex *T, magma_int_t ldt,
+    magma_int_t nthreads,
+    magma_int_t *info)
+{
+    *info = 0;
+    if (m < 0) {
+        *info = -1;
+    } else if (n < 0 || n > m) {
+        *info = -2;
+    } else if (lda < max(1,m)) {
+        *info = -4;
+    } else if (ldt < max(1,n)) {
+        *info = -7;
+    }
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    if (n == 0) {
+        return *info;
+    }
+
+    zpanel_team_t team;
+    zpanel_team_init( &team, m, nthreads );
+    // W holds one n-by-n product per thread; R one n-by-n block of V
+    if (MAGMA_SUCCESS != magma_zmalloc_cpu( &team.W, (team.nthreads + 1)*n*n )) {
+        *info = MAGMA_ERR_HOST_ALLOC;
+        return *info;
+    }
+    team.R = team.W + team.nthreads*n*n;
+
+    #pragma omp parallel num_threads( team.nthreads )
+    {
+        int saved = zpanel_blas_local_begin();
+        #ifdef _OPENMP
+        magma_int_t tid = omp_get_thread_num();
+        #else
+        magma_int_t tid = 0;
+        #endif
+        zgeqrf_rec_team( &team, tid, n, 0, n, A, lda, tau, T, ldt );
+        zpanel_blas_local_end( saved );
+    }
+
+    magma_free_cpu( team.W );
+    return *info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZPOTRF_REC_CPU computes the Cholesky factorization of a complex
+    Hermitian positive definite matrix A, on the CPU:
+        A = U^H * U,  if UPLO = MagmaUpper, or
+        A = L  * L^H, if UPLO = MagmaLower.
+    It is a drop-in replacement for lapackf77_zpotrf, intended for the
+    diagonal blocks of the hybrid magma_zpotrf.
+
+    The matrix is split recursively in halves. The triangular solve and the
+    trailing update are split into tiles that run as OpenMP tasks on a team
+    of nthreads threads, each calling single-threaded BLAS; the global BLAS
+    thread setting is not changed.
+
+    Arguments
+    ---------
+    @param[in]
+    uplo    magma_uplo_t
+      -     = MagmaUpper:  Upper triangle of A is stored;
+      -     = MagmaLower:  Lower triangle of A is stored.
+
+    @param[in]
+    n       INTEGER
+            The order of the matrix A.  N >= 0.
+
+    @param[in,out]
+    A       COMPLEX_16 array, dimension (LDA,N)
+            On entry, the Hermitian matrix A.
+            On exit, if INFO = 0, the factor U or L.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A.  LDA >= max(1,N).
+
+    @param[in]
+    nthreads INTEGER
+            Number of threads in the team. If nthreads <= 0, uses
+            magma_get_parallel_numthreads().
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+      -     > 0:  if INFO = i, the leading minor of order i is not
+                  positive definite, and the factorization could not be
+                  completed.
+
+    @ingroup magma_potrf_comp
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zpotrf_rec_cpu(
+    magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magma_int_t nthreads,
+    magma_int_t *info)
+{
+    *info = 0;
+    if (uplo != MagmaUpper && uplo != MagmaLower) {
+        *info = -1;
+    } else if (n < 0) {
+        *info = -2;
+    } else if (lda < max(1,n)) {
+        *info = -4;
+    }
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    if (n == 0) {
+        return *info;
+    }
+
+    if (nthreads <= 0) {
+        nthreads = magma_get_parallel_numthreads();
+    }
+
+    #pragma omp parallel num_threads( nthreads )
+    {
+        int saved = zpanel_blas_local_begin();
+        #pragma omp single
+        {
+            *info = zpotrf_rec( uplo, n, A, lda );
+        }
+        zpanel_blas_local_end( saved );
+    }
+    return *info;
+}
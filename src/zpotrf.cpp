@@ -145,6 +145,9 @@ magma_zpotrf(
         magma_queue_create( cdev, &queues[0] );
         magma_queue_create( cdev, &queues[1] );
         
+        /* CPU diagonal blocks use the recursive version, if enabled */
+        magma_int_t nthread_panel = magma_get_panel_numthreads();
+        
         if (upper) {
             /* Compute the Cholesky factorization A = U'*U. */
             for (j=0; j < n; j += nb) {
@@ -179,7 +182,10 @@ magma_zpotrf(
                                         dA(0, j), ldda,
                                          A(0, j), lda, queues[0] );
                 
-                lapackf77_zpotrf( MagmaUpperStr, &jb, A(j, j), &lda, info );
+                if (nthread_panel > 0)
+                    magma_zpotrf_rec_cpu( MagmaUpper, jb, A(j, j), lda, nthread_panel, info );
+                else
+                    lapackf77_zpotrf( MagmaUpperStr, &jb, A(j, j), &lda, info );
                 if (*info != 0) {
                     *info = *info + j;
                     break;
@@ -232,7 +238,10 @@ magma_zpotrf(
                                         dA(j, 0), ldda,
                                          A(j, 0), lda, queues[0] );
                 
-                lapackf77_zpotrf( MagmaLowerStr, &jb, A(j, j), &lda, info );
+                if (nthread_panel > 0)
+                    magma_zpotrf_rec_cpu( MagmaLower, jb, A(j, j), lda, nthread_panel, info );
+                else
+                    lapackf77_zpotrf( MagmaLowerStr, &jb, A(j, j), &lda, info );
                 if (*info != 0) {
                     *info = *info + j;
                     break;
@@ -0,0 +1,242 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+#include "magma_internal.h"
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZPOTRF_OOC_CPU computes the Cholesky factorization of a complex Hermitian
+    positive definite matrix A, stored out-of-core in a file, so A may exceed
+    the host memory.
+
+    The factorization has the form
+       A = U**H * U,   if UPLO = MagmaUpper, or
+       A = L  * L**H,  if UPLO = MagmaLower,
+    where U is an upper triangular matrix and L is lower triangular.
+
+    This is a left-looking algorithm on block columns (slabs), as wide as
+    the memory budget allows. Each slab is read into host memory, updated by
+    all previous block columns, which are read one NB-wide panel at a time,
+    factored with LAPACK and Level 3 BLAS, and written back. Reading the next
+    panel overlaps updating with the current one. Since the factored part
+    shrinks (MagmaLower) or the slabs get taller (MagmaUpper), slab widths
+    change as the factorization proceeds.
+
+    Arguments
+    ---------
+    @param[in]
+    uplo    magma_uplo_t
+      -     = MagmaUpper:  Upper triangle of A is stored;
+      -     = MagmaLower:  Lower triangle of A is stored.
+
+    @param[in,out]
+    A       Out-of-core N-by-N matrix of COMPLEX_16 elements,
+            created by magma_ooc_create, with tile size NB.
+            On entry, the Hermitian matrix A. If UPLO = MagmaUpper, the upper
+            triangular part of A contains the upper triangular part of the
+            matrix A, and the strictly lower triangular part of A is not
+            referenced. If UPLO = MagmaLower, the lower triangular part of
+            A contains the lower triangular part of the matrix A, and the
+            strictly upper triangular part of A is not referenced.
+    \n
+            On exit, if INFO = 0, the factor U or L from the Cholesky
+            factorization A = U**H * U or A = L * L**H.
+
+    @param[in]
+    mem_budget  SIZE_T
+            Bytes of host memory to use for the slab and panel, in addition
+            to the tile cache of A. MEM_BUDGET >= 2*N*NB*sizeof(COMPLEX_16).
+            A larger budget gives wider slabs, so fewer reads of previous
+            block columns.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+                  or another error occured, such as memory allocation failed
+                  or a file error (MAGMA_ERR_FILESYSTEM).
+      -     > 0:  if INFO = i, the leading minor of order i is not
+                  positive definite, and the factorization could not be
+                  completed.
+
+    @ingroup magma_potrf
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zpotrf_ooc_cpu(
+    magma_uplo_t uplo, magma_ooc_t A, size_t mem_budget,
+    magma_int_t *info )
+{
+    #define B(i_, j_) (B + (i_) + (j_)*ldb)
+    #define P(i_, j_) (P + (i_) + (j_)*ldp)
+
+    /* Constants */
+    const double d_one     =  1.0;
+    const double d_neg_one = -1.0;
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+
+    /* Local variables */
+    magmaDoubleComplex *work, *B, *P;
+    magma_int_t m, n, nb, j, jb, k, next, rows, ldb, ldp, iinfo;
+    size_t elemsize, budget;
+    bool upper = (uplo == MagmaUpper);
+
+    *info = 0;
+    if (A != NULL) {
+        magma_ooc_getsize( A, &m, &n, &nb, &elemsize );
+    }
+    budget = mem_budget / sizeof(magmaDoubleComplex);
+    if (! upper && uplo != MagmaLower) {
+        *info = -1;
+    } else if (A == NULL || elemsize != sizeof(magmaDoubleComplex) || m != n) {
+        *info = -2;
+    } else if (budget < 2*size_t(n)*nb) {
+        *info = -3;
+    }
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    /* Quick return */
+    if (n == 0)
+        return *info;
+
+    // the largest slab, plus a panel, needs at most n*(n + nb)
+    budget = min( budget, size_t(n)*(n + nb) );
+    if (MAGMA_SUCCESS != magma_zmalloc_cpu( &work, budget )) {
+        *info = MAGMA_ERR_HOST_ALLOC;
+        return *info;
+    }
+
+    for (j = 0; j < n && *info == 0; j += jb) {
+        // widest slab that fits in the budget, in multiples of nb:
+        // lower: (n-j)-by-jb slab + (n-j)-by-nb panel;
+        // upper: (j+jb)-by-jb slab + j-by-nb panel
+        jb = min( nb, n - j );
+        while (jb < n - j) {
+            next = min( jb + nb, n - j );
+            if (upper ? size_t(j + next)*next + size_t(j)*nb > budget
+                      : size_t(n - j)*(next + nb)        > budget)
+                break;
+            jb = next;
+        }
+
+        if (upper) {
+            //=========================================================
+            // slab A(0:j+jb, j:j+jb)
+            rows = j + jb;
+            ldb  = rows;
+            B    = work;
+            P    = work + size_t(ldb)*jb;
+            iinfo = magma_ooc_getmatrix( rows, jb, A, 0, j, B, ldb );
+            for (k = 0; k < j && iinfo == 0; k += nb) {
+                // panel U(0:k+nb, k:k+nb); read ahead the next one
+                ldp = k + nb;
+                iinfo = magma_ooc_getmatrix( ldp, nb, A, 0, k, P, ldp );
+                if (iinfo != 0)
+                    break;
+                if (k + nb < j) {
+                    magma_ooc_prefetch( k + 2*nb, nb, A, 0, k + nb );
+                }
+                // B(k:k+nb, :) = U(k,k)^{-H} ( B(k:k+nb, :) - U(0:k, k)^H B(0:k, :) )
+                if (k > 0) {
+                    blasf77_zgemm( MagmaConjTransStr, MagmaNoTransStr, &nb, &jb, &k,
+                                   &c_neg_one, P(0, 0), &ldp,
+                                               B(0, 0), &ldb,
+                                   &c_one,     B(k, 0), &ldb );
+                }
+                blasf77_ztrsm( MagmaLeftStr, MagmaUpperStr, MagmaConjTransStr, MagmaNonUnitStr,
+                               &nb, &jb, &c_one, P(k, 0), &ldp, B(k, 0), &ldb );
+            }
+            if (iinfo != 0) {
+                *info = iinfo;
+                break;
+            }
+            if (j + jb < n) {
+                magma_ooc_prefetch( j + jb + nb, nb, A, 0, j + jb );
+            }
+            // diagonal block
+            if (j > 0) {
+                blasf77_zherk( MagmaUpperStr, MagmaConjTransStr, &jb, &j,
+                               &d_neg_one, B(0, 0), &ldb,
+                               &d_one,     B(j, 0), &ldb );
+            }
+            lapackf77_zpotrf( MagmaUpperStr, &jb, B(j, 0), &ldb, &iinfo );
+            if (iinfo != 0) {
+                *info = iinfo + j;
+            }
+            iinfo = magma_ooc_setmatrix( rows, jb, B, ldb, A, 0, j );
+        }
+        else {
+            //=========================================================
+            // slab A(j:n, j:j+jb)
+            rows = n - j;
+            ldb  = rows;
+            ldp  = rows;
+            B    = work;
+            P    = work + size_t(ldb)*jb;
+            iinfo = magma_ooc_getmatrix( rows, jb, A, j, j, B, ldb );
+            if (j > 0) {
+                magma_ooc_prefetch( rows, nb, A, j, 0 );
+            }
+            for (k = 0; k < j && iinfo == 0; k += nb) {
+                // panel L(j:n, k:k+nb); read ahead the next one
+                iinfo = magma_ooc_getmatrix( rows, nb, A, j, k, P, ldp );
+                if (iinfo != 0)
+                    break;
+                if (k + nb < j) {
+                    magma_ooc_prefetch( rows, nb, A, j, k + nb );
+                }
+                // B -= L(j:n, k:k+nb) L(j:j+jb, k:k+nb)^H
+                blasf77_zherk( MagmaLowerStr, MagmaNoTransStr, &jb, &nb,
+                               &d_neg_one, P(0, 0), &ldp,
+                               &d_one,     B(0, 0), &ldb );
+                if (rows > jb) {
+                    magma_int_t mb = rows - jb;
+                    blasf77_zgemm( MagmaNoTransStr, MagmaConjTransStr, &mb, &jb, &nb,
+                                   &c_neg_one, P(jb, 0), &ldp,
+                                               P(0,  0), &ldp,
+                                   &c_one,     B(jb, 0), &ldb );
+                }
+            }
+            if (iinfo != 0) {
+                *info = iinfo;
+                break;
+            }
+            if (j + jb < n) {
+                magma_ooc_prefetch( rows - jb, nb, A, j + jb, j + jb );
+            }
+            lapackf77_zpotrf( MagmaLowerStr, &jb, B(0, 0), &ldb, &iinfo );
+            if (iinfo != 0) {
+                *info = iinfo + j;
+            }
+            else if (rows > jb) {
+                magma_int_t mb = rows - jb;
+                blasf77_ztrsm( MagmaRightStr, MagmaLowerStr, MagmaConjTransStr, MagmaNonUnitStr,
+                               &mb, &jb, &c_one, B(0, 0), &ldb, B(jb, 0), &ldb );
+            }
+            iinfo = magma_ooc_setmatrix( rows, jb, B, ldb, A, j, j );
+        }
+        if (iinfo != 0) {
+            *info = iinfo;
+        }
+    }
+
+    iinfo = magma_ooc_flush( A );
+    if (iinfo != 0) {
+        *info = iinfo;
+    }
+
+    magma_free_cpu( work );
+
+    return *info;
+} /* magma_zpotrf_ooc_cpu */
@@ -0,0 +1,195 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+#include "magma_internal.h"
+
+
+/******************************************************************************/
+// Replaces the m-by-l matrix Y (m >= l) by an orthonormal basis of its range,
+// with a blocked Householder QR and generation of Q.
+static void zrangefinder_orth(
+    magma_int_t m, magma_int_t l,
+    magmaDoubleComplex *Y, magma_int_t ldy,
+    magmaDoubleComplex *tau, magmaDoubleComplex *work, magma_int_t lwork )
+{
+    magma_int_t info;
+    lapackf77_zgeqrf( &m, &l, Y, &ldy, tau, work, &lwork, &info );
+    lapackf77_zungqr( &m, &l, &l, Y, &ldy, tau, work, &lwork, &info );
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZRANGEFINDER computes an M-by-L matrix Q with orthonormal columns whose
+    range approximates the range of the M-by-N matrix A, so that
+    A ~= Q Q^H A, using a randomized range finder with power iterations:
+
+        Q = orth( A S ),
+        repeat niter times:
+            Z = orth( A^H Q ),
+            Q = orth( A Z ),
+
+    where S is an N-by-L random sketch (see magma_zsketch). The sketch and
+    the products with A are single GEMMs, and each intermediate basis is
+    re-orthonormalized with a blocked Householder QR, so no information about
+    the smaller singular values is lost in floating point. Each power
+    iteration sharpens the decay of the singular values seen by the sketch,
+    from sigma_i to sigma_i^(2 niter + 1).
+
+    See N. Halko, P. G. Martinsson, J. Tropp, "Finding structure with
+    randomness: Probabilistic algorithms for constructing approximate matrix
+    decompositions", SIAM Review, 2011, Algorithm 4.4.
+
+    Arguments
+    ---------
+    @param[in]
+    sketch  magma_sketch_t
+            The kind of random sketch S; see magma_zsketch.
+
+    @param[in]
+    m       INTEGER
+            The number of rows of the matrix A. M >= 0.
+
+    @param[in]
+    n       INTEGER
+            The number of columns of the matrix A. N >= 0.
+
+    @param[in]
+    l       INTEGER
+            The number of columns of Q. 0 <= L <= min(M,N).
+            Typically L = k + p for a target rank k and a small
+            oversampling p, such as 10.
+
+    @param[in]
+    niter   INTEGER
+            The number of power iterations. NITER >= 0.
+            One or two are usually enough for slowly decaying singular values.
+
+    @param[in]
+    A       COMPLEX_16 array, dimension (LDA,N)
+            The M-by-N matrix A.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A. LDA >= max(1,M).
+
+    @param[out]
+    Q       COMPLEX_16 array, dimension (LDQ,L)
+            The M-by-L orthonormal basis.
+
+    @param[in]
+    ldq     INTEGER
+            The leading dimension of the array Q. LDQ >= max(1,M).
+
+    @param[in,out]
+    iseed   INTEGER array, dimension (4)
+            The seed of the random number generator; see magma_zsketch.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+                  or another error occured, such as memory allocation failed.
+
+    @ingroup magma_rangefinder
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zrangefinder(
+    magma_sketch_t sketch,
+    magma_int_t m, magma_int_t n, magma_int_t l, magma_int_t niter,
+    const magmaDoubleComplex *A, magma_int_t lda,
+    magmaDoubleComplex *Q, magma_int_t ldq,
+    magma_int_t *iseed,
+    magma_int_t *info )
+{
+    const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    const magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    const magma_int_t ineg_one = -1;
+
+    magma_int_t lwork, iter;
+    magmaDoubleComplex *Z = NULL, *tau = NULL, *work = NULL, query[1];
+
+    *info = 0;
+    if ( sketch != MagmaSketchGaussian && sketch != MagmaSketchSparseSign ) {
+        *info = -1;
+    } else if ( m < 0 ) {
+        *info = -2;
+    } else if ( n < 0 ) {
+        *info = -3;
+    } else if ( l < 0 || l > min(m,n) ) {
+        *info = -4;
+    } else if ( niter < 0 ) {
+        *info = -5;
+    } else if ( lda < max(1,m) ) {
+        *info = -7;
+    } else if ( ldq < max(1,m) ) {
+        *info = -9;
+    }
+
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    // Quick return if possible
+    if ( l == 0 ) {
+        return *info;
+    }
+
+    // workspace for QR and generation of Q, of m-by-l and n-by-l matrices
+    lapackf77_zgeqrf( &m, &l, Q, &ldq, NULL, query, &ineg_one, info );
+    lwork = magma_int_t( MAGMA_Z_REAL( query[0] ));
+    lapackf77_zungqr( &m, &l, &l, Q, &ldq, NULL, query, &ineg_one, info );
+    lwork = max( lwork, magma_int_t( MAGMA_Z_REAL( query[0] )));
+    if ( niter > 0 ) {
+        lapackf77_zgeqrf( &n, &l, Q, &n, NULL, query, &ineg_one, info );
+        lwork = max( lwork, magma_int_t( MAGMA_Z_REAL( query[0] )));
+        lapackf77_zungqr( &n, &l, &l, Q, &n, NULL, query, &ineg_one, info );
+        lwork = max( lwork, magma_int_t( MAGMA_Z_REAL( query[0] )));
+    }
+    *info = 0;
+
+    if (MAGMA_SUCCESS != magma_zmalloc_cpu( &tau,  l     ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &work, lwork ) ||
+        (niter > 0 && MAGMA_SUCCESS != magma_zmalloc_cpu( &Z, n*l )))
+    {
+        *info = MAGMA_ERR_HOST_ALLOC;
+        goto cleanup;
+    }
+
+    // Q = orth( A S )
+    magma_zsketch( sketch, MagmaRight, m, n, l, A, lda, Q, ldq, iseed, info );
+    if (*info != 0) {
+        goto cleanup;
+    }
+    zrangefinder_orth( m, l, Q, ldq, tau, work, lwork );
+
+    for( iter=0; iter < niter; ++iter ) {
+        // Z = orth( A^H Q )
+        blasf77_zgemm( "ConjTrans", "NoTrans", &n, &l, &m,
+                       &c_one,  A, &lda, Q, &ldq,
+                       &c_zero, Z, &n );
+        zrangefinder_orth( n, l, Z, n, tau, work, lwork );
+
+        // Q = orth( A Z )
+        blasf77_zgemm( "NoTrans", "NoTrans", &m, &l, &n,
+                       &c_one,  A, &lda, Z, &n,
+                       &c_zero, Q, &ldq );
+        zrangefinder_orth( m, l, Q, ldq, tau, work, lwork );
+    }
+
+cleanup:
+    magma_free_cpu( Z );
+    magma_free_cpu( tau );
+    magma_free_cpu( work );
+
+    return *info;
+} /* magma_zrangefinder */
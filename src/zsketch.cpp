@@ -0,0 +1,252 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+#include "magma_internal.h"
+
+// number of nonzeros per column of a sparse sign sketch
+#define SPARSE_SIGN_NNZ 8
+
+// row block size for applying a sparse sign sketch from the right
+#define SPARSE_SIGN_MB 256
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZSKETCH applies a random sketching matrix S to the M-by-N matrix A:
+
+        Y = S A,   S is L-by-M,   Y is L-by-N,   if side = MagmaLeft;
+        Y = A S,   S is N-by-L,   Y is M-by-L,   if side = MagmaRight.
+
+    S is not returned. Two kinds of sketch are supported:
+
+    A Gaussian sketch has independent normal(0,1) entries (real and imaginary
+    parts, in complex), and is applied with one GEMM.
+
+    A sparse sign sketch has min(8, L) nonzeros of value +-1/sqrt(min(8, L))
+    in each column (left) or row (right), in distinct random positions.
+    It costs O(M N) instead of O(L M N) to apply, at the price of a
+    slightly weaker embedding; see
+    J. Tropp, A. Yurtsever, M. Udell, V. Cevher, "Streaming low-rank matrix
+    approximation with an application to scientific simulation",
+    SIAM J. Sci. Comput., 2019.
+
+    Arguments
+    ---------
+    @param[in]
+    sketch  magma_sketch_t
+      -     = MagmaSketchGaussian:    Gaussian sketch.
+      -     = MagmaSketchSparseSign:  sparse sign sketch.
+
+    @param[in]
+    side    magma_side_t
+      -     = MagmaLeft:   Y = S A.
+      -     = MagmaRight:  Y = A S.
+
+    @param[in]
+    m       INTEGER
+            The number of rows of the matrix A. M >= 0.
+
+    @param[in]
+    n       INTEGER
+            The number of columns of the matrix A. N >= 0.
+
+    @param[in]
+    l       INTEGER
+            The sketch size: the number of rows of Y if side = MagmaLeft,
+            the number of columns of Y if side = MagmaRight. L >= 0.
+
+    @param[in]
+    A       COMPLEX_16 array, dimension (LDA,N)
+            The M-by-N matrix A.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A. LDA >= max(1,M).
+
+    @param[out]
+    Y       COMPLEX_16 array, dimension (LDY,N) if side = MagmaLeft,
+            (LDY,L) if side = MagmaRight.
+            On exit, the sketch of A.
+
+    @param[in]
+    ldy     INTEGER
+            The leading dimension of the array Y.
+            LDY >= max(1,L) if side = MagmaLeft,
+            LDY >= max(1,M) if side = MagmaRight.
+
+    @param[in,out]
+    iseed   INTEGER array, dimension (4)
+            On entry, the seed of the random number generator, as in
+            LAPACK's zlarnv; the array elements must be between 0 and 4095,
+            and iseed(4) must be odd.
+            On exit, the seed is updated.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+                  or another error occured, such as memory allocation failed.
+
+    @ingroup magma_sketch
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zsketch(
+    magma_sketch_t sketch, magma_side_t side,
+    magma_int_t m, magma_int_t n, magma_int_t l,
+    const magmaDoubleComplex *A, magma_int_t lda,
+    magmaDoubleComplex *Y, magma_int_t ldy,
+    magma_int_t *iseed,
+    magma_int_t *info )
+{
+    #define A(i_, j_)  (A + (i_) + (j_)*lda)
+    #define Y(i_, j_)  (Y + (i_) + (j_)*ldy)
+
+    const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    const magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    const magma_int_t idist_uniform = 1, idist_normal = 3;
+
+    magma_int_t k, ks, nnz, size;
+    magmaDoubleComplex *S = NULL;
+    magma_int_t *idx = NULL;
+    double *sgn = NULL, *u = NULL, scal;
+
+    *info = 0;
+    bool left = (side == MagmaLeft);
+    if ( sketch != MagmaSketchGaussian && sketch != MagmaSketchSparseSign ) {
+        *info = -1;
+    } else if ( ! left && side != MagmaRight ) {
+        *info = -2;
+    } else if ( m < 0 ) {
+        *info = -3;
+    } else if ( n < 0 ) {
+        *info = -4;
+    } else if ( l < 0 ) {
+        *info = -5;
+    } else if ( lda < max(1,m) ) {
+        *info = -7;
+    } else if ( ldy < max(1, (left ? l : m)) ) {
+        *info = -9;
+    }
+
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    // Quick return if possible
+    if ( m == 0 || n == 0 || l == 0 ) {
+        if ( left )
+            lapackf77_zlaset( "F", &l, &n, &c_zero, &c_zero, Y, &ldy );
+        else
+            lapackf77_zlaset( "F", &m, &l, &c_zero, &c_zero, Y, &ldy );
+        return *info;
+    }
+
+    // k is the dimension that is compressed to l
+    k = (left ? m : n);
+
+    if ( sketch == MagmaSketchGaussian ) {
+        // S is l-by-m (left) or n-by-l (right)
+        size = l*k;
+        if (MAGMA_SUCCESS != magma_zmalloc_cpu( &S, size )) {
+            *info = MAGMA_ERR_HOST_ALLOC;
+            return *info;
+        }
+        lapackf77_zlarnv( &idist_normal, iseed, &size, S );
+        if ( left ) {
+            blasf77_zgemm( "NoTrans", "NoTrans", &l, &n, &m,
+                           &c_one,  S, &l, A, &lda,
+                           &c_zero, Y, &ldy );
+        }
+        else {
+            blasf77_zgemm( "NoTrans", "NoTrans", &m, &l, &n,
+                           &c_one,  A, &lda, S, &n,
+                           &c_zero, Y, &ldy );
+        }
+        magma_free_cpu( S );
+        return *info;
+    }
+
+    // Sparse sign: nnz distinct positions and signs per index of the
+    // compressed dimension, from 2*nnz uniform(0,1) numbers each.
+    nnz  = min( l, magma_int_t( SPARSE_SIGN_NNZ ));
+    scal = 1. / magma_dsqrt( double( nnz ));
+    size = 2*nnz*k;
+    if (MAGMA_SUCCESS != magma_imalloc_cpu( &idx, nnz*k ) ||
+        MAGMA_SUCCESS != magma_dmalloc_cpu( &sgn, nnz*k ) ||
+        MAGMA_SUCCESS != magma_dmalloc_cpu( &u,   size  ))
+    {
+        *info = MAGMA_ERR_HOST_ALLOC;
+        goto cleanup;
+    }
+    lapackf77_dlarnv( &idist_uniform, iseed, &size, u );
+    for( magma_int_t i=0; i < k; ++i ) {
+        magma_int_t *ix = idx + i*nnz;
+        for( ks=0; ks < nnz; ++ks ) {
+            magma_int_t r = min( l-1, magma_int_t( u[2*(i*nnz + ks)] * l ));
+            // linear probing keeps the positions distinct
+            for( magma_int_t t=0; t < ks; ) {
+                if ( ix[t] == r ) {
+                    r = (r + 1) % l;
+                    t = 0;
+                }
+                else {
+                    ++t;
+                }
+            }
+            ix[ks] = r;
+            sgn[i*nnz + ks] = (u[2*(i*nnz + ks) + 1] < 0.5 ? -scal : scal);
+        }
+    }
+
+    if ( left ) {
+        lapackf77_zlaset( "F", &l, &n, &c_zero, &c_zero, Y, &ldy );
+        // each column of Y depends only on the same column of A
+        #pragma omp parallel for schedule(static)
+        for( magma_int_t j=0; j < n; ++j ) {
+            for( magma_int_t i=0; i < m; ++i ) {
+                magmaDoubleComplex a = *A(i,j);
+                for( magma_int_t t=0; t < nnz; ++t ) {
+                    *Y(idx[i*nnz + t], j) += sgn[i*nnz + t] * a;
+                }
+            }
+        }
+    }
+    else {
+        lapackf77_zlaset( "F", &m, &l, &c_zero, &c_zero, Y, &ldy );
+        // each block of rows of Y depends only on the same rows of A
+        #pragma omp parallel for schedule(static)
+        for( magma_int_t i0=0; i0 < m; i0 += SPARSE_SIGN_MB ) {
+            magma_int_t ib = min( m - i0, magma_int_t( SPARSE_SIGN_MB ));
+            for( magma_int_t j=0; j < n; ++j ) {
+                for( magma_int_t t=0; t < nnz; ++t ) {
+                    magmaDoubleComplex *y = Y(i0, idx[j*nnz + t]);
+                    const magmaDoubleComplex *a = A(i0, j);
+                    double s = sgn[j*nnz + t];
+                    #pragma omp simd
+                    for( magma_int_t i=0; i < ib; ++i ) {
+                        y[i] += s * a[i];
+                    }
+                }
+            }
+        }
+    }
+
+cleanup:
+    magma_free_cpu( idx );
+    magma_free_cpu( sgn );
+    magma_free_cpu( u );
+
+    return *info;
+
+    #undef A
+    #undef Y
+} /* magma_zsketch */
@@ -149,7 +149,7 @@ magma_zsytrf_nopiv_gpu(
             // factorize the diagonal block
             magma_queue_sync( queues[1] );
             trace_cpu_start( 0, "potrf", "potrf" );
-            magma_zsytrf_nopiv_cpu( MagmaUpper, jb, ib, A(j, j), nb, info );
+            magma_zsytrf_nopiv_rec_cpu( MagmaUpper, jb, ib, A(j, j), nb, info );
             trace_cpu_end( 0 );
             if (*info != 0) {
                 *info = *info + j;
@@ -207,7 +207,7 @@ magma_zsytrf_nopiv_gpu(
             // factorize the diagonal block
             magma_queue_sync( queues[1] );
             trace_cpu_start( 0, "potrf", "potrf" );
-            magma_zsytrf_nopiv_cpu( MagmaLower, jb, ib, A(j, j), nb, info );
+            magma_zsytrf_nopiv_rec_cpu( MagmaLower, jb, ib, A(j, j), nb, info );
             trace_cpu_end( 0 );
             if (*info != 0) {
                 *info = *info + j;
@@ -0,0 +1,550 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+       Cholesky, LU, and QR factorizations on the CPU of host matrices in
+       tile layout (magma_tile_t). The trailing matrix is updated one
+       contiguous tile at a time, each tile column by the thread that owns
+       it, so updates do not stride through memory with a large lda.
+*/
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(MAGMA_WITH_MKL)
+#include <mkl_service.h>
+#endif
+
+#include "magma_internal.h"
+
+#define P(i_, j_)  (P + (i_) + (j_)*ldp)
+
+
+/******************************************************************************/
+// Tile (i, j) of A, and its leading dimension in ldt.
+static inline magmaDoubleComplex* ztile(
+    magma_tile_t A, magma_int_t i, magma_int_t j, magma_int_t *ldt )
+{
+    return (magmaDoubleComplex*) magma_tile_ptr( A, i, j, ldt );
+}
+
+
+/******************************************************************************/
+// Inside a parallel region, each thread calls sequential BLAS on its tiles.
+// MKL is told so per thread; OpenMP builds of other BLAS libraries already
+// do not nest.
+static int ztile_blas_local_begin()
+{
+    #if defined(MAGMA_WITH_MKL)
+    return mkl_set_num_threads_local( 1 );
+    #else
+    return 0;
+    #endif
+}
+
+static void ztile_blas_local_end( int saved )
+{
+    #if defined(MAGMA_WITH_MKL)
+    mkl_set_num_threads_local( saved );
+    #endif
+}
+
+
+/******************************************************************************/
+// Copies tiles (k:mt, k) of A, rows k*nb to m, to or from the column-major
+// panel P, rows-by-jb with leading dimension ldp.
+static void ztile_panel_copy(
+    magma_tile_t A, magma_int_t k, magma_int_t jb,
+    magmaDoubleComplex *P, magma_int_t ldp, bool to_panel )
+{
+    magma_int_t m, nb, ldt;
+    magma_tile_getsize( A, &m, NULL, &nb, NULL );
+    for (magma_int_t i = k; i*nb < m; ++i) {
+        magma_int_t ib = min( nb, m - i*nb );
+        magmaDoubleComplex *T = ztile( A, i, k, &ldt );
+        if (to_panel)
+            lapackf77_zlacpy( MagmaFullStr, &ib, &jb, T, &ldt, P((i - k)*nb, 0), &ldp );
+        else
+            lapackf77_zlacpy( MagmaFullStr, &ib, &jb, P((i - k)*nb, 0), &ldp, T, &ldt );
+    }
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZPOTRF_TILE_CPU computes the Cholesky factorization of a complex
+    Hermitian positive definite matrix A, in tile layout, on the CPU:
+        A = U^H * U,  if UPLO = MagmaUpper, or
+        A = L  * L^H, if UPLO = MagmaLower.
+
+    This is the right-looking tile algorithm. At step k, diagonal tile
+    (k,k) is factored with LAPACK, the tiles of block column k (lower) or
+    block row k (upper) are solved with ztrsm, and the trailing tiles are
+    updated with zherk and zgemm, each tile column by the thread that owns
+    it (see magma_tile_create), with single-threaded BLAS.
+
+    Arguments
+    ---------
+    @param[in]
+    uplo    magma_uplo_t
+      -     = MagmaUpper:  Upper triangle of A is stored;
+      -     = MagmaLower:  Lower triangle of A is stored.
+
+    @param[in,out]
+    A       N-by-N tiled matrix of COMPLEX_16 elements.
+            On entry, the Hermitian matrix A; only the tiles on and below
+            (MagmaLower) or above (MagmaUpper) the diagonal, and the
+            corresponding triangle of the diagonal tiles, are referenced.
+            On exit, if INFO = 0, the factor U or L.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+      -     > 0:  if INFO = i, the leading minor of order i is not
+                  positive definite, and the factorization could not be
+                  completed.
+
+    @ingroup magma_potrf
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zpotrf_tile_cpu(
+    magma_uplo_t uplo, magma_tile_t A,
+    magma_int_t *info )
+{
+    const double d_one     =  1.0;
+    const double d_neg_one = -1.0;
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+
+    magma_int_t m, n, nb, nt;
+    size_t elemsize;
+    bool upper = (uplo == MagmaUpper);
+
+    *info = 0;
+    if (A != NULL) {
+        magma_tile_getsize( A, &m, &n, &nb, &elemsize );
+    }
+    if (! upper && uplo != MagmaLower) {
+        *info = -1;
+    } else if (A == NULL || elemsize != sizeof(magmaDoubleComplex) || m != n) {
+        *info = -2;
+    }
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    nt = magma_ceildiv( n, nb );
+    magma_int_t linfo = 0;  // shared; set by the owner of tile (k,k)
+
+    #pragma omp parallel num_threads( magma_tile_get_nthreads( A ))
+    {
+        #ifdef _OPENMP
+        magma_int_t tid  = omp_get_thread_num();
+        magma_int_t nthr = omp_get_num_threads();
+        #else
+        magma_int_t tid  = 0;
+        magma_int_t nthr = 1;
+        #endif
+        int saved = ztile_blas_local_begin();
+        magma_int_t ldkk, ldik, ldkj, ldij, ldjj;
+
+        for (magma_int_t k = 0; k < nt; ++k) {
+            magma_int_t kb = min( nb, n - k*nb );
+            magmaDoubleComplex *Akk = ztile( A, k, k, &ldkk );
+            if (k % nthr == tid) {
+                magma_int_t iinfo;
+                lapackf77_zpotrf( lapack_uplo_const( uplo ), &kb, Akk, &ldkk, &iinfo );
+                if (iinfo != 0) {
+                    linfo = iinfo + k*nb;
+                }
+            }
+            #pragma omp barrier
+            if (linfo != 0) {
+                break;
+            }
+
+            if (upper) {
+                // A(k, j) = U(k,k)^{-H} A(k, j), by the owner of column j
+                for (magma_int_t j = k+1; j < nt; ++j) {
+                    if (j % nthr == tid) {
+                        magma_int_t jb = min( nb, n - j*nb );
+                        magmaDoubleComplex *Akj = ztile( A, k, j, &ldkj );
+                        blasf77_ztrsm( MagmaLeftStr, MagmaUpperStr, MagmaConjTransStr, MagmaNonUnitStr,
+                                       &kb, &jb, &c_one, Akk, &ldkk, Akj, &ldkj );
+                    }
+                }
+                #pragma omp barrier
+                // A(i, j) -= A(k, i)^H A(k, j), for k < i <= j
+                for (magma_int_t j = k+1; j < nt; ++j) {
+                    if (j % nthr == tid) {
+                        magma_int_t jb = min( nb, n - j*nb );
+                        magmaDoubleComplex *Akj = ztile( A, k, j, &ldkj );
+                        magmaDoubleComplex *Ajj = ztile( A, j, j, &ldjj );
+                        blasf77_zherk( MagmaUpperStr, MagmaConjTransStr, &jb, &kb,
+                                       &d_neg_one, Akj, &ldkj,
+                                       &d_one,     Ajj, &ldjj );
+                        for (magma_int_t i = k+1; i < j; ++i) {
+                            magma_int_t ib = min( nb, n - i*nb );
+                            magmaDoubleComplex *Aki = ztile( A, k, i, &ldik );
+                            magmaDoubleComplex *Aij = ztile( A, i, j, &ldij );
+                            blasf77_zgemm( MagmaConjTransStr, MagmaNoTransStr, &ib, &jb, &kb,
+                                           &c_neg_one, Aki, &ldik,
+                                                       Akj, &ldkj,
+                                           &c_one,     Aij, &ldij );
+                        }
+                    }
+                }
+            }
+            else {
+                // A(i, k) = A(i, k) L(k,k)^{-H}, cyclically over tile rows
+                for (magma_int_t i = k+1; i < nt; ++i) {
+                    if (i % nthr == tid) {
+                        magma_int_t ib = min( nb, n - i*nb );
+                        magmaDoubleComplex *Aik = ztile( A, i, k, &ldik );
+                        blasf77_ztrsm( MagmaRightStr, MagmaLowerStr, MagmaConjTransStr, MagmaNonUnitStr,
+                                       &ib, &kb, &c_one, Akk, &ldkk, Aik, &ldik );
+                    }
+                }
+                #pragma omp barrier
+                // A(i, j) -= A(i, k) A(j, k)^H, for j <= i, by the owner of column j
+                for (magma_int_t j = k+1; j < nt; ++j) {
+                    if (j % nthr == tid) {
+                        magma_int_t jb = min( nb, n - j*nb );
+                        magmaDoubleComplex *Ajk = ztile( A, j, k, &ldkj );
+                        magmaDoubleComplex *Ajj = ztile( A, j, j, &ldjj );
+                        blasf77_zherk( MagmaLowerStr, MagmaNoTransStr, &jb, &kb,
+                                       &d_neg_one, Ajk, &ldkj,
+                                       &d_one,     Ajj, &ldjj );
+                        for (magma_int_t i = j+1; i < nt; ++i) {
+                            magma_int_t ib = min( nb, n - i*nb );
+                            magmaDoubleComplex *Aik = ztile( A, i, k, &ldik );
+                            magmaDoubleComplex *Aij = ztile( A, i, j, &ldij );
+                            blasf77_zgemm( MagmaNoTransStr, MagmaConjTransStr, &ib, &jb, &kb,
+                                           &c_neg_one, Aik, &ldik,
+                                                       Ajk, &ldkj,
+                                           &c_one,     Aij, &ldij );
+                        }
+                    }
+                }
+            }
+            #pragma omp barrier
+        }
+        ztile_blas_local_end( saved );
+    }
+
+    *info = linfo;
+    return *info;
+} /* magma_zpotrf_tile_cpu */
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZGETRF_TILE_CPU computes an LU factorization of a general M-by-N matrix
+    A, in tile layout, on the CPU, using partial pivoting with row
+    interchanges:
+        A = P * L * U.
+
+    At step k, the tiles of block column k below the diagonal are copied to
+    a column-major panel, factored by magma_zgetrf_rec_cpu, and copied back.
+    Then the owner of each other tile column (see magma_tile_create) applies
+    the row interchanges to it, and, right of the panel, solves its tile in
+    block row k with ztrsm and updates the tiles below it with zgemm.
+
+    Arguments
+    ---------
+    @param[in,out]
+    A       M-by-N tiled matrix of COMPLEX_16 elements.
+            On entry, the matrix to be factored.
+            On exit, the factors L and U from the factorization
+            A = P*L*U; the unit diagonal elements of L are not stored.
+
+    @param[out]
+    ipiv    INTEGER array, dimension (min(M,N))
+            The pivot indices; for 1 <= i <= min(M,N), row i of the
+            matrix was interchanged with row IPIV(i).
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+                  or another error occured, such as memory allocation failed.
+      -     > 0:  if INFO = i, U(i,i) is exactly zero. The factorization
+                  has been completed, but the factor U is exactly
+                  singular, and division by zero will occur if it is used
+                  to solve a system of equations.
+
+    @ingroup magma_getrf
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zgetrf_tile_cpu(
+    magma_tile_t A, magma_int_t *ipiv,
+    magma_int_t *info )
+{
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+
+    magmaDoubleComplex *P;
+    magma_int_t m, n, nb, mt, nt, minmn, nthreads, ldp, iinfo;
+    size_t elemsize;
+
+    *info = 0;
+    if (A != NULL) {
+        magma_tile_getsize( A, &m, &n, &nb, &elemsize );
+    }
+    if (A == NULL || elemsize != sizeof(magmaDoubleComplex)) {
+        *info = -1;
+    }
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    minmn = min( m, n );
+    if (minmn == 0)
+        return *info;
+
+    mt = magma_ceildiv( m, nb );
+    nt = magma_ceildiv( n, nb );
+    nthreads = magma_tile_get_nthreads( A );
+    ldp = m;
+    if (MAGMA_SUCCESS != magma_zmalloc_cpu( &P, size_t(ldp)*min( nb, n ))) {
+        *info = MAGMA_ERR_HOST_ALLOC;
+        return *info;
+    }
+
+    for (magma_int_t k = 0; k*nb < minmn; ++k) {
+        magma_int_t k0   = k*nb;
+        magma_int_t rows = m - k0;
+        magma_int_t jb   = min( nb, n - k0 );
+        magma_int_t npiv = min( rows, jb );
+
+        // factor the panel
+        ztile_panel_copy( A, k, jb, P, ldp, true );
+        magma_zgetrf_rec_cpu( rows, jb, P, ldp, ipiv + k0, nthreads, &iinfo );
+        if (iinfo > 0 && *info == 0) {
+            *info = iinfo + k0;
+        }
+        ztile_panel_copy( A, k, jb, P, ldp, false );
+        for (magma_int_t i = k0; i < k0 + npiv; ++i) {
+            ipiv[i] += k0;
+        }
+
+        #pragma omp parallel num_threads( nthreads )
+        {
+            #ifdef _OPENMP
+            magma_int_t tid  = omp_get_thread_num();
+            magma_int_t nthr = omp_get_num_threads();
+            #else
+            magma_int_t tid  = 0;
+            magma_int_t nthr = 1;
+            #endif
+            int saved = ztile_blas_local_begin();
+            magma_int_t ld1, ld2, ldkk, ldik, ldkj, ldij;
+
+            for (magma_int_t j = tid; j < nt; j += nthr) {
+                if (j == k) {
+                    continue;
+                }
+                magma_int_t jb2 = min( nb, n - j*nb );
+
+                // swap rows of tile column j
+                for (magma_int_t i = k0; i < k0 + npiv; ++i) {
+                    magma_int_t ip = ipiv[i] - 1;
+                    if (ip != i) {
+                        magmaDoubleComplex *r1 = ztile( A, i/nb,  j, &ld1 ) + i  % nb;
+                        magmaDoubleComplex *r2 = ztile( A, ip/nb, j, &ld2 ) + ip % nb;
+                        blasf77_zswap( &jb2, r1, &ld1, r2, &ld2 );
+                    }
+                }
+                if (j < k) {
+                    continue;
+                }
+
+                // A(k, j) = L(k,k)^{-1} A(k, j); A(i, j) -= A(i, k) A(k, j)
+                magmaDoubleComplex *Akk = ztile( A, k, k, &ldkk );
+                magmaDoubleComplex *Akj = ztile( A, k, j, &ldkj );
+                blasf77_ztrsm( MagmaLeftStr, MagmaLowerStr, MagmaNoTransStr, MagmaUnitStr,
+                               &npiv, &jb2, &c_one, Akk, &ldkk, Akj, &ldkj );
+                for (magma_int_t i = k+1; i < mt; ++i) {
+                    magma_int_t ib = min( nb, m - i*nb );
+                    magmaDoubleComplex *Aik = ztile( A, i, k, &ldik );
+                    magmaDoubleComplex *Aij = ztile( A, i, j, &ldij );
+                    blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &ib, &jb2, &npiv,
+                                   &c_neg_one, Aik, &ldik,
+                                               Akj, &ldkj,
+                                   &c_one,     Aij, &ldij );
+                }
+            }
+            ztile_blas_local_end( saved );
+        }
+    }
+
+    magma_free_cpu( P );
+    return *info;
+} /* magma_zgetrf_tile_cpu */
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZGEQRF_TILE_CPU computes a QR factorization of a complex M-by-N matrix
+    A, in tile layout, on the CPU:
+        A = Q * R.
+
+    At step k, the tiles of block column k below the diagonal are copied to
+    a column-major panel, factored by magma_zgeqrf_rec_cpu, which also forms
+    the triangular factor T of the block reflector, and copied back. Then
+    the owner of each tile column right of the panel (see magma_tile_create)
+    applies the block reflector to it, tile by tile:
+        W = V^H C,  W = T^H W,  C = C - V W.
+
+    Arguments
+    ---------
+    @param[in,out]
+    A       M-by-N tiled matrix of COMPLEX_16 elements.
+            On entry, the M-by-N matrix A.
+            On exit, the elements on and above the diagonal contain the
+            min(M,N)-by-N upper trapezoidal matrix R; the elements below the
+            diagonal, with the array TAU, represent the unitary matrix Q as
+            a product of min(M,N) elementary reflectors, as in zgeqrf.
+
+    @param[out]
+    tau     COMPLEX_16 array, dimension (min(M,N))
+            The scalar factors of the elementary reflectors.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+                  or another error occured, such as memory allocation failed.
+
+    @ingroup magma_geqrf
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zgeqrf_tile_cpu(
+    magma_tile_t A, magmaDoubleComplex *tau,
+    magma_int_t *info )
+{
+    const magmaDoubleComplex c_zero    = MAGMA_Z_ZERO;
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+
+    magmaDoubleComplex *P, *T, *work;
+    magma_int_t m, n, nb, mt, nt, minmn, nthreads, ldp, ldt, lwork, iinfo;
+    size_t elemsize;
+
+    *info = 0;
+    if (A != NULL) {
+        magma_tile_getsize( A, &m, &n, &nb, &elemsize );
+    }
+    if (A == NULL || elemsize != sizeof(magmaDoubleComplex)) {
+        *info = -1;
+    }
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    minmn = min( m, n );
+    if (minmn == 0)
+        return *info;
+
+    mt = magma_ceildiv( m, nb );
+    nt = magma_ceildiv( n, nb );
+    nthreads = magma_tile_get_nthreads( A );
+    ldp   = m;
+    ldt   = nb;
+    lwork = nb*nb;  // per thread W, and zgeqrf workspace for a wide last panel
+    if (MAGMA_SUCCESS != magma_zmalloc_cpu( &P,    size_t(ldp)*min( nb, n )) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &T,    ldt*nb ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &work, lwork*nthreads )) {
+        magma_free_cpu( P );
+        magma_free_cpu( T );
+        *info = MAGMA_ERR_HOST_ALLOC;
+        return *info;
+    }
+
+    for (magma_int_t k = 0; k*nb < minmn; ++k) {
+        magma_int_t k0   = k*nb;
+        magma_int_t rows = m - k0;
+        magma_int_t jb   = min( nb, n - k0 );
+        magma_int_t kb   = min( rows, jb );
+
+        // factor the panel, and form T
+        ztile_panel_copy( A, k, jb, P, ldp, true );
+        if (rows >= jb) {
+            magma_zgeqrf_rec_cpu( rows, jb, P, ldp, tau + k0, T, ldt, nthreads, &iinfo );
+        }
+        else {
+            // last tile row of a wide matrix
+            lapackf77_zgeqrf( &rows, &jb, P, &ldp, tau + k0, work, &lwork, &iinfo );
+            lapackf77_zlarft( MagmaForwardStr, MagmaColumnwiseStr, &rows, &kb,
+                              P, &ldp, tau + k0, T, &ldt );
+        }
+        ztile_panel_copy( A, k, jb, P, ldp, false );
+        if (k+1 >= nt) {
+            break;
+        }
+
+        // V, unit lower trapezoidal, in P
+        lapackf77_zlaset( MagmaUpperStr, &kb, &kb, &c_zero, &c_one, P, &ldp );
+
+        #pragma omp parallel num_threads( nthreads )
+        {
+            #ifdef _OPENMP
+            magma_int_t tid  = omp_get_thread_num();
+            magma_int_t nthr = omp_get_num_threads();
+            #else
+            magma_int_t tid  = 0;
+            magma_int_t nthr = 1;
+            #endif
+            int saved = ztile_blas_local_begin();
+            magmaDoubleComplex *W = work + tid*lwork;
+            magma_int_t ldw = kb, ldij;
+
+            for (magma_int_t j = tid; j < nt; j += nthr) {
+                if (j <= k) {
+                    continue;
+                }
+                magma_int_t jb2 = min( nb, n - j*nb );
+
+                // W = sum_i V_i^H C(i, j)
+                for (magma_int_t i = k; i < mt; ++i) {
+                    magma_int_t ib = min( nb, m - i*nb );
+                    magmaDoubleComplex *Aij = ztile( A, i, j, &ldij );
+                    blasf77_zgemm( MagmaConjTransStr, MagmaNoTransStr, &kb, &jb2, &ib,
+                                   &c_one, P((i - k)*nb, 0), &ldp,
+                                           Aij, &ldij,
+                                   (i == k ? &c_zero : &c_one), W, &ldw );
+                }
+                // W = T^H W
+                blasf77_ztrmm( MagmaLeftStr, MagmaUpperStr, MagmaConjTransStr, MagmaNonUnitStr,
+                               &kb, &jb2, &c_one, T, &ldt, W, &ldw );
+                // C(i, j) -= V_i W
+                for (magma_int_t i = k; i < mt; ++i) {
+                    magma_int_t ib = min( nb, m - i*nb );
+                    magmaDoubleComplex *Aij = ztile( A, i, j, &ldij );
+                    blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &ib, &jb2, &kb,
+                                   &c_neg_one, P((i - k)*nb, 0), &ldp,
+                                               W, &ldw,
+                                   &c_one,     Aij, &ldij );
+                }
+            }
+            ztile_blas_local_end( saved );
+        }
+    }
+
+    magma_free_cpu( P );
+    magma_free_cpu( T );
+    magma_free_cpu( work );
+    return *info;
+} /* magma_zgeqrf_tile_cpu */
@@ -130,6 +130,74 @@ private:
 };
 
 
+/******************************************************************************/
+// Solves the rows of a block of nb2 eigenvectors that are not in their tails.
+// The k-by-nb2 tails Xt are already solved; through the k-by-m (ConjTrans)
+// or m-by-k (NoTrans) block T12 they give the right-hand sides
+// Xh = -op(T12) * Xt of the remaining m rows, which are solved together,
+// (T22 - lambda(j)*I)**op * Xh(:,j) = scale(j) * Xh(:,j), with zlatrs3d.
+// Each column of Xt is normalized beforehand, leaving the whole range for the
+// growth in Xh, and scaled so the GEMM cannot overflow; afterwards it is
+// scaled by scale(j). On exit, scale(j) = 0 marks a vector that could not be
+// represented this way; the caller must solve it again as a whole.
+static void ztrevc3_mt_solve_block(
+    magma_trans_t trans, magma_int_t m, magma_int_t k, magma_int_t nb2,
+    const magmaDoubleComplex *T12, const magmaDoubleComplex *T22, magma_int_t ldt,
+    const magmaDoubleComplex *lambda, double *scale,
+    magmaDoubleComplex *Xt, magmaDoubleComplex *Xh, magma_int_t ldx,
+    magma_thread_queue& queue, magma_int_t gemm_nb, magma_int_t nthread )
+{
+    const magmaDoubleComplex c_zero    = MAGMA_Z_ZERO;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    const magma_int_t izero = 0, ione = 1;
+    const magma_int_t mb = 64;
+
+    magma_int_t i, ib, j, info;
+    double anrm, xnrm, s, d_one = 1., dwork[ mb ];
+
+    // |op(T12)|_inf, in row blocks for the workspace of zlange
+    anrm = 0;
+    if ( trans == MagmaNoTrans ) {
+        for( i=0; i < m; i += mb ) {
+            ib = min( mb, m-i );
+            anrm = max( anrm, lapackf77_zlange( "I", &ib, &k, T12 + i, &ldt, dwork ));
+        }
+    }
+    else {
+        anrm = lapackf77_zlange( "1", &k, &m, T12, &ldt, dwork );
+    }
+    for( j=0; j < nb2; ++j ) {
+        xnrm = lapackf77_zlange( "M", &k, &ione, Xt + j*ldx, &ldx, dwork );
+        if ( xnrm != 0. ) {
+            lapackf77_zlascl( "G", &izero, &izero, &xnrm, &d_one, &k, &ione,
+                              Xt + j*ldx, &ldx, &info );
+        }
+        s = magma_dlarmm( anrm, d_one, 0. );
+        if ( s != 1. ) {
+            blasf77_zdscal( &k, &s, Xt + j*ldx, &ione );
+        }
+    }
+
+    // split gemm into multiple tasks, each doing one block row
+    for( i=0; i < m; i += gemm_nb ) {
+        ib = min( gemm_nb, m-i );
+        queue.push_task( new zgemm_task(
+            trans, MagmaNoTrans, ib, nb2, k, c_neg_one,
+            (trans == MagmaNoTrans ? T12 + i : T12 + i*ldt), ldt,
+            Xt, ldx, c_zero,
+            Xh + i, ldx ));
+    }
+    queue.sync();
+
+    magma_zlatrs3d( trans, m, nb2, T22, ldt, lambda, Xh, ldx, scale, nthread, &info );
+    for( j=0; j < nb2; ++j ) {
+        if ( scale[j] != 1. ) {
+            blasf77_zdscal( &k, &scale[j], Xt + j*ldx, &ione );
+        }
+    }
+}
+
+
 /***************************************************************************//**
     Purpose
     -------
@@ -299,6 +367,11 @@ magma_int_t magma_ztrevc3_mt(
     magma_int_t            allv, bothv, leftv, over, rightv, somev;
     magma_int_t            i, ii, is, j, k, ki, iv, n2, nb, nb2, version;
     double                 ovfl, remax, unfl;  //smlnum, smin, ulp
+
+    // .. Local Arrays ..
+    // shifts and scale factors of the block solves in version 2
+    magmaDoubleComplex     lambda[ nbmax ];
+    double                 scale[ nbmax ];
     
     // Decode and test the input parameters
     bothv  = (side == MagmaBothSides);
@@ -437,7 +510,9 @@ magma_int_t magma_ztrevc3_mt(
 
             // Solve upper triangular system:
             // [ T(1:ki-1,1:ki-1) - T(ki,ki) ]*X = scale*work.
-            if ( ki > 0 ) {
+            // The blocked back-transform instead solves its whole block
+            // of vectors together, below.
+            if ( ki > 0 && (! over || version == 1) ) {
                 queue.push_task( new magma_zlatrsd_task(
                     MagmaUpper, MagmaNoTrans, MagmaNonUnit, MagmaTrue,
                     ki, T, ldt, *T(ki,ki),
@@ -490,11 +565,52 @@ magma_int_t magma_ztrevc3_mt(
                 // When the number of vectors stored reaches nb,
                 // or if this was last vector, do the GEMM
                 if ( (iv == 1) || (ki == 0) ) {
+                    nb2 = nb-iv+1;
+                    n2  = ki+nb-iv+1;
+
+                    // Solve the block of vectors, columns iv:nb for
+                    // eigenvalues ki:ki+nb2-1. First the tail of each vector,
+                    // rows ki:ki+k-1 of column iv+k, with zlatrsd, ...
+                    for( k=1; k < nb2; ++k ) {
+                        queue.push_task( new magma_zlatrsd_task(
+                            MagmaUpper, MagmaNoTrans, MagmaNonUnit, MagmaTrue,
+                            k, T(ki,ki), ldt, *T(ki+k,ki+k),
+                            work(ki,iv+k), work(ki+k,iv+k), &rwork[ki] ));
+                    }
                     queue.sync();
+                    // ... then rows 0:ki-1 of all of them together, with zlatrs3d.
+                    if ( ki > 0 ) {
+                        for( k=0; k < nb2; ++k ) {
+                            lambda[k] = *T(ki+k,ki+k);
+                        }
+                        ztrevc3_mt_solve_block(
+                            MagmaNoTrans, ki, nb2, nb2,
+                            T(0,ki), T, ldt, lambda, scale,
+                            work(ki,iv), work(0,iv), n,
+                            queue, gemm_nb, nthread );
+
+                        // solve any vector that could not be represented
+                        // in two parts as a whole, as in version 1
+                        for( k=0; k < nb2; ++k ) {
+                            if ( scale[k] == 0. ) {
+                                j = ki+k;
+                                *work(j,iv+k) = c_one;
+                                for( i=0; i < j; ++i ) {
+                                    *work(i,iv+k) = -(*T(i,j));
+                                }
+                                for( i=j+1; i < n; ++i ) {
+                                    *work(i,iv+k) = c_zero;
+                                }
+                                queue.push_task( new magma_zlatrsd_task(
+                                    MagmaUpper, MagmaNoTrans, MagmaNonUnit, MagmaTrue,
+                                    j, T, ldt, *T(j,j),
+                                    work(0,iv+k), work(j,iv+k), rwork ));
+                            }
+                        }
+                        queue.sync();
+                    }
                     time_trsv_sum += timer_stop( time_trsv );
                     timer_start( time_gemm );
-                    nb2 = nb-iv+1;
-                    n2  = ki+nb-iv+1;
                     
                     // split gemm into multiple tasks, each doing one block row
                     for( i=0; i < n; i += gemm_nb ) {
@@ -562,7 +678,9 @@ magma_int_t magma_ztrevc3_mt(
             // Solve conjugate-transposed triangular system:
             // [ T(ki+1:n,ki+1:n) - T(ki,ki) ]**H * X = scale*work.
             // TODO what happens with T(k,k) - lambda is small? Used to have < smin test.
-            if ( ki < n-1 ) {
+            // The blocked back-transform instead solves its whole block
+            // of vectors together, below.
+            if ( ki < n-1 && (! over || version == 1) ) {
                 n2 = n-ki-1;
                 queue.push_task( new magma_zlatrsd_task(
                     MagmaUpper, MagmaConjTrans, MagmaNonUnit, MagmaTrue,
@@ -614,7 +732,52 @@ magma_int_t magma_ztrevc3_mt(
                 // When the number of vectors stored reaches nb,
                 // or if this was last vector, do the GEMM
                 if ( (iv == nb) || (ki == n-1) ) {
+                    // Solve the block of vectors, columns 1:iv for
+                    // eigenvalues ki-iv+1:ki. First the tail of each vector,
+                    // rows j+1:ki of the column for eigenvalue j, with zlatrsd, ...
+                    for( k=1; k <= iv; ++k ) {
+                        j  = ki-iv+k;
+                        n2 = ki-j;
+                        if ( n2 > 0 ) {
+                            queue.push_task( new magma_zlatrsd_task(
+                                MagmaUpper, MagmaConjTrans, MagmaNonUnit, MagmaTrue,
+                                n2, T(j+1,j+1), ldt, *T(j,j),
+                                work(j+1,k), work(j,k), &rwork[j+1] ));
+                        }
+                    }
                     queue.sync();
+                    // ... then rows ki+1:n-1 of all of them together, with zlatrs3d.
+                    if ( ki < n-1 ) {
+                        for( k=1; k <= iv; ++k ) {
+                            lambda[k-1] = *T(ki-iv+k,ki-iv+k);
+                        }
+                        ztrevc3_mt_solve_block(
+                            MagmaConjTrans, n-ki-1, iv, iv,
+                            T(ki-iv+1,ki+1), T(ki+1,ki+1), ldt, lambda, scale,
+                            work(ki-iv+1,1), work(ki+1,1), n,
+                            queue, gemm_nb, nthread );
+
+                        // solve any vector that could not be represented
+                        // in two parts as a whole, as in version 1
+                        for( k=1; k <= iv; ++k ) {
+                            if ( scale[k-1] == 0. ) {
+                                j = ki-iv+k;
+                                *work(j,k) = c_one;
+                                for( i=0; i < j; ++i ) {
+                                    *work(i,k) = c_zero;
+                                }
+                                for( i=j+1; i < n; ++i ) {
+                                    *work(i,k) = -MAGMA_Z_CONJ( *T(j,i) );
+                                }
+                                n2 = n-j-1;
+                                queue.push_task( new magma_zlatrsd_task(
+                                    MagmaUpper, MagmaConjTrans, MagmaNonUnit, MagmaTrue,
+                                    n2, T(j+1,j+1), ldt, *T(j,j),
+                                    work(j+1,k), work(j,k), rwork ));
+                            }
+                        }
+                        queue.sync();
+                    }
                     n2 = n-(ki+1)+iv;
                     
                     // split gemm into multiple tasks, each doing one block row
@@ -0,0 +1,258 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       Machine-readable benchmark records for the testers (--output json|csv).
+       See testing/run_compare.py to compare two runs.
+*/
+#include <string.h>
+#include <time.h>
+
+#if ! defined( _WIN32 ) && ! defined( _WIN64 )
+#include <unistd.h>  // gethostname
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "magma_v2.h"
+#include "testings.h"
+
+#include "../control/magma_threadsetting.h"  // internal header
+
+// set by the Makefile or CMake from "git describe"
+#ifndef MAGMA_GIT_REVISION
+#define MAGMA_GIT_REVISION "unknown"
+#endif
+
+
+// -----------------------------------------------------------------------------
+// Escapes string s for a JSON string literal, without enclosing quotes.
+static std::string json_escape( const std::string& s )
+{
+    std::string out;
+    for (size_t i = 0; i < s.size(); ++i) {
+        unsigned char c = s[i];
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n";  break;
+            case '\t': out += "\\t";  break;
+            default:
+                if (c < 0x20) {
+                    char buf[8];
+                    snprintf( buf, sizeof(buf), "\\u%04x", c );
+                    out += buf;
+                }
+                else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+
+// -----------------------------------------------------------------------------
+// Quotes string s for CSV if it contains a comma, quote, or newline.
+static std::string csv_escape( const std::string& s )
+{
+    if (s.find_first_of( ",\"\n" ) == std::string::npos) {
+        return s;
+    }
+    std::string out = "\"";
+    for (size_t i = 0; i < s.size(); ++i) {
+        if (s[i] == '"') {
+            out += '"';
+        }
+        out += s[i];
+    }
+    out += '"';
+    return out;
+}
+
+
+// -----------------------------------------------------------------------------
+// Host information, appended to every record. Computed once, at the first
+// record, so all records of a run share the same date.
+struct bench_host_info
+{
+    std::string host;
+    std::string device;
+    std::string version;
+    std::string git;
+    std::string date;
+    magma_int_t omp_threads;
+    magma_int_t lapack_threads;
+};
+
+static const bench_host_info& bench_host( magma_opts const& opts )
+{
+    static bench_host_info info;
+    static bool init = false;
+    if (init) {
+        return info;
+    }
+    init = true;
+
+    char buf[256] = "unknown";
+    #if ! defined( _WIN32 ) && ! defined( _WIN64 )
+    if (gethostname( buf, sizeof(buf) ) != 0) {
+        strcpy( buf, "unknown" );
+    }
+    buf[ sizeof(buf)-1 ] = '\0';
+    #endif
+    info.host = buf;
+
+    info.device = "unknown";
+    #ifdef HAVE_CUBLAS
+    cudaDeviceProp prop;
+    if (cudaGetDeviceProperties( &prop, opts.device ) == cudaSuccess) {
+        info.device = prop.name;
+    }
+    #else
+    MAGMA_UNUSED( opts );
+    #endif
+
+    magma_int_t major, minor, micro;
+    magma_version( &major, &minor, &micro );
+    snprintf( buf, sizeof(buf), "%lld.%lld.%lld",
+              (long long) major, (long long) minor, (long long) micro );
+    info.version = buf;
+
+    // environment overrides the build's revision, e.g., for exported trees
+    const char* git = getenv( "MAGMA_GIT_REVISION" );
+    info.git = (git != NULL ? git : MAGMA_GIT_REVISION);
+
+    time_t now = time( NULL );
+    strftime( buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", gmtime( &now ));
+    info.date = buf;
+
+    info.omp_threads    = 1;
+    #ifdef _OPENMP
+    info.omp_threads    = omp_get_max_threads();
+    #endif
+    info.lapack_threads = magma_get_lapack_numthreads();
+    return info;
+}
+
+
+// -----------------------------------------------------------------------------
+magma_bench_record::magma_bench_record( magma_opts const& opts, const char* routine ):
+    opts_( opts ),
+    routine_( routine )
+{}
+
+
+// -----------------------------------------------------------------------------
+void magma_bench_record::add( const char* name, magma_int_t value )
+{
+    if (opts_.output == MagmaOutputText)
+        return;
+    char buf[32];
+    snprintf( buf, sizeof(buf), "%lld", (long long) value );
+    fields_.push_back( field( name, buf, false ));
+}
+
+
+// -----------------------------------------------------------------------------
+// NaN and Inf are not valid JSON numbers; they are written as strings.
+void magma_bench_record::add( const char* name, double value )
+{
+    if (opts_.output == MagmaOutputText)
+        return;
+    char buf[32];
+    snprintf( buf, sizeof(buf), "%.6g", value );
+    fields_.push_back( field( name, buf, ! std::isfinite( value )));
+}
+
+
+// -----------------------------------------------------------------------------
+void magma_bench_record::add( const char* name, const char* value )
+{
+    if (opts_.output == MagmaOutputText)
+        return;
+    fields_.push_back( field( name, value, true ));
+}
+
+
+// -----------------------------------------------------------------------------
+void magma_bench_record::perf( const char* name, double gflops, double time )
+{
+    if (opts_.output == MagmaOutputText)
+        return;
+    std::string prefix = name;
+    add( (prefix + "_gflops").c_str(), gflops );
+    add( (prefix + "_time"  ).c_str(), time   );
+}
+
+
+// -----------------------------------------------------------------------------
+// Writes one record, as a JSON object on a single line (JSON Lines) or a CSV
+// row. For CSV, a header row is written whenever the fields differ from the
+// previous row's, e.g., between testers in one output file.
+void magma_bench_record::write( magma_int_t iter, bool okay )
+{
+    if (opts_.output == MagmaOutputText)
+        return;
+
+    const bench_host_info& host = bench_host( opts_ );
+    char buf[32];
+    std::vector< field > all;
+    all.push_back( field( "routine", routine_, true ));
+    snprintf( buf, sizeof(buf), "%lld", (long long) iter );
+    all.push_back( field( "iter", buf, false ));
+    all.insert( all.end(), fields_.begin(), fields_.end() );
+    all.push_back( field( "status", (okay ? "ok" : "failed"), true ));
+    all.push_back( field( "host",    host.host,    true ));
+    all.push_back( field( "device",  host.device,  true ));
+    snprintf( buf, sizeof(buf), "%lld", (long long) host.omp_threads );
+    all.push_back( field( "omp_threads", buf, false ));
+    snprintf( buf, sizeof(buf), "%lld", (long long) host.lapack_threads );
+    all.push_back( field( "lapack_threads", buf, false ));
+    all.push_back( field( "magma_version", host.version, true ));
+    all.push_back( field( "git",     host.git,     true ));
+    all.push_back( field( "date",    host.date,    true ));
+
+    FILE* out = (opts_.output_file != NULL ? opts_.output_file : stdout);
+    std::string line;
+    if (opts_.output == MagmaOutputJson) {
+        line = "{";
+        for (size_t i = 0; i < all.size(); ++i) {
+            if (i > 0)
+                line += ", ";
+            line += "\"" + json_escape( all[i].name ) + "\": ";
+            if (all[i].is_string)
+                line += "\"" + json_escape( all[i].value ) + "\"";
+            else
+                line += all[i].value;
+        }
+        line += "}\n";
+    }
+    else {
+        // header is shared by all records in the process
+        static std::string last_header;
+        std::string header, row;
+        for (size_t i = 0; i < all.size(); ++i) {
+            if (i > 0) {
+                header += ",";
+                row    += ",";
+            }
+            header += csv_escape( all[i].name  );
+            row    += csv_escape( all[i].value );
+        }
+        if (header != last_header) {
+            line = header + "\n";
+            last_header = header;
+        }
+        line += row + "\n";
+    }
+    fputs( line.c_str(), out );
+    fflush( out );
+
+    fields_.clear();
+}
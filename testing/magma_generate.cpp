@@ -10,11 +10,18 @@
        Test matrix generation.
 */
 
+#include <stdint.h>
+#include <stdio.h>
+
 #include <exception>
 #include <string>
 #include <vector>
 #include <limits>
 
+#if ! defined( _WIN32 ) && ! defined( _WIN64 )
+#include <unistd.h>  // getpid
+#endif
+
 #include "magma_v2.h"
 #include "magma_lapack.hpp"  // experimental C++ bindings
 #include "magma_operators.h"
@@ -73,14 +80,6 @@ const char *ansi_red    = "\x1b[31m";
 const char *ansi_bold   = "\x1b[1m";
 const char *ansi_normal = "\x1b[0m";
 
-/******************************************************************************/
-// random number in (0, max_]
-template< typename FloatT >
-inline FloatT rand( FloatT max_ )
-{
-    return max_ * rand() / FloatT(RAND_MAX);
-}
-
 /******************************************************************************/
 // true if str begins with prefix
 inline bool begins( std::string const &str, std::string const &prefix )
@@ -96,10 +95,331 @@ inline bool contains( std::string const &str, std::string const &pattern )
 }
 
 
+/******************************************************************************/
+// Counter-based random number generator, Philox-4x32-10.
+// See Salmon, Moraes, Dror, and Shaw, Parallel random numbers: as easy as
+// 1, 2, 3, SC 2011.
+// Random entry (i, j) is a function of only the key and the counter (i, j),
+// not of the order in which entries are generated. Hence each thread
+// generates its own block of columns, and the matrix is the same
+// for any number of threads.
+
+// the random quantities of one matrix each have their own stream
+enum class Stream {
+    A = 1,
+    sigma,
+    sign,
+    U,
+    V,
+    D,
+};
+
+struct rng_key
+{
+    uint32_t k0, k1;
+};
+
+// ----------------------------------------
+static inline uint32_t mulhilo( uint32_t a, uint32_t b, uint32_t* hi )
+{
+    uint64_t product = uint64_t( a ) * b;
+    *hi = uint32_t( product >> 32 );
+    return uint32_t( product );
+}
+
+// ----------------------------------------
+static inline void philox4x32( uint32_t ctr[4], rng_key key )
+{
+    const uint32_t m0 = 0xD2511F53, m1 = 0xCD9E8D57;  // multipliers
+    const uint32_t w0 = 0x9E3779B9, w1 = 0xBB67AE85;  // Weyl sequence for key
+    for (int round = 0; round < 10; ++round) {
+        uint32_t hi0, hi1;
+        uint32_t lo0 = mulhilo( m0, ctr[0], &hi0 );
+        uint32_t lo1 = mulhilo( m1, ctr[2], &hi1 );
+        ctr[0] = hi1 ^ ctr[1] ^ key.k0;
+        ctr[1] = lo1;
+        ctr[2] = hi0 ^ ctr[3] ^ key.k1;
+        ctr[3] = lo0;
+        key.k0 += w0;
+        key.k1 += w1;
+    }
+}
+
+// ----------------------------------------
+// uniform on (0, 1), from 53 random bits
+static inline double rng_uniform( uint32_t hi, uint32_t lo )
+{
+    uint64_t bits = (uint64_t( hi ) << 21) ^ (lo >> 11);
+    return (bits + 0.5) * (1. / 9007199254740992.);  // 2^-53
+}
+
+// ----------------------------------------
+// Random entry (i, j), with distribution idist as in larnv:
+// rand uniform on (0, 1), randu uniform on (-1, 1), randn normal (0, 1).
+// For complex, real and imaginary parts are independent.
+template< typename FloatT >
+inline FloatT rng_entry( rng_key key, magma_int_t idist, uint64_t i, uint64_t j )
+{
+    typedef typename blas::traits<FloatT>::real_t real_t;
+
+    uint32_t x[4] = { uint32_t( i ), uint32_t( i >> 32 ),
+                      uint32_t( j ), uint32_t( j >> 32 ) };
+    philox4x32( x, key );
+    double u1 = rng_uniform( x[0], x[1] );
+    double u2 = rng_uniform( x[2], x[3] );
+    double re, im;
+    if (idist == idist_randu) {
+        re = 2*u1 - 1;
+        im = 2*u2 - 1;
+    }
+    else if (idist == idist_randn) {
+        // Box-Muller
+        const double twopi = 6.283185307179586;
+        double r = sqrt( -2*log( u1 ));
+        re = r * cos( twopi*u2 );
+        im = r * sin( twopi*u2 );
+    }
+    else {
+        re = u1;
+        im = u2;
+    }
+    return blas::traits<FloatT>::make( real_t( re ), real_t( im ));
+}
+
+// ----------------------------------------
+// Seed of one matrix, taken from opts.iseed, with a key for each stream.
+class rng_seed
+{
+public:
+    // copies iseed, then advances iseed so the next matrix differs.
+    rng_seed( magma_int_t iseed[4] )
+    {
+        std::copy( iseed, iseed + 4, seed );
+        double tmp;
+        lapack::larnv( idist_rand, iseed, 1, &tmp );
+    }
+
+    // iseed entries are in [0, 4095], so 12 bits each.
+    rng_key key( Stream stream ) const
+    {
+        rng_key k;
+        k.k0 = uint32_t( seed[0] ) | (uint32_t( seed[1] ) << 12) | (uint32_t( stream ) << 24);
+        k.k1 = uint32_t( seed[2] ) | (uint32_t( seed[3] ) << 12);
+        return k;
+    }
+
+    magma_int_t seed[4];
+};
+
+
+/******************************************************************************/
+// Fills m-by-n A with random entries, in parallel over columns.
+template< typename FloatT >
+void magma_generate_rand(
+    rng_key key, magma_int_t idist,
+    magma_int_t m, magma_int_t n,
+    FloatT* A, magma_int_t lda )
+{
+    #pragma omp parallel for schedule(static)
+    for (magma_int_t j = 0; j < n; ++j) {
+        for (magma_int_t i = 0; i < m; ++i) {
+            A[ i + j*lda ] = rng_entry<FloatT>( key, idist, i, j );
+        }
+    }
+}
+
+
+/******************************************************************************/
+// Random unitary Q = H_1 H_2 ... H_k, with m-by-k Householder vectors V from
+// random normal vectors (Stewart, 1980), and upper triangular T factors of
+// each block of nb = T.m reflectors, as in larft.
+// Unlike in geqrf, later columns are not updated, so reflectors and T factors
+// are independent and are all computed in parallel, with sequential BLAS.
+const magma_int_t unitary_nb = 64;
+
+template< typename FloatT >
+void magma_generate_unitary(
+    rng_key key,
+    Matrix<FloatT>& V, Vector<FloatT>& tau, Matrix<FloatT>& T )
+{
+    magma_int_t m  = V.m;
+    magma_int_t k  = V.n;
+    magma_int_t nb = T.m;
+    magma_generate_rand( key, idist_randn, m, k, V(0,0), V.ld );
+
+    magma_int_t nthreads = magma_batched_ref_begin();
+
+    #pragma omp parallel for schedule(static)
+    for (magma_int_t j = 0; j < k; ++j) {
+        magma_int_t mj = m - j;
+        lapack::larfg( mj, V(j,j), V(j+1,j), 1, tau(j) );
+    }
+
+    #pragma omp parallel for schedule(dynamic)
+    for (magma_int_t j = 0; j < k; j += nb) {
+        magma_int_t jb = min( nb, k - j );
+        lapack::larft( "Forward", "Columnwise", m - j, jb,
+                       V(j,j), V.ld, tau(j), T(0,j), T.ld );
+    }
+
+    magma_batched_ref_end( nthreads );
+}
+
+
+/******************************************************************************/
+// Applies Q from magma_generate_unitary: A = Q A or Q^H A (side = Left),
+// or A = A Q or A Q^H (side = Right), one block of reflectors at a time
+// using larfb, which is level 3 and uses multithreaded BLAS.
+template< typename FloatT >
+void magma_apply_unitary(
+    const char* side, const char* trans,
+    Matrix<FloatT>& V, Matrix<FloatT>& T,
+    Matrix<FloatT>& A )
+{
+    magma_int_t k  = V.n;
+    magma_int_t nb = T.m;
+    bool left    = (*side  == 'L' || *side  == 'l');
+    bool notrans = (*trans == 'N' || *trans == 'n');
+    magma_int_t ldwork = (left ? A.n : A.m);
+    Vector<FloatT> work( ldwork * nb );
+
+    // as in unmqr, Q A and A Q^H apply the last block first
+    magma_int_t nblock = magma_ceildiv( k, nb );
+    for (magma_int_t ib = 0; ib < nblock; ++ib) {
+        magma_int_t b  = (left == notrans ? nblock - 1 - ib : ib);
+        magma_int_t j  = b*nb;
+        magma_int_t jb = min( nb, k - j );
+        if (left) {
+            lapack::larfb( side, trans, "Forward", "Columnwise",
+                           A.m - j, A.n, jb, V(j,j), V.ld, T(0,j), T.ld,
+                           A(j,0), A.ld, work(0), ldwork );
+        }
+        else {
+            lapack::larfb( side, trans, "Forward", "Columnwise",
+                           A.m, A.n - j, jb, V(j,j), V.ld, T(0,j), T.ld,
+                           A(0,j), A.ld, work(0), ldwork );
+        }
+    }
+}
+
+
+/******************************************************************************/
+// Disk cache of generated matrices, enabled by --matrix-cache dir or
+// $MAGMA_MATRIX_CACHE. Only large matrices with a specified spectrum are
+// cached; they cost O(n^3) to generate, while random matrices are
+// cheaper to regenerate than to read.
+// The file name includes everything the matrix depends on: precision,
+// --matrix, size, cond, condD, and seed. Files are written to a temporary
+// name, then renamed, so concurrent testers never read a partial file.
+const magma_int_t cache_min_size = 1000*1000;  // entries
+const char        cache_magic[8] = { 'M','A','G','M','A','G','E','N' };
+const uint32_t    cache_version  = 1;
+
+template< typename FloatT > char cache_precision();
+template<> char cache_precision< float              >() { return 's'; }
+template<> char cache_precision< double             >() { return 'd'; }
+template<> char cache_precision< magmaFloatComplex  >() { return 'c'; }
+template<> char cache_precision< magmaDoubleComplex >() { return 'z'; }
+
+// ----------------------------------------
+template< typename FloatT >
+std::string cache_filename(
+    magma_opts const& opts, rng_seed const& seed,
+    double cond, double condD, magma_int_t m, magma_int_t n )
+{
+    char buf[ 1024 ];
+    snprintf( buf, sizeof(buf), "%s/%c%s_%lldx%lld_cond%.6e_condD%.6e_seed%lld-%lld-%lld-%lld.mat",
+              opts.matrix_cache.c_str(), cache_precision<FloatT>(), opts.matrix.c_str(),
+              (long long) m, (long long) n, cond, condD,
+              (long long) seed.seed[0], (long long) seed.seed[1],
+              (long long) seed.seed[2], (long long) seed.seed[3] );
+    return std::string( buf );
+}
+
+// ----------------------------------------
+// Reads A and sigma from file; returns false if file is missing or mismatched.
+template< typename FloatT >
+bool cache_read(
+    std::string const& filename,
+    Matrix<FloatT>& A,
+    Vector< typename blas::traits<FloatT>::real_t >& sigma )
+{
+    typedef typename blas::traits<FloatT>::real_t real_t;
+
+    FILE* f = fopen( filename.c_str(), "rb" );
+    if (f == NULL) {
+        return false;
+    }
+    char magic[8];
+    uint32_t header[2];
+    int64_t dims[2];
+    bool okay = (fread( magic,  sizeof(magic),  1, f ) == 1
+              && fread( header, sizeof(header), 1, f ) == 1
+              && fread( dims,   sizeof(dims),   1, f ) == 1
+              && std::equal( magic, magic + 8, cache_magic )
+              && header[0] == cache_version
+              && header[1] == sizeof(FloatT)
+              && dims[0] == A.m
+              && dims[1] == A.n);
+    for (magma_int_t j = 0; okay && j < A.n; ++j) {
+        okay = (fread( A(0,j), sizeof(FloatT), A.m, f ) == size_t( A.m ));
+    }
+    if (okay && sigma.n > 0) {
+        okay = (fread( sigma(0), sizeof(real_t), sigma.n, f ) == size_t( sigma.n ));
+    }
+    fclose( f );
+    return okay;
+}
+
+// ----------------------------------------
+// Writes A and sigma to file; on failure, warns and continues without cache.
+template< typename FloatT >
+void cache_write(
+    std::string const& filename,
+    Matrix<FloatT> const& A,
+    Vector< typename blas::traits<FloatT>::real_t > const& sigma )
+{
+    typedef typename blas::traits<FloatT>::real_t real_t;
+
+    long long pid = 0;
+    #if ! defined( _WIN32 ) && ! defined( _WIN64 )
+    pid = getpid();
+    #endif
+    char suffix[ 32 ];
+    snprintf( suffix, sizeof(suffix), ".tmp%lld", pid );
+    std::string tmpname = filename + suffix;
+
+    FILE* f = fopen( tmpname.c_str(), "wb" );
+    bool okay = (f != NULL);
+    if (okay) {
+        uint32_t header[2] = { cache_version, uint32_t( sizeof(FloatT) ) };
+        int64_t dims[2] = { A.m, A.n };
+        okay = (fwrite( cache_magic, sizeof(cache_magic), 1, f ) == 1
+             && fwrite( header,      sizeof(header),      1, f ) == 1
+             && fwrite( dims,        sizeof(dims),        1, f ) == 1);
+        for (magma_int_t j = 0; okay && j < A.n; ++j) {
+            okay = (fwrite( A(0,j), sizeof(FloatT), A.m, f ) == size_t( A.m ));
+        }
+        if (okay && sigma.n > 0) {
+            okay = (fwrite( sigma(0), sizeof(real_t), sigma.n, f ) == size_t( sigma.n ));
+        }
+        okay = (fclose( f ) == 0) && okay;
+    }
+    if (okay) {
+        okay = (rename( tmpname.c_str(), filename.c_str() ) == 0);
+    }
+    if (! okay) {
+        remove( tmpname.c_str() );
+        fprintf( stderr, "%sWarning: cannot write matrix cache file %s%s\n",
+                 ansi_red, filename.c_str(), ansi_normal );
+    }
+}
+
+
 /******************************************************************************/
 template< typename FloatT >
 void magma_generate_sigma(
-    magma_opts& opts,
+    rng_seed const& seed,
     Dist dist, bool rand_sign,
     typename blas::traits<FloatT>::real_t cond,
     typename blas::traits<FloatT>::real_t sigma_max,
@@ -170,7 +490,8 @@ void magma_generate_sigma(
 
         case Dist::logrand: {
             real_t range = log( 1/cond );
-            lapack::larnv( idist_rand, opts.iseed, sigma.n, sigma(0) );
+            magma_generate_rand( seed.key( Stream::sigma ), idist_rand,
+                                 sigma.n, 1, sigma(0), sigma.n );
             for (magma_int_t i = 0; i < minmn; ++i) {
                 sigma[i] = exp( sigma[i] * range );
             }
@@ -186,7 +507,8 @@ void magma_generate_sigma(
         case Dist::randu:
         case Dist::rand: {
             magma_int_t idist = (magma_int_t) dist;
-            lapack::larnv( idist, opts.iseed, sigma.n, sigma(0) );
+            magma_generate_rand( seed.key( Stream::sigma ), idist,
+                                 sigma.n, 1, sigma(0), sigma.n );
             break;
         }
 
@@ -203,8 +525,9 @@ void magma_generate_sigma(
 
     if (rand_sign) {
         // apply random signs
+        rng_key key = seed.key( Stream::sign );
         for (magma_int_t i = 0; i < minmn; ++i) {
-            if (rand() > RAND_MAX/2) {
+            if (rng_entry<real_t>( key, idist_rand, i, 0 ) > 0.5) {
                 sigma[i] = -sigma[i];
             }
         }
@@ -279,6 +602,7 @@ void magma_generate_correlation_factor( Matrix<magmaDoubleComplex>& A )
 template< typename FloatT >
 void magma_generate_svd(
     magma_opts& opts,
+    rng_seed const& seed,
     Dist dist,
     typename blas::traits<FloatT>::real_t cond,
     typename blas::traits<FloatT>::real_t condD,
@@ -289,34 +613,16 @@ void magma_generate_svd(
     typedef typename blas::traits<FloatT>::real_t real_t;
 
     // locals
-    FloatT tmp;
     magma_int_t m = A.m;
     magma_int_t n = A.n;
     magma_int_t maxmn = max( m, n );
     magma_int_t minmn = min( m, n );
-    magma_int_t sizeU;
-    magma_int_t info = 0;
     Matrix<FloatT> U( maxmn, minmn );
+    Matrix<FloatT> T( unitary_nb, minmn );
     Vector<FloatT> tau( minmn );
 
-    // query for workspace
-    magma_int_t lwork = -1;
-    lapack::unmqr( "Left", "NoTrans", A.m, A.n, minmn,
-                   U(0,0), U.ld, tau(0), A(0,0), A.ld,
-                   &tmp, lwork, &info );
-    assert( info == 0 );
-    lwork = magma_int_t( real( tmp ));
-    magma_int_t lwork2 = -1;
-    lapack::unmqr( "Right", "ConjTrans", A.m, A.n, minmn,
-                   U(0,0), U.ld, tau(0), A(0,0), A.ld,
-                   &tmp, lwork2, &info );
-    assert( info == 0 );
-    lwork2 = magma_int_t( real( tmp ));
-    lwork = max( lwork, lwork2 );
-    Vector<FloatT> work( lwork );
-
     // ----------
-    magma_generate_sigma( opts, dist, false, cond, sigma_max, A, sigma );
+    magma_generate_sigma( seed, dist, false, cond, sigma_max, A, sigma );
 
     // for generate correlation factor, need sum sigma_i^2 = n
     // scaling doesn't change cond
@@ -331,33 +637,18 @@ void magma_generate_svd(
     }
 
     // random U, m-by-minmn
-    // just make each random column into a Householder vector;
-    // no need to update subsequent columns (as in geqrf).
-    sizeU = U.size();
-    lapack::larnv( idist_randn, opts.iseed, sizeU, U(0,0) );
-    for (magma_int_t j = 0; j < minmn; ++j) {
-        magma_int_t mj = m - j;
-        lapack::larfg( mj, U(j,j), U(j+1,j), 1, tau(j) );
-    }
+    Matrix<FloatT> Um( U(0,0), m, minmn, U.ld );
+    magma_generate_unitary( seed.key( Stream::U ), Um, tau, T );
 
     // A = U*A
-    lapack::unmqr( "Left", "NoTrans", A.m, A.n, minmn,
-                   U(0,0), U.ld, tau(0), A(0,0), A.ld,
-                   work(0), lwork, &info );
-    assert( info == 0 );
+    magma_apply_unitary( "Left", "NoTrans", Um, T, A );
 
     // random V, n-by-minmn (stored column-wise in U)
-    lapack::larnv( idist_randn, opts.iseed, sizeU, U(0,0) );
-    for (magma_int_t j = 0; j < minmn; ++j) {
-        magma_int_t nj = n - j;
-        lapack::larfg( nj, U(j,j), U(j+1,j), 1, tau(j) );
-    }
+    Matrix<FloatT> Vn( U(0,0), n, minmn, U.ld );
+    magma_generate_unitary( seed.key( Stream::V ), Vn, tau, T );
 
     // A = A*V^H
-    lapack::unmqr( "Right", "ConjTrans", A.m, A.n, minmn,
-                   U(0,0), U.ld, tau(0), A(0,0), A.ld,
-                   work(0), lwork, &info );
-    assert( info == 0 );
+    magma_apply_unitary( "Right", "ConjTrans", Vn, T, A );
 
     if (condD != 1) {
         // A = A*W, W orthogonal, such that A has unit column norms
@@ -367,7 +658,7 @@ void magma_generate_svd(
         // A = A*D col scaling
         Vector<real_t> D( A.n );
         real_t range = log( condD );
-        lapack::larnv( idist_rand, opts.iseed, D.n, D(0) );
+        magma_generate_rand( seed.key( Stream::D ), idist_rand, D.n, 1, D(0), D.n );
         for (magma_int_t i = 0; i < D.n; ++i) {
             D[i] = exp( D[i] * range );
         }
@@ -379,6 +670,7 @@ void magma_generate_svd(
             }
             printf( " ];\n" );
         }
+        #pragma omp parallel for schedule(static)
         for (magma_int_t j = 0; j < A.n; ++j) {
             for (magma_int_t i = 0; i < A.m; ++i) {
                 *A(i,j) *= D[j];
@@ -391,6 +683,7 @@ void magma_generate_svd(
 template< typename FloatT >
 void magma_generate_heev(
     magma_opts& opts,
+    rng_seed const& seed,
     Dist dist, bool rand_sign,
     typename blas::traits<FloatT>::real_t cond,
     typename blas::traits<FloatT>::real_t condD,
@@ -404,53 +697,22 @@ void magma_generate_heev(
     assert( A.m == A.n );
 
     // locals
-    FloatT tmp;
     magma_int_t n = A.n;
-    magma_int_t sizeU;
-    magma_int_t info = 0;
     Matrix<FloatT> U( n, n );
+    Matrix<FloatT> T( unitary_nb, n );
     Vector<FloatT> tau( n );
 
-    // query for workspace
-    magma_int_t lwork = -1;
-    lapack::unmqr( "Left", "NoTrans", n, n, n,
-                   U(0,0), U.ld, tau(0), A(0,0), A.ld,
-                   &tmp, lwork, &info );
-    assert( info == 0 );
-    lwork = magma_int_t( real( tmp ));
-    magma_int_t lwork2 = -1;
-    lapack::unmqr( "Right", "ConjTrans", n, n, n,
-                   U(0,0), U.ld, tau(0), A(0,0), A.ld,
-                   &tmp, lwork2, &info );
-    assert( info == 0 );
-    lwork2 = magma_int_t( real( tmp ));
-    lwork = max( lwork, lwork2 );
-    Vector<FloatT> work( lwork );
-
     // ----------
-    magma_generate_sigma( opts, dist, rand_sign, cond, sigma_max, A, sigma );
+    magma_generate_sigma( seed, dist, rand_sign, cond, sigma_max, A, sigma );
 
     // random U, n-by-n
-    // just make each random column into a Householder vector;
-    // no need to update subsequent columns (as in geqrf).
-    sizeU = U.size();
-    lapack::larnv( idist_randn, opts.iseed, sizeU, U(0,0) );
-    for (magma_int_t j = 0; j < n; ++j) {
-        magma_int_t nj = n - j;
-        lapack::larfg( nj, U(j,j), U(j+1,j), 1, tau(j) );
-    }
+    magma_generate_unitary( seed.key( Stream::U ), U, tau, T );
 
     // A = U*A
-    lapack::unmqr( "Left", "NoTrans", n, n, n,
-                   U(0,0), U.ld, tau(0), A(0,0), A.ld,
-                   work(0), lwork, &info );
-    assert( info == 0 );
+    magma_apply_unitary( "Left", "NoTrans", U, T, A );
 
     // A = A*U^H
-    lapack::unmqr( "Right", "ConjTrans", n, n, n,
-                   U(0,0), U.ld, tau(0), A(0,0), A.ld,
-                   work(0), lwork, &info );
-    assert( info == 0 );
+    magma_apply_unitary( "Right", "ConjTrans", U, T, A );
 
     // make diagonal real
     // usually LAPACK ignores imaginary part anyway, but Matlab doesn't
@@ -462,10 +724,11 @@ void magma_generate_heev(
         // A = D*A*D row & column scaling
         Vector<real_t> D( n );
         real_t range = log( condD );
-        lapack::larnv( idist_rand, opts.iseed, n, D(0) );
+        magma_generate_rand( seed.key( Stream::D ), idist_rand, n, 1, D(0), n );
         for (magma_int_t i = 0; i < n; ++i) {
             D[i] = exp( D[i] * range );
         }
+        #pragma omp parallel for schedule(static)
         for (magma_int_t j = 0; j < n; ++j) {
             for (magma_int_t i = 0; i < n; ++i) {
                 *A(i,j) *= D[i] * D[j];
@@ -478,6 +741,7 @@ void magma_generate_heev(
 template< typename FloatT >
 void magma_generate_geev(
     magma_opts& opts,
+    rng_seed const& seed,
     Dist dist,
     typename blas::traits<FloatT>::real_t cond,
     typename blas::traits<FloatT>::real_t condD,
@@ -485,13 +749,63 @@ void magma_generate_geev(
     Matrix<FloatT>& A,
     Vector< typename blas::traits<FloatT>::real_t >& sigma )
 {
-    throw std::exception();  // not implemented
+    typedef typename blas::traits<FloatT>::real_t real_t;
+
+    // check inputs
+    assert( A.m == A.n );
+
+    // locals
+    magma_int_t n = A.n;
+    Matrix<FloatT> U( n, n );
+    Matrix<FloatT> T( unitary_nb, n );
+    Vector<FloatT> tau( n );
+
+    // ----------
+    // eigenvalues Lambda on the diagonal
+    magma_generate_sigma( seed, dist, true, cond, sigma_max, A, sigma );
+
+    // Schur form T = Lambda + strictly upper triangle, random normal
+    // entries scaled so the triangle is about as large as Lambda
+    magma_generate_rand( seed.key( Stream::A ), idist_randn, n, n, U(0,0), U.ld );
+    real_t scale = sigma_max / sqrt( real_t( max( 1, n ) ));
+    #pragma omp parallel for schedule(static)
+    for (magma_int_t j = 1; j < n; ++j) {
+        for (magma_int_t i = 0; i < j; ++i) {
+            *A(i,j) = *U(i,j) * scale;
+        }
+    }
+
+    // random U, n-by-n
+    magma_generate_unitary( seed.key( Stream::U ), U, tau, T );
+
+    // A = U*A
+    magma_apply_unitary( "Left", "NoTrans", U, T, A );
+
+    // A = A*U^H
+    magma_apply_unitary( "Right", "ConjTrans", U, T, A );
+
+    if (condD != 1) {
+        // A = D*A*D^{-1} similarity scaling; eigenvalues don't change
+        Vector<real_t> D( n );
+        real_t range = log( condD );
+        magma_generate_rand( seed.key( Stream::D ), idist_rand, n, 1, D(0), n );
+        for (magma_int_t i = 0; i < n; ++i) {
+            D[i] = exp( D[i] * range );
+        }
+        #pragma omp parallel for schedule(static)
+        for (magma_int_t j = 0; j < n; ++j) {
+            for (magma_int_t i = 0; i < n; ++i) {
+                *A(i,j) *= D[i] / D[j];
+            }
+        }
+    }
 }
 
 /******************************************************************************/
 template< typename FloatT >
 void magma_generate_geevx(
     magma_opts& opts,
+    rng_seed const& seed,
     Dist dist,
     typename blas::traits<FloatT>::real_t cond,
     typename blas::traits<FloatT>::real_t condD,
@@ -561,7 +875,7 @@ void magma_generate_geevx(
     spd#*       alias for poev
     heev#*      A = V Lambda V^H (eigenvalues mixed signs)
     syev#*      alias for heev
-    geev#*      A = V T V^H, Schur-form T                       [not yet implemented]
+    geev#*      A = V T V^H, Schur-form T, eigenvalues Lambda (mixed signs)
     geevx#*     A = X T X^{-1}, Schur-form T, X ill-conditioned [not yet implemented]
 
     # optional distribution suffix
@@ -600,10 +914,23 @@ void magma_generate_geevx(
     For heev, A0 = U Lambda U^H, A = D K A0 K D, where
     K is diagonal such that (K A0 K) has unit diagonal, and D is as above.
 
+    For geev, A = D A0 D^{-1}, with D as above; this similarity leaves the
+    eigenvalues unchanged but makes them more ill-conditioned.
+
     Note using condD changes the singular or eigenvalues; on output, sigma
     contains the singular or eigenvalues of A0, not of A.
     See: Demmel and Veselic, Jacobi's method is more accurate than QR, 1992.
 
+    Random numbers come from a counter-based generator (Philox), seeded from
+    opts.iseed, so generation is parallel and the random entries do not depend
+    on the number of threads. Each call advances opts.iseed. Orthogonal U and V
+    are applied with multithreaded BLAS, whose rounding may depend on its
+    number of threads.
+
+    With --matrix-cache dir (or $MAGMA_MATRIX_CACHE), large svd, poev, and heev
+    matrices are saved to dir and read back by later runs with the same
+    precision, --matrix, size, --cond, --condD, and seed.
+
     @ingroup testing
 *******************************************************************************/
 template< typename FloatT >
@@ -722,6 +1049,22 @@ void magma_generate_matrix(
     else if (contains( name, "_ufl"    )) { sigma_max = ufl; }
     else if (contains( name, "_ofl"    )) { sigma_max = ofl; }
 
+    // ----- seed; advances opts.iseed even if matrix is read from cache
+    rng_seed seed( opts.iseed );
+
+    bool use_cache = (! opts.matrix_cache.empty()
+                      && (type == MatrixType::svd  ||
+                          type == MatrixType::poev ||
+                          type == MatrixType::heev)
+                      && double( A.m ) * A.n >= cache_min_size);
+    std::string filename;
+    if (use_cache) {
+        filename = cache_filename<FloatT>( opts, seed, cond, condD, A.m, A.n );
+        if (cache_read( filename, A, sigma )) {
+            return;
+        }
+    }
+
     // ----- generate matrix
     switch (type) {
         case MatrixType::zero:
@@ -745,37 +1088,41 @@ void magma_generate_matrix(
         case MatrixType::randu:
         case MatrixType::randn: {
             magma_int_t idist = (magma_int_t) type;
-            magma_int_t sizeA = A.ld * A.n;
-            lapack::larnv( idist, opts.iseed, sizeA, A(0,0) );
+            magma_generate_rand( seed.key( Stream::A ), idist, A.m, A.n, A(0,0), A.ld );
             if (sigma_max != 1) {
                 FloatT scale = blas::traits<FloatT>::make( sigma_max, 0 );
-                blas::scal( sizeA, scale, A(0,0), 1 );
+                #pragma omp parallel for schedule(static)
+                for (magma_int_t j = 0; j < A.n; ++j) {
+                    for (magma_int_t i = 0; i < A.m; ++i) {
+                        *A(i,j) *= scale;
+                    }
+                }
             }
             break;
         }
 
         case MatrixType::diag:
-            magma_generate_sigma( opts, dist, false, cond, sigma_max, A, sigma );
+            magma_generate_sigma( seed, dist, false, cond, sigma_max, A, sigma );
             break;
 
         case MatrixType::svd:
-            magma_generate_svd( opts, dist, cond, condD, sigma_max, A, sigma );
+            magma_generate_svd( opts, seed, dist, cond, condD, sigma_max, A, sigma );
             break;
 
         case MatrixType::poev:
-            magma_generate_heev( opts, dist, false, cond, condD, sigma_max, A, sigma );
+            magma_generate_heev( opts, seed, dist, false, cond, condD, sigma_max, A, sigma );
             break;
 
         case MatrixType::heev:
-            magma_generate_heev( opts, dist, true, cond, condD, sigma_max, A, sigma );
+            magma_generate_heev( opts, seed, dist, true, cond, condD, sigma_max, A, sigma );
             break;
 
         case MatrixType::geev:
-            magma_generate_geev( opts, dist, cond, condD, sigma_max, A, sigma );
+            magma_generate_geev( opts, seed, dist, cond, condD, sigma_max, A, sigma );
             break;
 
         case MatrixType::geevx:
-            magma_generate_geevx( opts, dist, cond, condD, sigma_max, A, sigma );
+            magma_generate_geevx( opts, seed, dist, cond, condD, sigma_max, A, sigma );
             break;
     }
 
@@ -789,6 +1136,10 @@ void magma_generate_matrix(
         // reset sigma to unknown (nan)
         lapack::laset( "general", sigma.n, 1, nan, nan, sigma(0), sigma.n );
     }
+
+    if (use_cache) {
+        cache_write( filename, A, sigma );
+    }
 }
 
 
@@ -95,6 +95,13 @@ const char *usage =
 "  --dev x          GPU device to use, default 0.\n"
 "  --align n        Round up LDDA on GPU to multiple of align, default 32.\n"
 "  --verbose        Verbose output.\n"
+"  --output f       Also write each result as a machine-readable record, f is one of:\n"
+"         text*     no records, only the usual table\n"
+"         json      JSON Lines, one object per line\n"
+"         csv       CSV, with a header row\n"
+"                   Records include sizes, options, Gflop/s, time, error, host info,\n"
+"                   and git revision. Compare runs with testing/run_compare.py.\n"
+"  --output-file path  File for records, default stdout (interleaved with the table).\n"
 "\n"
 "The following options apply to only some routines.\n"
 "  --batch x        number of matrices for the batched routines, default 1000.\n"
@@ -146,6 +153,8 @@ const char *usage =
 "                   or 'rand_dominant' if SPD required (e.g., for posv).\n"
 "  --cond   kA      where applicable, condition number for test matrix, default sqrt( 1/eps ); see magma_generate_matrix.\n"
 "  --condD  kD      where applicable, condition number for scaling test matrix, default 1; see magma_generate_matrix.\n"
+"  --matrix-cache dir  save large svd, poev, heev test matrices in dir and reuse them;\n"
+"                   default $MAGMA_MATRIX_CACHE, else no cache.\n"
 "\n"
 "                   * default values\n";
 
@@ -171,6 +180,8 @@ magma_opts::magma_opts( magma_opts_t flag )
     this->itype    = 1;
     this->version  = 1;
     this->verbose  = 0;
+    this->output      = MagmaOutputText;
+    this->output_file = NULL;
     
     this->fraction_lo = 0.;
     this->fraction_up = 1.;
@@ -197,6 +208,8 @@ magma_opts::magma_opts( magma_opts_t flag )
     this->matrix    = "rand";
     this->cond      = 0;  // zero means cond = sqrt( 1/eps ), which varies by precision
     this->condD     = 1;
+    const char* cache = getenv( "MAGMA_MATRIX_CACHE" );
+    this->matrix_cache = (cache != NULL ? cache : "");
     
     this->iseed[0]  = 0;
     this->iseed[1]  = 0;
@@ -402,6 +415,26 @@ void magma_opts::parse_opts( int argc, char** argv )
             magma_assert( this->niter > 0,
                           "error: --niter %s is invalid; ensure niter > 0.\n", argv[i] );
         }
+        else if ( (strcmp("--output", argv[i]) == 0 && i+1 < argc) ||
+                  strncmp("--output=", argv[i], 9) == 0 ) {
+            const char* arg = (argv[i][8] == '=' ? argv[i] + 9 : argv[++i]);
+            if      ( strcmp( arg, "text" ) == 0 ) { this->output = MagmaOutputText; }
+            else if ( strcmp( arg, "json" ) == 0 ) { this->output = MagmaOutputJson; }
+            else if ( strcmp( arg, "csv"  ) == 0 ) { this->output = MagmaOutputCsv;  }
+            else {
+                fprintf( stderr, "error: --output %s is invalid; ensure output in [text, json, csv].\n", arg );
+                exit(1);
+            }
+        }
+        else if ( strcmp("--output-file", argv[i]) == 0 && i+1 < argc ) {
+            i++;
+            if ( this->output_file != NULL ) {
+                fclose( this->output_file );
+            }
+            this->output_file = fopen( argv[i], "a" );
+            magma_assert( this->output_file != NULL,
+                          "error: --output-file %s: cannot open: %s.\n", argv[i], strerror( errno ));
+        }
         else if ( strcmp("--nthread", argv[i]) == 0 && i+1 < argc ) {
             this->nthread = atoi( argv[++i] );
             magma_assert( this->nthread > 0,
@@ -592,6 +625,10 @@ void magma_opts::parse_opts( int argc, char** argv )
             magma_assert( this->condD >= 1,
                           "error: --condD %s is invalid; ensure condD >= 1.\n", argv[i] );
         }
+        else if ( strcmp("--matrix-cache", argv[i]) == 0 && i+1 < argc) {
+            i += 1;
+            this->matrix_cache = argv[i];
+        }
 
         // ----- usage
         else if ( strcmp("-h",     argv[i]) == 0 ||
@@ -708,6 +745,167 @@ void magma_opts::cleanup()
     #ifdef HAVE_CUBLAS
     this->handle = NULL;
     #endif
+    
+    if ( this->output_file != NULL ) {
+        fclose( this->output_file );
+        this->output_file = NULL;
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+// For CPU reference of batched routines, parallel across matrices:
+// switches to single-threaded BLAS inside an OpenMP team of the same size.
+// Returns previous number of BLAS threads, to restore with magma_batched_ref_end.
+extern "C"
+magma_int_t magma_batched_ref_begin()
+{
+    magma_int_t nthreads = magma_get_lapack_numthreads();
+    #ifdef _OPENMP
+    magma_set_lapack_numthreads( 1 );
+    magma_set_omp_numthreads( nthreads );
+    #endif
+    return nthreads;
+}
+
+extern "C"
+void magma_batched_ref_end( magma_int_t nthreads )
+{
+    #ifdef _OPENMP
+    magma_set_lapack_numthreads( nthreads );
+    #endif
+}
+
+
+// -----------------------------------------------------------------------------
+// 64-bit FNV-1a hash of bytes.
+// Data is hashed in fixed-size chunks in parallel, then chunk hashes are
+// combined in order, so the result is independent of the number of threads.
+static const uint64_t fnv_offset = 14695981039346656037ull;
+static const uint64_t fnv_prime  = 1099511628211ull;
+
+static uint64_t fnv1a( const unsigned char* data, size_t bytes, uint64_t h )
+{
+    for (size_t i = 0; i < bytes; ++i) {
+        h = (h ^ data[i]) * fnv_prime;
+    }
+    return h;
+}
+
+uint64_t magma_hash( const void* data, size_t bytes )
+{
+    const size_t chunk = 1024*1024;
+    const unsigned char* ptr = (const unsigned char*) data;
+    long nchunk = (long) ((bytes + chunk - 1) / chunk);
+    std::vector< uint64_t > hashes( nchunk );
+
+    #pragma omp parallel for schedule(static)
+    for (long c = 0; c < nchunk; ++c) {
+        size_t begin = c * chunk;
+        size_t len   = min( chunk, bytes - begin );
+        hashes[c] = fnv1a( ptr + begin, len, fnv_offset );
+    }
+
+    uint64_t h = fnv_offset;
+    if (nchunk > 0) {
+        h = fnv1a( (const unsigned char*) &hashes[0],
+                   nchunk * sizeof(uint64_t), h );
+    }
+    return h;
+}
+
+
+// -----------------------------------------------------------------------------
+// Key for magma_ref_cache: routine name, dimensions, and hash of the inputs,
+// e.g., "zgetrf_batched 32 32 1000 #3fa2c...".
+std::string magma_ref_key(
+    const char* routine,
+    std::vector< magma_int_t > const& dims,
+    std::vector< magma_ref_buffer > const& inputs )
+{
+    char buf[ 64 ];
+    std::string key = routine;
+    for (size_t i = 0; i < dims.size(); ++i) {
+        snprintf( buf, sizeof(buf), " %lld", (long long) dims[i] );
+        key += buf;
+    }
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        snprintf( buf, sizeof(buf), " #%016llx",
+                  (unsigned long long) magma_hash( inputs[i].ptr, inputs[i].bytes ));
+        key += buf;
+    }
+    return key;
+}
+
+
+// -----------------------------------------------------------------------------
+// Copies bytes in parallel; reference outputs of large batches are many GiB.
+static void magma_ref_copy( void* dst, const void* src, size_t bytes )
+{
+    const size_t chunk = 1024*1024;
+    long nchunk = (long) ((bytes + chunk - 1) / chunk);
+    #pragma omp parallel for schedule(static)
+    for (long c = 0; c < nchunk; ++c) {
+        size_t begin = c * chunk;
+        memcpy( (char*) dst + begin, (const char*) src + begin,
+                min( chunk, bytes - begin ));
+    }
+}
+
+magma_ref_cache::magma_ref_cache():
+    ncompute( 0 ),
+    nreuse( 0 ),
+    compute_time( 0 ),
+    reuse_time( 0 ),
+    time_( 0 )
+{}
+
+bool magma_ref_cache::lookup(
+    std::string const& key,
+    std::vector< magma_ref_buffer > const& bufs, double* time )
+{
+    if (key != key_ || bufs.size() != data_.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < bufs.size(); ++i) {
+        if (bufs[i].bytes != data_[i].size()) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < bufs.size(); ++i) {
+        if (bufs[i].bytes > 0) {
+            magma_ref_copy( bufs[i].ptr, &data_[i][0], bufs[i].bytes );
+        }
+    }
+    *time = time_;
+    nreuse     += 1;
+    reuse_time += time_;
+    return true;
+}
+
+void magma_ref_cache::store(
+    std::string const& key,
+    std::vector< magma_ref_buffer > const& bufs, double time )
+{
+    key_  = key;
+    time_ = time;
+    data_.resize( bufs.size() );
+    for (size_t i = 0; i < bufs.size(); ++i) {
+        data_[i].resize( bufs[i].bytes );
+        if (bufs[i].bytes > 0) {
+            magma_ref_copy( &data_[i][0], bufs[i].ptr, bufs[i].bytes );
+        }
+    }
+    ncompute     += 1;
+    compute_time += time;
+}
+
+void magma_ref_cache::print_stats() const
+{
+    printf( "%% CPU reference: computed %lld times (%.2f sec), "
+            "reused %lld times (saved %.2f sec)\n",
+            (long long) ncompute, compute_time,
+            (long long) nreuse,   reuse_time );
 }
 
 
@@ -0,0 +1,196 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+
+       CPU reference results for the batched and vbatched testers.
+       Parallelism is across matrices: each OpenMP thread handles whole
+       matrices with single-threaded BLAS/LAPACK.
+*/
+
+#include <algorithm>  // sort
+#include <vector>
+
+#include "magma_v2.h"
+#include "magma_lapack.h"
+
+#include "testings.h"
+
+/******************************************************************************/
+// Order matrices by decreasing cost, so that with dynamic scheduling the
+// largest matrices start first and the small ones fill in at the end.
+// Otherwise a large matrix near the end of a vbatched batch leaves one
+// thread working alone.
+static void ref_order(
+    magma_int_t batchCount, std::vector<double> const& cost,
+    std::vector<magma_int_t>& order )
+{
+    order.resize( batchCount );
+    for (magma_int_t s = 0; s < batchCount; ++s) {
+        order[s] = s;
+    }
+    std::stable_sort( order.begin(), order.end(),
+                      [&cost]( magma_int_t a, magma_int_t b ) { return cost[a] > cost[b]; } );
+}
+
+
+/***************************************************************************//**
+    Reference C_s = alpha op(A_s) op(B_s) + beta C_s for s = 0, ..., batchCount-1,
+    with per-matrix sizes as in magmablas_zgemm_vbatched.
+    Sizes and leading dimensions are host arrays.
+*******************************************************************************/
+extern "C"
+void magma_zgemm_vbatched_ref(
+    magma_trans_t transA, magma_trans_t transB,
+    magma_int_t* m, magma_int_t* n, magma_int_t* k,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex const * const * hA_array, magma_int_t* lda,
+    magmaDoubleComplex const * const * hB_array, magma_int_t* ldb,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex **hC_array, magma_int_t* ldc,
+    magma_int_t batchCount )
+{
+    std::vector<double> cost( batchCount );
+    for (magma_int_t s = 0; s < batchCount; ++s) {
+        cost[s] = double(m[s]) * n[s] * k[s];
+    }
+    std::vector<magma_int_t> order;
+    ref_order( batchCount, cost, order );
+
+    magma_int_t nthreads = magma_batched_ref_begin();
+    #pragma omp parallel for schedule(dynamic)
+    for (magma_int_t i = 0; i < batchCount; ++i) {
+        magma_int_t s = order[i];
+        blasf77_zgemm( lapack_trans_const(transA),
+                       lapack_trans_const(transB),
+                       &m[s], &n[s], &k[s],
+                       &alpha, hA_array[s], &lda[s],
+                               hB_array[s], &ldb[s],
+                       &beta,  hC_array[s], &ldc[s] );
+    }
+    magma_batched_ref_end( nthreads );
+}
+
+
+/***************************************************************************//**
+    Reference LU factorization with partial pivoting, P_s A_s = L_s U_s,
+    of a batch of m-by-n matrices. Info for each matrix is returned in
+    info_array.
+*******************************************************************************/
+extern "C"
+void magma_zgetrf_batched_ref(
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    magma_int_t **ipiv_array, magma_int_t *info_array,
+    magma_int_t batchCount )
+{
+    magma_int_t nthreads = magma_batched_ref_begin();
+    #pragma omp parallel for schedule(dynamic)
+    for (magma_int_t s = 0; s < batchCount; ++s) {
+        lapackf77_zgetrf( &m, &n, hA_array[s], &lda, ipiv_array[s], &info_array[s] );
+    }
+    magma_batched_ref_end( nthreads );
+}
+
+
+/***************************************************************************//**
+    Reference Cholesky factorization of a batch of n-by-n matrices.
+    Info for each matrix is returned in info_array.
+*******************************************************************************/
+extern "C"
+void magma_zpotrf_batched_ref(
+    magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    magma_int_t *info_array,
+    magma_int_t batchCount )
+{
+    magma_int_t nthreads = magma_batched_ref_begin();
+    #pragma omp parallel for schedule(dynamic)
+    for (magma_int_t s = 0; s < batchCount; ++s) {
+        lapackf77_zpotrf( lapack_uplo_const(uplo), &n, hA_array[s], &lda, &info_array[s] );
+    }
+    magma_batched_ref_end( nthreads );
+}
+
+
+/***************************************************************************//**
+    Reference Cholesky factorization of a batch of matrices of sizes n[s],
+    as in magma_zpotrf_vbatched. Sizes and leading dimensions are host arrays.
+*******************************************************************************/
+extern "C"
+void magma_zpotrf_vbatched_ref(
+    magma_uplo_t uplo, magma_int_t* n,
+    magmaDoubleComplex **hA_array, magma_int_t* lda,
+    magma_int_t *info_array,
+    magma_int_t batchCount )
+{
+    std::vector<double> cost( batchCount );
+    for (magma_int_t s = 0; s < batchCount; ++s) {
+        cost[s] = double(n[s]) * n[s] * n[s];
+    }
+    std::vector<magma_int_t> order;
+    ref_order( batchCount, cost, order );
+
+    magma_int_t nthreads = magma_batched_ref_begin();
+    #pragma omp parallel for schedule(dynamic)
+    for (magma_int_t i = 0; i < batchCount; ++i) {
+        magma_int_t s = order[i];
+        lapackf77_zpotrf( lapack_uplo_const(uplo), &n[s], hA_array[s], &lda[s], &info_array[s] );
+    }
+    magma_batched_ref_end( nthreads );
+}
+
+
+/***************************************************************************//**
+    Computes norm of each matrix in a batch, values[s] = norm( A_s ),
+    where norm is "M", "1", "I", or "F" as in lapackf77_zlange.
+    Sizes and leading dimensions are host arrays; for a fixed-size batch,
+    use magma_zlange_batched_ref.
+*******************************************************************************/
+extern "C"
+void magma_zlange_vbatched_ref(
+    const char* norm,
+    magma_int_t* m, magma_int_t* n,
+    magmaDoubleComplex const * const * hA_array, magma_int_t* lda,
+    double *values,
+    magma_int_t batchCount )
+{
+    magma_int_t nthreads = magma_batched_ref_begin();
+    #pragma omp parallel
+    {
+        // lange needs work of size m for infinity norm
+        std::vector<double> work;
+        #pragma omp for schedule(dynamic)
+        for (magma_int_t s = 0; s < batchCount; ++s) {
+            work.resize( max( 1, m[s] ));
+            values[s] = lapackf77_zlange( norm, &m[s], &n[s], hA_array[s], &lda[s], &work[0] );
+        }
+    }
+    magma_batched_ref_end( nthreads );
+}
+
+
+/******************************************************************************/
+extern "C"
+void magma_zlange_batched_ref(
+    const char* norm,
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex const * const * hA_array, magma_int_t lda,
+    double *values,
+    magma_int_t batchCount )
+{
+    magma_int_t nthreads = magma_batched_ref_begin();
+    #pragma omp parallel
+    {
+        std::vector<double> work( max( 1, m ));
+        #pragma omp for schedule(dynamic)
+        for (magma_int_t s = 0; s < batchCount; ++s) {
+            values[s] = lapackf77_zlange( norm, &m, &n, hA_array[s], &lda, &work[0] );
+        }
+    }
+    magma_batched_ref_end( nthreads );
+}
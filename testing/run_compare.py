@@ -0,0 +1,280 @@
+#!/usr/bin/env python
+#
+# MAGMA (version 2.0) --
+# Univ. of Tennessee, Knoxville
+# Univ. of California, Berkeley
+# Univ. of Colorado, Denver
+# @date
+
+## @file run_compare.py
+#
+# Usage:
+# Run testers with machine-readable output, once for the baseline and once
+# for the change, using --niter to get repeated samples of each test:
+#     ./testing_zgetrf -N 1000:5000:1000 --niter 5 --output json --output-file base.jsonl
+#     (rebuild with the change)
+#     ./testing_zgetrf -N 1000:5000:1000 --niter 5 --output json --output-file new.jsonl
+#
+# Then compare them:
+#     ./run_compare.py base.jsonl new.jsonl
+#
+# Records are matched by routine and all sizes and options (every field except
+# performance, errors, status, and host information). For each match, the
+# --niter samples of the metric (default magma_time) are compared with
+# Welch's t-test. A test is flagged "slower" if it is slower by more than
+# --threshold (default 5%) and the one-sided p-value is below --alpha
+# (default 0.05); likewise "faster". With fewer than 2 samples on either side,
+# there is no p-value, and the threshold alone decides, flagged with "?".
+#
+# Input files are JSON Lines or CSV written by --output json|csv. Other lines,
+# such as the usual text table when records are written to stdout, are ignored.
+#
+# Exits with status 1 if any test is slower, so it can be used in scripts.
+
+from __future__ import print_function
+
+import sys
+import csv
+import json
+import math
+
+from optparse import OptionParser
+
+parser = OptionParser( usage='%prog [options] baseline new' )
+parser.add_option( '--metric',     action='store', default='magma_time',
+	help='field to compare, e.g., magma_time, cpu_time, magma_gflops; default magma_time. '
+	    +'Fields ending in _gflops are higher-is-better, others lower-is-better.' )
+parser.add_option( '--threshold',  action='store', type=float, default=0.05,
+	help='minimum relative change to flag, default 0.05 (5%)' )
+parser.add_option( '--alpha',      action='store', type=float, default=0.05,
+	help='significance level for the one-sided t-test, default 0.05' )
+parser.add_option( '--skip-first', action='store_true', default=False,
+	help='drop iteration 0 of each test (warmup)' )
+parser.add_option( '--all',        action='store_true', default=False,
+	help='print all tests, not only changed ones' )
+
+(opts, args) = parser.parse_args()
+if (len(args) != 2):
+	parser.error( 'expected two files, baseline and new' )
+
+
+# --------------------
+# fields that are not part of a test's identity
+info_fields = set([
+	'routine', 'iter', 'status',
+	'host', 'device', 'omp_threads', 'lapack_threads',
+	'magma_version', 'git', 'date',
+])
+
+def is_result( name ):
+	return (name in info_fields
+	        or name.endswith( '_gflops' )
+	        or name.endswith( '_time' )
+	        or 'error' in name)
+# end
+
+
+# --------------------
+# Returns list of records (dicts) in file. Values are strings or numbers.
+def read_records( filename ):
+	records = []
+	header  = None
+	with open( filename ) as f:
+		for line in f:
+			line = line.strip()
+			if (line.startswith( '{' )):
+				try:
+					records.append( json.loads( line ))
+				except ValueError:
+					pass
+			elif (line.startswith( 'routine,' )):
+				header = next( csv.reader( [line] ))
+			elif (header and ',' in line):
+				row = next( csv.reader( [line] ))
+				if (len(row) == len(header)):
+					records.append( dict( zip( header, row )))
+	return records
+# end
+
+
+# --------------------
+def to_float( value ):
+	try:
+		return float( value )
+	except (TypeError, ValueError):
+		return float('nan')
+# end
+
+
+# --------------------
+# Groups records by test; returns dict of key -> list of samples of metric.
+# Key is routine followed by sorted (name, value) of sizes and options.
+def group( records ):
+	groups = {}
+	for rec in records:
+		if (opts.metric not in rec):
+			continue
+		if (opts.skip_first and str( rec.get( 'iter' )) == '0'):
+			continue
+		x = to_float( rec[ opts.metric ] )
+		if (math.isnan( x ) or math.isinf( x )):
+			continue
+		params = sorted( [ (k, str(v)) for (k, v) in rec.items() if not is_result( k ) ] )
+		key = (str( rec.get( 'routine' )),) + tuple( params )
+		groups.setdefault( key, [] ).append( x )
+	return groups
+# end
+
+
+# --------------------
+def mean_var( x ):
+	n = len(x)
+	m = sum( x ) / n
+	v = (sum( [ (xi - m)**2 for xi in x ] ) / (n - 1) if n > 1 else 0.)
+	return (m, v)
+# end
+
+
+# --------------------
+# Continued fraction for the incomplete beta function, Numerical Recipes betacf.
+def betacf( a, b, x ):
+	tiny = 1e-300
+	qab = a + b
+	qap = a + 1.
+	qam = a - 1.
+	c = 1.
+	d = 1. - qab*x/qap
+	if (abs( d ) < tiny):
+		d = tiny
+	d = 1./d
+	h = d
+	for m in range( 1, 300 ):
+		m2 = 2*m
+		aa = m*(b - m)*x / ((qam + m2)*(a + m2))
+		d = 1. + aa*d
+		if (abs( d ) < tiny):
+			d = tiny
+		c = 1. + aa/c
+		if (abs( c ) < tiny):
+			c = tiny
+		d = 1./d
+		h *= d*c
+		aa = -(a + m)*(qab + m)*x / ((a + m2)*(qap + m2))
+		d = 1. + aa*d
+		if (abs( d ) < tiny):
+			d = tiny
+		c = 1. + aa/c
+		if (abs( c ) < tiny):
+			c = tiny
+		d = 1./d
+		delta = d*c
+		h *= delta
+		if (abs( delta - 1. ) < 1e-14):
+			break
+	return h
+# end
+
+
+# --------------------
+# Regularized incomplete beta function I_x(a, b).
+def betai( a, b, x ):
+	if (x <= 0.):
+		return 0.
+	if (x >= 1.):
+		return 1.
+	bt = math.exp( math.lgamma( a + b ) - math.lgamma( a ) - math.lgamma( b )
+	               + a*math.log( x ) + b*math.log( 1. - x ))
+	if (x < (a + 1.) / (a + b + 2.)):
+		return bt * betacf( a, b, x ) / a
+	else:
+		return 1. - bt * betacf( b, a, 1. - x ) / b
+# end
+
+
+# --------------------
+# Upper tail P(T > t) of Student's t distribution with df degrees of freedom.
+def t_sf( t, df ):
+	tail = 0.5 * betai( 0.5*df, 0.5, df / (df + t*t) )
+	return (tail if t > 0 else 1. - tail)
+# end
+
+
+# --------------------
+# One-sided Welch's t-test that mean of y exceeds mean of x.
+# Returns p-value, or None if either has fewer than 2 samples.
+def welch_greater( x, y ):
+	if (len(x) < 2 or len(y) < 2):
+		return None
+	(mx, vx) = mean_var( x )
+	(my, vy) = mean_var( y )
+	sx = vx / len(x)
+	sy = vy / len(y)
+	if (sx + sy == 0):
+		return (0. if my > mx else 1.)
+	t  = (my - mx) / math.sqrt( sx + sy )
+	df = (sx + sy)**2 / (sx**2/(len(x) - 1) + sy**2/(len(y) - 1))
+	return t_sf( t, df )
+# end
+
+
+# --------------------
+def format_key( key ):
+	return key[0] + '  ' + ' '.join( [ '%s=%s' % kv for kv in key[1:] ] )
+# end
+
+
+# --------------------
+base = group( read_records( args[0] ))
+new  = group( read_records( args[1] ))
+
+# for Gflop/s, higher is better; negate so "greater" always means slower.
+higher_better = opts.metric.endswith( '_gflops' )
+sign = (-1. if higher_better else 1.)
+
+nslower = 0
+nfaster = 0
+nsame   = 0
+rows    = []
+for key in sorted( set( base.keys() ) & set( new.keys() )):
+	x = base[key]
+	y = new[key]
+	mx = mean_var( x )[0]
+	my = mean_var( y )[0]
+	if (mx == 0 or my == 0):
+		continue
+	# slowdown > 0 means new is slower
+	slowdown = (mx / my - 1. if higher_better else my / mx - 1.)
+	p_slow = welch_greater( [ sign*xi for xi in x ], [ sign*yi for yi in y ] )
+	p_fast = welch_greater( [ sign*yi for yi in y ], [ sign*xi for xi in x ] )
+	flag = ''
+	if (slowdown > opts.threshold and (p_slow is None or p_slow < opts.alpha)):
+		flag = 'slower'
+		nslower += 1
+	elif (-slowdown > opts.threshold and (p_fast is None or p_fast < opts.alpha)):
+		flag = 'faster'
+		nfaster += 1
+	else:
+		nsame += 1
+	p = (p_slow if slowdown > 0 else p_fast)
+	if (flag and p is None):
+		flag += ' ?'
+	if (flag or opts.all):
+		rows.append( (key, len(x), len(y), mx, my, slowdown, p, flag) )
+# end
+
+only_base = len( set( base.keys() ) - set( new.keys() ))
+only_new  = len( set( new.keys() ) - set( base.keys() ))
+
+print( '%% metric %s (%s is better), threshold %.1f%%, alpha %.3g'
+       % (opts.metric, ('higher' if higher_better else 'lower'), 100*opts.threshold, opts.alpha) )
+print( '% n_base n_new      baseline           new  slowdown   p-value   flag     test' )
+print( '%' + '=' * 110 )
+for (key, nx, ny, mx, my, slowdown, p, flag) in rows:
+	pstr = ('%9.2e' % p if p is not None else '      ---')
+	print( '%7d %5d   %11.4g   %11.4g   %+7.1f%%   %s   %-8s %s'
+	       % (nx, ny, mx, my, 100*slowdown, pstr, flag, format_key( key )) )
+print()
+print( '%% %d slower, %d faster, %d unchanged; %d tests only in baseline, %d only in new'
+       % (nslower, nfaster, nsame, only_base, only_new) )
+
+sys.exit( 1 if nslower > 0 else 0 )
@@ -132,6 +132,36 @@
 # 		./run_tests.py testing_ssygvdx_2stage -L -JN --itype 1 -s --no-mgpu
 #
 #
+# Parallel runs
+# -------------
+# The -j/--jobs option runs several testers concurrently, which makes the
+# --small and --medium sweeps, dominated by CPU reference computations and
+# process startup, finish several times faster. For example:
+#
+#       ./run_tests.py -j 8 --small --medium > run.txt
+#
+# Jobs are packed into a budget of CPU cores, by default all cores this
+# process may use, or the first --cores. Each job gets --threads CPU threads
+# (default cores/jobs), scaled up for testers dominated by multithreaded
+# LAPACK (eigenvalue, SVD, batched) and down for BLAS and auxiliary testers;
+# see job_weights below. Unless --no-pin is given, each job is pinned to its
+# cores with taskset and OMP_PLACES, and OMP_NUM_THREADS, MKL_NUM_THREADS,
+# and OPENBLAS_NUM_THREADS are set to its thread count.
+#
+# By default, all jobs may share the GPU; --gpu-jobs limits how many GPU
+# testers run at once. Multi-GPU testers run alone on the GPUs, and
+# CPU-only testers (testing_zgenerate) don't count against --gpu-jobs.
+# Timings from concurrent testers are not meaningful; use -j 1 (default)
+# for performance runs.
+#
+# Output of each tester is buffered and printed in the same order as a serial
+# run, with an additional "% threads on cores" line, so run_summarize.py
+# works on it unchanged.
+#
+# The --timeout option kills a tester that runs longer than the given number
+# of seconds, reporting it as an error. It works with and without -j.
+#
+#
 # What is checked
 # ------------------
 # The --memcheck option runs cuda-memcheck. This is very helpful for finding
@@ -214,9 +244,14 @@ import os
 import re
 import sys
 import time
+import signal
+import tempfile
+import threading
+import multiprocessing
 
 import subprocess
 from subprocess import PIPE, STDOUT
+from distutils.spawn import find_executable
 
 from optparse import OptionParser
 
@@ -230,6 +265,14 @@ parser.add_option(      '--batch',      action='store',      help='batch count f
 parser.add_option(      '--niter',      action='store',      help='number of iterations to repeat', default='1')
 parser.add_option(      '--ngpu',       action='store',      help='number of GPUs for multi-GPU tests; add --mgpu to run only multi-GPU tests', default='2')
 parser.add_option(      '--interactive',action='store_true', help='stop between tests')
+parser.add_option(      '--timeout',    action='store',      help='kill a tester after given seconds, counted as an error; default 0 for no timeout', type=float, default=0)
+
+# options for parallel runs
+parser.add_option('-j', '--jobs',       action='store',      help='number of testers to run concurrently; default 1 runs serially', type=int, default=1)
+parser.add_option(      '--cores',      action='store',      help='number of CPU cores to pack jobs into; default all available', type=int, default=0)
+parser.add_option(      '--threads',    action='store',      help='CPU threads per job, scaled per tester; default cores/jobs', type=int, default=0)
+parser.add_option(      '--gpu-jobs',   action='store',      help='number of testers that may share the GPU; default jobs. Multi-GPU testers run alone.', type=int, default=0)
+parser.add_option(      '--no-pin',     action='store_true', help='do not pin jobs to cores with taskset and OMP_PLACES')
 
 # options to specify sizes
 parser.add_option(      '--xsmall',     action='store_true', help='run extra small tests, N=25:100:25, 32:128:32')
@@ -310,6 +353,10 @@ output_to_file = not sys.stdout.isatty()
 if (output_to_file):
 	opts.interactive = False
 
+# interactive pauses after each tester, so it runs serially
+if (opts.interactive or opts.jobs < 1):
+	opts.jobs = 1
+
 # default if no sizes given is all sizes (small, medium, large)
 if (not opts.xsmall and not opts.small and not opts.medium and
 	not opts.large and not opts.xlarge):
@@ -688,6 +735,7 @@ aux = (
 	('testing_zlat2c',                 '-c',  n,    ''),
 	('testing_znan_inf',               '-c',  mn,   ''),
 	('testing_zprint',                 '-c',  '-n 10 -n 5,100 -n 100,5',  ''),
+	('testing_zscan_matrix',           '-c',  mn,   ''),
 	
 	# lower/upper
 	('testing_zsymmetrize',  '-L        -c',  n,    ''),
@@ -780,6 +828,10 @@ hesv = (
 	('testing_zhetrf', '-L --version 3 -c2',  n,    ''),
 	('testing_zhetrf', '-U --version 3 -c2',  n,    ''),
 	
+	# no-pivot LDLt, CPU only: blocked vs. recursive
+	('testing_zhetrf_nopiv_cpu',    '-L -c',  n,    ''),
+	('testing_zhetrf_nopiv_cpu',    '-U -c',  n,    ''),
+	
 	# no-pivot LDLt, GPU interface
 	('testing_zhetrf', '-L --version 4 -c2',  n,    ''),
 	('testing_zhetrf', '-U --version 4 -c2',  n,    ''),
@@ -805,11 +857,29 @@ lu = (
 	
 	# ----------
 	# LU, CPU interface
+	('testing_zcgesv_gmres_cpu', '--version 1 -c',  n,    ''),  # IR
+	('testing_zcgesv_gmres_cpu', '--version 2 -c',  n,    ''),  # GMRES-IR
 	('testing_zgesv',                  '-c',  n,    ''),
 	('testing_zgesv_rbt',              '-c',  n,    ''),
 	('testing_zgetrf',    '--version 1 -c2',  n,    ''),
 	('testing_zgetrf',    '--version 2 -c2',  n,    ''),  # zgetrf_nopiv
 	('testing_zgetrf',    '--version 3 -c2',  n,    ''),  # zgetf2_nopiv
+	
+	# CPU panels: recursive vs. LAPACK getrf, geqrf + larft, potrf
+	('testing_zpanel_rec_cpu',  '--nthread 4',  tall,  ''),
+	
+	# out-of-core potrf, getrf, geqrf with file-backed tiles
+	('testing_zooc_cpu',  '--version 1 -L -c',  n,    ''),
+	('testing_zooc_cpu',  '--version 1 -U -c',  n,    ''),
+	('testing_zooc_cpu',  '--version 2    -c',  mn,   ''),
+	('testing_zooc_cpu',  '--version 3    -c',  mn,   ''),
+	
+	# tile layout converters; potrf, getrf, geqrf in tile layout
+	('testing_ztile_cpu', '--version 1 -L -c',  n,    ''),
+	('testing_ztile_cpu', '--version 1 -U -c',  n,    ''),
+	('testing_ztile_cpu', '--version 2    -c',  mn,   ''),
+	('testing_ztile_cpu', '--version 3    -c',  mn,   ''),
+	('testing_ztile_cpu', '--version 3 --align 1 -c',  mn,   ''),  # compact tiles
 )
 if (opts.lu):
 	tests += lu
@@ -842,6 +912,8 @@ qr = (
 	
 	('testing_zlarfb_gpu', '--version 1 -c',  mnk,  ''),
 	('testing_zlarfb_gpu', '--version 2 -c',  mnk,  ''),
+	('testing_zlarfb_cpu', '--version 1 -c',  mnk,  ''),
+	('testing_zlarfb_cpu', '--version 2 -c',  mnk,  ''),
 	('testing_zungqr_gpu',             '-c',  mnk,  ''),
 	('testing_zunmql_gpu',             '-c',  mnk,  ''),
 	('testing_zunmqr_gpu', '--version 1 -c',  mnk,  ''),
@@ -854,6 +926,8 @@ qr = (
 	('testing_zgels',                  '-c',  mn,   ''),
 	('testing_zgeqlf',                 '-c',  mn,   ''),
 	('testing_zgeqp3',                 '-c',  mn,   ''),
+	('testing_zgeqp3_rand',   '--version 1 -c',  mn,   ''),  # Gaussian sketch
+	('testing_zgeqp3_rand',   '--version 2 -c',  mn,   ''),  # sparse sign sketch
 	('testing_zgeqrf',                '-c2',  mn,   ''),
 	('testing_zunglq',                 '-c',  mnk,  ''),
 	('testing_zungqr',     '--version 1 -c',  mnk,  ''),
@@ -1143,6 +1217,9 @@ geev = (
 	('testing_zgehrd',     '--version 1 -c',  n,    ''),
 	('testing_zgehrd',     '--version 2 -c',  n,    ''),
 	('testing_zgehrd',          ngpu + '-c',  n,    ''),
+	
+	('testing_zhseqr_mt', '--matrix geev --nthread 4',  n,  ''),
+	('testing_ztrevc3_mt', '--matrix geev',  n,  ''),
 )
 if (opts.geev):
 	tests += geev
@@ -1163,6 +1240,14 @@ svd = (
 	('testing_zgesvd', '--jobu o --jobv s -c',  mn,   ''),
 	('testing_zgesvd', '--jobu a --jobv a -c',  n,    ''),  # todo: do tall & wide, but avoid excessive sizes
 	
+	# randomized rank-k SVD, Gaussian and sparse sign sketch
+	('testing_zgesvd_rand',   '--version 1 -c',  mn,   ''),
+	('testing_zgesvd_rand',   '--version 2 -c',  mn,   ''),
+	
+	# bidiagonal divide-and-conquer, used by gesdd
+	('testing_dbdsdc',              '-U -c',  n,    ''),
+	('testing_dbdsdc',              '-L -c',  n,    ''),
+	
 	('testing_zgebrd',                 '-c',  mn,   ''),
 	('testing_zungbr',                 '-c',  mnk,  ''),
 	('testing_zunmbr',                 '-c',  mnk,  ''),
@@ -1582,18 +1667,72 @@ def substitute( txt, pfrom, pto ):
 # end
 
 
+# ----------------------------------------------------------------------
+# counts indications of success and failure in a line of tester output.
+# returns list (okay, fail, error), each 0 or 1.
+def count_line( line ):
+	okay  = 0
+	fail  = 0
+	error = 0
+	if re.search( r'\bok *$', line ):
+		okay = 1
+	if re.search( 'failed', line ):
+		fail = 1
+	if re.search( 'exit|memory leak|memory mapping error|CUDA runtime error|CL_INVALID|illegal value|ERROR SUMMARY: [1-9]', line ):
+		error = 1
+	return (okay, fail, error)
+# end
+
+
+# ----------------------------------------------------------------------
+# kills process if it runs longer than timeout seconds (if timeout > 0).
+# expired is set if the process was killed.
+# Processes are started in their own process group (see new_group), so the
+# whole group is killed, e.g., cuda-memcheck and the tester it runs.
+class Watchdog( object ):
+	def __init__( self, proc, timeout ):
+		self.expired = False
+		self.timer   = None
+		if (timeout > 0):
+			self.timer = threading.Timer( timeout, self.kill, [proc] )
+			self.timer.daemon = True
+			self.timer.start()
+	
+	def kill( self, proc ):
+		self.expired = True
+		try:
+			os.killpg( proc.pid, signal.SIGKILL )
+		except OSError:
+			pass  # already exited
+	
+	def cancel( self ):
+		if (self.timer):
+			self.timer.cancel()
+# end
+
+
+# ----------
+# for Popen preexec_fn, to start child in a new process group.
+def new_group():
+	os.setpgid( 0, 0 )
+# end
+
+
 # ----------------------------------------------------------------------
 # runs command in a subprocess.
-# returns list (okay, fail, errors, status)
+# returns list (okay, fail, errors, status, timed_out)
 # okay   is count of "ok"     in output.
 # fail   is count of "failed" in output.
 # error  is count of indications of other errors (exit, CUDA error, etc.).
 # status is exit status of the command.
-def run( cmd ):
+# timed_out is true if the command was killed after --timeout seconds.
+def run( cmd, timeout=0 ):
 	words = re.split( ' +', cmd.strip() )
 	
 	# stdout & stderr are merged
-	p = subprocess.Popen( words, bufsize=1, stdout=PIPE, stderr=STDOUT )
+	p = subprocess.Popen( words, bufsize=1, stdout=PIPE, stderr=STDOUT,
+	                      preexec_fn=new_group )
+	watchdog = Watchdog( p, timeout )
 	
 	okay  = 0
 	fail  = 0
@@ -1604,16 +1743,15 @@ def run( cmd ):
 		if not line:
 			break
 		print line.rstrip()
-		if re.search( r'\bok *$', line ):
-			okay += 1
-		if re.search( 'failed', line ):
-			fail += 1
-		if re.search( 'exit|memory leak|memory mapping error|CUDA runtime error|CL_INVALID|illegal value|ERROR SUMMARY: [1-9]', line ):
-			error += 1
+		(o, f, e) = count_line( line )
+		okay  += o
+		fail  += f
+		error += e
 	# end
 	
 	status = p.wait()
-	return (okay, fail, error, status)
+	watchdog.cancel()
+	return (okay, fail, error, status, watchdog.expired)
 # end
 
 
@@ -1624,6 +1762,210 @@ nfail  = 0
 nerror = 0
 failures = {}
 
+# ----------
+# counts results of one command, and prints errors to file and console.
+def report( cmd_opts, okay, fail, error, status, timed_out ):
+	global ntest, nokay, nfail, nerror
+	
+	ntest  += 1
+	nokay  += okay
+	nfail  += fail
+	nerror += error
+	
+	errmsg = ''
+	if (fail > 0):
+		errmsg += '  ** %d tests failed' % (fail)
+	if (error > 0):
+		errmsg += '  ** %d errors' % (error)
+	if (timed_out):
+		errmsg += '  ** timeout after %g sec' % (opts.timeout)
+		nerror += 1  # count timeout as an error
+	elif (status < 0):
+		errmsg += '  ** exit with signal %d' % (-status)
+		nerror += 1  # count crash as an error
+	
+	if (errmsg != ''):
+		if (output_to_file):
+			sys.stderr.write( errmsg + '\n' )  # to console
+		sys.stdout.write( errmsg + '\n' )  # to file
+		failures[ cmd_opts ] = True
+	else:
+		sys.stderr.write( '  ok\n' )
+	# end
+# end
+
+
+# ----------------------------------------------------------------------
+# for parallel runs, weight scaling --threads for each tester.
+# Testers that spend most of their time in multithreaded LAPACK
+# (eigenvalue and SVD solvers, CPU reference of batched routines) get more
+# cores; BLAS and auxiliary testers, which mostly wait on the GPU, get fewer.
+# First match applies; others have weight 1.
+job_weights = (
+	(r'ge[es]v|gesvd|gesdd|[hs][ey]ev|[hs][ey]gv|gebrd|gehrd|[hs][ey]2[hs]b|trevc', 2.0),
+	(r'_v?batched',  2.0),
+	(r'testing_.(gemm|gemv|[hs][ey]mv|[hs][ey]r2?k|trmm|trsm|trsv|geadd|lacpy|lag2|lange|lan[hs][ey]'
+	 r'|larfg|lascl|laset|lat2|nan_inf|print|scan_matrix|symmetrize|swap|transpose|trtri_diag)\b'
+	 r'|testing_(constants|operators|parse_opts|cblas)', 0.5),
+)
+
+# testers that do not use the GPU, so they don't count against --gpu-jobs.
+cpu_only = r'testing_.(generate|hetrf_nopiv_cpu|sytrf_nopiv_cpu|panel_rec_cpu|hseqr_mt|trevc3_mt|[cs]gesv_gmres_cpu|geqp3_rand|gesvd_rand|bdsdc|scan_matrix|larfb_cpu|ooc_cpu|tile_cpu)\b'
+
+# ----------
+# returns sorted list of CPU cores this process may run on, limited to --cores.
+def available_cores():
+	try:
+		cores = sorted( os.sched_getaffinity( 0 ))
+	except AttributeError:
+		cores = range( multiprocessing.cpu_count() )
+	if (opts.cores):
+		cores = cores[ :opts.cores ]
+	return cores
+# end
+
+# ----------
+# returns (threads, gpus) for command.
+# gpus is number of --gpu-jobs slots: none for CPU-only testers,
+# all of them for multi-GPU testers, else 1.
+def job_resources( cmdp, options, ncores, nthreads, gpu_jobs ):
+	weight = 1.0
+	for (regexp, w) in job_weights:
+		if (re.search( regexp, cmdp )):
+			weight = w
+			break
+	threads = int( round( nthreads * weight ))
+	threads = max( 1, min( ncores, threads ))
+	
+	if (re.search( cpu_only, cmdp )):
+		gpus = 0
+	elif (re.search( '(_m|_mgpu)$', cmdp ) or re.search( '--ngpu', options )):
+		gpus = gpu_jobs
+	else:
+		gpus = 1
+	return (threads, gpus)
+# end
+
+
+# ----------------------------------------------------------------------
+# runs jobs concurrently, up to --jobs at a time, packing them into the
+# core budget and --gpu-jobs slots. Jobs are started in order, but a job that
+# doesn't fit is passed over for later jobs that do (backfilling).
+# Output of each job is buffered, and printed in the original order,
+# so output files look the same as serial runs.
+def run_parallel( jobs ):
+	global last_cmd
+	
+	cores    = available_cores()
+	free     = list( cores )
+	gpu_free = gpu_jobs
+	pending  = range( len( jobs ))
+	running  = {}  # index -> (proc, output file, watchdog, cores)
+	results  = {}  # index -> (output, okay, fail, error, status, timed_out, cores)
+	next_job = 0   # next job to print, in order
+	
+	while (pending or running):
+		# start as many pending jobs as fit
+		for i in list( pending ):
+			if (len( running ) >= opts.jobs):
+				break
+			job = jobs[i]
+			if (job['disabled']):
+				pending.remove( i )
+				results[i] = None
+				continue
+			if (job['threads'] > len( free ) or job['gpus'] > gpu_free):
+				continue
+			
+			pending.remove( i )
+			mycores  = free[ :job['threads'] ]
+			free     = free[ job['threads']: ]
+			gpu_free -= job['gpus']
+			
+			nt  = str( job['threads'] )
+			env = dict( os.environ )
+			env['OMP_NUM_THREADS']      = nt
+			env['MKL_NUM_THREADS']      = nt
+			env['OPENBLAS_NUM_THREADS'] = nt
+			words = re.split( ' +', job['cmd_args'].strip() )
+			if (pin):
+				env['OMP_PLACES']    = ','.join( [ '{%d}' % c for c in mycores ] )
+				env['OMP_PROC_BIND'] = 'close'
+				words = ['taskset', '-c', ','.join( [ str(c) for c in mycores ] )] + words
+			
+			output = tempfile.TemporaryFile()
+			p = subprocess.Popen( words, stdout=output, stderr=STDOUT, env=env,
+			                      preexec_fn=new_group )
+			running[i] = (p, output, Watchdog( p, opts.timeout ), mycores)
+		# end
+		
+		# collect finished jobs
+		for i in running.keys():
+			(p, output, watchdog, mycores) = running[i]
+			status = p.poll()
+			if (status is None):
+				continue
+			watchdog.cancel()
+			del running[i]
+			free     = sorted( free + mycores )
+			gpu_free += jobs[i]['gpus']
+			
+			output.seek( 0 )
+			lines = output.read().splitlines()
+			output.close()
+			okay  = 0
+			fail  = 0
+			error = 0
+			for line in lines:
+				(o, f, e) = count_line( line )
+				okay  += o
+				fail  += f
+				error += e
+			results[i] = (lines, okay, fail, error, status, watchdog.expired, mycores)
+		# end
+		
+		# print finished jobs, in order
+		while (next_job in results):
+			job = jobs[ next_job ]
+			result = results.pop( next_job )
+			next_job += 1
+			
+			print
+			print '*'*100
+			print job['cmd_args']
+			print '*'*100
+			
+			if (output_to_file):
+				if (last_cmd and job['cmd'] != last_cmd):
+					sys.stderr.write( '\n' )            # to console
+				last_cmd = job['cmd']
+				sys.stderr.write( '%-48s' % job['cmd_opts'] )  # to console
+			# end
+			
+			if (result is None):
+				if (job['comments']):
+					sys.stderr.write( '  (disabled: ' + job['comments'] + ')\n' )
+				else:
+					sys.stderr.write( '  (disabled)\n' )
+				continue
+			# end
+			
+			(lines, okay, fail, error, status, timed_out, mycores) = result
+			print '%% %d threads on cores %s' % (job['threads'], ','.join( [ str(c) for c in mycores ] ))
+			for line in lines:
+				print line.rstrip()
+			report( job['cmd_opts'], okay, fail, error, status, timed_out )
+			sys.stdout.flush()
+			sys.stderr.flush()
+		# end
+		
+		if (running):
+			time.sleep( 0.05 )
+	# end
+# end
+
+
+# ----------------------------------------------------------------------
 start = None
 if (opts.start):
 	start = re.compile( opts.start + r'\b' )
@@ -1642,6 +1984,19 @@ if (int(opts.niter) != 1):
 
 last_cmd = None
 
+# ----------
+# resources for parallel runs
+ncores   = len( available_cores() )
+nthreads = opts.threads or max( 1, ncores // opts.jobs )
+gpu_jobs = opts.gpu_jobs or opts.jobs
+pin      = False
+if (opts.jobs > 1 and not opts.no_pin):
+	pin = (find_executable( 'taskset' ) is not None)
+	if (not pin):
+		print >>sys.stderr, 'taskset not found; jobs will not be pinned to cores'
+# end
+jobs = []
+
 for test in tests:
 	(cmd, options, sizes, comments) = test
 	for precision in opts.precisions:
@@ -1683,6 +2038,20 @@ for test in tests:
 		if (opts.memcheck):
 			cmd_args = 'cuda-memcheck ' + cmd_args
 		
+		if (opts.jobs > 1):
+			(threads, gpus) = job_resources( cmdp, options, ncores, nthreads, gpu_jobs )
+			jobs.append( {
+				'cmd':      cmd,
+				'cmd_args': cmd_args,
+				'cmd_opts': cmd_opts,
+				'disabled': disabled,
+				'comments': comments,
+				'threads':  threads,
+				'gpus':     gpus,
+			} )
+			continue
+		# end
+		
 		repeat_test = True
 		while repeat_test:
 			repeat_test = False
@@ -1709,33 +2078,8 @@ for test in tests:
 				break
 			# end
 			
-			t = time.time()
-			(okay, fail, error, status) = run( cmd_args )
-			t = time.time() - t
-			
-			# count stats
-			ntest  += 1
-			nokay  += okay
-			nfail  += fail
-			nerror += error
-			
-			errmsg = ''
-			if (fail > 0):
-				errmsg += '  ** %d tests failed' % (fail)
-			if (error > 0):
-				errmsg += '  ** %d errors' % (error)
-			if (status < 0):
-				errmsg += '  ** exit with signal %d' % (-status)
-				nerror += 1  # count crash as an error
-			
-			if (errmsg != ''):
-				if (output_to_file):
-					sys.stderr.write( errmsg + '\n' )  # to console
-				sys.stdout.write( errmsg + '\n' )  # to file
-				failures[ cmd_opts ] = True
-			else:
-				sys.stderr.write( '  ok\n' )
-			# end
+			(okay, fail, error, status, timed_out) = run( cmd_args, opts.timeout )
+			report( cmd_opts, okay, fail, error, status, timed_out )
 			
 			if (opts.interactive):
 				x = raw_input( '[enter to continue; M to make and re-run] ' )
@@ -1750,6 +2094,10 @@ for test in tests:
 	# end
 # end
 
+if (jobs):
+	run_parallel( jobs )
+# end
+
 
 # print summary
 msg  = '\n'
@@ -0,0 +1,175 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal d -> s
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "flops.h"
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing dbdsdc
+   Computes the SVD B = U S VT of a random N-by-N upper (-U, default) or
+   lower (-L) bidiagonal matrix B with LAPACK dbdsdc and with magma_dbdsdc,
+   both with singular vectors.
+   Checks
+       |B - U S VT|_1 / (N |B|_1 eps),
+       |I - U^T U| / (N eps) and |I - VT VT^T| / (N eps) with dort01,
+   and reports max_i |s_i - sigma_i| / sigma_1, against LAPACK's singular
+   values sigma.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    real_Double_t   cpu_time, magma_time;
+    double          Bnorm, error, ortho_u, ortho_v, sdiff, dummy[1];
+    double          c_zero = 0, c_one = 1, c_neg_one = -1;
+    double *d, *e, *dref, *eref, *h_B, *h_U, *h_VT, *h_work;
+    magma_int_t *iwork, idummy[1];
+    magma_int_t N, nm1, ldu, lwork, lwork_ort, info, i, j;
+    magma_int_t ione     = 1;
+    magma_int_t idist    = 3;
+    magma_int_t ISEED[4] = {0,0,0,1};
+    int status = 0;
+
+    magma_opts opts;
+    opts.parse_opts( argc, argv );
+    magma_bench_record rec( opts, "dbdsdc" );
+
+    double tol = opts.tolerance * lapackf77_dlamch("E");
+    double eps = lapackf77_dlamch( "E" );
+    const char *uplo_ = lapack_uplo_const( opts.uplo );
+
+    printf( "%% uplo = %s\n", uplo_ );
+    printf( "%%   N   LAPACK (sec)   MAGMA (sec)   speedup   |B - U S VT|   |I - U^T U|   |I - VT VT^T|   |s - sigma|/sigma_1\n" );
+    printf( "%%====================================================================================================\n" );
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            N      = opts.nsize[itest];
+            nm1    = max( 0, N-1 );
+            ldu    = max( 1, N );
+            lwork_ort = N*(N + 1);
+            lwork  = max( 3*N*N + 4*N, lwork_ort );
+
+            TESTING_CHECK( magma_dmalloc_cpu( &d,      N       ));
+            TESTING_CHECK( magma_dmalloc_cpu( &e,      N       ));
+            TESTING_CHECK( magma_dmalloc_cpu( &dref,   N       ));
+            TESTING_CHECK( magma_dmalloc_cpu( &eref,   N       ));
+            TESTING_CHECK( magma_dmalloc_cpu( &h_B,    ldu*N   ));
+            TESTING_CHECK( magma_dmalloc_cpu( &h_U,    ldu*N   ));
+            TESTING_CHECK( magma_dmalloc_cpu( &h_VT,   ldu*N   ));
+            TESTING_CHECK( magma_dmalloc_cpu( &h_work, lwork   ));
+            TESTING_CHECK( magma_imalloc_cpu( &iwork,  8*N     ));
+
+            /* Initialize the bidiagonal matrix */
+            lapackf77_dlarnv( &idist, ISEED, &N,   d );
+            lapackf77_dlarnv( &idist, ISEED, &nm1, e );
+            lapackf77_dlaset( "F", &N, &N, &c_zero, &c_zero, h_B, &ldu );
+            for( i = 0; i < N; ++i ) {
+                h_B[i + i*ldu] = d[i];
+                if ( i < N-1 ) {
+                    if ( opts.uplo == MagmaUpper )
+                        h_B[i + (i+1)*ldu] = e[i];
+                    else
+                        h_B[(i+1) + i*ldu] = e[i];
+                }
+            }
+            Bnorm = lapackf77_dlange( "1", &N, &N, h_B, &ldu, dummy );
+
+            /* =====================================================================
+               Performs operation using LAPACK
+               =================================================================== */
+            blasf77_dcopy( &N,   d, &ione, dref, &ione );
+            blasf77_dcopy( &nm1, e, &ione, eref, &ione );
+            cpu_time = magma_wtime();
+            lapackf77_dbdsdc( uplo_, "I", &N, dref, eref, h_U, &ldu, h_VT, &ldu,
+                              dummy, idummy, h_work, iwork, &info );
+            cpu_time = magma_wtime() - cpu_time;
+            if (info != 0) {
+                printf("lapackf77_dbdsdc returned error %lld.\n", (long long) info );
+            }
+
+            /* =====================================================================
+               Performs operation using MAGMA
+               =================================================================== */
+            magma_time = magma_wtime();
+            magma_dbdsdc( opts.uplo, MagmaIVec, N, d, e, h_U, ldu, h_VT, ldu,
+                          h_work, iwork, &info );
+            magma_time = magma_wtime() - magma_time;
+            if (info != 0) {
+                printf("magma_dbdsdc returned error %lld: %s.\n",
+                       (long long) info, magma_strerror( info ));
+            }
+
+            /* =====================================================================
+               Check the result
+               =================================================================== */
+            lapackf77_dort01( "Columns", &N, &N, h_U,  &ldu, h_work, &lwork_ort, &ortho_u );
+            lapackf77_dort01( "Rows",    &N, &N, h_VT, &ldu, h_work, &lwork_ort, &ortho_v );
+
+            // B - U S VT
+            for( j = 0; j < N; ++j ) {
+                blasf77_dscal( &N, &d[j], &h_U[j*ldu], &ione );
+            }
+            blasf77_dgemm( "N", "N", &N, &N, &N,
+                           &c_neg_one, h_U,  &ldu,
+                                       h_VT, &ldu,
+                           &c_one,     h_B,  &ldu );
+            error = lapackf77_dlange( "1", &N, &N, h_B, &ldu, dummy );
+            error = (Bnorm > 0 ? error / (N * Bnorm * eps) : error / (N * eps));
+
+            sdiff = 0;
+            for( i = 0; i < N; ++i ) {
+                sdiff = max( sdiff, fabs( d[i] - dref[i] ) / dref[0] );
+            }
+
+            bool okay = (info == 0 && error * eps < tol && ortho_u * eps < tol
+                         && ortho_v * eps < tol && sdiff < tol);
+            status += ! okay;
+            rec.add( "n", N );
+            rec.add( "cpu_time", cpu_time );
+            rec.add( "magma_time", magma_time );
+            rec.add( "error", error );
+            rec.add( "ortho_u", ortho_u );
+            rec.add( "ortho_v", ortho_v );
+            rec.add( "sval_diff", sdiff );
+            rec.write( iter, okay );
+            printf( "%5lld   %9.4f      %9.4f     %6.2f     %8.2e       %8.2e      %8.2e        %8.2e   %s\n",
+                    (long long) N, cpu_time, magma_time, cpu_time / magma_time,
+                    error, ortho_u, ortho_v, sdiff, (okay ? "ok" : "failed") );
+
+            magma_free_cpu( d      );
+            magma_free_cpu( e      );
+            magma_free_cpu( dref   );
+            magma_free_cpu( eref   );
+            magma_free_cpu( h_B    );
+            magma_free_cpu( h_U    );
+            magma_free_cpu( h_VT   );
+            magma_free_cpu( h_work );
+            magma_free_cpu( iwork  );
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
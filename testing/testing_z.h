@@ -70,6 +70,49 @@ void check_zgeev(
     #endif
     double result[4] );
 
+// CPU reference results for batched testers; see magma_zbatched_ref.cpp
+void magma_zgemm_vbatched_ref(
+    magma_trans_t transA, magma_trans_t transB,
+    magma_int_t* m, magma_int_t* n, magma_int_t* k,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex const * const * hA_array, magma_int_t* lda,
+    magmaDoubleComplex const * const * hB_array, magma_int_t* ldb,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex **hC_array, magma_int_t* ldc,
+    magma_int_t batchCount );
+
+void magma_zgetrf_batched_ref(
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    magma_int_t **ipiv_array, magma_int_t *info_array,
+    magma_int_t batchCount );
+
+void magma_zpotrf_batched_ref(
+    magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    magma_int_t *info_array,
+    magma_int_t batchCount );
+
+void magma_zpotrf_vbatched_ref(
+    magma_uplo_t uplo, magma_int_t* n,
+    magmaDoubleComplex **hA_array, magma_int_t* lda,
+    magma_int_t *info_array,
+    magma_int_t batchCount );
+
+void magma_zlange_batched_ref(
+    const char* norm,
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex const * const * hA_array, magma_int_t lda,
+    double *values,
+    magma_int_t batchCount );
+
+void magma_zlange_vbatched_ref(
+    const char* norm,
+    magma_int_t* m, magma_int_t* n,
+    magmaDoubleComplex const * const * hA_array, magma_int_t* lda,
+    double *values,
+    magma_int_t batchCount );
+
 //void magma_zgenerate_matrix(
 //    magma_int_t matrix,
 //    magma_int_t m, magma_int_t n,
@@ -0,0 +1,168 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions mixed zc -> ds
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "flops.h"
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing zcgesv_gmres_cpu
+   Solves op(A) X = B with LAPACK zgesv and with magma_zcgesv_gmres_cpu,
+   factoring in single precision (FP32) and in single precision rounded to
+   bfloat16 (BF16).
+   --version 1 refines with classical iterative refinement (IR),
+   --version 2 with GMRES-based iterative refinement (GMRES-IR).
+   Checks the backward error |b - Ax| / (N |A| |x|) of the mixed solution.
+   A negative iter means the refinement did not converge and the routine
+   fell back to a double precision solve.
+   Use --matrix and --cond (see magma_generate_matrix) to vary the conditioning.
+*/
+int main(int argc, char **argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    real_Double_t   gflops, cpu_perf, cpu_time, mp_perf, mp_time;
+    double          error, Rnorm, Anorm, Xnorm, *work;
+    magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    magmaDoubleComplex *h_A, *h_LU, *h_B, *h_X, *h_R;
+    magma_int_t *ipiv;
+    magma_int_t N, nrhs, lda, ldb, gesv_iter, info, size;
+    magma_int_t ione     = 1;
+    magma_int_t ISEED[4] = {0,0,0,1};
+    int status = 0;
+
+    magma_opts opts;
+    opts.parse_opts( argc, argv );
+    magma_bench_record rec( opts, "zcgesv_gmres_cpu" );
+
+    double tol = opts.tolerance * lapackf77_dlamch("E");
+
+    nrhs = opts.nrhs;
+
+    magma_refinement_t solver_type =
+        (opts.version == 2 ? Magma_REFINE_IRGMSTRS : Magma_REFINE_IRSTRS);
+    magma_refinement_t facto_types[2] = { Magma_PREC_SS, Magma_PREC_SB };
+
+    printf("%% Epsilon(double): %8.6e\n"
+           "%% Epsilon(single): %8.6e\n",
+           lapackf77_dlamch("Epsilon"), lapackf77_slamch("Epsilon") );
+    printf("%% trans = %s, solver = %s\n", lapack_trans_const(opts.transA),
+           (opts.version == 2 ? "GMRES-IR" : "IR") );
+    printf("%% matrix %s\n\n", opts.matrix.c_str() );
+    printf("%%   N  NRHS   Factor   LAPACK Gflop/s (sec)   MP Gflop/s (sec)   speedup   Iter   |b-Ax|/(N|A||x|)\n");
+    printf("%%=====================================================================================================\n");
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            N   = opts.nsize[itest];
+            ldb = lda = N;
+            gflops = ( FLOPS_ZGETRF( N, N ) + FLOPS_ZGETRS( N, nrhs )) / 1e9;
+
+            TESTING_CHECK( magma_zmalloc_cpu( &h_A,  lda*N    ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_LU, lda*N    ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_B,  ldb*nrhs ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_X,  ldb*nrhs ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_R,  ldb*nrhs ));
+            TESTING_CHECK( magma_imalloc_cpu( &ipiv, N        ));
+            TESTING_CHECK( magma_dmalloc_cpu( &work, N        ));
+
+            /* Initialize matrices */
+            magma_generate_matrix( opts, N, N, h_A, lda );
+            size = ldb * nrhs;
+            lapackf77_zlarnv( &ione, ISEED, &size, h_B );
+            Anorm = lapackf77_zlange( "I", &N, &N, h_A, &lda, work );
+
+            /* =====================================================================
+               Performs operation using LAPACK, in double precision
+               =================================================================== */
+            // zgesv has no trans argument; time zgetrf + zgetrs instead
+            lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_LU, &lda );
+            lapackf77_zlacpy( MagmaFullStr, &N, &nrhs, h_B, &ldb, h_X, &ldb );
+            cpu_time = magma_wtime();
+            lapackf77_zgetrf( &N, &N, h_LU, &lda, ipiv, &info );
+            lapackf77_zgetrs( lapack_trans_const(opts.transA), &N, &nrhs,
+                              h_LU, &lda, ipiv, h_X, &ldb, &info );
+            cpu_time = magma_wtime() - cpu_time;
+            cpu_perf = gflops / cpu_time;
+            if (info != 0) {
+                printf("lapackf77_zgetrs returned error %lld.\n", (long long) info );
+            }
+
+            for( int ifacto = 0; ifacto < 2; ++ifacto ) {
+                /* =================================================================
+                   Performs operation using MAGMA, mixed precision
+                   =============================================================== */
+                lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_LU, &lda );
+                mp_time = magma_wtime();
+                magma_zcgesv_gmres_cpu( opts.transA, N, nrhs, h_LU, lda, ipiv,
+                                        h_B, ldb, h_X, ldb,
+                                        facto_types[ifacto], solver_type,
+                                        &gesv_iter, &info );
+                mp_time = magma_wtime() - mp_time;
+                mp_perf = gflops / mp_time;
+                if (info != 0) {
+                    printf("magma_zcgesv_gmres_cpu returned error %lld: %s.\n",
+                           (long long) info, magma_strerror( info ));
+                }
+
+                /* =================================================================
+                   Check the result
+                   =============================================================== */
+                lapackf77_zlacpy( MagmaFullStr, &N, &nrhs, h_B, &ldb, h_R, &ldb );
+                blasf77_zgemm( lapack_trans_const(opts.transA), MagmaNoTransStr,
+                               &N, &nrhs, &N,
+                               &c_one,     h_A, &lda,
+                                           h_X, &ldb,
+                               &c_neg_one, h_R, &ldb );
+                Rnorm = lapackf77_zlange( "I", &N, &nrhs, h_R, &ldb, work );
+                Xnorm = lapackf77_zlange( "I", &N, &nrhs, h_X, &ldb, work );
+                error = Rnorm / (N*Anorm*Xnorm);
+
+                bool okay = (error < tol && info == 0);
+                status += ! okay;
+                rec.add( "n", N );
+                rec.add( "nrhs", nrhs );
+                rec.add( "facto", (ifacto == 0 ? "fp32" : "bf16") );
+                rec.add( "cpu_time", cpu_time );
+                rec.add( "magma_time", mp_time );
+                rec.add( "iter", gesv_iter );
+                rec.add( "error", error );
+                rec.write( iter, okay );
+                printf("%5lld %5lld   %-6s   %7.2f (%7.4f)      %7.2f (%7.4f)   %6.2f   %4lld   %8.2e   %s\n",
+                       (long long) N, (long long) nrhs,
+                       (ifacto == 0 ? "FP32" : "BF16"),
+                       cpu_perf, cpu_time, mp_perf, mp_time, cpu_time / mp_time,
+                       (long long) gesv_iter, error, (okay ? "ok" : "failed"));
+            }
+
+            magma_free_cpu( h_A );
+            magma_free_cpu( h_LU );
+            magma_free_cpu( h_B );
+            magma_free_cpu( h_X );
+            magma_free_cpu( h_R );
+            magma_free_cpu( ipiv );
+            magma_free_cpu( work );
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
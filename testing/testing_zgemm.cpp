@@ -62,6 +62,7 @@ int main( int argc, char** argv)
     
     magma_opts opts;
     opts.parse_opts( argc, argv );
+    magma_bench_record rec( opts, "zgemm" );
     
     // Allow 3*eps; complex needs 2*sqrt(2) factor; see Higham, 2002, sec. 3.6.
     double eps = lapackf77_dlamch("E");
@@ -194,6 +195,20 @@ int main( int argc, char** argv)
             /* =====================================================================
                Check the result
                =================================================================== */
+            bool okay = true;
+            rec.add( "m", M );
+            rec.add( "n", N );
+            rec.add( "k", K );
+            rec.add( "transA", lapack_trans_const(opts.transA) );
+            rec.add( "transB", lapack_trans_const(opts.transB) );
+            #ifdef HAVE_CUBLAS
+                rec.perf( "magma", magma_perf, magma_time );
+            #endif
+            rec.perf( "dev", dev_perf, dev_time );
+            if ( opts.lapack ) {
+                rec.perf( "cpu", cpu_perf, cpu_time );
+            }
+            
             if ( opts.lapack ) {
                 // Compute forward error bound (see Higham, 2002, sec. 3.5),
                 // modified to include alpha, beta, and input C.
@@ -214,7 +229,9 @@ int main( int argc, char** argv)
                     magma_error = lapackf77_zlange( "F", &M, &N, hCmagma, &ldc, work )
                             / (sqrt(double(K+2))*fabs(alpha)*Anorm*Bnorm + 2*fabs(beta)*Cnorm);
                     
-                    bool okay = (magma_error < tol && dev_error < tol);
+                    okay = (magma_error < tol && dev_error < tol);
+                    rec.add( "magma_error", magma_error );
+                    rec.add( "dev_error",   dev_error   );
                     status += ! okay;
                     printf("%5lld %5lld %5lld   %7.2f (%7.2f)    %7.2f (%7.2f)   %7.2f (%7.2f)    %8.2e     %8.2e   %s\n",
                            (long long) M, (long long) N, (long long) K,
@@ -224,7 +241,8 @@ int main( int argc, char** argv)
                            magma_error, dev_error,
                            (okay ? "ok" : "failed"));
                 #else
-                    bool okay = (dev_error < tol);
+                    okay = (dev_error < tol);
+                    rec.add( "dev_error", dev_error );
                     status += ! okay;
                     printf("%5lld %5lld %5lld   %7.2f (%7.2f)   %7.2f (%7.2f)    %8.2e   %s\n",
                            (long long) M, (long long) N, (long long) K,
@@ -241,7 +259,8 @@ int main( int argc, char** argv)
                     magma_error = lapackf77_zlange( "F", &M, &N, hCmagma, &ldc, work )
                             / (sqrt(double(K+2))*fabs(alpha)*Anorm*Bnorm + 2*fabs(beta)*Cnorm);
                     
-                    bool okay = (magma_error < tol);
+                    okay = (magma_error < tol);
+                    rec.add( "magma_error", magma_error );
                     status += ! okay;
                     printf("%5lld %5lld %5lld   %7.2f (%7.2f)    %7.2f (%7.2f)     ---   (  ---  )    %8.2e        ---    %s\n",
                            (long long) M, (long long) N, (long long) K,
@@ -255,6 +274,7 @@ int main( int argc, char** argv)
                            dev_perf,    1000.*dev_time );
                 #endif
             }
+            rec.write( iter, okay );
             
             magma_free_cpu( hA );
             magma_free_cpu( hB );
@@ -16,6 +16,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <algorithm>  // copy
 
 // includes, project
 #include "flops.h"
@@ -32,13 +33,13 @@ int main( int argc, char** argv)
     magma_print_environment();
 
     real_Double_t   gflops, magma_perf, magma_time, cublas_perf, cublas_time, cpu_perf, cpu_time;
-    double          error, cublas_error, magma_error, normalize, work[1];
+    double          cublas_error, magma_error;
     magma_int_t M, N, K;
     magma_int_t Am, An, Bm, Bn;
     magma_int_t sizeA, sizeB, sizeC;
     magma_int_t lda, ldb, ldc, ldda, lddb, lddc;
     magma_int_t ione     = 1;
-    magma_int_t ISEED[4] = {0,0,0,1};
+    magma_int_t ISEED[4] = {0,0,0,1}, ISEED_test[4];
     int status = 0;
     magma_int_t batchCount;
 
@@ -54,10 +55,13 @@ int main( int argc, char** argv)
     magmaDoubleComplex **d_B_array = NULL;
     magmaDoubleComplex **d_C_array = NULL;
 
+    magma_ref_cache refcache;
+
     magma_opts opts( MagmaOptsBatched );
     opts.parse_opts( argc, argv );
     opts.lapack |= opts.check; // check (-c) implies lapack (-l)
     batchCount = opts.batchcount;
+    magma_bench_record rec( opts, "zgemm_batched" );
     
     double *Anorm, *Bnorm, *Cnorm;
     TESTING_CHECK( magma_dmalloc_cpu( &Anorm, batchCount ));
@@ -77,7 +81,10 @@ int main( int argc, char** argv)
     printf("%% BatchCount     M     N     K   MAGMA Gflop/s (ms)   CUBLAS Gflop/s (ms)   CPU Gflop/s (ms)   MAGMA error   CUBLAS error\n");
     printf("%%========================================================================================================================\n");
     for( int itest = 0; itest < opts.ntest; ++itest ) {
+        // same matrices for each iter, so the CPU BLAS result can be reused
+        std::copy( ISEED, ISEED+4, ISEED_test );
         for( int iter = 0; iter < opts.niter; ++iter ) {
+            std::copy( ISEED_test, ISEED_test+4, ISEED );
             M = opts.msize[itest];
             N = opts.nsize[itest];
             K = opts.ksize[itest];
@@ -133,12 +140,17 @@ int main( int argc, char** argv)
             lapackf77_zlarnv( &ione, ISEED, &sizeB, h_B );
             lapackf77_zlarnv( &ione, ISEED, &sizeC, h_C );
             
-            // Compute norms for error
-            for (int s = 0; s < batchCount; ++s) {
-                Anorm[s] = lapackf77_zlange( "F", &Am, &An, &h_A[s*lda*An], &lda, work );
-                Bnorm[s] = lapackf77_zlange( "F", &Bm, &Bn, &h_B[s*ldb*Bn], &ldb, work );
-                Cnorm[s] = lapackf77_zlange( "F", &M,  &N,  &h_C[s*ldc*N],  &ldc, work );
+            // populate pointer arrays on the host
+            for(int s = 0; s < batchCount; s++){
+                h_A_array[s] = h_A + s * lda * An;
+                h_B_array[s] = h_B + s * ldb * Bn;
+                h_C_array[s] = h_C + s * ldc * N;
             }
+            
+            // Compute norms for error
+            magma_zlange_batched_ref( "F", Am, An, h_A_array, lda, Anorm, batchCount );
+            magma_zlange_batched_ref( "F", Bm, Bn, h_B_array, ldb, Bnorm, batchCount );
+            magma_zlange_batched_ref( "F", M,  N,  h_C_array, ldc, Cnorm, batchCount );
 
             /* =====================================================================
                Performs operation using MAGMABLAS
@@ -199,50 +211,74 @@ int main( int argc, char** argv)
                Performs operation using CPU BLAS
                =================================================================== */
             if ( opts.lapack ) {
-                // populate pointer arrays on the host
-                for(int s = 0; s < batchCount; s++){
-                    h_A_array[s] = h_A + s * lda * An;
-                    h_B_array[s] = h_B + s * ldb * Bn;
-                    h_C_array[s] = h_C + s * ldc * N;
+                std::vector< magma_ref_buffer > outputs = {
+                    { h_C, sizeC * sizeof(magmaDoubleComplex) } };
+                std::string key = magma_ref_key( "zgemm_batched",
+                                                 { opts.transA, opts.transB, M, N, K, batchCount },
+                                                 { { h_A, sizeA * sizeof(magmaDoubleComplex) },
+                                                   { h_B, sizeB * sizeof(magmaDoubleComplex) },
+                                                   outputs[0] } );
+                if ( ! refcache.lookup( key, outputs, &cpu_time )) {
+                    cpu_time = magma_wtime();
+                    blas_zgemm_batched( opts.transA, opts.transB,
+                           M, N, K,
+                           alpha, h_A_array, lda,
+                                  h_B_array, ldb,
+                           beta,  h_C_array, ldc, batchCount );
+                    cpu_time = magma_wtime() - cpu_time;
+                    refcache.store( key, outputs, cpu_time );
                 }
-                cpu_time = magma_wtime();
-                blas_zgemm_batched( opts.transA, opts.transB, 
-                       M, N, K,
-                       alpha, h_A_array, lda,
-                              h_B_array, ldb,
-                       beta,  h_C_array, ldc, batchCount );
-                cpu_time = magma_wtime() - cpu_time;
                 cpu_perf = gflops / cpu_time;
             }
             
             /* =====================================================================
                Check the result
                =================================================================== */
+            bool okay;
+            rec.add( "batch", batchCount );
+            rec.add( "m", M );
+            rec.add( "n", N );
+            rec.add( "k", K );
+            rec.add( "transA",  lapack_trans_const(opts.transA) );
+            rec.add( "transB",  lapack_trans_const(opts.transB) );
+            rec.add( "version", opts.version );
+            rec.perf( "magma",  magma_perf,  magma_time  );
+            rec.perf( "cublas", cublas_perf, cublas_time );
             if ( opts.lapack ) {
                 // compute error compared lapack
                 // error = |dC - C| / (gamma_{k+2}|A||B| + gamma_2|Cin|)
-                magma_error = 0;
-                cublas_error = 0;
-                
-                for (int s=0; s < batchCount; s++) {
-                    normalize = sqrt(double(K+2))*Anorm[s]*Bnorm[s] + 2*Cnorm[s];
+                std::vector<double> magma_errors( batchCount ), cublas_errors( batchCount );
+                magma_int_t nthreads = magma_batched_ref_begin();
+                #pragma omp parallel for schedule(dynamic)
+                for (magma_int_t s=0; s < batchCount; s++) {
+                    double work[1];
+                    double normalize = sqrt(double(K+2))*Anorm[s]*Bnorm[s] + 2*Cnorm[s];
                     if (normalize == 0)
                         normalize = 1;
                     magma_int_t Csize = ldc*N;
                     blasf77_zaxpy( &Csize, &c_neg_one, &h_C[s*ldc*N], &ione, &h_Cmagma[s*ldc*N], &ione );
-                    error = lapackf77_zlange( "F", &M, &N, &h_Cmagma[s*ldc*N], &ldc, work )
-                          / normalize;
-                    magma_error = magma_max_nan( error, magma_error );
+                    magma_errors[s] = lapackf77_zlange( "F", &M, &N, &h_Cmagma[s*ldc*N], &ldc, work )
+                                    / normalize;
                     
                     // cublas error
                     blasf77_zaxpy( &Csize, &c_neg_one, &h_C[s*ldc*N], &ione, &h_Ccublas[s*ldc*N], &ione );
-                    error = lapackf77_zlange( "F", &M, &N, &h_Ccublas[s*ldc*N], &ldc, work )
-                          / normalize;
-                    cublas_error = magma_max_nan( error, cublas_error );
+                    cublas_errors[s] = lapackf77_zlange( "F", &M, &N, &h_Ccublas[s*ldc*N], &ldc, work )
+                                     / normalize;
+                }
+                magma_batched_ref_end( nthreads );
+                
+                magma_error = 0;
+                cublas_error = 0;
+                for (magma_int_t s=0; s < batchCount; s++) {
+                    magma_error  = magma_max_nan( magma_errors[s],  magma_error  );
+                    cublas_error = magma_max_nan( cublas_errors[s], cublas_error );
                 }
 
-                bool okay = (magma_error < tol);
+                okay = (magma_error < tol);
                 status += ! okay;
+                rec.perf( "cpu", cpu_perf, cpu_time );
+                rec.add( "magma_error",  magma_error  );
+                rec.add( "cublas_error", cublas_error );
                 printf("  %10lld %5lld %5lld %5lld    %7.2f (%7.2f)    %7.2f (%7.2f)   %7.2f (%7.2f)   %8.2e      %8.2e   %s\n",
                        (long long) batchCount, (long long) M, (long long) N, (long long) K,
                        magma_perf,  1000.*magma_time,
@@ -253,27 +289,36 @@ int main( int argc, char** argv)
             else {
                 // compute error compared cublas
                 // error = |dC - C| / (gamma_{k+2}|A||B| + gamma_2|Cin|)
-                magma_error = 0;
-                
-                for (int s=0; s < batchCount; s++) {
-                    normalize = sqrt(double(K+2))*Anorm[s]*Bnorm[s] + 2*Cnorm[s];
+                std::vector<double> magma_errors( batchCount );
+                magma_int_t nthreads = magma_batched_ref_begin();
+                #pragma omp parallel for schedule(dynamic)
+                for (magma_int_t s=0; s < batchCount; s++) {
+                    double work[1];
+                    double normalize = sqrt(double(K+2))*Anorm[s]*Bnorm[s] + 2*Cnorm[s];
                     if (normalize == 0)
                         normalize = 1;
                     magma_int_t Csize = ldc*N;
                     blasf77_zaxpy( &Csize, &c_neg_one, &h_Ccublas[s*ldc*N], &ione, &h_Cmagma[s*ldc*N], &ione );
-                    error = lapackf77_zlange( "F", &M, &N, &h_Cmagma[s*ldc*N], &ldc, work )
-                          / normalize;
-                    magma_error = magma_max_nan( error, magma_error );
+                    magma_errors[s] = lapackf77_zlange( "F", &M, &N, &h_Cmagma[s*ldc*N], &ldc, work )
+                                    / normalize;
+                }
+                magma_batched_ref_end( nthreads );
+                
+                magma_error = 0;
+                for (magma_int_t s=0; s < batchCount; s++) {
+                    magma_error = magma_max_nan( magma_errors[s], magma_error );
                 }
 
-                bool okay = (magma_error < tol);
+                okay = (magma_error < tol);
                 status += ! okay;
+                rec.add( "magma_error", magma_error );
                 printf("  %10lld %5lld %5lld %5lld    %7.2f (%7.2f)    %7.2f (%7.2f)     ---   (  ---  )   %8.2e        ---      %s\n",
                        (long long) batchCount, (long long) M, (long long) N, (long long) K,
                        magma_perf,  1000.*magma_time,
                        cublas_perf, 1000.*cublas_time,
                        magma_error, (okay ? "ok" : "failed") );
             }
+            rec.write( iter, okay );
             
             magma_free_cpu( h_A  );
             magma_free_cpu( h_B  );
@@ -298,6 +343,10 @@ int main( int argc, char** argv)
         }
     }
 
+    if ( opts.lapack ) {
+        refcache.print_stats();
+    }
+
     magma_free_cpu( Anorm );
     magma_free_cpu( Bnorm );
     magma_free_cpu( Cnorm );
@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <algorithm>  // copy
 
 // includes, project
 #include "flops.h"
@@ -25,11 +26,6 @@
 #include "magma_lapack.h"
 #include "testings.h"
 
-#if defined(_OPENMP)
-#include <omp.h>
-#include "../control/magma_threadsetting.h"  // internal header
-#endif
-
 /* ////////////////////////////////////////////////////////////////////////////
    -- Testing zgemm_vbatched
 */
@@ -39,20 +35,20 @@ int main( int argc, char** argv)
     magma_print_environment();
 
     real_Double_t   gflops, magma_perf, magma_time, cpu_perf, cpu_time;
-    double          error, magma_error, normalize, work[1];
+    double          magma_error;
     magma_int_t M, N, K;
     magma_int_t *Am, *An, *Bm, *Bn;
     magma_int_t total_size_A_cpu = 0, total_size_B_cpu = 0, total_size_C_cpu = 0;
     magma_int_t total_size_A_dev = 0, total_size_B_dev = 0, total_size_C_dev = 0;
     magma_int_t ione     = 1;
-    magma_int_t ISEED[4] = {0,0,0,1};
+    magma_int_t ISEED[4] = {0,0,0,1}, ISEED_test[4];
     int status = 0;
     magma_int_t batchCount;
     magma_int_t max_M, max_N, max_K;
 
     magmaDoubleComplex *h_A, *h_B, *h_C, *h_Cmagma;
     magmaDoubleComplex *d_A, *d_B, *d_C;
-    magmaDoubleComplex *h_A_tmp, *h_B_tmp, *h_C_tmp, *h_Cmagma_tmp;
+    magmaDoubleComplex *h_A_tmp, *h_B_tmp, *h_C_tmp;
     magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
     magmaDoubleComplex alpha = MAGMA_Z_MAKE(  0.29, -0.86 );
     magmaDoubleComplex beta  = MAGMA_Z_MAKE( -0.48,  0.38 );
@@ -70,6 +66,8 @@ int main( int argc, char** argv)
     magma_int_t *h_ldb, *h_lddb, *d_lddb;
     magma_int_t *h_ldc, *h_lddc, *d_lddc;
     
+    magma_ref_cache refcache;
+    
     magma_opts opts( MagmaOptsBatched );
     opts.parse_opts( argc, argv );
     opts.lapack |= opts.check; // check (-c) implies lapack (-l)
@@ -121,7 +119,10 @@ int main( int argc, char** argv)
     printf("%% BatchCount     M     N     K   MAGMA Gflop/s (ms)   CPU Gflop/s (ms)   MAGMA error\n");
     printf("%%===================================================================================\n");
     for( int itest = 0; itest < opts.ntest; ++itest ) {
+        // same matrices for each iter, so the CPU BLAS result can be reused
+        std::copy( ISEED, ISEED+4, ISEED_test );
         for( int iter = 0; iter < opts.niter; ++iter ) {
+            std::copy( ISEED_test, ISEED_test+4, ISEED );
             M = opts.msize[itest];
             N = opts.nsize[itest];
             K = opts.ksize[itest];
@@ -193,17 +194,17 @@ int main( int argc, char** argv)
             lapackf77_zlarnv( &ione, ISEED, &total_size_C_cpu, h_C );
 
             // Compute norms for error
-            h_A_tmp = h_A;
-            h_B_tmp = h_B;
-            h_C_tmp = h_C;
-            for (int s = 0; s < batchCount; ++s) {
-                Anorm[s] = lapackf77_zlange( "F",  &Am[s],  &An[s], h_A_tmp, &h_lda[s], work );
-                Bnorm[s] = lapackf77_zlange( "F",  &Bm[s],  &Bn[s], h_B_tmp, &h_ldb[s], work );
-                Cnorm[s] = lapackf77_zlange( "F", &h_M[s], &h_N[s], h_C_tmp, &h_ldc[s], work );
-                h_A_tmp +=  An[s] * h_lda[s];
-                h_B_tmp +=  Bn[s] * h_ldb[s];
-                h_C_tmp += h_N[s] * h_ldc[s];
+            h_A_array[0] = h_A;
+            h_B_array[0] = h_B;
+            h_C_array[0] = h_C;
+            for (int i = 1; i < batchCount; i++) {
+                h_A_array[i] = h_A_array[i-1] + An[i-1] * h_lda[i-1];
+                h_B_array[i] = h_B_array[i-1] + Bn[i-1] * h_ldb[i-1];
+                h_C_array[i] = h_C_array[i-1] + h_N[i-1] * h_ldc[i-1];
             }
+            magma_zlange_vbatched_ref( "F",  Am,  An, h_A_array, h_lda, Anorm, batchCount );
+            magma_zlange_vbatched_ref( "F",  Bm,  Bn, h_B_array, h_ldb, Bnorm, batchCount );
+            magma_zlange_vbatched_ref( "F", h_M, h_N, h_C_array, h_ldc, Cnorm, batchCount );
             
             /* =====================================================================
                Performs operation using MAGMABLAS
@@ -280,27 +281,27 @@ int main( int argc, char** argv)
                     h_B_array[i] = h_B_array[i-1] + Bn[i-1] * h_ldb[i-1];
                     h_C_array[i] = h_C_array[i-1] + h_N[i-1] * h_ldc[i-1];
                 }
-                cpu_time = magma_wtime();
-                //#define BATCHED_DISABLE_PARCPU
-                #if !defined (BATCHED_DISABLE_PARCPU) && defined(_OPENMP)
-                magma_int_t nthreads = magma_get_lapack_numthreads();
-                magma_set_lapack_numthreads(1);
-                magma_set_omp_numthreads(nthreads);
-                #pragma omp parallel for schedule(dynamic)
-                #endif
-                for (magma_int_t s=0; s < batchCount; s++)
-                {
-                    blasf77_zgemm( lapack_trans_const(opts.transA),
-                                   lapack_trans_const(opts.transB),
-                                   &h_M[s], &h_N[s], &h_K[s],
-                                   &alpha, h_A_array[s], &h_lda[s],
-                                           h_B_array[s], &h_ldb[s],
-                                   &beta,  h_C_array[s], &h_ldc[s] );
+                std::vector< magma_ref_buffer > outputs = {
+                    { h_C, total_size_C_cpu * sizeof(magmaDoubleComplex) } };
+                // sizes are reproducible (srand above), but include them in the key anyway
+                std::string key = magma_ref_key( "zgemm_vbatched",
+                                                 { opts.transA, opts.transB, M, N, K, batchCount },
+                                                 { { h_M, batchCount * sizeof(magma_int_t) },
+                                                   { h_N, batchCount * sizeof(magma_int_t) },
+                                                   { h_K, batchCount * sizeof(magma_int_t) },
+                                                   { h_A, total_size_A_cpu * sizeof(magmaDoubleComplex) },
+                                                   { h_B, total_size_B_cpu * sizeof(magmaDoubleComplex) },
+                                                   outputs[0] } );
+                if ( ! refcache.lookup( key, outputs, &cpu_time )) {
+                    cpu_time = magma_wtime();
+                    magma_zgemm_vbatched_ref( opts.transA, opts.transB,
+                                              h_M, h_N, h_K,
+                                              alpha, h_A_array, h_lda,
+                                                     h_B_array, h_ldb,
+                                              beta,  h_C_array, h_ldc, batchCount );
+                    cpu_time = magma_wtime() - cpu_time;
+                    refcache.store( key, outputs, cpu_time );
                 }
-                #if !defined (BATCHED_DISABLE_PARCPU) && defined(_OPENMP)
-                    magma_set_lapack_numthreads(nthreads);
-                #endif
-                cpu_time = magma_wtime() - cpu_time;
                 cpu_perf = gflops / cpu_time;
             }
             
@@ -310,22 +311,30 @@ int main( int argc, char** argv)
             if ( opts.lapack ) {
                 // compute error compared lapack
                 // error = |dC - C| / (gamma_{k+2}|A||B| + gamma_2|Cin|)
-                magma_error = 0;
-                
-                h_C_tmp = h_C;
-                h_Cmagma_tmp = h_Cmagma;
+                // h_C_array points to h_C; compute offsets for h_Cmagma
+                std::vector<magma_int_t> offset( batchCount );
                 for (int s=0; s < batchCount; s++) {
-                    normalize = sqrt(double(h_K[s]+2))*Anorm[s]*Bnorm[s] + 2*Cnorm[s];
+                    offset[s] = h_C_array[s] - h_C;
+                }
+                std::vector<double> errors( batchCount );
+                magma_int_t nthreads = magma_batched_ref_begin();
+                #pragma omp parallel for schedule(dynamic)
+                for (magma_int_t s=0; s < batchCount; s++) {
+                    double work[1];
+                    double normalize = sqrt(double(h_K[s]+2))*Anorm[s]*Bnorm[s] + 2*Cnorm[s];
                     if (normalize == 0)
                         normalize = 1;
                     magma_int_t Csize = h_ldc[s] * h_N[s];
-                    blasf77_zaxpy( &Csize, &c_neg_one, h_C_tmp, &ione, h_Cmagma_tmp, &ione );
-                    error = lapackf77_zlange( "F", &h_M[s], &h_N[s], h_Cmagma_tmp, &h_ldc[s], work )
-                          / normalize;
-                    magma_error = magma_max_nan( error, magma_error );
-                    
-                    h_C_tmp      += h_N[s] * h_ldc[s];
-                    h_Cmagma_tmp += h_N[s] * h_ldc[s];
+                    magmaDoubleComplex* Cmagma = h_Cmagma + offset[s];
+                    blasf77_zaxpy( &Csize, &c_neg_one, h_C_array[s], &ione, Cmagma, &ione );
+                    errors[s] = lapackf77_zlange( "F", &h_M[s], &h_N[s], Cmagma, &h_ldc[s], work )
+                              / normalize;
+                }
+                magma_batched_ref_end( nthreads );
+                
+                magma_error = 0;
+                for (int s=0; s < batchCount; s++) {
+                    magma_error = magma_max_nan( errors[s], magma_error );
                 }
 
                 bool okay = (magma_error < tol);
@@ -357,6 +366,10 @@ int main( int argc, char** argv)
         }
     }
 
+    if ( opts.lapack ) {
+        refcache.print_stats();
+    }
+
     // free resources
     magma_free_cpu( h_M );
     magma_free_cpu( h_N );
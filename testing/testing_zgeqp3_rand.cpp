@@ -0,0 +1,216 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "flops.h"
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+#define COMPLEX
+
+// oversampling of the sketch
+#define RAND_P  8
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing zgeqp3_rand
+   Computes the QR factorization with column pivoting with LAPACK zgeqp3 and
+   with magma_zgeqp3_rand, which picks nb pivots at a time from a sketch
+   (--nb, default 64). --version 1 uses a Gaussian sketch, --version 2 a
+   sparse sign sketch.
+   Checks |A P - Q R|_F / (max(m,n) |A|_F eps) with zqpt01, and reports the
+   rank-k truncation error |R(k+1:m, k+1:n)|_F / |A|_F of both
+   factorizations, where k is set by -N m,n,k (default min(m,n)/8), and
+   the optimal rank-k error from the singular values of A.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    real_Double_t    gflops, cpu_perf, cpu_time, rand_perf, rand_time;
+    double           Anorm, error, tail_cpu, tail_rand, optimal, work[1];
+    magmaDoubleComplex *h_A, *h_R, *tau, *h_work, temp;
+    double *sigma;
+    #ifdef COMPLEX
+    double *rwork;
+    #endif
+    magma_int_t *jpvt, *iwork;
+    magma_int_t M, N, K, n2, lda, lwork, lwork_svd, j, info, min_mn, nb, mk, nk;
+    magma_int_t ione     = 1;
+    magma_int_t ISEED[4] = {0,0,0,1};
+    int status = 0;
+
+    magma_opts opts;
+    opts.parse_opts( argc, argv );
+    magma_bench_record rec( opts, "zgeqp3_rand" );
+
+    double tol = opts.tolerance * lapackf77_dlamch("E");
+    double ulp = lapackf77_dlamch( "P" );
+    magma_sketch_t sketch = (opts.version == 2 ? MagmaSketchSparseSign : MagmaSketchGaussian);
+    nb = (opts.nb > 0 ? opts.nb : 64);
+
+    printf( "%% matrix %s, %s sketch, nb = %lld, p = %d\n", opts.matrix.c_str(),
+            (sketch == MagmaSketchGaussian ? "Gaussian" : "sparse sign"),
+            (long long) nb, RAND_P );
+    printf( "%%   M     N     K   LAPACK Gflop/s (sec)   MAGMA Gflop/s (sec)   |AP - QR|   tail LAPACK   tail MAGMA   optimal\n" );
+    printf( "%%=========================================================================================================\n" );
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            M      = opts.msize[itest];
+            N      = opts.nsize[itest];
+            K      = opts.ksize[itest];
+            min_mn = min( M, N );
+            if ( K >= min_mn ) {
+                K = max( 1, min_mn / 8 );
+            }
+            lda    = M;
+            n2     = lda*N;
+            mk     = min_mn - K;
+            nk     = N - K;
+            gflops = FLOPS_ZGEQRF( M, N ) / 1e9;
+
+            // workspace for zgeqp3, zqpt01, and the singular values of A
+            lwork = -1;
+            lapackf77_zgeqp3( &M, &N, NULL, &lda, NULL, NULL, &temp, &lwork,
+                              #ifdef COMPLEX
+                              NULL,
+                              #endif
+                              &info );
+            lwork = max( (magma_int_t) MAGMA_Z_REAL( temp ), M*N + N );
+            lwork_svd = -1;
+            lapackf77_zgesdd( "N", &M, &N, NULL, &lda, NULL, NULL, &ione, NULL, &ione,
+                              &temp, &lwork_svd,
+                              #ifdef COMPLEX
+                              NULL,
+                              #endif
+                              NULL, &info );
+            lwork = max( lwork, (magma_int_t) MAGMA_Z_REAL( temp ));
+
+            #ifdef COMPLEX
+            TESTING_CHECK( magma_dmalloc_cpu( &rwork, max( 2*N, 7*min_mn ) ));
+            #endif
+            TESTING_CHECK( magma_imalloc_cpu( &jpvt,   N        ));
+            TESTING_CHECK( magma_imalloc_cpu( &iwork,  8*min_mn ));
+            TESTING_CHECK( magma_zmalloc_cpu( &tau,    min_mn   ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_A,    n2       ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_R,    n2       ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_work, lwork    ));
+            TESTING_CHECK( magma_dmalloc_cpu( &sigma,  min_mn   ));
+
+            /* Initialize the matrix */
+            magma_generate_matrix( opts, M, N, h_A, lda );
+            Anorm = lapackf77_zlange( "F", &M, &N, h_A, &lda, work );
+
+            // optimal rank-K error, from the singular values
+            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda );
+            lapackf77_zgesdd( "N", &M, &N, h_R, &lda, sigma, NULL, &ione, NULL, &ione,
+                              h_work, &lwork,
+                              #ifdef COMPLEX
+                              rwork,
+                              #endif
+                              iwork, &info );
+            optimal = 0;
+            for( j = K; j < min_mn; ++j ) {
+                optimal += sigma[j] * sigma[j];
+            }
+            optimal = sqrt( optimal ) / Anorm;
+
+            /* =====================================================================
+               Performs operation using LAPACK
+               =================================================================== */
+            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda );
+            for( j = 0; j < N; j++)
+                jpvt[j] = 0;
+
+            cpu_time = magma_wtime();
+            lapackf77_zgeqp3( &M, &N, h_R, &lda, jpvt, tau, h_work, &lwork,
+                              #ifdef COMPLEX
+                              rwork,
+                              #endif
+                              &info );
+            cpu_time = magma_wtime() - cpu_time;
+            cpu_perf = gflops / cpu_time;
+            if (info != 0) {
+                printf("lapackf77_zgeqp3 returned error %lld.\n", (long long) info );
+            }
+            tail_cpu = lapackf77_zlantr( "F", MagmaUpperStr, MagmaNonUnitStr, &mk, &nk,
+                                         &h_R[K + K*lda], &lda, work ) / Anorm;
+
+            /* =====================================================================
+               Performs operation using MAGMA
+               =================================================================== */
+            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda );
+
+            rand_time = magma_wtime();
+            magma_zgeqp3_rand( sketch, M, N, min_mn, h_R, lda, jpvt, tau,
+                               nb, RAND_P, ISEED, &info );
+            rand_time = magma_wtime() - rand_time;
+            rand_perf = gflops / rand_time;
+            if (info != 0) {
+                printf("magma_zgeqp3_rand returned error %lld: %s.\n",
+                       (long long) info, magma_strerror( info ));
+            }
+
+            /* =====================================================================
+               Check the result
+               =================================================================== */
+            tail_rand = lapackf77_zlantr( "F", MagmaUpperStr, MagmaNonUnitStr, &mk, &nk,
+                                          &h_R[K + K*lda], &lda, work ) / Anorm;
+
+            // Compute norm( A*P - Q*R )
+            error = lapackf77_zqpt01( &M, &N, &min_mn, h_A, h_R, &lda,
+                                      tau, jpvt, h_work, &lwork );
+            error *= ulp;
+
+            bool okay = (info == 0 && error < tol);
+            status += ! okay;
+            rec.add( "m", M );
+            rec.add( "n", N );
+            rec.add( "k", K );
+            rec.add( "cpu_time", cpu_time );
+            rec.add( "magma_time", rand_time );
+            rec.add( "error", error );
+            rec.add( "tail_cpu", tail_cpu );
+            rec.add( "tail_magma", tail_rand );
+            rec.add( "optimal", optimal );
+            rec.write( iter, okay );
+            printf( "%5lld %5lld %5lld   %7.2f (%7.4f)      %7.2f (%7.4f)       %8.2e    %8.2e      %8.2e     %8.2e   %s\n",
+                    (long long) M, (long long) N, (long long) K,
+                    cpu_perf, cpu_time, rand_perf, rand_time,
+                    error, tail_cpu, tail_rand, optimal, (okay ? "ok" : "failed") );
+
+            #ifdef COMPLEX
+            magma_free_cpu( rwork );
+            #endif
+            magma_free_cpu( jpvt   );
+            magma_free_cpu( iwork  );
+            magma_free_cpu( tau    );
+            magma_free_cpu( h_A    );
+            magma_free_cpu( h_R    );
+            magma_free_cpu( h_work );
+            magma_free_cpu( sigma  );
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
@@ -40,6 +40,7 @@ int main( int argc, char** argv)
     
     magma_opts opts;
     opts.parse_opts( argc, argv );
+    magma_bench_record rec( opts, "zgeqrf" );
 
     int status = 0;
     double tol = opts.tolerance * lapackf77_dlamch("E");
@@ -151,22 +152,31 @@ int main( int argc, char** argv)
             /* =====================================================================
                Print performance and error.
                =================================================================== */
+            bool okay = true;
+            rec.add( "m", M );
+            rec.add( "n", N );
+            rec.add( "ngpu", opts.ngpu );
             printf("%5lld %5lld   ", (long long) M, (long long) N );
             if ( opts.lapack ) {
                 printf( "%7.2f (%7.2f)", cpu_perf, cpu_time );
+                rec.perf( "cpu", cpu_perf, cpu_time );
             }
             else {
                 printf("  ---   (  ---  )" );
             }
             printf( "   %7.2f (%7.2f)   ", gpu_perf, gpu_time );
+            rec.perf( "magma", gpu_perf, gpu_time );
             if ( opts.check ) {
-                bool okay = (error < tol && error2 < tol);
+                okay = (error < tol && error2 < tol);
                 status += ! okay;
                 printf( "%11.2e   %11.2e   %s\n", error, error2, (okay ? "ok" : "failed") );
+                rec.add( "error",  error  );
+                rec.add( "error2", error2 );
             }
             else {
                 printf( "    ---\n" );
             }
+            rec.write( iter, okay );
             
             magma_free_cpu( tau    );
             magma_free_cpu( h_A    );
@@ -0,0 +1,230 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "flops.h"
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+#define COMPLEX
+
+// oversampling and power iterations used for the randomized SVD
+#define RAND_P      10
+#define RAND_NITER  2
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing zgesvd_rand
+   Computes the rank-k randomized SVD with magma_zgesvd_rand and the full SVD
+   with LAPACK zgesdd. Use -N m,n,k to set the target rank k; by default,
+   k = min(m,n)/8. --version 1 uses a Gaussian sketch, --version 2 a sparse
+   sign sketch.
+   Reports
+       |A - U S V^H|_F / |A|_F,  the error of the rank-k approximation,
+       the optimal rank-k error from LAPACK's singular values,
+           ( sum_{i > k} sigma_i^2 )^{1/2} / |A|_F,
+       their ratio, and
+       max_i |s_i - sigma_i| / sigma_1.
+   Checks that U and V have orthonormal columns, and that the ratio is below
+   (1 + k/(p-1))^{1/2}, the expected bound without power iterations
+   (Halko, Martinsson, Tropp, 2011, Theorem 10.5).
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    real_Double_t   cpu_time, rand_time;
+    double          Anorm, error, optimal, ratio, bound, sdiff, ortho_u, ortho_v, work[1];
+    magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    magmaDoubleComplex *h_A, *h_R, *h_U, *h_VT, *h_Uk, *h_VTk, *hwork, temp;
+    double *Sref, *S;
+    #ifdef COMPLEX
+    double *rwork;
+    magma_int_t lrwork;
+    #endif
+    magma_int_t *iwork;
+    magma_int_t M, N, K, min_mn, lda, lwork, lwork_ort, info;
+    magma_int_t ione = 1;
+    magma_int_t ISEED[4] = {0,0,0,1};
+    int status = 0;
+
+    magma_opts opts;
+    opts.parse_opts( argc, argv );
+    magma_bench_record rec( opts, "zgesvd_rand" );
+
+    double tol = opts.tolerance * lapackf77_dlamch("E");
+    magma_sketch_t sketch = (opts.version == 2 ? MagmaSketchSparseSign : MagmaSketchGaussian);
+
+    printf( "%% matrix %s, %s sketch, p = %d, niter = %d\n", opts.matrix.c_str(),
+            (sketch == MagmaSketchGaussian ? "Gaussian" : "sparse sign"),
+            RAND_P, RAND_NITER );
+    printf( "%%   M     N     K   LAPACK gesdd (sec)   MAGMA rand (sec)   speedup   |A-USV^H|/|A|   optimal    ratio   |s - sigma|/sigma_1\n" );
+    printf( "%%=====================================================================================================================\n" );
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            M      = opts.msize[itest];
+            N      = opts.nsize[itest];
+            K      = opts.ksize[itest];
+            min_mn = min( M, N );
+            if ( K >= min_mn ) {
+                K = max( 1, min_mn / 8 );
+            }
+            lda    = M;
+
+            // workspace for zgesdd, and for zunt01 of U and V^H
+            lwork = -1;
+            lapackf77_zgesdd( "S", &M, &N, NULL, &lda, NULL, NULL, &lda, NULL, &min_mn,
+                              &temp, &lwork,
+                              #ifdef COMPLEX
+                              NULL,
+                              #endif
+                              NULL, &info );
+            lwork_ort = K*(K + 1);
+            lwork = max( (magma_int_t) MAGMA_Z_REAL( temp ), lwork_ort );
+            #ifdef COMPLEX
+            lrwork = min_mn*max( 5*min_mn + 7, 2*max( M, N ) + 2*min_mn + 1 );
+            TESTING_CHECK( magma_dmalloc_cpu( &rwork, lrwork ));
+            #endif
+
+            TESTING_CHECK( magma_zmalloc_cpu( &h_A,   lda*N    ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_R,   lda*N    ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_U,   lda*min_mn ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_VT,  min_mn*N ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_Uk,  lda*K    ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_VTk, K*N      ));
+            TESTING_CHECK( magma_zmalloc_cpu( &hwork, lwork    ));
+            TESTING_CHECK( magma_dmalloc_cpu( &Sref,  min_mn   ));
+            TESTING_CHECK( magma_dmalloc_cpu( &S,     K        ));
+            TESTING_CHECK( magma_imalloc_cpu( &iwork, 8*min_mn ));
+
+            /* Initialize the matrix */
+            magma_generate_matrix( opts, M, N, h_A, lda );
+            Anorm = lapackf77_zlange( "F", &M, &N, h_A, &lda, work );
+
+            /* =====================================================================
+               Performs operation using LAPACK
+               =================================================================== */
+            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda );
+            cpu_time = magma_wtime();
+            lapackf77_zgesdd( "S", &M, &N, h_R, &lda, Sref, h_U, &lda, h_VT, &min_mn,
+                              hwork, &lwork,
+                              #ifdef COMPLEX
+                              rwork,
+                              #endif
+                              iwork, &info );
+            cpu_time = magma_wtime() - cpu_time;
+            if (info != 0) {
+                printf("lapackf77_zgesdd returned error %lld.\n", (long long) info );
+            }
+
+            /* =====================================================================
+               Performs operation using MAGMA
+               =================================================================== */
+            rand_time = magma_wtime();
+            magma_zgesvd_rand( MagmaSomeVec, sketch, M, N, K, RAND_P, RAND_NITER,
+                               h_A, lda, S, h_Uk, lda, h_VTk, K, ISEED, &info );
+            rand_time = magma_wtime() - rand_time;
+            if (info != 0) {
+                printf("magma_zgesvd_rand returned error %lld: %s.\n",
+                       (long long) info, magma_strerror( info ));
+            }
+
+            /* =====================================================================
+               Check the result
+               =================================================================== */
+            // orthogonality of U and V, before U is scaled
+            lapackf77_zunt01( "Columns", &M, &K, h_Uk, &lda, hwork, &lwork_ort,
+                              #ifdef COMPLEX
+                              rwork,
+                              #endif
+                              &ortho_u );
+            lapackf77_zunt01( "Rows", &K, &N, h_VTk, &K, hwork, &lwork_ort,
+                              #ifdef COMPLEX
+                              rwork,
+                              #endif
+                              &ortho_v );
+            // zunt01 returns |I - U^H U| / (k eps)
+            ortho_u *= lapackf77_dlamch("E");
+            ortho_v *= lapackf77_dlamch("E");
+
+            // |A - U S V^H|_F / |A|_F
+            for( magma_int_t j = 0; j < K; ++j ) {
+                temp = MAGMA_Z_MAKE( S[j], 0. );
+                blasf77_zscal( &M, &temp, &h_Uk[j*lda], &ione );
+            }
+            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda );
+            blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &M, &N, &K,
+                           &c_neg_one, h_Uk,  &lda,
+                                       h_VTk, &K,
+                           &c_one,     h_R,   &lda );
+            error = lapackf77_zlange( "F", &M, &N, h_R, &lda, work ) / Anorm;
+
+            optimal = 0;
+            for( magma_int_t i = K; i < min_mn; ++i ) {
+                optimal += Sref[i] * Sref[i];
+            }
+            optimal = sqrt( optimal ) / Anorm;
+            // if A has exact rank K, compare with roundoff instead
+            ratio = error / max( optimal, lapackf77_dlamch("E") );
+
+            sdiff = 0;
+            for( magma_int_t i = 0; i < K; ++i ) {
+                sdiff = max( sdiff, fabs( S[i] - Sref[i] ) / Sref[0] );
+            }
+
+            bound = sqrt( 1. + K / (RAND_P - 1.) );
+            bool okay = (info == 0 && ortho_u < tol && ortho_v < tol && ratio < bound);
+            status += ! okay;
+            rec.add( "m", M );
+            rec.add( "n", N );
+            rec.add( "k", K );
+            rec.add( "cpu_time", cpu_time );
+            rec.add( "magma_time", rand_time );
+            rec.add( "error", error );
+            rec.add( "optimal", optimal );
+            rec.add( "sval_diff", sdiff );
+            rec.write( iter, okay );
+            printf( "%5lld %5lld %5lld   %9.4f            %9.4f          %6.2f    %8.2e        %8.2e   %6.3f   %8.2e   %s\n",
+                    (long long) M, (long long) N, (long long) K,
+                    cpu_time, rand_time, cpu_time / rand_time,
+                    error, optimal, ratio, sdiff, (okay ? "ok" : "failed") );
+
+            magma_free_cpu( h_A   );
+            magma_free_cpu( h_R   );
+            magma_free_cpu( h_U   );
+            magma_free_cpu( h_VT  );
+            magma_free_cpu( h_Uk  );
+            magma_free_cpu( h_VTk );
+            magma_free_cpu( hwork );
+            magma_free_cpu( Sref  );
+            magma_free_cpu( S     );
+            magma_free_cpu( iwork );
+            #ifdef COMPLEX
+            magma_free_cpu( rwork );
+            #endif
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
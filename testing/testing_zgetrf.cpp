@@ -176,6 +176,7 @@ int main( int argc, char** argv)
     
     magma_opts opts;
     opts.parse_opts( argc, argv );
+    magma_bench_record rec( opts, "zgetrf" );
     
     double tol = opts.tolerance * lapackf77_dlamch("E");
 
@@ -246,6 +247,16 @@ int main( int argc, char** argv)
             /* =====================================================================
                Check the factorization
                =================================================================== */
+            bool okay = true;
+            rec.add( "m", M );
+            rec.add( "n", N );
+            rec.add( "version", opts.version );
+            rec.add( "ngpu",    opts.ngpu );
+            rec.add( "check",   opts.check );
+            if ( opts.lapack ) {
+                rec.perf( "cpu", cpu_perf, cpu_time );
+            }
+            rec.perf( "magma", gpu_perf, gpu_time );
             if ( opts.lapack ) {
                 printf("%5lld %5lld   %7.2f (%7.2f)   %7.2f (%7.2f)",
                        (long long) M, (long long) N, cpu_perf, cpu_time, gpu_perf, gpu_time );
@@ -256,17 +267,22 @@ int main( int argc, char** argv)
             }
             if ( opts.check == 2 ) {
                 error = get_residual( opts, M, N, h_A, lda, ipiv );
-                printf("   %8.2e   %s\n", error, (error < tol ? "ok" : "failed"));
-                status += ! (error < tol);
+                okay = (error < tol);
+                printf("   %8.2e   %s\n", error, (okay ? "ok" : "failed"));
+                rec.add( "error", error );
+                status += ! okay;
             }
             else if ( opts.check ) {
                 error = get_LU_error( opts, M, N, h_A, lda, ipiv );
-                printf("   %8.2e   %s\n", error, (error < tol ? "ok" : "failed"));
-                status += ! (error < tol);
+                okay = (error < tol);
+                printf("   %8.2e   %s\n", error, (okay ? "ok" : "failed"));
+                rec.add( "error", error );
+                status += ! okay;
             }
             else {
                 printf("     ---   \n");
             }
+            rec.write( iter, okay );
             
             magma_free_cpu( ipiv );
             magma_free_pinned( h_A  );
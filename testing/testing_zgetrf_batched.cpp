@@ -22,10 +22,7 @@
 #include "magma_lapack.h"
 #include "testings.h"
 
-#if defined(_OPENMP)
-#include <omp.h>
-#include "../control/magma_threadsetting.h"  // internal header
-#endif
+#include <algorithm>  // copy
 
 double get_LU_error(magma_int_t M, magma_int_t N,
                     magmaDoubleComplex *A,  magma_int_t lda,
@@ -84,19 +81,23 @@ int main( int argc, char** argv)
     magmaDoubleComplex **dA_array = NULL;
 
     magma_int_t     **dipiv_array = NULL;
+    magmaDoubleComplex **hA_array = NULL;
+    magma_int_t     **hipiv_array = NULL;
     magma_int_t     *ipiv, *cpu_info;
     magma_int_t     *dipiv_magma, *dinfo_magma;
     int             *dipiv_cublas, *dinfo_cublas;  // not magma_int_t
     
     magma_int_t M, N, n2, lda, ldda, min_mn, info;
     magma_int_t ione     = 1;
-    magma_int_t ISEED[4] = {0,0,0,1};
+    magma_int_t ISEED[4] = {0,0,0,1}, ISEED_test[4];
     magma_int_t batchCount;
     int status = 0;
+    magma_ref_cache refcache;
 
     magma_opts opts( MagmaOptsBatched );
     opts.parse_opts( argc, argv );
     //opts.lapack |= opts.check;
+    magma_bench_record rec( opts, "zgetrf_batched" );
     double tol = opts.tolerance * lapackf77_dlamch("E");
 
     batchCount = opts.batchcount;
@@ -105,7 +106,10 @@ int main( int argc, char** argv)
     printf("%% BatchCount   M     N    CPU Gflop/s (ms)   MAGMA Gflop/s (ms)   CUBLAS Gflop/s (ms)   ||PA-LU||/(||A||*N)\n");
     printf("%%==========================================================================================================\n");
     for( int itest = 0; itest < opts.ntest; ++itest ) {
+        // same matrices for each iter, so the LAPACK result can be reused
+        std::copy( ISEED, ISEED+4, ISEED_test );
         for( int iter = 0; iter < opts.niter; ++iter ) {
+            std::copy( ISEED_test, ISEED_test+4, ISEED );
             M = opts.msize[itest];
             N = opts.nsize[itest];
             min_mn = min(M, N);
@@ -128,6 +132,8 @@ int main( int argc, char** argv)
 
             TESTING_CHECK( magma_malloc( (void**) &dA_array,    batchCount * sizeof(magmaDoubleComplex*) ));
             TESTING_CHECK( magma_malloc( (void**) &dipiv_array, batchCount * sizeof(magma_int_t*) ));
+            TESTING_CHECK( magma_malloc_cpu( (void**) &hA_array,    batchCount * sizeof(magmaDoubleComplex*) ));
+            TESTING_CHECK( magma_malloc_cpu( (void**) &hipiv_array, batchCount * sizeof(magma_int_t*) ));
 
             /* Initialize the matrix */
             lapackf77_zlarnv( &ione, ISEED, &n2, h_A );
@@ -186,34 +192,44 @@ int main( int argc, char** argv)
                Performs operation using LAPACK
                =================================================================== */
             if ( opts.lapack ) {
-                cpu_time = magma_wtime();
-                // #define BATCHED_DISABLE_PARCPU
-                #if !defined (BATCHED_DISABLE_PARCPU) && defined(_OPENMP)
-                magma_int_t nthreads = magma_get_lapack_numthreads();
-                magma_set_lapack_numthreads(1);
-                magma_set_omp_numthreads(nthreads);
-                #pragma omp parallel for schedule(dynamic)
-                #endif
-                for (magma_int_t s=0; s < batchCount; s++)
-                {
-                    magma_int_t locinfo;
-                    lapackf77_zgetrf(&M, &N, h_A + s * lda * N, &lda, ipiv + s * min_mn, &locinfo);
-                    if (locinfo != 0) {
+                for (magma_int_t s=0; s < batchCount; s++) {
+                    hA_array[s]    = h_A  + s * lda * N;
+                    hipiv_array[s] = ipiv + s * min_mn;
+                }
+                std::vector< magma_ref_buffer > outputs = {
+                    { h_A,      n2                  * sizeof(magmaDoubleComplex) },
+                    { ipiv,     min_mn * batchCount * sizeof(magma_int_t) },
+                    { cpu_info, batchCount          * sizeof(magma_int_t) } };
+                std::string key = magma_ref_key( "zgetrf_batched", { M, N, lda, batchCount },
+                                                 { outputs[0] } );
+                if ( ! refcache.lookup( key, outputs, &cpu_time )) {
+                    cpu_time = magma_wtime();
+                    magma_zgetrf_batched_ref( M, N, hA_array, lda, hipiv_array, cpu_info, batchCount );
+                    cpu_time = magma_wtime() - cpu_time;
+                    refcache.store( key, outputs, cpu_time );
+                }
+                cpu_perf = gflops / cpu_time;
+                
+                for (magma_int_t s=0; s < batchCount; s++) {
+                    if (cpu_info[s] != 0) {
                         printf("lapackf77_zgetrf matrix %lld returned error %lld: %s.\n",
-                               (long long) s, (long long) locinfo, magma_strerror( locinfo ));
+                               (long long) s, (long long) cpu_info[s], magma_strerror( cpu_info[s] ));
                     }
                 }
-                #if !defined (BATCHED_DISABLE_PARCPU) && defined(_OPENMP)
-                    magma_set_lapack_numthreads(nthreads);
-                #endif
-                
-                cpu_time = magma_wtime() - cpu_time;
-                cpu_perf = gflops / cpu_time;
             }
             
             /* =====================================================================
                Check the factorization
                =================================================================== */
+            bool okay = true;
+            rec.add( "batch", batchCount );
+            rec.add( "m", M );
+            rec.add( "n", N );
+            if ( opts.lapack ) {
+                rec.perf( "cpu", cpu_perf, cpu_time );
+            }
+            rec.perf( "magma",  magma_perf,  magma_time  );
+            rec.perf( "cublas", cublas_perf, cublas_time );
             if ( opts.lapack ) {
                 printf("%10lld %5lld %5lld   %7.2f (%7.2f)    %7.2f (%7.2f)     %7.2f (%7.2f)",
                        (long long) batchCount, (long long) M, (long long) N,
@@ -242,21 +258,28 @@ int main( int argc, char** argv)
                     if (error == -1) {
                         break;
                     }
-                    
-                    double err = get_LU_error( M, N, h_R + i * lda*N, lda, h_Amagma + i * lda*N, ipiv + i * min_mn);
-                    if (std::isnan(err) || std::isinf(err)) {
-                        error = err;
-                        break;
+                }
+                if (error == 0) {
+                    std::vector<double> errors( batchCount );
+                    magma_int_t nthreads = magma_batched_ref_begin();
+                    #pragma omp parallel for schedule(dynamic)
+                    for (magma_int_t i=0; i < batchCount; i++) {
+                        errors[i] = get_LU_error( M, N, h_R + i * lda*N, lda, h_Amagma + i * lda*N, ipiv + i * min_mn );
+                    }
+                    magma_batched_ref_end( nthreads );
+                    for (magma_int_t i=0; i < batchCount; i++) {
+                        error = magma_max_nan( errors[i], error );
                     }
-                    error = max( err, error );
                 }
-                bool okay = (error < tol);
+                okay = (error < tol);
                 status += ! okay;
                 printf("   %8.2e   %s\n", error, (okay ? "ok" : "failed") );
+                rec.add( "error", error );
             }
             else {
                 printf("     ---\n");
             }
+            rec.write( iter, okay );
             
             magma_free_cpu( cpu_info );
             magma_free_cpu( ipiv );
@@ -271,12 +294,17 @@ int main( int argc, char** argv)
             magma_free( dinfo_cublas );
             magma_free( dipiv_array );
             magma_free( dA_array );
+            magma_free_cpu( hA_array );
+            magma_free_cpu( hipiv_array );
             fflush( stdout );
         }
         if ( opts.niter > 1 ) {
             printf( "\n" );
         }
     }
+    if ( opts.lapack ) {
+        refcache.print_stats();
+    }
     
     opts.cleanup();
     TESTING_CHECK( magma_finalize() );
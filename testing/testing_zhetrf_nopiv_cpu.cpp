@@ -0,0 +1,207 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "flops.h"
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "magma_operators.h"  // for MAGMA_Z_DIV
+#include "testings.h"
+
+
+/******************************************************************************/
+// LD is the LDL^H factorization of A without pivoting. Solves Ax = b for a
+// random b and returns the residual |Ax - b| / (n |A| |x|).
+static double get_residual_nopiv(
+    magma_uplo_t uplo, magma_int_t n,
+    const magmaDoubleComplex *A,  magma_int_t lda,
+    const magmaDoubleComplex *LD, magma_int_t ldld )
+{
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    const magma_int_t ione = 1;
+
+    magma_int_t ISEED[4] = {0,0,0,1};
+    magmaDoubleComplex *x, *b;
+    TESTING_CHECK( magma_zmalloc_cpu( &x, n ));
+    TESTING_CHECK( magma_zmalloc_cpu( &b, n ));
+    lapackf77_zlarnv( &ione, ISEED, &n, b );
+    blasf77_zcopy( &n, b, &ione, x, &ione );
+
+    // x = L^{-H} D^{-1} L^{-1} b, or U^{-1} D^{-1} U^{-H} b
+    const char* trans1 = (uplo == MagmaLower ? MagmaNoTransStr   : MagmaConjTransStr);
+    const char* trans2 = (uplo == MagmaLower ? MagmaConjTransStr : MagmaNoTransStr  );
+    blasf77_ztrsm( MagmaLeftStr, lapack_uplo_const(uplo), trans1, MagmaUnitStr,
+                   &n, &ione, &c_one, LD, &ldld, x, &n );
+    for (magma_int_t i = 0; i < n; ++i) {
+        x[i] = MAGMA_Z_DIV( x[i], LD[ i + i*ldld ] );
+    }
+    blasf77_ztrsm( MagmaLeftStr, lapack_uplo_const(uplo), trans2, MagmaUnitStr,
+                   &n, &ione, &c_one, LD, &ldld, x, &n );
+
+    // r = Ax - b, saved in b
+    blasf77_zhemv( lapack_uplo_const(uplo), &n, &c_one, A, &lda, x, &ione,
+                   &c_neg_one, b, &ione );
+
+    double work[1];
+    double norm_A = lapackf77_zlanhe( "Fro", lapack_uplo_const(uplo), &n, A, &lda, work );
+    double norm_r = lapackf77_zlange( "Fro", &n, &ione, b, &n, work );
+    double norm_x = lapackf77_zlange( "Fro", &n, &ione, x, &n, work );
+
+    magma_free_cpu( x );
+    magma_free_cpu( b );
+    return norm_r / (n * norm_A * norm_x);
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing zhetrf_nopiv_rec_cpu
+   Compares the recursive, multithreaded CPU LDL^H without pivoting
+   (magma_zhetrf_nopiv_rec_cpu) with the blocked version
+   (magma_zhetrf_nopiv_cpu) and with LAPACK zhetrf (Bunch-Kaufman pivoting).
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    real_Double_t   gflops, rec_perf, rec_time, blk_perf, blk_time, cpu_perf=0, cpu_time=0;
+    double          rec_error, blk_error;
+    magmaDoubleComplex *h_A, *h_R, *work, temp;
+    magma_int_t     *ipiv;
+    magma_int_t     N, n2, lda, lwork, info;
+    int status = 0;
+
+    magma_opts opts;
+    opts.matrix = "rand_dominant";  // default; no pivoting requires it
+    opts.parse_opts( argc, argv );
+    magma_bench_record rec( opts, "zhetrf_nopiv_cpu" );
+
+    double tol = opts.tolerance * lapackf77_dlamch("E");
+    magma_int_t ib = min( 32, opts.nb > 0 ? opts.nb : 32 );
+
+    printf( "%% uplo = %s, ib = %lld\n", lapack_uplo_const(opts.uplo), (long long) ib );
+    printf( "%%   N   LAPACK Gflop/s (sec)   Blocked Gflop/s (sec)   Recursive Gflop/s (sec)   |Ax-b|/(N*|A|*|x|) blocked, recursive\n" );
+    printf( "%%===================================================================================================================\n" );
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            N      = opts.nsize[itest];
+            lda    = N;
+            n2     = lda*N;
+            gflops = FLOPS_ZPOTRF( N ) / 1e9;
+
+            TESTING_CHECK( magma_zmalloc_cpu( &h_A, n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_R, n2 ));
+            TESTING_CHECK( magma_imalloc_cpu( &ipiv, N ));
+
+            magma_generate_matrix( opts, N, N, h_A, lda );
+
+            /* =====================================================================
+               Performs operation using LAPACK, with pivoting
+               =================================================================== */
+            if ( opts.lapack ) {
+                lwork = -1;
+                lapackf77_zhetrf( lapack_uplo_const(opts.uplo), &N, h_R, &lda, ipiv, &temp, &lwork, &info );
+                lwork = max( 1, (magma_int_t) MAGMA_Z_REAL( temp ));
+                TESTING_CHECK( magma_zmalloc_cpu( &work, lwork ));
+
+                lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_R, &lda );
+                cpu_time = magma_wtime();
+                lapackf77_zhetrf( lapack_uplo_const(opts.uplo), &N, h_R, &lda, ipiv, work, &lwork, &info );
+                cpu_time = magma_wtime() - cpu_time;
+                cpu_perf = gflops / cpu_time;
+                if (info != 0) {
+                    printf("lapackf77_zhetrf returned error %lld: %s.\n",
+                           (long long) info, magma_strerror( info ));
+                }
+                magma_free_cpu( work );
+            }
+
+            /* =====================================================================
+               Performs operation using blocked version
+               =================================================================== */
+            lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_R, &lda );
+            blk_time = magma_wtime();
+            magma_zhetrf_nopiv_cpu( opts.uplo, N, ib, h_R, lda, &info );
+            blk_time = magma_wtime() - blk_time;
+            blk_perf = gflops / blk_time;
+            if (info != 0) {
+                printf("magma_zhetrf_nopiv_cpu returned error %lld: %s.\n",
+                       (long long) info, magma_strerror( info ));
+            }
+            blk_error = (opts.check && info == 0
+                         ? get_residual_nopiv( opts.uplo, N, h_A, lda, h_R, lda )
+                         : 0 );
+
+            /* =====================================================================
+               Performs operation using recursive version
+               =================================================================== */
+            lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_R, &lda );
+            rec_time = magma_wtime();
+            magma_zhetrf_nopiv_rec_cpu( opts.uplo, N, ib, h_R, lda, &info );
+            rec_time = magma_wtime() - rec_time;
+            rec_perf = gflops / rec_time;
+            if (info != 0) {
+                printf("magma_zhetrf_nopiv_rec_cpu returned error %lld: %s.\n",
+                       (long long) info, magma_strerror( info ));
+            }
+            rec_error = (opts.check && info == 0
+                         ? get_residual_nopiv( opts.uplo, N, h_A, lda, h_R, lda )
+                         : 0 );
+
+            /* =====================================================================
+               Print performance and error
+               =================================================================== */
+            bool okay = true;
+            rec.add( "n", N );
+            rec.add( "uplo", lapack_uplo_const(opts.uplo) );
+            rec.add( "ib", ib );
+            rec.perf( "blocked", blk_perf, blk_time );
+            rec.perf( "magma", rec_perf, rec_time );
+            if ( opts.lapack ) {
+                rec.perf( "cpu", cpu_perf, cpu_time );
+                printf( "%5lld     %7.2f (%7.2f)       %7.2f (%7.2f)         %7.2f (%7.2f)",
+                        (long long) N, cpu_perf, cpu_time, blk_perf, blk_time, rec_perf, rec_time );
+            }
+            else {
+                printf( "%5lld       ---   (  ---  )       %7.2f (%7.2f)         %7.2f (%7.2f)",
+                        (long long) N, blk_perf, blk_time, rec_perf, rec_time );
+            }
+            if ( opts.check ) {
+                okay = (blk_error < tol && rec_error < tol);
+                rec.add( "blocked_error", blk_error );
+                rec.add( "error", rec_error );
+                printf( "   %8.2e  %8.2e   %s\n", blk_error, rec_error, (okay ? "ok" : "failed") );
+                status += ! okay;
+            }
+            else {
+                printf( "     ---       ---\n" );
+            }
+            rec.write( iter, okay );
+
+            magma_free_cpu( h_A );
+            magma_free_cpu( h_R );
+            magma_free_cpu( ipiv );
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
@@ -0,0 +1,243 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "flops.h"
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "magma_operators.h"
+#include "testings.h"
+
+#define COMPLEX
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing zhseqr_mt
+   Reduces the generated N-by-N matrix A to Hessenberg form, A = Q H Q^H,
+   then computes the Schur form H = Z T Z^H with LAPACK zhseqr and with
+   magma_zhseqr_mt, both accumulating the Schur vectors into Q.
+   Checks |A - (QZ) T (QZ)^H| / (N |A|) and |I - (QZ)^H (QZ)| / N for MAGMA.
+   The eigenvalues are compared with LAPACK's, matching each to the closest,
+   as max_i |w_i - w_lapack| / max_i |w_lapack|; how close they can be depends
+   on their condition numbers, so this difference is reported but not checked.
+   Use --matrix geev (A = U T U^H, see magma_generate_matrix) to set the
+   eigenvalues, and --nthread for the number of threads.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    real_Double_t   cpu_time, mt_time;
+    double          error, error_orth, diff, wmax, d, Anorm, work[1];
+    magmaDoubleComplex *h_A, *h_H, *h_T, *h_Q, *h_Z, *h_R, *tau, *hwork, temp;
+    #ifdef COMPLEX
+    magmaDoubleComplex *w_lapack, *w_mt;
+    #else
+    double *wr_lapack, *wi_lapack, *wr_mt, *wi_mt;
+    #endif
+    magmaDoubleComplex c_zero    = MAGMA_Z_ZERO;
+    magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    magma_int_t N, lda, n2, lwork, lwork_q, ilo, ihi, info, info_mt;
+    int status = 0;
+
+    magma_opts opts;
+    opts.parse_opts( argc, argv );
+    magma_bench_record rec( opts, "zhseqr_mt" );
+
+    double tol = opts.tolerance * lapackf77_dlamch("E");
+    magma_int_t nthread = opts.nthread;
+
+    printf( "%% nthread = %lld, matrix %s\n", (long long) nthread, opts.matrix.c_str() );
+    printf( "%%   N   LAPACK time (sec)   MAGMA time (sec)   speedup   |A - ZTZ^H| / (N |A|)   |I - Z^H Z| / N   eigenvalue diff\n" );
+    printf( "%%=========================================================================================================\n" );
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            N   = opts.nsize[itest];
+            lda = N;
+            n2  = lda*N;
+            ilo = 1;
+            ihi = N;
+
+            TESTING_CHECK( magma_zmalloc_cpu( &h_A, n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_H, n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_T, n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_Q, n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_Z, n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_R, n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &tau, N  ));
+            #ifdef COMPLEX
+            TESTING_CHECK( magma_zmalloc_cpu( &w_lapack, N ));
+            TESTING_CHECK( magma_zmalloc_cpu( &w_mt,     N ));
+            #else
+            TESTING_CHECK( magma_dmalloc_cpu( &wr_lapack, N ));
+            TESTING_CHECK( magma_dmalloc_cpu( &wi_lapack, N ));
+            TESTING_CHECK( magma_dmalloc_cpu( &wr_mt,     N ));
+            TESTING_CHECK( magma_dmalloc_cpu( &wi_mt,     N ));
+            #endif
+
+            /* Initialize the matrix and reduce it to Hessenberg form */
+            magma_generate_matrix( opts, N, N, h_A, lda );
+            Anorm = lapackf77_zlange( "F", &N, &N, h_A, &lda, work );
+
+            lwork = -1;
+            lapackf77_zgehrd( &N, &ilo, &ihi, h_H, &lda, tau, &temp, &lwork, &info );
+            lwork = max( N, (magma_int_t) MAGMA_Z_REAL( temp ));
+            lwork_q = -1;
+            lapackf77_zunghr( &N, &ilo, &ihi, h_Q, &lda, tau, &temp, &lwork_q, &info );
+            lwork = max( lwork, (magma_int_t) MAGMA_Z_REAL( temp ));
+            lwork_q = -1;
+            #ifdef COMPLEX
+            lapackf77_zhseqr( "S", "V", &N, &ilo, &ihi, h_T, &lda, w_lapack,
+                              h_Z, &lda, &temp, &lwork_q, &info );
+            #else
+            lapackf77_zhseqr( "S", "V", &N, &ilo, &ihi, h_T, &lda, wr_lapack, wi_lapack,
+                              h_Z, &lda, &temp, &lwork_q, &info );
+            #endif
+            lwork = max( lwork, (magma_int_t) MAGMA_Z_REAL( temp ));
+            TESTING_CHECK( magma_zmalloc_cpu( &hwork, lwork ));
+
+            lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_H, &lda );
+            lapackf77_zgehrd( &N, &ilo, &ihi, h_H, &lda, tau, hwork, &lwork, &info );
+            lapackf77_zlacpy( MagmaLowerStr, &N, &N, h_H, &lda, h_Q, &lda );
+            lapackf77_zunghr( &N, &ilo, &ihi, h_Q, &lda, tau, hwork, &lwork, &info );
+            if (N > 2) {
+                magma_int_t N2 = N - 2;
+                lapackf77_zlaset( MagmaLowerStr, &N2, &N2, &c_zero, &c_zero, &h_H[2], &lda );
+            }
+
+            /* =====================================================================
+               Performs operation using LAPACK
+               =================================================================== */
+            lapackf77_zlacpy( MagmaFullStr, &N, &N, h_H, &lda, h_T, &lda );
+            lapackf77_zlacpy( MagmaFullStr, &N, &N, h_Q, &lda, h_Z, &lda );
+            cpu_time = magma_wtime();
+            #ifdef COMPLEX
+            lapackf77_zhseqr( "S", "V", &N, &ilo, &ihi, h_T, &lda, w_lapack,
+                              h_Z, &lda, hwork, &lwork, &info );
+            #else
+            lapackf77_zhseqr( "S", "V", &N, &ilo, &ihi, h_T, &lda, wr_lapack, wi_lapack,
+                              h_Z, &lda, hwork, &lwork, &info );
+            #endif
+            cpu_time = magma_wtime() - cpu_time;
+            if (info != 0) {
+                printf("lapackf77_zhseqr returned error %lld.\n", (long long) info );
+            }
+
+            /* =====================================================================
+               Performs operation using MAGMA
+               =================================================================== */
+            lapackf77_zlacpy( MagmaFullStr, &N, &N, h_H, &lda, h_T, &lda );
+            lapackf77_zlacpy( MagmaFullStr, &N, &N, h_Q, &lda, h_Z, &lda );
+            mt_time = magma_wtime();
+            #ifdef COMPLEX
+            magma_zhseqr_mt( MagmaTrue, MagmaVec, N, ilo, ihi, h_T, lda, w_mt,
+                             h_Z, lda, nthread, &info_mt );
+            #else
+            magma_zhseqr_mt( MagmaTrue, MagmaVec, N, ilo, ihi, h_T, lda, wr_mt, wi_mt,
+                             h_Z, lda, nthread, &info_mt );
+            #endif
+            mt_time = magma_wtime() - mt_time;
+            if (info_mt != 0) {
+                printf("magma_zhseqr_mt returned error %lld: %s.\n",
+                       (long long) info_mt, magma_strerror( info_mt ));
+            }
+
+            /* =====================================================================
+               Check the result
+               =================================================================== */
+            // R = A - Z T Z^H
+            blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &N, &N, &N,
+                           &c_one,  h_Z, &lda, h_T, &lda,
+                           &c_zero, h_H, &lda );
+            lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_R, &lda );
+            blasf77_zgemm( MagmaNoTransStr, MagmaConjTransStr, &N, &N, &N,
+                           &c_neg_one, h_H, &lda, h_Z, &lda,
+                           &c_one,     h_R, &lda );
+            error = lapackf77_zlange( "F", &N, &N, h_R, &lda, work );
+            error = (Anorm == 0 ? error : error / (N * Anorm));
+
+            // R = I - Z^H Z
+            lapackf77_zlaset( MagmaFullStr, &N, &N, &c_zero, &c_one, h_R, &lda );
+            blasf77_zgemm( MagmaConjTransStr, MagmaNoTransStr, &N, &N, &N,
+                           &c_neg_one, h_Z, &lda, h_Z, &lda,
+                           &c_one,     h_R, &lda );
+            error_orth = lapackf77_zlange( "F", &N, &N, h_R, &lda, work ) / N;
+
+            // eigenvalues, each matched to the closest of LAPACK's
+            diff = 0;
+            wmax = 0;
+            for (magma_int_t i = 0; i < N; ++i) {
+                d = HUGE_VAL;
+                for (magma_int_t k = 0; k < N; ++k) {
+                    #ifdef COMPLEX
+                    d = min( d, MAGMA_Z_ABS( w_mt[i] - w_lapack[k] ));
+                    #else
+                    d = min( d, sqrt( (wr_mt[i] - wr_lapack[k])*(wr_mt[i] - wr_lapack[k])
+                                    + (wi_mt[i] - wi_lapack[k])*(wi_mt[i] - wi_lapack[k]) ));
+                    #endif
+                }
+                diff = max( diff, d );
+                #ifdef COMPLEX
+                wmax = max( wmax, MAGMA_Z_ABS( w_lapack[i] ));
+                #else
+                wmax = max( wmax, sqrt( wr_lapack[i]*wr_lapack[i] + wi_lapack[i]*wi_lapack[i] ));
+                #endif
+            }
+            diff = (wmax == 0 ? diff : diff / wmax);
+
+            bool okay = (error < tol && error_orth < tol && info_mt == 0);
+            status += ! okay;
+            rec.add( "n", N );
+            rec.add( "nthread", nthread );
+            rec.add( "cpu_time", cpu_time );
+            rec.add( "magma_time", mt_time );
+            rec.add( "error", error );
+            rec.add( "error_orth", error_orth );
+            rec.add( "eig_diff", diff );
+            rec.write( iter, okay );
+            printf( "%5lld   %9.4f           %9.4f          %6.2f    %8.2e                %8.2e          %8.2e   %s\n",
+                    (long long) N, cpu_time, mt_time, cpu_time / mt_time,
+                    error, error_orth, diff, (okay ? "ok" : "failed") );
+
+            magma_free_cpu( h_A );
+            magma_free_cpu( h_H );
+            magma_free_cpu( h_T );
+            magma_free_cpu( h_Q );
+            magma_free_cpu( h_Z );
+            magma_free_cpu( h_R );
+            magma_free_cpu( tau );
+            magma_free_cpu( hwork );
+            #ifdef COMPLEX
+            magma_free_cpu( w_lapack );
+            magma_free_cpu( w_mt );
+            #else
+            magma_free_cpu( wr_lapack );
+            magma_free_cpu( wi_lapack );
+            magma_free_cpu( wr_mt );
+            magma_free_cpu( wi_mt );
+            #endif
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
@@ -0,0 +1,326 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <algorithm>  // std::swap
+
+// includes, project
+#include "flops.h"
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+
+/******************************************************************************/
+// Sets V to random reflectors, as in LAPACK larfb, with the unit diagonal and
+// zeros stored explicitly, and tau(i) = 2 / |v_i|^2, so each H(i) is unitary.
+// V is nq-by-k if columnwise, k-by-nq if rowwise.
+static void init_reflectors(
+    magma_direct_t direct, magma_storev_t storev,
+    magma_int_t nq, magma_int_t k,
+    magmaDoubleComplex *V, magma_int_t ldv, magmaDoubleComplex *tau,
+    magma_int_t *iseed )
+{
+    const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    const magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    magma_int_t ione = 1;
+    magma_int_t mv = (storev == MagmaColumnwise ? nq : k);
+    magma_int_t nv = (storev == MagmaColumnwise ? k  : nq);
+    magma_int_t size = ldv*nv;
+    lapackf77_zlarnv( &ione, iseed, &size, V );
+    if ( storev == MagmaColumnwise ) {
+        if ( direct == MagmaForward )
+            lapackf77_zlaset( MagmaUpperStr, &k, &k, &c_zero, &c_one, V, &ldv );
+        else
+            lapackf77_zlaset( MagmaLowerStr, &k, &k, &c_zero, &c_one, &V[mv-k], &ldv );
+    }
+    else {
+        if ( direct == MagmaForward )
+            lapackf77_zlaset( MagmaLowerStr, &k, &k, &c_zero, &c_one, V, &ldv );
+        else
+            lapackf77_zlaset( MagmaUpperStr, &k, &k, &c_zero, &c_one, &V[(nv-k)*ldv], &ldv );
+    }
+    for( magma_int_t i = 0; i < k; ++i ) {
+        double vnorm = (storev == MagmaColumnwise
+                        ? magma_cblas_dznrm2( nq, &V[i*ldv], 1 )
+                        : magma_cblas_dznrm2( nq, &V[i], ldv ));
+        tau[i] = MAGMA_Z_MAKE( 2. / (vnorm*vnorm), 0. );
+    }
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing zlarfb_cpu
+   For each side, trans, direct, and storev, applies a block of K random
+   Householder reflectors to an M-by-N matrix C.
+   --version 1 (default): with LAPACK zlarft and zlarfb, and with
+   magma_zlarft_cpu and magma_zlarfb_cpu. Checks
+       |T - T_lapack|_F / |T_lapack|_F  and  |HC - HC_lapack|_F / |HC_lapack|_F.
+   --version 2: with LAPACK zlarfb in a loop, and with magma_zlarfb_cpu_vbatched,
+   on --batch problems of random sizes up to M-by-N-by-K. Checks
+       max_i |H_i C_i - H_i C_i lapack|_F / |H_i C_i lapack|_F.
+*/
+int main( int argc, char** argv )
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    // constants
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    const magma_int_t ione = 1;
+
+    // local variables
+    real_Double_t gflops, cpu_perf, cpu_time, magma_perf, magma_time;
+    magma_int_t M, N, K, nq, size, ldc, ldv, ldt, ldw, nv, lwork, info;
+    magma_int_t ISEED[4] = {0,0,0,1};
+    double Cnorm, error, error_t, work[1];
+    int status = 0;
+
+    // test all combinations of input parameters
+    magma_side_t   side  [] = { MagmaLeft,       MagmaRight    };
+    magma_trans_t  trans [] = { Magma_ConjTrans, MagmaNoTrans  };
+    magma_direct_t direct[] = { MagmaForward,    MagmaBackward };
+    magma_storev_t storev[] = { MagmaColumnwise, MagmaRowwise  };
+
+    magma_opts opts;
+    opts.parse_opts( argc, argv );
+    magma_bench_record rec( opts, "zlarfb_cpu" );
+
+    double tol = opts.tolerance * lapackf77_dlamch("E");
+    magma_int_t batchCount = (opts.version == 2 ? opts.batchcount : 1);
+
+    if ( opts.version == 2 ) {
+        printf( "%% batchCount = %lld, sizes random up to M, N, K\n", (long long) batchCount );
+    }
+    printf( "%%   M     N     K   side   trans   direct   storev   LAPACK Gflop/s (sec)   MAGMA Gflop/s (sec)   |T - T_lapack|   |HC - HC_lapack|\n" );
+    printf( "%%===================================================================================================================================\n" );
+    for (int itest = 0; itest < opts.ntest; ++itest) {
+      M = opts.msize[itest];
+      N = opts.nsize[itest];
+      K = opts.ksize[itest];
+      for (int iside = 0; iside < 2; ++iside) {
+      for (int itran = 0; itran < 2; ++itran) {
+      for (int idir  = 0; idir  < 2; ++idir ) {
+      for (int istor = 0; istor < 2; ++istor) {
+        for (int iter = 0; iter < opts.niter; ++iter) {
+            if ((side[iside] == MagmaLeft  && M < K) ||
+                (side[iside] == MagmaRight && N < K))
+            {
+                printf( "%5lld %5lld %5lld   %4c   skipping because zlarfb requires M >= K (left) or N >= K (right)\n",
+                        (long long) M, (long long) N, (long long) K,
+                        lapacke_side_const(side[iside]) );
+                continue;
+            }
+
+            // Allocate memory for batchCount problems; sizes of each problem
+            magmaDoubleComplex **V_array, **T_array, **C_array, **R_array, *tau, *W;
+            magma_int_t *m, *n, *k, *ldv_array, *ldt_array, *ldc_array;
+            TESTING_CHECK( magma_malloc_cpu( (void**) &V_array, batchCount*sizeof(magmaDoubleComplex*) ));
+            TESTING_CHECK( magma_malloc_cpu( (void**) &T_array, batchCount*sizeof(magmaDoubleComplex*) ));
+            TESTING_CHECK( magma_malloc_cpu( (void**) &C_array, batchCount*sizeof(magmaDoubleComplex*) ));
+            TESTING_CHECK( magma_malloc_cpu( (void**) &R_array, batchCount*sizeof(magmaDoubleComplex*) ));
+            TESTING_CHECK( magma_imalloc_cpu( &m, batchCount ));
+            TESTING_CHECK( magma_imalloc_cpu( &n, batchCount ));
+            TESTING_CHECK( magma_imalloc_cpu( &k, batchCount ));
+            TESTING_CHECK( magma_imalloc_cpu( &ldv_array, batchCount ));
+            TESTING_CHECK( magma_imalloc_cpu( &ldt_array, batchCount ));
+            TESTING_CHECK( magma_imalloc_cpu( &ldc_array, batchCount ));
+            TESTING_CHECK( magma_zmalloc_cpu( &tau, max( 1, K ) ));
+
+            gflops  = 0;
+            error_t = 0;
+            for (magma_int_t i = 0; i < batchCount; ++i) {
+                if ( opts.version == 2 ) {
+                    double r[3];
+                    magma_int_t three = 3, idist = 1;
+                    lapackf77_dlarnv( &idist, ISEED, &three, r );
+                    m[i] = 1 + magma_int_t( r[0] * M );
+                    n[i] = 1 + magma_int_t( r[1] * N );
+                    m[i] = min( m[i], M );
+                    n[i] = min( n[i], N );
+                    nq   = (side[iside] == MagmaLeft ? m[i] : n[i]);
+                    k[i] = min( nq, min( K, magma_int_t( r[2] * (K + 1) )));
+                }
+                else {
+                    m[i] = M;
+                    n[i] = N;
+                    k[i] = K;
+                }
+                nq  = (side[iside] == MagmaLeft ? m[i] : n[i]);
+                ldc = max( 1, m[i] );
+                ldt = max( 1, k[i] );
+                // (ldv, nv) get swapped if rowwise
+                ldv = max( 1, nq );
+                nv  = k[i];
+                if ( storev[istor] == MagmaRowwise ) {
+                    ldv = max( 1, k[i] );
+                    nv  = nq;
+                }
+                ldv_array[i] = ldv;
+                ldt_array[i] = ldt;
+                ldc_array[i] = ldc;
+                gflops += FLOPS_ZUNMQR( m[i], n[i], k[i], side[iside] ) / 1e9;
+
+                TESTING_CHECK( magma_zmalloc_cpu( &V_array[i], ldv*nv ));
+                TESTING_CHECK( magma_zmalloc_cpu( &T_array[i], ldt*k[i] ));
+                TESTING_CHECK( magma_zmalloc_cpu( &C_array[i], ldc*n[i] ));
+                TESTING_CHECK( magma_zmalloc_cpu( &R_array[i], ldc*n[i] ));
+
+                init_reflectors( direct[idir], storev[istor], nq, k[i],
+                                 V_array[i], ldv, tau, ISEED );
+                size = ldc*n[i];
+                lapackf77_zlarnv( &ione, ISEED, &size, C_array[i] );
+                lapackf77_zlacpy( MagmaFullStr, &m[i], &n[i], C_array[i], &ldc, R_array[i], &ldc );
+
+                // T from LAPACK, and check magma_zlarft_cpu against it
+                lapackf77_zlarft( lapack_direct_const( direct[idir] ), lapack_storev_const( storev[istor] ),
+                                  &nq, &k[i], V_array[i], &ldv, tau, T_array[i], &ldt );
+                if ( opts.version == 1 && k[i] > 0 ) {
+                    magmaDoubleComplex *T2;
+                    TESTING_CHECK( magma_zmalloc_cpu( &T2, ldt*k[i] ));
+                    lapackf77_zlacpy( MagmaFullStr, &k[i], &k[i], T_array[i], &ldt, T2, &ldt );
+                    magma_zlarft_cpu( direct[idir], storev[istor], nq, k[i],
+                                      V_array[i], ldv, tau, T2, ldt, &info );
+                    if (info != 0) {
+                        printf("magma_zlarft_cpu returned error %lld: %s.\n",
+                               (long long) info, magma_strerror( info ));
+                    }
+                    const char *tri = (direct[idir] == MagmaForward ? MagmaUpperStr : MagmaLowerStr);
+                    Cnorm   = lapackf77_zlantr( "F", tri, MagmaNonUnitStr, &k[i], &k[i], T_array[i], &ldt, work );
+                    size    = ldt*k[i];
+                    blasf77_zaxpy( &size, &c_neg_one, T_array[i], &ione, T2, &ione );
+                    error_t = lapackf77_zlantr( "F", tri, MagmaNonUnitStr, &k[i], &k[i], T2, &ldt, work ) / Cnorm;
+                    magma_free_cpu( T2 );
+                }
+            }
+
+            /* =====================================================================
+               Performs operation using LAPACK
+               =================================================================== */
+            lwork = 1;
+            for (magma_int_t i = 0; i < batchCount; ++i) {
+                lwork = max( lwork, k[i] * (side[iside] == MagmaLeft ? n[i] : m[i]) );
+            }
+            TESTING_CHECK( magma_zmalloc_cpu( &W, lwork ));
+
+            cpu_time = magma_wtime();
+            for (magma_int_t i = 0; i < batchCount; ++i) {
+                ldw = max( 1, (side[iside] == MagmaLeft ? n[i] : m[i]) );
+                lapackf77_zlarfb( lapack_side_const( side[iside] ), lapack_trans_const( trans[itran] ),
+                                  lapack_direct_const( direct[idir] ), lapack_storev_const( storev[istor] ),
+                                  &m[i], &n[i], &k[i],
+                                  V_array[i], &ldv_array[i], T_array[i], &ldt_array[i],
+                                  R_array[i], &ldc_array[i], W, &ldw );
+            }
+            cpu_time = magma_wtime() - cpu_time;
+            cpu_perf = gflops / cpu_time;
+            magma_free_cpu( W );
+
+            /* =====================================================================
+               Performs operation using MAGMA
+               =================================================================== */
+            if ( opts.version == 1 ) {
+                magmaDoubleComplex query;
+                magma_zlarfb_cpu( side[iside], trans[itran], direct[idir], storev[istor],
+                                  M, N, K, V_array[0], ldv_array[0], T_array[0], ldt_array[0],
+                                  C_array[0], ldc_array[0], &query, -1, &info );
+                lwork = magma_int_t( MAGMA_Z_REAL( query ));
+                TESTING_CHECK( magma_zmalloc_cpu( &W, lwork ));
+
+                magma_time = magma_wtime();
+                magma_zlarfb_cpu( side[iside], trans[itran], direct[idir], storev[istor],
+                                  M, N, K, V_array[0], ldv_array[0], T_array[0], ldt_array[0],
+                                  C_array[0], ldc_array[0], W, lwork, &info );
+                magma_time = magma_wtime() - magma_time;
+                magma_free_cpu( W );
+            }
+            else {
+                magma_time = magma_wtime();
+                magma_zlarfb_cpu_vbatched( side[iside], trans[itran], direct[idir], storev[istor],
+                                           m, n, k, V_array, ldv_array, T_array, ldt_array,
+                                           C_array, ldc_array, batchCount, &info );
+                magma_time = magma_wtime() - magma_time;
+            }
+            magma_perf = gflops / magma_time;
+            if (info != 0) {
+                printf("magma_zlarfb_cpu returned error %lld: %s.\n",
+                       (long long) info, magma_strerror( info ));
+            }
+
+            /* =====================================================================
+               Check the result
+               =================================================================== */
+            // relative error |HC_magma - HC_lapack| / |HC_lapack|
+            error = 0;
+            for (magma_int_t i = 0; i < batchCount; ++i) {
+                size  = ldc_array[i]*n[i];
+                Cnorm = lapackf77_zlange( "F", &m[i], &n[i], R_array[i], &ldc_array[i], work );
+                blasf77_zaxpy( &size, &c_neg_one, R_array[i], &ione, C_array[i], &ione );
+                error = max( error, lapackf77_zlange( "F", &m[i], &n[i], C_array[i], &ldc_array[i], work )
+                                    / max( Cnorm, 1. ));
+            }
+
+            bool okay = (info == 0 && error < tol && error_t < tol);
+            status += ! okay;
+            rec.add( "m", M );
+            rec.add( "n", N );
+            rec.add( "k", K );
+            rec.add( "side",   lapack_side_const( side[iside] ));
+            rec.add( "trans",  lapack_trans_const( trans[itran] ));
+            rec.add( "direct", lapack_direct_const( direct[idir] ));
+            rec.add( "storev", lapack_storev_const( storev[istor] ));
+            rec.add( "cpu_time", cpu_time );
+            rec.add( "magma_time", magma_time );
+            rec.add( "error", error );
+            rec.add( "error_t", error_t );
+            rec.write( iter, okay );
+            printf( "%5lld %5lld %5lld   %4c   %5c   %6c   %6c   %7.2f (%7.4f)      %7.2f (%7.4f)       %8.2e         %8.2e     %s\n",
+                    (long long) M, (long long) N, (long long) K,
+                    lapacke_side_const(side[iside]),
+                    lapacke_trans_const(trans[itran]),
+                    lapacke_direct_const(direct[idir]),
+                    lapacke_storev_const(storev[istor]),
+                    cpu_perf, cpu_time, magma_perf, magma_time,
+                    error_t, error, (okay ? "ok" : "failed") );
+
+            for (magma_int_t i = 0; i < batchCount; ++i) {
+                magma_free_cpu( V_array[i] );
+                magma_free_cpu( T_array[i] );
+                magma_free_cpu( C_array[i] );
+                magma_free_cpu( R_array[i] );
+            }
+            magma_free_cpu( V_array );
+            magma_free_cpu( T_array );
+            magma_free_cpu( C_array );
+            magma_free_cpu( R_array );
+            magma_free_cpu( m );
+            magma_free_cpu( n );
+            magma_free_cpu( k );
+            magma_free_cpu( ldv_array );
+            magma_free_cpu( ldt_array );
+            magma_free_cpu( ldc_array );
+            magma_free_cpu( tau );
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+      }}}}
+      printf( "\n" );
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
@@ -0,0 +1,251 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "flops.h"
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing out-of-core factorizations
+   Factors a random M-by-N matrix in host memory with LAPACK (in-core), and
+   stored out-of-core in a temporary file, with
+   --version 1 (default): magma_zpotrf_ooc_cpu (-L or -U, N-by-N, HPD matrix),
+   --version 2:           magma_zgetrf_ooc_cpu,
+   --version 3:           magma_zgeqrf_ooc_cpu.
+   The tile size is --nb (default 256); the look-ahead window is one tile
+   column. The memory budget is --fraction f (default 0.25) times the matrix
+   size, but at least the minimum each driver needs.
+   Reports the Gflop/s of both, the ratio, the bytes read and written per
+   flop, and the time spent waiting for tiles. Checks
+       potrf: |A - L L^H| / (N |A|) or |A - U^H U| / (N |A|),
+       getrf: |PA - LU| / (N |A|),
+       geqrf: |R - Q^H A| / (N |A|).
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_zero    = MAGMA_Z_ZERO;
+
+    real_Double_t   gflops, cpu_perf, cpu_time, ooc_perf, ooc_time;
+    real_Double_t   bytes_read, bytes_written, wait_time;
+    double          Anorm, error, work[1];
+    magmaDoubleComplex *h_A, *h_R, *h_F, *tau, *h_work, tmp[1];
+    magma_int_t *ipiv;
+    magma_int_t M, N, nb, lda, n2, min_mn, lwork, info, j;
+    magma_int_t ione = 1;
+    magma_ooc_t dA;
+    size_t budget, budget_min;
+    int status = 0;
+
+    magma_opts opts;
+    opts.parse_opts( argc, argv );
+    magma_bench_record rec( opts, "zooc_cpu" );
+
+    double tol = opts.tolerance * lapackf77_dlamch("E");
+    double fraction = (opts.fraction_up < 1 ? opts.fraction_up : 0.25);
+    const char* names[] = { "", "potrf", "getrf", "geqrf" };
+    int version = (opts.version <= 3 ? opts.version : 1);
+
+    printf( "%% %s", names[ version ] );
+    if ( version == 1 ) {
+        printf( ", uplo = %s", lapack_uplo_const( opts.uplo ));
+    }
+    printf( ", budget = %.2f of matrix\n", fraction );
+    printf( "%%   M     N    NB   budget (MB)   in-core Gflop/s (sec)   OOC Gflop/s (sec)   ratio   I/O (GB)   bytes/flop   wait (sec)   error\n" );
+    printf( "%%==================================================================================================================================\n" );
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            M = opts.msize[itest];
+            N = opts.nsize[itest];
+            if ( version == 1 ) {
+                M = N;
+            }
+            nb     = (opts.nb > 0 ? opts.nb : 256);
+            min_mn = min( M, N );
+            lda    = max( 1, M );
+            n2     = lda*N;
+            if ( version == 1 ) {
+                gflops     = FLOPS_ZPOTRF( N ) / 1e9;
+                budget_min = 2*size_t(N)*nb;
+            }
+            else if ( version == 2 ) {
+                gflops     = FLOPS_ZGETRF( M, N ) / 1e9;
+                budget_min = size_t(M)*(min( nb, N ) + nb);
+            }
+            else {
+                gflops     = FLOPS_ZGEQRF( M, N ) / 1e9;
+                budget_min = size_t(M)*(min( nb, N ) + nb);
+            }
+            budget = max( budget_min, size_t( fraction * n2 )) * sizeof(magmaDoubleComplex);
+
+            lwork = -1;
+            lapackf77_zgeqrf( &M, &N, NULL, &lda, NULL, tmp, &lwork, &info );
+            lwork = max( N*N, magma_int_t( MAGMA_Z_REAL( tmp[0] )));
+
+            TESTING_CHECK( magma_zmalloc_cpu( &h_A,    n2      ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_R,    n2      ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_F,    n2      ));
+            TESTING_CHECK( magma_zmalloc_cpu( &tau,    min_mn  ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_work, lwork   ));
+            TESTING_CHECK( magma_imalloc_cpu( &ipiv,   min_mn  ));
+
+            /* Initialize the matrix */
+            magma_generate_matrix( opts, M, N, h_A, lda );
+            if ( version == 1 ) {
+                magma_zmake_hpd( N, h_A, lda );
+            }
+            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda );
+            Anorm = lapackf77_zlange( "F", &M, &N, h_A, &lda, work );
+
+            /* =====================================================================
+               Performs operation using LAPACK, in-core
+               =================================================================== */
+            cpu_time = magma_wtime();
+            if ( version == 1 ) {
+                lapackf77_zpotrf( lapack_uplo_const( opts.uplo ), &N, h_R, &lda, &info );
+            }
+            else if ( version == 2 ) {
+                lapackf77_zgetrf( &M, &N, h_R, &lda, ipiv, &info );
+            }
+            else {
+                lapackf77_zgeqrf( &M, &N, h_R, &lda, tau, h_work, &lwork, &info );
+            }
+            cpu_time = magma_wtime() - cpu_time;
+            cpu_perf = gflops / cpu_time;
+            if (info != 0) {
+                printf("lapackf77_z%s returned error %lld: %s.\n",
+                       names[ version ], (long long) info, magma_strerror( info ));
+            }
+
+            /* =====================================================================
+               Performs operation using MAGMA, out-of-core
+               =================================================================== */
+            TESTING_CHECK( magma_ooc_create( M, N, nb, sizeof(magmaDoubleComplex),
+                                             magma_ceildiv( M, nb ), NULL, &dA ));
+            TESTING_CHECK( magma_ooc_setmatrix( M, N, h_A, lda, dA, 0, 0 ));
+            TESTING_CHECK( magma_ooc_flush( dA ));
+            magma_ooc_reset_stats( dA );
+
+            ooc_time = magma_wtime();
+            if ( version == 1 ) {
+                magma_zpotrf_ooc_cpu( opts.uplo, dA, budget, &info );
+            }
+            else if ( version == 2 ) {
+                magma_zgetrf_ooc_cpu( dA, ipiv, budget, &info );
+            }
+            else {
+                magma_zgeqrf_ooc_cpu( dA, tau, budget, &info );
+            }
+            ooc_time = magma_wtime() - ooc_time;
+            ooc_perf = gflops / ooc_time;
+            if (info != 0) {
+                printf("magma_z%s_ooc_cpu returned error %lld: %s.\n",
+                       names[ version ], (long long) info, magma_strerror( info ));
+            }
+            magma_ooc_get_stats( dA, &bytes_read, &bytes_written, &wait_time );
+            TESTING_CHECK( magma_ooc_getmatrix( M, N, dA, 0, 0, h_F, lda ));
+            TESTING_CHECK( magma_ooc_destroy( dA ));
+
+            /* =====================================================================
+               Check the result
+               =================================================================== */
+            if ( version == 1 ) {
+                // h_R = L L^H or U^H U, from the factor in h_F
+                lapackf77_zlacpy( MagmaFullStr, &N, &N, h_F, &lda, h_R, &lda );
+                if ( opts.uplo == MagmaLower ) {
+                    lapackf77_zlaset( MagmaUpperStr, &N, &N, &c_zero, &c_zero, h_R, &lda );
+                    lapackf77_zlaset( MagmaUpperStr, &N, &N, &c_zero, &c_zero, h_F, &lda );
+                    blasf77_ztrmm( MagmaRightStr, MagmaLowerStr, MagmaConjTransStr, MagmaNonUnitStr,
+                                   &N, &N, &c_one, h_F, &lda, h_R, &lda );
+                }
+                else {
+                    lapackf77_zlaset( MagmaLowerStr, &N, &N, &c_zero, &c_zero, h_R, &lda );
+                    lapackf77_zlaset( MagmaLowerStr, &N, &N, &c_zero, &c_zero, h_F, &lda );
+                    blasf77_ztrmm( MagmaLeftStr, MagmaUpperStr, MagmaConjTransStr, MagmaNonUnitStr,
+                                   &N, &N, &c_one, h_F, &lda, h_R, &lda );
+                }
+            }
+            else if ( version == 2 ) {
+                // h_R = L U, from the factors in h_F; h_A = P A
+                magma_int_t ldl = lda;
+                lapackf77_zlaswp( &N, h_A, &lda, &ione, &min_mn, ipiv, &ione );
+                lapackf77_zlacpy( MagmaUpperStr, &min_mn, &N, h_F, &lda, h_work, &min_mn );
+                lapackf77_zlaset( MagmaLowerStr, &min_mn, &N, &c_zero, &c_zero, h_work, &min_mn );
+                lapackf77_zlaset( MagmaUpperStr, &min_mn, &min_mn, &c_zero, &c_one, h_F, &ldl );
+                blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &M, &N, &min_mn,
+                               &c_one,  h_F,    &ldl,
+                                        h_work, &min_mn,
+                               &c_zero, h_R,    &lda );
+            }
+            else {
+                // h_R = Q R, with Q from zungqr and R from h_F
+                lapackf77_zlacpy( MagmaFullStr, &M, &N, h_F, &lda, h_R, &lda );
+                lapackf77_zungqr( &M, &min_mn, &min_mn, h_F, &lda, tau, h_work, &lwork, &info );
+                lapackf77_zlaset( MagmaLowerStr, &min_mn, &N, &c_zero, &c_zero, h_R, &lda );
+                lapackf77_zlacpy( MagmaFullStr, &min_mn, &N, h_R, &lda, h_work, &min_mn );
+                blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &M, &N, &min_mn,
+                               &c_one,  h_F,    &lda,
+                                        h_work, &min_mn,
+                               &c_zero, h_R,    &lda );
+            }
+            for( j = 0; j < N; ++j ) {
+                blasf77_zaxpy( &M, &c_neg_one, &h_A[j*lda], &ione, &h_R[j*lda], &ione );
+            }
+            error = lapackf77_zlange( "F", &M, &N, h_R, &lda, work ) / (N * Anorm);
+
+            bool okay = (info == 0 && error < tol);
+            status += ! okay;
+            rec.add( "m", M );
+            rec.add( "n", N );
+            rec.add( "nb", nb );
+            rec.add( "budget", double(budget) );
+            rec.add( "cpu_time", cpu_time );
+            rec.add( "magma_time", ooc_time );
+            rec.add( "bytes_read", bytes_read );
+            rec.add( "bytes_written", bytes_written );
+            rec.add( "wait_time", wait_time );
+            rec.add( "error", error );
+            rec.write( iter, okay );
+            printf( "%5lld %5lld %5lld   %9.1f      %7.2f (%7.2f)       %7.2f (%7.2f)    %5.2f   %8.3f     %8.2e     %7.3f    %8.2e   %s\n",
+                    (long long) M, (long long) N, (long long) nb, budget / 1e6,
+                    cpu_perf, cpu_time, ooc_perf, ooc_time, ooc_perf / cpu_perf,
+                    (bytes_read + bytes_written) / 1e9,
+                    (bytes_read + bytes_written) / (gflops * 1e9),
+                    wait_time, error, (okay ? "ok" : "failed") );
+
+            magma_free_cpu( h_A    );
+            magma_free_cpu( h_R    );
+            magma_free_cpu( h_F    );
+            magma_free_cpu( tau    );
+            magma_free_cpu( h_work );
+            magma_free_cpu( ipiv   );
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
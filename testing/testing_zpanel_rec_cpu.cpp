@@ -0,0 +1,253 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "flops.h"
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+
+/******************************************************************************/
+// Returns |F - G|_F / (n |G|_F) for the m-by-n matrices F and G, where G is
+// LAPACK's result, restricted to the uplo triangle unless uplo is "General".
+static double get_diff(
+    const char* uplo, magma_int_t m, magma_int_t n,
+    const magmaDoubleComplex *F, const magmaDoubleComplex *G, magma_int_t ld )
+{
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    const magma_int_t ione = 1;
+    magma_int_t mn = ld*n;
+    double work[1], norm_d, norm_g;
+
+    magmaDoubleComplex *D;
+    TESTING_CHECK( magma_zmalloc_cpu( &D, mn ));
+    blasf77_zcopy( &mn, F, &ione, D, &ione );
+    blasf77_zaxpy( &mn, &c_neg_one, G, &ione, D, &ione );
+    if (uplo[0] == 'G') {
+        norm_d = lapackf77_zlange( "Fro", &m, &n, D, &ld, work );
+        norm_g = lapackf77_zlange( "Fro", &m, &n, G, &ld, work );
+    }
+    else {
+        norm_d = lapackf77_zlantr( "Fro", uplo, MagmaNonUnitStr, &m, &n, D, &ld, work );
+        norm_g = lapackf77_zlantr( "Fro", uplo, MagmaNonUnitStr, &m, &n, G, &ld, work );
+    }
+    magma_free_cpu( D );
+    return (norm_g == 0 ? norm_d : norm_d / (n * norm_g));
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing zgetrf_rec_cpu, zgeqrf_rec_cpu, zpotrf_rec_cpu
+   Compares the recursive, multithreaded CPU panel factorizations with
+   LAPACK zgetrf, zgeqrf + zlarft, and zpotrf, for the tall and skinny
+   M-by-N panels of the hybrid factorizations (Cholesky uses the N-by-N
+   block). The error is the difference from LAPACK's factors,
+   |F - F_lapack| / (N |F_lapack|).
+   --nthread sets the size of the recursive versions' thread team.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    real_Double_t   gflops, rec_perf, rec_time, cpu_perf, cpu_time;
+    double          error, error_t;
+    magmaDoubleComplex *h_A, *h_L, *h_R, *tau, *tau_rec, *T, *T_rec, *work, temp;
+    magma_int_t     *ipiv, *ipiv_rec;
+    magma_int_t     M, N, lda, ldt, n2, lwork, info, info_rec;
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    magma_int_t     ione = 1;
+    magma_int_t     ISEED[4] = {0,0,0,1};
+    int status = 0;
+
+    magma_opts opts;
+    opts.parse_opts( argc, argv );
+    magma_bench_record rec( opts, "zpanel_rec_cpu" );
+
+    double tol = opts.tolerance * lapackf77_dlamch("E");
+    magma_int_t nthread = opts.nthread;
+
+    printf( "%% nthread = %lld\n", (long long) nthread );
+    printf( "%%   M     N   routine   LAPACK Gflop/s (sec)   Recursive Gflop/s (sec)   |F - F_lapack| / (N |F_lapack|)\n" );
+    printf( "%%=============================================================================================================\n" );
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            M   = opts.msize[itest];
+            N   = opts.nsize[itest];
+            if ( M < N ) {
+                printf( "%5lld %5lld   skipping because M < N is not supported.\n",
+                        (long long) M, (long long) N );
+                continue;
+            }
+            lda = M;
+            ldt = N;
+            n2  = lda*N;
+
+            TESTING_CHECK( magma_zmalloc_cpu( &h_A,     n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_L,     n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_R,     n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &tau,     N  ));
+            TESTING_CHECK( magma_zmalloc_cpu( &tau_rec, N  ));
+            TESTING_CHECK( magma_zmalloc_cpu( &T,       N*N ));
+            TESTING_CHECK( magma_zmalloc_cpu( &T_rec,   N*N ));
+            TESTING_CHECK( magma_imalloc_cpu( &ipiv,     N ));
+            TESTING_CHECK( magma_imalloc_cpu( &ipiv_rec, N ));
+
+            lapackf77_zlarnv( &ione, ISEED, &n2, h_A );
+            lapackf77_zlaset( MagmaFullStr, &N, &N, &c_zero, &c_zero, T,     &ldt );
+            lapackf77_zlaset( MagmaFullStr, &N, &N, &c_zero, &c_zero, T_rec, &ldt );
+
+            /* =====================================================================
+               LU with partial pivoting
+               =================================================================== */
+            gflops = FLOPS_ZGETRF( M, N ) / 1e9;
+            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_L, &lda );
+            cpu_time = magma_wtime();
+            lapackf77_zgetrf( &M, &N, h_L, &lda, ipiv, &info );
+            cpu_time = magma_wtime() - cpu_time;
+            cpu_perf = gflops / cpu_time;
+
+            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda );
+            rec_time = magma_wtime();
+            magma_zgetrf_rec_cpu( M, N, h_R, lda, ipiv_rec, nthread, &info_rec );
+            rec_time = magma_wtime() - rec_time;
+            rec_perf = gflops / rec_time;
+            if (info_rec != info) {
+                printf("magma_zgetrf_rec_cpu returned info %lld, LAPACK %lld.\n",
+                       (long long) info_rec, (long long) info );
+            }
+
+            error = get_diff( "General", M, N, h_R, h_L, lda );
+            bool okay = (error < tol && info_rec == info);
+            for (magma_int_t i = 0; i < N; ++i) {
+                okay = okay && (ipiv[i] == ipiv_rec[i]);
+            }
+            status += ! okay;
+            rec.add( "m", M );
+            rec.add( "n", N );
+            rec.add( "routine", "getrf" );
+            rec.add( "nthread", nthread );
+            rec.perf( "cpu", cpu_perf, cpu_time );
+            rec.perf( "magma", rec_perf, rec_time );
+            rec.add( "error", error );
+            rec.write( iter, okay );
+            printf( "%5lld %5lld   getrf      %7.2f (%7.4f)         %7.2f (%7.4f)          %8.2e   %s\n",
+                    (long long) M, (long long) N, cpu_perf, cpu_time, rec_perf, rec_time,
+                    error, (okay ? "ok" : "failed") );
+
+            /* =====================================================================
+               QR with the T factor; error is the larger of the errors in
+               V and R, and in T
+               =================================================================== */
+            gflops = FLOPS_ZGEQRF( M, N ) / 1e9;
+            lwork = -1;
+            lapackf77_zgeqrf( &M, &N, h_L, &lda, tau, &temp, &lwork, &info );
+            lwork = max( 1, (magma_int_t) MAGMA_Z_REAL( temp ));
+            TESTING_CHECK( magma_zmalloc_cpu( &work, lwork ));
+
+            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_L, &lda );
+            cpu_time = magma_wtime();
+            lapackf77_zgeqrf( &M, &N, h_L, &lda, tau, work, &lwork, &info );
+            lapackf77_zlarft( MagmaForwardStr, MagmaColumnwiseStr,
+                              &M, &N, h_L, &lda, tau, T, &ldt );
+            cpu_time = magma_wtime() - cpu_time;
+            cpu_perf = gflops / cpu_time;
+            magma_free_cpu( work );
+
+            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda );
+            rec_time = magma_wtime();
+            magma_zgeqrf_rec_cpu( M, N, h_R, lda, tau_rec, T_rec, ldt, nthread, &info_rec );
+            rec_time = magma_wtime() - rec_time;
+            rec_perf = gflops / rec_time;
+            if (info_rec != 0) {
+                printf("magma_zgeqrf_rec_cpu returned error %lld: %s.\n",
+                       (long long) info_rec, magma_strerror( info_rec ));
+            }
+
+            error   = get_diff( "General", M, N, h_R, h_L, lda );
+            error_t = get_diff( "Upper", N, N, T_rec, T, ldt );
+            error   = max( error, error_t );
+            okay = (error < tol && info_rec == 0);
+            status += ! okay;
+            rec.add( "m", M );
+            rec.add( "n", N );
+            rec.add( "routine", "geqrf" );
+            rec.add( "nthread", nthread );
+            rec.perf( "cpu", cpu_perf, cpu_time );
+            rec.perf( "magma", rec_perf, rec_time );
+            rec.add( "error", error );
+            rec.write( iter, okay );
+            printf( "%5lld %5lld   geqrf      %7.2f (%7.4f)         %7.2f (%7.4f)          %8.2e   %s\n",
+                    (long long) M, (long long) N, cpu_perf, cpu_time, rec_perf, rec_time,
+                    error, (okay ? "ok" : "failed") );
+
+            /* =====================================================================
+               Cholesky of the N-by-N block
+               =================================================================== */
+            gflops = FLOPS_ZPOTRF( N ) / 1e9;
+            magma_zmake_hpd( N, h_A, lda );
+            lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_L, &lda );
+            cpu_time = magma_wtime();
+            lapackf77_zpotrf( lapack_uplo_const(opts.uplo), &N, h_L, &lda, &info );
+            cpu_time = magma_wtime() - cpu_time;
+            cpu_perf = gflops / cpu_time;
+
+            lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_R, &lda );
+            rec_time = magma_wtime();
+            magma_zpotrf_rec_cpu( opts.uplo, N, h_R, lda, nthread, &info_rec );
+            rec_time = magma_wtime() - rec_time;
+            rec_perf = gflops / rec_time;
+            if (info_rec != info) {
+                printf("magma_zpotrf_rec_cpu returned info %lld, LAPACK %lld.\n",
+                       (long long) info_rec, (long long) info );
+            }
+
+            error = get_diff( lapack_uplo_const(opts.uplo), N, N, h_R, h_L, lda );
+            okay = (error < tol && info_rec == info);
+            status += ! okay;
+            rec.add( "m", N );
+            rec.add( "n", N );
+            rec.add( "routine", "potrf" );
+            rec.add( "uplo", lapack_uplo_const(opts.uplo) );
+            rec.add( "nthread", nthread );
+            rec.perf( "cpu", cpu_perf, cpu_time );
+            rec.perf( "magma", rec_perf, rec_time );
+            rec.add( "error", error );
+            rec.write( iter, okay );
+            printf( "%5lld %5lld   potrf      %7.2f (%7.4f)         %7.2f (%7.4f)          %8.2e   %s\n",
+                    (long long) N, (long long) N, cpu_perf, cpu_time, rec_perf, rec_time,
+                    error, (okay ? "ok" : "failed") );
+
+            magma_free_cpu( h_A );
+            magma_free_cpu( h_L );
+            magma_free_cpu( h_R );
+            magma_free_cpu( tau );
+            magma_free_cpu( tau_rec );
+            magma_free_cpu( T );
+            magma_free_cpu( T_rec );
+            magma_free_cpu( ipiv );
+            magma_free_cpu( ipiv_rec );
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
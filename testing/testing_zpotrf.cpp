@@ -42,6 +42,7 @@ int main( int argc, char** argv)
     opts.matrix = "rand_dominant";  // default
     opts.parse_opts( argc, argv );
     opts.lapack |= opts.check;  // check (-c) implies lapack (-l)
+    magma_bench_record rec( opts, "zpotrf" );
     
     double tol = opts.tolerance * lapackf77_dlamch("E");
     
@@ -78,6 +79,12 @@ int main( int argc, char** argv)
                        (long long) info, magma_strerror( info ));
             }
             
+            rec.add( "n", N );
+            rec.add( "uplo", lapack_uplo_const(opts.uplo) );
+            rec.add( "ngpu", opts.ngpu );
+            rec.perf( "magma", gpu_perf, gpu_time );
+            bool okay = true;
+            
             if ( opts.lapack ) {
                 /* =====================================================================
                    Performs operation using LAPACK
@@ -101,12 +108,16 @@ int main( int argc, char** argv)
                 printf("%5lld   %7.2f (%7.2f)   %7.2f (%7.2f)   %8.2e   %s\n",
                        (long long) N, cpu_perf, cpu_time, gpu_perf, gpu_time,
                        error, (error < tol ? "ok" : "failed") );
-                status += ! (error < tol);
+                okay = (error < tol);
+                status += ! okay;
+                rec.perf( "cpu", cpu_perf, cpu_time );
+                rec.add( "error", error );
             }
             else {
                 printf("%5lld     ---   (  ---  )   %7.2f (%7.2f)     ---  \n",
                        (long long) N, gpu_perf, gpu_time );
             }
+            rec.write( iter, okay );
             magma_free_cpu( h_A );
             magma_free_cpu( sigma );
             magma_free_pinned( h_R );
@@ -15,6 +15,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <algorithm>  // copy
 
 #include <cuda_runtime.h>  // cudaMemset
 
@@ -24,11 +25,6 @@
 #include "magma_lapack.h"
 #include "testings.h"
 
-#if defined(_OPENMP)
-#include <omp.h>
-#endif
-#include "../control/magma_threadsetting.h"  // internal header
-
 /* ////////////////////////////////////////////////////////////////////////////
    -- Testing zpotrf_batched
 */
@@ -44,12 +40,15 @@ int main( int argc, char** argv)
     magma_int_t N, n2, lda, ldda, info;
     magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
     magma_int_t ione     = 1;
-    magma_int_t ISEED[4] = {0,0,0,1};
-    double      work[1], error;
+    magma_int_t ISEED[4] = {0,0,0,1}, ISEED_test[4];
+    double      error;
     int status = 0;
     magmaDoubleComplex **d_A_array = NULL;
     magma_int_t *dinfo_magma;
     magma_int_t *hinfo_magma;
+    magma_int_t *hinfo_lapack;
+    magmaDoubleComplex **h_A_array = NULL;
+    magma_ref_cache refcache;
 
     magma_int_t batchCount;
 
@@ -57,6 +56,7 @@ int main( int argc, char** argv)
     opts.parse_opts( argc, argv );
     opts.lapack |= opts.check;  // check (-c) implies lapack (-l)
     batchCount = opts.batchcount;
+    magma_bench_record rec( opts, "zpotrf_batched" );
     double tol = opts.tolerance * lapackf77_dlamch("E");
 
     magma_queue_t queue = opts.queue;
@@ -64,7 +64,10 @@ int main( int argc, char** argv)
     printf("%% BatchCount   N    CPU Gflop/s (ms)    GPU Gflop/s (ms)   ||R_magma - R_lapack||_F / ||R_lapack||_F\n");
     printf("%%===================================================================================================\n");
     for( int itest = 0; itest < opts.ntest; ++itest ) {
+        // same matrices for each iter, so the LAPACK result can be reused
+        std::copy( ISEED, ISEED+4, ISEED_test );
         for( int iter = 0; iter < opts.niter; ++iter ) {
+            std::copy( ISEED_test, ISEED_test+4, ISEED );
             N   = opts.nsize[itest];
             lda = N;
             ldda = magma_roundup( N, opts.align );  // multiple of 32 by default
@@ -73,6 +76,8 @@ int main( int argc, char** argv)
             gflops = batchCount * FLOPS_ZPOTRF( N ) / 1e9;
 
             TESTING_CHECK( magma_imalloc_cpu( &hinfo_magma, batchCount ));
+            TESTING_CHECK( magma_imalloc_cpu( &hinfo_lapack, batchCount ));
+            TESTING_CHECK( magma_malloc_cpu( (void**) &h_A_array, batchCount * sizeof(magmaDoubleComplex*) ));
             TESTING_CHECK( magma_zmalloc_cpu( &h_A, n2 ));
             TESTING_CHECK( magma_zmalloc_pinned( &h_R, n2 ));
             TESTING_CHECK( magma_zmalloc( &d_A, ldda * N * batchCount ));
@@ -123,30 +128,28 @@ int main( int argc, char** argv)
                Performs operation using LAPACK
                =================================================================== */
             if ( opts.lapack ) {
-                cpu_time = magma_wtime();
-                // #define BATCHED_DISABLE_PARCPU
-                #if !defined (BATCHED_DISABLE_PARCPU) && defined(_OPENMP)
-                magma_int_t nthreads = magma_get_lapack_numthreads();
-                magma_set_lapack_numthreads(1);
-                magma_set_omp_numthreads(nthreads);
-                #pragma omp parallel for schedule(dynamic)
-                #endif
-                for (magma_int_t s=0; s < batchCount; s++)
-                {
-                    magma_int_t locinfo;
-                    lapackf77_zpotrf( lapack_uplo_const(opts.uplo), &N, h_A + s * lda * N, &lda, &locinfo );
-                    if (locinfo != 0) {
+                for (magma_int_t s=0; s < batchCount; s++) {
+                    h_A_array[s] = h_A + s * lda * N;
+                }
+                std::vector< magma_ref_buffer > outputs = {
+                    { h_A,          n2         * sizeof(magmaDoubleComplex) },
+                    { hinfo_lapack, batchCount * sizeof(magma_int_t) } };
+                std::string key = magma_ref_key( "zpotrf_batched", { opts.uplo, N, lda, batchCount },
+                                                 { outputs[0] } );
+                if ( ! refcache.lookup( key, outputs, &cpu_time )) {
+                    cpu_time = magma_wtime();
+                    magma_zpotrf_batched_ref( opts.uplo, N, h_A_array, lda, hinfo_lapack, batchCount );
+                    cpu_time = magma_wtime() - cpu_time;
+                    refcache.store( key, outputs, cpu_time );
+                }
+                cpu_perf = gflops / cpu_time;
+                
+                for (magma_int_t s=0; s < batchCount; s++) {
+                    if (hinfo_lapack[s] != 0) {
                         printf("lapackf77_zpotrf matrix %lld returned error %lld: %s.\n",
-                               (long long) s, (long long) locinfo, magma_strerror( locinfo ));
+                               (long long) s, (long long) hinfo_lapack[s], magma_strerror( hinfo_lapack[s] ));
                     }
                 }
-
-                #if !defined (BATCHED_DISABLE_PARCPU) && defined(_OPENMP)
-                    magma_set_lapack_numthreads(nthreads);
-                #endif
-            
-                cpu_time = magma_wtime() - cpu_time;
-                cpu_perf = gflops / cpu_time;
                 
                 /* =====================================================================
                    Check the result compared to LAPACK
@@ -154,19 +157,22 @@ int main( int argc, char** argv)
                 magma_zgetmatrix( N, columns, d_A, ldda, h_R, lda, opts.queue );
                 magma_int_t NN = lda*N;
                 const char* uplo = lapack_uplo_const(opts.uplo);
-                error = 0;
-                for (int i=0; i < batchCount; i++)
+                std::vector<double> errors( batchCount );
+                magma_int_t nthreads = magma_batched_ref_begin();
+                #pragma omp parallel for schedule(dynamic)
+                for (magma_int_t i=0; i < batchCount; i++)
                 {
-                    double Anorm, err;
+                    // BLAS is single-threaded here, so no need for safe_lapackf77_zlanhe
+                    double work[1];
                     blasf77_zaxpy(&NN, &c_neg_one, h_A + i * lda*N, &ione, h_R + i * lda*N, &ione);
-                    Anorm = safe_lapackf77_zlanhe("f", uplo, &N, h_A + i * lda*N, &lda, work);
-                    err   = safe_lapackf77_zlanhe("f", uplo, &N, h_R + i * lda*N, &lda, work)
-                          / Anorm;
-                    if (std::isnan(err) || std::isinf(err)) {
-                        error = err;
-                        break;
-                    }
-                    error = max( err, error );
+                    double Anorm = lapackf77_zlanhe("f", uplo, &N, h_A + i * lda*N, &lda, work);
+                    errors[i]    = lapackf77_zlanhe("f", uplo, &N, h_R + i * lda*N, &lda, work)
+                                 / Anorm;
+                }
+                magma_batched_ref_end( nthreads );
+                error = 0;
+                for (magma_int_t i=0; i < batchCount; i++) {
+                    error = magma_max_nan( errors[i], error );
                 }
                 bool okay = (error < tol);
                 status += ! okay;
@@ -174,13 +180,29 @@ int main( int argc, char** argv)
                 printf("%10lld %5lld   %7.2f (%7.2f)   %7.2f (%7.2f)   %8.2e   %s\n",
                        (long long) batchCount, (long long) N, cpu_perf, cpu_time*1000., gpu_perf, gpu_time*1000.,
                        error, (okay ? "ok" : "failed"));
+                
+                rec.add( "batch", batchCount );
+                rec.add( "n", N );
+                rec.add( "uplo", uplo );
+                rec.perf( "cpu",   cpu_perf, cpu_time );
+                rec.perf( "magma", gpu_perf, gpu_time );
+                rec.add( "error", error );
+                rec.write( iter, okay );
             }
             else {
                 printf("%10lld %5lld     ---   (  ---  )   %7.2f (%7.2f)     ---\n",
                        (long long) batchCount, (long long) N, gpu_perf, gpu_time*1000. );
+                
+                rec.add( "batch", batchCount );
+                rec.add( "n", N );
+                rec.add( "uplo", lapack_uplo_const(opts.uplo) );
+                rec.perf( "magma", gpu_perf, gpu_time );
+                rec.write( iter, true );
             }
 cleanup:
             magma_free_cpu( hinfo_magma );
+            magma_free_cpu( hinfo_lapack );
+            magma_free_cpu( h_A_array );
             magma_free_cpu( h_A );
             magma_free_pinned( h_R );
             magma_free( d_A );
@@ -197,6 +219,9 @@ cleanup:
             printf( "\n" );
         }
     }
+    if ( opts.lapack ) {
+        refcache.print_stats();
+    }
 
     opts.cleanup();
     TESTING_CHECK( magma_finalize() );
@@ -15,6 +15,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <algorithm>  // copy
 
 // includes, project
 #include "flops.h"
@@ -22,11 +23,6 @@
 #include "magma_lapack.h"
 #include "testings.h"
 
-#if defined(_OPENMP)
-#include <omp.h>
-#include "../control/magma_threadsetting.h"  // internal header
-#endif
-
 /* ////////////////////////////////////////////////////////////////////////////
    -- Testing zpotrf_vbatched
 */
@@ -42,13 +38,14 @@ int main( int argc, char** argv)
     magma_int_t N, total_size_cpu, total_size_dev, info;
     magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
     magma_int_t ione     = 1;
-    magma_int_t ISEED[4] = {0,0,0,1};
-    double      work[1], Anorm, error, magma_error;
+    magma_int_t ISEED[4] = {0,0,0,1}, ISEED_test[4];
+    double      magma_error;
     int status = 0;
     magmaDoubleComplex **h_A_array=NULL, **d_A_array = NULL;
     magma_int_t *dinfo_magma;
-    magma_int_t *hinfo_magma;
+    magma_int_t *hinfo_magma, *hinfo_lapack;
     magma_int_t max_N, batchCount;
+    magma_ref_cache refcache;
 
     magma_int_t *h_N, *d_N;
     magma_int_t *h_lda, *h_ldda, *d_ldda;
@@ -63,6 +60,7 @@ int main( int argc, char** argv)
     TESTING_CHECK( magma_imalloc_cpu(&h_N, batchCount) );
     TESTING_CHECK( magma_imalloc_cpu(&h_ldda, batchCount) );
     TESTING_CHECK( magma_imalloc_cpu(&hinfo_magma, batchCount) );
+    TESTING_CHECK( magma_imalloc_cpu(&hinfo_lapack, batchCount) );
     TESTING_CHECK( magma_imalloc(&d_N, batchCount+1) );
     TESTING_CHECK( magma_imalloc(&d_ldda, batchCount+1) );
     TESTING_CHECK( magma_imalloc(&dinfo_magma,  batchCount) );
@@ -74,7 +72,10 @@ int main( int argc, char** argv)
     printf("%% BatchCount     N   CPU Gflop/s (ms)   MAGMA Gflop/s (ms)   ||R_magma - R_lapack||_F / ||R_lapack||_F\n");
     printf("%%=====================================================================================================\n");
     for( int i = 0; i < opts.ntest; ++i ) {
+        // same matrices for each iter, so the LAPACK result can be reused
+        std::copy( ISEED, ISEED+4, ISEED_test );
         for( int iter = 0; iter < opts.niter; ++iter ) {
+            std::copy( ISEED_test, ISEED_test+4, ISEED );
             srand(1000); // guarantee reproducible sizes
             N   = opts.nsize[i];
             total_size_cpu = total_size_dev = 0;
@@ -154,24 +155,23 @@ int main( int argc, char** argv)
                 for(int s = 1; s < batchCount; s++){
                     h_A_array[s] = h_A_array[s-1] + h_N[s-1] * h_lda[s-1]; 
                 }
-                cpu_time = magma_wtime();
-                //#define BATCHED_DISABLE_PARCPU
-                #if !defined (BATCHED_DISABLE_PARCPU) && defined(_OPENMP)
-                magma_int_t nthreads = magma_get_lapack_numthreads();
-                magma_set_lapack_numthreads(1);
-                magma_set_omp_numthreads(nthreads); 
-                #pragma omp parallel for schedule(dynamic)
-                #endif
-                for (magma_int_t s=0; s < batchCount; s++){
-                    lapackf77_zpotrf( lapack_uplo_const(opts.uplo), &h_N[s], h_A_array[s], &h_lda[s], &info );
-                    if (info != 0)
-                        printf("lapackf77_zpotrf matrix %d returned err %d: %s.\n", (int) s, (int) info, magma_strerror( info ));
+                std::vector< magma_ref_buffer > outputs = {
+                    { h_A,          total_size_cpu * sizeof(magmaDoubleComplex) },
+                    { hinfo_lapack, batchCount     * sizeof(magma_int_t) } };
+                std::string key = magma_ref_key( "zpotrf_vbatched", { opts.uplo, N, batchCount },
+                                                 { { h_N, batchCount * sizeof(magma_int_t) },
+                                                   outputs[0] } );
+                if ( ! refcache.lookup( key, outputs, &cpu_time )) {
+                    cpu_time = magma_wtime();
+                    magma_zpotrf_vbatched_ref( opts.uplo, h_N, h_A_array, h_lda, hinfo_lapack, batchCount );
+                    cpu_time = magma_wtime() - cpu_time;
+                    refcache.store( key, outputs, cpu_time );
                 }
-                #if !defined (BATCHED_DISABLE_PARCPU) && defined(_OPENMP)
-                    magma_set_lapack_numthreads(nthreads);
-                #endif
-                cpu_time = magma_wtime() - cpu_time;
                 cpu_perf = gflops / cpu_time;
+                for (magma_int_t s=0; s < batchCount; s++) {
+                    if (hinfo_lapack[s] != 0)
+                        printf("lapackf77_zpotrf matrix %d returned err %d: %s.\n", (int) s, (int) hinfo_lapack[s], magma_strerror( hinfo_lapack[s] ));
+                }
 
                 /* =====================================================================
                    Check the result compared to LAPACK
@@ -183,19 +183,22 @@ int main( int argc, char** argv)
                     h_R_tmp += h_N[s] * h_lda[s]; 
                     d_A_tmp += h_N[s] * h_ldda[s];
                 }
-                magma_error = 0.0;
-                h_A_tmp = h_A;
-                h_R_tmp = h_R;
-                for (int s=0; s < batchCount; s++)
+                std::vector<double> errors( batchCount );
+                magma_int_t nthreads = magma_batched_ref_begin();
+                #pragma omp parallel for schedule(dynamic)
+                for (magma_int_t s=0; s < batchCount; s++)
                 {
+                    double work[1];
+                    magmaDoubleComplex* R = h_R + (h_A_array[s] - h_A);
                     magma_int_t Asize = h_lda[s] * h_N[s];
-                    Anorm = lapackf77_zlanhe("f", lapack_uplo_const(opts.uplo), &h_N[s], h_A_tmp, &h_lda[s], work);
-                    blasf77_zaxpy(&Asize, &c_neg_one, h_A_tmp, &ione, h_R_tmp, &ione);
-                    error = lapackf77_zlanhe("f", lapack_uplo_const(opts.uplo), &h_N[s], h_R_tmp, &h_lda[s], work) / Anorm;
-                    magma_error = magma_max_nan( magma_error, error );
-                    
-                    h_A_tmp += h_N[s] * h_lda[s];
-                    h_R_tmp += h_N[s] * h_lda[s];
+                    double Anorm = lapackf77_zlanhe("f", lapack_uplo_const(opts.uplo), &h_N[s], h_A_array[s], &h_lda[s], work);
+                    blasf77_zaxpy(&Asize, &c_neg_one, h_A_array[s], &ione, R, &ione);
+                    errors[s] = lapackf77_zlanhe("f", lapack_uplo_const(opts.uplo), &h_N[s], R, &h_lda[s], work) / Anorm;
+                }
+                magma_batched_ref_end( nthreads );
+                magma_error = 0.0;
+                for (int s=0; s < batchCount; s++) {
+                    magma_error = magma_max_nan( magma_error, errors[s] );
                 }
                 bool okay = (magma_error < tol);
                 status += ! okay;
@@ -234,6 +237,11 @@ cleanup:
     magma_free_cpu( h_ldda );
     magma_free_cpu( h_A_array );
     magma_free_cpu( hinfo_magma );
+    magma_free_cpu( hinfo_lapack );
+    
+    if ( opts.lapack ) {
+        refcache.print_stats();
+    }
     
     opts.cleanup();
     TESTING_CHECK( magma_finalize() );
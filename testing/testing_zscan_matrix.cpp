@@ -0,0 +1,191 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+#define COMPLEX
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing zscan_matrix
+   Scans a random M-by-N matrix (uplo = Full), or the lower or upper triangle
+   of a random N-by-N Hermitian matrix, with magma_zscan_matrix, and with
+   magma_znan_inf followed by LAPACK zlange or zlanhe for the max, one, inf,
+   and Frobenius norms. Square matrices are made Hermitian, then a_{0,n-1}
+   is perturbed so the symmetry defect is nonzero.
+   Reports the time and bandwidth of both, and checks
+       max |nrm - nrm_lapack| / (max(m,n) |nrm_lapack| eps) for the 4 norms,
+       the symmetry defect against a simple loop, and
+       the NAN and INF counts against magma_znan_inf, after setting
+       a few entries to NAN and INF.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    #define hA(i,j) (hA + (i) + (j)*lda)
+
+    real_Double_t   scan_time, sep_time, scan_bw, sep_bw, gbytes;
+    double          nrm[4], nrm_ref[4], defect, defect_ref, d, error, *work;
+    magmaDoubleComplex *hA;
+    magma_int_t M, N, lda, size, i, j, cnt, cnt_ref, nan_cnt, inf_cnt, nan_ref, inf_ref;
+    magma_int_t ione     = 1;
+    magma_int_t ISEED[4] = {0,0,0,1};
+    int status = 0;
+
+    magma_opts opts;
+    opts.parse_opts( argc, argv );
+    magma_bench_record rec( opts, "zscan_matrix" );
+
+    double eps = lapackf77_dlamch( "E" );
+    const char *norms[4] = { "M", "1", "I", "F" };
+    magma_uplo_t uplo[] = { MagmaFull, MagmaLower, MagmaUpper };
+
+    printf( "%% uplo    M     N   fused (sec)   GB/s   separate (sec)   GB/s   speedup   norm error   sym defect   nan+inf\n" );
+    printf( "%%=========================================================================================================\n" );
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+      for( int iuplo = 0; iuplo < 3; ++iuplo ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            M     = opts.msize[itest];
+            N     = opts.nsize[itest];
+            if ( uplo[iuplo] != MagmaFull && M != N ) {
+                continue;  // Hermitian storage is square
+            }
+            lda   = max( 1, M );
+            size  = lda*N;
+            gbytes = sizeof(magmaDoubleComplex) * 1e-9
+                   * (uplo[iuplo] == MagmaFull ? double(M)*N : 0.5*N*(N + 1.));
+
+            TESTING_CHECK( magma_zmalloc_cpu( &hA,   size ));
+            TESTING_CHECK( magma_dmalloc_cpu( &work, max( M, N ) ));
+
+            /* Initialize the matrix */
+            lapackf77_zlarnv( &ione, ISEED, &size, hA );
+            if ( M == N ) {
+                for( j = 0; j < N; ++j ) {
+                    *hA(j,j) = MAGMA_Z_MAKE( MAGMA_Z_REAL( *hA(j,j) ), 0. );
+                    for( i = j+1; i < N; ++i ) {
+                        *hA(j,i) = MAGMA_Z_CONJ( *hA(i,j) );
+                    }
+                }
+                if ( N > 1 ) {
+                    *hA(0,N-1) = MAGMA_Z_ADD( *hA(0,N-1), MAGMA_Z_MAKE( 1e-3, 0. ));
+                }
+            }
+
+            /* =====================================================================
+               Performs operation using magma_znan_inf and LAPACK
+               =================================================================== */
+            sep_time = magma_wtime();
+            cnt_ref = magma_znan_inf( uplo[iuplo], M, N, hA, lda, &nan_ref, &inf_ref );
+            for( int k = 0; k < 4; ++k ) {
+                if ( uplo[iuplo] == MagmaFull )
+                    nrm_ref[k] = lapackf77_zlange( norms[k], &M, &N, hA, &lda, work );
+                else
+                    nrm_ref[k] = lapackf77_zlanhe( norms[k], lapack_uplo_const( uplo[iuplo] ),
+                                                   &N, hA, &lda, work );
+            }
+            sep_time = magma_wtime() - sep_time;
+            sep_bw = gbytes / sep_time;
+
+            /* =====================================================================
+               Performs operation using MAGMA
+               =================================================================== */
+            scan_time = magma_wtime();
+            cnt = magma_zscan_matrix( uplo[iuplo], M, N, hA, lda, &nan_cnt, &inf_cnt,
+                                      &nrm[0], &nrm[1], &nrm[2], &nrm[3], &defect );
+            scan_time = magma_wtime() - scan_time;
+            scan_bw = gbytes / scan_time;
+
+            /* =====================================================================
+               Check the result
+               =================================================================== */
+            error = 0;
+            for( int k = 0; k < 4; ++k ) {
+                if ( nrm_ref[k] > 0 ) {
+                    error = max( error, fabs( nrm[k] - nrm_ref[k] )
+                                        / (max( M, N ) * nrm_ref[k] * eps) );
+                }
+            }
+
+            defect_ref = -1;
+            if ( uplo[iuplo] == MagmaFull && M == N ) {
+                defect_ref = 0;
+                for( j = 0; j < N; ++j ) {
+                    for( i = 0; i < N; ++i ) {
+                        d = fabs( MAGMA_Z_REAL( *hA(i,j) ) - MAGMA_Z_REAL( *hA(j,i) ));
+                        defect_ref = max( defect_ref, d );
+                        #ifdef COMPLEX
+                        d = fabs( MAGMA_Z_IMAG( *hA(i,j) ) + MAGMA_Z_IMAG( *hA(j,i) ));
+                        defect_ref = max( defect_ref, d );
+                        #endif
+                    }
+                }
+            }
+            else if ( uplo[iuplo] != MagmaFull ) {
+                defect_ref = 0;  // diagonal is real
+            }
+
+            bool okay = (cnt == cnt_ref && nan_cnt == nan_ref && inf_cnt == inf_ref
+                         && error < opts.tolerance && defect == defect_ref);
+
+            // set one entry in the stored part to NAN, one to INF
+            if ( M > 1 && N > 1 ) {
+                if ( uplo[iuplo] == MagmaUpper )
+                    *hA(0,N-1) = MAGMA_Z_NAN;
+                else
+                    *hA(M-1,0) = MAGMA_Z_NAN;
+                *hA(1,1) = MAGMA_Z_INF;
+                cnt_ref = magma_znan_inf( uplo[iuplo], M, N, hA, lda, &nan_ref, &inf_ref );
+                cnt = magma_zscan_matrix( uplo[iuplo], M, N, hA, lda, &nan_cnt, &inf_cnt,
+                                          &nrm[0], NULL, NULL, &nrm[3], NULL );
+                okay = okay && (cnt == cnt_ref && nan_cnt == nan_ref && inf_cnt == inf_ref
+                                && isnan( nrm[0] ) && isnan( nrm[3] ));
+            }
+
+            status += ! okay;
+            rec.add( "uplo", lapack_uplo_const( uplo[iuplo] ));
+            rec.add( "m", M );
+            rec.add( "n", N );
+            rec.add( "cpu_time", sep_time );
+            rec.add( "magma_time", scan_time );
+            rec.add( "magma_gbytes", scan_bw );
+            rec.add( "error", error );
+            rec.add( "sym_defect", defect );
+            rec.write( iter, okay );
+            printf( "%4c %5lld %5lld   %9.4f   %7.2f   %9.4f      %7.2f   %6.2f     %8.2e     %8.2e   %5lld   %s\n",
+                    lapacke_uplo_const( uplo[iuplo] ), (long long) M, (long long) N,
+                    scan_time, scan_bw, sep_time, sep_bw, sep_time / scan_time,
+                    error, defect, (long long) cnt, (okay ? "ok" : "failed") );
+
+            magma_free_cpu( hA );
+            magma_free_cpu( work );
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+      }
+      printf( "\n" );
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
@@ -0,0 +1,270 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "flops.h"
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing tile layout converters and tile factorizations
+   Converts a random M-by-N matrix to tile layout and back, out-of-place
+   (magma_tile_setmatrix, magma_tile_getmatrix) and in place
+   (magma_tile_attach, magma_tile_detach), and reports the bandwidth of
+   each, counting each element read and written once. Then factors it in
+   LAPACK layout with LAPACK, and in tile layout with
+   --version 1 (default): magma_zpotrf_tile_cpu (-L or -U, N-by-N, HPD matrix),
+   --version 2:           magma_zgetrf_tile_cpu,
+   --version 3:           magma_zgeqrf_tile_cpu,
+   and reports the speedup, without and with the conversions to and from
+   tile layout. The tile size is --nb (default 256). With --align 1, tiles
+   are compact; otherwise, tile columns are padded to a multiple of
+   --align elements. Checks
+       potrf: |A - L L^H| / (N |A|) or |A - U^H U| / (N |A|),
+       getrf: |PA - LU| / (N |A|),
+       geqrf: |R - Q^H A| / (N |A|),
+   and that both conversions reproduce the matrix exactly.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_zero    = MAGMA_Z_ZERO;
+
+    real_Double_t   gflops, cpu_perf, cpu_time, tile_perf, tile_time;
+    real_Double_t   set_time, get_time, attach_time, detach_time, gbytes;
+    double          Anorm, error, work[1];
+    magmaDoubleComplex *h_A, *h_R, *h_F, *tau, *h_work, tmp[1];
+    magma_int_t *ipiv;
+    magma_int_t M, N, nb, lda, n2, min_mn, lwork, info, j;
+    magma_int_t ione = 1;
+    magma_tile_t A;
+    int status = 0;
+
+    magma_opts opts;
+    opts.parse_opts( argc, argv );
+    magma_bench_record rec( opts, "ztile_cpu" );
+
+    double tol = opts.tolerance * lapackf77_dlamch("E");
+    const char* names[] = { "", "potrf", "getrf", "geqrf" };
+    int version = (opts.version <= 3 ? opts.version : 1);
+    magma_int_t align = (opts.align > 1 ? opts.align * sizeof(magmaDoubleComplex) : 0);
+
+    printf( "%% %s", names[ version ] );
+    if ( version == 1 ) {
+        printf( ", uplo = %s", lapack_uplo_const( opts.uplo ));
+    }
+    printf( ", %s tiles\n", (align > 0 ? "padded" : "compact") );
+    printf( "%%   M     N    NB   to tile   from tile   in place (GB/s)   LAPACK Gflop/s (sec)   tile Gflop/s (sec)   speedup   w/ convert   error\n" );
+    printf( "%%===============================================================================================================================\n" );
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            M = opts.msize[itest];
+            N = opts.nsize[itest];
+            if ( version == 1 ) {
+                M = N;
+            }
+            nb     = (opts.nb > 0 ? opts.nb : 256);
+            min_mn = min( M, N );
+            lda    = max( 1, M );
+            n2     = lda*N;
+            gbytes = 2. * M * N * sizeof(magmaDoubleComplex) / 1e9;  // read + write
+            if ( version == 1 ) {
+                gflops = FLOPS_ZPOTRF( N ) / 1e9;
+            }
+            else if ( version == 2 ) {
+                gflops = FLOPS_ZGETRF( M, N ) / 1e9;
+            }
+            else {
+                gflops = FLOPS_ZGEQRF( M, N ) / 1e9;
+            }
+
+            lwork = -1;
+            lapackf77_zgeqrf( &M, &N, NULL, &lda, NULL, tmp, &lwork, &info );
+            lwork = max( N*N, magma_int_t( MAGMA_Z_REAL( tmp[0] )));
+
+            TESTING_CHECK( magma_zmalloc_cpu( &h_A,    n2      ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_R,    n2      ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_F,    n2      ));
+            TESTING_CHECK( magma_zmalloc_cpu( &tau,    min_mn  ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_work, lwork   ));
+            TESTING_CHECK( magma_imalloc_cpu( &ipiv,   min_mn  ));
+
+            /* Initialize the matrix */
+            magma_generate_matrix( opts, M, N, h_A, lda );
+            if ( version == 1 ) {
+                magma_zmake_hpd( N, h_A, lda );
+            }
+            lapackf77_zlacpy( MagmaFullStr, &M, &N, h_A, &lda, h_R, &lda );
+            Anorm = lapackf77_zlange( "F", &M, &N, h_A, &lda, work );
+
+            /* =====================================================================
+               Conversions to and from tile layout, out-of-place and in place
+               =================================================================== */
+            TESTING_CHECK( magma_tile_create( M, N, nb, sizeof(magmaDoubleComplex),
+                                              align, 0, &A ));
+            set_time = magma_wtime();
+            TESTING_CHECK( magma_tile_setmatrix( h_A, lda, A ));
+            set_time = magma_wtime() - set_time;
+
+            get_time = magma_wtime();
+            TESTING_CHECK( magma_tile_getmatrix( A, h_F, lda ));
+            get_time = magma_wtime() - get_time;
+            bool convert_okay = (memcmp( h_A, h_F, n2*sizeof(magmaDoubleComplex) ) == 0);
+
+            magma_tile_t Ain;
+            attach_time = magma_wtime();
+            TESTING_CHECK( magma_tile_attach( M, N, nb, sizeof(magmaDoubleComplex),
+                                              h_F, lda, 0, &Ain ));
+            attach_time = magma_wtime() - attach_time;
+
+            detach_time = magma_wtime();
+            TESTING_CHECK( magma_tile_detach( Ain ));
+            detach_time = magma_wtime() - detach_time;
+            convert_okay = convert_okay &&
+                           (memcmp( h_A, h_F, n2*sizeof(magmaDoubleComplex) ) == 0);
+
+            /* =====================================================================
+               Performs operation using LAPACK, in LAPACK layout
+               =================================================================== */
+            cpu_time = magma_wtime();
+            if ( version == 1 ) {
+                lapackf77_zpotrf( lapack_uplo_const( opts.uplo ), &N, h_R, &lda, &info );
+            }
+            else if ( version == 2 ) {
+                lapackf77_zgetrf( &M, &N, h_R, &lda, ipiv, &info );
+            }
+            else {
+                lapackf77_zgeqrf( &M, &N, h_R, &lda, tau, h_work, &lwork, &info );
+            }
+            cpu_time = magma_wtime() - cpu_time;
+            cpu_perf = gflops / cpu_time;
+            if (info != 0) {
+                printf("lapackf77_z%s returned error %lld: %s.\n",
+                       names[ version ], (long long) info, magma_strerror( info ));
+            }
+
+            /* =====================================================================
+               Performs operation using MAGMA, in tile layout
+               =================================================================== */
+            tile_time = magma_wtime();
+            if ( version == 1 ) {
+                magma_zpotrf_tile_cpu( opts.uplo, A, &info );
+            }
+            else if ( version == 2 ) {
+                magma_zgetrf_tile_cpu( A, ipiv, &info );
+            }
+            else {
+                magma_zgeqrf_tile_cpu( A, tau, &info );
+            }
+            tile_time = magma_wtime() - tile_time;
+            tile_perf = gflops / tile_time;
+            if (info != 0) {
+                printf("magma_z%s_tile_cpu returned error %lld: %s.\n",
+                       names[ version ], (long long) info, magma_strerror( info ));
+            }
+            TESTING_CHECK( magma_tile_getmatrix( A, h_F, lda ));
+            magma_tile_destroy( A );
+
+            /* =====================================================================
+               Check the result
+               =================================================================== */
+            if ( version == 1 ) {
+                // h_R = L L^H or U^H U, from the factor in h_F
+                lapackf77_zlacpy( MagmaFullStr, &N, &N, h_F, &lda, h_R, &lda );
+                if ( opts.uplo == MagmaLower ) {
+                    lapackf77_zlaset( MagmaUpperStr, &N, &N, &c_zero, &c_zero, h_R, &lda );
+                    lapackf77_zlaset( MagmaUpperStr, &N, &N, &c_zero, &c_zero, h_F, &lda );
+                    blasf77_ztrmm( MagmaRightStr, MagmaLowerStr, MagmaConjTransStr, MagmaNonUnitStr,
+                                   &N, &N, &c_one, h_F, &lda, h_R, &lda );
+                }
+                else {
+                    lapackf77_zlaset( MagmaLowerStr, &N, &N, &c_zero, &c_zero, h_R, &lda );
+                    lapackf77_zlaset( MagmaLowerStr, &N, &N, &c_zero, &c_zero, h_F, &lda );
+                    blasf77_ztrmm( MagmaLeftStr, MagmaUpperStr, MagmaConjTransStr, MagmaNonUnitStr,
+                                   &N, &N, &c_one, h_F, &lda, h_R, &lda );
+                }
+            }
+            else if ( version == 2 ) {
+                // h_R = L U, from the factors in h_F; h_A = P A
+                magma_int_t ldl = lda;
+                lapackf77_zlaswp( &N, h_A, &lda, &ione, &min_mn, ipiv, &ione );
+                lapackf77_zlacpy( MagmaUpperStr, &min_mn, &N, h_F, &lda, h_work, &min_mn );
+                lapackf77_zlaset( MagmaLowerStr, &min_mn, &N, &c_zero, &c_zero, h_work, &min_mn );
+                lapackf77_zlaset( MagmaUpperStr, &min_mn, &min_mn, &c_zero, &c_one, h_F, &ldl );
+                blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &M, &N, &min_mn,
+                               &c_one,  h_F,    &ldl,
+                                        h_work, &min_mn,
+                               &c_zero, h_R,    &lda );
+            }
+            else {
+                // h_R = Q R, with Q from zungqr and R from h_F
+                lapackf77_zlacpy( MagmaFullStr, &M, &N, h_F, &lda, h_R, &lda );
+                lapackf77_zungqr( &M, &min_mn, &min_mn, h_F, &lda, tau, h_work, &lwork, &info );
+                lapackf77_zlaset( MagmaLowerStr, &min_mn, &N, &c_zero, &c_zero, h_R, &lda );
+                lapackf77_zlacpy( MagmaFullStr, &min_mn, &N, h_R, &lda, h_work, &min_mn );
+                blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &M, &N, &min_mn,
+                               &c_one,  h_F,    &lda,
+                                        h_work, &min_mn,
+                               &c_zero, h_R,    &lda );
+            }
+            for( j = 0; j < N; ++j ) {
+                blasf77_zaxpy( &M, &c_neg_one, &h_A[j*lda], &ione, &h_R[j*lda], &ione );
+            }
+            error = lapackf77_zlange( "F", &M, &N, h_R, &lda, work ) / (N * Anorm);
+
+            bool okay = (info == 0 && error < tol && convert_okay);
+            status += ! okay;
+            rec.add( "m", M );
+            rec.add( "n", N );
+            rec.add( "nb", nb );
+            rec.add( "set_gbps",    gbytes / set_time );
+            rec.add( "get_gbps",    gbytes / get_time );
+            rec.add( "inplace_gbps", 2*gbytes / (attach_time + detach_time) );
+            rec.add( "cpu_time", cpu_time );
+            rec.add( "magma_time", tile_time );
+            rec.add( "error", error );
+            rec.write( iter, okay );
+            printf( "%5lld %5lld %5lld   %7.2f   %9.2f   %15.2f   %7.2f (%7.2f)      %7.2f (%7.2f)    %6.2f   %10.2f   %8.2e   %s\n",
+                    (long long) M, (long long) N, (long long) nb,
+                    gbytes / set_time, gbytes / get_time,
+                    2*gbytes / (attach_time + detach_time),
+                    cpu_perf, cpu_time, tile_perf, tile_time,
+                    cpu_time / tile_time,
+                    cpu_time / (set_time + tile_time + get_time),
+                    error, (okay ? "ok" : "failed") );
+
+            magma_free_cpu( h_A    );
+            magma_free_cpu( h_R    );
+            magma_free_cpu( h_F    );
+            magma_free_cpu( tau    );
+            magma_free_cpu( h_work );
+            magma_free_cpu( ipiv   );
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
@@ -0,0 +1,241 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "flops.h"
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "magma_operators.h"
+#include "testings.h"
+
+#define COMPLEX
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing ztrevc3_mt
+   Computes the Schur form A = Z T Z^H with LAPACK, then the right and left
+   eigenvectors of A, back-transformed by Z, with LAPACK ztrevc3 and with
+   magma_ztrevc3_mt, which solves each block of eigenvectors together with
+   the blocked robust triangular solves (z)latrs3d / (d)laqtrs3d.
+   Checks |A VR - VR W| / (N |A|) and |A^H VL - VL W^H| / (N |A|) for MAGMA,
+   using zget22. The largest difference from LAPACK's vectors, which are
+   normalized the same way, is reported but not checked, as it depends on
+   the condition numbers of the eigenvectors.
+   Use --matrix geev (A = U T U^H, see magma_generate_matrix) to set the
+   eigenvalues.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    real_Double_t   cpu_time, mt_time;
+    double          error, diff, d, ulp, result[2];
+    magmaDoubleComplex *h_A, *h_T, *h_Z, *h_V, *h_Vmt, *tau, *hwork, temp;
+    #ifdef COMPLEX
+    magmaDoubleComplex *w;
+    double *rwork;
+    #else
+    double *wr, *wi;
+    #endif
+    magma_int_t N, lda, n2, lwork, lwork_q, lwork_mt, ilo, ihi, m, info, info_mt;
+    int status = 0;
+
+    magma_opts opts;
+    opts.parse_opts( argc, argv );
+    magma_bench_record rec( opts, "ztrevc3_mt" );
+
+    double tol = opts.tolerance * lapackf77_dlamch("E");
+    ulp = lapackf77_dlamch( "P" );
+
+    printf( "%% matrix %s\n", opts.matrix.c_str() );
+    printf( "%%   N   side   LAPACK time (sec)   MAGMA time (sec)   speedup   |A V - V W| / (N |A|)   diff from LAPACK\n" );
+    printf( "%%=====================================================================================================\n" );
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            N   = opts.nsize[itest];
+            lda = N;
+            n2  = lda*N;
+            ilo = 1;
+            ihi = N;
+            // blocked back-transform with the largest block, nb = 256
+            lwork_mt = N + 2*N*256;
+
+            TESTING_CHECK( magma_zmalloc_cpu( &h_A,   n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_T,   n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_Z,   n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_V,   n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_Vmt, n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &tau,   N  ));
+            #ifdef COMPLEX
+            TESTING_CHECK( magma_zmalloc_cpu( &w,     N   ));
+            TESTING_CHECK( magma_dmalloc_cpu( &rwork, 2*N ));
+            #else
+            TESTING_CHECK( magma_dmalloc_cpu( &wr,    N ));
+            TESTING_CHECK( magma_dmalloc_cpu( &wi,    N ));
+            #endif
+
+            /* Initialize the matrix and compute its Schur form with LAPACK */
+            magma_generate_matrix( opts, N, N, h_A, lda );
+
+            lwork = -1;
+            lapackf77_zgehrd( &N, &ilo, &ihi, h_T, &lda, tau, &temp, &lwork, &info );
+            // generous workspace - required by zget22
+            lwork = max( N*(5 + 2*N), (magma_int_t) MAGMA_Z_REAL( temp ));
+            lwork_q = -1;
+            lapackf77_zunghr( &N, &ilo, &ihi, h_Z, &lda, tau, &temp, &lwork_q, &info );
+            lwork = max( lwork, (magma_int_t) MAGMA_Z_REAL( temp ));
+            lwork_q = -1;
+            #ifdef COMPLEX
+            lapackf77_zhseqr( "S", "V", &N, &ilo, &ihi, h_T, &lda, w,
+                              h_Z, &lda, &temp, &lwork_q, &info );
+            #else
+            lapackf77_zhseqr( "S", "V", &N, &ilo, &ihi, h_T, &lda, wr, wi,
+                              h_Z, &lda, &temp, &lwork_q, &info );
+            #endif
+            lwork = max( lwork, (magma_int_t) MAGMA_Z_REAL( temp ));
+            lwork = max( lwork, lwork_mt );
+            TESTING_CHECK( magma_zmalloc_cpu( &hwork, lwork ));
+
+            lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_T, &lda );
+            lapackf77_zgehrd( &N, &ilo, &ihi, h_T, &lda, tau, hwork, &lwork, &info );
+            lapackf77_zlacpy( MagmaLowerStr, &N, &N, h_T, &lda, h_Z, &lda );
+            lapackf77_zunghr( &N, &ilo, &ihi, h_Z, &lda, tau, hwork, &lwork, &info );
+            #ifdef COMPLEX
+            lapackf77_zhseqr( "S", "V", &N, &ilo, &ihi, h_T, &lda, w,
+                              h_Z, &lda, hwork, &lwork, &info );
+            #else
+            lapackf77_zhseqr( "S", "V", &N, &ilo, &ihi, h_T, &lda, wr, wi,
+                              h_Z, &lda, hwork, &lwork, &info );
+            #endif
+            if (info != 0) {
+                printf("lapackf77_zhseqr returned error %lld.\n", (long long) info );
+            }
+
+            for( int iside = 0; iside < 2; ++iside ) {
+                magma_side_t side = (iside == 0 ? MagmaRight : MagmaLeft);
+
+                /* =====================================================================
+                   Performs operation using LAPACK
+                   =================================================================== */
+                lapackf77_zlacpy( MagmaFullStr, &N, &N, h_Z, &lda, h_V, &lda );
+                cpu_time = magma_wtime();
+                lapackf77_ztrevc3( lapack_side_const( side ), "B", NULL, &N,
+                                   h_T, &lda, h_V, &lda, h_V, &lda, &N, &m,
+                                   hwork, &lwork,
+                                   #ifdef COMPLEX
+                                   rwork,
+                                   #endif
+                                   &info );
+                cpu_time = magma_wtime() - cpu_time;
+                if (info != 0) {
+                    printf("lapackf77_ztrevc3 returned error %lld.\n", (long long) info );
+                }
+
+                /* =====================================================================
+                   Performs operation using MAGMA
+                   =================================================================== */
+                lapackf77_zlacpy( MagmaFullStr, &N, &N, h_Z, &lda, h_Vmt, &lda );
+                mt_time = magma_wtime();
+                magma_ztrevc3_mt( side, MagmaBacktransVec, NULL, N,
+                                  h_T, lda, h_Vmt, lda, h_Vmt, lda, N, &m,
+                                  hwork, lwork_mt,
+                                  #ifdef COMPLEX
+                                  rwork,
+                                  #endif
+                                  &info_mt );
+                mt_time = magma_wtime() - mt_time;
+                if (info_mt != 0) {
+                    printf("magma_ztrevc3_mt returned error %lld: %s.\n",
+                           (long long) info_mt, magma_strerror( info_mt ));
+                }
+
+                /* =====================================================================
+                   Check the result
+                   =================================================================== */
+                // | A V - V W | / (N |A|), or | A^H V - V W^H | / (N |A|) for left vectors
+                if ( side == MagmaRight ) {
+                    #ifdef COMPLEX
+                    lapackf77_zget22( MagmaNoTransStr, MagmaNoTransStr, MagmaNoTransStr,
+                                      &N, h_A, &lda, h_Vmt, &lda, w,
+                                      hwork, rwork, result );
+                    #else
+                    lapackf77_zget22( MagmaNoTransStr, MagmaNoTransStr, MagmaNoTransStr,
+                                      &N, h_A, &lda, h_Vmt, &lda, wr, wi,
+                                      hwork, result );
+                    #endif
+                }
+                else {
+                    #ifdef COMPLEX
+                    lapackf77_zget22( MagmaConjTransStr, MagmaNoTransStr, MagmaConjTransStr,
+                                      &N, h_A, &lda, h_Vmt, &lda, w,
+                                      hwork, rwork, result );
+                    #else
+                    lapackf77_zget22( MagmaConjTransStr, MagmaNoTransStr, MagmaConjTransStr,
+                                      &N, h_A, &lda, h_Vmt, &lda, wr, wi,
+                                      hwork, result );
+                    #endif
+                }
+                error = result[0] * ulp;
+
+                // difference from LAPACK's vectors
+                diff = 0;
+                for( magma_int_t j = 0; j < N; ++j ) {
+                    for( magma_int_t i = 0; i < N; ++i ) {
+                        d = MAGMA_Z_ABS( h_Vmt[i + j*lda] - h_V[i + j*lda] );
+                        diff = max( diff, d );
+                    }
+                }
+
+                bool okay = (error < tol && info_mt == 0);
+                status += ! okay;
+                rec.add( "n", N );
+                rec.add( "side", lapack_side_const( side ));
+                rec.add( "cpu_time", cpu_time );
+                rec.add( "magma_time", mt_time );
+                rec.add( "error", error );
+                rec.add( "vec_diff", diff );
+                rec.write( iter, okay );
+                printf( "%5lld   %-5s  %9.4f           %9.4f          %6.2f    %8.2e                %8.2e   %s\n",
+                        (long long) N, (side == MagmaRight ? "right" : "left"),
+                        cpu_time, mt_time, cpu_time / mt_time,
+                        error, diff, (okay ? "ok" : "failed") );
+            }
+
+            magma_free_cpu( h_A );
+            magma_free_cpu( h_T );
+            magma_free_cpu( h_Z );
+            magma_free_cpu( h_V );
+            magma_free_cpu( h_Vmt );
+            magma_free_cpu( tau );
+            magma_free_cpu( hwork );
+            #ifdef COMPLEX
+            magma_free_cpu( w );
+            magma_free_cpu( rwork );
+            #else
+            magma_free_cpu( wr );
+            magma_free_cpu( wi );
+            #endif
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
@@ -108,6 +108,9 @@ void magma_assert_warn( bool condition, const char* msg, ... );
 
 void magma_flush_cache( size_t cache_size );
 
+magma_int_t magma_batched_ref_begin();
+void        magma_batched_ref_end( magma_int_t nthreads );
+
 #ifdef __cplusplus
 }
 #endif
@@ -130,6 +133,12 @@ typedef enum {
     MagmaOptsBatched = 1000
 } magma_opts_t;
 
+typedef enum {
+    MagmaOutputText = 0,
+    MagmaOutputJson,
+    MagmaOutputCsv
+} magma_output_t;
+
 typedef enum {
     MagmaSVD_all,
     MagmaSVD_query,
@@ -196,6 +205,10 @@ public:
     magma_int_t check;
     magma_int_t verbose;
     
+    // machine-readable records, see magma_bench_record
+    magma_output_t output;
+    FILE*          output_file;  // NULL for stdout
+    
     // ranges for eigen/singular values (gesvdx, heevdx, ...)
     double      fraction_lo;
     double      fraction_up;
@@ -231,6 +244,7 @@ public:
     double      cond;
     double      condD;
     magma_int_t iseed[4];
+    std::string matrix_cache;  // directory of cached test matrices; empty for none
 
     // queue for default device
     magma_queue_t   queue;
@@ -244,6 +258,91 @@ public:
 
 extern const char* g_platform_str;
 
+// -----------------------------------------------------------------------------
+// Caches the CPU reference result of a batched tester, so repeated --niter
+// runs on identical input reuse it instead of recomputing it.
+// Holds only the most recent result; the key identifies routine, sizes, and
+// a hash of the input, see magma_ref_key.
+struct magma_ref_buffer
+{
+    void*  ptr;
+    size_t bytes;
+};
+
+class magma_ref_cache
+{
+public:
+    magma_ref_cache();
+
+    // if key matches the stored result, copies it into bufs, sets time to the
+    // time originally spent computing it, and returns true.
+    bool lookup( std::string const& key,
+                 std::vector< magma_ref_buffer > const& bufs, double* time );
+
+    // saves a copy of bufs under key, replacing any previous result.
+    void store(  std::string const& key,
+                 std::vector< magma_ref_buffer > const& bufs, double time );
+
+    // prints number of computed and reused results and reference time.
+    void print_stats() const;
+
+    magma_int_t ncompute;
+    magma_int_t nreuse;
+    double      compute_time;   // total time spent computing references
+    double      reuse_time;     // total time saved by reusing references
+
+private:
+    std::string key_;
+    std::vector< std::vector<char> > data_;
+    double time_;
+};
+
+uint64_t magma_hash( const void* data, size_t bytes );
+
+std::string magma_ref_key(
+    const char* routine,
+    std::vector< magma_int_t > const& dims,
+    std::vector< magma_ref_buffer > const& inputs );
+
+// -----------------------------------------------------------------------------
+// One result of a tester, written as a JSON Lines record or CSV row
+// with --output json|csv, and ignored with the default text output.
+// Fields are written in the order added, after the routine name and
+// iteration, followed by status and host information (hostname, device,
+// threads, MAGMA version, git revision, date).
+class magma_bench_record
+{
+public:
+    magma_bench_record( magma_opts const& opts, const char* routine );
+
+    // adds a size, option, error, etc.
+    void add( const char* name, magma_int_t value );
+    void add( const char* name, double      value );
+    void add( const char* name, const char* value );
+
+    // adds <name>_gflops and <name>_time, e.g., for name = "magma" or "cpu".
+    void perf( const char* name, double gflops, double time );
+
+    // writes the record for iteration iter, then clears fields for the next one.
+    void write( magma_int_t iter, bool okay );
+
+private:
+    struct field
+    {
+        field( std::string const& name_, std::string const& value_, bool is_string_ ):
+            name( name_ ), value( value_ ), is_string( is_string_ )
+        {}
+
+        std::string name;
+        std::string value;
+        bool is_string;
+    };
+
+    magma_opts const& opts_;
+    std::string routine_;
+    std::vector< field > fields_;
+};
+
 // -----------------------------------------------------------------------------
 template< typename FloatT >
 void magma_generate_matrix(
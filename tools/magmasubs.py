@@ -227,17 +227,21 @@ lapack = [
     ('slansy',         'dlansy',         'clanhe',         'zlanhe'          ),
     ('slansy',         'dlansy',         'clansy',         'zlansy'          ),
     ('slantr',         'dlantr',         'clantr',         'zlantr'          ),
+    ('slanv2',         'dlanv2',         'slanv2',         'dlanv2'          ),
     ('slapy3',         'dlapy3',         'slapy3',         'dlapy3'          ),
     ('slaqp2',         'dlaqp2',         'claqp2',         'zlaqp2'          ),
     ('slaqps',         'dlaqps',         'claqps',         'zlaqps'          ),
+    ('slaqr',          'dlaqr',          'claqr',          'zlaqr'           ),
     ('slaqtrs',        'dlaqtrs',        'claqtrs',        'zlaqtrs'         ),
     ('slarcm',         'dlarcm',         'clarcm',         'zlarcm'          ),
     ('slarf',          'dlarf',          'clarf',          'zlarf'           ),  # also does zlarfb, zlarfg, etc.
+    ('slarmm',         'dlarmm',         'slarmm',         'dlarmm'          ),
     ('slarnv',         'dlarnv',         'clarnv',         'zlarnv'          ),
     ('slarnv',         'dlarnv',         'slarnv',         'dlarnv'          ),
     ('slartg',         'dlartg',         'clartg',         'zlartg'          ),
     ('slascl',         'dlascl',         'slascl',         'dlascl'          ),
     ('slascl',         'dlascl',         'clascl',         'zlascl'          ),
+    ('slasd',          'dlasd',          'slasd',          'dlasd'           ),
     ('slaset',         'dlaset',         'claset',         'zlaset'          ),
     ('slasrt',         'dlasrt',         'slasrt',         'dlasrt'          ),
     ('slaswp',         'dlaswp',         'claswp',         'zlaswp'          ),
@@ -274,8 +278,10 @@ lapack = [
     ('spotrs',         'dpotrs',         'cpotrs',         'zpotrs'          ),
     ('sqpt01',         'dqpt01',         'cqpt01',         'zqpt01'          ),
     ('sqrt02',         'dqrt02',         'cqrt02',         'zqrt02'          ),
+    ('srangefinder',   'drangefinder',   'crangefinder',   'zrangefinder'    ),
     ('ssbtrd',         'dsbtrd',         'chbtrd',         'zhbtrd'          ),
     ('sshift',         'dshift',         'cshift',         'zshift'          ),
+    ('ssketch',        'dsketch',        'csketch',        'zsketch'         ),
     ('sssssm',         'dssssm',         'cssssm',         'zssssm'          ),
     ('sstebz',         'dstebz',         'sstebz',         'dstebz'          ),
     ('sstedc',         'dstedc',         'cstedc',         'zstedc'          ),
@@ -530,6 +536,7 @@ subs = {
     ('smalloc',        'dmalloc',        'cmalloc',        'zmalloc'         ),
     ('smalloc',        'dmalloc',        'smalloc',        'dmalloc'         ),
     ('smove',          'dmove',          'smove',          'dmove'           ),
+    ('spanel',         'dpanel',         'cpanel',         'zpanel'          ),
     ('spanel_to_q',    'dpanel_to_q',    'cpanel_to_q',    'zpanel_to_q'     ),
     ('spermute',       'dpermute',       'cpermute',       'zpermute'        ),
     ('SPRBT',          'DPRBT',          'CPRBT',          'ZPRBT'           ),
@@ -598,6 +605,7 @@ subs = {
     ('silu',           'dilu',           'cilu',           'zilu'            ),
     ('sgeblock',       'dgeblock',       'cilugeblock',    'zgeblock'        ),
     ('sge3pt',         'dge3pt',         'cge3pt',         'zge3pt'          ),    
+    ('sgestencil',     'dgestencil',     'cgestencil',     'zgestencil'      ),
     ('sgecscsyncfreetrsm',  'dgecscsyncfreetrsm',  'cgecscsyncfreetrsm',  'zgecscsyncfreetrsm'),   
 
 
@@ -635,6 +643,14 @@ subs = {
     ('scustom',        'dcustom',        'ccustom',        'zcustom'         ),
     ('sparilu',        'dparilu',        'cparilu',        'zparilu'         ),
     ('sparic',         'dparic',         'cparic',         'zparic'          ),
+    ('spipecg',        'dpipecg',        'cpipecg',        'zpipecg'         ),
+    ('ssstep',         'dsstep',         'csstep',         'zsstep'          ),
+    ('schebyshev',     'dchebyshev',     'cchebyshev',     'zchebyshev'      ),
+    ('srecycle',       'drecycle',       'crecycle',       'zrecycle'        ),
+    ('sgcrodr',        'dgcrodr',        'cgcrodr',        'zgcrodr'         ),
+    ('sdefcg',         'ddefcg',         'cdefcg',         'zdefcg'          ),
+    ('sschwarz',       'dschwarz',       'cschwarz',       'zschwarz'        ),
+    ('svbjacobi',      'dvbjacobi',      'cvbjacobi',      'zvbjacobi'       ),
 
     # ----- SPARSE Iterative Eigensolvers
     ('slobpcg',        'dlobpcg',        'clobpcg',        'zlobpcg'         ),